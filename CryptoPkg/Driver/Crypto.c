@@ -1016,6 +1016,36 @@ CryptoServiceSha256HashAll (
   return CALL_BASECRYPTLIB (Sha256.Services.HashAll, Sha256HashAll, (Data, DataSize, HashValue), FALSE);
 }
 
+/**
+  Computes the SHA-256 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha256HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-256 digest value (32 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-256 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceSha256HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  return CALL_BASECRYPTLIB (Sha256.Services.HashAllBatch, Sha256HashAllBatch, (Requests, RequestCount), FALSE);
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
 
@@ -1165,6 +1195,36 @@ CryptoServiceSha384HashAll (
   return CALL_BASECRYPTLIB (Sha384.Services.HashAll, Sha384HashAll, (Data, DataSize, HashValue), FALSE);
 }
 
+/**
+  Computes the SHA-384 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha384HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-384 digest value (48 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-384 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceSha384HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  return CALL_BASECRYPTLIB (Sha384.Services.HashAllBatch, Sha384HashAllBatch, (Requests, RequestCount), FALSE);
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-512 hash operations.
 
@@ -1314,6 +1374,36 @@ CryptoServiceSha512HashAll (
   return CALL_BASECRYPTLIB (Sha512.Services.HashAll, Sha512HashAll, (Data, DataSize, HashValue), FALSE);
 }
 
+/**
+  Computes the SHA-512 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha512HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-512 digest value (64 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-512 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceSha512HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  return CALL_BASECRYPTLIB (Sha512.Services.HashAllBatch, Sha512HashAllBatch, (Requests, RequestCount), FALSE);
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SM3 hash operations.
 
@@ -2736,6 +2826,34 @@ CryptoServiceRsaPkcs1Verify (
   return CALL_BASECRYPTLIB (Rsa.Services.Pkcs1Verify, RsaPkcs1Verify, (RsaContext, MessageHash, HashSize, Signature, SigSize), FALSE);
 }
 
+/**
+  Verifies a batch of RSA-SSA signatures with EMSA-PKCS1-v1_5 encoding scheme
+  defined in RSA PKCS#1.
+
+  Each entry of Requests is verified as if by RsaPkcs1Verify() using the RSA
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once. The HashNid member is ignored.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceRsaPkcs1VerifyBatch (
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  )
+{
+  return CALL_BASECRYPTLIB (Rsa.Services.Pkcs1VerifyBatch, RsaPkcs1VerifyBatch, (Requests, RequestCount), FALSE);
+}
+
 /**
   Retrieve the RSA Private Key from the password-protected PEM key data.
 
@@ -5509,6 +5627,88 @@ CryptoServiceTlsGetExportKey (
            );
 }
 
+/**
+  Sets a previously established TLS session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() for another TLS
+  connection to the same server. The handshake then offers to resume it, by
+  session ID, session ticket or TLS 1.3 pre-shared key, and falls back to a
+  full handshake if the server declines.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session to resume.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+
+**/
+EFI_STATUS
+EFIAPI
+CryptoServiceTlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  return CALL_BASECRYPTLIB (TlsSet.Services.Session, TlsSetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
+/**
+  Gets the resumable session established by the specified TLS connection.
+
+  This function returns a reference to the TLS/SSL session of the connection,
+  including the session ticket received from the server if any, which can be
+  resumed by a later connection with TlsSetSession(). The caller must release
+  it with TlsSessionFree().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  The TLS session, or NULL if Tls is invalid or the session can't be
+           resumed.
+
+**/
+VOID *
+EFIAPI
+CryptoServiceTlsGetSession (
+  IN     VOID  *Tls
+  )
+{
+  return CALL_BASECRYPTLIB (TlsGet.Services.Session, TlsGetSession, (Tls), NULL);
+}
+
+/**
+  Release a TLS session returned by TlsGetSession().
+
+  @param[in]  Session         Pointer to the TLS session to release.
+
+**/
+VOID
+EFIAPI
+CryptoServiceTlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  CALL_VOID_BASECRYPTLIB (Tls.Services.SessionFree, TlsSessionFree, (Session));
+}
+
+/**
+  Checks whether the handshake of a TLS connection resumed a previous session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @retval  TRUE     The connection resumed the session set with TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceTlsSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  return CALL_BASECRYPTLIB (Tls.Services.SessionReused, TlsSessionReused, (Tls), FALSE);
+}
+
 /**
   Carries out the RSA-SSA signature generation with EMSA-PSS encoding scheme.
 
@@ -6813,6 +7013,33 @@ CryptoServiceEcDsaVerify (
   return CALL_BASECRYPTLIB (Ec.Services.DsaVerify, EcDsaVerify, (EcContext, HashNid, MessageHash, HashSize, Signature, SigSize), FALSE);
 }
 
+/**
+  Verifies a batch of EC-DSA signatures.
+
+  Each entry of Requests is verified as if by EcDsaVerify() using the EC
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceEcDsaVerifyBatch (
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  )
+{
+  return CALL_BASECRYPTLIB (Ec.Services.DsaVerifyBatch, EcDsaVerifyBatch, (Requests, RequestCount), FALSE);
+}
+
 const EDKII_CRYPTO_PROTOCOL  mEdkiiCrypto = {
   /// Version
   CryptoServiceGetCryptoVersion,
@@ -7116,4 +7343,15 @@ const EDKII_CRYPTO_PROTOCOL  mEdkiiCrypto = {
   CryptoServicePkcs1v2Decrypt,
   CryptoServiceRsaOaepEncrypt,
   CryptoServiceRsaOaepDecrypt,
+  /// TLS session resumption
+  CryptoServiceTlsSetSession,
+  CryptoServiceTlsGetSession,
+  CryptoServiceTlsSessionFree,
+  CryptoServiceTlsSessionReused,
+  /// Batched hash and signature verification
+  CryptoServiceSha256HashAllBatch,
+  CryptoServiceSha384HashAllBatch,
+  CryptoServiceSha512HashAllBatch,
+  CryptoServiceRsaPkcs1VerifyBatch,
+  CryptoServiceEcDsaVerifyBatch,
 };
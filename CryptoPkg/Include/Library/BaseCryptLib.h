@@ -82,6 +82,30 @@ typedef enum {
   RsaKeyQInv    ///< The CRT coefficient (== 1/q mod p)
 } RSA_KEY_TAG;
 
+///
+/// One entry of a batched hash operation, see Sha256HashAllBatch().
+///
+typedef struct {
+  CONST VOID    *Data;      ///< Pointer to the buffer containing the data to be hashed.
+  UINTN         DataSize;   ///< Size of Data buffer in bytes.
+  UINT8         *HashValue; ///< Pointer to a buffer that receives the digest value.
+  BOOLEAN       Result;     ///< Set to TRUE when the digest was computed.
+} CRYPTO_HASH_REQUEST;
+
+///
+/// One entry of a batched signature verification, see RsaPkcs1VerifyBatch() and
+/// EcDsaVerifyBatch().
+///
+typedef struct {
+  VOID           *Context;      ///< RSA or EC context holding the public key.
+  UINTN          HashNid;       ///< Hash NID of MessageHash. Only used for EC-DSA.
+  CONST UINT8    *MessageHash;  ///< Pointer to octet message hash to be checked.
+  UINTN          HashSize;      ///< Size of the message hash in bytes.
+  CONST UINT8    *Signature;    ///< Pointer to the signature to be verified.
+  UINTN          SigSize;       ///< Size of signature in bytes.
+  BOOLEAN        Result;        ///< Set to TRUE when the signature is valid.
+} CRYPTO_VERIFY_REQUEST;
+
 // =====================================================================================
 //    One-Way Cryptographic Hash Primitives
 // =====================================================================================
@@ -505,6 +529,33 @@ Sha256HashAll (
   OUT  UINT8       *HashValue
   );
 
+/**
+  Computes the SHA-256 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha256HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-256 digest value (32 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-256 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha256HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
 
@@ -636,6 +687,33 @@ Sha384HashAll (
   OUT  UINT8       *HashValue
   );
 
+/**
+  Computes the SHA-384 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha384HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-384 digest value (48 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-384 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha384HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-512 hash operations.
 
@@ -767,6 +845,33 @@ Sha512HashAll (
   OUT  UINT8       *HashValue
   );
 
+/**
+  Computes the SHA-512 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha512HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-512 digest value (64 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-512 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha512HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
 /**
   Parallel hash function ParallelHash256, as defined in NIST's Special Publication 800-185,
   published December 2016.
@@ -1685,6 +1790,31 @@ RsaPkcs1Verify (
   IN  UINTN        SigSize
   );
 
+/**
+  Verifies a batch of RSA-SSA signatures with EMSA-PKCS1-v1_5 encoding scheme
+  defined in RSA PKCS#1.
+
+  Each entry of Requests is verified as if by RsaPkcs1Verify() using the RSA
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once. The HashNid member is ignored.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+RsaPkcs1VerifyBatch (
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  );
+
 /**
   Carries out the RSA-SSA signature generation with EMSA-PSS encoding scheme.
 
@@ -4303,4 +4433,28 @@ EcDsaVerify (
   IN  UINTN        SigSize
   );
 
+/**
+  Verifies a batch of EC-DSA signatures.
+
+  Each entry of Requests is verified as if by EcDsaVerify() using the EC
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+EcDsaVerifyBatch (
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  );
+
 #endif // __BASE_CRYPT_LIB_H__
@@ -313,6 +313,33 @@ TlsShutdown (
   IN     VOID  *Tls
   );
 
+/**
+  Release a TLS session returned by TlsGetSession().
+
+  @param[in]  Session         Pointer to the TLS session to release.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  );
+
+/**
+  Checks whether the handshake of a TLS connection resumed a previous session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @retval  TRUE     The connection resumed the session set with TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID  *Tls
+  );
+
 /**
   Set a new TLS/SSL method for a particular TLS object.
 
@@ -458,6 +485,29 @@ TlsSetSessionId (
   IN     UINT16  SessionIdLen
   );
 
+/**
+  Sets a previously established TLS session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() for another TLS
+  connection to the same server. The handshake then offers to resume it, by
+  session ID, session ticket or TLS 1.3 pre-shared key, and falls back to a
+  full handshake if the server declines.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session to resume.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  );
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -751,6 +801,26 @@ TlsGetSessionId (
   IN OUT UINT16  *SessionIdLen
   );
 
+/**
+  Gets the resumable session established by the specified TLS connection.
+
+  This function returns a reference to the TLS/SSL session of the connection,
+  including the session ticket received from the server if any, which can be
+  resumed by a later connection with TlsSetSession(). The caller must release
+  it with TlsSessionFree().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  The TLS session, or NULL if Tls is invalid or the session can't be
+           resumed.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls
+  );
+
 /**
   Gets the client random data used in the specified TLS connection.
 
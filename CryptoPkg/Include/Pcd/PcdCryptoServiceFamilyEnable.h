@@ -162,6 +162,7 @@ typedef struct {
       UINT8    GetPublicKeyFromX509 : 1;
       UINT8    RsaOaepEncrypt       : 1;
       UINT8    RsaOaepDecrypt       : 1;
+      UINT8    Pkcs1VerifyBatch     : 1;
     } Services;
     UINT32    Family;
   } Rsa;
@@ -184,6 +185,7 @@ typedef struct {
       UINT8    Update         : 1;
       UINT8    Final          : 1;
       UINT8    HashAll        : 1;
+      UINT8    HashAllBatch   : 1;
     } Services;
     UINT32    Family;
   } Sha256;
@@ -195,6 +197,7 @@ typedef struct {
       UINT8    Update         : 1;
       UINT8    Final          : 1;
       UINT8    HashAll        : 1;
+      UINT8    HashAllBatch   : 1;
     } Services;
     UINT32    Family;
   } Sha384;
@@ -206,6 +209,7 @@ typedef struct {
       UINT8    Update         : 1;
       UINT8    Final          : 1;
       UINT8    HashAll        : 1;
+      UINT8    HashAllBatch   : 1;
     } Services;
     UINT32    Family;
   } Sha512;
@@ -308,6 +312,8 @@ typedef struct {
       UINT8    Read           : 1;
       UINT8    Write          : 1;
       UINT8    Shutdown       : 1;
+      UINT8    SessionFree    : 1;
+      UINT8    SessionReused  : 1;
     } Services;
     UINT32    Family;
   } Tls;
@@ -327,6 +333,7 @@ typedef struct {
       UINT8    HostPrivateKeyEx   : 1;
       UINT8    SignatureAlgoList  : 1;
       UINT8    EcCurve            : 1;
+      UINT8    Session            : 1;
     } Services;
     UINT32    Family;
   } TlsSet;
@@ -346,6 +353,7 @@ typedef struct {
       UINT8    HostPrivateKey       : 1;
       UINT8    CertRevocationList   : 1;
       UINT8    ExportKey            : 1;
+      UINT8    Session              : 1;
     } Services;
     UINT32    Family;
   } TlsGet;
@@ -425,6 +433,7 @@ typedef struct {
       UINT8    GetPrivateKeyFromPem          : 1;
       UINT8    DsaSign                       : 1;
       UINT8    DsaVerify                     : 1;
+      UINT8    DsaVerifyBatch                : 1;
     } Services;
     UINT32    Family;
   } Ec;
@@ -11,13 +11,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/MpService.h>
 
 /**
-  Dispatch the block task to each AP in PEI phase.
+  Start a procedure on each AP in DXE phase.
 
+  @param[in] Procedure          Procedure to run on each AP.
+  @param[in] ProcedureArgument  Argument of the procedure.
 **/
 VOID
 EFIAPI
-DispatchBlockToAp (
-  VOID
+DispatchToAp (
+  IN CRYPT_AP_PROCEDURE  Procedure,
+  IN VOID                *ProcedureArgument
   )
 {
   EFI_STATUS                Status;
@@ -30,20 +33,33 @@ DispatchBlockToAp (
                   );
   if (EFI_ERROR (Status)) {
     //
-    // Failed to locate MpServices Protocol, do parallel hash by one core.
+    // Failed to locate MpServices Protocol, the caller does the work by one core.
     //
-    DEBUG ((DEBUG_ERROR, "[DispatchBlockToApDxe] Failed to locate MpServices Protocol. Status = %r\n", Status));
+    DEBUG ((DEBUG_ERROR, "[DispatchToApDxe] Failed to locate MpServices Protocol. Status = %r\n", Status));
     return;
   }
 
   Status = MpServices->StartupAllAPs (
                          MpServices,
-                         ParallelHashApExecute,
+                         Procedure,
                          FALSE,
                          NULL,
                          0,
-                         NULL,
+                         ProcedureArgument,
                          NULL
                          );
   return;
 }
+
+/**
+  Dispatch the block task to each AP in DXE phase.
+
+**/
+VOID
+EFIAPI
+DispatchBlockToAp (
+  VOID
+  )
+{
+  DispatchToAp (ParallelHashApExecute, NULL);
+}
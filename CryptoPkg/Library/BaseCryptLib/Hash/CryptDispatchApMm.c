@@ -10,13 +10,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MmServicesTableLib.h>
 
 /**
-  Dispatch the block task to each AP in SMM mode.
+  Start a procedure on each AP in SMM mode.
 
+  @param[in] Procedure          Procedure to run on each AP.
+  @param[in] ProcedureArgument  Argument of the procedure.
 **/
 VOID
 EFIAPI
-DispatchBlockToAp (
-  VOID
+DispatchToAp (
+  IN CRYPT_AP_PROCEDURE  Procedure,
+  IN VOID                *ProcedureArgument
   )
 {
   UINTN  Index;
@@ -27,9 +30,22 @@ DispatchBlockToAp (
 
   for (Index = 0; Index < gMmst->NumberOfCpus; Index++) {
     if (Index != gMmst->CurrentlyExecutingCpu) {
-      gMmst->MmStartupThisAp (ParallelHashApExecute, Index, NULL);
+      gMmst->MmStartupThisAp (Procedure, Index, ProcedureArgument);
     }
   }
 
   return;
 }
+
+/**
+  Dispatch the block task to each AP in SMM mode.
+
+**/
+VOID
+EFIAPI
+DispatchBlockToAp (
+  VOID
+  )
+{
+  DispatchToAp (ParallelHashApExecute, NULL);
+}
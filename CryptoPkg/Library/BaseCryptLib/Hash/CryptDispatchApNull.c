@@ -0,0 +1,28 @@
+/** @file
+  Dispatch to APs Wrapper Implementation which does not support APs.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "CryptParallelHash.h"
+
+/**
+  Start a procedure on each AP.
+
+  No APs are available to this library instance, so the caller does all of
+  the work.
+
+  @param[in] Procedure          Procedure to run on each AP.
+  @param[in] ProcedureArgument  Argument of the procedure.
+**/
+VOID
+EFIAPI
+DispatchToAp (
+  IN CRYPT_AP_PROCEDURE  Procedure,
+  IN VOID                *ProcedureArgument
+  )
+{
+  return;
+}
@@ -13,13 +13,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PeiServicesLib.h>
 
 /**
-  Dispatch the block task to each AP in PEI phase.
+  Start a procedure on each AP in PEI phase.
 
+  @param[in] Procedure          Procedure to run on each AP.
+  @param[in] ProcedureArgument  Argument of the procedure.
 **/
 VOID
 EFIAPI
-DispatchBlockToAp (
-  VOID
+DispatchToAp (
+  IN CRYPT_AP_PROCEDURE  Procedure,
+  IN VOID                *ProcedureArgument
   )
 {
   EFI_STATUS               Status;
@@ -36,19 +39,32 @@ DispatchBlockToAp (
                                   );
   if (EFI_ERROR (Status)) {
     //
-    // Failed to locate MpServices Ppi, do parallel hash by one core.
+    // Failed to locate MpServices Ppi, the caller does the work by one core.
     //
-    DEBUG ((DEBUG_ERROR, "[DispatchBlockToApPei] Failed to locate MpServices Ppi. Status = %r\n", Status));
+    DEBUG ((DEBUG_ERROR, "[DispatchToApPei] Failed to locate MpServices Ppi. Status = %r\n", Status));
     return;
   }
 
   Status = MpServicesPpi->StartupAllAPs (
                             (CONST EFI_PEI_SERVICES **)PeiServices,
                             MpServicesPpi,
-                            ParallelHashApExecute,
+                            Procedure,
                             FALSE,
                             0,
-                            NULL
+                            ProcedureArgument
                             );
   return;
 }
+
+/**
+  Dispatch the block task to each AP in PEI phase.
+
+**/
+VOID
+EFIAPI
+DispatchBlockToAp (
+  VOID
+  )
+{
+  DispatchToAp (ParallelHashApExecute, NULL);
+}
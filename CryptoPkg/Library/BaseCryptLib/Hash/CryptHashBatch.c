@@ -0,0 +1,282 @@
+/** @file
+  Batched SHA-2 Digest Wrapper Implementation.
+
+  The requests of a batch are independent, so large batches are shared with the
+  APs: every processor claims the next unclaimed request until none are left.
+  The HashAll functions used here keep their context on the stack and do not
+  allocate memory, which is what makes them safe to run on an AP.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "CryptParallelHash.h"
+#include <Library/SynchronizationLib.h>
+
+///
+/// Batches with less data than this are hashed by the calling processor alone,
+/// as waking the APs would cost more than it saves.
+///
+#define HASH_BATCH_DISPATCH_THRESHOLD  SIZE_64KB
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_ALL_FUNCTION)(
+  IN   CONST VOID  *Data,
+  IN   UINTN       DataSize,
+  OUT  UINT8       *HashValue
+  );
+
+typedef struct {
+  HASH_ALL_FUNCTION      HashAll;
+  CRYPTO_HASH_REQUEST    *Requests;
+  UINT32                 RequestCount;
+  volatile UINT32        NextRequest;
+  volatile UINT32        CompletedCount;
+  UINTN                  ActiveWorkers;
+} HASH_BATCH_JOB;
+
+//
+// The job being worked on, guarded by mHashBatchLock. An AP may start after
+// the batch it was dispatched for has been finished by the other processors,
+// so it must find the job through this pointer and not through a stale
+// argument pointing into the caller's stack.
+//
+STATIC HASH_BATCH_JOB  *mHashBatchJob;
+STATIC SPIN_LOCK       mHashBatchLock;
+STATIC BOOLEAN         mHashBatchLockInitialized;
+
+/**
+  Hash requests of the current batch until none are left unclaimed.
+
+  Runs on the APs and on the calling processor.
+
+  @param[in] ProcedureArgument  Not used.
+**/
+VOID
+EFIAPI
+HashBatchApExecute (
+  IN VOID  *ProcedureArgument
+  )
+{
+  HASH_BATCH_JOB       *Job;
+  CRYPTO_HASH_REQUEST  *Request;
+  UINT32               Index;
+
+  AcquireSpinLock (&mHashBatchLock);
+  Job = mHashBatchJob;
+  if (Job != NULL) {
+    Job->ActiveWorkers++;
+  }
+
+  ReleaseSpinLock (&mHashBatchLock);
+
+  if (Job == NULL) {
+    return;
+  }
+
+  while (TRUE) {
+    Index = InterlockedIncrement (&Job->NextRequest) - 1;
+    if (Index >= Job->RequestCount) {
+      break;
+    }
+
+    Request         = &Job->Requests[Index];
+    Request->Result = Job->HashAll (Request->Data, Request->DataSize, Request->HashValue);
+    InterlockedIncrement (&Job->CompletedCount);
+  }
+
+  AcquireSpinLock (&mHashBatchLock);
+  Job->ActiveWorkers--;
+  ReleaseSpinLock (&mHashBatchLock);
+}
+
+/**
+  Computes the digest of each data buffer in a batch with HashAll.
+
+  @param[in]       HashAll       HashAll function of the digest algorithm.
+  @param[in, out]  Requests      Array of hash requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+
+**/
+STATIC
+BOOLEAN
+HashAllBatch (
+  IN      HASH_ALL_FUNCTION    HashAll,
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  HASH_BATCH_JOB  Job;
+  UINTN           TotalSize;
+  UINTN           Index;
+  UINTN           ActiveWorkers;
+  BOOLEAN         Status;
+
+  if (RequestCount == 0) {
+    return TRUE;
+  }
+
+  if (Requests == NULL) {
+    return FALSE;
+  }
+
+  TotalSize = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    Requests[Index].Result = FALSE;
+    if (TotalSize < HASH_BATCH_DISPATCH_THRESHOLD) {
+      TotalSize += MIN (Requests[Index].DataSize, HASH_BATCH_DISPATCH_THRESHOLD);
+    }
+  }
+
+  if ((RequestCount > 1) && (RequestCount < MAX_INT32) && (TotalSize >= HASH_BATCH_DISPATCH_THRESHOLD)) {
+    if (!mHashBatchLockInitialized) {
+      //
+      // Nothing has been dispatched yet, so no AP can be holding the lock.
+      //
+      InitializeSpinLock (&mHashBatchLock);
+      mHashBatchLockInitialized = TRUE;
+    }
+
+    Job.HashAll        = HashAll;
+    Job.Requests       = Requests;
+    Job.RequestCount   = (UINT32)RequestCount;
+    Job.NextRequest    = 0;
+    Job.CompletedCount = 0;
+    Job.ActiveWorkers  = 0;
+
+    AcquireSpinLock (&mHashBatchLock);
+    mHashBatchJob = &Job;
+    ReleaseSpinLock (&mHashBatchLock);
+
+    DispatchToAp (HashBatchApExecute, NULL);
+
+    //
+    // Join the APs (or do all of the work when none could be started), then
+    // wait for the requests claimed by APs that are still running.
+    //
+    HashBatchApExecute (NULL);
+    while (Job.CompletedCount < Job.RequestCount) {
+      CpuPause ();
+    }
+
+    //
+    // Retire the job so that late APs no longer find it, and wait for the
+    // ones that already did to let go of it.
+    //
+    AcquireSpinLock (&mHashBatchLock);
+    mHashBatchJob = NULL;
+    ReleaseSpinLock (&mHashBatchLock);
+    do {
+      AcquireSpinLock (&mHashBatchLock);
+      ActiveWorkers = Job.ActiveWorkers;
+      ReleaseSpinLock (&mHashBatchLock);
+    } while (ActiveWorkers != 0);
+  } else {
+    for (Index = 0; Index < RequestCount; Index++) {
+      Requests[Index].Result = HashAll (Requests[Index].Data, Requests[Index].DataSize, Requests[Index].HashValue);
+    }
+  }
+
+  Status = TRUE;
+  for (Index = 0; Index < RequestCount; Index++) {
+    Status = (BOOLEAN)(Status && Requests[Index].Result);
+  }
+
+  return Status;
+}
+
+/**
+  Computes the SHA-256 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha256HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-256 digest value (32 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-256 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha256HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  return HashAllBatch (Sha256HashAll, Requests, RequestCount);
+}
+
+/**
+  Computes the SHA-384 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha384HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-384 digest value (48 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-384 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha384HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  return HashAllBatch (Sha384HashAll, Requests, RequestCount);
+}
+
+/**
+  Computes the SHA-512 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha512HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-512 digest value (64 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-512 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha512HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  return HashAllBatch (Sha512HashAll, Requests, RequestCount);
+}
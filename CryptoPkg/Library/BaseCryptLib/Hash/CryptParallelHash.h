@@ -219,6 +219,17 @@ ParallelHashApExecute (
   IN VOID  *ProcedureArgument
   );
 
+/**
+  Procedure run on each AP by DispatchToAp().
+
+  @param[in] ProcedureArgument Argument of the procedure.
+**/
+typedef
+VOID
+(EFIAPI *CRYPT_AP_PROCEDURE)(
+  IN VOID  *ProcedureArgument
+  );
+
 /**
   Dispatch the block task to each AP.
 
@@ -229,4 +240,21 @@ DispatchBlockToAp (
   VOID
   );
 
+/**
+  Start a procedure on each AP.
+
+  Depending on the phase this may return before the APs have finished, or do
+  nothing at all when no APs are available, so Procedure must record its own
+  progress and the caller must be prepared to finish the work itself.
+
+  @param[in] Procedure          Procedure to run on each AP.
+  @param[in] ProcedureArgument  Argument of the procedure.
+**/
+VOID
+EFIAPI
+DispatchToAp (
+  IN CRYPT_AP_PROCEDURE  Procedure,
+  IN VOID                *ProcedureArgument
+  );
+
 #endif // CRYPT_PARALLEL_HASH_H_
@@ -61,4 +61,36 @@ WrapPkcs7Data (
   OUT UINTN        *WrapDataSize
   );
 
+/**
+  Look up the PKCS#7 chain cache for a signer certificate whose chain has
+  already been verified up to a trusted certificate.
+
+  @param[in]  AnchorDigest  SHA-256 digest of the trusted certificate.
+  @param[in]  SignerDigest  SHA-256 digest of the signer certificate.
+
+  @retval TRUE   The chain of the signer has been verified up to the
+                 trusted certificate.
+  @retval FALSE  The pair is not in the cache.
+
+**/
+BOOLEAN
+Pkcs7ChainCacheLookup (
+  IN CONST UINT8  *AnchorDigest,
+  IN CONST UINT8  *SignerDigest
+  );
+
+/**
+  Record in the PKCS#7 chain cache that the chain of a signer certificate
+  has been verified up to a trusted certificate.
+
+  @param[in]  AnchorDigest  SHA-256 digest of the trusted certificate.
+  @param[in]  SignerDigest  SHA-256 digest of the signer certificate.
+
+**/
+VOID
+Pkcs7ChainCacheRecord (
+  IN CONST UINT8  *AnchorDigest,
+  IN CONST UINT8  *SignerDigest
+  );
+
 #endif
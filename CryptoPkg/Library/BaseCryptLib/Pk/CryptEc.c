@@ -914,6 +914,61 @@ EcDsaSign (
   return TRUE;
 }
 
+/**
+  Get half of the EC-DSA signature size for the curve of an EC key.
+
+  @param[in]  EcKey  Pointer to the EC key.
+
+  @return  Size in bytes of each of R and S, or 0 if the curve is not supported.
+**/
+STATIC
+UINT8
+EcDsaGetHalfSigSize (
+  IN  CONST EC_KEY  *EcKey
+  )
+{
+  switch (EC_GROUP_get_curve_name (EC_KEY_get0_group (EcKey))) {
+    case NID_X9_62_prime256v1:
+      return 32;
+    case NID_secp384r1:
+      return 48;
+    case NID_secp521r1:
+      return 66;
+    case NID_brainpoolP512r1:
+      return 64;
+    default:
+      return 0;
+  }
+}
+
+/**
+  Check that the size of a message hash matches its hash NID.
+
+  @param[in]  HashNid   hash NID
+  @param[in]  HashSize  Size of the message hash in bytes.
+
+  @retval  TRUE   HashSize matches HashNid.
+  @retval  FALSE  HashSize does not match HashNid, or HashNid is not supported.
+**/
+STATIC
+BOOLEAN
+EcDsaCheckHashSize (
+  IN  UINTN  HashNid,
+  IN  UINTN  HashSize
+  )
+{
+  switch (HashNid) {
+    case CRYPTO_NID_SHA256:
+      return (BOOLEAN)(HashSize == SHA256_DIGEST_SIZE);
+    case CRYPTO_NID_SHA384:
+      return (BOOLEAN)(HashSize == SHA384_DIGEST_SIZE);
+    case CRYPTO_NID_SHA512:
+      return (BOOLEAN)(HashSize == SHA512_DIGEST_SIZE);
+    default:
+      return FALSE;
+  }
+}
+
 /**
   Verifies the EC-DSA signature.
 
@@ -949,9 +1004,7 @@ EcDsaVerify (
   )
 {
   INT32      Result;
-  EC_KEY     *EcKey;
   ECDSA_SIG  *EcDsaSig;
-  INT32      OpenSslNid;
   UINT8      HalfSize;
   BIGNUM     *R;
   BIGNUM     *S;
@@ -964,53 +1017,13 @@ EcDsaVerify (
     return FALSE;
   }
 
-  EcKey      = (EC_KEY *)EcContext;
-  OpenSslNid = EC_GROUP_get_curve_name (EC_KEY_get0_group (EcKey));
-  switch (OpenSslNid) {
-    case NID_X9_62_prime256v1:
-      HalfSize = 32;
-      break;
-    case NID_secp384r1:
-      HalfSize = 48;
-      break;
-    case NID_secp521r1:
-      HalfSize = 66;
-      break;
-    case NID_brainpoolP512r1:
-      HalfSize = 64;
-      break;
-    default:
-      return FALSE;
-  }
-
-  if (SigSize != (UINTN)(HalfSize * 2)) {
+  HalfSize = EcDsaGetHalfSigSize ((EC_KEY *)EcContext);
+  if ((HalfSize == 0) || (SigSize != (UINTN)(HalfSize * 2))) {
     return FALSE;
   }
 
-  switch (HashNid) {
-    case CRYPTO_NID_SHA256:
-      if (HashSize != SHA256_DIGEST_SIZE) {
-        return FALSE;
-      }
-
-      break;
-
-    case CRYPTO_NID_SHA384:
-      if (HashSize != SHA384_DIGEST_SIZE) {
-        return FALSE;
-      }
-
-      break;
-
-    case CRYPTO_NID_SHA512:
-      if (HashSize != SHA512_DIGEST_SIZE) {
-        return FALSE;
-      }
-
-      break;
-
-    default:
-      return FALSE;
+  if (!EcDsaCheckHashSize (HashNid, HashSize)) {
+    return FALSE;
   }
 
   EcDsaSig = ECDSA_SIG_new ();
@@ -1039,3 +1052,113 @@ EcDsaVerify (
 
   return (Result == 1);
 }
+
+/**
+  Verifies a batch of EC-DSA signatures.
+
+  Each entry of Requests is verified as if by EcDsaVerify() using the EC
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once.
+
+  One signature object is reused for every entry, and the curve of a context
+  is only looked up when it differs from the one of the previous entry.
+  Verification stays on the calling processor, as OpenSSL allocates memory
+  while verifying.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+EcDsaVerifyBatch (
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  )
+{
+  CRYPTO_VERIFY_REQUEST  *Request;
+  UINTN                  Index;
+  ECDSA_SIG              *EcDsaSig;
+  BIGNUM                 *R;
+  BIGNUM                 *S;
+  VOID                   *EcContext;
+  UINT8                  HalfSize;
+  BOOLEAN                Status;
+
+  if (RequestCount == 0) {
+    return TRUE;
+  }
+
+  if (Requests == NULL) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    Requests[Index].Result = FALSE;
+  }
+
+  EcDsaSig = ECDSA_SIG_new ();
+  R        = BN_new ();
+  S        = BN_new ();
+  if ((EcDsaSig == NULL) || (R == NULL) || (S == NULL)) {
+    ECDSA_SIG_free (EcDsaSig);
+    BN_free (R);
+    BN_free (S);
+    return FALSE;
+  }
+
+  //
+  // EcDsaSig owns R and S from here on; they are refilled for every entry.
+  //
+  ECDSA_SIG_set0 (EcDsaSig, R, S);
+
+  Status    = TRUE;
+  EcContext = NULL;
+  HalfSize  = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    Request = &Requests[Index];
+    if ((Request->Context == NULL) || (Request->MessageHash == NULL) || (Request->Signature == NULL)) {
+      Status = FALSE;
+      continue;
+    }
+
+    if (Request->Context != EcContext) {
+      EcContext = Request->Context;
+      HalfSize  = EcDsaGetHalfSigSize ((EC_KEY *)EcContext);
+    }
+
+    if ((HalfSize == 0) || (Request->SigSize != (UINTN)(HalfSize * 2)) ||
+        !EcDsaCheckHashSize (Request->HashNid, Request->HashSize))
+    {
+      Status = FALSE;
+      continue;
+    }
+
+    if ((BN_bin2bn (Request->Signature, (UINT32)HalfSize, R) == NULL) ||
+        (BN_bin2bn (Request->Signature + HalfSize, (UINT32)HalfSize, S) == NULL))
+    {
+      Status = FALSE;
+      continue;
+    }
+
+    Request->Result = (BOOLEAN)(ECDSA_do_verify (
+                                  Request->MessageHash,
+                                  (UINT32)Request->HashSize,
+                                  EcDsaSig,
+                                  (EC_KEY *)EcContext
+                                  ) == 1);
+    if (!Request->Result) {
+      Status = FALSE;
+    }
+  }
+
+  ECDSA_SIG_free (EcDsaSig);
+
+  return Status;
+}
@@ -0,0 +1,107 @@
+/** @file
+  Cache of the PKCS#7 signer certificate chains already verified up to a
+  trusted certificate.
+
+  Pkcs7Verify() is called again and again with the same signers and trusted
+  certificates, e.g. for every authenticated variable write or every image
+  checked against db. The chain verification is deterministic there: time
+  checks are disabled and no CRL is used, so a chain verified once stays
+  valid for as long as the same trusted certificate is passed. Only the
+  signature of the content then needs to be verified again.
+
+  The entries are keyed by the SHA-256 digests of the DER encodings of both
+  certificates, so an entry can only be hit with the very trusted
+  certificate it was verified against. Only successful verifications are
+  recorded. The cache is bounded and the oldest entry is replaced first.
+
+  The cache is bypassed when PcdPkcs7ChainCacheEnable is FALSE, e.g. to
+  measure the cost of a full verification.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include <Library/PcdLib.h>
+
+#define PKCS7_CHAIN_CACHE_SIZE  16
+
+typedef struct {
+  BOOLEAN    Valid;
+  UINT8      AnchorDigest[SHA256_DIGEST_SIZE];
+  UINT8      SignerDigest[SHA256_DIGEST_SIZE];
+} PKCS7_CHAIN_CACHE_ENTRY;
+
+STATIC PKCS7_CHAIN_CACHE_ENTRY  mPkcs7ChainCache[PKCS7_CHAIN_CACHE_SIZE];
+STATIC UINTN                    mPkcs7ChainCacheNext;
+
+/**
+  Look up the PKCS#7 chain cache for a signer certificate whose chain has
+  already been verified up to a trusted certificate.
+
+  @param[in]  AnchorDigest  SHA-256 digest of the trusted certificate.
+  @param[in]  SignerDigest  SHA-256 digest of the signer certificate.
+
+  @retval TRUE   The chain of the signer has been verified up to the
+                 trusted certificate.
+  @retval FALSE  The pair is not in the cache, or the cache is disabled.
+
+**/
+BOOLEAN
+Pkcs7ChainCacheLookup (
+  IN CONST UINT8  *AnchorDigest,
+  IN CONST UINT8  *SignerDigest
+  )
+{
+  UINTN  Index;
+
+  if (!PcdGetBool (PcdPkcs7ChainCacheEnable)) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < PKCS7_CHAIN_CACHE_SIZE; Index++) {
+    if (mPkcs7ChainCache[Index].Valid &&
+        (CompareMem (mPkcs7ChainCache[Index].SignerDigest, SignerDigest, SHA256_DIGEST_SIZE) == 0) &&
+        (CompareMem (mPkcs7ChainCache[Index].AnchorDigest, AnchorDigest, SHA256_DIGEST_SIZE) == 0))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Record in the PKCS#7 chain cache that the chain of a signer certificate
+  has been verified up to a trusted certificate.
+
+  Nothing is recorded when the cache is disabled.
+
+  @param[in]  AnchorDigest  SHA-256 digest of the trusted certificate.
+  @param[in]  SignerDigest  SHA-256 digest of the signer certificate.
+
+**/
+VOID
+Pkcs7ChainCacheRecord (
+  IN CONST UINT8  *AnchorDigest,
+  IN CONST UINT8  *SignerDigest
+  )
+{
+  PKCS7_CHAIN_CACHE_ENTRY  *Entry;
+
+  if (!PcdGetBool (PcdPkcs7ChainCacheEnable)) {
+    return;
+  }
+
+  if (Pkcs7ChainCacheLookup (AnchorDigest, SignerDigest)) {
+    return;
+  }
+
+  Entry = &mPkcs7ChainCache[mPkcs7ChainCacheNext];
+  CopyMem (Entry->AnchorDigest, AnchorDigest, SHA256_DIGEST_SIZE);
+  CopyMem (Entry->SignerDigest, SignerDigest, SHA256_DIGEST_SIZE);
+  Entry->Valid = TRUE;
+
+  mPkcs7ChainCacheNext = (mPkcs7ChainCacheNext + 1) % PKCS7_CHAIN_CACHE_SIZE;
+}
@@ -0,0 +1,45 @@
+/** @file
+  PKCS#7 chain cache which does not cache anything, for the phases where
+  module globals cannot be written.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+
+/**
+  Look up the PKCS#7 chain cache for a signer certificate whose chain has
+  already been verified up to a trusted certificate.
+
+  @param[in]  AnchorDigest  SHA-256 digest of the trusted certificate.
+  @param[in]  SignerDigest  SHA-256 digest of the signer certificate.
+
+  @retval FALSE  The pair is never cached.
+
+**/
+BOOLEAN
+Pkcs7ChainCacheLookup (
+  IN CONST UINT8  *AnchorDigest,
+  IN CONST UINT8  *SignerDigest
+  )
+{
+  return FALSE;
+}
+
+/**
+  Record in the PKCS#7 chain cache that the chain of a signer certificate
+  has been verified up to a trusted certificate.
+
+  @param[in]  AnchorDigest  SHA-256 digest of the trusted certificate.
+  @param[in]  SignerDigest  SHA-256 digest of the signer certificate.
+
+**/
+VOID
+Pkcs7ChainCacheRecord (
+  IN CONST UINT8  *AnchorDigest,
+  IN CONST UINT8  *SignerDigest
+  )
+{
+}
@@ -747,11 +747,67 @@ _Error:
   return Status;
 }
 
+/**
+  Check whether the certificate chains of all the signers of a PKCS#7 signed
+  data are known to be verified up to a trusted certificate, or record that
+  they are.
+
+  @param[in]  Pkcs7         PKCS#7 signed data.
+  @param[in]  AnchorDigest  SHA-256 digest of the trusted certificate.
+  @param[in]  Record        FALSE to look up the chain cache, TRUE to record
+                            the signers in it.
+
+  @retval  TRUE   The chains of all the signers are cached, or were recorded.
+  @retval  FALSE  A signer is not cached, or could not be recorded.
+
+**/
+STATIC
+BOOLEAN
+Pkcs7SignerChainsCached (
+  IN PKCS7        *Pkcs7,
+  IN CONST UINT8  *AnchorDigest,
+  IN BOOLEAN      Record
+  )
+{
+  STACK_OF (X509)  *Signers;
+  UINT8         SignerDigest[SHA256_DIGEST_SIZE];
+  unsigned int  DigestSize;
+  int           Index;
+  BOOLEAN       Cached;
+
+  Signers = PKCS7_get0_signers (Pkcs7, NULL, PKCS7_BINARY);
+  if (Signers == NULL) {
+    return FALSE;
+  }
+
+  Cached = (BOOLEAN)(sk_X509_num (Signers) > 0);
+  for (Index = 0; Index < sk_X509_num (Signers); Index++) {
+    if (!X509_digest (sk_X509_value (Signers, Index), EVP_sha256 (), SignerDigest, &DigestSize)) {
+      Cached = FALSE;
+      break;
+    }
+
+    if (Record) {
+      Pkcs7ChainCacheRecord (AnchorDigest, SignerDigest);
+    } else if (!Pkcs7ChainCacheLookup (AnchorDigest, SignerDigest)) {
+      Cached = FALSE;
+      break;
+    }
+  }
+
+  sk_X509_free (Signers);
+  return Cached;
+}
+
 /**
   Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
   Cryptographic Message Syntax Standard". The input signed data could be wrapped
   in a ContentInfo structure.
 
+  The certificate chains of the signers verified up to TrustedCert are
+  cached, so that repeated verifications with the same signers and trusted
+  certificate only verify the signature of the content.
+
   If P7Data, TrustedCert or InData is NULL, then return FALSE.
   If P7Length, CertLength or DataLength overflow, then return FALSE.
 
@@ -791,6 +847,9 @@ Pkcs7Verify (
   CONST UINT8  *Temp;
   UINTN        SignedDataSize;
   BOOLEAN      Wrapped;
+  UINT8        AnchorDigest[SHA256_DIGEST_SIZE];
+  unsigned int DigestSize;
+  BOOLEAN      ChainCached;
 
   //
   // Check input parameters.
@@ -906,10 +965,33 @@ Pkcs7Verify (
   //
   X509_STORE_set_purpose (CertStore, X509_PURPOSE_ANY);
 
+  //
+  // Skip the chain verification when the chains of all signers have already
+  // been verified up to this trusted certificate. The signature of the
+  // content is always verified.
+  //
+  ChainCached = FALSE;
+  if (X509_digest (Cert, EVP_sha256 (), AnchorDigest, &DigestSize)) {
+    ChainCached = Pkcs7SignerChainsCached (Pkcs7, AnchorDigest, FALSE);
+  } else {
+    ZeroMem (AnchorDigest, sizeof (AnchorDigest));
+    DigestSize = 0;
+  }
+
   //
   // Verifies the PKCS#7 signedData structure
   //
-  Status = (BOOLEAN)PKCS7_verify (Pkcs7, NULL, CertStore, DataBio, NULL, PKCS7_BINARY);
+  Status = (BOOLEAN)PKCS7_verify (
+                      Pkcs7,
+                      NULL,
+                      CertStore,
+                      DataBio,
+                      NULL,
+                      ChainCached ? (PKCS7_BINARY | PKCS7_NOVERIFY) : PKCS7_BINARY
+                      );
+  if (Status && !ChainCached && (DigestSize == SHA256_DIGEST_SIZE)) {
+    Pkcs7SignerChainsCached (Pkcs7, AnchorDigest, TRUE);
+  }
 
 _Exit:
   //
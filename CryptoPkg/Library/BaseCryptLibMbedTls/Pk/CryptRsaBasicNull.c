@@ -119,3 +119,32 @@ RsaPkcs1Verify (
   ASSERT (FALSE);
   return FALSE;
 }
+
+/**
+  Verifies a batch of RSA-SSA signatures with EMSA-PKCS1-v1_5 encoding scheme
+  defined in RSA PKCS#1.
+
+  Each entry of Requests is verified as if by RsaPkcs1Verify() using the RSA
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once. The HashNid member is ignored.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+RsaPkcs1VerifyBatch (
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
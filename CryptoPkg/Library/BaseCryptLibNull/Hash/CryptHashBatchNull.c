@@ -0,0 +1,96 @@
+/** @file
+  Batched SHA-2 Digest Wrapper Null Implementation.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+
+/**
+  Computes the SHA-256 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha256HashAll(), and its Result
+  member reports whether that digest was computed.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-256 digest value (32 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-256 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha256HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
+/**
+  Computes the SHA-384 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha384HashAll(), and its Result
+  member reports whether that digest was computed.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-384 digest value (48 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-384 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha384HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
+/**
+  Computes the SHA-512 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha512HashAll(), and its Result
+  member reports whether that digest was computed.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-512 digest value (64 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-512 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha512HashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
@@ -576,3 +576,31 @@ EcDsaVerify (
   ASSERT (FALSE);
   return FALSE;
 }
+
+/**
+  Verifies a batch of EC-DSA signatures.
+
+  Each entry of Requests is verified as if by EcDsaVerify() using the EC
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+EcDsaVerifyBatch (
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
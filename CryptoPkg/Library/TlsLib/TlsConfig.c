@@ -595,6 +595,44 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a previously established TLS session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() for another TLS
+  connection to the same server. The handshake then offers to resume it, by
+  session ID, session ticket or TLS 1.3 pre-shared key, and falls back to a
+  full handshake if the server declines.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session to resume.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Session == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_set_session (TlsConn->Ssl, (SSL_SESSION *)Session) != 1) {
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -1308,6 +1346,48 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the resumable session established by the specified TLS connection.
+
+  This function returns a reference to the TLS/SSL session of the connection,
+  including the session ticket received from the server if any, which can be
+  resumed by a later connection with TlsSetSession(). The caller must release
+  it with TlsSessionFree().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  The TLS session, or NULL if Tls is invalid or the session can't be
+           resumed.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *Session;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL)) {
+    return NULL;
+  }
+
+  Session = SSL_get1_session (TlsConn->Ssl);
+  if (Session == NULL) {
+    return NULL;
+  }
+
+  if (SSL_SESSION_is_resumable (Session) != 1) {
+    SSL_SESSION_free (Session);
+    return NULL;
+  }
+
+  return Session;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -497,3 +497,46 @@ TlsShutdown (
   SSL_shutdown (TlsConn->Ssl);
   return SSL_clear (TlsConn->Ssl) == 1 ? EFI_SUCCESS : EFI_PROTOCOL_ERROR;
 }
+
+/**
+  Release a TLS session returned by TlsGetSession().
+
+  @param[in]  Session         Pointer to the TLS session to release.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  if (Session != NULL) {
+    SSL_SESSION_free ((SSL_SESSION *)Session);
+  }
+}
+
+/**
+  Checks whether the handshake of a TLS connection resumed a previous session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @retval  TRUE     The connection resumed the session set with TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(SSL_session_reused (TlsConn->Ssl) == 1);
+}
@@ -268,3 +268,37 @@ TlsShutdown (
   ASSERT (FALSE);
   return EFI_UNSUPPORTED;
 }
+
+/**
+  Release a TLS session returned by TlsGetSession().
+
+  @param[in]  Session         Pointer to the TLS session to release.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Checks whether the handshake of a TLS connection resumed a previous session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @retval  TRUE     The connection resumed the session set with TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
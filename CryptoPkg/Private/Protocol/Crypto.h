@@ -21,7 +21,7 @@
 /// the EDK II Crypto Protocol is extended, this version define must be
 /// increased.
 ///
-#define EDKII_CRYPTO_VERSION  17
+#define EDKII_CRYPTO_VERSION  19
 
 ///
 /// EDK II Crypto Protocol forward declaration
@@ -1604,6 +1604,31 @@ BOOLEAN
   IN  UINTN        SigSize
   );
 
+/**
+  Verifies a batch of RSA-SSA signatures with EMSA-PKCS1-v1_5 encoding scheme
+  defined in RSA PKCS#1.
+
+  Each entry of Requests is verified as if by RsaPkcs1Verify() using the RSA
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once. The HashNid member is ignored.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_RSA_PKCS1_VERIFY_BATCH)(
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  );
+
 /**
   Retrieve the RSA Private Key from the password-protected PEM key data.
 
@@ -1933,6 +1958,33 @@ BOOLEAN
   OUT  UINT8                       *HashValue
   );
 
+/**
+  Computes the SHA-256 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha256HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-256 digest value (32 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-256 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_SHA256_HASH_ALL_BATCH)(
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
   If this interface is not supported, then return zero.
@@ -2066,6 +2118,33 @@ BOOLEAN
   OUT  UINT8       *HashValue
   );
 
+/**
+  Computes the SHA-384 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha384HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-384 digest value (48 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-384 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_SHA384_HASH_ALL_BATCH)(
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-512 hash operations.
 
@@ -2197,6 +2276,33 @@ BOOLEAN
   OUT  UINT8       *HashValue
   );
 
+/**
+  Computes the SHA-512 message digest of each data buffer in a batch.
+
+  Each entry of Requests is hashed as if by Sha512HashAll(), and its Result
+  member reports whether that digest was computed. Where the library instance
+  can start application processors, large batches are spread across them; the
+  digests are always complete when this function returns.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests. Each HashValue receives
+                                 the SHA-512 digest value (64 bytes).
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All SHA-512 digest computations succeeded.
+  @retval FALSE  Requests is NULL and RequestCount is not zero.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_SHA512_HASH_ALL_BATCH)(
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
 // ----------------------------------------------------------------------------
 // X509
 // ----------------------------------------------------------------------------
@@ -4281,6 +4387,76 @@ EFI_STATUS
   IN     UINTN                    KeyBufferLen
   );
 
+/**
+  Sets a previously established TLS session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() for another TLS
+  connection to the same server. The handshake then offers to resume it, by
+  session ID, session ticket or TLS 1.3 pre-shared key, and falls back to a
+  full handshake if the server declines.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session to resume.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_CRYPTO_TLS_SET_SESSION)(
+  IN     VOID                     *Tls,
+  IN     VOID                     *Session
+  );
+
+/**
+  Gets the resumable session established by the specified TLS connection.
+
+  This function returns a reference to the TLS/SSL session of the connection,
+  including the session ticket received from the server if any, which can be
+  resumed by a later connection with TlsSetSession(). The caller must release
+  it with TlsSessionFree().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  The TLS session, or NULL if Tls is invalid or the session can't be
+           resumed.
+
+**/
+typedef
+VOID *
+(EFIAPI *EDKII_CRYPTO_TLS_GET_SESSION)(
+  IN     VOID                     *Tls
+  );
+
+/**
+  Release a TLS session returned by TlsGetSession().
+
+  @param[in]  Session         Pointer to the TLS session to release.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_CRYPTO_TLS_SESSION_FREE)(
+  IN     VOID                     *Session
+  );
+
+/**
+  Checks whether the handshake of a TLS connection resumed a previous session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @retval  TRUE     The connection resumed the session set with TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or Tls is invalid.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_TLS_SESSION_REUSED)(
+  IN     VOID                     *Tls
+  );
+
 /**
   Gets the CA-supplied certificate revocation list data set in the specified
   TLS object.
@@ -5424,6 +5600,30 @@ BOOLEAN
   IN  UINTN        SigSize
   );
 
+/**
+  Verifies a batch of EC-DSA signatures.
+
+  Each entry of Requests is verified as if by EcDsaVerify() using the EC
+  context in its Context member, and its Result member reports whether the
+  signature is valid. Entries may share one context, so a key used for many
+  signatures only has to be set up once.
+
+  @param[in, out]  Requests      Array of verification requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval  TRUE   All signatures are valid.
+  @retval  FALSE  Requests is NULL and RequestCount is not zero.
+  @retval  FALSE  At least one signature is invalid.
+  @retval  FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_EC_DSA_VERIFY_BATCH)(
+  IN OUT  CRYPTO_VERIFY_REQUEST  *Requests,
+  IN      UINTN                  RequestCount
+  );
+
 ///
 /// EDK II Crypto Protocol
 ///
@@ -5710,6 +5910,17 @@ struct _EDKII_CRYPTO_PROTOCOL {
   EDKII_CRYPTO_PKCS1V2_DECRYPT                        Pkcs1v2Decrypt;
   EDKII_CRYPTO_RSA_OAEP_ENCRYPT                       RsaOaepEncrypt;
   EDKII_CRYPTO_RSA_OAEP_DECRYPT                       RsaOaepDecrypt;
+  /// TLS session resumption
+  EDKII_CRYPTO_TLS_SET_SESSION                        TlsSetSession;
+  EDKII_CRYPTO_TLS_GET_SESSION                        TlsGetSession;
+  EDKII_CRYPTO_TLS_SESSION_FREE                       TlsSessionFree;
+  EDKII_CRYPTO_TLS_SESSION_REUSED                     TlsSessionReused;
+  /// Batched hash and signature verification
+  EDKII_CRYPTO_SHA256_HASH_ALL_BATCH                  Sha256HashAllBatch;
+  EDKII_CRYPTO_SHA384_HASH_ALL_BATCH                  Sha384HashAllBatch;
+  EDKII_CRYPTO_SHA512_HASH_ALL_BATCH                  Sha512HashAllBatch;
+  EDKII_CRYPTO_RSA_PKCS1_VERIFY_BATCH                 RsaPkcs1VerifyBatch;
+  EDKII_CRYPTO_EC_DSA_VERIFY_BATCH                    EcDsaVerifyBatch;
 };
 
 extern GUID  gEdkiiCryptoProtocolGuid;
@@ -992,6 +992,31 @@ TestVerifyAuthenticodeVerify (
   return UNIT_TEST_PASSED;
 }
 
+STATIC
+BOOLEAN
+AuthenticodeVerifyOperation (
+  IN VOID  *Context
+  )
+{
+  return AuthenticodeVerify (
+           AuthenticodeWithSha256,
+           sizeof (AuthenticodeWithSha256),
+           TestRootCert2,
+           sizeof (TestRootCert2),
+           PeSha256Hash,
+           SHA256_DIGEST_SIZE
+           );
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAuthenticodeVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return RunCryptoChainBenchmark ("AuthenticodeVerifyCold", "AuthenticodeVerifyWarm", AuthenticodeVerifyOperation, NULL);
+}
+
 TEST_DESC  mAuthenticodeTest[] = {
   //
   // -----Description--------------------------------------Class----------------------Function-----------------Pre---Post--Context
@@ -0,0 +1,358 @@
+/** @file
+  Application for Cryptographic Primitives Performance Benchmarks.
+
+  Every benchmark reports one machine-readable line through the unit test log
+  and the debug output:
+
+    CRYPTO_BENCHMARK,<Name>,<Iterations>,<ElapsedNs>,<Rate>,<Unit>
+
+  Unit is "MB/s" (10^6 bytes per second) for hash, HMAC and cipher primitives
+  and "ops/s" for signature verification. The suite is linked against every
+  BaseCryptLib backend the unit test is built with, so the lines can be
+  compared across backends and tracked across builds.
+
+  The PKCS#7 and Authenticode verifications are reported twice: "Cold" with
+  the signer chain cache of BaseCryptLib disabled through
+  PcdPkcs7ChainCacheEnable, so that every iteration verifies the full chain,
+  and "Warm" with the cache enabled, so that the chain is only verified once.
+  Backends without the cache report the same rate twice.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TestBaseCryptLib.h"
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
+
+///
+/// Size of the buffer processed by each hash, HMAC and cipher operation.
+///
+#define CRYPTO_BENCHMARK_DATA_SIZE  SIZE_16KB
+
+///
+/// A measurement is repeated with twice the iterations until it runs for at
+/// least this long.
+///
+#define CRYPTO_BENCHMARK_MIN_DURATION_NS  100000000ULL
+
+#define CRYPTO_BENCHMARK_MAX_ITERATIONS  0x100000
+
+#define CRYPTO_BENCHMARK_FORMAT  "CRYPTO_BENCHMARK,%a,%lu,%lu,%lu,%a\n"
+
+typedef
+BOOLEAN
+(EFIAPI *CRYPTO_BENCHMARK_HASH_ALL)(
+  IN   CONST VOID  *Data,
+  IN   UINTN       DataSize,
+  OUT  UINT8       *HashValue
+  );
+
+typedef struct {
+  CHAR8                        *Name;
+  CRYPTO_BENCHMARK_HASH_ALL    HashAll;
+} CRYPTO_BENCHMARK_HASH;
+
+GLOBAL_REMOVE_IF_UNREFERENCED UINT8  mBenchmarkData[CRYPTO_BENCHMARK_DATA_SIZE];
+GLOBAL_REMOVE_IF_UNREFERENCED UINT8  mBenchmarkOutput[CRYPTO_BENCHMARK_DATA_SIZE];
+GLOBAL_REMOVE_IF_UNREFERENCED UINT8  mBenchmarkKey[32];
+GLOBAL_REMOVE_IF_UNREFERENCED UINT8  mBenchmarkIvec[16];
+GLOBAL_REMOVE_IF_UNREFERENCED UINT8  mBenchmarkDigest[SHA512_DIGEST_SIZE];
+
+CRYPTO_BENCHMARK_HASH  mBenchmarkSha1   = { "Sha1HashAll", Sha1HashAll };
+CRYPTO_BENCHMARK_HASH  mBenchmarkSha256 = { "Sha256HashAll", Sha256HashAll };
+CRYPTO_BENCHMARK_HASH  mBenchmarkSha384 = { "Sha384HashAll", Sha384HashAll };
+CRYPTO_BENCHMARK_HASH  mBenchmarkSha512 = { "Sha512HashAll", Sha512HashAll };
+CRYPTO_BENCHMARK_HASH  mBenchmarkSm3    = { "Sm3HashAll", Sm3HashAll };
+
+/**
+  Converts two performance counter samples into elapsed nanoseconds, taking
+  the counting direction and a single roll over into account.
+
+  @param[in]  Start  Counter value sampled first.
+  @param[in]  End    Counter value sampled last.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+STATIC
+UINT64
+BenchmarkElapsedNs (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+  UINT64  Ticks;
+
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterStart < CounterEnd) {
+    if (End >= Start) {
+      Ticks = End - Start;
+    } else {
+      Ticks = (CounterEnd - Start) + (End - CounterStart) + 1;
+    }
+  } else {
+    if (Start >= End) {
+      Ticks = Start - End;
+    } else {
+      Ticks = (Start - CounterEnd) + (CounterStart - End) + 1;
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Measures an operation and reports its throughput or rate.
+
+  The operation is called once to warm up, then timed over a doubling number
+  of iterations until the measurement runs for at least
+  CRYPTO_BENCHMARK_MIN_DURATION_NS.
+
+  @param[in]  Name               Name reported for the benchmark.
+  @param[in]  BytesPerOperation  Bytes processed by one call to Operation, or
+                                 zero to report operations per second.
+  @param[in]  Operation          Operation to measure.
+  @param[in]  Context            Context passed to Operation.
+
+  @retval UNIT_TEST_PASSED             The result was reported.
+  @retval UNIT_TEST_SKIPPED            The backend does not support the
+                                       operation, or the performance counter
+                                       does not advance.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The operation failed after succeeding
+                                       once.
+
+**/
+UNIT_TEST_STATUS
+RunCryptoBenchmark (
+  IN CONST CHAR8                 *Name,
+  IN UINTN                       BytesPerOperation,
+  IN CRYPTO_BENCHMARK_OPERATION  Operation,
+  IN VOID                        *Context
+  )
+{
+  UINT64  Iterations;
+  UINT64  Index;
+  UINT64  Start;
+  UINT64  ElapsedNs;
+  UINT64  Rate;
+  CHAR8   *Unit;
+
+  if (!Operation (Context)) {
+    UT_LOG_WARNING ("%a is not supported by this BaseCryptLib instance\n", Name);
+    return UNIT_TEST_SKIPPED;
+  }
+
+  Iterations = 1;
+  while (TRUE) {
+    Start = GetPerformanceCounter ();
+    for (Index = 0; Index < Iterations; Index++) {
+      if (!Operation (Context)) {
+        UT_LOG_ERROR ("%a failed in iteration %lu\n", Name, Index);
+        return UNIT_TEST_ERROR_TEST_FAILED;
+      }
+    }
+
+    ElapsedNs = BenchmarkElapsedNs (Start, GetPerformanceCounter ());
+    if ((ElapsedNs >= CRYPTO_BENCHMARK_MIN_DURATION_NS) || (Iterations >= CRYPTO_BENCHMARK_MAX_ITERATIONS)) {
+      break;
+    }
+
+    Iterations = LShiftU64 (Iterations, 1);
+  }
+
+  if (ElapsedNs == 0) {
+    UT_LOG_WARNING ("%a: the performance counter did not advance\n", Name);
+    return UNIT_TEST_SKIPPED;
+  }
+
+  if (BytesPerOperation != 0) {
+    //
+    // Bytes per nanosecond times 1000 is 10^6 bytes per second.
+    //
+    Rate = DivU64x64Remainder (MultU64x64 (MultU64x64 (Iterations, BytesPerOperation), 1000), ElapsedNs, NULL);
+    Unit = "MB/s";
+  } else {
+    Rate = DivU64x64Remainder (MultU64x32 (Iterations, 1000000000), ElapsedNs, NULL);
+    Unit = "ops/s";
+  }
+
+  UT_LOG_INFO (CRYPTO_BENCHMARK_FORMAT, Name, Iterations, ElapsedNs, Rate, Unit);
+  DEBUG ((DEBUG_INFO, CRYPTO_BENCHMARK_FORMAT, Name, Iterations, ElapsedNs, Rate, Unit));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measures a verification going through Pkcs7Verify() with the signer chain
+  cache of BaseCryptLib disabled, then enabled.
+
+  Nothing is recorded in the cache while it is disabled, so the warm up call
+  of the second measurement is the one filling it.
+
+  @param[in]  ColdName   Name reported for the benchmark without the cache.
+  @param[in]  WarmName   Name reported for the benchmark with the cache.
+  @param[in]  Operation  Operation to measure.
+  @param[in]  Context    Context passed to Operation.
+
+  @retval UNIT_TEST_PASSED             Both results were reported.
+  @retval UNIT_TEST_SKIPPED            The operation is not supported.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The operation failed after succeeding
+                                       once.
+
+**/
+UNIT_TEST_STATUS
+RunCryptoChainBenchmark (
+  IN CONST CHAR8                 *ColdName,
+  IN CONST CHAR8                 *WarmName,
+  IN CRYPTO_BENCHMARK_OPERATION  Operation,
+  IN VOID                        *Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+  BOOLEAN           CacheEnable;
+
+  CacheEnable = PcdGetBool (PcdPkcs7ChainCacheEnable);
+
+  PatchPcdSetBool (PcdPkcs7ChainCacheEnable, FALSE);
+  TestStatus = RunCryptoBenchmark (ColdName, 0, Operation, Context);
+  if (TestStatus == UNIT_TEST_PASSED) {
+    PatchPcdSetBool (PcdPkcs7ChainCacheEnable, TRUE);
+    TestStatus = RunCryptoBenchmark (WarmName, 0, Operation, Context);
+  }
+
+  PatchPcdSetBool (PcdPkcs7ChainCacheEnable, CacheEnable);
+  return TestStatus;
+}
+
+STATIC
+BOOLEAN
+HashAllOperation (
+  IN VOID  *Context
+  )
+{
+  return ((CRYPTO_BENCHMARK_HASH *)Context)->HashAll (mBenchmarkData, sizeof (mBenchmarkData), mBenchmarkDigest);
+}
+
+STATIC
+BOOLEAN
+HmacSha256AllOperation (
+  IN VOID  *Context
+  )
+{
+  return HmacSha256All (mBenchmarkData, sizeof (mBenchmarkData), mBenchmarkKey, sizeof (mBenchmarkKey), mBenchmarkDigest);
+}
+
+STATIC
+BOOLEAN
+AesCbcEncryptOperation (
+  IN VOID  *Context
+  )
+{
+  return AesCbcEncrypt (Context, mBenchmarkData, sizeof (mBenchmarkData), mBenchmarkIvec, mBenchmarkOutput);
+}
+
+STATIC
+BOOLEAN
+AeadAesGcmEncryptOperation (
+  IN VOID  *Context
+  )
+{
+  UINTN  OutBufferSize;
+
+  OutBufferSize = sizeof (mBenchmarkOutput);
+  return AeadAesGcmEncrypt (
+           mBenchmarkKey,
+           sizeof (mBenchmarkKey),
+           mBenchmarkIvec,
+           12,
+           NULL,
+           0,
+           mBenchmarkData,
+           sizeof (mBenchmarkData),
+           mBenchmarkDigest,
+           16,
+           mBenchmarkOutput,
+           &OutBufferSize
+           );
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkHashAll (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRYPTO_BENCHMARK_HASH  *Hash;
+
+  Hash = (CRYPTO_BENCHMARK_HASH *)Context;
+  return RunCryptoBenchmark (Hash->Name, sizeof (mBenchmarkData), HashAllOperation, Hash);
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkHmacSha256All (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return RunCryptoBenchmark ("HmacSha256All", sizeof (mBenchmarkData), HmacSha256AllOperation, NULL);
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAesCbcEncrypt (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+  VOID              *AesContext;
+  UINTN             AesContextSize;
+
+  AesContextSize = AesGetContextSize ();
+  if (AesContextSize == 0) {
+    UT_LOG_WARNING ("AesCbcEncrypt is not supported by this BaseCryptLib instance\n");
+    return UNIT_TEST_SKIPPED;
+  }
+
+  AesContext = AllocatePool (AesContextSize);
+  UT_ASSERT_NOT_NULL (AesContext);
+  UT_ASSERT_TRUE (AesInit (AesContext, mBenchmarkKey, 128));
+
+  TestStatus = RunCryptoBenchmark ("Aes128CbcEncrypt", sizeof (mBenchmarkData), AesCbcEncryptOperation, AesContext);
+
+  FreePool (AesContext);
+  return TestStatus;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAeadAesGcmEncrypt (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return RunCryptoBenchmark ("Aes256GcmEncrypt", sizeof (mBenchmarkData), AeadAesGcmEncryptOperation, NULL);
+}
+
+TEST_DESC  mBenchmarkTest[] = {
+  //
+  // -----Description-------------------------Class----------------------------------Function-----------------------Pre---Post--Context
+  //
+  { "BenchmarkSha1HashAll()",        "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkHashAll,            NULL, NULL, &mBenchmarkSha1   },
+  { "BenchmarkSha256HashAll()",      "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkHashAll,            NULL, NULL, &mBenchmarkSha256 },
+  { "BenchmarkSha384HashAll()",      "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkHashAll,            NULL, NULL, &mBenchmarkSha384 },
+  { "BenchmarkSha512HashAll()",      "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkHashAll,            NULL, NULL, &mBenchmarkSha512 },
+  { "BenchmarkSm3HashAll()",         "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkHashAll,            NULL, NULL, &mBenchmarkSm3    },
+  { "BenchmarkHmacSha256All()",      "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkHmacSha256All,      NULL, NULL, NULL              },
+  { "BenchmarkAesCbcEncrypt()",      "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkAesCbcEncrypt,      NULL, NULL, NULL              },
+  { "BenchmarkAeadAesGcmEncrypt()",  "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkAeadAesGcmEncrypt,  NULL, NULL, NULL              },
+  { "BenchmarkRsaPkcs1Verify()",     "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkRsaPkcs1Verify,     NULL, NULL, NULL              },
+  { "BenchmarkRsaPssVerify()",       "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkRsaPssVerify,       NULL, NULL, NULL              },
+  { "BenchmarkEcDsaVerify()",        "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkEcDsaVerify,        NULL, NULL, NULL              },
+  { "BenchmarkPkcs7Verify()",        "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkPkcs7Verify,        NULL, NULL, NULL              },
+  { "BenchmarkAuthenticodeVerify()", "CryptoPkg.BaseCryptLib.Benchmark", BenchmarkAuthenticodeVerify, NULL, NULL, NULL              },
+};
+
+UINTN  mBenchmarkTestNum = ARRAY_SIZE (mBenchmarkTest);
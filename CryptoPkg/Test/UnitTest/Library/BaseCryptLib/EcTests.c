@@ -434,13 +434,128 @@ TestVerifyEcKey (
   return UNIT_TEST_PASSED;
 }
 
+#define EC_BATCH_TEST_REQUESTS  4
+
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifyEcDsaBatch (
+  UNIT_TEST_CONTEXT  Context
+  )
+{
+  BOOLEAN                Status;
+  VOID                   *EcPrivKey;
+  VOID                   *EcPubKey;
+  UINT8                  HashValue[EC_BATCH_TEST_REQUESTS][SHA256_DIGEST_SIZE];
+  UINT8                  Signature[EC_BATCH_TEST_REQUESTS][66 * 2];
+  CRYPTO_VERIFY_REQUEST  Requests[EC_BATCH_TEST_REQUESTS];
+  UINTN                  SigSize;
+  UINTN                  Index;
+
+  Status = EcGetPrivateKeyFromPem (mEccTestPemKey, sizeof (mEccTestPemKey), NULL, &EcPrivKey);
+  UT_ASSERT_TRUE (Status);
+
+  Status = EcGetPublicKeyFromX509 (mEccTestRootCer, sizeof (mEccTestRootCer), &EcPubKey);
+  UT_ASSERT_TRUE (Status);
+
+  //
+  // Sign a different message hash for each request, all with the same key.
+  //
+  for (Index = 0; Index < EC_BATCH_TEST_REQUESTS; Index++) {
+    SetMem (HashValue[Index], SHA256_DIGEST_SIZE, (UINT8)Index);
+    SigSize = sizeof (Signature[Index]);
+    Status  = EcDsaSign (EcPrivKey, CRYPTO_NID_SHA256, HashValue[Index], SHA256_DIGEST_SIZE, Signature[Index], &SigSize);
+    UT_ASSERT_TRUE (Status);
+
+    Requests[Index].Context     = EcPubKey;
+    Requests[Index].HashNid     = CRYPTO_NID_SHA256;
+    Requests[Index].MessageHash = HashValue[Index];
+    Requests[Index].HashSize    = SHA256_DIGEST_SIZE;
+    Requests[Index].Signature   = Signature[Index];
+    Requests[Index].SigSize     = SigSize;
+  }
+
+  Status = EcDsaVerifyBatch (Requests, EC_BATCH_TEST_REQUESTS);
+  UT_ASSERT_TRUE (Status);
+  for (Index = 0; Index < EC_BATCH_TEST_REQUESTS; Index++) {
+    UT_ASSERT_TRUE (Requests[Index].Result);
+  }
+
+  //
+  // A signature over another message hash is reported for its entry only.
+  //
+  Requests[1].MessageHash = HashValue[2];
+  Status                  = EcDsaVerifyBatch (Requests, EC_BATCH_TEST_REQUESTS);
+  UT_ASSERT_FALSE (Status);
+  UT_ASSERT_TRUE (Requests[0].Result);
+  UT_ASSERT_FALSE (Requests[1].Result);
+  UT_ASSERT_TRUE (Requests[2].Result);
+  UT_ASSERT_TRUE (Requests[3].Result);
+
+  EcFree (EcPrivKey);
+  EcFree (EcPubKey);
+
+  return UNIT_TEST_PASSED;
+}
+
+typedef struct {
+  VOID   *EcPubKey;
+  UINT8  HashValue[SHA256_DIGEST_SIZE];
+  UINT8  Signature[66 * 2];
+  UINTN  SigSize;
+} EC_BENCHMARK_CONTEXT;
+
+STATIC
+BOOLEAN
+EcDsaVerifyOperation (
+  IN VOID  *Context
+  )
+{
+  EC_BENCHMARK_CONTEXT  *Ec;
+
+  Ec = (EC_BENCHMARK_CONTEXT *)Context;
+  return EcDsaVerify (Ec->EcPubKey, CRYPTO_NID_SHA256, Ec->HashValue, sizeof (Ec->HashValue), Ec->Signature, Ec->SigSize);
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkEcDsaVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS      TestStatus;
+  BOOLEAN               Status;
+  VOID                  *EcPrivKey;
+  EC_BENCHMARK_CONTEXT  Ec;
+
+  Status = EcGetPrivateKeyFromPem (mEccTestPemKey, sizeof (mEccTestPemKey), NULL, &EcPrivKey);
+  UT_ASSERT_TRUE (Status);
+
+  Status = EcGetPublicKeyFromX509 (mEccTestRootCer, sizeof (mEccTestRootCer), &Ec.EcPubKey);
+  UT_ASSERT_TRUE (Status);
+
+  Status = Sha256HashAll (mEcPayload, AsciiStrLen (mEcPayload), Ec.HashValue);
+  UT_ASSERT_TRUE (Status);
+
+  Ec.SigSize = sizeof (Ec.Signature);
+  Status     = EcDsaSign (EcPrivKey, CRYPTO_NID_SHA256, Ec.HashValue, sizeof (Ec.HashValue), Ec.Signature, &Ec.SigSize);
+  UT_ASSERT_TRUE (Status);
+
+  TestStatus = RunCryptoBenchmark ("EcDsaVerify", 0, EcDsaVerifyOperation, &Ec);
+
+  EcFree (EcPrivKey);
+  EcFree (Ec.EcPubKey);
+
+  return TestStatus;
+}
+
 TEST_DESC  mEcTest[] = {
   //
   // -----Description-----------------Class------------------Function----Pre----Post----Context
   //
-  { "TestVerifyEcBasic()", "CryptoPkg.BaseCryptLib.Ec", TestVerifyEcBasic, TestVerifyEcPreReq, TestVerifyEcCleanUp, NULL },
-  { "TestVerifyEcDh()",    "CryptoPkg.BaseCryptLib.Ec", TestVerifyEcDh,    TestVerifyEcPreReq, TestVerifyEcCleanUp, NULL },
-  { "TestVerifyEcKey()",   "CryptoPkg.BaseCryptLib.Ec", TestVerifyEcKey,   NULL,               NULL,                NULL },
+  { "TestVerifyEcBasic()",    "CryptoPkg.BaseCryptLib.Ec", TestVerifyEcBasic,    TestVerifyEcPreReq, TestVerifyEcCleanUp, NULL },
+  { "TestVerifyEcDh()",       "CryptoPkg.BaseCryptLib.Ec", TestVerifyEcDh,       TestVerifyEcPreReq, TestVerifyEcCleanUp, NULL },
+  { "TestVerifyEcKey()",      "CryptoPkg.BaseCryptLib.Ec", TestVerifyEcKey,      NULL,               NULL,                NULL },
+  { "TestVerifyEcDsaBatch()", "CryptoPkg.BaseCryptLib.Ec", TestVerifyEcDsaBatch, NULL,               NULL,                NULL },
 };
 
 UINTN  mEcTestNum = ARRAY_SIZE (mEcTest);
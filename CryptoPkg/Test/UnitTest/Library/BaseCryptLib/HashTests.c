@@ -219,18 +219,113 @@ TestVerifyHash (
   return UNIT_TEST_PASSED;
 }
 
+typedef
+BOOLEAN
+(EFIAPI *EFI_HASH_ALL_BATCH)(
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
+typedef struct {
+  UINT32                DigestSize;
+  EFI_HASH_ALL          HashAll;
+  EFI_HASH_ALL_BATCH    HashAllBatch;
+  CONST UINT8           *Digest;
+} HASH_BATCH_TEST_CONTEXT;
+
+HASH_BATCH_TEST_CONTEXT  mSha256BatchTestCtx = { SHA256_DIGEST_SIZE, Sha256HashAll, Sha256HashAllBatch, Sha256Digest };
+HASH_BATCH_TEST_CONTEXT  mSha384BatchTestCtx = { SHA384_DIGEST_SIZE, Sha384HashAll, Sha384HashAllBatch, Sha384Digest };
+HASH_BATCH_TEST_CONTEXT  mSha512BatchTestCtx = { SHA512_DIGEST_SIZE, Sha512HashAll, Sha512HashAllBatch, Sha512Digest };
+
+//
+// Enough data in total for the batch to be shared with the APs, if any.
+//
+#define HASH_BATCH_TEST_REQUESTS   16
+#define HASH_BATCH_TEST_DATA_SIZE  SIZE_128KB
+
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifyHashAllBatch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HASH_BATCH_TEST_CONTEXT  *HashTestContext;
+  CRYPTO_HASH_REQUEST      Requests[HASH_BATCH_TEST_REQUESTS];
+  UINT8                    *Data;
+  UINT8                    *Digests;
+  UINT8                    Digest[MAX_DIGEST_SIZE];
+  UINTN                    Index;
+  BOOLEAN                  Status;
+
+  HashTestContext = Context;
+
+  Data    = AllocatePool (HASH_BATCH_TEST_DATA_SIZE);
+  Digests = AllocateZeroPool (HASH_BATCH_TEST_REQUESTS * MAX_DIGEST_SIZE);
+  UT_ASSERT_NOT_NULL (Data);
+  UT_ASSERT_NOT_NULL (Digests);
+
+  for (Index = 0; Index < HASH_BATCH_TEST_DATA_SIZE; Index++) {
+    Data[Index] = (UINT8)(Index * 7 + (Index >> 8));
+  }
+
+  //
+  // The first request is the known answer test, the others hash overlapping
+  // slices of Data of different sizes.
+  //
+  Requests[0].Data      = HashData;
+  Requests[0].DataSize  = AsciiStrLen (HashData);
+  Requests[0].HashValue = Digests;
+  for (Index = 1; Index < HASH_BATCH_TEST_REQUESTS; Index++) {
+    Requests[Index].Data      = Data + Index * 64;
+    Requests[Index].DataSize  = HASH_BATCH_TEST_DATA_SIZE - Index * 64 * HASH_BATCH_TEST_REQUESTS;
+    Requests[Index].HashValue = Digests + Index * MAX_DIGEST_SIZE;
+  }
+
+  Status = HashTestContext->HashAllBatch (Requests, HASH_BATCH_TEST_REQUESTS);
+  UT_ASSERT_TRUE (Status);
+
+  UT_ASSERT_MEM_EQUAL (Requests[0].HashValue, HashTestContext->Digest, HashTestContext->DigestSize);
+  for (Index = 0; Index < HASH_BATCH_TEST_REQUESTS; Index++) {
+    UT_ASSERT_TRUE (Requests[Index].Result);
+    Status = HashTestContext->HashAll (Requests[Index].Data, Requests[Index].DataSize, Digest);
+    UT_ASSERT_TRUE (Status);
+    UT_ASSERT_MEM_EQUAL (Requests[Index].HashValue, Digest, HashTestContext->DigestSize);
+  }
+
+  //
+  // A failing request fails the batch without affecting the others.
+  //
+  Requests[1].HashValue = NULL;
+  Status                = HashTestContext->HashAllBatch (Requests, HASH_BATCH_TEST_REQUESTS);
+  UT_ASSERT_FALSE (Status);
+  UT_ASSERT_FALSE (Requests[1].Result);
+  UT_ASSERT_TRUE (Requests[0].Result);
+  UT_ASSERT_TRUE (Requests[2].Result);
+
+  Status = HashTestContext->HashAllBatch (NULL, 1);
+  UT_ASSERT_FALSE (Status);
+
+  FreePool (Data);
+  FreePool (Digests);
+
+  return UNIT_TEST_PASSED;
+}
+
 TEST_DESC  mHashTest[] = {
   //
   // -----Description----------------Class---------------------Function---------------Pre------------------Post------------Context
   //
  #ifdef ENABLE_MD5_DEPRECATED_INTERFACES
-  { "TestVerifyMd5()",    "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mMd5TestCtx    },
+  { "TestVerifyMd5()",                "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,         TestVerifyHashPreReq, TestVerifyHashCleanUp, &mMd5TestCtx         },
  #endif
-  { "TestVerifySha1()",   "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha1TestCtx   },
-  { "TestVerifySha256()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha256TestCtx },
-  { "TestVerifySha384()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha384TestCtx },
-  { "TestVerifySha512()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha512TestCtx },
-  { "TestVerifySm3()",    "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSm3TestCtx    },
+  { "TestVerifySha1()",               "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,         TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha1TestCtx        },
+  { "TestVerifySha256()",             "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,         TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha256TestCtx      },
+  { "TestVerifySha384()",             "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,         TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha384TestCtx      },
+  { "TestVerifySha512()",             "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,         TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha512TestCtx      },
+  { "TestVerifySm3()",                "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,         TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSm3TestCtx         },
+  { "TestVerifySha256HashAllBatch()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHashAllBatch, NULL,                 NULL,                  &mSha256BatchTestCtx },
+  { "TestVerifySha384HashAllBatch()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHashAllBatch, NULL,                 NULL,                  &mSha384BatchTestCtx },
+  { "TestVerifySha512HashAllBatch()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHashAllBatch, NULL,                 NULL,                  &mSha512BatchTestCtx },
 };
 
 UINTN  mHashTestNum = ARRAY_SIZE (mHashTest);
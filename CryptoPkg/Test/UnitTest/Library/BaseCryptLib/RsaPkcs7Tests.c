@@ -426,6 +426,250 @@ TestVerifyPkcs7SignVerify (
   return UNIT_TEST_PASSED;
 }
 
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifyPkcs7CachedChainVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BOOLEAN  Status;
+  UINT8    *P7SignedData;
+  UINTN    P7SignedDataSize;
+  UINT8    *SignCert;
+  CHAR8    *Content;
+  UINTN    ContentSize;
+
+  P7SignedData = NULL;
+  SignCert     = NULL;
+
+  Status = X509ConstructCertificate (TestCert, sizeof (TestCert), (UINT8 **)&SignCert);
+  UT_ASSERT_TRUE (Status);
+  UT_ASSERT_NOT_NULL (SignCert);
+
+  ContentSize = AsciiStrLen (Payload);
+  Content     = AllocateCopyPool (ContentSize, Payload);
+  UT_ASSERT_NOT_NULL (Content);
+
+  Status = Pkcs7Sign (
+             TestKeyPem,
+             sizeof (TestKeyPem),
+             (CONST UINT8 *)PemPass,
+             (UINT8 *)Content,
+             ContentSize,
+             SignCert,
+             NULL,
+             &P7SignedData,
+             &P7SignedDataSize
+             );
+  UT_ASSERT_TRUE (Status);
+  UT_ASSERT_NOT_EQUAL (P7SignedDataSize, 0);
+
+  //
+  // The second verification finds the signer chain in the cache.
+  //
+  Status = Pkcs7Verify (P7SignedData, P7SignedDataSize, TestCACert, sizeof (TestCACert), (UINT8 *)Content, ContentSize);
+  UT_ASSERT_TRUE (Status);
+  Status = Pkcs7Verify (P7SignedData, P7SignedDataSize, TestCACert, sizeof (TestCACert), (UINT8 *)Content, ContentSize);
+  UT_ASSERT_TRUE (Status);
+
+  //
+  // A cached chain doesn't skip the verification of the content signature.
+  //
+  Content[0] ^= 1;
+
+  Status = Pkcs7Verify (P7SignedData, P7SignedDataSize, TestCACert, sizeof (TestCACert), (UINT8 *)Content, ContentSize);
+  UT_ASSERT_FALSE (Status);
+
+  FreePool (Content);
+  FreePool (P7SignedData);
+  X509Free (SignCert);
+
+  return UNIT_TEST_PASSED;
+}
+
+typedef struct {
+  VOID         *RsaPubKey;
+  UINT8        Digest[SHA256_DIGEST_SIZE];
+  CONST UINT8  *Signature;
+  UINTN        SigSize;
+} RSA_BENCHMARK_CONTEXT;
+
+typedef struct {
+  CONST UINT8  *P7SignedData;
+  UINTN        P7SignedDataSize;
+} PKCS7_BENCHMARK_CONTEXT;
+
+STATIC
+BOOLEAN
+RsaPkcs1VerifyOperation (
+  IN VOID  *Context
+  )
+{
+  RSA_BENCHMARK_CONTEXT  *Rsa;
+
+  Rsa = (RSA_BENCHMARK_CONTEXT *)Context;
+  return RsaPkcs1Verify (Rsa->RsaPubKey, Rsa->Digest, sizeof (Rsa->Digest), Rsa->Signature, Rsa->SigSize);
+}
+
+STATIC
+BOOLEAN
+RsaPssVerifyOperation (
+  IN VOID  *Context
+  )
+{
+  RSA_BENCHMARK_CONTEXT  *Rsa;
+
+  Rsa = (RSA_BENCHMARK_CONTEXT *)Context;
+  return RsaPssVerify (
+           Rsa->RsaPubKey,
+           (CONST UINT8 *)Payload,
+           AsciiStrLen (Payload),
+           Rsa->Signature,
+           Rsa->SigSize,
+           SHA256_DIGEST_SIZE,
+           SHA256_DIGEST_SIZE
+           );
+}
+
+STATIC
+BOOLEAN
+Pkcs7VerifyOperation (
+  IN VOID  *Context
+  )
+{
+  PKCS7_BENCHMARK_CONTEXT  *Pkcs7;
+
+  Pkcs7 = (PKCS7_BENCHMARK_CONTEXT *)Context;
+  return Pkcs7Verify (
+           Pkcs7->P7SignedData,
+           Pkcs7->P7SignedDataSize,
+           TestCACert,
+           sizeof (TestCACert),
+           (UINT8 *)Payload,
+           AsciiStrLen (Payload)
+           );
+}
+
+/**
+  Signs Payload with TestKeyPem and benchmarks the verification of the
+  signature with the public key of TestCert.
+
+  @param[in]  Name  Name reported for the benchmark.
+  @param[in]  Pss   TRUE for RSASSA-PSS, FALSE for RSASSA-PKCS1-v1_5.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+BenchmarkRsaVerify (
+  IN CONST CHAR8  *Name,
+  IN BOOLEAN      Pss
+  )
+{
+  UNIT_TEST_STATUS       TestStatus;
+  BOOLEAN                Status;
+  VOID                   *RsaPrivKey;
+  UINT8                  *Signature;
+  UINTN                  SigSize;
+  RSA_BENCHMARK_CONTEXT  Rsa;
+
+  Status = RsaGetPrivateKeyFromPem (TestKeyPem, sizeof (TestKeyPem), PemPass, &RsaPrivKey);
+  UT_ASSERT_TRUE (Status);
+
+  Status = Sha256HashAll (Payload, AsciiStrLen (Payload), Rsa.Digest);
+  UT_ASSERT_TRUE (Status);
+
+  SigSize = 0;
+  if (Pss) {
+    Status = RsaPssSign (RsaPrivKey, (CONST UINT8 *)Payload, AsciiStrLen (Payload), SHA256_DIGEST_SIZE, SHA256_DIGEST_SIZE, NULL, &SigSize);
+  } else {
+    Status = RsaPkcs1Sign (RsaPrivKey, Rsa.Digest, sizeof (Rsa.Digest), NULL, &SigSize);
+  }
+
+  UT_ASSERT_FALSE (Status);
+  UT_ASSERT_NOT_EQUAL (SigSize, 0);
+
+  Signature = AllocatePool (SigSize);
+  UT_ASSERT_NOT_NULL (Signature);
+  if (Pss) {
+    Status = RsaPssSign (RsaPrivKey, (CONST UINT8 *)Payload, AsciiStrLen (Payload), SHA256_DIGEST_SIZE, SHA256_DIGEST_SIZE, Signature, &SigSize);
+  } else {
+    Status = RsaPkcs1Sign (RsaPrivKey, Rsa.Digest, sizeof (Rsa.Digest), Signature, &SigSize);
+  }
+
+  UT_ASSERT_TRUE (Status);
+
+  Status = RsaGetPublicKeyFromX509 (TestCert, sizeof (TestCert), &Rsa.RsaPubKey);
+  UT_ASSERT_TRUE (Status);
+
+  Rsa.Signature = Signature;
+  Rsa.SigSize   = SigSize;
+  TestStatus    = RunCryptoBenchmark (Name, 0, Pss ? RsaPssVerifyOperation : RsaPkcs1VerifyOperation, &Rsa);
+
+  RsaFree (Rsa.RsaPubKey);
+  RsaFree (RsaPrivKey);
+  FreePool (Signature);
+
+  return TestStatus;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkRsaPkcs1Verify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BenchmarkRsaVerify ("RsaPkcs1Verify", FALSE);
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkRsaPssVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BenchmarkRsaVerify ("RsaPssVerify", TRUE);
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkPkcs7Verify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS         TestStatus;
+  BOOLEAN                  Status;
+  UINT8                    *P7SignedData;
+  UINTN                    P7SignedDataSize;
+  UINT8                    *SignCert;
+  PKCS7_BENCHMARK_CONTEXT  Pkcs7;
+
+  Status = X509ConstructCertificate (TestCert, sizeof (TestCert), (UINT8 **)&SignCert);
+  UT_ASSERT_TRUE (Status);
+  UT_ASSERT_NOT_NULL (SignCert);
+
+  Status = Pkcs7Sign (
+             TestKeyPem,
+             sizeof (TestKeyPem),
+             (CONST UINT8 *)PemPass,
+             (UINT8 *)Payload,
+             AsciiStrLen (Payload),
+             SignCert,
+             NULL,
+             &P7SignedData,
+             &P7SignedDataSize
+             );
+  UT_ASSERT_TRUE (Status);
+
+  Pkcs7.P7SignedData     = P7SignedData;
+  Pkcs7.P7SignedDataSize = P7SignedDataSize;
+  TestStatus             = RunCryptoChainBenchmark ("Pkcs7VerifyCold", "Pkcs7VerifyWarm", Pkcs7VerifyOperation, &Pkcs7);
+
+  FreePool (P7SignedData);
+  X509Free (SignCert);
+
+  return TestStatus;
+}
+
 TEST_DESC  mRsaCertTest[] = {
   //
   // -----Description--------------------------------------Class----------------------Function-----------------Pre---Post--Context
@@ -440,6 +684,7 @@ TEST_DESC  mPkcs7Test[] = {
   // -----Description--------------------------------------Class----------------------Function-----------------Pre---Post--Context
   //
   { "TestVerifyPkcs7SignVerify()", "CryptoPkg.BaseCryptLib.Pkcs7", TestVerifyPkcs7SignVerify, NULL, NULL, NULL },
+  { "TestVerifyPkcs7CachedChainVerify()", "CryptoPkg.BaseCryptLib.Pkcs7", TestVerifyPkcs7CachedChainVerify, NULL, NULL, NULL },
 };
 
 UINTN  mPkcs7TestNum = ARRAY_SIZE (mPkcs7Test);
@@ -101,6 +101,104 @@ extern TEST_DESC  mEcTest[];
 extern UINTN      mX509TestNum;
 extern TEST_DESC  mX509Test[];
 
+extern UINTN      mBenchmarkTestNum;
+extern TEST_DESC  mBenchmarkTest[];
+
+/**
+  Operation measured by RunCryptoBenchmark().
+
+  @param[in]  Context  Context passed to RunCryptoBenchmark().
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed or is not supported.
+
+**/
+typedef
+BOOLEAN
+(*CRYPTO_BENCHMARK_OPERATION)(
+  IN VOID  *Context
+  );
+
+/**
+  Measures an operation and reports its throughput or rate.
+
+  @param[in]  Name               Name reported for the benchmark.
+  @param[in]  BytesPerOperation  Bytes processed by one call to Operation, or
+                                 zero to report operations per second.
+  @param[in]  Operation          Operation to measure.
+  @param[in]  Context            Context passed to Operation.
+
+  @retval UNIT_TEST_PASSED             The result was reported.
+  @retval UNIT_TEST_SKIPPED            The operation is not supported.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The operation failed after succeeding
+                                       once.
+
+**/
+UNIT_TEST_STATUS
+RunCryptoBenchmark (
+  IN CONST CHAR8                 *Name,
+  IN UINTN                       BytesPerOperation,
+  IN CRYPTO_BENCHMARK_OPERATION  Operation,
+  IN VOID                        *Context
+  );
+
+/**
+  Measures a verification going through Pkcs7Verify() with the signer chain
+  cache of BaseCryptLib disabled, then enabled.
+
+  @param[in]  ColdName   Name reported for the benchmark without the cache.
+  @param[in]  WarmName   Name reported for the benchmark with the cache.
+  @param[in]  Operation  Operation to measure.
+  @param[in]  Context    Context passed to Operation.
+
+  @retval UNIT_TEST_PASSED             Both results were reported.
+  @retval UNIT_TEST_SKIPPED            The operation is not supported.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The operation failed after succeeding
+                                       once.
+
+**/
+UNIT_TEST_STATUS
+RunCryptoChainBenchmark (
+  IN CONST CHAR8                 *ColdName,
+  IN CONST CHAR8                 *WarmName,
+  IN CRYPTO_BENCHMARK_OPERATION  Operation,
+  IN VOID                        *Context
+  );
+
+//
+// Signature verification benchmarks, implemented next to the test vectors
+// they use.
+//
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkRsaPkcs1Verify (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkRsaPssVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkPkcs7Verify (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkEcDsaVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAuthenticodeVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
 /** Creates a framework you can use */
 EFI_STATUS
 EFIAPI
@@ -583,11 +583,8 @@ ProcessAsyncTaskList (
   BOOLEAN                       HasNewItem;
   EFI_STATUS                    Status;
 
-  Private    = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
-  QueueId    = 2;
-  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  HasNewItem = FALSE;
-  PciIo      = Private->PciIo;
+  Private = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
+  PciIo   = Private->PciIo;
 
   //
   // Submit asynchronous subtasks to the NVMe Submission Queue
@@ -663,85 +660,91 @@ ProcessAsyncTaskList (
     }
   }
 
-  while (Cq->Pt != Private->Pt[QueueId]) {
-    ASSERT (Cq->Sqid == QueueId);
-
-    HasNewItem = TRUE;
-
-    //
-    // Find the command with given Command Id.
-    //
-    for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
-         !IsNull (&Private->AsyncPassThruQueue, Link);
-         Link = NextLink)
-    {
-      NextLink     = GetNextNode (&Private->AsyncPassThruQueue, Link);
-      AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
-      if (AsyncRequest->CommandId == Cq->Cid) {
-        //
-        // Copy the Respose Queue entry for this command to the callers
-        // response buffer.
-        //
-        CopyMem (
-          AsyncRequest->Packet->NvmeCompletion,
-          Cq,
-          sizeof (EFI_NVM_EXPRESS_COMPLETION)
-          );
-
-        //
-        // Free the resources allocated before cmd submission
-        //
-        if (AsyncRequest->MapData != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapData);
-        }
+  //
+  // Reap the completions from all the asynchronous I/O completion queues.
+  //
+  for (QueueId = NVME_ASYNC_QUEUE_START;
+       QueueId < NVME_ASYNC_QUEUE_START + Private->AsyncQueueNum;
+       QueueId++)
+  {
+    Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+    HasNewItem = FALSE;
 
-        if (AsyncRequest->MapMeta != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
-        }
+    while (Cq->Pt != Private->Pt[QueueId]) {
+      ASSERT (Cq->Sqid == QueueId);
 
-        if (AsyncRequest->MapPrpList != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-        }
+      HasNewItem = TRUE;
 
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
-                   PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
-                   );
+      //
+      // Find the command with given Command Id.
+      //
+      for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
+           !IsNull (&Private->AsyncPassThruQueue, Link);
+           Link = NextLink)
+      {
+        NextLink     = GetNextNode (&Private->AsyncPassThruQueue, Link);
+        AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
+        if ((AsyncRequest->QueueId == QueueId) && (AsyncRequest->CommandId == Cq->Cid)) {
+          //
+          // Copy the Respose Queue entry for this command to the callers
+          // response buffer.
+          //
+          CopyMem (
+            AsyncRequest->Packet->NvmeCompletion,
+            Cq,
+            sizeof (EFI_NVM_EXPRESS_COMPLETION)
+            );
+
+          //
+          // Free the resources allocated before cmd submission
+          //
+          if (AsyncRequest->MapData != NULL) {
+            PciIo->Unmap (PciIo, AsyncRequest->MapData);
+          }
+
+          if (AsyncRequest->MapMeta != NULL) {
+            PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
+          }
+
+          NvmeFreePrpList (
+            Private,
+            AsyncRequest->PrpListHost,
+            AsyncRequest->PrpListNo,
+            AsyncRequest->MapPrpList
+            );
+
+          RemoveEntryList (Link);
+          gBS->SignalEvent (AsyncRequest->CallerEvent);
+          FreePool (AsyncRequest);
+          break;
         }
+      }
 
-        RemoveEntryList (Link);
-        gBS->SignalEvent (AsyncRequest->CallerEvent);
-        FreePool (AsyncRequest);
+      //
+      // Update submission queue head.
+      //
+      Private->AsyncSqHead[QueueId] = Cq->Sqhd;
 
-        //
-        // Update submission queue head.
-        //
-        Private->AsyncSqHead = Cq->Sqhd;
-        break;
+      Private->CqHdbl[QueueId].Cqh++;
+      if (Private->CqHdbl[QueueId].Cqh > Private->AsyncCqSize) {
+        Private->CqHdbl[QueueId].Cqh = 0;
+        Private->Pt[QueueId]        ^= 1;
       }
-    }
 
-    Private->CqHdbl[QueueId].Cqh++;
-    if (Private->CqHdbl[QueueId].Cqh > MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes)) {
-      Private->CqHdbl[QueueId].Cqh = 0;
-      Private->Pt[QueueId]        ^= 1;
+      Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
     }
 
-    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  }
-
-  if (HasNewItem) {
-    Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
-    PciIo->Mem.Write (
-                 PciIo,
-                 EfiPciIoWidthUint32,
-                 NVME_BAR,
-                 NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
-                 1,
-                 &Data
-                 );
+    if (HasNewItem) {
+      Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
+      PciIo->Mem.Write (
+                   PciIo,
+                   EfiPciIoWidthUint32,
+                   NVME_BAR,
+                   NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
+                   1,
+                   &Data
+                   );
+    }
   }
 }
 
@@ -1029,21 +1032,33 @@ NvmExpressDriverBindingStart (
     }
 
     //
-    // 6 x 4kB aligned buffers will be carved out of this buffer.
+    // The queue buffer holds the admin queues, the blocking I/O queues and
+    // PcdNvmeAsyncIoQueuePairNumber asynchronous I/O queue pairs.
     // 1st 4kB boundary is the start of the admin submission queue.
     // 2nd 4kB boundary is the start of the admin completion queue.
     // 3rd 4kB boundary is the start of I/O submission queue #1.
     // 4th 4kB boundary is the start of I/O completion queue #1.
-    // 5th 4kB boundary is the start of I/O submission queue #2.
-    // 6th 4kB boundary is the start of I/O completion queue #2.
+    // Then each asynchronous I/O queue pair takes NVME_ASYNC_CSQ_PAGES for
+    // the submission queue followed by NVME_ASYNC_CCQ_PAGES for the completion
+    // queue.
+    //
+    Private->AsyncQueueNum = PcdGet8 (PcdNvmeAsyncIoQueuePairNumber);
+    if (Private->AsyncQueueNum == 0) {
+      Private->AsyncQueueNum = 1;
+    } else if (Private->AsyncQueueNum > NVME_MAX_ASYNC_QUEUES) {
+      Private->AsyncQueueNum = NVME_MAX_ASYNC_QUEUES;
+    }
+
+    Private->BufferPages = 4 + Private->AsyncQueueNum * (NVME_ASYNC_CSQ_PAGES + NVME_ASYNC_CCQ_PAGES);
+
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // Allocate the queue buffer, then map it for bus master read and write.
     //
     Status = PciIo->AllocateBuffer (
                       PciIo,
                       AllocateAnyPages,
                       EfiBootServicesData,
-                      6,
+                      Private->BufferPages,
                       (VOID **)&Private->Buffer,
                       0
                       );
@@ -1051,7 +1066,7 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (Private->BufferPages);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -1061,12 +1076,51 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (Private->BufferPages))) {
       goto Exit;
     }
 
     Private->BufferPciAddr = (UINT8 *)(UINTN)MappedAddr;
 
+    //
+    // Pre-allocate the PRP list pool. PRP lists are allocated per request if
+    // the pool is not available.
+    //
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      NVME_PRP_LIST_POOL_PAGES,
+                      (VOID **)&Private->PrpListPool,
+                      0
+                      );
+    if (!EFI_ERROR (Status)) {
+      Bytes  = EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_PAGES);
+      Status = PciIo->Map (
+                        PciIo,
+                        EfiPciIoOperationBusMasterCommonBuffer,
+                        Private->PrpListPool,
+                        &Bytes,
+                        &Private->PrpListPoolPciAddr,
+                        &Private->PrpListPoolMapping
+                        );
+      if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_PAGES))) {
+        if (!EFI_ERROR (Status)) {
+          PciIo->Unmap (PciIo, Private->PrpListPoolMapping);
+        }
+
+        PciIo->FreeBuffer (PciIo, NVME_PRP_LIST_POOL_PAGES, Private->PrpListPool);
+        Private->PrpListPool        = NULL;
+        Private->PrpListPoolMapping = NULL;
+      }
+    } else {
+      Private->PrpListPool = NULL;
+    }
+
+    if (Private->PrpListPool == NULL) {
+      DEBUG ((DEBUG_WARN, "NvmExpressDriverBindingStart: PRP list pool is not available\n"));
+    }
+
     Private->Signature                 = NVME_CONTROLLER_PRIVATE_DATA_SIGNATURE;
     Private->ControllerHandle          = Controller;
     Private->ImageHandle               = This->DriverBindingHandle;
@@ -1171,7 +1225,15 @@ Exit:
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, Private->BufferPages, Private->Buffer);
+  }
+
+  if ((Private != NULL) && (Private->PrpListPoolMapping != NULL)) {
+    PciIo->Unmap (PciIo, Private->PrpListPoolMapping);
+  }
+
+  if ((Private != NULL) && (Private->PrpListPool != NULL)) {
+    PciIo->FreeBuffer (PciIo, NVME_PRP_LIST_POOL_PAGES, Private->PrpListPool);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
@@ -1293,7 +1355,15 @@ NvmExpressDriverBindingStop (
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, Private->BufferPages, Private->Buffer);
+      }
+
+      if (Private->PrpListPoolMapping != NULL) {
+        Private->PciIo->Unmap (Private->PciIo, Private->PrpListPoolMapping);
+      }
+
+      if (Private->PrpListPool != NULL) {
+        Private->PciIo->FreeBuffer (Private->PciIo, NVME_PRP_LIST_POOL_PAGES, Private->PrpListPool);
       }
 
       FreePool (Private->ControllerData);
@@ -36,6 +36,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
@@ -68,17 +69,71 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 #define NVME_CCQ_SIZE  1                                // Number of I/O completion queue entries, which is 0-based
 
 //
-// Number of asynchronous I/O submission queue entries, which is 0-based.
-// The asynchronous I/O submission queue size is 4kB in total.
+// Maximum number of asynchronous I/O submission queue entries, which is 0-based.
+// The asynchronous I/O submission queue size is 16kB in total. The number of
+// entries actually used is further limited by CAP.MQES.
 //
-#define NVME_ASYNC_CSQ_SIZE  63
+#define NVME_ASYNC_CSQ_SIZE  255
 //
-// Number of asynchronous I/O completion queue entries, which is 0-based.
-// The asynchronous I/O completion queue size is 4kB in total.
+// Maximum number of asynchronous I/O completion queue entries, which is 0-based.
+// The asynchronous I/O completion queue size is 4kB in total. The number of
+// entries actually used is further limited by CAP.MQES.
 //
 #define NVME_ASYNC_CCQ_SIZE  255
 
-#define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
+//
+// Number of pages occupied by each asynchronous I/O submission/completion queue.
+//
+#define NVME_ASYNC_CSQ_PAGES  EFI_SIZE_TO_PAGES ((NVME_ASYNC_CSQ_SIZE + 1) * sizeof (NVME_SQ))
+#define NVME_ASYNC_CCQ_PAGES  EFI_SIZE_TO_PAGES ((NVME_ASYNC_CCQ_SIZE + 1) * sizeof (NVME_CQ))
+
+//
+// Queue #0 is the admin queue, queue #1 is the blocking I/O queue, and the
+// asynchronous I/O queue pairs start from queue #2.
+//
+#define NVME_ASYNC_QUEUE_START  2
+#define NVME_MAX_ASYNC_QUEUES   16                      // Maximum number of asynchronous I/O queue pairs
+#define NVME_MAX_QUEUES         (NVME_ASYNC_QUEUE_START + NVME_MAX_ASYNC_QUEUES)
+
+//
+// Number of pages in the pre-allocated PRP list pool, each page holds 512
+// PRP entries.
+//
+#define NVME_PRP_LIST_POOL_PAGES  64
+
+//
+// SGL Support (SGLS) field in the Identify Controller data structure.
+//
+#define NVME_CTRL_SGLS_SUPPORT_MASK     (BIT0 | BIT1)
+#define NVME_CTRL_SGLS_DWORD_ALIGNMENT  BIT1
+
+//
+// PRP or SGL for Data Transfer (PSDT) value of a submission queue entry: SGLs
+// are used for the data transfer, MPTR (if used) is a contiguous buffer.
+//
+#define NVME_PSDT_SGL_MPTR_CONTIGUOUS  0x1
+
+//
+// SGL Descriptor Type of the SGL Identifier, placed in bits 7:4.
+//
+#define NVME_SGL_DATA_BLOCK_DESCRIPTOR  0x0
+
+//
+// SGL Data Block descriptor, occupies the Data Pointer (DPTR) field of a
+// submission queue entry.
+//
+typedef struct {
+  UINT64    Address;
+  UINT32    Length;
+  UINT8     Reserved[3];
+  UINT8     Identifier;
+} NVME_SGL_DESCRIPTOR;
+
+//
+// Maximum number of logical blocks in a single read/write command, limited by
+// the 16-bit NLB field.
+//
+#define NVME_MAX_NLB_BLOCKS  0x10000
 
 //
 // FormatNVM Admin Command LBA Format (LBAF) Mask
@@ -145,16 +200,18 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA            *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // BufferPages x 4kB aligned buffers will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // Then each asynchronous I/O queue pair takes NVME_ASYNC_CSQ_PAGES for
+  // the submission queue followed by NVME_ASYNC_CCQ_PAGES for the completion
+  // queue.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
+  UINTN          BufferPages;
 
   //
   // Pointers to 4kB aligned submission & completion queues.
@@ -169,7 +226,15 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   //
   NVME_SQTDBL    SqTdbl[NVME_MAX_QUEUES];
   NVME_CQHDBL    CqHdbl[NVME_MAX_QUEUES];
-  UINT16         AsyncSqHead;
+  UINT16         AsyncSqHead[NVME_MAX_QUEUES];
+
+  //
+  // Number and 0-based sizes of the asynchronous I/O queue pairs in use.
+  //
+  UINT16         AsyncQueueNum;
+  UINT16         AsyncSqSize;
+  UINT16         AsyncCqSize;
+  UINT16         NextAsyncQueue;
 
   //
   // Flag to indicate internal IO queue creation.
@@ -186,6 +251,15 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
 
   VOID           *Mapping;
 
+  //
+  // Pre-allocated PRP list pages, so that transfers spanning more than two
+  // memory pages do not allocate and map PRP lists per request.
+  //
+  UINT8                   *PrpListPool;
+  EFI_PHYSICAL_ADDRESS    PrpListPoolPciAddr;
+  VOID                    *PrpListPoolMapping;
+  BOOLEAN                 PrpListPoolUsed[NVME_PRP_LIST_POOL_PAGES];
+
   //
   // For Non-blocking operations.
   //
@@ -329,6 +403,7 @@ typedef struct {
   LIST_ENTRY                                  Link;
 
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET    *Packet;
+  UINT16                                      QueueId;
   UINT16                                      CommandId;
   VOID                                        *MapPrpList;
   UINTN                                       PrpListNo;
@@ -759,6 +834,70 @@ NvmeDumpStatus (
   IN NVME_CQ  *Cq
   );
 
+/**
+  Reset the NVMe controller after a command timeout and abort all the
+  outstanding asynchronous requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_TIMEOUT       The controller has been reset and the asynchronous
+                            requests have been aborted.
+  @retval Others            Fail to recover the controller.
+
+**/
+EFI_STATUS
+NvmeRecoverFromTimeout (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Aborts the asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_SUCCESS       The asynchronous PassThru requests have been aborted.
+  @return EFI_DEVICE_ERROR  Fail to abort all the asynchronous PassThru requests.
+
+**/
+EFI_STATUS
+AbortAsyncPassThruTasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+/**
+  Release the PRP lists created by NvmeCreatePrpList().
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpListHost    The host base address of PRP lists.
+  @param[in] PrpListNo      The number of PRP List.
+  @param[in] Mapping        The mapping value returned from PciIo.Map(), or NULL
+                            if the PRP lists come from the pre-allocated pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  );
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
@@ -141,6 +141,48 @@ WriteSectors (
   return Status;
 }
 
+/**
+  Get the maximum number of blocks which can be transferred by a single read
+  or write command.
+
+  The transfer is limited by the Maximum Data Transfer Size (MDTS) reported by
+  the controller and by the 16-bit Number of Logical Blocks (NLB) field of the
+  command.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+
+  @return The maximum number of blocks of a single command.
+
+**/
+UINT32
+NvmeGetMaxTransferBlocks (
+  IN NVME_DEVICE_PRIVATE_DATA  *Device
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  UINT32                        BlockSize;
+  UINT64                        MaxTransferBlocks;
+
+  Private   = Device->Controller;
+  BlockSize = Device->Media.BlockSize;
+
+  //
+  // The transfer length of a command is also kept in a 32-bit field.
+  //
+  MaxTransferBlocks = MIN (NVME_MAX_NLB_BLOCKS, MAX_UINT32 / BlockSize);
+  if (Private->ControllerData->Mdts != 0) {
+    MaxTransferBlocks = MIN (
+                          MaxTransferBlocks,
+                          DivU64x32 (
+                            LShiftU64 (1, Private->ControllerData->Mdts + Private->Cap.Mpsmin + 12),
+                            BlockSize
+                            )
+                          );
+  }
+
+  return (UINT32)MaxTransferBlocks;
+}
+
 /**
   Read some blocks from the device.
 
@@ -163,7 +205,6 @@ NvmeRead (
 {
   EFI_STATUS                    Status;
   UINT32                        BlockSize;
-  NVME_CONTROLLER_PRIVATE_DATA  *Private;
   UINT32                        MaxTransferBlocks;
   UINTN                         OrginalBlocks;
   BOOLEAN                       IsEmpty;
@@ -185,30 +226,24 @@ NvmeRead (
   }
 
   Status        = EFI_SUCCESS;
-  Private       = Device->Controller;
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
 
-  if (Private->ControllerData->Mdts != 0) {
-    MaxTransferBlocks = (1 << (Private->ControllerData->Mdts)) * (1 << (Private->Cap.Mpsmin + 12)) / BlockSize;
-  } else {
-    MaxTransferBlocks = 1024;
-  }
+  MaxTransferBlocks = NvmeGetMaxTransferBlocks (Device);
 
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Submit all the chunks of a large request at once, rather than waiting
+    // for each chunk to complete before sending the next one.
+    //
+    Status = NvmeTransferChunks (Device, Buffer, Lba, Blocks, FALSE);
+    if (!EFI_ERROR (Status)) {
       Blocks = 0;
     }
-
-    if (EFI_ERROR (Status)) {
-      break;
+  } else {
+    Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+    if (!EFI_ERROR (Status)) {
+      Blocks = 0;
     }
   }
 
@@ -249,7 +284,6 @@ NvmeWrite (
 {
   EFI_STATUS                    Status;
   UINT32                        BlockSize;
-  NVME_CONTROLLER_PRIVATE_DATA  *Private;
   UINT32                        MaxTransferBlocks;
   UINTN                         OrginalBlocks;
   BOOLEAN                       IsEmpty;
@@ -271,30 +305,24 @@ NvmeWrite (
   }
 
   Status        = EFI_SUCCESS;
-  Private       = Device->Controller;
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
 
-  if (Private->ControllerData->Mdts != 0) {
-    MaxTransferBlocks = (1 << (Private->ControllerData->Mdts)) * (1 << (Private->Cap.Mpsmin + 12)) / BlockSize;
-  } else {
-    MaxTransferBlocks = 1024;
-  }
-
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
+  MaxTransferBlocks = NvmeGetMaxTransferBlocks (Device);
 
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Submit all the chunks of a large request at once, rather than waiting
+    // for each chunk to complete before sending the next one.
+    //
+    Status = NvmeTransferChunks (Device, Buffer, Lba, Blocks, TRUE);
+    if (!EFI_ERROR (Status)) {
       Blocks = 0;
     }
-
-    if (EFI_ERROR (Status)) {
-      break;
+  } else {
+    Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+    if (!EFI_ERROR (Status)) {
+      Blocks = 0;
     }
   }
 
@@ -726,7 +754,6 @@ NvmeAsyncRead (
 {
   EFI_STATUS                    Status;
   UINT32                        BlockSize;
-  NVME_CONTROLLER_PRIVATE_DATA  *Private;
   NVME_BLKIO2_REQUEST           *BlkIo2Req;
   UINT32                        MaxTransferBlocks;
   UINTN                         OrginalBlocks;
@@ -734,7 +761,6 @@ NvmeAsyncRead (
   EFI_TPL                       OldTpl;
 
   Status        = EFI_SUCCESS;
-  Private       = Device->Controller;
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
   BlkIo2Req     = AllocateZeroPool (sizeof (NVME_BLKIO2_REQUEST));
@@ -751,11 +777,7 @@ NvmeAsyncRead (
 
   InitializeListHead (&BlkIo2Req->SubtasksQueue);
 
-  if (Private->ControllerData->Mdts != 0) {
-    MaxTransferBlocks = (1 << (Private->ControllerData->Mdts)) * (1 << (Private->Cap.Mpsmin + 12)) / BlockSize;
-  } else {
-    MaxTransferBlocks = 1024;
-  }
+  MaxTransferBlocks = NvmeGetMaxTransferBlocks (Device);
 
   while (Blocks > 0) {
     if (Blocks > MaxTransferBlocks) {
@@ -854,7 +876,6 @@ NvmeAsyncWrite (
 {
   EFI_STATUS                    Status;
   UINT32                        BlockSize;
-  NVME_CONTROLLER_PRIVATE_DATA  *Private;
   NVME_BLKIO2_REQUEST           *BlkIo2Req;
   UINT32                        MaxTransferBlocks;
   UINTN                         OrginalBlocks;
@@ -862,7 +883,6 @@ NvmeAsyncWrite (
   EFI_TPL                       OldTpl;
 
   Status        = EFI_SUCCESS;
-  Private       = Device->Controller;
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
   BlkIo2Req     = AllocateZeroPool (sizeof (NVME_BLKIO2_REQUEST));
@@ -879,11 +899,7 @@ NvmeAsyncWrite (
 
   InitializeListHead (&BlkIo2Req->SubtasksQueue);
 
-  if (Private->ControllerData->Mdts != 0) {
-    MaxTransferBlocks = (1 << (Private->ControllerData->Mdts)) * (1 << (Private->Cap.Mpsmin + 12)) / BlockSize;
-  } else {
-    MaxTransferBlocks = 1024;
-  }
+  MaxTransferBlocks = NvmeGetMaxTransferBlocks (Device);
 
   while (Blocks > 0) {
     if (Blocks > MaxTransferBlocks) {
@@ -956,6 +972,231 @@ NvmeAsyncWrite (
   return Status;
 }
 
+/**
+  Release the BlockIo2 request of a blocking transfer which is still queued
+  after the controller reset, so that the caller can return.
+
+  The asynchronous PassThru requests must have been aborted, so no subtask of
+  the request is still owned by the controller.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Token                  The token of the blocking transfer.
+
+**/
+STATIC
+VOID
+NvmeReleaseBlkIo2Request (
+  IN NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN EFI_BLOCK_IO2_TOKEN       *Token
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  NVME_BLKIO2_REQUEST           *BlkIo2Req;
+  NVME_BLKIO2_SUBTASK           *Subtask;
+  LIST_ENTRY                    *Link;
+  LIST_ENTRY                    *NextLink;
+  LIST_ENTRY                    *SubLink;
+  LIST_ENTRY                    *NextSubLink;
+  LIST_ENTRY                    ReleasedSubtasks;
+  EFI_TPL                       OldTpl;
+
+  Private = Device->Controller;
+  InitializeListHead (&ReleasedSubtasks);
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  for (Link = GetFirstNode (&Private->UnsubmittedSubtasks);
+       !IsNull (&Private->UnsubmittedSubtasks, Link);
+       Link = NextLink)
+  {
+    NextLink = GetNextNode (&Private->UnsubmittedSubtasks, Link);
+    Subtask  = NVME_BLKIO2_SUBTASK_FROM_LINK (Link);
+    if (Subtask->BlockIo2Request->Token == Token) {
+      RemoveEntryList (Link);
+      InsertTailList (&ReleasedSubtasks, Link);
+    }
+  }
+
+  for (Link = GetFirstNode (&Device->AsyncQueue);
+       !IsNull (&Device->AsyncQueue, Link);
+       Link = NextLink)
+  {
+    NextLink  = GetNextNode (&Device->AsyncQueue, Link);
+    BlkIo2Req = NVME_BLKIO2_REQUEST_FROM_LINK (Link);
+    if (BlkIo2Req->Token != Token) {
+      continue;
+    }
+
+    for (SubLink = GetFirstNode (&BlkIo2Req->SubtasksQueue);
+         !IsNull (&BlkIo2Req->SubtasksQueue, SubLink);
+         SubLink = NextSubLink)
+    {
+      NextSubLink = GetNextNode (&BlkIo2Req->SubtasksQueue, SubLink);
+      RemoveEntryList (SubLink);
+      InsertTailList (&ReleasedSubtasks, SubLink);
+    }
+
+    RemoveEntryList (Link);
+    FreePool (BlkIo2Req);
+  }
+
+  //
+  // Closing the events also drops their pending notifications.
+  //
+  while (!IsListEmpty (&ReleasedSubtasks)) {
+    Subtask = NVME_BLKIO2_SUBTASK_FROM_LINK (GetFirstNode (&ReleasedSubtasks));
+    RemoveEntryList (&Subtask->Link);
+    gBS->CloseEvent (Subtask->Event);
+    FreePool (Subtask->CommandPacket->NvmeCmd);
+    FreePool (Subtask->CommandPacket->NvmeCompletion);
+    FreePool (Subtask->CommandPacket);
+    FreePool (Subtask);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Read or write blocks which span more than one maximum data transfer size
+  chunk.
+
+  All the chunks are queued to the asynchronous I/O queues at once, so that
+  the controller can process them concurrently, and the function returns when
+  every chunk has completed.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Buffer                 The data buffer.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred.
+  @param  IsWrite                Indicates it is a write operation or a read operation.
+
+  @retval EFI_SUCCESS            Datum are transferred.
+  @retval EFI_TIMEOUT            A timeout occurred and the controller was reset.
+  @retval EFI_DEVICE_ERROR       A timeout occurred and the controller could not
+                                 be recovered.
+  @retval Others                 Fail to transfer all the datum.
+
+**/
+EFI_STATUS
+NvmeTransferChunks (
+  IN NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN VOID                      *Buffer,
+  IN UINT64                    Lba,
+  IN UINTN                     Blocks,
+  IN BOOLEAN                   IsWrite
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  EFI_BLOCK_IO2_TOKEN           Token;
+  EFI_EVENT                     TimerEvent;
+  EFI_STATUS                    Status;
+  EFI_STATUS                    TimeoutStatus;
+  EFI_TPL                       OldTpl;
+  UINTN                         MaxTransferBlocks;
+  UINTN                         ChunkNum;
+
+  Private           = Device->Controller;
+  TimerEvent        = NULL;
+  TimeoutStatus     = EFI_SUCCESS;
+  MaxTransferBlocks = NvmeGetMaxTransferBlocks (Device);
+
+  ZeroMem (&Token, sizeof (EFI_BLOCK_IO2_TOKEN));
+  Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The chunks beyond the queue capacity wait for free slots, allow each chunk
+  // the generic timeout.
+  //
+  ChunkNum = (Blocks + MaxTransferBlocks - 1) / MaxTransferBlocks;
+  Status   = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Status = gBS->SetTimer (TimerEvent, TimerRelative, MultU64x64 (NVME_GENERIC_TIMEOUT, ChunkNum));
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (IsWrite) {
+    Status = NvmeAsyncWrite (Device, Buffer, Lba, Blocks, &Token);
+  } else {
+    Status = NvmeAsyncRead (Device, Buffer, Lba, Blocks, &Token);
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  //
+  // Drive the submission and the completion processing here instead of
+  // waiting for the periodic timer, the caller is blocked on the result.
+  //
+  while (EFI_ERROR (gBS->CheckEvent (Token.Event))) {
+    if (!EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      if (TimeoutStatus != EFI_SUCCESS) {
+        //
+        // The aborted chunks were not all released within the final wait,
+        // release the request here rather than waiting on the controller.
+        //
+        NvmeReleaseBlkIo2Request (Device, &Token);
+        break;
+      }
+
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for the NVMe transfer.\n", __func__));
+
+      //
+      // Stop submitting the remaining chunks.
+      //
+      OldTpl                  = gBS->RaiseTPL (TPL_NOTIFY);
+      Token.TransactionStatus = EFI_TIMEOUT;
+      gBS->RestoreTPL (OldTpl);
+
+      //
+      // Reset the controller, then abort the outstanding chunks, which
+      // signals the token once they are all released.
+      //
+      TimeoutStatus = NvmeRecoverFromTimeout (Private);
+      if (TimeoutStatus != EFI_TIMEOUT) {
+        TimeoutStatus = EFI_DEVICE_ERROR;
+      }
+
+      AbortAsyncPassThruTasks (Private);
+
+      //
+      // The timer has been consumed, re-arm it to bound the wait for the
+      // aborted chunks.
+      //
+      if (EFI_ERROR (gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT))) {
+        NvmeReleaseBlkIo2Request (Device, &Token);
+        break;
+      }
+
+      continue;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  //
+  // The aborted chunks report EFI_ABORTED, return the timeout instead.
+  //
+  Status = (TimeoutStatus != EFI_SUCCESS) ? TimeoutStatus : Token.TransactionStatus;
+
+Exit:
+  if (TimerEvent != NULL) {
+    gBS->CloseEvent (TimerEvent);
+  }
+
+  gBS->CloseEvent (Token.Event);
+  return Status;
+}
+
 /**
   Reset the Block Device.
 
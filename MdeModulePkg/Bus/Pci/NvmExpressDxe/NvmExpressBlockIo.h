@@ -9,6 +9,34 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _EFI_NVME_BLOCKIO_H_
 #define _EFI_NVME_BLOCKIO_H_
 
+/**
+  Read or write blocks which span more than one maximum data transfer size
+  chunk.
+
+  All the chunks are queued to the asynchronous I/O queues at once, so that
+  the controller can process them concurrently, and the function returns when
+  every chunk has completed.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Buffer                 The data buffer.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred.
+  @param  IsWrite                Indicates it is a write operation or a read operation.
+
+  @retval EFI_SUCCESS            Datum are transferred.
+  @retval EFI_TIMEOUT            A timeout occurred and the controller was reset.
+  @retval Others                 Fail to transfer all the datum.
+
+**/
+EFI_STATUS
+NvmeTransferChunks (
+  IN NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN VOID                      *Buffer,
+  IN UINT64                    Lba,
+  IN UINTN                     Blocks,
+  IN BOOLEAN                   IsWrite
+  );
+
 /**
   Reset the Block Device.
 
@@ -564,6 +564,69 @@ NvmeIdentifyNamespace (
   return Status;
 }
 
+/**
+  Request the number of I/O submission and completion queues from the controller
+  with the Set Features (Number of Queues) command, and trim the number of
+  asynchronous I/O queue pairs to what the controller allocates.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return EFI_SUCCESS      Successfully negotiate the number of I/O queues.
+  @return EFI_DEVICE_ERROR Fail to negotiate the number of I/O queues.
+
+**/
+EFI_STATUS
+NvmeSetNumberOfQueues (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET  CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                   Command;
+  EFI_NVM_EXPRESS_COMPLETION                Completion;
+  EFI_STATUS                                Status;
+  UINT16                                    Requested;
+  UINT16                                    Allocated;
+
+  ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+  ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
+  ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
+
+  CommandPacket.NvmeCmd        = &Command;
+  CommandPacket.NvmeCompletion = &Completion;
+
+  //
+  // One blocking I/O queue pair plus the asynchronous I/O queue pairs, the
+  // NSQR and NCQR fields are 0-based.
+  //
+  Requested                    = Private->AsyncQueueNum;
+  Command.Cdw0.Opcode          = NVME_ADMIN_SET_FEATURES_CMD;
+  Command.Cdw10                = NVME_FEATURE_NUMBER_OF_QUEUES;
+  Command.Cdw11                = ((UINT32)Requested << 16) | Requested;
+  Command.Flags                = CDW10_VALID | CDW11_VALID;
+  CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+  CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
+
+  Status = Private->Passthru.PassThru (
+                               &Private->Passthru,
+                               0,
+                               &CommandPacket,
+                               NULL
+                               );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // NSQA and NCQA in completion dword 0 are 0-based as well.
+  //
+  Allocated = MIN ((UINT16)Completion.DW0, (UINT16)(Completion.DW0 >> 16));
+  if (Allocated < Requested) {
+    Private->AsyncQueueNum = MAX (Allocated, 1);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Create io completion queue.
 
@@ -589,7 +652,7 @@ NvmeCreateIoCompletionQueue (
   Status                 = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_START + Private->AsyncQueueNum; Index++) {
     ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
@@ -600,18 +663,14 @@ NvmeCreateIoCompletionQueue (
 
     Command.Cdw0.Opcode          = NVME_ADMIN_CRIOCQ_CMD;
     CommandPacket.TransferBuffer = Private->CqBufferPciAddr[Index];
-    CommandPacket.TransferLength = EFI_PAGE_SIZE;
+    CommandPacket.TransferLength = (Index == 1) ? EFI_PAGE_SIZE : EFI_PAGES_TO_SIZE (NVME_ASYNC_CCQ_PAGES);
     CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
     if (Index == 1) {
       QueueSize = NVME_CCQ_SIZE;
     } else {
-      if (Private->Cap.Mqes > NVME_ASYNC_CCQ_SIZE) {
-        QueueSize = NVME_ASYNC_CCQ_SIZE;
-      } else {
-        QueueSize = Private->Cap.Mqes;
-      }
+      QueueSize = Private->AsyncCqSize;
     }
 
     CrIoCq.Qid   = Index;
@@ -661,7 +720,7 @@ NvmeCreateIoSubmissionQueue (
   Status                 = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_START + Private->AsyncQueueNum; Index++) {
     ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
@@ -672,18 +731,14 @@ NvmeCreateIoSubmissionQueue (
 
     Command.Cdw0.Opcode          = NVME_ADMIN_CRIOSQ_CMD;
     CommandPacket.TransferBuffer = Private->SqBufferPciAddr[Index];
-    CommandPacket.TransferLength = EFI_PAGE_SIZE;
+    CommandPacket.TransferLength = (Index == 1) ? EFI_PAGE_SIZE : EFI_PAGES_TO_SIZE (NVME_ASYNC_CSQ_PAGES);
     CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
     if (Index == 1) {
       QueueSize = NVME_CSQ_SIZE;
     } else {
-      if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
-        QueueSize = NVME_ASYNC_CSQ_SIZE;
-      } else {
-        QueueSize = Private->Cap.Mqes;
-      }
+      QueueSize = Private->AsyncSqSize;
     }
 
     CrIoSq.Qid   = Index;
@@ -732,6 +787,8 @@ NvmeControllerInit (
   NVME_ACQ             Acq;
   UINT8                Sn[21];
   UINT8                Mn[41];
+  UINTN                Offset;
+  UINT16               Index;
 
   //
   // Enable this controller.
@@ -777,19 +834,24 @@ NvmeControllerInit (
   //
   ASSERT ((Private->Cap.Mpsmin + 12) <= EFI_PAGE_SHIFT);
 
-  Private->Cid[0]        = 0;
-  Private->Cid[1]        = 0;
-  Private->Cid[2]        = 0;
-  Private->Pt[0]         = 0;
-  Private->Pt[1]         = 0;
-  Private->Pt[2]         = 0;
-  Private->SqTdbl[0].Sqt = 0;
-  Private->SqTdbl[1].Sqt = 0;
-  Private->SqTdbl[2].Sqt = 0;
-  Private->CqHdbl[0].Cqh = 0;
-  Private->CqHdbl[1].Cqh = 0;
-  Private->CqHdbl[2].Cqh = 0;
-  Private->AsyncSqHead   = 0;
+  ZeroMem (Private->Cid, sizeof (Private->Cid));
+  ZeroMem (Private->Pt, sizeof (Private->Pt));
+  ZeroMem (Private->SqTdbl, sizeof (Private->SqTdbl));
+  ZeroMem (Private->CqHdbl, sizeof (Private->CqHdbl));
+  ZeroMem (Private->AsyncSqHead, sizeof (Private->AsyncSqHead));
+  Private->NextAsyncQueue = 0;
+
+  //
+  // Size the asynchronous I/O queues from CAP.MQES, which is 0-based.
+  //
+  Private->AsyncSqSize = (UINT16)MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes);
+  Private->AsyncCqSize = (UINT16)MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes);
+
+  //
+  // Re-derive the number of asynchronous I/O queue pairs from the queue buffer,
+  // since it may have been trimmed by the controller before a reset.
+  //
+  Private->AsyncQueueNum = (UINT16)((Private->BufferPages - 4) / (NVME_ASYNC_CSQ_PAGES + NVME_ASYNC_CCQ_PAGES));
 
   Status = NvmeDisableController (Private);
 
@@ -818,7 +880,7 @@ NvmeControllerInit (
   //
   // Address of I/O submission & completion queue.
   //
-  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (6));
+  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (Private->BufferPages));
   Private->SqBuffer[0]        = (NVME_SQ *)(UINTN)(Private->Buffer);
   Private->SqBufferPciAddr[0] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr);
   Private->CqBuffer[0]        = (NVME_CQ *)(UINTN)(Private->Buffer + 1 * EFI_PAGE_SIZE);
@@ -827,10 +889,16 @@ NvmeControllerInit (
   Private->SqBufferPciAddr[1] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 2 * EFI_PAGE_SIZE);
   Private->CqBuffer[1]        = (NVME_CQ *)(UINTN)(Private->Buffer + 3 * EFI_PAGE_SIZE);
   Private->CqBufferPciAddr[1] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 3 * EFI_PAGE_SIZE);
-  Private->SqBuffer[2]        = (NVME_SQ *)(UINTN)(Private->Buffer + 4 * EFI_PAGE_SIZE);
-  Private->SqBufferPciAddr[2] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 4 * EFI_PAGE_SIZE);
-  Private->CqBuffer[2]        = (NVME_CQ *)(UINTN)(Private->Buffer + 5 * EFI_PAGE_SIZE);
-  Private->CqBufferPciAddr[2] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 5 * EFI_PAGE_SIZE);
+
+  Offset = 4 * EFI_PAGE_SIZE;
+  for (Index = NVME_ASYNC_QUEUE_START; Index < NVME_ASYNC_QUEUE_START + Private->AsyncQueueNum; Index++) {
+    Private->SqBuffer[Index]        = (NVME_SQ *)(UINTN)(Private->Buffer + Offset);
+    Private->SqBufferPciAddr[Index] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + Offset);
+    Offset                         += EFI_PAGES_TO_SIZE (NVME_ASYNC_CSQ_PAGES);
+    Private->CqBuffer[Index]        = (NVME_CQ *)(UINTN)(Private->Buffer + Offset);
+    Private->CqBufferPciAddr[Index] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + Offset);
+    Offset                         += EFI_PAGES_TO_SIZE (NVME_ASYNC_CCQ_PAGES);
+  }
 
   DEBUG ((DEBUG_INFO, "Private->Buffer = [%016X]\n", (UINT64)(UINTN)Private->Buffer));
   DEBUG ((DEBUG_INFO, "Admin     Submission Queue size (Aqa.Asqs) = [%08X]\n", Aqa.Asqs));
@@ -839,8 +907,10 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "Admin     Completion Queue (CqBuffer[0]) = [%016X]\n", Private->CqBuffer[0]));
   DEBUG ((DEBUG_INFO, "Sync  I/O Submission Queue (SqBuffer[1]) = [%016X]\n", Private->SqBuffer[1]));
   DEBUG ((DEBUG_INFO, "Sync  I/O Completion Queue (CqBuffer[1]) = [%016X]\n", Private->CqBuffer[1]));
-  DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[2]) = [%016X]\n", Private->SqBuffer[2]));
-  DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[2]) = [%016X]\n", Private->CqBuffer[2]));
+  for (Index = NVME_ASYNC_QUEUE_START; Index < NVME_ASYNC_QUEUE_START + Private->AsyncQueueNum; Index++) {
+    DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[%d]) = [%016X]\n", Index, Private->SqBuffer[Index]));
+    DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[%d]) = [%016X]\n", Index, Private->CqBuffer[Index]));
+  }
 
   //
   // Program admin queue attributes.
@@ -919,8 +989,26 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "    NN        : 0x%x\n", Private->ControllerData->Nn));
 
   //
-  // Create two I/O completion queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Negotiate the number of I/O queues. Fall back to a single asynchronous
+  // I/O queue pair if the controller rejects the request.
+  //
+  Status = NvmeSetNumberOfQueues (Private);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "NvmeControllerInit: failed to set number of queues (%r)\n", Status));
+    Private->AsyncQueueNum = 1;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "NvmeControllerInit: %d async I/O queue pair(s), SQ size %d, CQ size %d\n",
+    Private->AsyncQueueNum,
+    Private->AsyncSqSize + 1,
+    Private->AsyncCqSize + 1
+    ));
+
+  //
+  // Create the I/O completion queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
   Status = NvmeCreateIoCompletionQueue (Private);
   if (EFI_ERROR (Status)) {
@@ -928,8 +1016,8 @@ NvmeControllerInit (
   }
 
   //
-  // Create two I/O Submission queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Create the I/O Submission queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
   Status = NvmeCreateIoSubmissionQueue (Private);
 
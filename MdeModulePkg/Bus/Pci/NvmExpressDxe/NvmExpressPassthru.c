@@ -195,30 +195,132 @@ NvmeDumpStatus (
   }
 }
 
+/**
+  Allocate contiguous PRP list pages from the pre-allocated PRP list pool.
+
+  @param[in]  Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  Pages               The number of PRP list pages required.
+  @param[out] PciAddr             The device address of the allocated PRP list pages.
+
+  @return The host address of the allocated PRP list pages, or NULL if the pool
+          cannot satisfy the request.
+
+**/
+VOID *
+NvmeAllocatePrpListFromPool (
+  IN  NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN  UINTN                         Pages,
+  OUT EFI_PHYSICAL_ADDRESS          *PciAddr
+  )
+{
+  UINTN    Index;
+  UINTN    Count;
+  EFI_TPL  OldTpl;
+
+  if ((Private->PrpListPool == NULL) || (Pages > NVME_PRP_LIST_POOL_PAGES)) {
+    return NULL;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  //
+  // First-fit search for a run of free pages.
+  //
+  Count = 0;
+  for (Index = 0; Index < NVME_PRP_LIST_POOL_PAGES; Index++) {
+    if (Private->PrpListPoolUsed[Index]) {
+      Count = 0;
+      continue;
+    }
+
+    Count++;
+    if (Count == Pages) {
+      Index = Index + 1 - Pages;
+      SetMem (&Private->PrpListPoolUsed[Index], Pages, TRUE);
+      gBS->RestoreTPL (OldTpl);
+
+      *PciAddr = Private->PrpListPoolPciAddr + EFI_PAGES_TO_SIZE (Index);
+      return Private->PrpListPool + EFI_PAGES_TO_SIZE (Index);
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return NULL;
+}
+
+/**
+  Release the PRP lists created by NvmeCreatePrpList().
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpListHost    The host base address of PRP lists.
+  @param[in] PrpListNo      The number of PRP List.
+  @param[in] Mapping        The mapping value returned from PciIo.Map(), or NULL
+                            if the PRP lists come from the pre-allocated pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  )
+{
+  UINTN    Index;
+  EFI_TPL  OldTpl;
+
+  if (PrpListHost == NULL) {
+    return;
+  }
+
+  if ((Private->PrpListPool != NULL) &&
+      ((UINT8 *)PrpListHost >= Private->PrpListPool) &&
+      ((UINT8 *)PrpListHost < Private->PrpListPool + EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_PAGES)))
+  {
+    Index = EFI_SIZE_TO_PAGES ((UINTN)((UINT8 *)PrpListHost - Private->PrpListPool));
+    ASSERT (Index + PrpListNo <= NVME_PRP_LIST_POOL_PAGES);
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    SetMem (&Private->PrpListPoolUsed[Index], PrpListNo, FALSE);
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  if (Mapping != NULL) {
+    Private->PciIo->Unmap (Private->PciIo, Mapping);
+  }
+
+  Private->PciIo->FreeBuffer (Private->PciIo, PrpListNo, PrpListHost);
+}
+
 /**
   Create PRP lists for data transfer which is larger than 2 memory pages.
   Note here we calcuate the number of required PRP lists and allocate them at one time.
+  The PRP lists are taken from the pre-allocated pool when possible, and only
+  allocated and mapped separately when the pool is exhausted.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
   @param[out]    PrpListHost         The host base address of PRP lists.
   @param[in,out] PrpListNo           The number of PRP List.
-  @param[out]    Mapping             The mapping value returned from PciIo.Map().
+  @param[out]    Mapping             The mapping value returned from PciIo.Map(),
+                                     or NULL if the PRP lists come from the pool.
 
   @retval The pointer to the first PRP List of the PRP lists.
 
 **/
 VOID *
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL   *PciIo,
-  IN     EFI_PHYSICAL_ADDRESS  PhysicalAddr,
-  IN     UINTN                 Pages,
-  OUT VOID                     **PrpListHost,
-  IN OUT UINTN                 *PrpListNo,
-  OUT VOID                     **Mapping
+  IN     NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN     EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN     UINTN                         Pages,
+  OUT VOID                             **PrpListHost,
+  IN OUT UINTN                         *PrpListNo,
+  OUT VOID                             **Mapping
   )
 {
+  EFI_PCI_IO_PROTOCOL   *PciIo;
   UINTN                 PrpEntryNo;
   UINT64                PrpListBase;
   UINTN                 PrpListIndex;
@@ -228,6 +330,9 @@ NvmeCreatePrpList (
   UINTN                 Bytes;
   EFI_STATUS            Status;
 
+  PciIo    = Private->PciIo;
+  *Mapping = NULL;
+
   //
   // The number of Prp Entry in a memory page.
   //
@@ -247,32 +352,36 @@ NvmeCreatePrpList (
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = PciIo->AllocateBuffer (
-                    PciIo,
-                    AllocateAnyPages,
-                    EfiBootServicesData,
-                    *PrpListNo,
-                    PrpListHost,
-                    0
-                    );
+  Bytes        = EFI_PAGES_TO_SIZE (*PrpListNo);
+  *PrpListHost = NvmeAllocatePrpListFromPool (Private, *PrpListNo, &PrpListPhyAddr);
+  if (*PrpListHost == NULL) {
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      *PrpListNo,
+                      PrpListHost,
+                      0
+                      );
 
-  if (EFI_ERROR (Status)) {
-    return NULL;
-  }
-
-  Bytes  = EFI_PAGES_TO_SIZE (*PrpListNo);
-  Status = PciIo->Map (
-                    PciIo,
-                    EfiPciIoOperationBusMasterCommonBuffer,
-                    *PrpListHost,
-                    &Bytes,
-                    &PrpListPhyAddr,
-                    Mapping
-                    );
+    if (EFI_ERROR (Status)) {
+      *PrpListHost = NULL;
+      return NULL;
+    }
 
-  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
-    DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
+    Status = PciIo->Map (
+                      PciIo,
+                      EfiPciIoOperationBusMasterCommonBuffer,
+                      *PrpListHost,
+                      &Bytes,
+                      &PrpListPhyAddr,
+                      Mapping
+                      );
+
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
+      DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
+      goto EXIT;
+    }
   }
 
   //
@@ -280,7 +389,7 @@ NvmeCreatePrpList (
   //
   ZeroMem (*PrpListHost, Bytes);
   for (PrpListIndex = 0; PrpListIndex < *PrpListNo - 1; ++PrpListIndex) {
-    PrpListBase = *(UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+    PrpListBase = (UINT64)(UINTN)*PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
 
     for (PrpEntryIndex = 0; PrpEntryIndex < PrpEntryNo; ++PrpEntryIndex) {
       if (PrpEntryIndex != PrpEntryNo - 1) {
@@ -301,7 +410,7 @@ NvmeCreatePrpList (
   //
   // Fill last PRP list.
   //
-  PrpListBase = *(UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  PrpListBase = (UINT64)(UINTN)*PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
   for (PrpEntryIndex = 0; PrpEntryIndex < Remainder; ++PrpEntryIndex) {
     *((UINT64 *)(UINTN)PrpListBase + PrpEntryIndex) = PhysicalAddr;
     PhysicalAddr                                   += EFI_PAGE_SIZE;
@@ -310,10 +419,100 @@ NvmeCreatePrpList (
   return (VOID *)(UINTN)PrpListPhyAddr;
 
 EXIT:
+  if (*Mapping != NULL) {
+    PciIo->Unmap (PciIo, *Mapping);
+    *Mapping = NULL;
+  }
+
   PciIo->FreeBuffer (PciIo, *PrpListNo, *PrpListHost);
+  *PrpListHost = NULL;
   return NULL;
 }
 
+/**
+  Select an asynchronous I/O queue pair which has a free submission queue slot.
+
+  The asynchronous I/O queue pairs are used in a round robin manner, so that the
+  outstanding requests are spread across all of them.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return The selected queue ID, or 0 if all the asynchronous I/O submission
+          queues are full.
+
+**/
+UINT16
+NvmeSelectAsyncQueue (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  UINT16  Index;
+  UINT16  QueueId;
+  UINT16  QueueSize;
+
+  QueueSize = Private->AsyncSqSize + 1;
+
+  for (Index = 0; Index < Private->AsyncQueueNum; Index++) {
+    QueueId = NVME_ASYNC_QUEUE_START + (Private->NextAsyncQueue + Index) % Private->AsyncQueueNum;
+    if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize != Private->AsyncSqHead[QueueId]) {
+      Private->NextAsyncQueue = (Private->NextAsyncQueue + Index + 1) % Private->AsyncQueueNum;
+      return QueueId;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  Check whether the data buffer of a command can be described by a single SGL
+  Data Block descriptor.
+
+  SGLs are only used for commands submitted to the I/O queues of a controller
+  which reports SGL support in the Identify Controller data. Commands with a
+  metadata buffer keep using PRPs, since MPTR would otherwise have to point to
+  another SGL segment.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] QueueType      The queue type of the command.
+  @param[in] MapData        The mapping of the data buffer.
+  @param[in] MapMeta        The mapping of the metadata buffer.
+  @param[in] PhysicalAddr   The device address of the data buffer.
+  @param[in] Bytes          The length of the data buffer.
+
+  @retval TRUE              An SGL Data Block descriptor can be used.
+  @retval FALSE             PRPs must be used.
+
+**/
+BOOLEAN
+NvmeUseSglForTransfer (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN UINT8                         QueueType,
+  IN VOID                          *MapData,
+  IN VOID                          *MapMeta,
+  IN EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN UINT32                        Bytes
+  )
+{
+  UINT32  Sgls;
+
+  if ((QueueType != NVME_IO_QUEUE) || (MapData == NULL) || (MapMeta != NULL)) {
+    return FALSE;
+  }
+
+  Sgls = Private->ControllerData->Sgls;
+  if ((Sgls & NVME_CTRL_SGLS_SUPPORT_MASK) == 0) {
+    return FALSE;
+  }
+
+  if (((Sgls & NVME_CTRL_SGLS_SUPPORT_MASK) == NVME_CTRL_SGLS_DWORD_ALIGNMENT) &&
+      (((PhysicalAddr | Bytes) & (sizeof (UINT32) - 1)) != 0))
+  {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
   Aborts the asynchronous PassThru requests.
 
@@ -384,17 +583,12 @@ AbortAsyncPassThruTasks (
       PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
     }
 
-    if (AsyncRequest->MapPrpList != NULL) {
-      PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-    }
-
-    if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
-    }
+    NvmeFreePrpList (
+      Private,
+      AsyncRequest->PrpListHost,
+      AsyncRequest->PrpListNo,
+      AsyncRequest->MapPrpList
+      );
 
     RemoveEntryList (Link);
     gBS->SignalEvent (AsyncRequest->CallerEvent);
@@ -414,6 +608,59 @@ AbortAsyncPassThruTasks (
   return Status;
 }
 
+/**
+  Reset the NVMe controller after a command timeout and abort all the
+  outstanding asynchronous requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_TIMEOUT       The controller has been reset and the asynchronous
+                            requests have been aborted.
+  @retval Others            Fail to recover the controller.
+
+**/
+EFI_STATUS
+NvmeRecoverFromTimeout (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  //
+  // Disable the timer to trigger the process of async transfers temporarily.
+  //
+  Status = gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Reset the NVMe controller.
+  //
+  Status = NvmeControllerInit (Private);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Status = AbortAsyncPassThruTasks (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Re-enable the timer to trigger the process of async transfers.
+  //
+  Status = gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Return EFI_TIMEOUT to indicate a timeout occurs for NVMe command.
+  //
+  return EFI_TIMEOUT;
+}
+
 /**
   Sends an NVM Express Command Packet to an NVM Express controller or namespace. This function supports
   both blocking I/O and non-blocking I/O. The blocking I/O functionality is required, and the non-blocking
@@ -473,6 +720,7 @@ NvmExpressPassThru (
   VOID                           *MapPrpList;
   UINTN                          MapLength;
   UINT64                         *Prp;
+  NVME_SGL_DESCRIPTOR            *SglDescriptor;
   VOID                           *PrpListHost;
   UINTN                          PrpListNo;
   UINT32                         Attributes;
@@ -553,7 +801,7 @@ NvmExpressPassThru (
   Prp         = NULL;
   TimerEvent  = NULL;
   Status      = EFI_SUCCESS;
-  QueueSize   = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
+  QueueSize   = Private->AsyncSqSize + 1;
 
   if (Packet->QueueType == NVME_ADMIN_QUEUE) {
     QueueId = 0;
@@ -561,14 +809,11 @@ NvmExpressPassThru (
     if (Event == NULL) {
       QueueId = 1;
     } else {
-      QueueId = 2;
-
       //
       // Submission queue full check.
       //
-      if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize ==
-          Private->AsyncSqHead)
-      {
+      QueueId = NvmeSelectAsyncQueue (Private);
+      if (QueueId == 0) {
         return EFI_NOT_READY;
       }
     }
@@ -587,15 +832,6 @@ NvmExpressPassThru (
   Sq->Cid  = Private->Cid[QueueId]++;
   Sq->Nsid = Packet->NvmeCmd->Nsid;
 
-  //
-  // Currently we only support PRP for data transfer, SGL is NOT supported.
-  //
-  ASSERT (Sq->Psdt == 0);
-  if (Sq->Psdt != 0) {
-    DEBUG ((DEBUG_ERROR, "NvmExpressPassThru: doesn't support SGL mechanism\n"));
-    return EFI_UNSUPPORTED;
-  }
-
   Sq->Prp[0] = (UINT64)(UINTN)Packet->TransferBuffer;
   if ((Packet->QueueType == NVME_ADMIN_QUEUE) &&
       ((Sq->Opc == NVME_ADMIN_CRIOCQ_CMD) || (Sq->Opc == NVME_ADMIN_CRIOSQ_CMD)))
@@ -670,17 +906,27 @@ NvmExpressPassThru (
 
   //
   // If the buffer size spans more than two memory pages (page size as defined in CC.Mps),
-  // then build a PRP list in the second PRP submission queue entry.
+  // then build a PRP list in the second PRP submission queue entry. When the controller
+  // supports SGLs for I/O commands, the mapped buffer is described by a single SGL Data
+  // Block descriptor instead, which needs no PRP list at all.
   //
   Offset = ((UINT16)Sq->Prp[0]) & (EFI_PAGE_SIZE - 1);
   Bytes  = Packet->TransferLength;
 
-  if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
+  if (((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) &&
+      NvmeUseSglForTransfer (Private, Packet->QueueType, MapData, MapMeta, Sq->Prp[0], Bytes))
+  {
+    SglDescriptor             = (NVME_SGL_DESCRIPTOR *)Sq->Prp;
+    SglDescriptor->Address    = Sq->Prp[0];
+    SglDescriptor->Length     = Bytes;
+    SglDescriptor->Identifier = NVME_SGL_DATA_BLOCK_DESCRIPTOR << 4;
+    Sq->Psdt                  = NVME_PSDT_SGL_MPTR_CONTIGUOUS;
+  } else if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
     //
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp     = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -760,6 +1006,7 @@ NvmExpressPassThru (
 
     AsyncRequest->Signature   = NVME_PASS_THRU_ASYNC_REQ_SIG;
     AsyncRequest->Packet      = Packet;
+    AsyncRequest->QueueId     = QueueId;
     AsyncRequest->CommandId   = Sq->Cid;
     AsyncRequest->CallerEvent = Event;
     AsyncRequest->MapData     = MapData;
@@ -832,36 +1079,7 @@ NvmExpressPassThru (
     //
     DEBUG ((DEBUG_ERROR, "NvmExpressPassThru: Timeout occurs for an NVMe command.\n"));
 
-    //
-    // Disable the timer to trigger the process of async transfers temporarily.
-    //
-    Status = gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
-    if (EFI_ERROR (Status)) {
-      goto EXIT;
-    }
-
-    //
-    // Reset the NVMe controller.
-    //
-    Status = NvmeControllerInit (Private);
-    if (!EFI_ERROR (Status)) {
-      Status = AbortAsyncPassThruTasks (Private);
-      if (!EFI_ERROR (Status)) {
-        //
-        // Re-enable the timer to trigger the process of async transfers.
-        //
-        Status = gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
-        if (!EFI_ERROR (Status)) {
-          //
-          // Return EFI_TIMEOUT to indicate a timeout occurs for NVMe PassThru command.
-          //
-          Status = EFI_TIMEOUT;
-        }
-      }
-    } else {
-      Status = EFI_DEVICE_ERROR;
-    }
-
+    Status = NvmeRecoverFromTimeout (Private);
     goto EXIT;
   }
 
@@ -907,15 +1125,8 @@ EXIT:
              );
   }
 
-  if (MapPrpList != NULL) {
-    PciIo->Unmap (
-             PciIo,
-             MapPrpList
-             );
-  }
-
   if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+    NvmeFreePrpList (Private, PrpListHost, PrpListNo, MapPrpList);
   }
 
   if (TimerEvent != NULL) {
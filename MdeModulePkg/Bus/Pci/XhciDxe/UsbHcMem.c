@@ -465,6 +465,124 @@ UsbHcFreeMemPool (
   return EFI_SUCCESS;
 }
 
+/**
+  Initialize an object cache and preallocate its objects.
+
+  @param  Cache                The object cache to initialize.
+  @param  ObjSize              Size of each object, at least sizeof (LIST_ENTRY).
+  @param  ObjNum               Number of objects to preallocate.
+
+  @retval EFI_SUCCESS          The object cache is initialized.
+  @retval EFI_OUT_OF_RESOURCES Fail to preallocate the objects.
+
+**/
+EFI_STATUS
+UsbHcInitObjCache (
+  OUT USBHC_OBJ_CACHE  *Cache,
+  IN  UINTN            ObjSize,
+  IN  UINTN            ObjNum
+  )
+{
+  UINTN  Index;
+
+  ASSERT (ObjSize >= sizeof (LIST_ENTRY));
+
+  InitializeListHead (&Cache->FreeList);
+  Cache->ObjSize = ALIGN_VALUE (ObjSize, sizeof (UINTN));
+  Cache->ObjNum  = 0;
+  Cache->Buf     = AllocatePool (Cache->ObjSize * ObjNum);
+
+  if (Cache->Buf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Cache->ObjNum = ObjNum;
+
+  //
+  // A free object is linked into the free list through its first bytes.
+  //
+  for (Index = 0; Index < ObjNum; Index++) {
+    InsertTailList (&Cache->FreeList, (LIST_ENTRY *)(Cache->Buf + Index * Cache->ObjSize));
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Release the preallocated objects of an object cache.
+
+  All the objects allocated from the cache must have been freed.
+
+  @param  Cache                The object cache to release.
+
+**/
+VOID
+UsbHcFreeObjCache (
+  IN USBHC_OBJ_CACHE  *Cache
+  )
+{
+  if (Cache->Buf != NULL) {
+    FreePool (Cache->Buf);
+  }
+
+  InitializeListHead (&Cache->FreeList);
+  Cache->Buf    = NULL;
+  Cache->ObjNum = 0;
+}
+
+/**
+  Allocate a zeroed object from an object cache.
+
+  @param  Cache                The object cache.
+
+  @return The allocated object or NULL.
+
+**/
+VOID *
+UsbHcAllocateObj (
+  IN USBHC_OBJ_CACHE  *Cache
+  )
+{
+  LIST_ENTRY  *Obj;
+
+  if (IsListEmpty (&Cache->FreeList)) {
+    return AllocateZeroPool (Cache->ObjSize);
+  }
+
+  Obj = GetFirstNode (&Cache->FreeList);
+  RemoveEntryList (Obj);
+  ZeroMem (Obj, Cache->ObjSize);
+
+  return Obj;
+}
+
+/**
+  Free an object back to the object cache it was allocated from.
+
+  @param  Cache                The object cache.
+  @param  Obj                  The object to free.
+
+**/
+VOID
+UsbHcFreeObj (
+  IN USBHC_OBJ_CACHE  *Cache,
+  IN VOID             *Obj
+  )
+{
+  UINT8  *Ptr;
+
+  Ptr = (UINT8 *)Obj;
+
+  if ((Cache->Buf != NULL) &&
+      (Ptr >= Cache->Buf) &&
+      (Ptr < Cache->Buf + Cache->ObjSize * Cache->ObjNum))
+  {
+    InsertHeadList (&Cache->FreeList, (LIST_ENTRY *)Ptr);
+  } else {
+    FreePool (Obj);
+  }
+}
+
 /**
   Allocate some memory from the host controller's memory pool
   which can be used to communicate with host controller.
@@ -38,6 +38,24 @@ typedef struct _USBHC_MEM_POOL {
   USBHC_MEM_BLOCK        *Head;
 } USBHC_MEM_POOL;
 
+//
+// USBHC_OBJ_CACHE keeps a preallocated array of fixed-size host
+// memory objects, such as URBs, on a free list. It saves a trip to
+// the pool allocator for every transfer. Objects are handed out
+// from the pool when the cache runs dry.
+//
+typedef struct _USBHC_OBJ_CACHE {
+  UINT8         *Buf;
+  UINTN         ObjSize;
+  UINTN         ObjNum;
+  LIST_ENTRY    FreeList;
+} USBHC_OBJ_CACHE;
+
+//
+// Number of URBs preallocated per host controller.
+//
+#define USBHC_URB_CACHE_NUMBER  32
+
 //
 // Memory allocation unit, must be 2^n, n>4
 //
@@ -123,6 +141,63 @@ UsbHcFreeMem (
   IN UINTN           Size
   );
 
+/**
+  Initialize an object cache and preallocate its objects.
+
+  @param  Cache                The object cache to initialize.
+  @param  ObjSize              Size of each object, at least sizeof (LIST_ENTRY).
+  @param  ObjNum               Number of objects to preallocate.
+
+  @retval EFI_SUCCESS          The object cache is initialized.
+  @retval EFI_OUT_OF_RESOURCES Fail to preallocate the objects.
+
+**/
+EFI_STATUS
+UsbHcInitObjCache (
+  OUT USBHC_OBJ_CACHE  *Cache,
+  IN  UINTN            ObjSize,
+  IN  UINTN            ObjNum
+  );
+
+/**
+  Release the preallocated objects of an object cache.
+
+  All the objects allocated from the cache must have been freed.
+
+  @param  Cache                The object cache to release.
+
+**/
+VOID
+UsbHcFreeObjCache (
+  IN USBHC_OBJ_CACHE  *Cache
+  );
+
+/**
+  Allocate a zeroed object from an object cache.
+
+  @param  Cache                The object cache.
+
+  @return The allocated object or NULL.
+
+**/
+VOID *
+UsbHcAllocateObj (
+  IN USBHC_OBJ_CACHE  *Cache
+  );
+
+/**
+  Free an object back to the object cache it was allocated from.
+
+  @param  Cache                The object cache.
+  @param  Obj                  The object to free.
+
+**/
+VOID
+UsbHcFreeObj (
+  IN USBHC_OBJ_CACHE  *Cache,
+  IN VOID             *Obj
+  );
+
 /**
   Calculate the corresponding pci bus address according to the Mem parameter.
 
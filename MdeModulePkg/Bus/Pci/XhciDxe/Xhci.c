@@ -205,10 +205,10 @@ XhcReset (
       }
 
       //
-      // Clean up the asynchronous transfers, currently only
-      // interrupt supports asynchronous operation.
+      // Clean up the asynchronous interrupt and bulk transfers.
       //
       XhciDelAllAsyncIntTransfers (Xhc);
+      XhciDelAllAsyncBulkTransfers (Xhc);
       XhcFreeSched (Xhc);
 
       XhcInitSched (Xhc);
@@ -1343,6 +1343,142 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Queue an asynchronous bulk transfer to a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support bulk
+                                transfer.
+  @param  MaximumPacketLength   Maximum packet size the endpoint is capable of
+                                sending or receiving.
+  @param  Data                  The buffer of data to transmit from or receive into.
+  @param  DataLength            The length of the data buffer.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                the transfer is allowed to complete.
+  @param  CallBackFunction      Function to call when the transfer is finished.
+  @param  Context               Context passed to CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer was queued successfully.
+  @retval EFI_OUT_OF_RESOURCES  The transfer failed due to lack of resource.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_DEVICE_ERROR      The transfer failed due to host controller error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkTransfer (
+  IN EDKII_USB_ASYNC_BULK_PROTOCOL    *This,
+  IN UINT8                            DeviceAddress,
+  IN UINT8                            EndPointAddress,
+  IN UINT8                            DeviceSpeed,
+  IN UINTN                            MaximumPacketLength,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN UINTN                            Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  CallBackFunction,
+  IN VOID                             *Context OPTIONAL
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  URB                *Urb;
+  UINT8              SlotId;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  //
+  // Validate the parameters
+  //
+  if ((Data == NULL) || (DataLength == 0) || (CallBackFunction == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((DeviceSpeed == EFI_USB_SPEED_LOW) ||
+      ((DeviceSpeed == EFI_USB_SPEED_FULL) && (MaximumPacketLength > 64)) ||
+      ((EFI_USB_SPEED_HIGH == DeviceSpeed) && (MaximumPacketLength > 512)) ||
+      ((EFI_USB_SPEED_SUPER == DeviceSpeed) && (MaximumPacketLength > 1024)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_ASYNC_BULK_THIS (This);
+  Status = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcAsyncBulkTransfer: HC is halted\n"));
+    goto ON_EXIT;
+  }
+
+  //
+  // Check if the device is still enabled before every transaction.
+  //
+  SlotId = XhcBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId == 0) {
+    goto ON_EXIT;
+  }
+
+  Urb = XhciInsertAsyncBulkTransfer (
+          Xhc,
+          DeviceAddress,
+          EndPointAddress,
+          DeviceSpeed,
+          MaximumPacketLength,
+          Data,
+          DataLength,
+          Timeout,
+          CallBackFunction,
+          Context
+          );
+  if (Urb == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  //
+  // Ring the doorbell, the completion is reported by XhcMonitorAsyncRequests.
+  //
+  Status = RingIntTransferDoorBell (Xhc, Urb);
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Cancel all the asynchronous bulk transfers queued on an endpoint.
+
+  @param  This                  This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+
+  @retval EFI_SUCCESS           The transfers were cancelled.
+  @retval EFI_NOT_FOUND         No transfer is queued on the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcCancelAsyncBulkTransfer (
+  IN EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                          DeviceAddress,
+  IN UINT8                          EndPointAddress
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_ASYNC_BULK_THIS (This);
+  Status = XhciDelAsyncBulkTransfer (Xhc, DeviceAddress, EndPointAddress);
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
 /**
   Submits an asynchronous interrupt transfer to an
   interrupt endpoint of a USB device.
@@ -1835,6 +1971,16 @@ XhcCreateUsbHc (
   }
 
   InitializeListHead (&Xhc->AsyncIntTransfers);
+  InitializeListHead (&Xhc->AsyncBulkTransfers);
+
+  Xhc->AsyncBulk.AsyncBulkTransfer       = XhcAsyncBulkTransfer;
+  Xhc->AsyncBulk.CancelAsyncBulkTransfer = XhcCancelAsyncBulkTransfer;
+
+  //
+  // Preallocate the URBs. The transfers fall back to pool
+  // allocations if it fails or the cache runs dry.
+  //
+  UsbHcInitObjCache (&Xhc->UrbCache, sizeof (URB), USBHC_URB_CACHE_NUMBER);
 
   //
   // Be caution that the Offset passed to XhcReadCapReg() should be Dword align
@@ -1896,6 +2042,7 @@ XhcCreateUsbHc (
   return Xhc;
 
 ON_ERROR:
+  UsbHcFreeObjCache (&Xhc->UrbCache);
   FreePool (Xhc);
   return NULL;
 }
@@ -2145,11 +2292,13 @@ XhcDriverBindingStart (
     FALSE
     );
 
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &Xhc->Usb2Hc
+                  &Xhc->Usb2Hc,
+                  &gEdkiiUsbAsyncBulkProtocolGuid,
+                  &Xhc->AsyncBulk,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "XhcDriverBindingStart: failed to install USB2_HC Protocol\n"));
@@ -2162,6 +2311,7 @@ XhcDriverBindingStart (
 FREE_POOL:
   gBS->CloseEvent (Xhc->PollTimer);
   XhcFreeSched (Xhc);
+  UsbHcFreeObjCache (&Xhc->UrbCache);
   FreePool (Xhc);
 
 CLOSE_PCIIO:
@@ -2233,19 +2383,22 @@ XhcDriverBindingStop (
     return Status;
   }
 
-  Status = gBS->UninstallProtocolInterface (
+  Xhc   = XHC_FROM_THIS (Usb2Hc);
+  PciIo = Xhc->PciIo;
+
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  Usb2Hc
+                  Usb2Hc,
+                  &gEdkiiUsbAsyncBulkProtocolGuid,
+                  &Xhc->AsyncBulk,
+                  NULL
                   );
 
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
-  Xhc   = XHC_FROM_THIS (Usb2Hc);
-  PciIo = Xhc->PciIo;
-
   //
   // Stop AsyncRequest Polling timer then stop the XHCI driver
   // and uninstall the XHCI protocl.
@@ -2281,7 +2434,9 @@ XhcDriverBindingStop (
   XhcHaltHC (Xhc, XHC_GENERIC_TIMEOUT);
   XhcClearBiosOwnership (Xhc);
   XhciDelAllAsyncIntTransfers (Xhc);
+  XhciDelAllAsyncBulkTransfers (Xhc);
   XhcFreeSched (Xhc);
+  UsbHcFreeObjCache (&Xhc->UrbCache);
 
   if (Xhc->ControllerNameTable) {
     FreeUnicodeStringTable (Xhc->ControllerNameTable);
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/Usb2HostController.h>
+#include <Protocol/UsbAsyncBulk.h>
 #include <Protocol/PciIo.h>
 
 #include <Guid/EventGroup.h>
@@ -104,6 +105,8 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 
 #define XHCI_INSTANCE_SIG  SIGNATURE_32 ('x', 'h', 'c', 'i')
 #define XHC_FROM_THIS(a)  CR(a, USB_XHCI_INSTANCE, Usb2Hc, XHCI_INSTANCE_SIG)
+#define XHC_FROM_ASYNC_BULK_THIS(a) \
+          CR(a, USB_XHCI_INSTANCE, AsyncBulk, XHCI_INSTANCE_SIG)
 
 #define USB_DESC_TYPE_HUB              0x29
 #define USB_DESC_TYPE_HUB_SUPER_SPEED  0x2a
@@ -206,8 +209,10 @@ struct _USB_XHCI_INSTANCE {
   EFI_PCI_IO_PROTOCOL         *PciIo;
   UINT64                      OriginalPciAttributes;
   USBHC_MEM_POOL              *MemPool;
+  USBHC_OBJ_CACHE             UrbCache;
 
-  EFI_USB2_HC_PROTOCOL        Usb2Hc;
+  EFI_USB2_HC_PROTOCOL           Usb2Hc;
+  EDKII_USB_ASYNC_BULK_PROTOCOL  AsyncBulk;
 
   EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
 
@@ -218,6 +223,7 @@ struct _USB_XHCI_INSTANCE {
   EFI_EVENT                   ExitBootServiceEvent;
   EFI_EVENT                   PollTimer;
   LIST_ENTRY                  AsyncIntTransfers;
+  LIST_ENTRY                  AsyncBulkTransfers;
 
   UINT8                       CapLength;  ///< Capability Register Length
   XHC_HCSPARAMS1              HcSParams1; ///< Structural Parameters 1
@@ -610,6 +616,63 @@ XhcAsyncInterruptTransfer (
   IN     VOID                                *Context OPTIONAL
   );
 
+/**
+  Queue an asynchronous bulk transfer to a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support bulk
+                                transfer.
+  @param  MaximumPacketLength   Maximum packet size the endpoint is capable of
+                                sending or receiving.
+  @param  Data                  The buffer of data to transmit from or receive into.
+  @param  DataLength            The length of the data buffer.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                the transfer is allowed to complete.
+  @param  CallBackFunction      Function to call when the transfer is finished.
+  @param  Context               Context passed to CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer was queued successfully.
+  @retval EFI_OUT_OF_RESOURCES  The transfer failed due to lack of resource.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_DEVICE_ERROR      The transfer failed due to host controller error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkTransfer (
+  IN EDKII_USB_ASYNC_BULK_PROTOCOL    *This,
+  IN UINT8                            DeviceAddress,
+  IN UINT8                            EndPointAddress,
+  IN UINT8                            DeviceSpeed,
+  IN UINTN                            MaximumPacketLength,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN UINTN                            Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  CallBackFunction,
+  IN VOID                             *Context OPTIONAL
+  );
+
+/**
+  Cancel all the asynchronous bulk transfers queued on an endpoint.
+
+  @param  This                  This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+
+  @retval EFI_SUCCESS           The transfers were cancelled.
+  @retval EFI_NOT_FOUND         No transfer is queued on the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcCancelAsyncBulkTransfer (
+  IN EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                          DeviceAddress,
+  IN UINT8                          EndPointAddress
+  );
+
 /**
   Submits synchronous interrupt transfer to an interrupt endpoint
   of a USB device.
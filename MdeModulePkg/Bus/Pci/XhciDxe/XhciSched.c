@@ -30,7 +30,7 @@ XhcCreateCmdTrb (
 {
   URB  *Urb;
 
-  Urb = AllocateZeroPool (sizeof (URB));
+  Urb = UsbHcAllocateObj (&Xhc->UrbCache);
   if (Urb == NULL) {
     return NULL;
   }
@@ -150,7 +150,7 @@ XhcCreateUrb (
   EFI_STATUS    Status;
   URB           *Urb;
 
-  Urb = AllocateZeroPool (sizeof (URB));
+  Urb = UsbHcAllocateObj (&Xhc->UrbCache);
   if (Urb == NULL) {
     return NULL;
   }
@@ -175,7 +175,7 @@ XhcCreateUrb (
   Status = XhcCreateTransferTrb (Xhc, Urb);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "XhcCreateUrb: XhcCreateTransferTrb Failed, Status = %r\n", Status));
-    FreePool (Urb);
+    UsbHcFreeObj (&Xhc->UrbCache, Urb);
     Urb = NULL;
   }
 
@@ -203,7 +203,7 @@ XhcFreeUrb (
     Xhc->PciIo->Unmap (Xhc->PciIo, Urb->DataMap);
   }
 
-  FreePool (Urb);
+  UsbHcFreeObj (&Xhc->UrbCache, Urb);
 }
 
 /**
@@ -230,6 +230,8 @@ XhcCreateTransferTrb (
   UINTN                          TotalLen;
   UINTN                          Len;
   UINTN                          TrbNum;
+  UINTN                          DataPhy;
+  UINTN                          PacketsLeft;
   EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   VOID                           *Map;
@@ -387,26 +389,44 @@ XhcCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
+      //
+      // The whole bulk transfer is one TD made of chained Normal TRBs, so a
+      // short packet retires it at once instead of leaving the remaining
+      // TRBs waiting for more data. The data buffer of a TRB must not cross
+      // a 64KB boundary (xHCI 6.4.1.1), and TD Size gives the number of
+      // packets left after the TRB (xHCI 4.11.2.4).
+      //
       TotalLen = 0;
       Len      = 0;
       TrbNum   = 0;
       TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
       while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
-          Len = Urb->DataLen - TotalLen;
-        } else {
-          Len = 0x10000;
+        DataPhy = (UINTN)Urb->DataPhy + TotalLen;
+        Len     = MIN (Urb->DataLen - TotalLen, SIZE_64KB - (DataPhy & (SIZE_64KB - 1)));
+
+        PacketsLeft = 0;
+        if (Urb->Ep.MaxPacket != 0) {
+          PacketsLeft = (Urb->DataLen - TotalLen - Len + Urb->Ep.MaxPacket - 1) / Urb->Ep.MaxPacket;
         }
 
         TrbStart                      = (TRB *)(UINTN)EPRing->RingEnqueue;
-        TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
-        TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
+        TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT (DataPhy);
+        TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT (DataPhy);
         TrbStart->TrbNormal.Length    = (UINT32)Len;
-        TrbStart->TrbNormal.TDSize    = 0;
+        TrbStart->TrbNormal.TDSize    = (UINT32)MIN (PacketsLeft, 31);
         TrbStart->TrbNormal.IntTarget = 0;
         TrbStart->TrbNormal.ISP       = 1;
         TrbStart->TrbNormal.IOC       = 1;
+        TrbStart->TrbNormal.CH        = (TotalLen + Len < Urb->DataLen) ? 1 : 0;
         TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
+
+        //
+        // A Link TRB in the middle of a TD must carry the chain bit as well.
+        //
+        if ((UINT8)(TrbStart + 1)->TrbNormal.Type == TRB_TYPE_LINK) {
+          ((LINK_TRB *)(TrbStart + 1))->CH = TrbStart->TrbNormal.CH;
+        }
+
         //
         // Update the cycle bit
         //
@@ -1088,6 +1108,38 @@ IsAsyncIntTrb (
   return FALSE;
 }
 
+/**
+  Check if the Trb is a transaction of the URBs in XHCI's asynchronous bulk transfer list.
+
+  @param Xhc    The XHCI Instance.
+  @param Trb    The TRB to be checked.
+  @param Urb    The pointer to the matched Urb.
+
+  @retval TRUE  The Trb is matched with a transaction of the URBs in the async list.
+  @retval FALSE The Trb is not matched with any URBs in the async list.
+
+**/
+BOOLEAN
+IsAsyncBulkTrb (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  TRB_TEMPLATE       *Trb,
+  OUT URB                **Urb
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *CheckedUrb;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    CheckedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (IsTransferRingTrb (Xhc, Trb, CheckedUrb)) {
+      *Urb = CheckedUrb;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 /**
   Check the URB's execution result and update the URB's
   result accordingly.
@@ -1160,7 +1212,7 @@ XhcCheckUrbResult (
 
     //
     // Update the status of URB including the pending URB, the URB that is currently checked,
-    // and URBs in the XHCI's async interrupt transfer list.
+    // and URBs in the XHCI's async interrupt and bulk transfer lists.
     // This way is used to avoid that those completed async transfer events don't get
     // handled in time and are flushed by newer coming events.
     //
@@ -1170,10 +1222,20 @@ XhcCheckUrbResult (
       CheckedUrb = Urb;
     } else if (IsAsyncIntTrb (Xhc, TRBPtr, &AsyncUrb)) {
       CheckedUrb = AsyncUrb;
+    } else if (IsAsyncBulkTrb (Xhc, TRBPtr, &AsyncUrb)) {
+      CheckedUrb = AsyncUrb;
     } else {
       continue;
     }
 
+    //
+    // A TD retired early by a short packet may still report trailing
+    // events for its last TRB on some xHCs, ignore them.
+    //
+    if (CheckedUrb->Finished) {
+      continue;
+    }
+
     switch (EvtTrb->Completecode) {
       case TRB_COMPLETION_STALL_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_STALL;
@@ -1226,6 +1288,19 @@ XhcCheckUrbResult (
           CheckedUrb->Completed += (((TRANSFER_TRB_NORMAL *)TRBPtr)->Length - EvtTrb->Length);
         }
 
+        //
+        // A short packet in a chained TD retires the TD, the xHC skips
+        // the rest of its TRBs without reporting events for them.
+        //
+        if ((EvtTrb->Completecode == TRB_COMPLETION_SHORT_PACKET) &&
+            (TRBType == TRB_TYPE_NORMAL) &&
+            (((TRANSFER_TRB_NORMAL *)TRBPtr)->CH != 0))
+        {
+          CheckedUrb->Finished = TRUE;
+          CheckedUrb->EvtTrb   = (TRB_TEMPLATE *)EvtTrb;
+          continue;
+        }
+
         break;
 
       default:
@@ -1520,6 +1595,319 @@ XhciInsertAsyncIntTransfer (
   return Urb;
 }
 
+/**
+  Insert an asynchronous bulk transfer for the device and endpoint.
+
+  @param Xhc            The XHCI Instance
+  @param BusAddr        The logical device address assigned by UsbBus driver
+  @param EpAddr         Endpoint addrress
+  @param DevSpeed       The device speed
+  @param MaxPacket      The max packet length of the endpoint
+  @param Data           The data buffer to transfer
+  @param DataLen        The length of data buffer
+  @param Timeout        The time, in millisecond, the transfer is allowed to take
+  @param Callback       The function to call when the transfer is finished
+  @param Context        The context to the callback
+
+  @return Created URB or NULL
+
+**/
+URB *
+XhciInsertAsyncBulkTransfer (
+  IN USB_XHCI_INSTANCE                *Xhc,
+  IN UINT8                            BusAddr,
+  IN UINT8                            EpAddr,
+  IN UINT8                            DevSpeed,
+  IN UINTN                            MaxPacket,
+  IN VOID                             *Data,
+  IN UINTN                            DataLen,
+  IN UINTN                            Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN VOID                             *Context
+  )
+{
+  LIST_ENTRY              *Entry;
+  URB                     *Urb;
+  EFI_USB_DATA_DIRECTION  Direction;
+  UINTN                   TrbNum;
+
+  Direction = ((EpAddr & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut;
+
+  //
+  // All the queued TDs of an endpoint share its transfer ring. Refuse the
+  // transfer if its TRBs, one per 64KB at most plus one for an unaligned
+  // start, may not fit in the ring space left, keeping the Link TRB aside.
+  //
+  TrbNum = DataLen / SIZE_64KB + 2;
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr == BusAddr) &&
+        (Urb->Ep.EpAddr == (EpAddr & 0x0F)) &&
+        (Urb->Ep.Direction == Direction))
+    {
+      TrbNum += Urb->TrbNum;
+    }
+  }
+
+  if (TrbNum >= TR_RING_TRB_NUMBER - 1) {
+    DEBUG ((DEBUG_ERROR, "%a: transfer ring of EP 0x%x is full\n", __func__, EpAddr));
+    return NULL;
+  }
+
+  Urb = XhcCreateUrb (
+          Xhc,
+          BusAddr,
+          EpAddr,
+          DevSpeed,
+          MaxPacket,
+          XHC_BULK_TRANSFER_ASYNC,
+          NULL,
+          Data,
+          DataLen,
+          Callback,
+          Context
+          );
+  if (Urb == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to create URB\n", __func__));
+    return NULL;
+  }
+
+  Urb->Timeout = Timeout;
+
+  //
+  // The xHC executes the TDs of an endpoint in order, keep the list
+  // in the same order.
+  //
+  InsertTailList (&Xhc->AsyncBulkTransfers, &Urb->UrbList);
+
+  return Urb;
+}
+
+/**
+  Delete all the asynchronous bulk transfers queued for
+  the device and endpoint, without invoking their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpNum                 The endpoint of the target.
+
+  @retval EFI_SUCCESS           The asynchronous transfers are removed.
+  @retval EFI_NOT_FOUND         No transfer for the endpoint is found.
+
+**/
+EFI_STATUS
+XhciDelAsyncBulkTransfer (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  UINT8              BusAddr,
+  IN  UINT8              EpNum
+  )
+{
+  LIST_ENTRY              *Entry;
+  LIST_ENTRY              *Next;
+  URB                     *Urb;
+  URB                     *PendingUrb;
+  EFI_USB_DATA_DIRECTION  Direction;
+  EFI_STATUS              Status;
+  BOOLEAN                 Found;
+
+  Direction = ((EpNum & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut;
+  EpNum    &= 0x0F;
+
+  Found      = FALSE;
+  PendingUrb = NULL;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr == BusAddr) &&
+        (Urb->Ep.EpAddr == EpNum) &&
+        (Urb->Ep.Direction == Direction))
+    {
+      Found = TRUE;
+      if (!Urb->Finished) {
+        PendingUrb = Urb;
+      }
+    }
+  }
+
+  if (!Found) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Stopping the endpoint and moving its dequeue pointer up to the
+  // enqueue pointer removes all the queued TDs at once.
+  //
+  if (PendingUrb != NULL) {
+    Status = XhcDequeueTrbFromEndpoint (Xhc, PendingUrb);
+    if (EFI_ERROR (Status) && (Status != EFI_ALREADY_STARTED)) {
+      DEBUG ((DEBUG_ERROR, "XhciDelAsyncBulkTransfer: XhcDequeueTrbFromEndpoint failed\n"));
+    }
+  }
+
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr == BusAddr) &&
+        (Urb->Ep.EpAddr == EpNum) &&
+        (Urb->Ep.Direction == Direction))
+    {
+      RemoveEntryList (&Urb->UrbList);
+      XhcFreeUrb (Xhc, Urb);
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Remove all the asynchronous bulk transfers, once the host controller is
+  halted. The unfinished transfers complete with EFI_USB_ERR_SYSTEM.
+
+  @param  Xhc    The XHCI Instance.
+
+**/
+VOID
+XhciDelAllAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
+  )
+{
+  URB      *Urb;
+  EFI_TPL  OldTpl;
+
+  //
+  // The TDs will never be executed and the transfer rings go away with
+  // the schedule, so there is no endpoint to stop. The callers may still
+  // be waiting for their transfers, complete them. The callbacks can't
+  // queue new transfers to the halted host controller.
+  //
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+  while (!IsListEmpty (&Xhc->AsyncBulkTransfers)) {
+    Urb = EFI_LIST_CONTAINER (GetFirstNode (&Xhc->AsyncBulkTransfers), URB, UrbList);
+    RemoveEntryList (&Urb->UrbList);
+
+    if (Urb->DataMap != NULL) {
+      Xhc->PciIo->Unmap (Xhc->PciIo, Urb->DataMap);
+      Urb->DataMap = NULL;
+    }
+
+    if (!Urb->Finished) {
+      Urb->Result  |= EFI_USB_ERR_SYSTEM;
+      Urb->Finished = TRUE;
+    }
+
+    if (Urb->Callback != NULL) {
+      (Urb->Callback)(Urb->Data, Urb->Completed, Urb->Context, Urb->Result);
+    }
+
+    XhcFreeUrb (Xhc, Urb);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Mark the unfinished asynchronous bulk transfers queued on the same
+  endpoint as the URB as not executed, after the TDs of the endpoint
+  have been removed from its transfer ring.
+
+  @param  Xhc     The XHCI Instance.
+  @param  Urb     The URB whose endpoint is aborted.
+
+**/
+VOID
+XhcAbortAsyncBulkEndpoint (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN URB                *Urb
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *CheckedUrb;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    CheckedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!CheckedUrb->Finished &&
+        (CheckedUrb->Ep.BusAddr == Urb->Ep.BusAddr) &&
+        (CheckedUrb->Ep.EpAddr == Urb->Ep.EpAddr) &&
+        (CheckedUrb->Ep.Direction == Urb->Ep.Direction))
+    {
+      CheckedUrb->Result  |= EFI_USB_ERR_NOTEXECUTE;
+      CheckedUrb->Finished = TRUE;
+    }
+  }
+}
+
+/**
+  Check the asynchronous bulk transfers, and move the finished ones
+  to a separate list, so their callbacks are free to queue or cancel
+  transfers.
+
+  @param  Xhc     The XHCI Instance.
+  @param  Done    The list to receive the finished URBs.
+
+**/
+VOID
+XhcCheckAsyncBulkRequests (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  OUT LIST_ENTRY         *Done
+  )
+{
+  LIST_ENTRY  *Entry;
+  LIST_ENTRY  *Next;
+  URB         *Urb;
+  EFI_STATUS  Status;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+
+    //
+    // The TDs of a detached device will never be executed.
+    //
+    if (XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr) == 0) {
+      Urb->Result  |= EFI_USB_ERR_SYSTEM;
+      Urb->Finished = TRUE;
+      continue;
+    }
+
+    XhcCheckUrbResult (Xhc, Urb);
+
+    //
+    // The poll timer fires every millisecond.
+    //
+    if (!Urb->Finished && (Urb->Timeout != 0) && (--Urb->Timeout == 0)) {
+      Status = XhcDequeueTrbFromEndpoint (Xhc, Urb);
+      if (Status != EFI_ALREADY_STARTED) {
+        Urb->Result  |= EFI_USB_ERR_TIMEOUT;
+        Urb->Finished = TRUE;
+        XhcAbortAsyncBulkEndpoint (Xhc, Urb);
+      }
+
+      continue;
+    }
+
+    //
+    // Based on XHCI spec 4.8.3, software should do the reset endpoint while USB Transaction occur.
+    // The recovery drops the TDs queued behind the failed one as well.
+    //
+    if (Urb->Finished &&
+        ((Urb->Result & (EFI_USB_ERR_STALL | EFI_USB_ERR_BABBLE | EDKII_USB_ERR_TRANSACTION)) != 0))
+    {
+      Status = XhcRecoverHaltedEndpoint (Xhc, Urb);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "XhcCheckAsyncBulkRequests: XhcRecoverHaltedEndpoint failed!\n"));
+      }
+
+      XhcAbortAsyncBulkEndpoint (Xhc, Urb);
+    }
+  }
+
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (Urb->Finished) {
+      RemoveEntryList (&Urb->UrbList);
+      InsertTailList (Done, &Urb->UrbList);
+    }
+  }
+}
+
 /**
   Update the queue head for next round of asynchronous transfer
 
@@ -1620,6 +2008,7 @@ XhcMonitorAsyncRequests (
   USB_XHCI_INSTANCE  *Xhc;
   LIST_ENTRY         *Entry;
   LIST_ENTRY         *Next;
+  LIST_ENTRY         Done;
   UINT8              *ProcBuf;
   URB                *Urb;
   UINT8              SlotId;
@@ -1708,6 +2097,35 @@ XhcMonitorAsyncRequests (
 
     XhcUpdateAsyncRequest (Xhc, Urb);
   }
+
+  //
+  // Complete the finished asynchronous bulk transfers in order.
+  //
+  InitializeListHead (&Done);
+  XhcCheckAsyncBulkRequests (Xhc, &Done);
+
+  while (!IsListEmpty (&Done)) {
+    Urb = EFI_LIST_CONTAINER (GetFirstNode (&Done), URB, UrbList);
+    RemoveEntryList (&Urb->UrbList);
+
+    //
+    // Unmap the data buffer before the callback, so the data of
+    // an IN transfer is visible to the caller.
+    //
+    if (Urb->DataMap != NULL) {
+      Xhc->PciIo->Unmap (Xhc->PciIo, Urb->DataMap);
+      Urb->DataMap = NULL;
+    }
+
+    if (Urb->Callback != NULL) {
+      gBS->RestoreTPL (OldTpl);
+      (Urb->Callback)(Urb->Data, Urb->Completed, Urb->Context, Urb->Result);
+      OldTpl = gBS->RaiseTPL (XHC_TPL);
+    }
+
+    XhcFreeUrb (Xhc, Urb);
+  }
+
   gBS->RestoreTPL (OldTpl);
 }
 
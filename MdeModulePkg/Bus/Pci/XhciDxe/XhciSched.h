@@ -21,6 +21,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define XHC_INT_TRANSFER_SYNC        0x04
 #define XHC_INT_TRANSFER_ASYNC       0x08
 #define XHC_INT_ONLY_TRANSFER_ASYNC  0x10
+#define XHC_BULK_TRANSFER_ASYNC      0x20
 
 //
 // 6.4.6 TRB Types
@@ -181,6 +182,11 @@ typedef struct _URB {
   EFI_ASYNC_USB_TRANSFER_CALLBACK    Callback;
   VOID                               *Context;
   //
+  // Time left, in millisecond, for an asynchronous bulk transfer to
+  // complete. 0 means no timeout.
+  //
+  UINTN                              Timeout;
+  //
   // Execute result
   //
   UINT32                             Result;
@@ -877,6 +883,68 @@ XhciInsertAsyncIntTransfer (
   IN VOID                             *Context
   );
 
+/**
+  Insert an asynchronous bulk transfer for the device and endpoint.
+
+  @param Xhc            The XHCI Instance
+  @param BusAddr        The logical device address assigned by UsbBus driver
+  @param EpAddr         Endpoint addrress
+  @param DevSpeed       The device speed
+  @param MaxPacket      The max packet length of the endpoint
+  @param Data           The data buffer to transfer
+  @param DataLen        The length of data buffer
+  @param Timeout        The time, in millisecond, the transfer is allowed to take
+  @param Callback       The function to call when the transfer is finished
+  @param Context        The context to the callback
+
+  @return Created URB or NULL
+
+**/
+URB *
+XhciInsertAsyncBulkTransfer (
+  IN USB_XHCI_INSTANCE                *Xhc,
+  IN UINT8                            BusAddr,
+  IN UINT8                            EpAddr,
+  IN UINT8                            DevSpeed,
+  IN UINTN                            MaxPacket,
+  IN VOID                             *Data,
+  IN UINTN                            DataLen,
+  IN UINTN                            Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN VOID                             *Context
+  );
+
+/**
+  Delete all the asynchronous bulk transfers queued for
+  the device and endpoint, without invoking their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpNum                 The endpoint of the target.
+
+  @retval EFI_SUCCESS           The asynchronous transfers are removed.
+  @retval EFI_NOT_FOUND         No transfer for the endpoint is found.
+
+**/
+EFI_STATUS
+XhciDelAsyncBulkTransfer (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  UINT8              BusAddr,
+  IN  UINT8              EpNum
+  );
+
+/**
+  Remove all the asynchronous bulk transfers, once the host controller is
+  halted. The unfinished transfers complete with EFI_USB_ERR_SYSTEM.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhciDelAllAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
+  );
+
 /**
   Set Bios Ownership
 
@@ -26,6 +26,11 @@ EFI_USB_IO_PROTOCOL  mUsbIoProtocol = {
   UsbIoPortReset
 };
 
+EDKII_USB_IO_ASYNC_BULK_PROTOCOL  mUsbIoAsyncBulkProtocol = {
+  UsbIoAsyncBulkTransfer,
+  UsbIoCancelAsyncBulkTransfer
+};
+
 EFI_DRIVER_BINDING_PROTOCOL  mUsbBusDriverBinding = {
   UsbBusControllerDriverSupported,
   UsbBusControllerDriverStart,
@@ -314,6 +319,125 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Queue an asynchronous bulk transfer to the device endpoint.
+
+  @param  This                   The USB IO asynchronous bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  Data                   The data to transfer.
+  @param  DataLength             The length of the data to transfer.
+  @param  Timeout                Time to wait before timeout, in millisecond.
+  @param  CallBackFunction       Function to call when the transfer is finished.
+  @param  Context                Context passed to CallBackFunction.
+
+  @retval EFI_SUCCESS            The transfer is queued.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to queue the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkTransfer (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint,
+  IN VOID                              *Data,
+  IN UINTN                             DataLength,
+  IN UINTN                             Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK   CallBackFunction,
+  IN VOID                              *Context OPTIONAL
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+  EFI_STATUS         Status;
+
+  if ((USB_ENDPOINT_ADDR (Endpoint) == 0) || (USB_ENDPOINT_ADDR (Endpoint) > 15)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf = USB_INTERFACE_FROM_ASYNC_BULK (This);
+  Dev   = UsbIf->Device;
+
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  //
+  // The host controller keeps the data toggle and the transaction
+  // translator of the device itself.
+  //
+  Status = UsbHcAsyncBulkTransfer (
+             Dev->Bus,
+             Dev->Address,
+             Endpoint,
+             Dev->Speed,
+             EpDesc->Desc.MaxPacketSize,
+             Data,
+             DataLength,
+             Timeout,
+             CallBackFunction,
+             Context
+             );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Cancel the asynchronous bulk transfers queued on the device endpoint.
+
+  @param  This                   The USB IO asynchronous bulk instance.
+  @param  Endpoint               The device endpoint.
+
+  @retval EFI_SUCCESS            The transfers are cancelled.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval EFI_NOT_FOUND          No transfer is queued on the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoCancelAsyncBulkTransfer (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+  EFI_STATUS         Status;
+
+  if ((USB_ENDPOINT_ADDR (Endpoint) == 0) || (USB_ENDPOINT_ADDR (Endpoint) > 15)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf = USB_INTERFACE_FROM_ASYNC_BULK (This);
+  Dev   = UsbIf->Device;
+
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = UsbHcCancelAsyncBulkTransfer (Dev->Bus, Dev->Address, Endpoint);
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
 /**
   Execute a synchronous interrupt transfer.
 
@@ -1010,6 +1134,22 @@ UsbBusBuildProtocol (
     }
   }
 
+  //
+  // Let the USB class drivers keep several bulk transfers in flight
+  // if the host controller can.
+  //
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEdkiiUsbAsyncBulkProtocolGuid,
+                  (VOID **)&UsbBus->AsyncBulk,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    UsbBus->AsyncBulk = NULL;
+  }
+
   //
   // Install an EFI_USB_BUS_PROTOCOL to host controller to identify it.
   //
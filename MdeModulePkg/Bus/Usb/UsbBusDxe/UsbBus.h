@@ -14,6 +14,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Protocol/Usb2HostController.h>
 #include <Protocol/UsbIo.h>
+#include <Protocol/UsbAsyncBulk.h>
+#include <Protocol/UsbIoAsyncBulk.h>
 #include <Protocol/DevicePath.h>
 
 #include <Library/BaseLib.h>
@@ -140,6 +142,9 @@ typedef struct _USB_HUB_API    USB_HUB_API;
 #define USB_INTERFACE_FROM_USBIO(a) \
           CR(a, USB_INTERFACE, UsbIo, USB_INTERFACE_SIGNATURE)
 
+#define USB_INTERFACE_FROM_ASYNC_BULK(a) \
+          CR(a, USB_INTERFACE, AsyncBulk, USB_INTERFACE_SIGNATURE)
+
 #define USB_BUS_FROM_THIS(a) \
           CR(a, USB_BUS, BusId, USB_BUS_SIGNATURE)
 
@@ -194,66 +199,68 @@ struct _USB_DEVICE {
 // Stands for different functions of USB device
 //
 struct _USB_INTERFACE {
-  UINTN                       Signature;
-  USB_DEVICE                  *Device;
-  USB_INTERFACE_DESC          *IfDesc;
-  USB_INTERFACE_SETTING       *IfSetting;
+  UINTN                               Signature;
+  USB_DEVICE                          *Device;
+  USB_INTERFACE_DESC                  *IfDesc;
+  USB_INTERFACE_SETTING               *IfSetting;
 
   //
   // Handles and protocols
   //
-  EFI_HANDLE                  Handle;
-  EFI_USB_IO_PROTOCOL         UsbIo;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  BOOLEAN                     IsManaged;
+  EFI_HANDLE                          Handle;
+  EFI_USB_IO_PROTOCOL                 UsbIo;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    AsyncBulk;
+  EFI_DEVICE_PATH_PROTOCOL            *DevicePath;
+  BOOLEAN                             IsManaged;
 
   //
   // Hub device special data
   //
-  BOOLEAN                     IsHub;
-  USB_HUB_API                 *HubApi;
-  UINT8                       NumOfPort;
-  EFI_EVENT                   HubNotify;
+  BOOLEAN                             IsHub;
+  USB_HUB_API                         *HubApi;
+  UINT8                               NumOfPort;
+  EFI_EVENT                           HubNotify;
 
   //
   // Data used only by normal hub devices
   //
-  USB_ENDPOINT_DESC           *HubEp;
-  UINT8                       *ChangeMap;
+  USB_ENDPOINT_DESC                   *HubEp;
+  UINT8                               *ChangeMap;
 
   //
   // Data used only by root hub to hand over device to
   // companion UHCI driver if low/full speed devices are
   // connected to EHCI.
   //
-  UINT8                       MaxSpeed;
+  UINT8                               MaxSpeed;
 };
 
 //
 // Stands for the current USB Bus
 //
 struct _USB_BUS {
-  UINTN                       Signature;
-  EFI_USB_BUS_PROTOCOL        BusId;
+  UINTN                            Signature;
+  EFI_USB_BUS_PROTOCOL             BusId;
 
   //
   // Managed USB host controller
   //
-  EFI_HANDLE                  HostHandle;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  EFI_USB2_HC_PROTOCOL        *Usb2Hc;
+  EFI_HANDLE                       HostHandle;
+  EFI_DEVICE_PATH_PROTOCOL         *DevicePath;
+  EFI_USB2_HC_PROTOCOL             *Usb2Hc;
+  EDKII_USB_ASYNC_BULK_PROTOCOL    *AsyncBulk;
 
   //
   // Recorded the max supported usb devices.
   // XHCI can support up to 255 devices.
   // EHCI/UHCI/OHCI supports up to 127 devices.
   //
-  UINT32                      MaxDevices;
+  UINT32                           MaxDevices;
   //
   // An array of device that is on the bus. Devices[0] is
   // for root hub. Device with address i is at Devices[i].
   //
-  USB_DEVICE                  *Devices[256];
+  USB_DEVICE                       *Devices[256];
 
   //
   // USB Bus driver need to control the recursive connect policy of the bus, only those wanted
@@ -417,6 +424,52 @@ UsbIoBulkTransfer (
   OUT UINT32               *UsbStatus
   );
 
+/**
+  Queue an asynchronous bulk transfer to the device endpoint.
+
+  @param  This                   The USB IO asynchronous bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  Data                   The data to transfer.
+  @param  DataLength             The length of the data to transfer.
+  @param  Timeout                Time to wait before timeout, in millisecond.
+  @param  CallBackFunction       Function to call when the transfer is finished.
+  @param  Context                Context passed to CallBackFunction.
+
+  @retval EFI_SUCCESS            The transfer is queued.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to queue the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkTransfer (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint,
+  IN VOID                              *Data,
+  IN UINTN                             DataLength,
+  IN UINTN                             Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK   CallBackFunction,
+  IN VOID                              *Context OPTIONAL
+  );
+
+/**
+  Cancel the asynchronous bulk transfers queued on the device endpoint.
+
+  @param  This                   The USB IO asynchronous bulk instance.
+  @param  Endpoint               The device endpoint.
+
+  @retval EFI_SUCCESS            The transfers are cancelled.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval EFI_NOT_FOUND          No transfer is queued on the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoCancelAsyncBulkTransfer (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint
+  );
+
 /**
   Execute a synchronous interrupt transfer.
 
@@ -749,9 +802,10 @@ UsbBusControllerDriverStop (
   IN EFI_HANDLE                   *ChildHandleBuffer
   );
 
-extern EFI_USB_IO_PROTOCOL           mUsbIoProtocol;
-extern EFI_DRIVER_BINDING_PROTOCOL   mUsbBusDriverBinding;
-extern EFI_COMPONENT_NAME_PROTOCOL   mUsbBusComponentName;
-extern EFI_COMPONENT_NAME2_PROTOCOL  mUsbBusComponentName2;
+extern EFI_USB_IO_PROTOCOL               mUsbIoProtocol;
+extern EDKII_USB_IO_ASYNC_BULK_PROTOCOL  mUsbIoAsyncBulkProtocol;
+extern EFI_DRIVER_BINDING_PROTOCOL       mUsbBusDriverBinding;
+extern EFI_COMPONENT_NAME_PROTOCOL       mUsbBusComponentName;
+extern EFI_COMPONENT_NAME2_PROTOCOL      mUsbBusComponentName2;
 
 #endif
@@ -67,6 +67,14 @@ UsbFreeInterface (
                   NULL
                   );
   if (!EFI_ERROR (Status)) {
+    if (UsbIf->AsyncBulk.AsyncBulkTransfer != NULL) {
+      gBS->UninstallProtocolInterface (
+             UsbIf->Handle,
+             &gEdkiiUsbIoAsyncBulkProtocolGuid,
+             &UsbIf->AsyncBulk
+             );
+    }
+
     if (UsbIf->DevicePath != NULL) {
       FreePool (UsbIf->DevicePath);
     }
@@ -173,6 +181,29 @@ UsbCreateInterface (
     goto ON_ERROR;
   }
 
+  //
+  // The asynchronous bulk transfers are optional, the drivers of the
+  // interface are connected later on.
+  //
+  if (Device->Bus->AsyncBulk != NULL) {
+    CopyMem (
+      &(UsbIf->AsyncBulk),
+      &mUsbIoAsyncBulkProtocol,
+      sizeof (EDKII_USB_IO_ASYNC_BULK_PROTOCOL)
+      );
+
+    Status = gBS->InstallProtocolInterface (
+                    &UsbIf->Handle,
+                    &gEdkiiUsbIoAsyncBulkProtocolGuid,
+                    EFI_NATIVE_INTERFACE,
+                    &UsbIf->AsyncBulk
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "UsbCreateInterface: failed to install async bulk - %r\n", Status));
+      ZeroMem (&UsbIf->AsyncBulk, sizeof (EDKII_USB_IO_ASYNC_BULK_PROTOCOL));
+    }
+  }
+
   return UsbIf;
 
 ON_ERROR:
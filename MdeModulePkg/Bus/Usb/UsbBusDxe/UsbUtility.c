@@ -259,6 +259,85 @@ UsbHcBulkTransfer (
   return Status;
 }
 
+/**
+  Queue an asynchronous bulk transfer to the device's endpoint.
+
+  @param  UsbBus           The USB bus driver.
+  @param  DevAddr          The target device address.
+  @param  EpAddr           The target endpoint address, with direction encoded in
+                           bit 7.
+  @param  DevSpeed         The device's speed.
+  @param  MaxPacket        The endpoint's max packet size.
+  @param  Data             The data buffer.
+  @param  DataLength       The length of data buffer.
+  @param  TimeOut          The time to wait until timeout.
+  @param  Callback         Function to call when the transfer is finished.
+  @param  Context          Context passed to Callback.
+
+  @retval EFI_SUCCESS      The transfer is queued.
+  @retval EFI_UNSUPPORTED  The host controller doesn't support it.
+  @retval Others           Failed to queue the transfer.
+
+**/
+EFI_STATUS
+UsbHcAsyncBulkTransfer (
+  IN  USB_BUS                          *UsbBus,
+  IN  UINT8                            DevAddr,
+  IN  UINT8                            EpAddr,
+  IN  UINT8                            DevSpeed,
+  IN  UINTN                            MaxPacket,
+  IN  VOID                             *Data,
+  IN  UINTN                            DataLength,
+  IN  UINTN                            TimeOut,
+  IN  EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN  VOID                             *Context
+  )
+{
+  if (UsbBus->AsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return UsbBus->AsyncBulk->AsyncBulkTransfer (
+                              UsbBus->AsyncBulk,
+                              DevAddr,
+                              EpAddr,
+                              DevSpeed,
+                              MaxPacket,
+                              Data,
+                              DataLength,
+                              TimeOut,
+                              Callback,
+                              Context
+                              );
+}
+
+/**
+  Cancel the asynchronous bulk transfers queued on the device's endpoint.
+
+  @param  UsbBus           The USB bus driver.
+  @param  DevAddr          The target device address.
+  @param  EpAddr           The target endpoint address, with direction encoded in
+                           bit 7.
+
+  @retval EFI_SUCCESS      The transfers are cancelled.
+  @retval EFI_UNSUPPORTED  The host controller doesn't support it.
+  @retval EFI_NOT_FOUND    No transfer is queued on the endpoint.
+
+**/
+EFI_STATUS
+UsbHcCancelAsyncBulkTransfer (
+  IN  USB_BUS  *UsbBus,
+  IN  UINT8    DevAddr,
+  IN  UINT8    EpAddr
+  )
+{
+  if (UsbBus->AsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return UsbBus->AsyncBulk->CancelAsyncBulkTransfer (UsbBus->AsyncBulk, DevAddr, EpAddr);
+}
+
 /**
   Queue or cancel an asynchronous interrupt transfer.
 
@@ -13,7 +13,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 #include <IndustryStandard/Scsi.h>
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/UsbIo.h>
+#include <Protocol/UsbIoAsyncBulk.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/DiskInfo.h>
 #include <Library/BaseLib.h>
@@ -28,6 +30,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct _USB_MASS_TRANSPORT  USB_MASS_TRANSPORT;
 typedef struct _USB_MASS_DEVICE     USB_MASS_DEVICE;
 
+/**
+  Report the end of a command executed asynchronously by the transport
+  protocol. It is called at TPL_NOTIFY.
+
+  @param  Context               The context passed when the command was started.
+  @param  Status                EFI_SUCCESS if the command passed, EFI_ABORTED if
+                                it was cancelled by a reset, or another error.
+
+**/
+typedef
+VOID
+(*USB_MASS_COMMAND_CALLBACK) (
+  IN  VOID        *Context,
+  IN  EFI_STATUS  Status
+  );
+
 #include "UsbMassBot.h"
 #include "UsbMassCbi.h"
 #include "UsbMassBoot.h"
@@ -99,6 +117,47 @@ EFI_STATUS
   OUT UINT32                  *CmdStatus
   );
 
+/**
+  Start a USB mass storage command through the transport protocol, without
+  waiting for it to complete.
+
+  The command, data and status phases are all queued at once. Callback is
+  invoked when the status of the command is known. The sense data of a
+  failed command is not requested.
+
+  @param  Context               The USB Transport Protocol.
+  @param  AsyncBulk             The asynchronous bulk transfers of the interface.
+  @param  Cmd                   The command to transfer to device
+  @param  CmdLen                The length of the command
+  @param  DataDir               The direction of data transfer
+  @param  Data                  The buffer to hold the data
+  @param  DataLen               The length of the buffer
+  @param  Lun                   Should be 0, this field for bot only
+  @param  Timeout               The time to wait
+  @param  Callback              The function to call when the command is finished.
+  @param  CallbackContext       The context passed to Callback.
+
+  @retval EFI_SUCCESS           The command is started.
+  @retval EFI_NOT_READY         Another command is in flight.
+  @retval Other                 Failed to start the command.
+
+**/
+typedef
+EFI_STATUS
+(*USB_MASS_EXEC_COMMAND_ASYNC) (
+  IN  VOID                              *Context,
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk,
+  IN  VOID                              *Cmd,
+  IN  UINT8                             CmdLen,
+  IN  EFI_USB_DATA_DIRECTION            DataDir,
+  IN  VOID                              *Data,
+  IN  UINT32                            DataLen,
+  IN  UINT8                             Lun,
+  IN  UINT32                            Timeout,
+  IN  USB_MASS_COMMAND_CALLBACK         Callback,
+  IN  VOID                              *CallbackContext
+  );
+
 /**
   Reset the USB mass storage device by Transport protocol.
 
@@ -158,29 +217,41 @@ EFI_STATUS
 /// it is no longer necessary.
 ///
 struct _USB_MASS_TRANSPORT {
-  UINT8                      Protocol;
-  USB_MASS_INIT_TRANSPORT    Init;        ///< Initialize the mass storage transport protocol
-  USB_MASS_EXEC_COMMAND      ExecCommand; ///< Transport command to the device then get result
-  USB_MASS_RESET             Reset;       ///< Reset the device
-  USB_MASS_GET_MAX_LUN       GetMaxLun;   ///< Get max lun, only for bot
-  USB_MASS_CLEAN_UP          CleanUp;     ///< Clean up the resources.
+  UINT8                          Protocol;
+  USB_MASS_INIT_TRANSPORT        Init;             ///< Initialize the mass storage transport protocol
+  USB_MASS_EXEC_COMMAND          ExecCommand;      ///< Transport command to the device then get result
+  USB_MASS_RESET                 Reset;            ///< Reset the device, cancelling the command in flight
+  USB_MASS_GET_MAX_LUN           GetMaxLun;        ///< Get max lun, only for bot
+  USB_MASS_CLEAN_UP              CleanUp;          ///< Clean up the resources.
+  USB_MASS_EXEC_COMMAND_ASYNC    ExecCommandAsync; ///< Start a command without waiting for it, only for bot
 };
 
 struct _USB_MASS_DEVICE {
-  UINT32                      Signature;
-  EFI_HANDLE                  Controller;
-  EFI_USB_IO_PROTOCOL         *UsbIo;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  EFI_BLOCK_IO_PROTOCOL       BlockIo;
-  EFI_BLOCK_IO_MEDIA          BlockIoMedia;
-  BOOLEAN                     OpticalStorage;
-  UINT8                       Lun;        ///< Logical Unit Number
-  UINT8                       Pdt;        ///< Peripheral Device Type
-  USB_MASS_TRANSPORT          *Transport; ///< USB mass storage transport protocol
-  VOID                        *Context;
-  EFI_DISK_INFO_PROTOCOL      DiskInfo;
-  USB_BOOT_INQUIRY_DATA       InquiryData;
-  BOOLEAN                     Cdb16Byte;
+  UINT32                              Signature;
+  EFI_HANDLE                          Controller;
+  EFI_USB_IO_PROTOCOL                 *UsbIo;
+  EFI_DEVICE_PATH_PROTOCOL            *DevicePath;
+  EFI_BLOCK_IO_PROTOCOL               BlockIo;
+  EFI_BLOCK_IO2_PROTOCOL              BlockIo2;
+  EFI_BLOCK_IO_MEDIA                  BlockIoMedia;
+  BOOLEAN                             OpticalStorage;
+  UINT8                               Lun;               ///< Logical Unit Number
+  UINT8                               Pdt;               ///< Peripheral Device Type
+  USB_MASS_TRANSPORT                  *Transport;        ///< USB mass storage transport protocol
+  VOID                                *Context;
+  EFI_DISK_INFO_PROTOCOL              DiskInfo;
+  USB_BOOT_INQUIRY_DATA               InquiryData;
+  BOOLEAN                             Cdb16Byte;
+  LIST_ENTRY                          AsyncQueue;        ///< Pending Block I/O 2 requests
+  EFI_EVENT                           AsyncEvent;        ///< Processes the pending Block I/O 2 requests
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    *AsyncBulk;        ///< NULL if the host controller has none
+  BOOLEAN                             AsyncBusy;         ///< A command of the oldest request is in flight
+  BOOLEAN                             AsyncDone;         ///< That command has finished with AsyncStatus
+  EFI_STATUS                          AsyncStatus;
+  UINT8                               *ReadAheadBuffer;
+  EFI_LBA                             ReadAheadLba;      ///< First block held in ReadAheadBuffer
+  UINTN                               ReadAheadBlocks;   ///< Number of valid blocks in ReadAheadBuffer
+  EFI_LBA                             NextSequentialLba; ///< Block following the last read request
 };
 
 #endif
@@ -768,6 +768,17 @@ UsbBootDetectMedia (
            &UsbMass->BlockIo,
            &UsbMass->BlockIo
            );
+    gBS->ReinstallProtocolInterface (
+           UsbMass->Controller,
+           &gEfiBlockIo2ProtocolGuid,
+           &UsbMass->BlockIo2,
+           &UsbMass->BlockIo2
+           );
+
+    //
+    // The read-ahead data belongs to the previous media.
+    //
+    UsbMass->ReadAheadBlocks = 0;
 
     //
     // Reset MediaId after reinstalling Block I/O Protocol.
@@ -963,6 +974,91 @@ UsbBootReadWriteBlocks16 (
   return Status;
 }
 
+/**
+  Start to read or write some blocks from the device, without waiting for
+  the command to complete.
+
+  The blocks are transferred by one READ or WRITE command, by the 16 byte
+  cmd if the device requires it. The sense data is not requested when the
+  command fails, the caller retries it by UsbBootReadWriteBlocks() or
+  UsbBootReadWriteBlocks16() instead.
+
+  @param  UsbMass                The USB mass storage device to access
+  @param  Write                  TRUE for write operation.
+  @param  Lba                    The start block number
+  @param  BlockCount             The block number to read or write
+  @param  Buffer                 The buffer to read to or write from
+  @param  Callback               The function to call when the command is finished.
+  @param  Context                The context passed to Callback.
+
+  @retval EFI_SUCCESS            The command is started.
+  @retval EFI_UNSUPPORTED        The transport or the host controller can't
+                                 execute the command asynchronously.
+  @retval Others                 Failed to start the command.
+
+**/
+EFI_STATUS
+UsbBootReadWriteBlocksAsync (
+  IN  USB_MASS_DEVICE            *UsbMass,
+  IN  BOOLEAN                    Write,
+  IN  EFI_LBA                    Lba,
+  IN  UINT32                     BlockCount,
+  IN OUT UINT8                   *Buffer,
+  IN  USB_MASS_COMMAND_CALLBACK  Callback,
+  IN  VOID                       *Context
+  )
+{
+  UINT8  Cmd[16];
+  UINT8  CmdLen;
+
+  if ((UsbMass->AsyncBulk == NULL) || (UsbMass->Transport->ExecCommandAsync == NULL)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ZeroMem (Cmd, sizeof (Cmd));
+
+  if (UsbMass->Cdb16Byte) {
+    CmdLen = 16;
+    Cmd[0] = Write ? EFI_SCSI_OP_WRITE16 : EFI_SCSI_OP_READ16;
+    Cmd[1] = (UINT8)((USB_BOOT_LUN (UsbMass->Lun) & 0xE0));
+    WriteUnaligned64 ((UINT64 *)&Cmd[2], SwapBytes64 (Lba));
+    WriteUnaligned32 ((UINT32 *)&Cmd[10], SwapBytes32 (BlockCount));
+  } else {
+    ASSERT ((Lba <= MAX_UINT32) && (BlockCount <= MAX_UINT16));
+
+    CmdLen = (UINT8)sizeof (USB_BOOT_READ_WRITE_10_CMD);
+    Cmd[0] = Write ? USB_BOOT_WRITE10_OPCODE : USB_BOOT_READ10_OPCODE;
+    Cmd[1] = (UINT8)(USB_BOOT_LUN (UsbMass->Lun));
+    WriteUnaligned32 ((UINT32 *)&Cmd[2], SwapBytes32 ((UINT32)Lba));
+    WriteUnaligned16 ((UINT16 *)&Cmd[7], SwapBytes16 ((UINT16)BlockCount));
+  }
+
+  DEBUG ((
+    DEBUG_BLKIO,
+    "UsbBoot%sBlocksAsync: LBA (0x%lx), Blk (0x%x)\n",
+    Write ? L"Write" : L"Read",
+    Lba,
+    BlockCount
+    ));
+
+  //
+  // USB command's upper limit timeout is 5s. [USB2.0-9.2.6.1]
+  //
+  return UsbMass->Transport->ExecCommandAsync (
+                               UsbMass->Context,
+                               UsbMass->AsyncBulk,
+                               Cmd,
+                               CmdLen,
+                               Write ? EfiUsbDataOut : EfiUsbDataIn,
+                               Buffer,
+                               BlockCount * UsbMass->BlockIoMedia.BlockSize,
+                               UsbMass->Lun,
+                               (UINT32)USB_BOOT_GENERAL_CMD_TIMEOUT,
+                               Callback,
+                               Context
+                               );
+}
+
 /**
   Use the USB clear feature control transfer to clear the endpoint stall condition.
 
@@ -318,6 +318,40 @@ UsbBootReadWriteBlocks16 (
   IN OUT UINT8         *Buffer
   );
 
+/**
+  Start to read or write some blocks from the device, without waiting for
+  the command to complete.
+
+  The blocks are transferred by one READ or WRITE command, by the 16 byte
+  cmd if the device requires it. The sense data is not requested when the
+  command fails, the caller retries it by UsbBootReadWriteBlocks() or
+  UsbBootReadWriteBlocks16() instead.
+
+  @param  UsbMass                The USB mass storage device to access
+  @param  Write                  TRUE for write operation.
+  @param  Lba                    The start block number
+  @param  BlockCount             The block number to read or write
+  @param  Buffer                 The buffer to read to or write from
+  @param  Callback               The function to call when the command is finished.
+  @param  Context                The context passed to Callback.
+
+  @retval EFI_SUCCESS            The command is started.
+  @retval EFI_UNSUPPORTED        The transport or the host controller can't
+                                 execute the command asynchronously.
+  @retval Others                 Failed to start the command.
+
+**/
+EFI_STATUS
+UsbBootReadWriteBlocksAsync (
+  IN  USB_MASS_DEVICE            *UsbMass,
+  IN  BOOLEAN                    Write,
+  IN  EFI_LBA                    Lba,
+  IN  UINT32                     BlockCount,
+  IN OUT UINT8                   *Buffer,
+  IN  USB_MASS_COMMAND_CALLBACK  Callback,
+  IN  VOID                       *Context
+  );
+
 /**
   Use the USB clear feature control transfer to clear the endpoint stall condition.
 
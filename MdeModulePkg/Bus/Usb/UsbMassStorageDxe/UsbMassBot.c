@@ -18,7 +18,8 @@ USB_MASS_TRANSPORT  mUsbBotTransport = {
   UsbBotExecCommand,
   UsbBotResetDevice,
   UsbBotGetMaxLun,
-  UsbBotCleanUp
+  UsbBotCleanUp,
+  UsbBotExecCommandAsync
 };
 
 /**
@@ -124,6 +125,188 @@ ON_ERROR:
   return Status;
 }
 
+/**
+  Cancel the transfers of the asynchronous command still queued on the
+  bulk endpoints. Their callbacks are not invoked.
+
+  @param  UsbBot                The USB BOT device.
+
+**/
+VOID
+UsbBotCancelAsyncTransfers (
+  IN USB_BOT_PROTOCOL  *UsbBot
+  )
+{
+  UsbBot->AsyncBulk->CancelAsyncBulkTransfer (UsbBot->AsyncBulk, UsbBot->BulkOutEndpoint->EndpointAddress);
+  UsbBot->AsyncBulk->CancelAsyncBulkTransfer (UsbBot->AsyncBulk, UsbBot->BulkInEndpoint->EndpointAddress);
+  UsbBot->AsyncPending = 0;
+}
+
+/**
+  Check the CSW of the asynchronous command once all its transfers are
+  finished, and report the result of the command.
+
+  A transfer error, an invalid CSW or a phase error leaves the device in
+  an unknown state, the reset recovery is done before the next command.
+  A failed command doesn't, its sense data is retrieved when the caller
+  retries it.
+
+  @param  UsbBot                The USB BOT device.
+
+**/
+VOID
+UsbBotAsyncCommandDone (
+  IN USB_BOT_PROTOCOL  *UsbBot
+  )
+{
+  USB_BOT_CSW  *Csw;
+  EFI_STATUS   Status;
+
+  Csw    = &UsbBot->AsyncCsw;
+  Status = EFI_SUCCESS;
+
+  if (UsbBot->AsyncResult != EFI_USB_NOERROR) {
+    Status = USB_IS_ERROR (UsbBot->AsyncResult, EFI_USB_ERR_TIMEOUT) ? EFI_TIMEOUT : EFI_DEVICE_ERROR;
+  } else if ((UsbBot->AsyncCswLen != sizeof (USB_BOT_CSW)) ||
+             (Csw->Signature != USB_BOT_CSW_SIGNATURE) ||
+             (Csw->Tag != UsbBot->AsyncCbw.Tag) ||
+             (Csw->CmdStatus == USB_BOT_COMMAND_ERROR))
+  {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "UsbBotAsyncCommandDone: (%r), USB result 0x%x\n", Status, UsbBot->AsyncResult));
+    UsbBot->ResetPending = TRUE;
+  } else if ((Csw->CmdStatus != USB_BOT_COMMAND_OK) ||
+             (Csw->DataResidue != 0) ||
+             (UsbBot->AsyncDataLen != UsbBot->AsyncCbw.DataLen))
+  {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  //
+  // The tag is increased even if there is an error.
+  //
+  UsbBot->CbwTag++;
+
+  UsbBot->AsyncCallback (UsbBot->AsyncContext, Status);
+}
+
+/**
+  Account for a finished transfer of the asynchronous command.
+
+  When a transfer fails, the device won't run the phases queued behind
+  it, so their transfers are cancelled and the command ends.
+
+  @param  Data                  The data buffer of the transfer.
+  @param  DataLength            The number of bytes transferred.
+  @param  Context               The USB BOT device.
+  @param  Result                The USB result of the transfer.
+
+  @retval EFI_SUCCESS           The transfer is accounted for.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbBotAsyncTransferDone (
+  IN VOID    *Data,
+  IN UINTN   DataLength,
+  IN VOID    *Context,
+  IN UINT32  Result
+  )
+{
+  USB_BOT_PROTOCOL  *UsbBot;
+
+  UsbBot = (USB_BOT_PROTOCOL *)Context;
+
+  //
+  // The transfers that were already finished when the command ended
+  // are still reported, ignore them.
+  //
+  if (UsbBot->AsyncPending == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (Data == &UsbBot->AsyncCsw) {
+    UsbBot->AsyncCswLen = DataLength;
+  } else if (Data != &UsbBot->AsyncCbw) {
+    UsbBot->AsyncDataLen = DataLength;
+  }
+
+  UsbBot->AsyncResult |= Result;
+  UsbBot->AsyncPending--;
+
+  if ((Result != EFI_USB_NOERROR) && (UsbBot->AsyncPending != 0)) {
+    UsbBotCancelAsyncTransfers (UsbBot);
+  }
+
+  if (UsbBot->AsyncPending == 0) {
+    UsbBotAsyncCommandDone (UsbBot);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Cancel the asynchronous command in flight, if any. Its callback is
+  invoked with EFI_ABORTED.
+
+  @param  UsbBot                The USB BOT device.
+
+**/
+VOID
+UsbBotCancelAsyncCommand (
+  IN USB_BOT_PROTOCOL  *UsbBot
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (UsbBot->AsyncPending != 0) {
+    UsbBotCancelAsyncTransfers (UsbBot);
+    UsbBot->ResetPending = TRUE;
+    UsbBot->CbwTag++;
+    UsbBot->AsyncCallback (UsbBot->AsyncContext, EFI_ABORTED);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Wait for the asynchronous command in flight, if any, then do the reset
+  recovery if the device requires it, before a command is sent.
+
+  The transfers complete in the poll timer of the host controller, which
+  runs at TPL_NOTIFY, above the TPL_CALLBACK of the caller.
+
+  @param  UsbBot                The USB BOT device.
+
+  @retval EFI_SUCCESS           The device is ready for a command.
+  @retval Others                The reset recovery failed.
+
+**/
+EFI_STATUS
+UsbBotWaitAsyncCommand (
+  IN USB_BOT_PROTOCOL  *UsbBot
+  )
+{
+  UINT32  Elapsed;
+
+  for (Elapsed = 0; (UsbBot->AsyncPending != 0) && (Elapsed < UsbBot->AsyncTimeout); Elapsed++) {
+    gBS->Stall (USB_MASS_1_MILLISECOND);
+  }
+
+  UsbBotCancelAsyncCommand (UsbBot);
+
+  if (UsbBot->ResetPending) {
+    return UsbBotResetDevice (UsbBot, FALSE);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Send the command to the device using Bulk-Out endpoint.
 
@@ -410,6 +593,14 @@ UsbBotExecCommand (
   *CmdStatus = USB_MASS_CMD_FAIL;
   UsbBot     = (USB_BOT_PROTOCOL *)Context;
 
+  //
+  // The device executes one command at a time.
+  //
+  Status = UsbBotWaitAsyncCommand (UsbBot);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Send the command to the device. Return immediately if device
   // rejects the command.
@@ -444,6 +635,163 @@ UsbBotExecCommand (
   return EFI_SUCCESS;
 }
 
+/**
+  Start a command through the USB Mass Storage Class BOT protocol,
+  without waiting for it to complete.
+
+  The CBW, the data and the CSW transfers are queued at once, the bulk
+  endpoints execute them in order.
+
+  @param  Context               The context of the BOT protocol, that is,
+                                USB_BOT_PROTOCOL
+  @param  AsyncBulk             The asynchronous bulk transfers of the interface.
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  Callback              The function to call when the command is finished.
+  @param  CallbackContext       The context passed to Callback.
+
+  @retval EFI_SUCCESS           The command is started.
+  @retval EFI_NOT_READY         Another command is in flight.
+  @retval Other                 Failed to start the command.
+
+**/
+EFI_STATUS
+UsbBotExecCommandAsync (
+  IN  VOID                              *Context,
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk,
+  IN  VOID                              *Cmd,
+  IN  UINT8                             CmdLen,
+  IN  EFI_USB_DATA_DIRECTION            DataDir,
+  IN  VOID                              *Data,
+  IN  UINT32                            DataLen,
+  IN  UINT8                             Lun,
+  IN  UINT32                            Timeout,
+  IN  USB_MASS_COMMAND_CALLBACK         Callback,
+  IN  VOID                              *CallbackContext
+  )
+{
+  USB_BOT_PROTOCOL  *UsbBot;
+  USB_BOT_CBW       *Cbw;
+  EFI_STATUS        Status;
+  EFI_TPL           OldTpl;
+  UINT8             DataEndpoint;
+  UINTN             CbwTimeout;
+  UINTN             DataTimeout;
+  UINTN             CswTimeout;
+
+  ASSERT ((CmdLen > 0) && (CmdLen <= USB_BOT_MAX_CMDLEN));
+
+  UsbBot = (USB_BOT_PROTOCOL *)Context;
+
+  if (UsbBot->AsyncPending != 0) {
+    return EFI_NOT_READY;
+  }
+
+  if (UsbBot->ResetPending) {
+    Status = UsbBotResetDevice (UsbBot, FALSE);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  //
+  // Fill in the Command Block Wrapper.
+  //
+  Cbw            = &UsbBot->AsyncCbw;
+  Cbw->Signature = USB_BOT_CBW_SIGNATURE;
+  Cbw->Tag       = UsbBot->CbwTag;
+  Cbw->DataLen   = (DataDir == EfiUsbNoData) ? 0 : DataLen;
+  Cbw->Flag      = (UINT8)((DataDir == EfiUsbDataIn) ? BIT7 : 0);
+  Cbw->Lun       = Lun;
+  Cbw->CmdLen    = CmdLen;
+
+  ZeroMem (Cbw->CmdBlock, USB_BOT_MAX_CMDLEN);
+  CopyMem (Cbw->CmdBlock, Cmd, CmdLen);
+  ZeroMem (&UsbBot->AsyncCsw, sizeof (USB_BOT_CSW));
+
+  DataEndpoint = (DataDir == EfiUsbDataIn) ? UsbBot->BulkInEndpoint->EndpointAddress
+                                           : UsbBot->BulkOutEndpoint->EndpointAddress;
+
+  //
+  // The timeout of a transfer runs from the time it is queued, so the
+  // later phases get the time of the earlier ones on top of their own.
+  //
+  CbwTimeout  = USB_BOT_SEND_CBW_TIMEOUT / USB_MASS_1_MILLISECOND;
+  DataTimeout = CbwTimeout + Timeout / USB_MASS_1_MILLISECOND;
+  CswTimeout  = DataTimeout + USB_BOT_RECV_CSW_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  UsbBot->AsyncBulk     = AsyncBulk;
+  UsbBot->AsyncCswLen   = 0;
+  UsbBot->AsyncDataLen  = 0;
+  UsbBot->AsyncResult   = EFI_USB_NOERROR;
+  UsbBot->AsyncTimeout  = (UINT32)CswTimeout;
+  UsbBot->AsyncCallback = Callback;
+  UsbBot->AsyncContext  = CallbackContext;
+  UsbBot->AsyncPending  = (Cbw->DataLen == 0) ? 2 : 3;
+
+  //
+  // Queue all the transfers before any of them can complete.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Status = AsyncBulk->AsyncBulkTransfer (
+                        AsyncBulk,
+                        UsbBot->BulkOutEndpoint->EndpointAddress,
+                        Cbw,
+                        sizeof (USB_BOT_CBW),
+                        CbwTimeout,
+                        UsbBotAsyncTransferDone,
+                        UsbBot
+                        );
+  if (EFI_ERROR (Status)) {
+    UsbBot->AsyncPending = 0;
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+  }
+
+  if (Cbw->DataLen != 0) {
+    Status = AsyncBulk->AsyncBulkTransfer (
+                          AsyncBulk,
+                          DataEndpoint,
+                          Data,
+                          DataLen,
+                          DataTimeout,
+                          UsbBotAsyncTransferDone,
+                          UsbBot
+                          );
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = AsyncBulk->AsyncBulkTransfer (
+                          AsyncBulk,
+                          UsbBot->BulkInEndpoint->EndpointAddress,
+                          &UsbBot->AsyncCsw,
+                          sizeof (USB_BOT_CSW),
+                          CswTimeout,
+                          UsbBotAsyncTransferDone,
+                          UsbBot
+                          );
+  }
+
+  //
+  // The device may have received the CBW already, recover it before
+  // the next command.
+  //
+  if (EFI_ERROR (Status)) {
+    UsbBotCancelAsyncTransfers (UsbBot);
+    UsbBot->ResetPending = TRUE;
+    UsbBot->CbwTag++;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
 /**
   Reset the USB mass storage device by BOT protocol.
 
@@ -469,6 +817,8 @@ UsbBotResetDevice (
 
   UsbBot = (USB_BOT_PROTOCOL *)Context;
 
+  UsbBotCancelAsyncCommand (UsbBot);
+
   //
   // Issue a class specific Bulk-Only Mass Storage Reset request,
   // according to section 3.1 of USB Mass Storage Class Bulk-Only Transport Spec, v1.0.
@@ -507,6 +857,7 @@ UsbBotResetDevice (
   UsbClearEndpointStall (UsbBot->UsbIo, UsbBot->BulkInEndpoint->EndpointAddress);
   UsbClearEndpointStall (UsbBot->UsbIo, UsbBot->BulkOutEndpoint->EndpointAddress);
 
+  UsbBot->ResetPending = FALSE;
   return Status;
 }
 
@@ -588,6 +939,11 @@ UsbBotCleanUp (
   IN  VOID  *Context
   )
 {
+  //
+  // The LUNs cancel their commands before they are freed.
+  //
+  ASSERT (((USB_BOT_PROTOCOL *)Context)->AsyncPending == 0);
+
   FreePool (Context);
   return EFI_SUCCESS;
 }
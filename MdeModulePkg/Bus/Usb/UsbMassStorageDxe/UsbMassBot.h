@@ -76,11 +76,27 @@ typedef struct {
   //
   // Put Interface at the first field to make it easy to distinguish BOT/CBI Protocol instance
   //
-  EFI_USB_INTERFACE_DESCRIPTOR    Interface;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkInEndpoint;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkOutEndpoint;
-  UINT32                          CbwTag;
-  EFI_USB_IO_PROTOCOL             *UsbIo;
+  EFI_USB_INTERFACE_DESCRIPTOR        Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkInEndpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkOutEndpoint;
+  UINT32                              CbwTag;
+  EFI_USB_IO_PROTOCOL                 *UsbIo;
+
+  //
+  // The command started by UsbBotExecCommandAsync(). It is shared by all
+  // the LUNs, the device only executes one command at a time.
+  //
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    *AsyncBulk;
+  USB_BOT_CBW                         AsyncCbw;
+  USB_BOT_CSW                         AsyncCsw;
+  UINTN                               AsyncCswLen;
+  UINTN                               AsyncDataLen;
+  UINTN                               AsyncPending;  ///< Transfers of the command not finished yet
+  UINT32                              AsyncResult;   ///< USB results of the finished transfers
+  UINT32                              AsyncTimeout;  ///< In millisecond, for the whole command
+  USB_MASS_COMMAND_CALLBACK           AsyncCallback;
+  VOID                                *AsyncContext;
+  BOOLEAN                             ResetPending;  ///< Reset recovery needed before the next command
 } USB_BOT_PROTOCOL;
 
 /**
@@ -136,9 +152,52 @@ UsbBotExecCommand (
   OUT UINT32                  *CmdStatus
   );
 
+/**
+  Start a command through the USB Mass Storage Class BOT protocol,
+  without waiting for it to complete.
+
+  The CBW, the data and the CSW transfers are queued at once, the bulk
+  endpoints execute them in order.
+
+  @param  Context               The context of the BOT protocol, that is,
+                                USB_BOT_PROTOCOL
+  @param  AsyncBulk             The asynchronous bulk transfers of the interface.
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  Callback              The function to call when the command is finished.
+  @param  CallbackContext       The context passed to Callback.
+
+  @retval EFI_SUCCESS           The command is started.
+  @retval EFI_NOT_READY         Another command is in flight.
+  @retval Other                 Failed to start the command.
+
+**/
+EFI_STATUS
+UsbBotExecCommandAsync (
+  IN  VOID                              *Context,
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk,
+  IN  VOID                              *Cmd,
+  IN  UINT8                             CmdLen,
+  IN  EFI_USB_DATA_DIRECTION            DataDir,
+  IN  VOID                              *Data,
+  IN  UINT32                            DataLen,
+  IN  UINT8                             Lun,
+  IN  UINT32                            Timeout,
+  IN  USB_MASS_COMMAND_CALLBACK         Callback,
+  IN  VOID                              *CallbackContext
+  );
+
 /**
   Reset the USB mass storage device by BOT protocol.
 
+  The command started by UsbBotExecCommandAsync(), if any, is cancelled
+  first and completes with EFI_ABORTED.
+
   @param  Context               The context of the BOT protocol, that is,
                                 USB_BOT_PROTOCOL.
   @param  ExtendedVerification  If FALSE, just issue Bulk-Only Mass Storage Reset request.
@@ -1,5 +1,5 @@
 /** @file
-  USB Mass Storage Driver that manages USB Mass Storage Device and produces Block I/O Protocol.
+  USB Mass Storage Driver that manages USB Mass Storage Device and produces Block I/O and Block I/O 2 Protocols.
 
 Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -27,6 +27,150 @@ EFI_DRIVER_BINDING_PROTOCOL  gUSBMassDriverBinding = {
   NULL
 };
 
+/**
+  Read or write blocks from the device, using the 16-byte CDBs if the
+  capacity of the device requires them.
+
+  @param  UsbMass                The USB mass storage device to access.
+  @param  Write                  TRUE for write operation.
+  @param  Lba                    The start block number.
+  @param  TotalBlock             Total block number to read or write.
+  @param  Buffer                 The buffer to read to or write from.
+
+  @retval EFI_SUCCESS            Data are read into the buffer or written into the device.
+  @retval Others                 Failed to read or write all the data.
+
+**/
+EFI_STATUS
+UsbMassReadWriteDevice (
+  IN     USB_MASS_DEVICE  *UsbMass,
+  IN     BOOLEAN          Write,
+  IN     EFI_LBA          Lba,
+  IN     UINTN            TotalBlock,
+  IN OUT UINT8            *Buffer
+  )
+{
+  if (UsbMass->Cdb16Byte) {
+    return UsbBootReadWriteBlocks16 (UsbMass, Write, Lba, TotalBlock, Buffer);
+  } else {
+    return UsbBootReadWriteBlocks (UsbMass, Write, (UINT32)Lba, TotalBlock, Buffer);
+  }
+}
+
+/**
+  Read blocks from the device through the read-ahead buffer.
+
+  The blocks held in the read-ahead buffer are copied directly. When the
+  request continues the previous read and is smaller than the read-ahead
+  buffer, the whole buffer is filled by a single command so that the next
+  sequential reads need no device access.
+
+  @param  UsbMass                The USB mass storage device to read from.
+  @param  Lba                    The start block number.
+  @param  TotalBlock             Total block number to read.
+  @param  Buffer                 The buffer to read to.
+
+  @retval EFI_SUCCESS            Data are read into the buffer.
+  @retval Others                 Failed to read all the data.
+
+**/
+EFI_STATUS
+UsbMassReadWithReadAhead (
+  IN  USB_MASS_DEVICE  *UsbMass,
+  IN  EFI_LBA          Lba,
+  IN  UINTN            TotalBlock,
+  OUT UINT8            *Buffer
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+  EFI_STATUS          Status;
+  UINT32              BlockSize;
+  UINTN               Count;
+  UINTN               WindowBlocks;
+  BOOLEAN             Sequential;
+
+  Media      = &UsbMass->BlockIoMedia;
+  BlockSize  = Media->BlockSize;
+  Sequential = (BOOLEAN)(Lba == UsbMass->NextSequentialLba);
+
+  UsbMass->NextSequentialLba = Lba + TotalBlock;
+
+  //
+  // Copy the leading blocks held in the read-ahead buffer.
+  //
+  if ((UsbMass->ReadAheadBlocks != 0) &&
+      (Lba >= UsbMass->ReadAheadLba) &&
+      (Lba < UsbMass->ReadAheadLba + UsbMass->ReadAheadBlocks))
+  {
+    Count = (UINTN)MIN (TotalBlock, UsbMass->ReadAheadLba + UsbMass->ReadAheadBlocks - Lba);
+    CopyMem (
+      Buffer,
+      UsbMass->ReadAheadBuffer + (UINTN)(Lba - UsbMass->ReadAheadLba) * BlockSize,
+      Count * BlockSize
+      );
+
+    Lba        += Count;
+    Buffer     += Count * BlockSize;
+    TotalBlock -= Count;
+    Sequential  = TRUE;
+  }
+
+  if (TotalBlock == 0) {
+    return EFI_SUCCESS;
+  }
+
+  WindowBlocks = USB_MASS_READ_AHEAD_SIZE / BlockSize;
+  if (!Sequential || (TotalBlock >= WindowBlocks)) {
+    return UsbMassReadWriteDevice (UsbMass, FALSE, Lba, TotalBlock, Buffer);
+  }
+
+  if (UsbMass->ReadAheadBuffer == NULL) {
+    UsbMass->ReadAheadBuffer = AllocatePool (USB_MASS_READ_AHEAD_SIZE);
+    if (UsbMass->ReadAheadBuffer == NULL) {
+      return UsbMassReadWriteDevice (UsbMass, FALSE, Lba, TotalBlock, Buffer);
+    }
+  }
+
+  //
+  // Fill the read-ahead buffer, but do not read beyond the last block.
+  //
+  Count                    = (UINTN)MIN (WindowBlocks, Media->LastBlock - Lba + 1);
+  UsbMass->ReadAheadBlocks = 0;
+  Status                   = UsbMassReadWriteDevice (UsbMass, FALSE, Lba, Count, UsbMass->ReadAheadBuffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  UsbMass->ReadAheadLba    = Lba;
+  UsbMass->ReadAheadBlocks = Count;
+  CopyMem (Buffer, UsbMass->ReadAheadBuffer, TotalBlock * BlockSize);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Drop the read-ahead data overlapped by a write.
+
+  @param  UsbMass                The USB mass storage device written to.
+  @param  Lba                    The start block number.
+  @param  TotalBlock             Total block number to write.
+
+**/
+VOID
+UsbMassDropReadAhead (
+  IN USB_MASS_DEVICE  *UsbMass,
+  IN EFI_LBA          Lba,
+  IN UINTN            TotalBlock
+  )
+{
+  if ((UsbMass->ReadAheadBlocks != 0) &&
+      (Lba < UsbMass->ReadAheadLba + UsbMass->ReadAheadBlocks) &&
+      (Lba + TotalBlock > UsbMass->ReadAheadLba))
+  {
+    UsbMass->ReadAheadBlocks = 0;
+  }
+}
+
 /**
   Reset the block device.
 
@@ -59,8 +203,9 @@ UsbMassReset (
   //
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-  UsbMass = USB_MASS_DEVICE_FROM_BLOCK_IO (This);
-  Status  = UsbMass->Transport->Reset (UsbMass->Context, ExtendedVerification);
+  UsbMass                  = USB_MASS_DEVICE_FROM_BLOCK_IO (This);
+  UsbMass->ReadAheadBlocks = 0;
+  Status                   = UsbMass->Transport->Reset (UsbMass->Context, ExtendedVerification);
 
   gBS->RestoreTPL (OldTpl);
 
@@ -165,11 +310,7 @@ UsbMassReadBlocks (
     goto ON_EXIT;
   }
 
-  if (UsbMass->Cdb16Byte) {
-    Status = UsbBootReadWriteBlocks16 (UsbMass, FALSE, Lba, TotalBlock, Buffer);
-  } else {
-    Status = UsbBootReadWriteBlocks (UsbMass, FALSE, (UINT32)Lba, TotalBlock, Buffer);
-  }
+  Status = UsbMassReadWithReadAhead (UsbMass, Lba, TotalBlock, Buffer);
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "UsbMassReadBlocks: UsbBootReadBlocks (%r) -> Reset\n", Status));
@@ -280,15 +421,13 @@ UsbMassWriteBlocks (
     goto ON_EXIT;
   }
 
+  UsbMassDropReadAhead (UsbMass, Lba, TotalBlock);
+
   //
   // Try to write the data even the device is marked as ReadOnly,
   // and clear the status should the write succeed.
   //
-  if (UsbMass->Cdb16Byte) {
-    Status = UsbBootReadWriteBlocks16 (UsbMass, TRUE, Lba, TotalBlock, Buffer);
-  } else {
-    Status = UsbBootReadWriteBlocks (UsbMass, TRUE, (UINT32)Lba, TotalBlock, Buffer);
-  }
+  Status = UsbMassReadWriteDevice (UsbMass, TRUE, Lba, TotalBlock, Buffer);
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "UsbMassWriteBlocks: UsbBootWriteBlocks (%r) -> Reset\n", Status));
@@ -323,6 +462,661 @@ UsbMassFlushBlocks (
   return EFI_SUCCESS;
 }
 
+/**
+  Check the parameters of a Block I/O 2 read or write request, before it
+  is queued and again when it is started.
+
+  @param  UsbMass                The USB mass storage device.
+  @param  MediaId                The media ID that the request is for.
+  @param  Lba                    The starting logical block address.
+  @param  BufferSize             The size of Buffer in bytes.
+  @param  Buffer                 The data buffer.
+
+  @retval EFI_SUCCESS            The request is valid.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_MEDIA_CHANGED      The MediaId is not for the current media.
+  @retval EFI_BAD_BUFFER_SIZE    The BufferSize parameter is not a multiple of the
+                                 intrinsic block size of the device.
+  @retval EFI_INVALID_PARAMETER  The request contains LBAs that are not valid,
+                                 or the buffer is NULL.
+
+**/
+EFI_STATUS
+UsbMassCheckAsyncRequest (
+  IN USB_MASS_DEVICE  *UsbMass,
+  IN UINT32           MediaId,
+  IN EFI_LBA          Lba,
+  IN UINTN            BufferSize,
+  IN VOID             *Buffer
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+
+  Media = &UsbMass->BlockIoMedia;
+
+  if (!(Media->MediaPresent)) {
+    return EFI_NO_MEDIA;
+  }
+
+  if (MediaId != Media->MediaId) {
+    return EFI_MEDIA_CHANGED;
+  }
+
+  if (BufferSize == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (Buffer == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((BufferSize % Media->BlockSize) != 0) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  if (Lba + BufferSize / Media->BlockSize - 1 > Media->LastBlock) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Complete a Block I/O 2 request and remove it from the queue.
+
+  @param  Request                The request to complete.
+  @param  Status                 The status of the request.
+
+**/
+VOID
+UsbMassCompleteAsyncRequest (
+  IN USB_MASS_ASYNC_REQUEST  *Request,
+  IN EFI_STATUS              Status
+  )
+{
+  RemoveEntryList (&Request->Link);
+  Request->Token->TransactionStatus = Status;
+  gBS->SignalEvent (Request->Token->Event);
+  FreePool (Request);
+}
+
+/**
+  Abort all the pending Block I/O 2 requests of the device.
+
+  The command in flight, if any, is cancelled by resetting the device.
+
+  @param  UsbMass                The USB mass storage device.
+
+**/
+VOID
+UsbMassAbortAsyncRequests (
+  IN USB_MASS_DEVICE  *UsbMass
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (UsbMass->AsyncBusy) {
+    UsbMass->Transport->Reset (UsbMass->Context, FALSE);
+    UsbMass->AsyncBusy = FALSE;
+  }
+
+  while (!IsListEmpty (&UsbMass->AsyncQueue)) {
+    UsbMassCompleteAsyncRequest (
+      USB_MASS_ASYNC_REQUEST_FROM_LINK (GetFirstNode (&UsbMass->AsyncQueue)),
+      EFI_ABORTED
+      );
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Record the result of the command started for the oldest Block I/O 2
+  request, and signal the event that processes the requests.
+
+  It is called at TPL_NOTIFY, by the host controller poll timer.
+
+  @param  Context                Pointer to the USB_MASS_DEVICE.
+  @param  Status                 The result of the command.
+
+**/
+VOID
+UsbMassAsyncCommandDone (
+  IN VOID        *Context,
+  IN EFI_STATUS  Status
+  )
+{
+  USB_MASS_DEVICE  *UsbMass;
+
+  UsbMass              = (USB_MASS_DEVICE *)Context;
+  UsbMass->AsyncStatus = Status;
+  UsbMass->AsyncDone   = TRUE;
+  gBS->SignalEvent (UsbMass->AsyncEvent);
+}
+
+/**
+  Account for the blocks of the command executed for the oldest Block I/O 2
+  request, and complete the request when all its blocks are transferred or
+  the command failed.
+
+  @param  UsbMass                The USB mass storage device.
+  @param  Request                The oldest request.
+  @param  Status                 The result of the command.
+
+**/
+VOID
+UsbMassAdvanceAsyncRequest (
+  IN USB_MASS_DEVICE         *UsbMass,
+  IN USB_MASS_ASYNC_REQUEST  *Request,
+  IN EFI_STATUS              Status
+  )
+{
+  UINTN  ByteSize;
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "UsbMassAdvanceAsyncRequest: LBA (0x%lx) (%r) -> Reset\n", Request->Lba, Status));
+    UsbMassReset (&UsbMass->BlockIo, TRUE);
+    UsbMassCompleteAsyncRequest (Request, Status);
+    return;
+  }
+
+  ByteSize             = (UINTN)Request->CommandBlocks * UsbMass->BlockIoMedia.BlockSize;
+  Request->Lba        += Request->CommandBlocks;
+  Request->Buffer      = (UINT8 *)Request->Buffer + ByteSize;
+  Request->BufferSize -= ByteSize;
+
+  if (Request->BufferSize == 0) {
+    UsbMassCompleteAsyncRequest (Request, EFI_SUCCESS);
+  }
+}
+
+/**
+  Start the next command of the oldest Block I/O 2 request.
+
+  The first time a read or write request is started, the media is checked
+  and the read-ahead buffer is looked up. Then the request is split into
+  commands, each started without waiting for it when the transport and the
+  host controller support it. Otherwise, e.g. when another LUN of the
+  device has a command in flight, the command is executed synchronously.
+
+  @param  UsbMass                The USB mass storage device.
+
+  @retval TRUE                   A command is in flight.
+  @retval FALSE                  The request was executed or completed
+                                 synchronously.
+
+**/
+BOOLEAN
+UsbMassStartAsyncRequest (
+  IN USB_MASS_DEVICE  *UsbMass
+  )
+{
+  USB_MASS_ASYNC_REQUEST  *Request;
+  EFI_BLOCK_IO_MEDIA      *Media;
+  EFI_STATUS              Status;
+  BOOLEAN                 Write;
+  UINTN                   TotalBlock;
+  UINTN                   Count;
+
+  Request = USB_MASS_ASYNC_REQUEST_FROM_LINK (GetFirstNode (&UsbMass->AsyncQueue));
+  Media   = &UsbMass->BlockIoMedia;
+  Write   = (BOOLEAN)(Request->Operation == UsbMassAsyncWrite);
+
+  //
+  // USB mass storage device doesn't support write cache, the previous
+  // requests have completed already.
+  //
+  if (Request->Operation == UsbMassAsyncFlush) {
+    UsbMassCompleteAsyncRequest (Request, EFI_SUCCESS);
+    return FALSE;
+  }
+
+  if (!Request->Started) {
+    Request->Started = TRUE;
+
+    if (Media->RemovableMedia) {
+      Status = UsbBootDetectMedia (UsbMass);
+      if (EFI_ERROR (Status)) {
+        UsbMassCompleteAsyncRequest (Request, Status);
+        return FALSE;
+      }
+    }
+
+    Status = UsbMassCheckAsyncRequest (UsbMass, Request->MediaId, Request->Lba, Request->BufferSize, Request->Buffer);
+    if (EFI_ERROR (Status)) {
+      UsbMassCompleteAsyncRequest (Request, Status);
+      return FALSE;
+    }
+
+    TotalBlock = Request->BufferSize / Media->BlockSize;
+    if (!Write &&
+        (UsbMass->ReadAheadBlocks != 0) &&
+        (Request->Lba >= UsbMass->ReadAheadLba) &&
+        (Request->Lba + TotalBlock <= UsbMass->ReadAheadLba + UsbMass->ReadAheadBlocks))
+    {
+      CopyMem (
+        Request->Buffer,
+        UsbMass->ReadAheadBuffer + (UINTN)(Request->Lba - UsbMass->ReadAheadLba) * Media->BlockSize,
+        Request->BufferSize
+        );
+      UsbMassCompleteAsyncRequest (Request, EFI_SUCCESS);
+      return FALSE;
+    }
+  }
+
+  //
+  // Split the request like UsbBootReadWriteBlocks() does, the READ10 and
+  // WRITE10 commands only have 16 bit transfer length.
+  //
+  Count = MIN (Request->BufferSize / Media->BlockSize, USB_BOOT_MAX_CARRY_SIZE / Media->BlockSize);
+  if (!UsbMass->Cdb16Byte) {
+    Count = MIN (Count, MAX_UINT16);
+  }
+
+  Request->CommandBlocks = (UINT32)Count;
+
+  //
+  // The read-ahead buffer may be filled by a Block I/O read between two
+  // commands of the write, so it is checked for every command.
+  //
+  if (Write) {
+    UsbMassDropReadAhead (UsbMass, Request->Lba, Count);
+  }
+
+  //
+  // The command may complete before UsbBootReadWriteBlocksAsync() returns.
+  //
+  UsbMass->AsyncBusy = TRUE;
+  UsbMass->AsyncDone = FALSE;
+  Status             = UsbBootReadWriteBlocksAsync (
+                         UsbMass,
+                         Write,
+                         Request->Lba,
+                         Request->CommandBlocks,
+                         Request->Buffer,
+                         UsbMassAsyncCommandDone,
+                         UsbMass
+                         );
+  if (!EFI_ERROR (Status)) {
+    return TRUE;
+  }
+
+  UsbMass->AsyncBusy = FALSE;
+
+  Status = UsbMassReadWriteDevice (UsbMass, Write, Request->Lba, Request->CommandBlocks, Request->Buffer);
+  UsbMassAdvanceAsyncRequest (UsbMass, Request, Status);
+  return FALSE;
+}
+
+/**
+  Execute the pending Block I/O 2 requests of the device.
+
+  The requests are executed in the order they were queued. The command of
+  a request is started without waiting for it, and the event is signaled
+  again when it completes. The failed command is executed again
+  synchronously, which requests the sense data and retries it as a Block
+  I/O read or write does.
+
+  When the device can't execute the commands asynchronously, one command
+  is executed per call. The event is signaled again while requests are
+  pending, so that the other events get a chance to run between two
+  commands.
+
+  @param  Event                  The event this notify function registered to.
+  @param  Context                Pointer to the USB_MASS_DEVICE.
+
+**/
+VOID
+EFIAPI
+UsbMassProcessAsyncRequests (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  USB_MASS_DEVICE         *UsbMass;
+  USB_MASS_ASYNC_REQUEST  *Request;
+  EFI_STATUS              Status;
+  EFI_TPL                 OldTpl;
+  BOOLEAN                 Done;
+
+  UsbMass = (USB_MASS_DEVICE *)Context;
+
+  if (UsbMass->AsyncBusy) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Done   = UsbMass->AsyncDone;
+    Status = UsbMass->AsyncStatus;
+    gBS->RestoreTPL (OldTpl);
+
+    if (!Done) {
+      return;
+    }
+
+    UsbMass->AsyncBusy = FALSE;
+    Request            = USB_MASS_ASYNC_REQUEST_FROM_LINK (GetFirstNode (&UsbMass->AsyncQueue));
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_BLKIO, "UsbMassProcessAsyncRequests: LBA (0x%lx) (%r) -> Retry\n", Request->Lba, Status));
+      Status = UsbMassReadWriteDevice (
+                 UsbMass,
+                 (BOOLEAN)(Request->Operation == UsbMassAsyncWrite),
+                 Request->Lba,
+                 Request->CommandBlocks,
+                 Request->Buffer
+                 );
+    }
+
+    UsbMassAdvanceAsyncRequest (UsbMass, Request, Status);
+  }
+
+  if (IsListEmpty (&UsbMass->AsyncQueue)) {
+    return;
+  }
+
+  if (!UsbMassStartAsyncRequest (UsbMass) && !IsListEmpty (&UsbMass->AsyncQueue)) {
+    gBS->SignalEvent (UsbMass->AsyncEvent);
+  }
+}
+
+/**
+  Queue a Block I/O 2 request to the device.
+
+  @param  UsbMass                The USB mass storage device.
+  @param  Operation              The operation of the request.
+  @param  MediaId                The media ID that the request is for.
+  @param  Lba                    The starting logical block address.
+  @param  Token                  A pointer to the token associated with the transaction.
+  @param  BufferSize             The size of Buffer in bytes.
+  @param  Buffer                 The data buffer.
+
+  @retval EFI_SUCCESS            The request is queued.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the request.
+
+**/
+EFI_STATUS
+UsbMassQueueAsyncRequest (
+  IN USB_MASS_DEVICE           *UsbMass,
+  IN USB_MASS_ASYNC_OPERATION  Operation,
+  IN UINT32                    MediaId,
+  IN EFI_LBA                   Lba,
+  IN EFI_BLOCK_IO2_TOKEN       *Token,
+  IN UINTN                     BufferSize,
+  IN VOID                      *Buffer
+  )
+{
+  USB_MASS_ASYNC_REQUEST  *Request;
+  EFI_STATUS              Status;
+  EFI_TPL                 OldTpl;
+
+  if (UsbMass->AsyncEvent == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    UsbMassProcessAsyncRequests,
+                    UsbMass,
+                    &UsbMass->AsyncEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      UsbMass->AsyncEvent = NULL;
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Request = AllocateZeroPool (sizeof (USB_MASS_ASYNC_REQUEST));
+  if (Request == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Request->Signature  = USB_MASS_ASYNC_REQUEST_SIGNATURE;
+  Request->Operation  = Operation;
+  Request->MediaId    = MediaId;
+  Request->Lba        = Lba;
+  Request->BufferSize = BufferSize;
+  Request->Buffer     = Buffer;
+  Request->Token      = Token;
+
+  Token->TransactionStatus = EFI_SUCCESS;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  InsertTailList (&UsbMass->AsyncQueue, &Request->Link);
+  gBS->SignalEvent (UsbMass->AsyncEvent);
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Reset the block device hardware.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.Reset(). All the pending
+  asynchronous requests are aborted.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  ExtendedVerification   Indicates that the driver may perform a more exhaustive
+                                 verification operation of the device during reset.
+
+  @retval EFI_SUCCESS            The device was reset.
+  @retval EFI_DEVICE_ERROR       The device is not functioning properly and could
+                                 not be reset.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
+  USB_MASS_DEVICE  *UsbMass;
+
+  UsbMass = USB_MASS_DEVICE_FROM_BLOCK_IO2 (This);
+
+  UsbMassAbortAsyncRequests (UsbMass);
+
+  return UsbMassReset (&UsbMass->BlockIo, ExtendedVerification);
+}
+
+/**
+  Read BufferSize bytes from Lba into Buffer.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx(). If Token is
+  NULL or Token->Event is NULL, the read is performed synchronously. Otherwise
+  the request is queued, EFI_SUCCESS is returned, and Token->Event is signaled
+  when the read completes.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  MediaId                Id of the media, changes every time the media is replaced.
+  @param  Lba                    The starting Logical Block Address to read from.
+  @param  Token                  A pointer to the token associated with the transaction.
+  @param  BufferSize             Size of Buffer, must be a multiple of device block size.
+  @param  Buffer                 A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS            The read request was queued if Event is not NULL,
+                                 or the data was read correctly from the device.
+  @retval EFI_DEVICE_ERROR       The device reported an error while performing the read.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_MEDIA_CHANGED      The MediaId is not for the current media.
+  @retval EFI_BAD_BUFFER_SIZE    The BufferSize parameter is not a multiple of the
+                                 intrinsic block size of the device.
+  @retval EFI_INVALID_PARAMETER  The read request contains LBAs that are not valid,
+                                 or the buffer is not on proper alignment.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be completed due to a lack
+                                 of resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  )
+{
+  USB_MASS_DEVICE  *UsbMass;
+  EFI_STATUS       Status;
+
+  UsbMass = USB_MASS_DEVICE_FROM_BLOCK_IO2 (This);
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    Status = UsbMassReadBlocks (&UsbMass->BlockIo, MediaId, Lba, BufferSize, Buffer);
+    if (Token != NULL) {
+      Token->TransactionStatus = Status;
+    }
+
+    return Status;
+  }
+
+  Status = UsbMassCheckAsyncRequest (UsbMass, MediaId, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (BufferSize == 0) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  return UsbMassQueueAsyncRequest (UsbMass, UsbMassAsyncRead, MediaId, Lba, Token, BufferSize, Buffer);
+}
+
+/**
+  Write BufferSize bytes from Buffer to Lba.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx(). If Token is
+  NULL or Token->Event is NULL, the write is performed synchronously. Otherwise
+  the request is queued, EFI_SUCCESS is returned, and Token->Event is signaled
+  when the write completes.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  MediaId                The media ID that the write request is for.
+  @param  Lba                    The starting logical block address to be written.
+  @param  Token                  A pointer to the token associated with the transaction.
+  @param  BufferSize             Size of Buffer, must be a multiple of device block size.
+  @param  Buffer                 A pointer to the source buffer for the data.
+
+  @retval EFI_SUCCESS            The write request was queued if Event is not NULL,
+                                 or the data was written correctly to the device.
+  @retval EFI_WRITE_PROTECTED    The device cannot be written to.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_MEDIA_CHANGED      The MediaId is not for the current media.
+  @retval EFI_DEVICE_ERROR       The device reported an error while performing the write.
+  @retval EFI_BAD_BUFFER_SIZE    The BufferSize parameter is not a multiple of the
+                                 intrinsic block size of the device.
+  @retval EFI_INVALID_PARAMETER  The write request contains LBAs that are not valid,
+                                 or the buffer is not on proper alignment.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be completed due to a lack
+                                 of resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  )
+{
+  USB_MASS_DEVICE  *UsbMass;
+  EFI_STATUS       Status;
+
+  UsbMass = USB_MASS_DEVICE_FROM_BLOCK_IO2 (This);
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    Status = UsbMassWriteBlocks (&UsbMass->BlockIo, MediaId, Lba, BufferSize, Buffer);
+    if (Token != NULL) {
+      Token->TransactionStatus = Status;
+    }
+
+    return Status;
+  }
+
+  Status = UsbMassCheckAsyncRequest (UsbMass, MediaId, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (BufferSize == 0) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  return UsbMassQueueAsyncRequest (UsbMass, UsbMassAsyncWrite, MediaId, Lba, Token, BufferSize, Buffer);
+}
+
+/**
+  Flush the block device.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx(). The flush
+  completes after all the previously queued requests have completed.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  Token                  A pointer to the token associated with the transaction.
+
+  @retval EFI_SUCCESS            The flush request was queued if Event is not NULL,
+                                 or all outstanding data was written to the device.
+  @retval EFI_DEVICE_ERROR       The device reported an error while writing back the data.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be completed due to a lack
+                                 of resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  )
+{
+  USB_MASS_DEVICE  *UsbMass;
+  EFI_STATUS       Status;
+
+  UsbMass = USB_MASS_DEVICE_FROM_BLOCK_IO2 (This);
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    Status = UsbMassFlushBlocks (&UsbMass->BlockIo);
+    if (Token != NULL) {
+      Token->TransactionStatus = Status;
+    }
+
+    return Status;
+  }
+
+  return UsbMassQueueAsyncRequest (UsbMass, UsbMassAsyncFlush, 0, 0, Token, 0, NULL);
+}
+
+/**
+  Release the resources of a USB mass storage device.
+
+  @param  UsbMass                The USB mass storage device.
+
+**/
+VOID
+UsbMassFreeDevice (
+  IN USB_MASS_DEVICE  *UsbMass
+  )
+{
+  UsbMassAbortAsyncRequests (UsbMass);
+
+  if (UsbMass->AsyncEvent != NULL) {
+    gBS->CloseEvent (UsbMass->AsyncEvent);
+  }
+
+  if (UsbMass->ReadAheadBuffer != NULL) {
+    FreePool (UsbMass->ReadAheadBuffer);
+  }
+
+  FreePool (UsbMass);
+}
+
 /**
   Initialize the media parameter data for EFI_BLOCK_IO_MEDIA of Block I/O Protocol.
 
@@ -455,6 +1249,42 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Look up the asynchronous bulk transfers of the USB interface, which let
+  the Block I/O 2 requests run without blocking, if the transport can use
+  them.
+
+  @param  This                 The Driver Binding Protocol instance.
+  @param  Controller           The USB interface of the device.
+  @param  UsbMass              The USB mass storage device.
+
+**/
+VOID
+UsbMassInitAsyncBulk (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   Controller,
+  IN USB_MASS_DEVICE              *UsbMass
+  )
+{
+  EFI_STATUS  Status;
+
+  if (UsbMass->Transport->ExecCommandAsync == NULL) {
+    return;
+  }
+
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEdkiiUsbIoAsyncBulkProtocolGuid,
+                  (VOID **)&UsbMass->AsyncBulk,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    UsbMass->AsyncBulk = NULL;
+  }
+}
+
 /**
   Initialize data for device that supports multiple LUNSs.
 
@@ -496,17 +1326,24 @@ UsbMassInitMultiLun (
     UsbMass = AllocateZeroPool (sizeof (USB_MASS_DEVICE));
     ASSERT (UsbMass != NULL);
 
-    UsbMass->Signature           = USB_MASS_SIGNATURE;
-    UsbMass->UsbIo               = UsbIo;
-    UsbMass->BlockIo.Media       = &UsbMass->BlockIoMedia;
-    UsbMass->BlockIo.Reset       = UsbMassReset;
-    UsbMass->BlockIo.ReadBlocks  = UsbMassReadBlocks;
-    UsbMass->BlockIo.WriteBlocks = UsbMassWriteBlocks;
-    UsbMass->BlockIo.FlushBlocks = UsbMassFlushBlocks;
-    UsbMass->OpticalStorage      = FALSE;
-    UsbMass->Transport           = Transport;
-    UsbMass->Context             = Context;
-    UsbMass->Lun                 = Index;
+    UsbMass->Signature              = USB_MASS_SIGNATURE;
+    UsbMass->UsbIo                  = UsbIo;
+    UsbMass->BlockIo.Media          = &UsbMass->BlockIoMedia;
+    UsbMass->BlockIo.Reset          = UsbMassReset;
+    UsbMass->BlockIo.ReadBlocks     = UsbMassReadBlocks;
+    UsbMass->BlockIo.WriteBlocks    = UsbMassWriteBlocks;
+    UsbMass->BlockIo.FlushBlocks    = UsbMassFlushBlocks;
+    UsbMass->BlockIo2.Media         = &UsbMass->BlockIoMedia;
+    UsbMass->BlockIo2.Reset         = UsbMassResetEx;
+    UsbMass->BlockIo2.ReadBlocksEx  = UsbMassReadBlocksEx;
+    UsbMass->BlockIo2.WriteBlocksEx = UsbMassWriteBlocksEx;
+    UsbMass->BlockIo2.FlushBlocksEx = UsbMassFlushBlocksEx;
+    UsbMass->OpticalStorage         = FALSE;
+    UsbMass->Transport              = Transport;
+    UsbMass->Context                = Context;
+    UsbMass->Lun                    = Index;
+    InitializeListHead (&UsbMass->AsyncQueue);
+    UsbMassInitAsyncBulk (This, Controller, UsbMass);
 
     //
     // Initialize the media parameter data for EFI_BLOCK_IO_MEDIA of Block I/O Protocol.
@@ -547,6 +1384,8 @@ UsbMassInitMultiLun (
                     UsbMass->DevicePath,
                     &gEfiBlockIoProtocolGuid,
                     &UsbMass->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid,
+                    &UsbMass->BlockIo2,
                     &gEfiDiskInfoProtocolGuid,
                     &UsbMass->DiskInfo,
                     NULL
@@ -579,6 +1418,8 @@ UsbMassInitMultiLun (
              UsbMass->DevicePath,
              &gEfiBlockIoProtocolGuid,
              &UsbMass->BlockIo,
+             &gEfiBlockIo2ProtocolGuid,
+             &UsbMass->BlockIo2,
              &gEfiDiskInfoProtocolGuid,
              &UsbMass->DiskInfo,
              NULL
@@ -637,17 +1478,24 @@ UsbMassInitNonLun (
     goto ON_ERROR;
   }
 
-  UsbMass->Signature           = USB_MASS_SIGNATURE;
-  UsbMass->Controller          = Controller;
-  UsbMass->UsbIo               = UsbIo;
-  UsbMass->BlockIo.Media       = &UsbMass->BlockIoMedia;
-  UsbMass->BlockIo.Reset       = UsbMassReset;
-  UsbMass->BlockIo.ReadBlocks  = UsbMassReadBlocks;
-  UsbMass->BlockIo.WriteBlocks = UsbMassWriteBlocks;
-  UsbMass->BlockIo.FlushBlocks = UsbMassFlushBlocks;
-  UsbMass->OpticalStorage      = FALSE;
-  UsbMass->Transport           = Transport;
-  UsbMass->Context             = Context;
+  UsbMass->Signature              = USB_MASS_SIGNATURE;
+  UsbMass->Controller             = Controller;
+  UsbMass->UsbIo                  = UsbIo;
+  UsbMass->BlockIo.Media          = &UsbMass->BlockIoMedia;
+  UsbMass->BlockIo.Reset          = UsbMassReset;
+  UsbMass->BlockIo.ReadBlocks     = UsbMassReadBlocks;
+  UsbMass->BlockIo.WriteBlocks    = UsbMassWriteBlocks;
+  UsbMass->BlockIo.FlushBlocks    = UsbMassFlushBlocks;
+  UsbMass->BlockIo2.Media         = &UsbMass->BlockIoMedia;
+  UsbMass->BlockIo2.Reset         = UsbMassResetEx;
+  UsbMass->BlockIo2.ReadBlocksEx  = UsbMassReadBlocksEx;
+  UsbMass->BlockIo2.WriteBlocksEx = UsbMassWriteBlocksEx;
+  UsbMass->BlockIo2.FlushBlocksEx = UsbMassFlushBlocksEx;
+  UsbMass->OpticalStorage         = FALSE;
+  UsbMass->Transport              = Transport;
+  UsbMass->Context                = Context;
+  InitializeListHead (&UsbMass->AsyncQueue);
+  UsbMassInitAsyncBulk (This, Controller, UsbMass);
 
   //
   // Initialize the media parameter data for EFI_BLOCK_IO_MEDIA of Block I/O Protocol.
@@ -664,6 +1512,8 @@ UsbMassInitNonLun (
                   &Controller,
                   &gEfiBlockIoProtocolGuid,
                   &UsbMass->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &UsbMass->BlockIo2,
                   &gEfiDiskInfoProtocolGuid,
                   &UsbMass->DiskInfo,
                   NULL
@@ -973,6 +1823,8 @@ USBMassDriverBindingStop (
                     Controller,
                     &gEfiBlockIoProtocolGuid,
                     &UsbMass->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid,
+                    &UsbMass->BlockIo2,
                     &gEfiDiskInfoProtocolGuid,
                     &UsbMass->DiskInfo,
                     NULL
@@ -989,7 +1841,7 @@ USBMassDriverBindingStop (
            );
 
     UsbMass->Transport->CleanUp (UsbMass->Context);
-    FreePool (UsbMass);
+    UsbMassFreeDevice (UsbMass);
 
     DEBUG ((DEBUG_INFO, "Success to stop non-multi-lun root handle\n"));
     return EFI_SUCCESS;
@@ -1032,6 +1884,8 @@ USBMassDriverBindingStop (
                     UsbMass->DevicePath,
                     &gEfiBlockIoProtocolGuid,
                     &UsbMass->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid,
+                    &UsbMass->BlockIo2,
                     &gEfiDiskInfoProtocolGuid,
                     &UsbMass->DiskInfo,
                     NULL
@@ -1060,7 +1914,7 @@ USBMassDriverBindingStop (
         UsbMass->Transport->CleanUp (UsbMass->Context);
       }
 
-      FreePool (UsbMass);
+      UsbMassFreeDevice (UsbMass);
     }
   }
 
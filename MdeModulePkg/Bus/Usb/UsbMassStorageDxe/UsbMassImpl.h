@@ -15,9 +15,48 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define USB_MASS_DEVICE_FROM_BLOCK_IO(a) \
         CR (a, USB_MASS_DEVICE, BlockIo, USB_MASS_SIGNATURE)
 
+#define USB_MASS_DEVICE_FROM_BLOCK_IO2(a) \
+        CR (a, USB_MASS_DEVICE, BlockIo2, USB_MASS_SIGNATURE)
+
 #define USB_MASS_DEVICE_FROM_DISK_INFO(a) \
         CR (a, USB_MASS_DEVICE, DiskInfo, USB_MASS_SIGNATURE)
 
+//
+// Size of the read-ahead buffer. A sequential read smaller than this is
+// extended to fill the buffer with one command, so that the following
+// sequential reads are served without another CBW/data/CSW round trip.
+//
+#define USB_MASS_READ_AHEAD_SIZE  USB_BOOT_MAX_CARRY_SIZE
+
+#define USB_MASS_ASYNC_REQUEST_SIGNATURE  SIGNATURE_32 ('U', 'M', 'A', 'R')
+
+typedef enum {
+  UsbMassAsyncRead,
+  UsbMassAsyncWrite,
+  UsbMassAsyncFlush
+} USB_MASS_ASYNC_OPERATION;
+
+//
+// A Block I/O 2 request waiting to be executed. A read or write is split
+// into commands, Lba, BufferSize and Buffer describe the blocks not yet
+// transferred.
+//
+typedef struct {
+  UINT32                      Signature;
+  LIST_ENTRY                  Link;
+  USB_MASS_ASYNC_OPERATION    Operation;
+  UINT32                      MediaId;
+  EFI_LBA                     Lba;
+  UINTN                       BufferSize;
+  VOID                        *Buffer;
+  EFI_BLOCK_IO2_TOKEN         *Token;
+  BOOLEAN                     Started;       ///< The media and the parameters are checked.
+  UINT32                      CommandBlocks; ///< The blocks of the command in flight.
+} USB_MASS_ASYNC_REQUEST;
+
+#define USB_MASS_ASYNC_REQUEST_FROM_LINK(a) \
+        CR (a, USB_MASS_ASYNC_REQUEST, Link, USB_MASS_ASYNC_REQUEST_SIGNATURE)
+
 extern EFI_COMPONENT_NAME_PROTOCOL   gUsbMassStorageComponentName;
 extern EFI_COMPONENT_NAME2_PROTOCOL  gUsbMassStorageComponentName2;
 
@@ -208,6 +247,135 @@ UsbMassFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   );
 
+//
+// Functions for Block I/O 2 Protocol
+//
+
+/**
+  Reset the block device hardware.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.Reset(). All the pending
+  asynchronous requests are aborted.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  ExtendedVerification   Indicates that the driver may perform a more exhaustive
+                                 verification operation of the device during reset.
+
+  @retval EFI_SUCCESS            The device was reset.
+  @retval EFI_DEVICE_ERROR       The device is not functioning properly and could
+                                 not be reset.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  );
+
+/**
+  Read BufferSize bytes from Lba into Buffer.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx(). If Token is
+  NULL or Token->Event is NULL, the read is performed synchronously. Otherwise
+  the request is queued, EFI_SUCCESS is returned, and Token->Event is signaled
+  when the read completes.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  MediaId                Id of the media, changes every time the media is replaced.
+  @param  Lba                    The starting Logical Block Address to read from.
+  @param  Token                  A pointer to the token associated with the transaction.
+  @param  BufferSize             Size of Buffer, must be a multiple of device block size.
+  @param  Buffer                 A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS            The read request was queued if Event is not NULL,
+                                 or the data was read correctly from the device.
+  @retval EFI_DEVICE_ERROR       The device reported an error while performing the read.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_MEDIA_CHANGED      The MediaId is not for the current media.
+  @retval EFI_BAD_BUFFER_SIZE    The BufferSize parameter is not a multiple of the
+                                 intrinsic block size of the device.
+  @retval EFI_INVALID_PARAMETER  The read request contains LBAs that are not valid,
+                                 or the buffer is not on proper alignment.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be completed due to a lack
+                                 of resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  );
+
+/**
+  Write BufferSize bytes from Buffer to Lba.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx(). If Token is
+  NULL or Token->Event is NULL, the write is performed synchronously. Otherwise
+  the request is queued, EFI_SUCCESS is returned, and Token->Event is signaled
+  when the write completes.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  MediaId                The media ID that the write request is for.
+  @param  Lba                    The starting logical block address to be written.
+  @param  Token                  A pointer to the token associated with the transaction.
+  @param  BufferSize             Size of Buffer, must be a multiple of device block size.
+  @param  Buffer                 A pointer to the source buffer for the data.
+
+  @retval EFI_SUCCESS            The write request was queued if Event is not NULL,
+                                 or the data was written correctly to the device.
+  @retval EFI_WRITE_PROTECTED    The device cannot be written to.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_MEDIA_CHANGED      The MediaId is not for the current media.
+  @retval EFI_DEVICE_ERROR       The device reported an error while performing the write.
+  @retval EFI_BAD_BUFFER_SIZE    The BufferSize parameter is not a multiple of the
+                                 intrinsic block size of the device.
+  @retval EFI_INVALID_PARAMETER  The write request contains LBAs that are not valid,
+                                 or the buffer is not on proper alignment.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be completed due to a lack
+                                 of resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  );
+
+/**
+  Flush the block device.
+
+  This function implements EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx(). The flush
+  completes after all the previously queued requests have completed.
+
+  @param  This                   Indicates a pointer to the calling context.
+  @param  Token                  A pointer to the token associated with the transaction.
+
+  @retval EFI_SUCCESS            The flush request was queued if Event is not NULL,
+                                 or all outstanding data was written to the device.
+  @retval EFI_DEVICE_ERROR       The device reported an error while writing back the data.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be completed due to a lack
+                                 of resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbMassFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  );
+
 //
 // EFI Component Name Functions
 //
@@ -0,0 +1,95 @@
+/** @file
+  EDKII Simple Network Receive Buffer Loan Protocol.
+
+  This protocol is produced by Simple Network Protocol drivers on the handle
+  of the Simple Network Protocol instance. It lets the consumer of the SNP
+  borrow a receive buffer of the network interface, holding a received
+  packet, instead of having Receive() copy the packet into a buffer of the
+  caller. The buffer is handed back with ReturnLoan() once the packet has
+  been consumed, and the driver then gives it back to the receive ring.
+
+  Only a part of the receive buffers of the interface may be loaned out at
+  a time, so that the interface keeps receiving while the consumer holds
+  packets. Once that limit is reached, ReceiveLoan() fails and the consumer
+  falls back to the Receive() service of the SNP.
+
+  Like the services of the SNP, both services may only be called at
+  TPL_CALLBACK or lower. A consumer that releases a loaned buffer at a higher
+  TPL must defer ReturnLoan() until it runs at TPL_CALLBACK again.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL_H__
+#define __EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL_H__
+
+#define EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL_GUID \
+  { \
+    0x3f0e5d2a, 0x8b61, 0x4c47, { 0x9e, 0x1d, 0x52, 0xa8, 0x07, 0xc4, 0x6b, 0x3e } \
+  }
+
+typedef struct _EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL;
+
+/**
+  Receive a packet from the network interface into a buffer loaned by the
+  interface.
+
+  On success, Buffer points to the media header followed by the data of the
+  packet. The buffer stays valid and owned by the caller until it is handed
+  back with ReturnLoan(). The caller may modify its content.
+
+  @param  This          This EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param  HeaderSize    The size, in bytes, of the media header received on
+                        the network interface. Optional.
+  @param  BufferSize    On exit, the size, in bytes, of the packet received.
+  @param  Buffer        On exit, the loaned buffer holding the packet.
+
+  @retval EFI_SUCCESS           A packet is received into a loaned buffer.
+  @retval EFI_NOT_STARTED       The network interface is not initialized.
+  @retval EFI_NOT_READY         No packet has been received.
+  @retval EFI_OUT_OF_RESOURCES  The maximum number of buffers is loaned out.
+                                The packet, if any, is left to Receive().
+  @retval EFI_INVALID_PARAMETER BufferSize or Buffer is NULL.
+  @retval EFI_DEVICE_ERROR      The network interface reported an error.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_RX_LOAN_RECEIVE)(
+  IN  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  OUT UINTN                                  *HeaderSize OPTIONAL,
+  OUT UINTN                                  *BufferSize,
+  OUT VOID                                   **Buffer
+  );
+
+/**
+  Hand a loaned receive buffer back to the network interface.
+
+  The buffer may be returned after the interface has been shut down, but all
+  the loaned buffers must be returned before the Simple Network Protocol
+  instance can be stopped and uninstalled.
+
+  @param  This          This EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param  Buffer        The buffer returned by ReceiveLoan().
+
+  @retval EFI_SUCCESS           The buffer is returned.
+  @retval EFI_INVALID_PARAMETER Buffer is not a loaned buffer.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_RX_LOAN_RETURN)(
+  IN EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  IN VOID                                   *Buffer
+  );
+
+struct _EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL {
+  EDKII_SIMPLE_NETWORK_RX_LOAN_RECEIVE    ReceiveLoan;
+  EDKII_SIMPLE_NETWORK_RX_LOAN_RETURN     ReturnLoan;
+};
+
+extern EFI_GUID  gEdkiiSimpleNetworkRxLoanProtocolGuid;
+
+#endif
@@ -0,0 +1,112 @@
+/** @file
+  EDKII USB Asynchronous Bulk Transfer Protocol.
+
+  This protocol is produced by USB host controller drivers on the host
+  controller handle, next to EFI_USB2_HC_PROTOCOL. It lets a caller queue
+  several bulk transfers on one endpoint and be notified of the completion
+  of each through a callback, instead of blocking in BulkTransfer() until
+  the single outstanding transfer is done.
+
+  Only host controllers that keep the transaction translator of each device
+  in their own device context, like xHCI, produce this protocol, so none is
+  passed with the transfers.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_USB_ASYNC_BULK_PROTOCOL_H__
+#define __EDKII_USB_ASYNC_BULK_PROTOCOL_H__
+
+#include <Protocol/Usb2HostController.h>
+
+#define EDKII_USB_ASYNC_BULK_PROTOCOL_GUID \
+  { \
+    0x9289eb06, 0xad1d, 0x43c9, { 0x83, 0xc4, 0xf7, 0x0e, 0xe1, 0x4e, 0x2b, 0xad } \
+  }
+
+typedef struct _EDKII_USB_ASYNC_BULK_PROTOCOL EDKII_USB_ASYNC_BULK_PROTOCOL;
+
+/**
+  Queue an asynchronous bulk transfer to a bulk endpoint of a USB device.
+
+  The function returns as soon as the transfer has been handed to the host
+  controller. When the transfer completes, fails or times out,
+  CallBackFunction is invoked with Data, the number of bytes actually
+  transferred, Context and the USB transfer result. Data must stay valid
+  and must not be touched by the caller until then. Several transfers may
+  be queued on the same endpoint; they complete in submission order.
+
+  CallBackFunction is invoked at TPL_NOTIFY. It may queue or cancel
+  transfers. When the host controller is reset or stopped, the transfers
+  still queued complete with EFI_USB_ERR_SYSTEM, from within the Reset() of
+  EFI_USB2_HC_PROTOCOL or the Stop() of the host controller driver.
+
+  @param  This                  This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support bulk
+                                transfer.
+  @param  MaximumPacketLength   Maximum packet size the endpoint is capable of
+                                sending or receiving.
+  @param  Data                  The buffer of data to transmit from or receive into.
+  @param  DataLength            The length of the data buffer.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                the transfer is allowed to complete. 0 means no
+                                timeout.
+  @param  CallBackFunction      Function to call when the transfer is finished.
+  @param  Context               Context passed to CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer was queued successfully.
+  @retval EFI_OUT_OF_RESOURCES  The transfer failed due to lack of resource.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_DEVICE_ERROR      The transfer failed due to host controller error.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_ASYNC_BULK_TRANSFER)(
+  IN EDKII_USB_ASYNC_BULK_PROTOCOL    *This,
+  IN UINT8                            DeviceAddress,
+  IN UINT8                            EndPointAddress,
+  IN UINT8                            DeviceSpeed,
+  IN UINTN                            MaximumPacketLength,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN UINTN                            Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  CallBackFunction,
+  IN VOID                             *Context OPTIONAL
+  );
+
+/**
+  Cancel all the asynchronous bulk transfers queued on an endpoint.
+
+  The callbacks of the cancelled transfers are not invoked. Once the
+  function returns, the data buffers of those transfers are no longer
+  accessed by the host controller and belong to the caller again.
+
+  @param  This                  This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+
+  @retval EFI_SUCCESS           The transfers were cancelled.
+  @retval EFI_NOT_FOUND         No transfer is queued on the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_ASYNC_BULK_CANCEL)(
+  IN EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                          DeviceAddress,
+  IN UINT8                          EndPointAddress
+  );
+
+struct _EDKII_USB_ASYNC_BULK_PROTOCOL {
+  EDKII_USB_ASYNC_BULK_TRANSFER    AsyncBulkTransfer;
+  EDKII_USB_ASYNC_BULK_CANCEL      CancelAsyncBulkTransfer;
+};
+
+extern EFI_GUID  gEdkiiUsbAsyncBulkProtocolGuid;
+
+#endif
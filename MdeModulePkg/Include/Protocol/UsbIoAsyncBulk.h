@@ -0,0 +1,105 @@
+/** @file
+  EDKII USB IO Asynchronous Bulk Transfer Protocol.
+
+  This protocol is produced by the USB bus driver on the USB interface
+  handles, next to EFI_USB_IO_PROTOCOL, when the host controller produces
+  EDKII_USB_ASYNC_BULK_PROTOCOL. It lets a USB class driver keep several
+  bulk transfers in flight on the endpoints of its interface.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_USB_IO_ASYNC_BULK_PROTOCOL_H__
+#define __EDKII_USB_IO_ASYNC_BULK_PROTOCOL_H__
+
+#include <Protocol/UsbIo.h>
+
+#define EDKII_USB_IO_ASYNC_BULK_PROTOCOL_GUID \
+  { \
+    0xe68902d6, 0x0276, 0x4c47, { 0x9e, 0x13, 0x54, 0x30, 0x49, 0x23, 0x90, 0x64 } \
+  }
+
+typedef struct _EDKII_USB_IO_ASYNC_BULK_PROTOCOL EDKII_USB_IO_ASYNC_BULK_PROTOCOL;
+
+/**
+  Queue an asynchronous bulk transfer to a bulk endpoint of the interface.
+
+  The function returns as soon as the transfer has been handed to the host
+  controller. When the transfer completes, fails or times out,
+  CallBackFunction is invoked at TPL_NOTIFY with Data, the number of bytes
+  actually transferred, Context and the USB transfer result. Data must stay
+  valid and must not be touched by the caller until then. Several transfers
+  may be queued on the same endpoint; they complete in submission order.
+
+  After a failed transfer the host controller has dropped the transfers
+  queued behind it on the same endpoint, which complete with
+  EFI_USB_ERR_NOTEXECUTE. Clearing a stall condition of the device is left
+  to the caller. When the host controller is reset or stopped, the pending
+  transfers complete with EFI_USB_ERR_SYSTEM.
+
+  @param  This                  This EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceEndpoint        The destination USB device endpoint to which the
+                                device request is being sent. DeviceEndpoint must
+                                be between 0x01 and 0x0F or between 0x81 and 0x8F,
+                                otherwise EFI_INVALID_PARAMETER is returned.
+  @param  Data                  The buffer of data to transmit from or receive into.
+  @param  DataLength            The length of the data buffer.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                the transfer is allowed to complete. 0 means no
+                                timeout.
+  @param  CallBackFunction      Function to call when the transfer is finished.
+  @param  Context               Context passed to CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer was queued successfully.
+  @retval EFI_OUT_OF_RESOURCES  The transfer failed due to lack of resource.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid, e.g. DeviceEndpoint
+                                is not a bulk endpoint of the interface.
+  @retval EFI_DEVICE_ERROR      The transfer failed due to host controller error.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_TRANSFER)(
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             DeviceEndpoint,
+  IN VOID                              *Data,
+  IN UINTN                             DataLength,
+  IN UINTN                             Timeout,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK   CallBackFunction,
+  IN VOID                              *Context OPTIONAL
+  );
+
+/**
+  Cancel all the asynchronous bulk transfers queued on an endpoint of the
+  interface.
+
+  The callbacks of the cancelled transfers are not invoked. Once the
+  function returns, the data buffers of those transfers are no longer
+  accessed by the host controller and belong to the caller again.
+
+  @param  This                  This EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceEndpoint        The endpoint of the interface.
+
+  @retval EFI_SUCCESS           The transfers were cancelled.
+  @retval EFI_NOT_FOUND         No transfer is queued on the endpoint.
+  @retval EFI_INVALID_PARAMETER DeviceEndpoint is not a bulk endpoint of the
+                                interface.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_CANCEL)(
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             DeviceEndpoint
+  );
+
+struct _EDKII_USB_IO_ASYNC_BULK_PROTOCOL {
+  EDKII_USB_IO_ASYNC_BULK_TRANSFER    AsyncBulkTransfer;
+  EDKII_USB_IO_ASYNC_BULK_CANCEL      CancelAsyncBulkTransfer;
+};
+
+extern EFI_GUID  gEdkiiUsbIoAsyncBulkProtocolGuid;
+
+#endif
@@ -343,16 +343,18 @@ DnsUnload (
 {
   EFI_STATUS  Status;
 
-  LIST_ENTRY      *Entry;
-  DNS4_CACHE      *ItemCache4;
-  DNS4_SERVER_IP  *ItemServerIp4;
-  DNS6_CACHE      *ItemCache6;
-  DNS6_SERVER_IP  *ItemServerIp6;
+  LIST_ENTRY          *Entry;
+  DNS4_CACHE          *ItemCache4;
+  DNS4_SERVER_IP      *ItemServerIp4;
+  DNS6_CACHE          *ItemCache6;
+  DNS6_SERVER_IP      *ItemServerIp6;
+  DNS_NEGATIVE_CACHE  *ItemNegative;
 
   ItemCache4    = NULL;
   ItemServerIp4 = NULL;
   ItemCache6    = NULL;
   ItemServerIp6 = NULL;
+  ItemNegative  = NULL;
 
   //
   // Disconnect the driver specified by ImageHandle
@@ -402,6 +404,14 @@ DnsUnload (
       FreePool (ItemServerIp6);
     }
 
+    while (!IsListEmpty (&mDriverData->DnsNegativeCacheList)) {
+      Entry = NetListRemoveHead (&mDriverData->DnsNegativeCacheList);
+      ASSERT (Entry != NULL);
+      ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+      FreePool (ItemNegative->HostName);
+      FreePool (ItemNegative);
+    }
+
     FreePool (mDriverData);
   }
 
@@ -492,6 +502,7 @@ DnsDriverEntryPoint (
   InitializeListHead (&mDriverData->Dns4ServerList);
   InitializeListHead (&mDriverData->Dns6CacheList);
   InitializeListHead (&mDriverData->Dns6ServerList);
+  InitializeListHead (&mDriverData->DnsNegativeCacheList);
 
   return Status;
 
@@ -31,6 +31,11 @@ typedef struct _DNS_INSTANCE DNS_INSTANCE;
 
 #define DNS_INSTANCE_SIGNATURE  SIGNATURE_32 ('D', 'N', 'S', 'I')
 
+//
+// The maximum number of DNS servers a query is sent to at once.
+//
+#define DNS_MAX_PARALLEL_SERVERS  3
+
 struct _DNS_DRIVER_DATA {
   EFI_EVENT     Timer;                 /// Ticking timer for DNS cache update.
 
@@ -39,6 +44,8 @@ struct _DNS_DRIVER_DATA {
 
   LIST_ENTRY    Dns6CacheList;
   LIST_ENTRY    Dns6ServerList;
+
+  LIST_ENTRY    DnsNegativeCacheList;  /// Negative answers of both DNSv4 and DNSv6.
 };
 
 struct _DNS_SERVICE {
@@ -80,6 +87,13 @@ struct _DNS_INSTANCE {
 
   EFI_IP_ADDRESS          SessionDnsServer;
 
+  //
+  // The queries are sent to all these servers at once, the first of them
+  // being SessionDnsServer. The first answer wins.
+  //
+  EFI_IP_ADDRESS          SessionDnsServers[DNS_MAX_PARALLEL_SERVERS];
+  UINTN                   SessionDnsServerCount;
+
   NET_MAP                 Dns4TxTokens;
   NET_MAP                 Dns6TxTokens;
 
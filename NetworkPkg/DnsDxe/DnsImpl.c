@@ -688,8 +688,12 @@ Dns4ConfigUdp (
   UdpConfig.StationPort        = Config->LocalPort;
   UdpConfig.RemotePort         = DNS_SERVER_PORT;
 
+  //
+  // The UDP child isn't connected to one server, the queries are sent to
+  // all the session DNS servers, see DnsSendQuery().
+  //
   CopyMem (&UdpConfig.StationAddress, &Config->StationIp, sizeof (EFI_IPv4_ADDRESS));
-  CopyMem (&UdpConfig.RemoteAddress, &Instance->SessionDnsServer.v4, sizeof (EFI_IPv4_ADDRESS));
+  ZeroMem (&UdpConfig.RemoteAddress, sizeof (EFI_IPv4_ADDRESS));
 
   Status = UdpIo->Protocol.Udp4->Configure (UdpIo->Protocol.Udp4, &UdpConfig);
 
@@ -732,7 +736,7 @@ Dns6ConfigUdp (
   UdpConfig.StationPort        = Config->LocalPort;
   UdpConfig.RemotePort         = DNS_SERVER_PORT;
   CopyMem (&UdpConfig.StationAddress, &Config->StationIp, sizeof (EFI_IPv6_ADDRESS));
-  CopyMem (&UdpConfig.RemoteAddress, &Instance->SessionDnsServer.v6, sizeof (EFI_IPv6_ADDRESS));
+  ZeroMem (&UdpConfig.RemoteAddress, sizeof (EFI_IPv6_ADDRESS));
 
   Status = UdpIo->Protocol.Udp6->Configure (UdpIo->Protocol.Udp6, &UdpConfig);
 
@@ -942,6 +946,224 @@ UpdateDns6Cache (
   return EFI_SUCCESS;
 }
 
+/**
+  Skip a domain name in a DNS message.
+
+  @param  Packet             The DNS message.
+  @param  Length             The length of the DNS message.
+  @param  Offset             The offset of the domain name.
+
+  @return The offset following the domain name, or 0 if the domain name
+          exceeds the DNS message.
+
+**/
+STATIC
+UINT32
+DnsSkipName (
+  IN UINT8   *Packet,
+  IN UINT32  Length,
+  IN UINT32  Offset
+  )
+{
+  UINT8  Label;
+
+  while (Offset < Length) {
+    Label = Packet[Offset];
+    if (Label == 0) {
+      return Offset + 1;
+    }
+
+    //
+    // A compressed name ends with a pointer to the rest of the name.
+    //
+    if ((Label & 0xC0) == 0xC0) {
+      return (Offset + sizeof (UINT16) <= Length) ? Offset + sizeof (UINT16) : 0;
+    }
+
+    Offset += Label + 1;
+  }
+
+  return 0;
+}
+
+/**
+  Get the negative caching TTL of a DNS response, the minimum of the TTL and
+  of the MINIMUM field of the SOA record in its authority section.
+
+  @param  DnsHeader          The DNS response, header converted to host order.
+  @param  Offset             The offset of the answer section.
+  @param  Length             The length of the DNS response.
+  @param  Ttl                The negative caching TTL.
+
+  @retval TRUE               The TTL is returned.
+  @retval FALSE              The response has no valid SOA record.
+
+**/
+STATIC
+BOOLEAN
+DnsGetNegativeTtl (
+  IN  DNS_HEADER  *DnsHeader,
+  IN  UINT32      Offset,
+  IN  UINT32      Length,
+  OUT UINT32      *Ttl
+  )
+{
+  UINT8               *Packet;
+  DNS_ANSWER_SECTION  *Record;
+  UINT32              RecordNum;
+  UINT32              Index;
+  UINT16              DataLength;
+  UINT32              Minimum;
+
+  Packet    = (UINT8 *)DnsHeader;
+  RecordNum = (UINT32)DnsHeader->AnswersNum + DnsHeader->AuthorityNum;
+
+  for (Index = 0; Index < RecordNum; Index++) {
+    Offset = DnsSkipName (Packet, Length, Offset);
+    if ((Offset == 0) || (Length - Offset < sizeof (DNS_ANSWER_SECTION))) {
+      return FALSE;
+    }
+
+    Record      = (DNS_ANSWER_SECTION *)(Packet + Offset);
+    DataLength  = NTOHS (Record->DataLength);
+    Offset     += sizeof (DNS_ANSWER_SECTION);
+    if (Length - Offset < DataLength) {
+      return FALSE;
+    }
+
+    //
+    // The SOA RDATA ends with the 32-bit SERIAL, REFRESH, RETRY, EXPIRE and
+    // MINIMUM fields, after the MNAME and RNAME domain names.
+    //
+    if ((Index >= DnsHeader->AnswersNum) && (NTOHS (Record->Type) == DNS_TYPE_SOA) &&
+        (DataLength >= 2 + 5 * sizeof (UINT32)))
+    {
+      Minimum = NTOHL (ReadUnaligned32 ((UINT32 *)(Packet + Offset + DataLength - sizeof (UINT32))));
+      *Ttl    = MIN (NTOHL (Record->Ttl), Minimum);
+      return TRUE;
+    }
+
+    Offset += DataLength;
+  }
+
+  return FALSE;
+}
+
+/**
+  Remember the negative answer to an address query in the shared negative
+  cache of all DNS instances, as described in RFC 2308.
+
+  The answer is kept for the TTL of the SOA record of its authority section,
+  bounded by PcdDnsNegativeCacheTimeout. An answer without SOA record is not
+  cached.
+
+  @param  HostName           The host name of the query.
+  @param  DnsHeader          The DNS response, header converted to host order.
+  @param  QuerySection       The query section of the DNS response, converted
+                             to host order.
+  @param  Length             The length of the DNS response.
+  @param  Status             The status the query completed with.
+
+**/
+VOID
+UpdateDnsNegativeCache (
+  IN CHAR16             *HostName,
+  IN DNS_HEADER         *DnsHeader,
+  IN DNS_QUERY_SECTION  *QuerySection,
+  IN UINT32             Length,
+  IN EFI_STATUS         Status
+  )
+{
+  DNS_NEGATIVE_CACHE  *Item;
+  LIST_ENTRY          *Entry;
+  UINT16              QueryType;
+  UINT32              Timeout;
+
+  if (!DnsGetNegativeTtl (
+         DnsHeader,
+         (UINT32)((UINT8 *)(QuerySection + 1) - (UINT8 *)DnsHeader),
+         Length,
+         &Timeout
+         ))
+  {
+    return;
+  }
+
+  Timeout = MIN (Timeout, PcdGet32 (PcdDnsNegativeCacheTimeout));
+  if (Timeout == 0) {
+    return;
+  }
+
+  //
+  // A name which doesn't exist has no record of any type, while a name
+  // without record of the queried type may have records of other types.
+  //
+  if (DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) {
+    QueryType = DNS_TYPE_ANY;
+  } else {
+    QueryType = QuerySection->Type;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &mDriverData->DnsNegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if ((Item->QueryType == QueryType) && (StrCmp (HostName, Item->HostName) == 0)) {
+      Item->Status  = Status;
+      Item->Timeout = Timeout;
+      return;
+    }
+  }
+
+  Item = AllocatePool (sizeof (DNS_NEGATIVE_CACHE));
+  if (Item == NULL) {
+    return;
+  }
+
+  Item->HostName = AllocateCopyPool (StrSize (HostName), HostName);
+  if (Item->HostName == NULL) {
+    FreePool (Item);
+    return;
+  }
+
+  Item->QueryType = QueryType;
+  Item->Status    = Status;
+  Item->Timeout   = Timeout;
+  InsertTailList (&mDriverData->DnsNegativeCacheList, &Item->AllCacheLink);
+}
+
+/**
+  Look up the negative cache for an address query.
+
+  @param  HostName           The host name to query.
+  @param  QueryType          The type of the query, DNS_TYPE_A or DNS_TYPE_AAAA.
+  @param  Status             The status the cached query completed with.
+
+  @retval TRUE               The query has a cached negative answer.
+  @retval FALSE              The query has to be sent to the DNS server.
+
+**/
+BOOLEAN
+LookupDnsNegativeCache (
+  IN  CHAR16      *HostName,
+  IN  UINT16      QueryType,
+  OUT EFI_STATUS  *Status
+  )
+{
+  DNS_NEGATIVE_CACHE  *Item;
+  LIST_ENTRY          *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &mDriverData->DnsNegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (((Item->QueryType == DNS_TYPE_ANY) || (Item->QueryType == QueryType)) &&
+        (StrCmp (HostName, Item->HostName) == 0))
+    {
+      *Status = Item->Status;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
@@ -1114,6 +1336,8 @@ IsValidDnsResponse (
   @param  Instance              The DNS instance
   @param  RxString              Received buffer.
   @param  Length                Received buffer length.
+  @param  ServerIndex           The index in SessionDnsServers of the server
+                                which sent the response.
   @param  Completed             Flag to indicate that Dns response is valid.
 
   @retval EFI_SUCCESS           Parse Dns Response successfully.
@@ -1125,6 +1349,7 @@ ParseDnsResponse (
   IN OUT DNS_INSTANCE  *Instance,
   IN     UINT8         *RxString,
   IN     UINT32        Length,
+  IN     UINTN         ServerIndex,
   OUT BOOLEAN          *Completed
   )
 {
@@ -1158,6 +1383,7 @@ ParseDnsResponse (
 
   EFI_STATUS  Status;
   UINT32      RemainingLength;
+  UINT32      *FailedServers;
 
   EFI_TPL  OldTpl;
 
@@ -1283,6 +1509,28 @@ ParseDnsResponse (
   if ((DnsHeader->Flags.Bits.RCode != DNS_FLAGS_RCODE_NO_ERROR) || (DnsHeader->AnswersNum < 1) || \
       (DnsHeader->Flags.Bits.QR != DNS_FLAGS_QR_RESPONSE))
   {
+    //
+    // A server which failed to resolve the name doesn't end the query
+    // while another server it was sent to may still answer.
+    //
+    if ((DnsHeader->Flags.Bits.QR == DNS_FLAGS_QR_RESPONSE) &&
+        (DnsHeader->Flags.Bits.RCode != DNS_FLAGS_RCODE_NO_ERROR) &&
+        (DnsHeader->Flags.Bits.RCode != DNS_FLAGS_RCODE_NAME_ERROR))
+    {
+      FailedServers   = (Dns4TokenEntry != NULL) ? &Dns4TokenEntry->FailedServers : &Dns6TokenEntry->FailedServers;
+      *FailedServers |= (UINT32)(1 << ServerIndex);
+      if (*FailedServers != (UINT32)((1 << Instance->SessionDnsServerCount) - 1)) {
+        //
+        // Nothing was allocated for the token yet.
+        //
+        *Completed     = FALSE;
+        Status         = EFI_ABORTED;
+        Dns4TokenEntry = NULL;
+        Dns6TokenEntry = NULL;
+        goto ON_EXIT;
+      }
+    }
+
     //
     // The domain name referenced in the query does not exist.
     //
@@ -1292,6 +1540,21 @@ ParseDnsResponse (
       Status = EFI_DEVICE_ERROR;
     }
 
+    //
+    // Remember that the host name has no address, so that it isn't queried
+    // again until the negative answer expires.
+    //
+    if ((DnsHeader->Flags.Bits.QR == DNS_FLAGS_QR_RESPONSE) &&
+        ((DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) ||
+         ((DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NO_ERROR) && (DnsHeader->AnswersNum == 0))))
+    {
+      if ((Dns4TokenEntry != NULL) && !Dns4TokenEntry->GeneralLookUp && (QuerySection->Type == DNS_TYPE_A)) {
+        UpdateDnsNegativeCache (Dns4TokenEntry->QueryHostName, DnsHeader, QuerySection, Length, Status);
+      } else if ((Dns6TokenEntry != NULL) && !Dns6TokenEntry->GeneralLookUp && (QuerySection->Type == DNS_TYPE_AAAA)) {
+        UpdateDnsNegativeCache (Dns6TokenEntry->QueryHostName, DnsHeader, QuerySection, Length, Status);
+      }
+    }
+
     goto ON_COMPLETE;
   }
 
@@ -1815,6 +2078,9 @@ DnsOnPacketReceived (
 
   BOOLEAN  Completed;
 
+  EFI_IP_ADDRESS  Source;
+  UINTN           ServerIndex;
+
   Instance = (DNS_INSTANCE *)Context;
   NET_CHECK_SIGNATURE (Instance, DNS_INSTANCE_SIGNATURE);
 
@@ -1827,6 +2093,32 @@ DnsOnPacketReceived (
 
   ASSERT (Packet != NULL);
 
+  //
+  // The UDP child isn't connected, only accept the responses of the
+  // servers the queries were sent to.
+  //
+  CopyMem (&Source, &EndPoint->RemoteAddr, sizeof (EFI_IP_ADDRESS));
+  if (Instance->Service->IpVersion == IP_VERSION_4) {
+    Source.Addr[0] = HTONL (Source.Addr[0]);
+  } else {
+    Ip6Swap128 (&Source.v6);
+  }
+
+  for (ServerIndex = 0; ServerIndex < Instance->SessionDnsServerCount; ServerIndex++) {
+    if (CompareMem (
+          &Source,
+          &Instance->SessionDnsServers[ServerIndex],
+          (Instance->Service->IpVersion == IP_VERSION_4) ? sizeof (EFI_IPv4_ADDRESS) : sizeof (EFI_IPv6_ADDRESS)
+          ) == 0)
+    {
+      break;
+    }
+  }
+
+  if (ServerIndex == Instance->SessionDnsServerCount) {
+    goto ON_EXIT;
+  }
+
   Len = Packet->TotalSize;
 
   RcvString = NetbufGetByte (Packet, 0, NULL);
@@ -1835,7 +2127,7 @@ DnsOnPacketReceived (
   //
   // Parse Dns Response
   //
-  ParseDnsResponse (Instance, RcvString, Len, &Completed);
+  ParseDnsResponse (Instance, RcvString, Len, ServerIndex, &Completed);
 
 ON_EXIT:
 
@@ -1843,7 +2135,13 @@ ON_EXIT:
     NetbufFree (Packet);
   }
 
-  if (!Completed) {
+  //
+  // Keep receiving while queries are pending, the other servers still
+  // answer the completed query too.
+  //
+  if (!Completed ||
+      !NetMapIsEmpty ((Instance->Service->IpVersion == IP_VERSION_4) ? &Instance->Dns4TxTokens : &Instance->Dns6TxTokens))
+  {
     UdpIoRecvDatagram (Instance->UdpIo, DnsOnPacketReceived, Instance, 0);
   }
 }
@@ -1901,6 +2199,96 @@ DnsOnPacketSent (
   NetbufFree (Packet);
 }
 
+/**
+  Set the DNS servers the queries of a DNS instance are sent to.
+
+  Up to DNS_MAX_PARALLEL_SERVERS servers of the list are used, in order.
+
+  @param  Instance              The DNS instance.
+  @param  ServerList            The EFI_IPv4_ADDRESS or EFI_IPv6_ADDRESS list
+                                of the servers, according to the IP version
+                                of the instance.
+  @param  ServerCount           The number of servers in ServerList, not 0.
+
+**/
+VOID
+DnsSetSessionServers (
+  IN DNS_INSTANCE  *Instance,
+  IN VOID          *ServerList,
+  IN UINTN         ServerCount
+  )
+{
+  UINTN  Index;
+
+  ASSERT (ServerCount != 0);
+
+  ZeroMem (Instance->SessionDnsServers, sizeof (Instance->SessionDnsServers));
+  Instance->SessionDnsServerCount = MIN (ServerCount, DNS_MAX_PARALLEL_SERVERS);
+
+  for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+    if (Instance->Service->IpVersion == IP_VERSION_4) {
+      CopyMem (&Instance->SessionDnsServers[Index].v4, (EFI_IPv4_ADDRESS *)ServerList + Index, sizeof (EFI_IPv4_ADDRESS));
+    } else {
+      CopyMem (&Instance->SessionDnsServers[Index].v6, (EFI_IPv6_ADDRESS *)ServerList + Index, sizeof (EFI_IPv6_ADDRESS));
+    }
+  }
+
+  CopyMem (&Instance->SessionDnsServer, &Instance->SessionDnsServers[0], sizeof (EFI_IP_ADDRESS));
+}
+
+/**
+  Send a DNS packet to all the session DNS servers of the instance, so that
+  a slow or unreachable server doesn't delay the query.
+
+  @param  Instance              The DNS instance
+  @param  Packet                The DNS packet to send.
+
+  @retval EFI_SUCCESS           The packet is sent to at least one server.
+  @retval Others                Failed to send the packet to any server.
+
+**/
+EFI_STATUS
+DnsSendQuery (
+  IN DNS_INSTANCE  *Instance,
+  IN NET_BUF       *Packet
+  )
+{
+  EFI_STATUS     Status;
+  EFI_STATUS     SendStatus;
+  UDP_END_POINT  EndPoint;
+  UINTN          Index;
+
+  Status = EFI_NOT_STARTED;
+
+  for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+    //
+    // UDP_END_POINT addresses are in host byte order.
+    //
+    ZeroMem (&EndPoint, sizeof (EndPoint));
+    CopyMem (&EndPoint.RemoteAddr, &Instance->SessionDnsServers[Index], sizeof (EFI_IP_ADDRESS));
+    EndPoint.RemotePort = DNS_SERVER_PORT;
+    if (Instance->Service->IpVersion == IP_VERSION_4) {
+      EndPoint.RemoteAddr.Addr[0] = NTOHL (EndPoint.RemoteAddr.Addr[0]);
+    } else {
+      Ip6Swap128 (&EndPoint.RemoteAddr.v6);
+    }
+
+    NET_GET_REF (Packet);
+
+    SendStatus = UdpIoSendDatagram (Instance->UdpIo, Packet, &EndPoint, NULL, DnsOnPacketSent, Instance);
+    if (EFI_ERROR (SendStatus)) {
+      NET_PUT_REF (Packet);
+      if (Status != EFI_SUCCESS) {
+        Status = SendStatus;
+      }
+    } else {
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  return Status;
+}
+
 /**
   Query request information.
 
@@ -1932,11 +2320,7 @@ DoDnsQuery (
   //
   // Transmit the DNS packet.
   //
-  NET_GET_REF (Packet);
-
-  Status = UdpIoSendDatagram (Instance->UdpIo, Packet, NULL, NULL, DnsOnPacketSent, Instance);
-
-  return Status;
+  return DnsSendQuery (Instance, Packet);
 }
 
 /**
@@ -2056,34 +2440,9 @@ DnsRetransmit (
   IN NET_BUF       *Packet
   )
 {
-  EFI_STATUS  Status;
-
-  UINT8  *Buffer;
-
   ASSERT (Packet != NULL);
 
-  //
-  // Set the requests to the listening port, other packets to the connected port
-  //
-  Buffer = NetbufGetByte (Packet, 0, NULL);
-  ASSERT (Buffer != NULL);
-
-  NET_GET_REF (Packet);
-
-  Status = UdpIoSendDatagram (
-             Instance->UdpIo,
-             Packet,
-             NULL,
-             NULL,
-             DnsOnPacketSent,
-             Instance
-             );
-
-  if (EFI_ERROR (Status)) {
-    NET_PUT_REF (Packet);
-  }
-
-  return Status;
+  return DnsSendQuery (Instance, Packet);
 }
 
 /**
@@ -2221,10 +2580,11 @@ DnsOnTimerUpdate (
   IN VOID       *Context
   )
 {
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Next;
-  DNS4_CACHE  *Item4;
-  DNS6_CACHE  *Item6;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
+  DNS4_CACHE          *Item4;
+  DNS6_CACHE          *Item6;
+  DNS_NEGATIVE_CACHE  *ItemNegative;
 
   Item4 = NULL;
   Item6 = NULL;
@@ -2272,4 +2632,17 @@ DnsOnTimerUpdate (
       Entry = Entry->ForwardLink;
     }
   }
+
+  //
+  // Expire the negative answers.
+  //
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->DnsNegativeCacheList) {
+    ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    ItemNegative->Timeout--;
+    if (ItemNegative->Timeout == 0) {
+      RemoveEntryList (&ItemNegative->AllCacheLink);
+      FreePool (ItemNegative->HostName);
+      FreePool (ItemNegative);
+    }
+  }
 }
@@ -26,6 +26,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DpcLib.h>
 #include <Library/PrintLib.h>
 #include <Library/UdpIoLib.h>
+#include <Library/PcdLib.h>
 
 //
 // UEFI Driver Model Protocols
@@ -97,6 +98,14 @@ typedef struct {
   EFI_DNS6_CACHE_ENTRY    DnsCache;
 } DNS6_CACHE;
 
+typedef struct {
+  LIST_ENTRY    AllCacheLink;
+  CHAR16        *HostName;
+  UINT16        QueryType;            /// DNS_TYPE_ANY if the host name doesn't exist.
+  EFI_STATUS    Status;
+  UINT32        Timeout;
+} DNS_NEGATIVE_CACHE;
+
 typedef struct {
   LIST_ENTRY          AllServerLink;
   EFI_IPv4_ADDRESS    Dns4ServerIp;
@@ -113,6 +122,7 @@ typedef struct {
   CHAR16                       *QueryHostName;
   EFI_IPv4_ADDRESS             QueryIpAddress;
   BOOLEAN                      GeneralLookUp;
+  UINT32                       FailedServers; ///< Bit N is set when SessionDnsServers[N] failed.
   EFI_DNS4_COMPLETION_TOKEN    *Token;
 } DNS4_TOKEN_ENTRY;
 
@@ -122,6 +132,7 @@ typedef struct {
   CHAR16                       *QueryHostName;
   EFI_IPv6_ADDRESS             QueryIpAddress;
   BOOLEAN                      GeneralLookUp;
+  UINT32                       FailedServers; ///< Bit N is set when SessionDnsServers[N] failed.
   EFI_DNS6_COMPLETION_TOKEN    *Token;
 } DNS6_TOKEN_ENTRY;
 
@@ -515,6 +526,49 @@ UpdateDns6Cache (
   IN EFI_DNS6_CACHE_ENTRY  DnsCacheEntry
   );
 
+/**
+  Remember the negative answer to an address query in the shared negative
+  cache of all DNS instances, as described in RFC 2308.
+
+  The answer is kept for the TTL of the SOA record of its authority section,
+  bounded by PcdDnsNegativeCacheTimeout. An answer without SOA record is not
+  cached.
+
+  @param  HostName           The host name of the query.
+  @param  DnsHeader          The DNS response, header converted to host order.
+  @param  QuerySection       The query section of the DNS response, converted
+                             to host order.
+  @param  Length             The length of the DNS response.
+  @param  Status             The status the query completed with.
+
+**/
+VOID
+UpdateDnsNegativeCache (
+  IN CHAR16             *HostName,
+  IN DNS_HEADER         *DnsHeader,
+  IN DNS_QUERY_SECTION  *QuerySection,
+  IN UINT32             Length,
+  IN EFI_STATUS         Status
+  );
+
+/**
+  Look up the negative cache for an address query.
+
+  @param  HostName           The host name to query.
+  @param  QueryType          The type of the query, DNS_TYPE_A or DNS_TYPE_AAAA.
+  @param  Status             The status the cached query completed with.
+
+  @retval TRUE               The query has a cached negative answer.
+  @retval FALSE              The query has to be sent to the DNS server.
+
+**/
+BOOLEAN
+LookupDnsNegativeCache (
+  IN  CHAR16      *HostName,
+  IN  UINT16      QueryType,
+  OUT EFI_STATUS  *Status
+  );
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
@@ -577,6 +631,8 @@ IsValidDnsResponse (
   @param  Instance              The DNS instance
   @param  RxString              Received buffer.
   @param  Length                Received buffer length.
+  @param  ServerIndex           The index in SessionDnsServers of the server
+                                which sent the response.
   @param  Completed             Flag to indicate that Dns response is valid.
 
   @retval EFI_SUCCESS           Parse Dns Response successfully.
@@ -588,6 +644,7 @@ ParseDnsResponse (
   IN OUT DNS_INSTANCE  *Instance,
   IN     UINT8         *RxString,
   IN     UINT32        Length,
+  IN     UINTN         ServerIndex,
   OUT BOOLEAN          *Completed
   );
 
@@ -627,6 +684,25 @@ DnsOnPacketSent (
   VOID           *Context
   );
 
+/**
+  Set the DNS servers the queries of a DNS instance are sent to.
+
+  Up to DNS_MAX_PARALLEL_SERVERS servers of the list are used, in order.
+
+  @param  Instance              The DNS instance.
+  @param  ServerList            The EFI_IPv4_ADDRESS or EFI_IPv6_ADDRESS list
+                                of the servers, according to the IP version
+                                of the instance.
+  @param  ServerCount           The number of servers in ServerList, not 0.
+
+**/
+VOID
+DnsSetSessionServers (
+  IN DNS_INSTANCE  *Instance,
+  IN VOID          *ServerList,
+  IN UINTN         ServerCount
+  );
+
 /**
   Query request information.
 
@@ -188,6 +188,7 @@ Dns4Configure (
 
   UINT32            ServerListCount;
   EFI_IPv4_ADDRESS  *ServerList;
+  UINTN             Index;
 
   Status     = EFI_SUCCESS;
   ServerList = NULL;
@@ -209,6 +210,8 @@ Dns4Configure (
 
   if (DnsConfigData == NULL) {
     ZeroMem (&Instance->SessionDnsServer, sizeof (EFI_IP_ADDRESS));
+    ZeroMem (Instance->SessionDnsServers, sizeof (Instance->SessionDnsServers));
+    Instance->SessionDnsServerCount = 0;
 
     //
     // Reset the Instance if ConfigData is NULL
@@ -269,9 +272,10 @@ Dns4Configure (
 
       OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-      CopyMem (&Instance->SessionDnsServer.v4, &ServerList[0], sizeof (EFI_IPv4_ADDRESS));
+      DnsSetSessionServers (Instance, ServerList, ServerListCount);
+      FreePool (ServerList);
     } else {
-      CopyMem (&Instance->SessionDnsServer.v4, &DnsConfigData->DnsServerList[0], sizeof (EFI_IPv4_ADDRESS));
+      DnsSetSessionServers (Instance, DnsConfigData->DnsServerList, DnsConfigData->DnsServerListCount);
     }
 
     //
@@ -288,9 +292,15 @@ Dns4Configure (
     }
 
     //
-    // Add configured DNS server used by this instance to ServerList.
+    // Add configured DNS servers used by this instance to ServerList.
     //
-    Status = AddDns4ServerIp (&mDriverData->Dns4ServerList, Instance->SessionDnsServer.v4);
+    for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+      Status = AddDns4ServerIp (&mDriverData->Dns4ServerList, Instance->SessionDnsServers[Index].v4);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+
     if (EFI_ERROR (Status)) {
       if (Instance->Dns4CfgData.DnsServerList != NULL) {
         FreePool (Instance->Dns4CfgData.DnsServerList);
@@ -450,6 +460,19 @@ Dns4HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    //
+    // The host name is known to have no address, complete the token with
+    // the cached negative answer.
+    //
+    if (LookupDnsNegativeCache (HostName, DNS_TYPE_A, &Token->Status)) {
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      goto ON_EXIT;
+    }
   }
 
   //
@@ -1037,6 +1060,7 @@ Dns6Configure (
 
   UINT32            ServerListCount;
   EFI_IPv6_ADDRESS  *ServerList;
+  UINTN             Index;
 
   Status     = EFI_SUCCESS;
   ServerList = NULL;
@@ -1058,6 +1082,8 @@ Dns6Configure (
 
   if (DnsConfigData == NULL) {
     ZeroMem (&Instance->SessionDnsServer, sizeof (EFI_IP_ADDRESS));
+    ZeroMem (Instance->SessionDnsServers, sizeof (Instance->SessionDnsServers));
+    Instance->SessionDnsServerCount = 0;
 
     //
     // Reset the Instance if ConfigData is NULL
@@ -1111,9 +1137,10 @@ Dns6Configure (
 
       OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-      CopyMem (&Instance->SessionDnsServer.v6, &ServerList[0], sizeof (EFI_IPv6_ADDRESS));
+      DnsSetSessionServers (Instance, ServerList, ServerListCount);
+      FreePool (ServerList);
     } else {
-      CopyMem (&Instance->SessionDnsServer.v6, &DnsConfigData->DnsServerList[0], sizeof (EFI_IPv6_ADDRESS));
+      DnsSetSessionServers (Instance, DnsConfigData->DnsServerList, DnsConfigData->DnsServerCount);
     }
 
     //
@@ -1132,9 +1159,15 @@ Dns6Configure (
     }
 
     //
-    // Add configured DNS server used by this instance to ServerList.
+    // Add configured DNS servers used by this instance to ServerList.
     //
-    Status = AddDns6ServerIp (&mDriverData->Dns6ServerList, Instance->SessionDnsServer.v6);
+    for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+      Status = AddDns6ServerIp (&mDriverData->Dns6ServerList, Instance->SessionDnsServers[Index].v6);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+
     if (EFI_ERROR (Status)) {
       if (Instance->Dns6CfgData.DnsServerList != NULL) {
         FreePool (Instance->Dns6CfgData.DnsServerList);
@@ -1296,6 +1329,19 @@ Dns6HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    //
+    // The host name is known to have no address, complete the token with
+    // the cached negative answer.
+    //
+    if (LookupDnsNegativeCache (HostName, DNS_TYPE_AAAA, &Token->Status)) {
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      goto ON_EXIT;
+    }
   }
 
   //
@@ -597,21 +597,23 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create a HttpIo instance bound to the NIC and the station address of Private.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to initialize.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
+STATIC
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
@@ -636,15 +638,34 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           HttpBootHttpIoCallback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = HttpBootCreateHttpIoInstance (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -1804,3 +1825,583 @@ ERROR_1:
 
   return Status;
 }
+
+/**
+  Build the request headers of a connection of the parallel range download:
+  Host, Accept, User-Agent, [Authorization], [If-Match]|[If-Unmodified-Since]
+  and Range. The Range header is updated for every range requested.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[out]      HttpIoHeader    The created headers.
+
+  @retval EFI_SUCCESS              The headers were created.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_UNSUPPORTED          The authentication scheme isn't supported.
+  @retval Others                   Unexpected error happened.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeCreateHeaders (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO_HEADER          **HttpIoHeader
+  )
+{
+  EFI_STATUS      Status;
+  HTTP_IO_HEADER  *Header;
+  CHAR8           *HostName;
+  CHAR8           BaseAuthValue[80];
+  UINTN           HeadersCount;
+
+  HeadersCount = 4;
+  if (Private->AuthData != NULL) {
+    HeadersCount++;
+  }
+
+  if (Private->LastModifiedOrEtag != NULL) {
+    HeadersCount++;
+  }
+
+  Header = HttpIoCreateHeader (HeadersCount);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Private->AuthData != NULL) {
+    if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
+
+    AsciiSPrint (BaseAuthValue, sizeof (BaseAuthValue), "%a %a", "Basic", Private->AuthData);
+    Status = HttpIoSetHeader (Header, HTTP_HEADER_AUTHORIZATION, BaseAuthValue);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  //
+  // Make sure all the ranges come from the same version of the file.
+  //
+  if (Private->LastModifiedOrEtag != NULL) {
+    if (Private->LastModifiedOrEtag[0] == '"') {
+      Status = HttpIoSetHeader (Header, HTTP_HEADER_IF_MATCH, Private->LastModifiedOrEtag);
+    } else {
+      Status = HttpIoSetHeader (Header, HTTP_HEADER_IF_UNMODIFIED_SINCE, Private->LastModifiedOrEtag);
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  Status = HttpIoSetHeader (Header, "Range", "bytes=0-0");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
+/**
+  Check that the Content-Range header of a range response matches the range
+  requested on the connection and the size of the boot file.
+
+  @param[in]       Conn            The connection which received the response.
+  @param[in]       HeaderCount     Number of HTTP header structures in Headers.
+  @param[in]       Headers         Array containing list of HTTP headers.
+  @param[in]       FileSize        The size of the boot file.
+
+  @retval EFI_SUCCESS              The response carries the requested range.
+  @retval EFI_UNSUPPORTED          The response doesn't carry the requested range.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeCheckContentRange (
+  IN     HTTP_BOOT_RANGE_CONN  *Conn,
+  IN     UINTN                 HeaderCount,
+  IN     EFI_HTTP_HEADER       *Headers,
+  IN     UINTN                 FileSize
+  )
+{
+  EFI_HTTP_HEADER  *HttpHeader;
+  CHAR8            *Value;
+  UINTN            First;
+  UINTN            Last;
+  UINTN            Length;
+
+  //
+  // Content-Range: bytes <range-start>-<range-end>/<size>
+  //
+  HttpHeader = HttpFindHeader (HeaderCount, Headers, HTTP_HEADER_CONTENT_RANGE);
+  if ((HttpHeader == NULL) || (AsciiStrnCmp (HttpHeader->FieldValue, "bytes ", 6) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value = HttpHeader->FieldValue + 6;
+  if (EFI_ERROR (AsciiStrDecimalToUintnS (Value, &Value, &First)) || (*Value != '-')) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value++;
+  if (EFI_ERROR (AsciiStrDecimalToUintnS (Value, &Value, &Last)) || (*Value != '/')) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value++;
+  if (EFI_ERROR (AsciiStrDecimalToUintnS (Value, NULL, &Length))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((First != Conn->Offset) || (Last != Conn->End - 1) || (Length != FileSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue the response token of a connection of the parallel range download.
+
+  @param[in, out]  Conn            The connection.
+  @param[in]       Body            NULL to receive the response header, otherwise
+                                   the buffer to receive the rest of the range in.
+
+  @retval EFI_SUCCESS              The token was queued.
+  @retval Others                   Failed to queue the token.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeQueueResponse (
+  IN OUT HTTP_BOOT_RANGE_CONN  *Conn,
+  IN     UINT8                 *Body OPTIONAL
+  )
+{
+  HTTP_IO     *HttpIo;
+  EFI_STATUS  Status;
+
+  HttpIo                                = &Conn->HttpIo;
+  HttpIo->RspToken.Status               = EFI_NOT_READY;
+  HttpIo->RspToken.Message->HeaderCount = 0;
+  HttpIo->RspToken.Message->Headers     = NULL;
+  if (Body == NULL) {
+    ZeroMem (&Conn->Response, sizeof (Conn->Response));
+    HttpIo->RspToken.Message->Data.Response = &Conn->Response;
+    HttpIo->RspToken.Message->BodyLength    = 0;
+    HttpIo->RspToken.Message->Body          = NULL;
+  } else {
+    HttpIo->RspToken.Message->Data.Response = NULL;
+    HttpIo->RspToken.Message->BodyLength    = Conn->End - Conn->Offset;
+    HttpIo->RspToken.Message->Body          = Body + Conn->Offset;
+  }
+
+  HttpIo->IsRxDone = FALSE;
+  Status           = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Conn->State = (Body == NULL) ? HttpBootRangeHeader : HttpBootRangeBody;
+  return EFI_SUCCESS;
+}
+
+/**
+  Move a connection of the parallel range download forward without blocking:
+  assign it the next range of the file, or process the completion of its
+  pending token and queue the next one.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  Conn            The connection.
+  @param[in]       Buffer          The memory buffer to transfer the file to.
+  @param[in, out]  NextOffset      The offset of the first range not requested yet.
+  @param[in, out]  ImageType       The image type of the file, ImageTypeMax until
+                                   the first response is received.
+
+  @retval EFI_SUCCESS              The connection is progressing normally.
+  @retval EFI_UNSUPPORTED          The server didn't return the requested range.
+  @retval EFI_TIMEOUT              Data transfer has timed-out.
+  @retval Others                   Unexpected error happened.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeStep (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT HTTP_BOOT_RANGE_CONN    *Conn,
+  IN     UINT8                   *Buffer,
+  IN OUT UINTN                   *NextOffset,
+  IN OUT HTTP_BOOT_IMAGE_TYPE    *ImageType
+  )
+{
+  EFI_STATUS         Status;
+  HTTP_IO            *HttpIo;
+  EFI_HTTP_PROTOCOL  *Http;
+  EFI_HTTP_MESSAGE   *Message;
+  BOOLEAN            Done;
+  CHAR8              RangeValue[64];
+
+  HttpIo = &Conn->HttpIo;
+  Http   = HttpIo->Http;
+
+  if (Conn->State != HttpBootRangeIdle) {
+    Http->Poll (Http);
+    Done = (Conn->State == HttpBootRangeSending) ? HttpIo->IsTxDone : HttpIo->IsRxDone;
+    if (!Done) {
+      if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+        return EFI_TIMEOUT;
+      }
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  switch (Conn->State) {
+    case HttpBootRangeIdle:
+      if (*NextOffset >= Private->BootFileSize) {
+        break;
+      }
+
+      Conn->Offset = *NextOffset;
+      Conn->End    = MIN (Conn->Offset + PcdGet32 (PcdHttpBootRangeChunkSize), Private->BootFileSize);
+
+      AsciiSPrint (RangeValue, sizeof (RangeValue), "bytes=%lu-%lu", (UINT64)Conn->Offset, (UINT64)(Conn->End - 1));
+      Status = HttpIoSetHeader (Conn->Headers, "Range", RangeValue);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      HttpIo->ReqToken.Status                = EFI_NOT_READY;
+      HttpIo->ReqToken.Message->Data.Request = &Conn->Request;
+      HttpIo->ReqToken.Message->HeaderCount  = Conn->Headers->HeaderCount;
+      HttpIo->ReqToken.Message->Headers      = Conn->Headers->Headers;
+      HttpIo->ReqToken.Message->BodyLength   = 0;
+      HttpIo->ReqToken.Message->Body         = NULL;
+
+      //
+      // Show the URI once, with the request of the first range.
+      //
+      if (Conn->Offset == 0) {
+        Status = HttpBootHttpIoCallback (HttpIoRequest, HttpIo->ReqToken.Message, Private);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      }
+
+      HttpIo->IsTxDone = FALSE;
+      Status           = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Status = Http->Request (Http, &HttpIo->ReqToken);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      //
+      // Only claim the range once it is in flight. A range whose request
+      // failed is neither received nor tracked by a busy connection, so it
+      // must stay above NextOffset for the resume offset to be right.
+      //
+      Conn->State = HttpBootRangeSending;
+      *NextOffset = Conn->End;
+      break;
+
+    case HttpBootRangeSending:
+      if (EFI_ERROR (HttpIo->ReqToken.Status)) {
+        return HttpIo->ReqToken.Status;
+      }
+
+      return HttpBootRangeQueueResponse (Conn, NULL);
+
+    case HttpBootRangeHeader:
+      //
+      // Anything but a 206 response with the requested range, e.g. a 200
+      // response with the whole file, means the server doesn't do ranges.
+      //
+      Message = HttpIo->RspToken.Message;
+      Status  = HttpIo->RspToken.Status;
+      if ((Status == EFI_HTTP_ERROR) ||
+          (!EFI_ERROR (Status) && (Conn->Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT)))
+      {
+        Status = EFI_UNSUPPORTED;
+      }
+
+      if (!EFI_ERROR (Status)) {
+        Status = HttpBootRangeCheckContentRange (Conn, Message->HeaderCount, Message->Headers, Private->BootFileSize);
+      }
+
+      if (!EFI_ERROR (Status) && (*ImageType == ImageTypeMax)) {
+        Status = HttpBootCheckImageType (
+                   Private->BootFileUri,
+                   Private->BootFileUriParser,
+                   Message->HeaderCount,
+                   Message->Headers,
+                   ImageType
+                   );
+      }
+
+      if (Message->Headers != NULL) {
+        HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+        Message->Headers     = NULL;
+        Message->HeaderCount = 0;
+      }
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      return HttpBootRangeQueueResponse (Conn, Buffer);
+
+    case HttpBootRangeBody:
+      if (EFI_ERROR (HttpIo->RspToken.Status)) {
+        return HttpIo->RspToken.Status;
+      }
+
+      Message = HttpIo->RspToken.Message;
+      if (Private->HttpBootCallback != NULL) {
+        Status = Private->HttpBootCallback->Callback (
+                                              Private->HttpBootCallback,
+                                              HttpBootHttpEntityBody,
+                                              TRUE,
+                                              (UINT32)Message->BodyLength,
+                                              Buffer + Conn->Offset
+                                              );
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      }
+
+      Conn->Offset += Message->BodyLength;
+      if (Conn->Offset < Conn->End) {
+        return HttpBootRangeQueueResponse (Conn, Buffer);
+      }
+
+      gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+      Conn->State = HttpBootRangeIdle;
+      break;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Download the boot file over several HTTP connections in parallel, each
+  connection fetching PcdHttpBootRangeChunkSize bytes of the file at a time
+  with an HTTP Range request.
+
+  The size of the boot file must already be known in Private->BootFileSize.
+  If the download is interrupted by a timeout or a device error,
+  Private->PartialTransferredSize is set to the size of the contiguous data
+  received from the beginning of the file, so that HttpBootGetBootFile() can
+  resume the download over a single connection.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The parallel download is disabled, the file is too small
+                                   for it, or the server doesn't honor range requests. The
+                                   caller should download the file with HttpBootGetBootFile().
+  @retval EFI_TIMEOUT              Data transfer has timed-out.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  )
+{
+  EFI_STATUS            Status;
+  HTTP_BOOT_RANGE_CONN  *Conns;
+  HTTP_BOOT_RANGE_CONN  *Conn;
+  UINTN                 ConnCount;
+  UINTN                 Created;
+  UINTN                 Index;
+  UINTN                 ChunkSize;
+  UINTN                 NextOffset;
+  UINTN                 Received;
+  BOOLEAN               Busy;
+  CHAR16                *Url;
+  UINTN                 UrlSize;
+  HTTP_BOOT_IMAGE_TYPE  Type;
+
+  ASSERT (Private != NULL);
+
+  if ((BufferSize == NULL) || (Buffer == NULL) || (ImageType == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Splitting the file only pays off if every connection gets at least
+  // one full range.
+  //
+  ConnCount = PcdGet8 (PcdHttpBootRangeConnections);
+  ChunkSize = PcdGet32 (PcdHttpBootRangeChunkSize);
+  if ((ConnCount < 2) || (ChunkSize == 0) ||
+      (Private->BootFileSize / 2 < ChunkSize) || (*BufferSize < Private->BootFileSize))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  ConnCount = MIN (ConnCount, (Private->BootFileSize + ChunkSize - 1) / ChunkSize);
+
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+
+  Conns = AllocateZeroPool (ConnCount * sizeof (HTTP_BOOT_RANGE_CONN));
+  if (Conns == NULL) {
+    FreePool (Url);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Open the connections. Private->HttpIo is left alone, it is used to
+  // fall back to, or to resume, a single connection download.
+  //
+  for (Created = 0; Created < ConnCount; Created++) {
+    Conn   = &Conns[Created];
+    Status = HttpBootRangeCreateHeaders (Private, &Conn->Headers);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Status = HttpBootCreateHttpIoInstance (Private, &Conn->HttpIo);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Conn->Created        = TRUE;
+    Conn->State          = HttpBootRangeIdle;
+    Conn->Request.Method = HttpMethodGet;
+    Conn->Request.Url    = Url;
+  }
+
+  if (Created < 2) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  DEBUG ((DEBUG_INFO, "HttpBootGetBootFileByRanges: %d connections, %d bytes per range.\n", Created, ChunkSize));
+
+  //
+  // Poll all the connections until every range has been received.
+  //
+  NextOffset = 0;
+  Type       = ImageTypeMax;
+  do {
+    Busy = FALSE;
+    for (Index = 0; Index < Created; Index++) {
+      Status = HttpBootRangeStep (Private, &Conns[Index], Buffer, &NextOffset, &Type);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      if (Conns[Index].State != HttpBootRangeIdle) {
+        Busy = TRUE;
+      }
+    }
+  } while (Busy);
+
+  *BufferSize                     = Private->BootFileSize;
+  *ImageType                      = Type;
+  Private->PartialTransferredSize = 0;
+  Status                          = EFI_SUCCESS;
+
+ON_EXIT:
+  if (((Status == EFI_TIMEOUT) || (Status == EFI_DEVICE_ERROR)) && (*BufferSize == Private->BootFileSize)) {
+    //
+    // Everything below the lowest range still in flight has been received,
+    // let the single connection download resume from there. HttpBootGetBootFile()
+    // only resumes into a buffer of the exact size of the file.
+    //
+    Received = NextOffset;
+    for (Index = 0; Index < Created; Index++) {
+      if (Conns[Index].State != HttpBootRangeIdle) {
+        Received = MIN (Received, Conns[Index].Offset);
+      }
+    }
+
+    Private->PartialTransferredSize = Received;
+    DEBUG ((
+      DEBUG_WARN | DEBUG_INFO,
+      "HttpBootGetBootFileByRanges: Transfer error. Bytes transferred so far: %lu.\n",
+      (UINT64)Received
+      ));
+  }
+
+  for (Index = 0; Index < ConnCount; Index++) {
+    Conn = &Conns[Index];
+    if (Conn->Created) {
+      if (Conn->State != HttpBootRangeIdle) {
+        //
+        // Abort the pending tokens, and run their notify DPCs before the
+        // connection they point to is freed.
+        //
+        Conn->HttpIo.Http->Cancel (Conn->HttpIo.Http, NULL);
+        DispatchDpc ();
+      }
+
+      HttpIoDestroyIo (&Conn->HttpIo);
+    }
+
+    if (Conn->Headers != NULL) {
+      HttpIoFreeHeader (Conn->Headers);
+    }
+  }
+
+  FreePool (Conns);
+  FreePool (Url);
+  return Status;
+}
@@ -58,6 +58,31 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// State of a connection used by the parallel range download.
+//
+typedef enum {
+  HttpBootRangeIdle,                      // No range assigned.
+  HttpBootRangeSending,                   // GET request queued.
+  HttpBootRangeHeader,                    // Waiting for the response header.
+  HttpBootRangeBody                       // Receiving the message-body.
+} HTTP_BOOT_RANGE_STATE;
+
+//
+// A connection of the parallel range download, each one fetches a
+// [Offset, End) byte range of the boot file at a time.
+//
+typedef struct {
+  HTTP_IO                   HttpIo;
+  BOOLEAN                   Created;
+  HTTP_BOOT_RANGE_STATE     State;
+  HTTP_IO_HEADER            *Headers;
+  EFI_HTTP_REQUEST_DATA     Request;
+  EFI_HTTP_RESPONSE_DATA    Response;
+  UINTN                     Offset;       // Next byte to receive.
+  UINTN                     End;          // End of the range, exclusive.
+} HTTP_BOOT_RANGE_CONN;
+
 /**
   Discover all the boot information for boot file.
 
@@ -136,6 +161,41 @@ HttpBootGetBootFile (
   OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
   );
 
+/**
+  Download the boot file over several HTTP connections in parallel, each
+  connection fetching PcdHttpBootRangeChunkSize bytes of the file at a time
+  with an HTTP Range request.
+
+  The size of the boot file must already be known in Private->BootFileSize.
+  If the download is interrupted by a timeout or a device error,
+  Private->PartialTransferredSize is set to the size of the contiguous data
+  received from the beginning of the file, so that HttpBootGetBootFile() can
+  resume the download over a single connection.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The parallel download is disabled, the file is too small
+                                   for it, or the server doesn't honor range requests. The
+                                   caller should download the file with HttpBootGetBootFile().
+  @retval EFI_TIMEOUT              Data transfer has timed-out.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  );
+
 /**
   Clean up all cached data.
 
@@ -394,6 +394,23 @@ HttpBootGetBootFileCaller (
           return Status;
         }
 
+        //
+        // Try to load the boot file over parallel range connections first.
+        // If the server doesn't honor ranges, use a single connection. If
+        // the transfer is interrupted, resume it over a single connection.
+        //
+        if ((PcdGet8 (PcdHttpBootRangeConnections) > 1) &&
+            (Buffer != NULL) &&
+            (Private->ProxyUri == NULL) &&
+            (Private->PartialTransferredSize == 0) &&
+            IsListEmpty (&Private->CacheList))
+        {
+          Status = HttpBootGetBootFileByRanges (Private, BufferSize, Buffer, ImageType);
+          if ((Status != EFI_UNSUPPORTED) && (Status != EFI_TIMEOUT) && (Status != EFI_DEVICE_ERROR)) {
+            return Status;
+          }
+        }
+
         //
         // Load the boot file into Buffer
         //
@@ -0,0 +1,532 @@
+/** @file
+  Keep-alive connection pool of the HttpDxe driver.
+
+  Consumers such as DxeHttpIoLib create an HTTP child, send one request and
+  destroy the child again, so every request used to pay for a new TCP
+  connection and a DNS lookup. When an HTTP instance is reset or destroyed
+  with an idle HTTP/1.1 keep-alive connection, the TCP child is handed over
+  to a pool of the HTTP service instead of being closed, and the next HTTP
+  instance which talks to the same server, through the same local access
+  point, takes it over. Up to PcdHttpConnectionPoolSize connections are
+  kept, and a connection is closed after PcdHttpConnectionIdleTimeout
+  seconds in the pool.
+
+  Only plain HTTP connections are pooled: the TLS child of an HTTPS
+  connection is installed on the handle of its HTTP instance, where the
+  consumers of the HTTP protocol can find it, so it can't be moved to
+  another HTTP instance.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpDriver.h"
+
+/**
+  Destroy a TCP child of an HTTP service, which aborts its connection.
+
+  @param[in]  HttpService        The HTTP private instance.
+  @param[in]  UsingIpv6          TRUE for a TCP6 child, FALSE for a TCP4 child.
+  @param[in]  TcpChildHandle     The handle of the TCP child.
+
+**/
+STATIC
+VOID
+HttpConnPoolDestroyTcpChild (
+  IN HTTP_SERVICE  *HttpService,
+  IN BOOLEAN       UsingIpv6,
+  IN EFI_HANDLE    TcpChildHandle
+  )
+{
+  if (!UsingIpv6) {
+    gBS->CloseProtocol (
+           TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      TcpChildHandle
+      );
+  } else {
+    gBS->CloseProtocol (
+           TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      TcpChildHandle
+      );
+  }
+}
+
+/**
+  Remove a connection from the connection pool and close it.
+
+  @param[in]  HttpService        The HTTP private instance.
+  @param[in]  Entry              The pooled connection.
+
+**/
+STATIC
+VOID
+HttpConnPoolDestroy (
+  IN HTTP_SERVICE          *HttpService,
+  IN HTTP_CONN_POOL_ENTRY  *Entry
+  )
+{
+  RemoveEntryList (&Entry->Link);
+  HttpService->ConnPoolCount--;
+
+  HttpConnPoolDestroyTcpChild (HttpService, Entry->LocalAddressIsIPv6, Entry->TcpChildHandle);
+
+  FreePool (Entry->RemoteHost);
+  FreePool (Entry);
+}
+
+/**
+  Account the idle time of the pooled connections, and close the ones
+  which reached PcdHttpConnectionIdleTimeout.
+
+  @param[in]  Event              The pool timer event.
+  @param[in]  Context            The HTTP private instance.
+
+**/
+STATIC
+VOID
+EFIAPI
+HttpConnPoolTimerTick (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  HTTP_SERVICE          *HttpService;
+  LIST_ENTRY            *Link;
+  LIST_ENTRY            *Next;
+  HTTP_CONN_POOL_ENTRY  *Entry;
+
+  HttpService = (HTTP_SERVICE *)Context;
+
+  NET_LIST_FOR_EACH_SAFE (Link, Next, &HttpService->ConnPool) {
+    Entry = NET_LIST_USER_STRUCT (Link, HTTP_CONN_POOL_ENTRY, Link);
+    Entry->IdleTime++;
+    if (Entry->IdleTime >= PcdGet32 (PcdHttpConnectionIdleTimeout)) {
+      DEBUG ((DEBUG_INFO, "HttpConnPool: closing idle connection to %a:%d\n", Entry->RemoteHost, Entry->RemotePort));
+      HttpConnPoolDestroy (HttpService, Entry);
+    }
+  }
+
+  if (IsListEmpty (&HttpService->ConnPool)) {
+    gBS->SetTimer (Event, TimerCancel, 0);
+  }
+}
+
+/**
+  Check whether the TCP connection of an HTTP instance is established.
+
+  @param[in]  UsingIpv6          TRUE for a TCP6 child, FALSE for a TCP4 child.
+  @param[in]  Tcp4               The TCP4 protocol of the connection.
+  @param[in]  Tcp6               The TCP6 protocol of the connection.
+
+  @retval TRUE                   The connection is established.
+  @retval FALSE                  The connection is closing or closed.
+
+**/
+STATIC
+BOOLEAN
+HttpConnPoolIsEstablished (
+  IN BOOLEAN            UsingIpv6,
+  IN EFI_TCP4_PROTOCOL  *Tcp4,
+  IN EFI_TCP6_PROTOCOL  *Tcp6
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+
+  if (!UsingIpv6) {
+    Status = Tcp4->GetModeData (Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+    return (BOOLEAN)(!EFI_ERROR (Status) && (Tcp4State == Tcp4StateEstablished));
+  }
+
+  Status = Tcp6->GetModeData (Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+  return (BOOLEAN)(!EFI_ERROR (Status) && (Tcp6State == Tcp6StateEstablished));
+}
+
+/**
+  Move the connection of an HTTP instance which is being reset or destroyed
+  to the connection pool of the HTTP service, if it can carry more requests.
+
+  On success the TCP child of the HTTP instance is detached from it, and
+  HttpInstance->State is set to HTTP_STATE_TCP_CLOSED.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+
+**/
+VOID
+HttpConnPoolPark (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTP_SERVICE          *HttpService;
+  HTTP_CONN_POOL_ENTRY  *Entry;
+  EFI_STATUS            Status;
+  EFI_TPL               OldTpl;
+
+  HttpService = HttpInstance->Service;
+
+  //
+  // The connection must be idle: every request got its response, and the
+  // whole response was read, so that the next byte the server sends
+  // belongs to the response to the next request.
+  //
+  if ((PcdGet32 (PcdHttpConnectionPoolSize) == 0) ||
+      (HttpInstance->State != HTTP_STATE_TCP_CONNECTED) ||
+      (HttpInstance->RemoteHost == NULL) ||
+      HttpInstance->UseHttps ||
+      HttpInstance->ProxyConnected ||
+      HttpInstance->ConnectionClose ||
+      (NetMapGetCount (&HttpInstance->TxTokens) != 0) ||
+      (NetMapGetCount (&HttpInstance->RxTokens) != 0) ||
+      (HttpInstance->CacheBody != NULL) ||
+      (HttpInstance->MsgParser != NULL))
+  {
+    return;
+  }
+
+  if (!HttpConnPoolIsEstablished (HttpInstance->LocalAddressIsIPv6, HttpInstance->Tcp4, HttpInstance->Tcp6)) {
+    return;
+  }
+
+  if (HttpService->ConnPoolTimer == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    HttpConnPoolTimerTick,
+                    HttpService,
+                    &HttpService->ConnPoolTimer
+                    );
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+  }
+
+  Entry = AllocateZeroPool (sizeof (HTTP_CONN_POOL_ENTRY));
+  if (Entry == NULL) {
+    return;
+  }
+
+  Entry->RemoteHost = AllocateCopyPool (AsciiStrSize (HttpInstance->RemoteHost), HttpInstance->RemoteHost);
+  if (Entry->RemoteHost == NULL) {
+    FreePool (Entry);
+    return;
+  }
+
+  Entry->LocalAddressIsIPv6 = HttpInstance->LocalAddressIsIPv6;
+  Entry->RemotePort         = HttpInstance->RemotePort;
+
+  //
+  // Detach the TCP child from the HTTP instance.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    CopyMem (&Entry->IPv4Node, &HttpInstance->IPv4Node, sizeof (Entry->IPv4Node));
+    IP4_COPY_ADDRESS (&Entry->RemoteAddr, &HttpInstance->RemoteAddr);
+    CopyMem (&Entry->Tcp4CfgData, &HttpInstance->Tcp4CfgData, sizeof (Entry->Tcp4CfgData));
+    CopyMem (&Entry->Tcp4Option, &HttpInstance->Tcp4Option, sizeof (Entry->Tcp4Option));
+    Entry->Tcp4CfgData.ControlOption = &Entry->Tcp4Option;
+    Entry->Tcp4                      = HttpInstance->Tcp4;
+    Entry->TcpChildHandle            = HttpInstance->Tcp4ChildHandle;
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+  } else {
+    CopyMem (&Entry->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Entry->Ipv6Node));
+    IP6_COPY_ADDRESS (&Entry->RemoteIpv6Addr, &HttpInstance->RemoteIpv6Addr);
+    CopyMem (&Entry->Tcp6CfgData, &HttpInstance->Tcp6CfgData, sizeof (Entry->Tcp6CfgData));
+    CopyMem (&Entry->Tcp6Option, &HttpInstance->Tcp6Option, sizeof (Entry->Tcp6Option));
+    Entry->Tcp6CfgData.ControlOption = &Entry->Tcp6Option;
+    Entry->Tcp6                      = HttpInstance->Tcp6;
+    Entry->TcpChildHandle            = HttpInstance->Tcp6ChildHandle;
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+  }
+
+  HttpInstance->State = HTTP_STATE_TCP_CLOSED;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  InsertHeadList (&HttpService->ConnPool, &Entry->Link);
+  HttpService->ConnPoolCount++;
+
+  //
+  // Evict the connections which have been idle for the longest time.
+  //
+  while (HttpService->ConnPoolCount > PcdGet32 (PcdHttpConnectionPoolSize)) {
+    HttpConnPoolDestroy (
+      HttpService,
+      NET_LIST_USER_STRUCT (HttpService->ConnPool.BackLink, HTTP_CONN_POOL_ENTRY, Link)
+      );
+  }
+
+  gBS->SetTimer (HttpService->ConnPoolTimer, TimerPeriodic, HTTP_CONN_POOL_TICK);
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Take the pooled connection of an HTTP instance's server out of the
+  connection pool.
+
+  On success the address of the server is copied to HttpInstance, and the
+  returned connection must be passed to HttpConnPoolAdopt().
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+  @param[in]       HostName       The host name of the server.
+  @param[in]       RemotePort     The port of the server.
+
+  @return The pooled connection, or NULL if there is none.
+
+**/
+HTTP_CONN_POOL_ENTRY *
+HttpConnPoolTake (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     CHAR8          *HostName,
+  IN     UINT16         RemotePort
+  )
+{
+  HTTP_SERVICE          *HttpService;
+  LIST_ENTRY            *Link;
+  LIST_ENTRY            *Next;
+  HTTP_CONN_POOL_ENTRY  *Entry;
+  HTTP_CONN_POOL_ENTRY  *Found;
+  EFI_TPL               OldTpl;
+
+  HttpService = HttpInstance->Service;
+
+  if (HttpInstance->UseHttps || HttpInstance->ProxyConnected ||
+      (HttpInstance->Method == HttpMethodConnect))
+  {
+    return NULL;
+  }
+
+  Found  = NULL;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  NET_LIST_FOR_EACH_SAFE (Link, Next, &HttpService->ConnPool) {
+    Entry = NET_LIST_USER_STRUCT (Link, HTTP_CONN_POOL_ENTRY, Link);
+
+    if ((Entry->LocalAddressIsIPv6 != HttpInstance->LocalAddressIsIPv6) ||
+        (Entry->RemotePort != RemotePort) ||
+        (AsciiStrCmp (Entry->RemoteHost, HostName) != 0))
+    {
+      continue;
+    }
+
+    if (!Entry->LocalAddressIsIPv6) {
+      if ((Entry->IPv4Node.UseDefaultAddress != HttpInstance->IPv4Node.UseDefaultAddress) ||
+          (Entry->IPv4Node.LocalPort != HttpInstance->IPv4Node.LocalPort) ||
+          (!Entry->IPv4Node.UseDefaultAddress &&
+           (!EFI_IP4_EQUAL (&Entry->IPv4Node.LocalAddress, &HttpInstance->IPv4Node.LocalAddress) ||
+            !EFI_IP4_EQUAL (&Entry->IPv4Node.LocalSubnet, &HttpInstance->IPv4Node.LocalSubnet))))
+      {
+        continue;
+      }
+    } else {
+      if ((Entry->Ipv6Node.LocalPort != HttpInstance->Ipv6Node.LocalPort) ||
+          !EFI_IP6_EQUAL (&Entry->Ipv6Node.LocalAddress, &HttpInstance->Ipv6Node.LocalAddress))
+      {
+        continue;
+      }
+    }
+
+    //
+    // The server may have closed the connection while it was idle.
+    //
+    if (!HttpConnPoolIsEstablished (Entry->LocalAddressIsIPv6, Entry->Tcp4, Entry->Tcp6)) {
+      HttpConnPoolDestroy (HttpService, Entry);
+      continue;
+    }
+
+    RemoveEntryList (&Entry->Link);
+    HttpService->ConnPoolCount--;
+    Found = Entry;
+    break;
+  }
+
+  if (IsListEmpty (&HttpService->ConnPool) && (HttpService->ConnPoolTimer != NULL)) {
+    gBS->SetTimer (HttpService->ConnPoolTimer, TimerCancel, 0);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Found != NULL) {
+    if (!Found->LocalAddressIsIPv6) {
+      IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &Found->RemoteAddr);
+    } else {
+      IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &Found->RemoteIpv6Addr);
+    }
+  }
+
+  return Found;
+}
+
+/**
+  Replace the TCP child of an HTTP instance with the connection returned by
+  HttpConnPoolTake(), which is released.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+  @param[in]       Entry          The pooled connection.
+
+  @retval EFI_SUCCESS            The HTTP instance is connected to its server.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnPoolAdopt (
+  IN OUT HTTP_PROTOCOL         *HttpInstance,
+  IN     HTTP_CONN_POOL_ENTRY  *Entry
+  )
+{
+  HTTP_SERVICE  *HttpService;
+  EFI_STATUS    Status;
+  VOID          *Interface;
+
+  HttpService = HttpInstance->Service;
+
+  if (!Entry->LocalAddressIsIPv6) {
+    Status = gBS->OpenProtocol (
+                    Entry->TcpChildHandle,
+                    &gEfiTcp4ProtocolGuid,
+                    &Interface,
+                    HttpService->Ip4DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  } else {
+    Status = gBS->OpenProtocol (
+                    Entry->TcpChildHandle,
+                    &gEfiTcp6ProtocolGuid,
+                    &Interface,
+                    HttpService->Ip6DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  }
+
+  if (EFI_ERROR (Status)) {
+    HttpConnPoolDestroyTcpChild (HttpService, Entry->LocalAddressIsIPv6, Entry->TcpChildHandle);
+    FreePool (Entry->RemoteHost);
+    FreePool (Entry);
+    return Status;
+  }
+
+  //
+  // Destroy the unused TCP child of the HTTP instance, and put the pooled
+  // connection in its place.
+  //
+  if (!Entry->LocalAddressIsIPv6) {
+    if (HttpInstance->Tcp4ChildHandle != NULL) {
+      gBS->CloseProtocol (
+             HttpInstance->Tcp4ChildHandle,
+             &gEfiTcp4ProtocolGuid,
+             HttpService->Ip4DriverBindingHandle,
+             HttpInstance->Handle
+             );
+
+      HttpConnPoolDestroyTcpChild (HttpService, FALSE, HttpInstance->Tcp4ChildHandle);
+    }
+
+    HttpInstance->Tcp4ChildHandle = Entry->TcpChildHandle;
+    HttpInstance->Tcp4            = Entry->Tcp4;
+    CopyMem (&HttpInstance->Tcp4CfgData, &Entry->Tcp4CfgData, sizeof (HttpInstance->Tcp4CfgData));
+    CopyMem (&HttpInstance->Tcp4Option, &Entry->Tcp4Option, sizeof (HttpInstance->Tcp4Option));
+    HttpInstance->Tcp4CfgData.ControlOption = &HttpInstance->Tcp4Option;
+  } else {
+    if (HttpInstance->Tcp6ChildHandle != NULL) {
+      gBS->CloseProtocol (
+             HttpInstance->Tcp6ChildHandle,
+             &gEfiTcp6ProtocolGuid,
+             HttpService->Ip6DriverBindingHandle,
+             HttpInstance->Handle
+             );
+
+      HttpConnPoolDestroyTcpChild (HttpService, TRUE, HttpInstance->Tcp6ChildHandle);
+    }
+
+    HttpInstance->Tcp6ChildHandle = Entry->TcpChildHandle;
+    HttpInstance->Tcp6            = Entry->Tcp6;
+    CopyMem (&HttpInstance->Tcp6CfgData, &Entry->Tcp6CfgData, sizeof (HttpInstance->Tcp6CfgData));
+    CopyMem (&HttpInstance->Tcp6Option, &Entry->Tcp6Option, sizeof (HttpInstance->Tcp6Option));
+    HttpInstance->Tcp6CfgData.ControlOption = &HttpInstance->Tcp6Option;
+  }
+
+  HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+
+  DEBUG ((DEBUG_INFO, "HttpConnPool: reusing connection to %a:%d\n", Entry->RemoteHost, Entry->RemotePort));
+
+  FreePool (Entry->RemoteHost);
+  FreePool (Entry);
+
+  HttpCloseTcpConnCloseEvent (HttpInstance);
+  return HttpCreateTcpConnCloseEvent (HttpInstance);
+}
+
+/**
+  Close the pooled connections of an HTTP service which use one IP version.
+
+  @param[in]  HttpService        The HTTP private instance.
+  @param[in]  UsingIpv6          TRUE to close the TCP6 connections,
+                                 FALSE to close the TCP4 connections.
+
+**/
+VOID
+HttpConnPoolFlush (
+  IN HTTP_SERVICE  *HttpService,
+  IN BOOLEAN       UsingIpv6
+  )
+{
+  LIST_ENTRY            *Link;
+  LIST_ENTRY            *Next;
+  HTTP_CONN_POOL_ENTRY  *Entry;
+  EFI_TPL               OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  NET_LIST_FOR_EACH_SAFE (Link, Next, &HttpService->ConnPool) {
+    Entry = NET_LIST_USER_STRUCT (Link, HTTP_CONN_POOL_ENTRY, Link);
+    if (Entry->LocalAddressIsIPv6 == UsingIpv6) {
+      HttpConnPoolDestroy (HttpService, Entry);
+    }
+  }
+
+  if (IsListEmpty (&HttpService->ConnPool) && (HttpService->ConnPoolTimer != NULL)) {
+    gBS->CloseEvent (HttpService->ConnPoolTimer);
+    HttpService->ConnPoolTimer = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
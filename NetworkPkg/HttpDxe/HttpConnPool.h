@@ -0,0 +1,114 @@
+/** @file
+  The header file of the keep-alive connection pool of the HttpDxe driver.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EFI_HTTP_CONN_POOL_H__
+#define __EFI_HTTP_CONN_POOL_H__
+
+//
+// The idle time of the pooled connections is accounted every second.
+//
+#define HTTP_CONN_POOL_TICK  TICKS_PER_SECOND
+
+///
+/// An idle keep-alive connection released by an HTTP instance, ready to be
+/// taken over by the next HTTP instance which talks to the same server.
+///
+typedef struct {
+  LIST_ENTRY                 Link;
+
+  BOOLEAN                    LocalAddressIsIPv6;
+  EFI_HTTPv4_ACCESS_POINT    IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT    Ipv6Node;
+
+  CHAR8                      *RemoteHost;
+  UINT16                     RemotePort;
+  EFI_IPv4_ADDRESS           RemoteAddr;
+  EFI_IPv6_ADDRESS           RemoteIpv6Addr;
+
+  EFI_HANDLE                 TcpChildHandle;
+  EFI_TCP4_PROTOCOL          *Tcp4;
+  EFI_TCP4_CONFIG_DATA       Tcp4CfgData;
+  EFI_TCP4_OPTION            Tcp4Option;
+  EFI_TCP6_PROTOCOL          *Tcp6;
+  EFI_TCP6_CONFIG_DATA       Tcp6CfgData;
+  EFI_TCP6_OPTION            Tcp6Option;
+
+  //
+  // Seconds spent in the pool.
+  //
+  UINT32                     IdleTime;
+} HTTP_CONN_POOL_ENTRY;
+
+/**
+  Move the connection of an HTTP instance which is being reset or destroyed
+  to the connection pool of the HTTP service, if it can carry more requests.
+
+  On success the TCP child of the HTTP instance is detached from it, and
+  HttpInstance->State is set to HTTP_STATE_TCP_CLOSED.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+
+**/
+VOID
+HttpConnPoolPark (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Take the pooled connection of an HTTP instance's server out of the
+  connection pool.
+
+  On success the address of the server is copied to HttpInstance, and the
+  returned connection must be passed to HttpConnPoolAdopt().
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+  @param[in]       HostName       The host name of the server.
+  @param[in]       RemotePort     The port of the server.
+
+  @return The pooled connection, or NULL if there is none.
+
+**/
+HTTP_CONN_POOL_ENTRY *
+HttpConnPoolTake (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     CHAR8          *HostName,
+  IN     UINT16         RemotePort
+  );
+
+/**
+  Replace the TCP child of an HTTP instance with the connection returned by
+  HttpConnPoolTake(), which is released.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+  @param[in]       Entry          The pooled connection.
+
+  @retval EFI_SUCCESS            The HTTP instance is connected to its server.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnPoolAdopt (
+  IN OUT HTTP_PROTOCOL         *HttpInstance,
+  IN     HTTP_CONN_POOL_ENTRY  *Entry
+  );
+
+/**
+  Close the pooled connections of an HTTP service which use one IP version.
+
+  @param[in]  HttpService        The HTTP private instance.
+  @param[in]  UsingIpv6          TRUE to close the TCP6 connections,
+                                 FALSE to close the TCP4 connections.
+
+**/
+VOID
+HttpConnPoolFlush (
+  IN HTTP_SERVICE  *HttpService,
+  IN BOOLEAN       UsingIpv6
+  );
+
+#endif
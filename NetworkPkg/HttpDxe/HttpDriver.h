@@ -51,6 +51,7 @@
 #include <Protocol/Tls.h>
 #include <Protocol/TlsConfig.h>
 #include <Protocol/HttpCallback.h>
+#include <Protocol/TlsSessionCache.h>
 
 #include <Guid/ImageAuthentication.h>
 //
@@ -88,6 +89,7 @@ extern EFI_HTTP_UTILITIES_PROTOCOL  *mHttpUtilities;
 #include "HttpProto.h"
 #include "HttpsSupport.h"
 #include "HttpDns.h"
+#include "HttpConnPool.h"
 
 typedef struct {
   EFI_SERVICE_BINDING_PROTOCOL    *ServiceBinding;
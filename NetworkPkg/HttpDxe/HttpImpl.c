@@ -257,6 +257,7 @@ EfiHttpRequest (
   UINT16                         EndPointRemotePort;
   CHAR8                          *EndPointUrlMsg;
   EFI_HTTP_CONNECT_REQUEST_DATA  *ConnRequest;
+  HTTP_CONN_POOL_ENTRY           *Pooled;
 
   //
   // Initializations
@@ -275,6 +276,7 @@ EfiHttpRequest (
   EndPointUrlMsg     = NULL;
   EndPointRemotePort = 0;
   ConnRequest        = NULL;
+  Pooled             = NULL;
 
   if ((This == NULL) || (Token == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -567,9 +569,14 @@ EfiHttpRequest (
 
   if (Configure) {
     //
-    // Parse Url for IPv4 or IPv6 address, if failed, perform DNS resolution.
+    // Take over an idle connection to the server released by another HTTP
+    // instance, it already knows the server address. Otherwise parse Url
+    // for IPv4 or IPv6 address, if failed, perform DNS resolution.
     //
-    if (!HttpInstance->LocalAddressIsIPv6) {
+    Pooled = HttpConnPoolTake (HttpInstance, HostName, RemotePort);
+    if (Pooled != NULL) {
+      Status = EFI_SUCCESS;
+    } else if (!HttpInstance->LocalAddressIsIPv6) {
       Status = NetLibAsciiStrToIp4 (HostName, &HttpInstance->RemoteAddr);
     } else {
       Status = HttpUrlGetIp6 (ParseUrl, UrlParser, &HttpInstance->RemoteIpv6Addr);
@@ -631,6 +638,19 @@ EfiHttpRequest (
     EfiHttpCancel (This, NULL);
   }
 
+  if (Pooled != NULL) {
+    //
+    // The pooled connection is configured and connected already.
+    //
+    Status = HttpConnPoolAdopt (HttpInstance, Pooled);
+    if (EFI_ERROR (Status)) {
+      goto Error1;
+    }
+
+    Configure   = FALSE;
+    ReConfigure = FALSE;
+  }
+
   //
   // Wrap the HTTP token in HTTP_TOKEN_WRAP
   //
@@ -697,6 +717,8 @@ EfiHttpRequest (
       }
     }
 
+    HttpInstance->EndPointRemotePort = EndPointRemotePort;
+
     EndPointUrlMsg = AllocateZeroPool (URI_STR_MAX_SIZE);
     if (EndPointUrlMsg == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
@@ -1620,6 +1642,12 @@ Error:
     HttpInstance->CacheBody = NULL;
   }
 
+  //
+  // The rest of the response may still arrive, the connection can't carry
+  // another request.
+  //
+  HttpInstance->ConnectionClose = TRUE;
+
   if (HttpInstance->StatusCode >= HTTP_ERROR_OR_NOT_SUPPORT_STATUS_CODE) {
     Token->Status = EFI_HTTP_ERROR;
   } else {
@@ -822,6 +822,12 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL  *HttpInstance
   )
 {
+  //
+  // Hand an idle keep-alive connection over to the next HTTP instance
+  // which talks to the same server, rather than closing it.
+  //
+  HttpConnPoolPark (HttpInstance);
+
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -864,7 +870,8 @@ HttpCleanProtocol (
     HttpInstance->EndPointHostName = NULL;
   }
 
-  HttpInstance->ProxyConnected = FALSE;
+  HttpInstance->EndPointRemotePort = 0;
+  HttpInstance->ProxyConnected     = FALSE;
 
   NetMapClean (&HttpInstance->TxTokens);
   NetMapClean (&HttpInstance->RxTokens);
@@ -1102,6 +1109,7 @@ HttpConfigureTcp4 (
   Tcp4Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp4Option->EnableNagle         = TRUE;
   Tcp4Option->EnableWindowScaling = TRUE;
+  Tcp4Option->EnableSelectiveAck  = TRUE;
   Tcp4CfgData->ControlOption      = Tcp4Option;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
@@ -1186,6 +1194,7 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle         = TRUE;
   Tcp6Option->EnableWindowScaling = TRUE;
+  Tcp6Option->EnableSelectiveAck  = TRUE;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
       (HttpInstance->State == HTTP_STATE_TCP_CLOSED))
@@ -60,6 +60,13 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                      ChildrenList;
   UINTN                           ChildrenNumber;
   INTN                            State;
+
+  //
+  // Idle keep-alive connections, most recently released first.
+  //
+  LIST_ENTRY                      ConnPool;
+  UINTN                           ConnPoolCount;
+  EFI_EVENT                       ConnPoolTimer;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -174,6 +181,7 @@ typedef struct _HTTP_PROTOCOL {
   UINTN                             ProxyUrlLen;
   BOOLEAN                           ProxyConnected;
   CHAR8                             *EndPointHostName;
+  UINT16                            EndPointRemotePort;
 
   //
   // Https Support
@@ -651,7 +651,9 @@ TlsConfigureSession (
   IN OUT HTTP_PROTOCOL  *HttpInstance
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS                        Status;
+  EDKII_TLS_SESSION_CACHE_PROTOCOL  *SessionCache;
+  UINT16                            ServerPort;
 
   //
   // TlsConfigData initialization
@@ -664,8 +666,10 @@ TlsConfigureSession (
   if (HttpInstance->ProxyConnected) {
     ASSERT (HttpInstance->EndPointHostName != NULL);
     HttpInstance->TlsConfigData.VerifyHost.HostName = HttpInstance->EndPointHostName;
+    ServerPort                                      = HttpInstance->EndPointRemotePort;
   } else {
     HttpInstance->TlsConfigData.VerifyHost.HostName = HttpInstance->RemoteHost;
+    ServerPort                                      = HttpInstance->RemotePort;
   }
 
   //
@@ -704,6 +708,20 @@ TlsConfigureSession (
     return Status;
   }
 
+  //
+  // The TLS session of the server can be resumed by the next connection
+  // once its port is known too. It's an optimization only, the connection
+  // works without it.
+  //
+  Status = gBS->HandleProtocol (
+                  HttpInstance->Handle,
+                  &gEdkiiTlsSessionCacheProtocolGuid,
+                  (VOID **)&SessionCache
+                  );
+  if (!EFI_ERROR (Status)) {
+    SessionCache->SetServerPort (SessionCache, ServerPort);
+  }
+
   Status = HttpInstance->Tls->SetSessionData (
                                 HttpInstance->Tls,
                                 EfiTlsSessionState,
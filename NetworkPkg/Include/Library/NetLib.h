@@ -1556,6 +1556,7 @@ NetLibIp6ToStr (
 #define  NET_BUF_HEAD          1    // Trim or allocate space from head
 #define  NET_BUF_TAIL          0    // Trim or allocate space from tail
 #define  NET_VECTOR_OWN_FIRST  0x01 // We allocated the 1st block in the vector
+#define  NET_VECTOR_CACHED     0x02 // The blocks we allocated are in a cached size class
 
 #define NET_CHECK_SIGNATURE(PData, SIGNATURE) \
   ASSERT (((PData) != NULL) && ((PData)->Signature == (SIGNATURE)))
@@ -0,0 +1,61 @@
+/** @file
+  This file defines the EDKII Managed Network Statistics Protocol interface.
+
+  The protocol is installed by MnpDxe on the handle of the network device,
+  next to EFI_SIMPLE_NETWORK_PROTOCOL. It reports the packets MNP received
+  from the device and the packets it had to drop, which the statistics of
+  the Simple Network Protocol can't account for.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_MANAGED_NETWORK_STATISTICS_H_
+#define EDKII_MANAGED_NETWORK_STATISTICS_H_
+
+#define EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL_GUID \
+  { \
+    0x657b30b5, 0x4068, 0x4fe8, {0xa7, 0xda, 0x0e, 0xb1, 0x1d, 0x5f, 0x54, 0x8f} \
+  }
+
+typedef struct _EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL;
+
+///
+/// The receive statistics of MNP on a network device.
+///
+typedef struct {
+  UINT64    RxPackets;          ///< Packets received from the device.
+  UINT64    RxNoReceiverDrops;  ///< Packets dropped because no MNP child wanted them.
+  UINT64    RxQueueDrops;       ///< Packets dropped because the receive queue of a child was full.
+  UINT64    RxTimeoutDrops;     ///< Packets dropped because no receive token took them in time.
+  UINT64    RxErrors;           ///< Packets lost to a receive error, e.g. a bad size or no free buffer.
+  UINT32    RxPacketsPerSecond; ///< Receive rate over the last second.
+  UINT32    PollInterval;       ///< Current interval of the system poll, in microseconds.
+} EDKII_MANAGED_NETWORK_STATISTICS;
+
+/**
+  Get and optionally reset the receive statistics of MNP on a network device.
+
+  @param[in]   This            Pointer to the EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL instance.
+  @param[in]   Reset           TRUE to reset the counters once they are read.
+  @param[out]  Statistics      The statistics, optional when Reset is TRUE.
+
+  @retval EFI_SUCCESS             The statistics are returned, or reset.
+  @retval EFI_INVALID_PARAMETER   This is NULL, or Statistics is NULL and
+                                  Reset is FALSE.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MANAGED_NETWORK_GET_STATISTICS)(
+  IN  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL  *This,
+  IN  BOOLEAN                                    Reset,
+  OUT EDKII_MANAGED_NETWORK_STATISTICS           *Statistics OPTIONAL
+  );
+
+struct _EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL {
+  EDKII_MANAGED_NETWORK_GET_STATISTICS    GetStatistics;
+};
+
+extern EFI_GUID  gEdkiiManagedNetworkStatisticsProtocolGuid;
+
+#endif
@@ -0,0 +1,48 @@
+/** @file
+  This file defines the EDKII TLS Session Cache Protocol interface.
+
+  The protocol is installed by TlsDxe on the TLS child handles, next to
+  EFI_TLS_PROTOCOL. A client connection offers the cached session of its
+  server for resumption only when the caller identified the server by its
+  host name (EfiTlsVerifyHost) and by its port with this protocol.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_TLS_SESSION_CACHE_H_
+#define EDKII_TLS_SESSION_CACHE_H_
+
+#define EDKII_TLS_SESSION_CACHE_PROTOCOL_GUID \
+  { \
+    0xfa37f4cf, 0xbe62, 0x4e88, {0xbc, 0x1b, 0x3f, 0xee, 0xd4, 0x37, 0x16, 0xaf} \
+  }
+
+typedef struct _EDKII_TLS_SESSION_CACHE_PROTOCOL EDKII_TLS_SESSION_CACHE_PROTOCOL;
+
+/**
+  Set the port of the server the TLS connection is established with.
+
+  It must be called before the handshake starts.
+
+  @param[in]  This            Pointer to the EDKII_TLS_SESSION_CACHE_PROTOCOL instance.
+  @param[in]  ServerPort      The TCP port of the server.
+
+  @retval EFI_SUCCESS             The port is set.
+  @retval EFI_INVALID_PARAMETER   This is NULL, or ServerPort is 0.
+  @retval EFI_ACCESS_DENIED       The handshake has started.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TLS_SESSION_CACHE_SET_SERVER_PORT)(
+  IN EDKII_TLS_SESSION_CACHE_PROTOCOL  *This,
+  IN UINT16                            ServerPort
+  );
+
+struct _EDKII_TLS_SESSION_CACHE_PROTOCOL {
+  EDKII_TLS_SESSION_CACHE_SET_SERVER_PORT    SetServerPort;
+};
+
+extern EFI_GUID  gEdkiiTlsSessionCacheProtocolGuid;
+
+#endif
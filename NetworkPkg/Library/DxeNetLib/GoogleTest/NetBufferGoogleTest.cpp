@@ -0,0 +1,340 @@
+/** @file
+  Tests for the NET_BUF caches of NetBuffer.c.
+
+  Besides the unit tests of the recycling of the NET_BUF, NET_VECTOR and data
+  block size classes, a micro-benchmark measures the packet allocation and
+  free throughput of the caches against three pool allocations per packet.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/UefiBootServicesTableLib.h>
+  #include <Library/NetLib.h>
+
+  EFI_STATUS
+  EFIAPI
+  NetLibDestructor (
+    IN EFI_HANDLE        ImageHandle,
+    IN EFI_SYSTEM_TABLE  *SystemTable
+    );
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_PACKET_LEN     1514
+#define TEST_HEAD_SPACE     60
+#define TEST_BENCHMARK_RUN  1000000
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// The boot services NetBuffer.c depends on, which are not mocked
+////////////////////////////////////////////////////////////////////////
+static EFI_TPL  mTpl = TPL_APPLICATION;
+
+static
+EFI_TPL
+EFIAPI
+HostRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = mTpl;
+  mTpl   = NewTpl;
+  return OldTpl;
+}
+
+static
+VOID
+EFIAPI
+HostRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+  mTpl = OldTpl;
+}
+
+static
+EFI_STATUS
+EFIAPI
+HostFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+class NetBufferTest : public ::testing::Test {
+protected:
+  void
+  SetUp (
+    ) override
+  {
+    gBS->RaiseTPL   = HostRaiseTpl;
+    gBS->RestoreTPL = HostRestoreTpl;
+    gBS->FreePool   = HostFreePool;
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    EXPECT_EQ (mTpl, (EFI_TPL)TPL_APPLICATION);
+    NetLibDestructor (NULL, NULL);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////
+
+TEST_F (NetBufferTest, FreedPacketShouldBeRecycledBySameSizeClass) {
+  NET_BUF     *Nbuf;
+  NET_VECTOR  *Vector;
+  UINT8       *Bulk;
+  UINT8       *Data;
+
+  Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Nbuf, nullptr);
+  Data = NetbufAllocSpace (Nbuf, TEST_PACKET_LEN, NET_BUF_TAIL);
+  ASSERT_NE (Data, nullptr);
+  SetMem (Data, TEST_PACKET_LEN, 0x5A);
+  Nbuf->Tcp = (TCP_HEAD *)Data;
+
+  Vector = Nbuf->Vector;
+  Bulk   = Vector->Block[0].Bulk;
+  NetbufFree (Nbuf);
+
+  //
+  // 1514 and 2000 bytes are in the same size class.
+  //
+  Nbuf = NetbufAlloc (2000);
+  ASSERT_NE (Nbuf, nullptr);
+  EXPECT_EQ (Nbuf->Vector, Vector);
+  EXPECT_EQ (Nbuf->Vector->Block[0].Bulk, Bulk);
+
+  //
+  // The recycled packet is as good as a new one.
+  //
+  EXPECT_EQ (Nbuf->Signature, (UINT32)NET_BUF_SIGNATURE);
+  EXPECT_EQ (Nbuf->RefCnt, 1);
+  EXPECT_EQ (Nbuf->Tcp, nullptr);
+  EXPECT_EQ (Nbuf->TotalSize, 0U);
+  EXPECT_EQ (Nbuf->Vector->Len, 2000U);
+  EXPECT_EQ (Nbuf->Vector->Free, nullptr);
+  EXPECT_EQ (NET_TAILSPACE (&Nbuf->BlockOp[0]), 2000U);
+  EXPECT_NE (NetbufAllocSpace (Nbuf, 2000, NET_BUF_TAIL), nullptr);
+
+  NetbufFree (Nbuf);
+}
+
+TEST_F (NetBufferTest, DifferentSizeClassShouldNotShareDataBlocks) {
+  NET_BUF  *Small;
+  NET_BUF  *Large;
+  UINT8    *Bulk;
+
+  Small = NetbufAlloc (100);
+  ASSERT_NE (Small, nullptr);
+  Bulk = Small->Vector->Block[0].Bulk;
+  NetbufFree (Small);
+
+  Large = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Large, nullptr);
+  EXPECT_NE (Large->Vector->Block[0].Bulk, Bulk);
+  EXPECT_NE (NetbufAllocSpace (Large, TEST_PACKET_LEN, NET_BUF_TAIL), nullptr);
+  NetbufFree (Large);
+
+  //
+  // Blocks beyond the largest size class are allocated from the pool.
+  //
+  Large = NetbufAlloc (9000);
+  ASSERT_NE (Large, nullptr);
+  EXPECT_NE (NetbufAllocSpace (Large, 9000, NET_BUF_TAIL), nullptr);
+  NetbufFree (Large);
+}
+
+TEST_F (NetBufferTest, FragmentShouldShareDataAndRecycleHeadSpace) {
+  NET_BUF     *Nbuf;
+  NET_BUF     *Fragment;
+  NET_VECTOR  *Vector;
+  UINT8       *Data;
+  UINT8       Copy[500];
+  UINT32      Index;
+
+  Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Nbuf, nullptr);
+  Data = NetbufAllocSpace (Nbuf, TEST_PACKET_LEN, NET_BUF_TAIL);
+  ASSERT_NE (Data, nullptr);
+  for (Index = 0; Index < TEST_PACKET_LEN; Index++) {
+    Data[Index] = (UINT8)Index;
+  }
+
+  Fragment = NetbufGetFragment (Nbuf, 100, sizeof (Copy), TEST_HEAD_SPACE);
+  ASSERT_NE (Fragment, nullptr);
+  EXPECT_EQ (Fragment->TotalSize, sizeof (Copy));
+  EXPECT_EQ (Fragment->Vector->Flag, (UINT32)(NET_VECTOR_OWN_FIRST | NET_VECTOR_CACHED));
+  EXPECT_EQ (Nbuf->Vector->RefCnt, 2);
+  EXPECT_NE (NetbufAllocSpace (Fragment, TEST_HEAD_SPACE, NET_BUF_HEAD), nullptr);
+
+  EXPECT_EQ (NetbufCopy (Fragment, TEST_HEAD_SPACE, sizeof (Copy), Copy), sizeof (Copy));
+  EXPECT_EQ (CompareMem (Copy, Data + 100, sizeof (Copy)), 0);
+
+  //
+  // The data is released with the last packet which shares it.
+  //
+  Vector = Nbuf->Vector;
+  NetbufFree (Nbuf);
+  EXPECT_EQ (Fragment->Vector->Arg, (VOID *)Vector);
+  EXPECT_EQ (Vector->RefCnt, 1);
+  NetbufFree (Fragment);
+}
+
+TEST_F (NetBufferTest, CloneAndDuplicateShouldUseCachedPackets) {
+  NET_BUF  *Nbuf;
+  NET_BUF  *Clone;
+  NET_BUF  *Duplicate;
+  UINT8    *Data;
+
+  Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Nbuf, nullptr);
+  Data = NetbufAllocSpace (Nbuf, TEST_PACKET_LEN, NET_BUF_TAIL);
+  ASSERT_NE (Data, nullptr);
+  SetMem (Data, TEST_PACKET_LEN, 0xA5);
+
+  Clone = NetbufClone (Nbuf);
+  ASSERT_NE (Clone, nullptr);
+  EXPECT_EQ (Clone->Vector, Nbuf->Vector);
+  EXPECT_EQ (Clone->TotalSize, (UINT32)TEST_PACKET_LEN);
+
+  Duplicate = NetbufDuplicate (Clone, NULL, TEST_HEAD_SPACE);
+  ASSERT_NE (Duplicate, nullptr);
+  EXPECT_NE (Duplicate->Vector, Nbuf->Vector);
+  EXPECT_EQ (Duplicate->TotalSize, (UINT32)TEST_PACKET_LEN);
+  EXPECT_EQ (CompareMem (NetbufGetByte (Duplicate, 0, NULL), Data, TEST_PACKET_LEN), 0);
+
+  NetbufFree (Clone);
+  EXPECT_EQ (Nbuf->Vector->RefCnt, 1);
+  NetbufFree (Nbuf);
+  NetbufFree (Duplicate);
+}
+
+TEST_F (NetBufferTest, CachedPacketsShouldBeReleasedByFreePool) {
+  NET_BUF  *Nbuf;
+
+  //
+  // Like IpSec does for the packets it replaces.
+  //
+  Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Nbuf, nullptr);
+  FreePool (Nbuf->Vector->Block[0].Bulk);
+  FreePool (Nbuf->Vector);
+  FreePool (Nbuf);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Micro-benchmark
+////////////////////////////////////////////////////////////////////////
+
+/**
+  Measure the time per iteration of a packet allocation pattern.
+
+  @param[in]  Pattern   The allocation pattern.
+
+  @return The time per iteration in nanoseconds.
+**/
+template<typename PATTERN>
+static
+double
+NetBufferBenchmark (
+  PATTERN  Pattern
+  )
+{
+  std::chrono::steady_clock::time_point  Start;
+  std::chrono::nanoseconds               Elapsed;
+  UINT32                                 Index;
+
+  //
+  // Warm up the caches.
+  //
+  Pattern ();
+
+  Start = std::chrono::steady_clock::now ();
+  for (Index = 0; Index < TEST_BENCHMARK_RUN; Index++) {
+    Pattern ();
+  }
+
+  Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now () - Start);
+  return (double)Elapsed.count () / TEST_BENCHMARK_RUN;
+}
+
+TEST_F (NetBufferTest, BenchmarkPacketAllocFree) {
+  double  Pool;
+  double  Cached;
+  double  Segment;
+
+  //
+  // The packet allocation without caches: NET_BUF, NET_VECTOR and data
+  // block from the pool.
+  //
+  Pool = NetBufferBenchmark (
+           [] () {
+      VOID *Nbuf;
+      VOID *Vector;
+      VOID *Bulk;
+
+      Nbuf   = AllocateZeroPool (NET_BUF_SIZE (1));
+      Vector = AllocateZeroPool (NET_VECTOR_SIZE (1));
+      Bulk   = AllocatePool (TEST_PACKET_LEN);
+      FreePool (Bulk);
+      FreePool (Vector);
+      FreePool (Nbuf);
+    }
+           );
+
+  Cached = NetBufferBenchmark (
+             [] () {
+      NetbufFree (NetbufAlloc (TEST_PACKET_LEN));
+    }
+             );
+
+  //
+  // A TCP segment: the data, and a fragment of it with head space for the
+  // headers.
+  //
+  Segment = NetBufferBenchmark (
+              [] () {
+      NET_BUF *Nbuf;
+
+      Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+      NetbufAllocSpace (Nbuf, TEST_PACKET_LEN, NET_BUF_TAIL);
+      NetbufFree (NetbufGetFragment (Nbuf, 0, TEST_PACKET_LEN - TEST_HEAD_SPACE, TEST_HEAD_SPACE));
+      NetbufFree (Nbuf);
+    }
+              );
+
+  RecordProperty ("PoolNsPerPacket", (int)Pool);
+  RecordProperty ("CachedNsPerPacket", (int)Cached);
+  RecordProperty ("SegmentNsPerPacket", (int)Segment);
+  printf (
+    "Packet alloc/free: pool %.1f ns, cached %.1f ns, TCP segment %.1f ns\n",
+    Pool,
+    Cached,
+    Segment
+    );
+}
@@ -14,6 +14,270 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+//
+// NET_BUF, NET_VECTOR and data block caches.
+//
+// Every packet sent or received allocates a NET_BUF, a NET_VECTOR and a data
+// block, and frees them once it is delivered. The freed objects of the most
+// common sizes are kept in per-size class free lists, linked through their
+// first bytes, and handed out again by the next allocations of their size
+// classes instead of going through the pool allocator. The cached objects
+// remain individual pool allocations, so that FreePool() still releases them.
+//
+#define NET_CACHE_BLOCK_NUM       4    // NET_BUF and NET_VECTOR of 1 to 4 blocks
+#define NET_CACHE_BULK_MIN_SHIFT  7    // Data blocks of 128 bytes ...
+#define NET_CACHE_BULK_MAX_SHIFT  11   // ... to 2048 bytes, in power of 2 classes
+#define NET_CACHE_DEPTH           64   // Free objects kept per size class
+
+typedef struct {
+  VOID      *Head;
+  UINT32    Count;
+} NET_CACHE;
+
+STATIC NET_CACHE  mNetbufCache[NET_CACHE_BLOCK_NUM];
+STATIC NET_CACHE  mNetVectorCache[NET_CACHE_BLOCK_NUM];
+STATIC NET_CACHE  mNetBulkCache[NET_CACHE_BULK_MAX_SHIFT - NET_CACHE_BULK_MIN_SHIFT + 1];
+
+/**
+  Allocate an object from a size class cache, or from the pool if the
+  cache is empty.
+
+  @param[in, out]  Cache        The cache of the size class, or NULL if the
+                                size isn't cached.
+  @param[in]       Size         The size of the objects of the size class.
+
+  @return                       Pointer to the allocated object, or NULL if the
+                                allocation failed due to resource limit.
+
+**/
+STATIC
+VOID *
+NetCacheAlloc (
+  IN OUT NET_CACHE  *Cache  OPTIONAL,
+  IN     UINTN      Size
+  )
+{
+  VOID     *Object;
+  EFI_TPL  OldTpl;
+
+  Object = NULL;
+
+  if (Cache != NULL) {
+    //
+    // The network stack allocates and frees packets up to TPL_NOTIFY.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Object = Cache->Head;
+    if (Object != NULL) {
+      Cache->Head = *(VOID **)Object;
+      Cache->Count--;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (Object == NULL) {
+    Object = AllocatePool (Size);
+  }
+
+  return Object;
+}
+
+/**
+  Free an object to its size class cache, or to the pool if the cache
+  is full.
+
+  @param[in, out]  Cache        The cache of the size class, or NULL if the
+                                size isn't cached.
+  @param[in]       Object       The object to free.
+
+**/
+STATIC
+VOID
+NetCacheFree (
+  IN OUT NET_CACHE  *Cache  OPTIONAL,
+  IN     VOID       *Object
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (Cache != NULL) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (Cache->Count < NET_CACHE_DEPTH) {
+      *(VOID **)Object = Cache->Head;
+      Cache->Head      = Object;
+      Cache->Count++;
+      Object = NULL;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (Object != NULL) {
+    FreePool (Object);
+  }
+}
+
+/**
+  Get the cache of the NET_BUFs with BlockOpNum NET_BLOCK_OPs.
+
+  @param[in]  BlockOpNum        The number of NET_BLOCK_OP in the net buffer.
+
+  @return                       The cache, or NULL if the size isn't cached.
+
+**/
+STATIC
+NET_CACHE *
+NetbufCacheOf (
+  IN UINT32  BlockOpNum
+  )
+{
+  return (BlockOpNum <= NET_CACHE_BLOCK_NUM) ? &mNetbufCache[BlockOpNum - 1] : NULL;
+}
+
+/**
+  Get the cache of the NET_VECTORs with BlockNum NET_BLOCKs.
+
+  @param[in]  BlockNum          The number of NET_BLOCK in the net vector.
+
+  @return                       The cache, or NULL if the size isn't cached.
+
+**/
+STATIC
+NET_CACHE *
+NetVectorCacheOf (
+  IN UINT32  BlockNum
+  )
+{
+  return (BlockNum <= NET_CACHE_BLOCK_NUM) ? &mNetVectorCache[BlockNum - 1] : NULL;
+}
+
+/**
+  Get the cache of the data blocks able to hold Len bytes.
+
+  @param[in]   Len              The length of the data block.
+  @param[out]  Size             The size of the data blocks of the cache, or
+                                Len if the size isn't cached.
+
+  @return                       The cache, or NULL if the size isn't cached.
+
+**/
+STATIC
+NET_CACHE *
+NetBulkCacheOf (
+  IN  UINT32  Len,
+  OUT UINT32  *Size
+  )
+{
+  INTN  Shift;
+
+  Shift = (Len > 1) ? HighBitSet32 (Len - 1) + 1 : 0;
+  Shift = MAX (Shift, NET_CACHE_BULK_MIN_SHIFT);
+
+  if (Shift > NET_CACHE_BULK_MAX_SHIFT) {
+    *Size = Len;
+    return NULL;
+  }
+
+  *Size = 1U << Shift;
+  return &mNetBulkCache[Shift - NET_CACHE_BULK_MIN_SHIFT];
+}
+
+/**
+  Allocate a data block of Len bytes. The data block must be released by
+  NetBulkFree() with the same length, or by FreePool().
+
+  @param[in]  Len               The length of the data block.
+
+  @return                       Pointer to the allocated data block, or NULL if
+                                the allocation failed due to resource limit.
+
+**/
+STATIC
+UINT8 *
+NetBulkAlloc (
+  IN UINT32  Len
+  )
+{
+  NET_CACHE  *Cache;
+  UINT32     Size;
+
+  Cache = NetBulkCacheOf (Len, &Size);
+  return NetCacheAlloc (Cache, Size);
+}
+
+/**
+  Free a data block allocated by NetBulkAlloc().
+
+  @param[in]  Bulk              Pointer to the data block.
+  @param[in]  Len               The length the data block was allocated with.
+
+**/
+STATIC
+VOID
+NetBulkFree (
+  IN UINT8   *Bulk,
+  IN UINT32  Len
+  )
+{
+  NET_CACHE  *Cache;
+  UINT32     Size;
+
+  Cache = NetBulkCacheOf (Len, &Size);
+  NetCacheFree (Cache, Bulk);
+}
+
+/**
+  Release the free objects kept in a set of caches.
+
+  @param[in, out]  Caches       The caches.
+  @param[in]       Count        The number of caches.
+
+**/
+STATIC
+VOID
+NetCacheFlush (
+  IN OUT NET_CACHE  *Caches,
+  IN     UINTN      Count
+  )
+{
+  UINTN  Index;
+  VOID   *Object;
+
+  for (Index = 0; Index < Count; Index++) {
+    while (Caches[Index].Head != NULL) {
+      Object              = Caches[Index].Head;
+      Caches[Index].Head  = *(VOID **)Object;
+      Caches[Index].Count--;
+      FreePool (Object);
+    }
+  }
+}
+
+/**
+  Release the NET_BUF, NET_VECTOR and data block caches when the image
+  which links the library is unloaded.
+
+  @param[in]  ImageHandle       The image handle of the driver.
+  @param[in]  SystemTable       The system table.
+
+  @retval EFI_SUCCESS           The caches are released.
+
+**/
+EFI_STATUS
+EFIAPI
+NetLibDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  NetCacheFlush (mNetbufCache, ARRAY_SIZE (mNetbufCache));
+  NetCacheFlush (mNetVectorCache, ARRAY_SIZE (mNetVectorCache));
+  NetCacheFlush (mNetBulkCache, ARRAY_SIZE (mNetBulkCache));
+
+  return EFI_SUCCESS;
+}
+
 /**
   Allocate and build up the sketch for a NET_BUF.
 
@@ -42,24 +306,26 @@ NetbufAllocStruct (
   //
   // Allocate three memory blocks.
   //
-  Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  Nbuf = NetCacheAlloc (NetbufCacheOf (BlockOpNum), NET_BUF_SIZE (BlockOpNum));
 
   if (Nbuf == NULL) {
     return NULL;
   }
 
+  ZeroMem (Nbuf, NET_BUF_SIZE (BlockOpNum));
   Nbuf->Signature  = NET_BUF_SIGNATURE;
   Nbuf->RefCnt     = 1;
   Nbuf->BlockOpNum = BlockOpNum;
   InitializeListHead (&Nbuf->List);
 
   if (BlockNum != 0) {
-    Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    Vector = NetCacheAlloc (NetVectorCacheOf (BlockNum), NET_VECTOR_SIZE (BlockNum));
 
     if (Vector == NULL) {
       goto FreeNbuf;
     }
 
+    ZeroMem (Vector, NET_VECTOR_SIZE (BlockNum));
     Vector->Signature = NET_VECTOR_SIGNATURE;
     Vector->RefCnt    = 1;
     Vector->BlockNum  = BlockNum;
@@ -70,7 +336,7 @@ NetbufAllocStruct (
 
 FreeNbuf:
 
-  FreePool (Nbuf);
+  NetCacheFree (NetbufCacheOf (BlockOpNum), Nbuf);
   return NULL;
 }
 
@@ -102,14 +368,15 @@ NetbufAlloc (
     return NULL;
   }
 
-  Bulk = AllocatePool (Len);
+  Bulk = NetBulkAlloc (Len);
 
   if (Bulk == NULL) {
     goto FreeNBuf;
   }
 
-  Vector      = Nbuf->Vector;
-  Vector->Len = Len;
+  Vector       = Nbuf->Vector;
+  Vector->Len  = Len;
+  Vector->Flag = NET_VECTOR_CACHED;
 
   Vector->Block[0].Bulk = Bulk;
   Vector->Block[0].Len  = Len;
@@ -124,7 +391,8 @@ NetbufAlloc (
   return Nbuf;
 
 FreeNBuf:
-  FreePool (Nbuf);
+  NetCacheFree (NetVectorCacheOf (1), Nbuf->Vector);
+  NetCacheFree (NetbufCacheOf (1), Nbuf);
   return NULL;
 }
 
@@ -161,7 +429,9 @@ NetbufFreeVector (
     // isn't NULL. If NET_VECTOR_OWN_FIRST is set, release the
     // first block since it is allocated by us
     //
-    if ((Vector->Flag & NET_VECTOR_OWN_FIRST) != 0) {
+    if ((Vector->Flag & NET_VECTOR_CACHED) != 0) {
+      NetBulkFree (Vector->Block[0].Bulk, Vector->Block[0].Len);
+    } else if ((Vector->Flag & NET_VECTOR_OWN_FIRST) != 0) {
       gBS->FreePool (Vector->Block[0].Bulk);
     }
 
@@ -171,11 +441,15 @@ NetbufFreeVector (
     // Free each memory block associated with the Vector
     //
     for (Index = 0; Index < Vector->BlockNum; Index++) {
-      gBS->FreePool (Vector->Block[Index].Bulk);
+      if ((Vector->Flag & NET_VECTOR_CACHED) != 0) {
+        NetBulkFree (Vector->Block[Index].Bulk, Vector->Block[Index].Len);
+      } else {
+        gBS->FreePool (Vector->Block[Index].Bulk);
+      }
     }
   }
 
-  FreePool (Vector);
+  NetCacheFree (NetVectorCacheOf (Vector->BlockNum), Vector);
 }
 
 /**
@@ -208,7 +482,7 @@ NetbufFree (
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetCacheFree (NetbufCacheOf (Nbuf->BlockOpNum), Nbuf);
   }
 }
 
@@ -234,7 +508,7 @@ NetbufClone (
 
   NET_CHECK_SIGNATURE (Nbuf, NET_BUF_SIGNATURE);
 
-  Clone = AllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  Clone = NetCacheAlloc (NetbufCacheOf (Nbuf->BlockOpNum), NET_BUF_SIZE (Nbuf->BlockOpNum));
 
   if (Clone == NULL) {
     return NULL;
@@ -596,7 +870,7 @@ NetbufGetFragment (
       return NULL;
     }
 
-    FirstBulk = AllocatePool (HeadSpace);
+    FirstBulk = NetBulkAlloc (HeadSpace);
 
     if (FirstBulk == NULL) {
       goto FreeChild;
@@ -605,7 +879,7 @@ NetbufGetFragment (
     Vector       = Child->Vector;
     Vector->Free = NetbufGetFragmentFree;
     Vector->Arg  = Nbuf->Vector;
-    Vector->Flag = NET_VECTOR_OWN_FIRST;
+    Vector->Flag = NET_VECTOR_OWN_FIRST | NET_VECTOR_CACHED;
     Vector->Len  = HeadSpace;
 
     //
@@ -662,7 +936,8 @@ NetbufGetFragment (
 
 FreeChild:
 
-  FreePool (Child);
+  NetCacheFree (NetVectorCacheOf (1), Child->Vector);
+  NetCacheFree (NetbufCacheOf (BlockOpNum), Child);
   return NULL;
 }
 
@@ -181,7 +181,14 @@ MnpFreeNbuf (
 
   NET_PUT_REF (Nbuf);
 
-  if (Nbuf->RefCnt == 1) {
+  if ((Nbuf->RefCnt == 1) && (Nbuf->Vector->Free != NULL)) {
+    //
+    // The Nbuf wraps a receive buffer loaned by Snp. Freeing it returns the
+    // buffer to Snp, which can't be done at TPL_NOTIFY, so queue it for
+    // MnpReturnRxLoans.
+    //
+    NetbufQueAppend (&MnpDeviceData->RxLoanReturnQue, Nbuf);
+  } else if (Nbuf->RefCnt == 1) {
     //
     // Trim all buffer contained in the Nbuf, then append it to the NbufQue.
     //
@@ -435,6 +442,7 @@ MnpInitializeDeviceData (
   // Copy the MNP Protocol interfaces from the template.
   //
   CopyMem (&MnpDeviceData->VlanConfig, &mVlanConfigProtocolTemplate, sizeof (EFI_VLAN_CONFIG_PROTOCOL));
+  MnpDeviceData->Statistics.GetStatistics = MnpGetStatistics;
 
   //
   // Open the Simple Network protocol.
@@ -457,6 +465,21 @@ MnpInitializeDeviceData (
   SnpMode            = Snp->Mode;
   MnpDeviceData->Snp = Snp;
 
+  //
+  // Check whether Snp can loan its receive buffers.
+  //
+  Status = gBS->OpenProtocol (
+                  ControllerHandle,
+                  &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+                  (VOID **)&MnpDeviceData->RxLoan,
+                  ImageHandle,
+                  ControllerHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDeviceData->RxLoan = NULL;
+  }
+
   //
   // Initialize the lists.
   //
@@ -488,6 +511,7 @@ MnpInitializeDeviceData (
   // Initialize the FreeNetBufQue and pre-allocate some NET_BUFs.
   //
   NetbufQueInit (&MnpDeviceData->FreeNbufQue);
+  NetbufQueInit (&MnpDeviceData->RxLoanReturnQue);
   Status = MnpAddFreeNbuf (MnpDeviceData, MNP_INIT_NET_BUFFER_NUM);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "MnpInitializeDeviceData: MnpAddFreeNbuf failed, %r.\n", Status));
@@ -658,6 +682,11 @@ MnpDestroyDeviceData (
   //
   MnpFreeNbuf (MnpDeviceData, MnpDeviceData->RxNbufCache);
 
+  //
+  // Return the receive buffers still queued to Snp.
+  //
+  MnpReturnRxLoans (MnpDeviceData);
+
   //
   // Flush the FreeNbufQue.
   //
@@ -1151,6 +1180,11 @@ MnpStopSnp (
   Snp = MnpDeviceData->Snp;
   ASSERT (Snp != NULL);
 
+  //
+  // Return the receive buffers released by the instances to SNP.
+  //
+  MnpReturnRxLoans (MnpDeviceData);
+
   //
   // Recycle all the transmit buffer from SNP.
   //
@@ -1263,9 +1297,10 @@ MnpStart (
     // The EnableSystemPoll differs with the current state, disable or enable
     // the system poll.
     //
-    TimerOpType = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    TimerOpType                 = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    MnpDeviceData->PollInterval = MNP_SYS_POLL_INTERVAL;
 
-    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MNP_SYS_POLL_INTERVAL);
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MnpDeviceData->PollInterval);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "MnpStart: gBS->SetTimer for PollTimer failed, %r.\n", Status));
 
@@ -1385,6 +1420,8 @@ MnpFlushRcvdDataQueue (
   ASSERT (Instance->RcvdPacketQueueSize == 0);
 
   gBS->RestoreTPL (OldTpl);
+
+  MnpReturnRxLoans (Instance->MnpServiceData->MnpDeviceData);
 }
 
 /**
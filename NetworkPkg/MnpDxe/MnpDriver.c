@@ -176,6 +176,21 @@ MnpDriverBindingStart (
     return Status;
   }
 
+  //
+  // Publish the receive statistics on the device handle.
+  //
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &ControllerHandle,
+                  &gEdkiiManagedNetworkStatisticsProtocolGuid,
+                  &MnpDeviceData->Statistics,
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDestroyDeviceData (MnpDeviceData, This->DriverBindingHandle);
+    FreePool (MnpDeviceData);
+    return Status;
+  }
+
   //
   // Check whether NIC driver has already produced VlanConfig protocol
   //
@@ -272,6 +287,13 @@ Exit:
              );
     }
 
+    gBS->UninstallMultipleProtocolInterfaces (
+           MnpDeviceData->ControllerHandle,
+           &gEdkiiManagedNetworkStatisticsProtocolGuid,
+           &MnpDeviceData->Statistics,
+           NULL
+           );
+
     //
     // Destroy Mnp Device Data
     //
@@ -378,6 +400,13 @@ MnpDriverBindingStop (
              );
     }
 
+    gBS->UninstallMultipleProtocolInterfaces (
+           MnpDeviceData->ControllerHandle,
+           &gEdkiiManagedNetworkStatisticsProtocolGuid,
+           &MnpDeviceData->Statistics,
+           NULL
+           );
+
     //
     // Destroy Mnp Device Data
     //
@@ -12,7 +12,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/ManagedNetwork.h>
+#include <Protocol/ManagedNetworkStatistics.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkRxLoan.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
 
@@ -45,9 +47,20 @@ typedef struct {
 
   EFI_VLAN_CONFIG_PROTOCOL       VlanConfig;
   UINTN                          NumberOfVlan;
+
+  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL    Statistics;
   CHAR16                         *MacString;
   EFI_SIMPLE_NETWORK_PROTOCOL    *Snp;
 
+  //
+  // Rx buffer loan interface of Snp, NULL if Snp doesn't produce it. Packets
+  // received through it are wrapped in NET_BUFs without being copied. The
+  // NET_BUFs released at TPL_NOTIFY are queued in RxLoanReturnQue, and their
+  // buffers are returned to Snp at TPL_CALLBACK by MnpReturnRxLoans.
+  //
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL    *RxLoan;
+  NET_BUF_QUEUE                            RxLoanReturnQue;
+
   //
   // List of MNP_SERVICE_DATA
   //
@@ -70,6 +83,17 @@ typedef struct {
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
 
+  //
+  // Adaptive system poll. The poll interval drops to MNP_SYS_POLL_INTERVAL_MIN
+  // while packets arrive and backs off to MNP_SYS_POLL_INTERVAL when idle.
+  // RxEventTrusted is set once the WaitForPacket event of Snp has proven to
+  // announce the received packets, it is then used to skip idle receives.
+  //
+  UINT64                         PollInterval;
+  UINT32                         RxIdlePolls;
+  BOOLEAN                        RxEventTrusted;
+  BOOLEAN                        RxPending;
+
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
 
@@ -85,6 +109,20 @@ typedef struct {
   UINT32                         BufferLength;
   UINT32                         PaddingSize;
   NET_BUF                        *RxNbufCache;
+
+  //
+  // Receive statistics. RxPacketsPerSecond is updated once a second while
+  // the device is started. They are published through Statistics, and the
+  // rate and drops are also reported on DEBUG_NET.
+  //
+  UINT64                         RxPackets;
+  UINT64                         RxNoReceiverDrops;
+  UINT64                         RxQueueDrops;
+  UINT64                         RxTimeoutDrops;
+  UINT64                         RxErrors;
+  UINT64                         RxLastPackets;
+  UINT32                         RxPacketsPerSecond;
+  UINT32                         RxRateTicks;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
@@ -95,6 +133,14 @@ typedef struct {
   MNP_DEVICE_DATA_SIGNATURE \
   )
 
+#define MNP_DEVICE_DATA_FROM_STATISTICS(a) \
+  CR ( \
+  (a), \
+  MNP_DEVICE_DATA, \
+  Statistics, \
+  MNP_DEVICE_DATA_SIGNATURE \
+  )
+
 #define MNP_SERVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'S')
 
 typedef struct {
@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_INTERVAL_MIN    (1 * TICKS_PER_MS)     // 1 millisecond
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -25,6 +26,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define MNP_MAX_RCVD_PACKET_QUE_SIZE  256
 
+//
+// Maximum number of packets received from Snp in one poll.
+//
+#define MNP_RX_BATCH_SIZE  64
+
+//
+// While the WaitForPacket event of Snp is trusted, a receive is still
+// attempted every MNP_RX_EVENT_CHECK_POLLS idle polls.
+//
+#define MNP_RX_EVENT_CHECK_POLLS  16
+
+//
+// Number of MNP_MEDIA_DETECT_INTERVAL periods in one second, the period of
+// the receive rate computation.
+//
+#define MNP_RX_RATE_TICKS  2
+
 #define MNP_RECEIVE_UNICAST    0x01
 #define MNP_RECEIVE_BROADCAST  0x02
 
@@ -87,6 +105,15 @@ typedef struct {
   UINT64                              TimeoutTick;
 } MNP_RXDATA_WRAP;
 
+//
+// Context of a NET_BUF wrapping a receive buffer loaned by Snp, the buffer
+// is returned to Snp when the NET_BUF is freed.
+//
+typedef struct {
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL    *RxLoan;
+  VOID                                     *Buffer;
+} MNP_RX_LOAN;
+
 #define MNP_TX_BUF_WRAP_SIGNATURE  SIGNATURE_32 ('M', 'T', 'B', 'W')
 
 typedef struct {
@@ -430,6 +457,36 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Receive and deliver the packets pending in Snp, up to MNP_RX_BATCH_SIZE.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[out]      Received             The number of packets received, optional.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                The status of the first receive attempt.
+
+**/
+EFI_STATUS
+MnpReceivePacketBatch (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  OUT    UINTN            *Received OPTIONAL
+  );
+
+/**
+  Return the receive buffers of the NET_BUFs queued in RxLoanReturnQue to Snp.
+
+  The buffer loan services of Snp can't be called above TPL_CALLBACK, so this
+  function must be called at TPL_CALLBACK or lower.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+**/
+VOID
+MnpReturnRxLoans (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
@@ -532,6 +589,26 @@ MnpSystemPoll (
   IN VOID       *Context
   );
 
+/**
+  Get and optionally reset the receive statistics of MNP on a network device.
+
+  @param[in]   This            Pointer to the EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL instance.
+  @param[in]   Reset           TRUE to reset the counters once they are read.
+  @param[out]  Statistics      The statistics, optional when Reset is TRUE.
+
+  @retval EFI_SUCCESS             The statistics are returned, or reset.
+  @retval EFI_INVALID_PARAMETER   This is NULL, or Statistics is NULL and
+                                  Reset is FALSE.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL  *This,
+  IN  BOOLEAN                                    Reset,
+  OUT EDKII_MANAGED_NETWORK_STATISTICS           *Statistics OPTIONAL
+  );
+
 /**
   Returns the operational parameters for the current MNP child driver. May also
   support returning the underlying SNP driver mode data.
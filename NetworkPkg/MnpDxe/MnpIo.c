@@ -496,6 +496,7 @@ MnpQueueRcvdPacket (
     //
     MnpRecycleRxData (NULL, (VOID *)OldRxDataWrap);
     Instance->RcvdPacketQueueSize--;
+    Instance->MnpServiceData->MnpDeviceData->RxQueueDrops++;
   }
 
   //
@@ -813,6 +814,214 @@ MnpEnqueuePacket (
   }
 }
 
+/**
+  Free function of the NET_BUFs wrapping the receive buffers loaned by Snp.
+
+  @param[in]  Arg               Pointer to the MNP_RX_LOAN of the buffer.
+
+**/
+VOID
+EFIAPI
+MnpReturnRxLoan (
+  IN VOID  *Arg
+  )
+{
+  MNP_RX_LOAN  *Loan;
+
+  Loan = (MNP_RX_LOAN *)Arg;
+  Loan->RxLoan->ReturnLoan (Loan->RxLoan, Loan->Buffer);
+  FreePool (Loan);
+}
+
+/**
+  Return the receive buffers of the NET_BUFs queued in RxLoanReturnQue to Snp.
+
+  The buffer loan services of Snp can't be called above TPL_CALLBACK, so this
+  function must be called at TPL_CALLBACK or lower.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+**/
+VOID
+MnpReturnRxLoans (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  EFI_TPL  OldTpl;
+  NET_BUF  *Nbuf;
+
+  while (MnpDeviceData->RxLoanReturnQue.BufNum != 0) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Nbuf   = NetbufQueRemove (&MnpDeviceData->RxLoanReturnQue);
+    gBS->RestoreTPL (OldTpl);
+
+    if (Nbuf != NULL) {
+      NetbufFree (Nbuf);
+    }
+  }
+}
+
+/**
+  Wrap a receive buffer loaned by Snp into a NET_BUF.
+
+  If the protocol header following the media header isn't 4-byte aligned in
+  the loaned buffer, the packet is copied into a NET_BUF of the buffer pool
+  instead, and the buffer is returned to Snp at once.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Buffer               The loaned buffer.
+  @param[in]       BufLen               The length of the packet in Buffer.
+
+  @return Pointer to the NET_BUF holding the packet, with the same reference
+          count as a NET_BUF allocated by MnpAllocNbuf, or NULL on failure.
+
+**/
+NET_BUF *
+MnpWrapRxLoan (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     VOID             *Buffer,
+  IN     UINT32           BufLen
+  )
+{
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *RxLoan;
+  MNP_RX_LOAN                            *Loan;
+  NET_FRAGMENT                           Fragment;
+  NET_BUF                                *Nbuf;
+
+  RxLoan = MnpDeviceData->RxLoan;
+
+  if ((((UINTN)Buffer + MnpDeviceData->Snp->Mode->MediaHeaderSize) & 0x3) != 0) {
+    Nbuf = NULL;
+    if (BufLen <= MnpDeviceData->BufferLength) {
+      Nbuf = MnpAllocNbuf (MnpDeviceData);
+    }
+
+    if (Nbuf != NULL) {
+      CopyMem (NetbufAllocSpace (Nbuf, BufLen, NET_BUF_TAIL), Buffer, BufLen);
+    }
+
+    RxLoan->ReturnLoan (RxLoan, Buffer);
+    return Nbuf;
+  }
+
+  Loan = AllocatePool (sizeof (MNP_RX_LOAN));
+  if (Loan == NULL) {
+    RxLoan->ReturnLoan (RxLoan, Buffer);
+    return NULL;
+  }
+
+  Loan->RxLoan = RxLoan;
+  Loan->Buffer = Buffer;
+
+  Fragment.Bulk = Buffer;
+  Fragment.Len  = BufLen;
+  Nbuf          = NetbufFromExt (&Fragment, 1, 0, 0, MnpReturnRxLoan, Loan);
+  if (Nbuf == NULL) {
+    MnpReturnRxLoan (Loan);
+    return NULL;
+  }
+
+  //
+  // Hold one more reference like MnpAllocNbuf does for the pool, so the
+  // NET_BUF is released through MnpFreeNbuf like the others.
+  //
+  NET_GET_REF (Nbuf);
+
+  return Nbuf;
+}
+
+/**
+  Try to receive a packet in a buffer loaned by Snp and deliver it.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+  @retval EFI_SUCCESS           A packet is received.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_OUT_OF_RESOURCES  Snp has no more buffer to loan.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceiveLoanedPacket (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  EFI_STATUS                             Status;
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *RxLoan;
+  NET_BUF                                *Nbuf;
+  VOID                                   *Buffer;
+  UINTN                                  BufLen;
+  UINTN                                  HeaderSize;
+  MNP_SERVICE_DATA                       *MnpServiceData;
+  UINT16                                 VlanId;
+
+  RxLoan = MnpDeviceData->RxLoan;
+  Status = RxLoan->ReceiveLoan (RxLoan, &HeaderSize, &BufLen, &Buffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  MnpDeviceData->RxPackets++;
+
+  //
+  // Sanity check.
+  //
+  if ((HeaderSize != MnpDeviceData->Snp->Mode->MediaHeaderSize) || (BufLen < HeaderSize)) {
+    DEBUG (
+      (DEBUG_WARN,
+       "MnpReceiveLoanedPacket: Size error, HL:TL = %d:%d.\n",
+       HeaderSize,
+       BufLen)
+      );
+    RxLoan->ReturnLoan (RxLoan, Buffer);
+    MnpDeviceData->RxErrors++;
+    return EFI_DEVICE_ERROR;
+  }
+
+  Nbuf = MnpWrapRxLoan (MnpDeviceData, Buffer, (UINT32)BufLen);
+  if (Nbuf == NULL) {
+    DEBUG ((DEBUG_ERROR, "MnpReceiveLoanedPacket: Wrap the loaned buffer failed.\n"));
+    MnpDeviceData->RxErrors++;
+    return EFI_DEVICE_ERROR;
+  }
+
+  VlanId = 0;
+  if (MnpDeviceData->NumberOfVlan != 0) {
+    //
+    // VLAN is configured, remove the VLAN tag if any
+    //
+    MnpRemoveVlanTag (MnpDeviceData, Nbuf, &VlanId);
+  }
+
+  MnpServiceData = MnpFindServiceData (MnpDeviceData, VlanId);
+  if (MnpServiceData != NULL) {
+    //
+    // Enqueue the packet to the matched instances.
+    //
+    MnpEnqueuePacket (MnpServiceData, Nbuf);
+  }
+
+  if (Nbuf->RefCnt > 2) {
+    //
+    // Drop the reference of the receive path, the instances hold the others.
+    //
+    MnpFreeNbuf (MnpDeviceData, Nbuf);
+
+    //
+    // Deliver the queued packets.
+    //
+    MnpDeliverPacket (MnpServiceData);
+  } else {
+    //
+    // No receiver for this packet.
+    //
+    MnpDeviceData->RxNoReceiverDrops++;
+    MnpFreeNbuf (MnpDeviceData, Nbuf);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Try to receive a packet and deliver it.
 
@@ -850,6 +1059,17 @@ MnpReceivePacket (
     return EFI_NOT_STARTED;
   }
 
+  if (MnpDeviceData->RxLoan != NULL) {
+    //
+    // Receive into a buffer loaned by Snp if possible, and fall back to
+    // receiving into the rx cache once Snp has loaned out its buffers.
+    //
+    Status = MnpReceiveLoanedPacket (MnpDeviceData);
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      return Status;
+    }
+  }
+
   if (MnpDeviceData->RxNbufCache == NULL) {
     //
     // Try to get a new buffer as there may be buffers recycled.
@@ -860,6 +1080,7 @@ MnpReceivePacket (
       //
       // No available buffer in the buffer pool.
       //
+      MnpDeviceData->RxErrors++;
       return EFI_DEVICE_ERROR;
     }
 
@@ -890,6 +1111,8 @@ MnpReceivePacket (
     return Status;
   }
 
+  MnpDeviceData->RxPackets++;
+
   //
   // Sanity check.
   //
@@ -900,6 +1123,7 @@ MnpReceivePacket (
        HeaderSize,
        BufLen)
       );
+    MnpDeviceData->RxErrors++;
     return EFI_DEVICE_ERROR;
   }
 
@@ -927,6 +1151,8 @@ MnpReceivePacket (
     //
     // VLAN is not set for this tagged frame, ignore this packet
     //
+    MnpDeviceData->RxNoReceiverDrops++;
+
     if (Trimmed > 0) {
       NetbufAllocSpace (Nbuf, Trimmed, NET_BUF_TAIL);
     }
@@ -954,6 +1180,7 @@ MnpReceivePacket (
     MnpDeviceData->RxNbufCache = Nbuf;
     if (Nbuf == NULL) {
       DEBUG ((DEBUG_ERROR, "MnpReceivePacket: Alloc packet for receiving cache failed.\n"));
+      MnpDeviceData->RxErrors++;
       return EFI_DEVICE_ERROR;
     }
 
@@ -962,6 +1189,8 @@ MnpReceivePacket (
     //
     // No receiver for this packet.
     //
+    MnpDeviceData->RxNoReceiverDrops++;
+
     if (Trimmed > 0) {
       NetbufAllocSpace (Nbuf, Trimmed, NET_BUF_TAIL);
     }
@@ -985,6 +1214,48 @@ EXIT:
   return Status;
 }
 
+/**
+  Receive and deliver the packets pending in Snp, up to MNP_RX_BATCH_SIZE.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[out]      Received             The number of packets received, optional.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                The status of the first receive attempt.
+
+**/
+EFI_STATUS
+MnpReceivePacketBatch (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  OUT    UINTN            *Received OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Count;
+
+  //
+  // Give the buffers released since the last batch back to Snp first, so it
+  // has them to receive into.
+  //
+  MnpReturnRxLoans (MnpDeviceData);
+
+  Status = EFI_SUCCESS;
+  for (Count = 0; Count < MNP_RX_BATCH_SIZE; Count++) {
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  MnpReturnRxLoans (MnpDeviceData);
+
+  if (Received != NULL) {
+    *Received = Count;
+  }
+
+  return (Count != 0) ? EFI_SUCCESS : Status;
+}
+
 /**
   Remove the received packets if timeout occurs.
 
@@ -1044,16 +1315,20 @@ MnpCheckPacketTimeout (
           DEBUG ((DEBUG_WARN, "MnpCheckPacketTimeout: Received packet timeout.\n"));
           MnpRecycleRxData (NULL, RxDataWrap);
           Instance->RcvdPacketQueueSize--;
+          MnpDeviceData->RxTimeoutDrops++;
         }
       }
 
       gBS->RestoreTPL (OldTpl);
     }
   }
+
+  MnpReturnRxLoans (MnpDeviceData);
 }
 
 /**
-  Poll to update MediaPresent field in SNP ModeData by Snp->GetStatus().
+  Poll to update MediaPresent field in SNP ModeData by Snp->GetStatus(),
+  and update the receive rate once a second.
 
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
@@ -1081,6 +1356,87 @@ MnpCheckMediaStatus (
     //
     Snp->GetStatus (Snp, &InterruptStatus, NULL);
   }
+
+  if (++MnpDeviceData->RxRateTicks < MNP_RX_RATE_TICKS) {
+    return;
+  }
+
+  MnpDeviceData->RxRateTicks        = 0;
+  MnpDeviceData->RxPacketsPerSecond = (UINT32)(MnpDeviceData->RxPackets - MnpDeviceData->RxLastPackets);
+  MnpDeviceData->RxLastPackets      = MnpDeviceData->RxPackets;
+
+  if (MnpDeviceData->RxPacketsPerSecond != 0) {
+    DEBUG (
+      (DEBUG_NET,
+       "MnpCheckMediaStatus: rx %d pkt/s, poll %d us, no receiver %ld, queue full %ld, timeout %ld, errors %ld.\n",
+       MnpDeviceData->RxPacketsPerSecond,
+       (UINT32)DivU64x32 (MnpDeviceData->PollInterval, 10),
+       MnpDeviceData->RxNoReceiverDrops,
+       MnpDeviceData->RxQueueDrops,
+       MnpDeviceData->RxTimeoutDrops,
+       MnpDeviceData->RxErrors)
+      );
+  }
+}
+
+/**
+  Get and optionally reset the receive statistics of MNP on a network device.
+
+  @param[in]   This            Pointer to the EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL instance.
+  @param[in]   Reset           TRUE to reset the counters once they are read.
+  @param[out]  Statistics      The statistics, optional when Reset is TRUE.
+
+  @retval EFI_SUCCESS             The statistics are returned, or reset.
+  @retval EFI_INVALID_PARAMETER   This is NULL, or Statistics is NULL and
+                                  Reset is FALSE.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL  *This,
+  IN  BOOLEAN                                    Reset,
+  OUT EDKII_MANAGED_NETWORK_STATISTICS           *Statistics OPTIONAL
+  )
+{
+  MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_TPL          OldTpl;
+
+  if ((This == NULL) || (!Reset && (Statistics == NULL))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MnpDeviceData = MNP_DEVICE_DATA_FROM_STATISTICS (This);
+
+  //
+  // The counters are updated at TPL_CALLBACK.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (Statistics != NULL) {
+    Statistics->RxPackets          = MnpDeviceData->RxPackets;
+    Statistics->RxNoReceiverDrops  = MnpDeviceData->RxNoReceiverDrops;
+    Statistics->RxQueueDrops       = MnpDeviceData->RxQueueDrops;
+    Statistics->RxTimeoutDrops     = MnpDeviceData->RxTimeoutDrops;
+    Statistics->RxErrors           = MnpDeviceData->RxErrors;
+    Statistics->RxPacketsPerSecond = MnpDeviceData->RxPacketsPerSecond;
+    Statistics->PollInterval       = (UINT32)DivU64x32 (MnpDeviceData->PollInterval, 10);
+  }
+
+  if (Reset) {
+    MnpDeviceData->RxPackets          = 0;
+    MnpDeviceData->RxNoReceiverDrops  = 0;
+    MnpDeviceData->RxQueueDrops       = 0;
+    MnpDeviceData->RxTimeoutDrops     = 0;
+    MnpDeviceData->RxErrors           = 0;
+    MnpDeviceData->RxLastPackets      = 0;
+    MnpDeviceData->RxPacketsPerSecond = 0;
+    MnpDeviceData->RxRateTicks        = 0;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1098,15 +1454,63 @@ MnpSystemPoll (
   IN VOID       *Context
   )
 {
-  MNP_DEVICE_DATA  *MnpDeviceData;
+  MNP_DEVICE_DATA              *MnpDeviceData;
+  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
+  BOOLEAN                      Signaled;
+  UINTN                        Received;
+  UINT64                       Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  Snp      = MnpDeviceData->Snp;
+  Received = 0;
+
   //
-  // Try to receive packets from Snp.
+  // Ask the WaitForPacket event of Snp whether a packet is pending. If the
+  // last batch was cut short by MNP_RX_BATCH_SIZE, more packets are pending.
   //
-  MnpReceivePacket (MnpDeviceData);
+  Signaled = MnpDeviceData->RxPending;
+  if (!Signaled && (Snp->WaitForPacket != NULL)) {
+    Signaled = (BOOLEAN)(gBS->CheckEvent (Snp->WaitForPacket) == EFI_SUCCESS);
+  }
+
+  //
+  // Skip the receive when the trusted event says there is nothing to receive,
+  // but try now and then in case the event stops working.
+  //
+  if (Signaled || !MnpDeviceData->RxEventTrusted ||
+      ((++MnpDeviceData->RxIdlePolls % MNP_RX_EVENT_CHECK_POLLS) == 0))
+  {
+    //
+    // Try to receive packets from Snp.
+    //
+    MnpReceivePacketBatch (MnpDeviceData, &Received);
+
+    if ((Received != 0) && (Snp->WaitForPacket != NULL) && !MnpDeviceData->RxPending) {
+      //
+      // Trust the event once it has announced received packets, stop
+      // trusting it as soon as packets arrive unannounced.
+      //
+      MnpDeviceData->RxEventTrusted = Signaled;
+    }
+
+    MnpDeviceData->RxPending = (BOOLEAN)(Received == MNP_RX_BATCH_SIZE);
+  }
+
+  //
+  // Poll fast while packets arrive, back off to MNP_SYS_POLL_INTERVAL when idle.
+  //
+  if (Received != 0) {
+    Interval = MNP_SYS_POLL_INTERVAL_MIN;
+  } else {
+    Interval = MIN (MultU64x32 (MnpDeviceData->PollInterval, 2), MNP_SYS_POLL_INTERVAL);
+  }
+
+  if (Interval != MnpDeviceData->PollInterval) {
+    MnpDeviceData->PollInterval = Interval;
+    gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval);
+  }
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -773,7 +773,7 @@ MnpPoll (
   //
   // Try to receive packets.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePacketBatch (Instance->MnpServiceData->MnpDeviceData, NULL);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -476,8 +476,9 @@ Mtftp4InitProtocol (
   Instance->Signature = MTFTP4_PROTOCOL_SIGNATURE;
   InitializeListHead (&Instance->Link);
   CopyMem (&Instance->Mtftp4, &gMtftp4ProtocolTemplate, sizeof (Instance->Mtftp4));
-  Instance->State   = MTFTP4_STATE_UNCONFIGED;
-  Instance->Service = MtftpSb;
+  Instance->State       = MTFTP4_STATE_UNCONFIGED;
+  Instance->Service     = MtftpSb;
+  Instance->WindowLimit = MAX_UINT16;
 
   InitializeListHead (&Instance->Blocks);
 }
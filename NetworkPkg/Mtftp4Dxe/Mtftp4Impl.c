@@ -67,12 +67,20 @@ Mtftp4CleanOperation (
     FreePool (Block);
   }
 
+  if ((Instance->Operation == EFI_MTFTP4_OPCODE_RRQ) ||
+      (Instance->Operation == EFI_MTFTP4_OPCODE_DIR))
+  {
+    Mtftp4RrqUpdateWindowLimit (Instance, Result);
+  }
+
   ZeroMem (&Instance->RequestOption, sizeof (MTFTP4_OPTION));
 
   Instance->Operation = 0;
 
   Instance->BlkSize       = MTFTP4_DEFAULT_BLKSIZE;
   Instance->WindowSize    = 1;
+  Instance->LossCount     = 0;
+  Instance->GapAcked      = FALSE;
   Instance->TotalBlock    = 0;
   Instance->AckedBlock    = 0;
   Instance->LastBlock     = 0;
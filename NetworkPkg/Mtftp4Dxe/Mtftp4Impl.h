@@ -52,6 +52,12 @@ typedef struct _MTFTP4_PROTOCOL  MTFTP4_PROTOCOL;
 #define MTFTP4_DEFAULT_WINDOWSIZE   1
 #define MTFTP4_TIME_TO_GETMAP       5
 
+///
+/// The windowsize proposed for the next download is halved when more than
+/// one window in MTFTP4_WINDOW_LOSS_RATIO needed a recovery.
+///
+#define MTFTP4_WINDOW_LOSS_RATIO  8
+
 #define MTFTP4_STATE_UNCONFIGED  0
 #define MTFTP4_STATE_CONFIGED    1
 #define MTFTP4_STATE_DESTROY     2
@@ -116,6 +122,16 @@ struct _MTFTP4_PROTOCOL {
 
   UINT16                    WindowSize;
 
+  //
+  // WindowLimit caps the windowsize proposed in the request. It survives
+  // the session and is adapted to the losses seen by the downloads of this
+  // child: LossCount counts the gaps and timeouts of the current download,
+  // GapAcked is set once a gap in the current window has been acknowledged.
+  //
+  UINT16                    WindowLimit;
+  UINT32                    LossCount;
+  BOOLEAN                   GapAcked;
+
   //
   // Record the total received and saved block number.
   //
@@ -214,6 +230,38 @@ Mtftp4RrqStart (
   IN UINT16           Operation
   );
 
+/**
+  Handle the timeout of a download session.
+
+  If only part of the current window has arrived, the ACK sent for the
+  previous window is stale. Acknowledge the blocks received since then
+  instead, so that the server restarts from the first missing block.
+
+  @param  Instance              The downloading MTFTP session
+
+  @retval TRUE                  A new ACK has been sent.
+  @retval FALSE                 The last packet should be retransmitted.
+
+**/
+BOOLEAN
+Mtftp4RrqTimeout (
+  IN MTFTP4_PROTOCOL  *Instance
+  );
+
+/**
+  Adapt the windowsize limit of the session to the losses seen by the
+  download that just finished.
+
+  @param  Instance              The downloading MTFTP session
+  @param  Result                The result of the download.
+
+**/
+VOID
+Mtftp4RrqUpdateWindowLimit (
+  IN OUT MTFTP4_PROTOCOL  *Instance,
+  IN     EFI_STATUS       Result
+  );
+
 #define MTFTP4_SERVICE_FROM_THIS(a)   \
   CR (a, MTFTP4_SERVICE, ServiceBinding, MTFTP4_SERVICE_SIGNATURE)
 
@@ -264,6 +264,18 @@ Mtftp4RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->Master && (Expected != BlockNum)) {
+    //
+    // After a block of a window is lost, the rest of the window arrives
+    // out of order too. Only acknowledge the gap once (RFC 7440), or the
+    // server would restart the window for each of those blocks.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+    Instance->LossCount++;
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -276,6 +288,8 @@ Mtftp4RrqHandleData (
     return Status;
   }
 
+  Instance->GapAcked = FALSE;
+
   //
   // Record the total received and saved block number.
   //
@@ -319,6 +333,86 @@ Mtftp4RrqHandleData (
   return Status;
 }
 
+/**
+  Handle the timeout of a download session.
+
+  If only part of the current window has arrived, the ACK sent for the
+  previous window is stale. Acknowledge the blocks received since then
+  instead, so that the server restarts from the first missing block.
+
+  @param  Instance              The downloading MTFTP session
+
+  @retval TRUE                  A new ACK has been sent.
+  @retval FALSE                 The last packet should be retransmitted.
+
+**/
+BOOLEAN
+Mtftp4RrqTimeout (
+  IN MTFTP4_PROTOCOL  *Instance
+  )
+{
+  INTN  Expected;
+
+  if (Instance->TotalBlock == 0) {
+    return FALSE;
+  }
+
+  Instance->LossCount++;
+
+  if (!Instance->Master || (Instance->TotalBlock == Instance->AckedBlock)) {
+    return FALSE;
+  }
+
+  Expected = Mtftp4GetNextBlockNum (&Instance->Blocks);
+  if (Expected < 0) {
+    return FALSE;
+  }
+
+  Instance->GapAcked = TRUE;
+  return (BOOLEAN)!EFI_ERROR (Mtftp4RrqSendAck (Instance, (UINT16)(Expected - 1)));
+}
+
+/**
+  Adapt the windowsize limit of the session to the losses seen by the
+  download that just finished.
+
+  The limit is halved when more than one window in MTFTP4_WINDOW_LOSS_RATIO
+  needed a recovery, and doubled after a loss free download that used the
+  whole limit. Downloads that didn't negotiate a windowsize, or that failed
+  for another reason than a timeout, leave it unchanged.
+
+  @param  Instance              The downloading MTFTP session
+  @param  Result                The result of the download.
+
+**/
+VOID
+Mtftp4RrqUpdateWindowLimit (
+  IN OUT MTFTP4_PROTOCOL  *Instance,
+  IN     EFI_STATUS       Result
+  )
+{
+  UINT64  Windows;
+
+  if (((Instance->RequestOption.Exist & MTFTP4_WINDOWSIZE_EXIST) == 0) ||
+      (Instance->TotalBlock == 0) ||
+      (EFI_ERROR (Result) && (Result != EFI_TIMEOUT)))
+  {
+    return;
+  }
+
+  Windows = DivU64x32 (Instance->TotalBlock, Instance->WindowSize) + 1;
+
+  if (EFI_ERROR (Result) ||
+      (MultU64x32 (Instance->LossCount, MTFTP4_WINDOW_LOSS_RATIO) > Windows))
+  {
+    Instance->WindowLimit = MAX (Instance->WindowSize / 2, 1);
+  } else if ((Instance->LossCount == 0) &&
+             (Instance->WindowSize == Instance->WindowLimit))
+  {
+    Instance->WindowLimit = (UINT16)MIN ((UINT32)Instance->WindowLimit * 2, MAX_UINT16);
+  }
+}
+
 /**
   Validate whether the options received in the server's OACK packet is valid.
 
@@ -352,10 +446,12 @@ Mtftp4RrqOackValid (
 
   //
   // Server can only specify a smaller block size and window size to be used and
-  // return the timeout matches that requested.
+  // return the timeout matches that requested. The window size put in the
+  // request was capped by the window size limit of the session, so the
+  // reply is bounded by that and not by the user's window size.
   //
   if ((((Reply->Exist & MTFTP4_BLKSIZE_EXIST) != 0) && (Reply->BlkSize > Request->BlkSize)) ||
-      (((Reply->Exist & MTFTP4_WINDOWSIZE_EXIST) != 0) && (Reply->WindowSize > Request->WindowSize)) ||
+      (((Reply->Exist & MTFTP4_WINDOWSIZE_EXIST) != 0) && (Reply->WindowSize > MIN (Request->WindowSize, This->WindowLimit))) ||
       (((Reply->Exist & MTFTP4_TIMEOUT_EXIST) != 0) && (Reply->Timeout != Request->Timeout))
       )
   {
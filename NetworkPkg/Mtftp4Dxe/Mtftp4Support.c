@@ -245,6 +245,32 @@ Mtftp4RemoveBlockNum (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Get the value string to put in the request packet for an option.
+
+  @param  Option                The option requested by the user
+  @param  WindowStr             The windowsize to propose instead of the
+                                user's one, or an empty string.
+
+  @return The value string of the option.
+
+**/
+STATIC
+UINT8 *
+Mtftp4RequestValueStr (
+  IN EFI_MTFTP4_OPTION  *Option,
+  IN UINT8              *WindowStr
+  )
+{
+  if ((WindowStr[0] != '\0') &&
+      (AsciiStriCmp ((CHAR8 *)Option->OptionStr, "windowsize") == 0))
+  {
+    return WindowStr;
+  }
+
+  return Option->ValueStr;
+}
+
 /**
   Build then transmit the request packet for the MTFTP session.
 
@@ -273,6 +299,8 @@ Mtftp4SendRequest (
   UINTN              ModeLength;
   UINTN              OptionStrLength;
   UINTN              ValueStrLength;
+  UINT8              *ValueStr;
+  UINT8              WindowStr[6];
 
   Token   = Instance->Token;
   Options = Token->OptionList;
@@ -282,6 +310,17 @@ Mtftp4SendRequest (
     Mode = (UINT8 *)"octet";
   }
 
+  //
+  // Don't propose a bigger windowsize than the previous downloads could
+  // sustain without losses.
+  //
+  WindowStr[0] = '\0';
+  if (((Instance->RequestOption.Exist & MTFTP4_WINDOWSIZE_EXIST) != 0) &&
+      (Instance->RequestOption.WindowSize > Instance->WindowLimit))
+  {
+    AsciiValueToStringS ((CHAR8 *)WindowStr, sizeof (WindowStr), 0, Instance->WindowLimit, 0);
+  }
+
   //
   // Compute the packet length
   //
@@ -290,8 +329,9 @@ Mtftp4SendRequest (
   BufferLength   = (UINT32)FileNameLength + (UINT32)ModeLength + 4;
 
   for (Index = 0; Index < Token->OptionCount; Index++) {
+    ValueStr        = Mtftp4RequestValueStr (&Options[Index], WindowStr);
     OptionStrLength = AsciiStrLen ((CHAR8 *)Options[Index].OptionStr);
-    ValueStrLength  = AsciiStrLen ((CHAR8 *)Options[Index].ValueStr);
+    ValueStrLength  = AsciiStrLen ((CHAR8 *)ValueStr);
     BufferLength   += (UINT32)OptionStrLength + (UINT32)ValueStrLength + 2;
   }
 
@@ -319,15 +359,16 @@ Mtftp4SendRequest (
   Cur          += ModeLength + 1;
 
   for (Index = 0; Index < Token->OptionCount; ++Index) {
+    ValueStr        = Mtftp4RequestValueStr (&Options[Index], WindowStr);
     OptionStrLength = AsciiStrLen ((CHAR8 *)Options[Index].OptionStr);
-    ValueStrLength  = AsciiStrLen ((CHAR8 *)Options[Index].ValueStr);
+    ValueStrLength  = AsciiStrLen ((CHAR8 *)ValueStr);
 
     Status = AsciiStrCpyS ((CHAR8 *)Cur, BufferLength, (CHAR8 *)Options[Index].OptionStr);
     ASSERT_EFI_ERROR (Status);
     BufferLength -= (UINT32)(OptionStrLength + 1);
     Cur          += OptionStrLength + 1;
 
-    Status = AsciiStrCpyS ((CHAR8 *)Cur, BufferLength, (CHAR8 *)Options[Index].ValueStr);
+    Status = AsciiStrCpyS ((CHAR8 *)Cur, BufferLength, (CHAR8 *)ValueStr);
     ASSERT_EFI_ERROR (Status);
     BufferLength -= (UINT32)(ValueStrLength + 1);
     Cur          += ValueStrLength + 1;
@@ -635,6 +676,16 @@ Mtftp4OnTimerTick (
       continue;
     }
 
+    //
+    // A download may rather acknowledge the part of the window received.
+    //
+    if (((Instance->Operation == EFI_MTFTP4_OPCODE_RRQ) ||
+         (Instance->Operation == EFI_MTFTP4_OPCODE_DIR)) &&
+        Mtftp4RrqTimeout (Instance))
+    {
+      continue;
+    }
+
     //
     // Retransmit the packet if haven't reach the maximum retry count,
     // otherwise exit the transfer.
@@ -206,9 +206,10 @@ Mtftp6CreateInstance (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Mtftp6Ins->Signature = MTFTP6_INSTANCE_SIGNATURE;
-  Mtftp6Ins->InDestroy = FALSE;
-  Mtftp6Ins->Service   = Service;
+  Mtftp6Ins->Signature   = MTFTP6_INSTANCE_SIGNATURE;
+  Mtftp6Ins->InDestroy   = FALSE;
+  Mtftp6Ins->Service     = Service;
+  Mtftp6Ins->WindowLimit = MAX_UINT16;
 
   CopyMem (
     &Mtftp6Ins->Mtftp6,
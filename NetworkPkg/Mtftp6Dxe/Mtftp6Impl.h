@@ -43,6 +43,12 @@ typedef struct _MTFTP6_INSTANCE  MTFTP6_INSTANCE;
 #define MTFTP6_DEFAULT_WINDOWSIZE       1
 #define MTFTP6_TICK_PER_SECOND          10000000U
 
+//
+// The windowsize proposed for the next download is halved when more than
+// one window in MTFTP6_WINDOW_LOSS_RATIO needed a recovery.
+//
+#define MTFTP6_WINDOW_LOSS_RATIO  8
+
 #define MTFTP6_SERVICE_FROM_THIS(a)   CR (a, MTFTP6_SERVICE, ServiceBinding, MTFTP6_SERVICE_SIGNATURE)
 #define MTFTP6_INSTANCE_FROM_THIS(a)  CR (a, MTFTP6_INSTANCE, Mtftp6, MTFTP6_INSTANCE_SIGNATURE)
 
@@ -76,6 +82,16 @@ struct _MTFTP6_INSTANCE {
 
   UINT16                    WindowSize;
 
+  //
+  // WindowLimit caps the windowsize proposed in the request. It survives
+  // the operation and is adapted to the losses seen by the downloads of this
+  // child: LossCount counts the gaps and timeouts of the current download,
+  // GapAcked is set once a gap in the current window has been acknowledged.
+  //
+  UINT16                    WindowLimit;
+  UINT32                    LossCount;
+  BOOLEAN                   GapAcked;
+
   //
   // Record the total received and saved block number.
   //
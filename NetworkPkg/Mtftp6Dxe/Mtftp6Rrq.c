@@ -234,6 +234,18 @@ Mtftp6RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->IsMaster && (Expected != BlockNum)) {
+    //
+    // After a block of a window is lost, the rest of the window arrives
+    // out of order too. Only acknowledge the gap once (RFC 7440), or the
+    // server would restart the window for each of those blocks.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+    Instance->LossCount++;
+
     //
     // Free the received packet before send new packet in ReceiveNotify,
     // since the udpio might need to be reconfigured.
@@ -253,6 +265,8 @@ Mtftp6RrqHandleData (
     return Status;
   }
 
+  Instance->GapAcked = FALSE;
+
   //
   // Record the total received and saved block number.
   //
@@ -302,6 +316,85 @@ Mtftp6RrqHandleData (
   return Status;
 }
 
+/**
+  Handle the timeout of a download. If only part of the current window has
+  arrived, the ACK sent for the previous window is stale: acknowledge the
+  blocks received since then instead, so that the server restarts from the
+  first missing block.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+
+  @retval TRUE                  A new ACK has been sent.
+  @retval FALSE                 The last packet should be retransmitted.
+
+**/
+BOOLEAN
+Mtftp6RrqTimeout (
+  IN MTFTP6_INSTANCE  *Instance
+  )
+{
+  INTN  Expected;
+
+  if (Instance->TotalBlock == 0) {
+    return FALSE;
+  }
+
+  Instance->LossCount++;
+
+  if (!Instance->IsMaster || (Instance->TotalBlock == Instance->AckedBlock)) {
+    return FALSE;
+  }
+
+  Expected = Mtftp6GetNextBlockNum (&Instance->BlkList);
+  if (Expected < 0) {
+    return FALSE;
+  }
+
+  Instance->GapAcked = TRUE;
+  return (BOOLEAN)!EFI_ERROR (Mtftp6RrqSendAck (Instance, (UINT16)(Expected - 1)));
+}
+
+/**
+  Adapt the windowsize limit of the Mtftp6 instance to the losses seen by
+  the download that just finished.
+
+  The limit is halved when more than one window in MTFTP6_WINDOW_LOSS_RATIO
+  needed a recovery, and doubled after a loss free download that used the
+  whole limit. Downloads that didn't negotiate a windowsize, or that failed
+  for another reason than a timeout, leave it unchanged.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+  @param[in]  Result                The result of the download.
+
+**/
+VOID
+Mtftp6RrqUpdateWindowLimit (
+  IN MTFTP6_INSTANCE  *Instance,
+  IN EFI_STATUS       Result
+  )
+{
+  UINT64  Windows;
+
+  if (((Instance->ExtInfo.BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) == 0) ||
+      (Instance->TotalBlock == 0) ||
+      (EFI_ERROR (Result) && (Result != EFI_TIMEOUT)))
+  {
+    return;
+  }
+
+  Windows = DivU64x32 (Instance->TotalBlock, Instance->WindowSize) + 1;
+
+  if (EFI_ERROR (Result) ||
+      (MultU64x32 (Instance->LossCount, MTFTP6_WINDOW_LOSS_RATIO) > Windows))
+  {
+    Instance->WindowLimit = MAX (Instance->WindowSize / 2, 1);
+  } else if ((Instance->LossCount == 0) &&
+             (Instance->WindowSize == Instance->WindowLimit))
+  {
+    Instance->WindowLimit = (UINT16)MIN ((UINT32)Instance->WindowLimit * 2, MAX_UINT16);
+  }
+}
+
 /**
   Validate whether the options received in the server's OACK packet is valid.
   The options are valid only if:
@@ -334,10 +427,12 @@ Mtftp6RrqOackValid (
 
   //
   // Server can only specify a smaller block size and windowsize to be used and
-  // return the timeout matches that requested.
+  // return the timeout matches that requested. The windowsize put in the
+  // request was capped by the windowsize limit of the instance, so the
+  // reply is bounded by that and not by the user's windowsize.
   //
   if ((((ReplyInfo->BitMap & MTFTP6_OPT_BLKSIZE_BIT) != 0) && (ReplyInfo->BlkSize > RequestInfo->BlkSize)) ||
-      (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->BlkSize > RequestInfo->BlkSize)) ||
+      (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->WindowSize > MIN (RequestInfo->WindowSize, Instance->WindowLimit))) ||
       (((ReplyInfo->BitMap & MTFTP6_OPT_TIMEOUT_BIT) != 0) && (ReplyInfo->Timeout != RequestInfo->Timeout))
       )
   {
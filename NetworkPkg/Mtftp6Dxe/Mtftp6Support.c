@@ -436,6 +436,32 @@ Mtftp6ConfigUdpIo (
   return Status;
 }
 
+/**
+  Get the value string to put in the request packet for an option.
+
+  @param[in]  Option                 The option requested by the user.
+  @param[in]  WindowStr              The windowsize to propose instead of the
+                                     user's one, or an empty string.
+
+  @return The value string of the option.
+
+**/
+STATIC
+UINT8 *
+Mtftp6RequestValueStr (
+  IN EFI_MTFTP6_OPTION  *Option,
+  IN UINT8              *WindowStr
+  )
+{
+  if ((WindowStr[0] != '\0') &&
+      (AsciiStriCmp ((CHAR8 *)Option->OptionStr, "windowsize") == 0))
+  {
+    return WindowStr;
+  }
+
+  return Option->ValueStr;
+}
+
 /**
   Build and transmit the request packet for the Mtftp6 instance.
 
@@ -466,6 +492,8 @@ Mtftp6SendRequest (
   UINTN              ModeLength;
   UINTN              OptionStrLength;
   UINTN              ValueStrLength;
+  UINT8              *ValueStr;
+  UINT8              WindowStr[6];
 
   Token   = Instance->Token;
   Options = Token->OptionList;
@@ -475,6 +503,17 @@ Mtftp6SendRequest (
     Mode = (UINT8 *)"octet";
   }
 
+  //
+  // Don't propose a bigger windowsize than the previous downloads could
+  // sustain without losses.
+  //
+  WindowStr[0] = '\0';
+  if (((Instance->ExtInfo.BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) &&
+      (Instance->ExtInfo.WindowSize > Instance->WindowLimit))
+  {
+    AsciiValueToStringS ((CHAR8 *)WindowStr, sizeof (WindowStr), 0, Instance->WindowLimit, 0);
+  }
+
   //
   // The header format of RRQ/WRQ packet is:
   //
@@ -499,8 +538,9 @@ Mtftp6SendRequest (
   BufferLength   = (UINT32)FileNameLength + (UINT32)ModeLength + 4;
 
   for (Index = 0; Index < Token->OptionCount; Index++) {
+    ValueStr        = Mtftp6RequestValueStr (&Options[Index], WindowStr);
     OptionStrLength = AsciiStrLen ((CHAR8 *)Options[Index].OptionStr);
-    ValueStrLength  = AsciiStrLen ((CHAR8 *)Options[Index].ValueStr);
+    ValueStrLength  = AsciiStrLen ((CHAR8 *)ValueStr);
     BufferLength   += (UINT32)OptionStrLength + (UINT32)ValueStrLength + 2;
   }
 
@@ -534,15 +574,16 @@ Mtftp6SendRequest (
   // Copy all the extension options into the packet.
   //
   for (Index = 0; Index < Token->OptionCount; ++Index) {
+    ValueStr        = Mtftp6RequestValueStr (&Options[Index], WindowStr);
     OptionStrLength = AsciiStrLen ((CHAR8 *)Options[Index].OptionStr);
-    ValueStrLength  = AsciiStrLen ((CHAR8 *)Options[Index].ValueStr);
+    ValueStrLength  = AsciiStrLen ((CHAR8 *)ValueStr);
 
     Status = AsciiStrCpyS ((CHAR8 *)Cur, BufferLength, (CHAR8 *)Options[Index].OptionStr);
     ASSERT_EFI_ERROR (Status);
     BufferLength -= (UINT32)(OptionStrLength + 1);
     Cur          += OptionStrLength + 1;
 
-    Status = AsciiStrCpyS ((CHAR8 *)Cur, BufferLength, (CHAR8 *)Options[Index].ValueStr);
+    Status = AsciiStrCpyS ((CHAR8 *)Cur, BufferLength, (CHAR8 *)ValueStr);
     ASSERT_EFI_ERROR (Status);
     BufferLength -= (UINT32)(ValueStrLength + 1);
     Cur          += ValueStrLength + 1;
@@ -943,6 +984,12 @@ Mtftp6OperationClean (
     FreePool (Block);
   }
 
+  if ((Instance->Operation == EFI_MTFTP6_OPCODE_RRQ) ||
+      (Instance->Operation == EFI_MTFTP6_OPCODE_DIR))
+  {
+    Mtftp6RrqUpdateWindowLimit (Instance, Result);
+  }
+
   //
   // Reinitialize the corresponding fields of the Mtftp6 operation.
   //
@@ -956,6 +1003,8 @@ Mtftp6OperationClean (
   Instance->BlkSize        = 0;
   Instance->Operation      = 0;
   Instance->WindowSize     = 1;
+  Instance->LossCount      = 0;
+  Instance->GapAcked       = FALSE;
   Instance->TotalBlock     = 0;
   Instance->AckedBlock     = 0;
   Instance->LastBlk        = 0;
@@ -1210,6 +1259,16 @@ Mtftp6OnTimerTick (
       }
     }
 
+    //
+    // A download may rather acknowledge the part of the window received.
+    //
+    if (((Instance->Operation == EFI_MTFTP6_OPCODE_RRQ) ||
+         (Instance->Operation == EFI_MTFTP6_OPCODE_DIR)) &&
+        Mtftp6RrqTimeout (Instance))
+    {
+      continue;
+    }
+
     //
     // Retransmit the packet if haven't reach the maximum retry count,
     // otherwise exit the transfer.
@@ -333,4 +333,35 @@ Mtftp6RrqStart (
   IN UINT16           Operation
   );
 
+/**
+  Handle the timeout of a download. If only part of the current window has
+  arrived, the ACK sent for the previous window is stale: acknowledge the
+  blocks received since then instead, so that the server restarts from the
+  first missing block.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+
+  @retval TRUE                  A new ACK has been sent.
+  @retval FALSE                 The last packet should be retransmitted.
+
+**/
+BOOLEAN
+Mtftp6RrqTimeout (
+  IN MTFTP6_INSTANCE  *Instance
+  );
+
+/**
+  Adapt the windowsize limit of the Mtftp6 instance to the losses seen by
+  the download that just finished.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+  @param[in]  Result                The result of the download.
+
+**/
+VOID
+Mtftp6RrqUpdateWindowLimit (
+  IN MTFTP6_INSTANCE  *Instance,
+  IN EFI_STATUS       Result
+  );
+
 #endif
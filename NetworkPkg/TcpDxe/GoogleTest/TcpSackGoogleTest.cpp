@@ -0,0 +1,728 @@
+/** @file
+  Tests for TcpSack.c and TcpCongestion.c.
+
+  Besides the unit tests of the SACK scoreboard and of the congestion
+  window computations, a simulation drives the sender side of a bulk
+  transfer over a bottleneck link that drops segments, and measures the
+  goodput of the loss recovery and congestion control combinations.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <utility>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_MSS  1460
+#define TEST_ISS  1000000
+
+#define TEST_SEQ(Index)  ((TCP_SEQNO)(TEST_ISS + (Index) * TEST_MSS))
+
+class TcpLossySimulation;
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These functions are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+UINT32                     mTcpTick;
+static TcpLossySimulation  *mSimulation;
+static std::vector<UINT32> mRetransmitted;
+
+VOID
+TcpSimulationSend (
+  IN TCP_SEQNO  Seq
+  );
+
+INTN
+TcpRetransmit (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Seq
+  )
+{
+  mRetransmitted.push_back (Seq);
+
+  if (mSimulation != NULL) {
+    TcpSimulationSend (Seq);
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+static
+VOID
+InitTcb (
+  OUT TCP_CB   *Tcb,
+  IN  BOOLEAN  Sack,
+  IN  UINT8    CongestAlgo
+  )
+{
+  ZeroMem (Tcb, sizeof (TCP_CB));
+
+  Tcb->SndMss       = TEST_MSS;
+  Tcb->SndUna       = TEST_ISS;
+  Tcb->SndNxt       = TEST_ISS;
+  Tcb->CWnd         = TEST_MSS;
+  Tcb->Ssthresh     = 0xffffffff;
+  Tcb->CongestState = TCP_CONGEST_OPEN;
+  Tcb->SndWndScale  = 14;
+
+  TcpCcInit (Tcb);
+  Tcb->CongestAlgo = CongestAlgo;
+
+  if (Sack) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SND_SACK);
+  }
+}
+
+static
+VOID
+SackOption (
+  OUT TCP_OPTION  *Option,
+  IN  UINT32      Num,
+  IN  UINT32      *Index
+  )
+{
+  UINT32  Block;
+
+  ZeroMem (Option, sizeof (TCP_OPTION));
+  Option->Flag    = TCP_OPTION_RCVD_SACK;
+  Option->SackNum = (UINT8)Num;
+
+  for (Block = 0; Block < Num; Block++) {
+    Option->Sack[Block].Left  = TEST_SEQ (Index[2 * Block]);
+    Option->Sack[Block].Right = TEST_SEQ (Index[2 * Block + 1]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpSackUpdate Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpSackTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+  TCP_OPTION Option;
+
+  virtual void
+  SetUp (
+    )
+  {
+    InitTcb (&Tcb, TRUE, TCP_CC_NEWRENO);
+    Tcb.SndNxt = TEST_SEQ (100);
+    Tcb.CWnd   = 100 * TEST_MSS;
+    mRetransmitted.clear ();
+  }
+};
+
+// Test Description:
+// Blocks are kept sorted and merged when they overlap or touch.
+TEST_F (TcpSackTest, UpdateShouldMergeAndSortBlocks) {
+  UINT32  First[]  = { 10, 12, 4, 6 };
+  UINT32  Second[] = { 6, 8, 12, 14 };
+
+  SackOption (&Option, 2, First);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+
+  ASSERT_EQ (Tcb.SackNum, 2);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, TEST_SEQ (4));
+  EXPECT_EQ (Tcb.SackBlock[1].Left, TEST_SEQ (10));
+
+  SackOption (&Option, 2, Second);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+
+  ASSERT_EQ (Tcb.SackNum, 2);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, TEST_SEQ (4));
+  EXPECT_EQ (Tcb.SackBlock[0].Right, TEST_SEQ (8));
+  EXPECT_EQ (Tcb.SackBlock[1].Left, TEST_SEQ (10));
+  EXPECT_EQ (Tcb.SackBlock[1].Right, TEST_SEQ (14));
+}
+
+// Test Description:
+// The cumulative ACK removes and trims the blocks below it.
+TEST_F (TcpSackTest, UpdateShouldTrimAtCumulativeAck) {
+  UINT32  Blocks[] = { 2, 4, 6, 9 };
+
+  SackOption (&Option, 2, Blocks);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+
+  ZeroMem (&Option, sizeof (Option));
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (7));
+
+  ASSERT_EQ (Tcb.SackNum, 1);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, TEST_SEQ (7));
+  EXPECT_EQ (Tcb.SackBlock[0].Right, TEST_SEQ (9));
+}
+
+// Test Description:
+// D-SACK blocks and blocks beyond SND.NXT are ignored.
+TEST_F (TcpSackTest, UpdateShouldIgnoreInvalidBlocks) {
+  UINT32  Blocks[] = { 1, 3, 99, 101, 8, 5 };
+
+  SackOption (&Option, 3, Blocks);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (5));
+
+  EXPECT_EQ (Tcb.SackNum, 0);
+}
+
+// Test Description:
+// When the scoreboard is full, the highest block is dropped.
+TEST_F (TcpSackTest, UpdateShouldDropHighestBlockWhenFull) {
+  UINT32  Index;
+  UINT32  Blocks[2];
+
+  for (Index = 0; Index <= TCP_SACK_SCOREBOARD_SIZE; Index++) {
+    Blocks[0] = 40 - 2 * Index;
+    Blocks[1] = Blocks[0] + 1;
+    SackOption (&Option, 1, Blocks);
+    TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+  }
+
+  ASSERT_EQ (Tcb.SackNum, TCP_SACK_SCOREBOARD_SIZE);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, TEST_SEQ (40 - 2 * TCP_SACK_SCOREBOARD_SIZE));
+  EXPECT_EQ (Tcb.SackBlock[TCP_SACK_SCOREBOARD_SIZE - 1].Left, TEST_SEQ (40 - 2));
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpSackPipe, TcpSackNextHole and TcpSackIsLost Tests
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// The holes below the highest SACKed byte are deemed lost until they
+// are retransmitted.
+TEST_F (TcpSackTest, PipeShouldNotCountSackedOrLostBytes) {
+  UINT32  Blocks[] = { 2, 4, 6, 8 };
+
+  SackOption (&Option, 2, Blocks);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+  Tcb.HighRxt = TEST_SEQ (0);
+
+  EXPECT_EQ (TcpSackPipe (&Tcb, TEST_SEQ (0)), (UINT32)(92 * TEST_MSS));
+
+  Tcb.HighRxt = TEST_SEQ (1);
+  EXPECT_EQ (TcpSackPipe (&Tcb, TEST_SEQ (0)), (UINT32)(93 * TEST_MSS));
+}
+
+// Test Description:
+// The holes are returned in order, starting at HighRxt.
+TEST_F (TcpSackTest, NextHoleShouldWalkHolesFromHighRxt) {
+  UINT32     Blocks[] = { 2, 4, 6, 8 };
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+
+  SackOption (&Option, 2, Blocks);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+  Tcb.HighRxt = TEST_SEQ (1);
+
+  ASSERT_TRUE (TcpSackNextHole (&Tcb, TEST_SEQ (0), &Seq, &Len));
+  EXPECT_EQ (Seq, TEST_SEQ (1));
+  EXPECT_EQ (Len, (UINT32)TEST_MSS);
+
+  Tcb.HighRxt = TEST_SEQ (2);
+  ASSERT_TRUE (TcpSackNextHole (&Tcb, TEST_SEQ (0), &Seq, &Len));
+  EXPECT_EQ (Seq, TEST_SEQ (4));
+
+  Tcb.HighRxt = TEST_SEQ (6);
+  EXPECT_FALSE (TcpSackNextHole (&Tcb, TEST_SEQ (0), &Seq, &Len));
+}
+
+// Test Description:
+// SND.UNA is lost once more than two segments above it are SACKed.
+TEST_F (TcpSackTest, IsLostShouldUseDupThreshSegments) {
+  UINT32  Two[]   = { 1, 3 };
+  UINT32  Three[] = { 4, 5 };
+
+  SackOption (&Option, 1, Two);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+  EXPECT_FALSE (TcpSackIsLost (&Tcb, TEST_SEQ (0)));
+
+  SackOption (&Option, 1, Three);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+  EXPECT_TRUE (TcpSackIsLost (&Tcb, TEST_SEQ (0)));
+
+  TCP_CLEAR_FLG (Tcb.CtrlFlag, TCP_CTRL_SND_SACK);
+  EXPECT_FALSE (TcpSackIsLost (&Tcb, TEST_SEQ (0)));
+}
+
+// Test Description:
+// Entering the recovery retransmits all the holes the window allows.
+TEST_F (TcpSackTest, RecoverShouldRetransmitAllHolesInOneRound) {
+  UINT32   Blocks[] = { 1, 20, 21, 40, 41, 60 };
+  TCP_SEG  Seg;
+
+  Tcb.SndNxt = TEST_SEQ (60);
+  Tcb.CWnd   = 60 * TEST_MSS;
+  SackOption (&Option, 3, Blocks);
+  TcpSackUpdate (&Tcb, &Option, TEST_SEQ (0));
+
+  ZeroMem (&Seg, sizeof (Seg));
+  Seg.Ack = TEST_SEQ (0);
+  TcpSackRecover (&Tcb, &Seg);
+
+  EXPECT_EQ (Tcb.CongestState, TCP_CONGEST_RECOVER);
+  EXPECT_EQ (Tcb.Ssthresh, (UINT32)(30 * TEST_MSS));
+  ASSERT_EQ (mRetransmitted.size (), 3U);
+  EXPECT_EQ (mRetransmitted[0], TEST_SEQ (0));
+  EXPECT_EQ (mRetransmitted[1], TEST_SEQ (20));
+  EXPECT_EQ (mRetransmitted[2], TEST_SEQ (40));
+
+  Seg.Ack = TEST_SEQ (60);
+  TcpSackUpdate (&Tcb, &Option, Seg.Ack);
+  TcpSackRecover (&Tcb, &Seg);
+
+  EXPECT_EQ (Tcb.CongestState, TCP_CONGEST_OPEN);
+  EXPECT_EQ (Tcb.CWnd, Tcb.Ssthresh);
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpCongestion Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpCongestionTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+};
+
+// Test Description:
+// NewReno halves the flight size, CUBIC reduces the window by 30%.
+TEST_F (TcpCongestionTest, SsthreshShouldFollowAlgorithm) {
+  InitTcb (&Tcb, FALSE, TCP_CC_NEWRENO);
+  Tcb.SndNxt = TEST_SEQ (100);
+  Tcb.CWnd   = 100 * TEST_MSS;
+  EXPECT_EQ (TcpCcSsthresh (&Tcb), (UINT32)(50 * TEST_MSS));
+
+  InitTcb (&Tcb, FALSE, TCP_CC_CUBIC);
+  Tcb.SndNxt = TEST_SEQ (100);
+  Tcb.CWnd   = 100 * TEST_MSS;
+  EXPECT_EQ (TcpCcSsthresh (&Tcb), (UINT32)(70 * TEST_MSS));
+  EXPECT_EQ (Tcb.CubicWMax, (UINT32)(100 * TEST_MSS));
+
+  //
+  // Fast convergence: a loss below the last maximum lowers WMax further.
+  //
+  Tcb.SndNxt = TEST_SEQ (80);
+  Tcb.CWnd   = 80 * TEST_MSS;
+  TcpCcSsthresh (&Tcb);
+  EXPECT_EQ (Tcb.CubicWMax, (UINT32)(68 * TEST_MSS));
+}
+
+// Test Description:
+// After a loss, CUBIC gets back to WMax in about K seconds, much faster
+// than NewReno's one segment per RTT.
+TEST_F (TcpCongestionTest, CubicShouldRecoverFasterThanReno) {
+  UINT32  Algo;
+  UINT32  Rtt;
+  UINT32  Window[2];
+
+  for (Algo = 0; Algo < 2; Algo++) {
+    InitTcb (&Tcb, FALSE, (UINT8)Algo);
+    Tcb.SRtt   = 1 << TCP_RTT_SHIFT;
+    Tcb.SndNxt = TEST_SEQ (1000);
+    Tcb.CWnd   = 1000 * TEST_MSS;
+    mTcpTick   = 0;
+
+    Tcb.Ssthresh = TcpCcSsthresh (&Tcb);
+    Tcb.CWnd     = Tcb.Ssthresh;
+
+    //
+    // One tick, that is 200ms, per RTT for 20 seconds.
+    //
+    for (Rtt = 0; Rtt < 100; Rtt++) {
+      mTcpTick++;
+      for (UINT32 Ack = 0; Ack < Tcb.CWnd / TEST_MSS; Ack++) {
+        TcpCcOnAck (&Tcb, TEST_MSS);
+      }
+    }
+
+    Window[Algo] = Tcb.CWnd / TEST_MSS;
+  }
+
+  EXPECT_LT (Window[TCP_CC_NEWRENO], 900U);
+  EXPECT_GE (Window[TCP_CC_CUBIC], 1000U);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Loss injecting simulation
+////////////////////////////////////////////////////////////////////////
+
+//
+// A bulk transfer over a path with a fixed RTT of one TCP tick and a
+// bottleneck that forwards at most Capacity segments per RTT, dropping
+// the others, and drops segments at random on top of that. The receiver
+// advertises a window of twice the capacity, acknowledges every segment
+// and reports up to three SACK blocks, the one of the latest segment
+// first. The sender side follows the ACK processing of TcpInput(), the
+// window check of TcpDataToSend() and the retransmission timer.
+//
+class TcpLossySimulation {
+public:
+  struct Ack {
+    TCP_SEQNO    Ack;
+    UINT32       Num;
+    TCP_SACK_BLOCK Sack[3];
+  };
+
+  TCP_CB Tcb;
+  UINT32 Capacity;
+  UINT32 LossPpm;
+  UINT32 Seed;
+  UINT32 Offered;
+  UINT32 IdleRounds;
+  UINT32 RcvNxt;
+  std::vector<std::pair<UINT32, UINT32> > OutOfOrder;
+  std::vector<Ack> Acks;
+
+  TcpLossySimulation (
+    BOOLEAN  Sack,
+    UINT8    CongestAlgo,
+    UINT32   Capacity,
+    UINT32   LossPpm
+    ) : Capacity (Capacity), LossPpm (LossPpm), Seed (0x2545F491), Offered (0), IdleRounds (0), RcvNxt (0)
+  {
+    InitTcb (&Tcb, Sack, CongestAlgo);
+    Tcb.SRtt = 1 << TCP_RTT_SHIFT;
+    mTcpTick = 0;
+  }
+
+  BOOLEAN
+  Drop (
+    )
+  {
+    Seed = Seed * 1103515245 + 12345;
+    return (BOOLEAN)(((Seed >> 8) % 1000000) < LossPpm);
+  }
+
+  //
+  // A segment enters the network.
+  //
+  VOID
+  Send (
+    TCP_SEQNO  Seq
+    )
+  {
+    UINT32  Index;
+    size_t  Block;
+    Ack     A;
+
+    Offered++;
+    if ((Offered > Capacity) || Drop ()) {
+      return;
+    }
+
+    Index = (Seq - TEST_ISS) / TEST_MSS;
+    if (Index == RcvNxt) {
+      RcvNxt++;
+      if (!OutOfOrder.empty () && (OutOfOrder[0].first == RcvNxt)) {
+        RcvNxt = OutOfOrder[0].second;
+        OutOfOrder.erase (OutOfOrder.begin ());
+      }
+    } else if (Index > RcvNxt) {
+      Insert (Index);
+    }
+
+    A.Ack = TEST_SEQ (RcvNxt);
+    A.Num = 0;
+
+    if (TCP_FLG_ON (Tcb.CtrlFlag, TCP_CTRL_SND_SACK)) {
+      //
+      // The block of the latest segment first, then the others.
+      //
+      for (Block = 0; Block < OutOfOrder.size (); Block++) {
+        if ((Index >= OutOfOrder[Block].first) && (Index < OutOfOrder[Block].second)) {
+          AddBlock (&A, Block);
+        }
+      }
+
+      for (Block = 0; (Block < OutOfOrder.size ()) && (A.Num < 3); Block++) {
+        if ((Index < OutOfOrder[Block].first) || (Index >= OutOfOrder[Block].second)) {
+          AddBlock (&A, Block);
+        }
+      }
+    }
+
+    Acks.push_back (A);
+  }
+
+  //
+  // Add a segment to the out of order ranges of the receiver.
+  //
+  VOID
+  Insert (
+    UINT32  Index
+    )
+  {
+    size_t  Block;
+
+    for (Block = 0; Block < OutOfOrder.size (); Block++) {
+      if (Index + 1 < OutOfOrder[Block].first) {
+        break;
+      }
+
+      if (Index + 1 == OutOfOrder[Block].first) {
+        OutOfOrder[Block].first--;
+        return;
+      }
+
+      if (Index < OutOfOrder[Block].second) {
+        return;
+      }
+
+      if (Index == OutOfOrder[Block].second) {
+        OutOfOrder[Block].second++;
+        if ((Block + 1 < OutOfOrder.size ()) && (OutOfOrder[Block + 1].first == OutOfOrder[Block].second)) {
+          OutOfOrder[Block].second = OutOfOrder[Block + 1].second;
+          OutOfOrder.erase (OutOfOrder.begin () + Block + 1);
+        }
+
+        return;
+      }
+    }
+
+    OutOfOrder.insert (OutOfOrder.begin () + Block, std::make_pair (Index, Index + 1));
+  }
+
+  VOID
+  AddBlock (
+    Ack     *A,
+    size_t  Block
+    )
+  {
+    A->Sack[A->Num].Left  = TEST_SEQ (OutOfOrder[Block].first);
+    A->Sack[A->Num].Right = TEST_SEQ (OutOfOrder[Block].second);
+    A->Num++;
+  }
+
+  VOID
+  SendNewData (
+    )
+  {
+    TCP_SEQNO  Limit;
+    UINT32     Pipe;
+
+    if (TCP_FLG_ON (Tcb.CtrlFlag, TCP_CTRL_SND_SACK) && (Tcb.CongestState == TCP_CONGEST_RECOVER)) {
+      Pipe  = TcpSackPipe (&Tcb, Tcb.SndUna);
+      Limit = Tcb.SndNxt + ((Tcb.CWnd > Pipe) ? Tcb.CWnd - Pipe : 0);
+    } else {
+      Limit = Tcb.SndUna + Tcb.CWnd;
+    }
+
+    if (TCP_SEQ_GT (Limit, Tcb.SndUna + 2 * Capacity * TEST_MSS)) {
+      Limit = Tcb.SndUna + 2 * Capacity * TEST_MSS;
+    }
+
+    while (TCP_SEQ_LEQ (Tcb.SndNxt + TEST_MSS, Limit)) {
+      Send (Tcb.SndNxt);
+      Tcb.SndNxt += TEST_MSS;
+    }
+  }
+
+  //
+  // NewReno fast recovery, as TcpFastRecover() does it.
+  //
+  VOID
+  NewRenoRecover (
+    TCP_SEG  *Seg
+    )
+  {
+    UINT32  Acked;
+
+    if (Tcb.CongestState != TCP_CONGEST_RECOVER) {
+      Tcb.Ssthresh     = TcpCcSsthresh (&Tcb);
+      Tcb.Recover      = Tcb.SndNxt;
+      Tcb.CongestState = TCP_CONGEST_RECOVER;
+      TcpRetransmit (&Tcb, Tcb.SndUna);
+      Tcb.CWnd = Tcb.Ssthresh + 3 * Tcb.SndMss;
+    } else if (Seg->Ack == Tcb.SndUna) {
+      Tcb.CWnd += Tcb.SndMss;
+    } else if (TCP_SEQ_GEQ (Seg->Ack, Tcb.Recover)) {
+      Tcb.CWnd         = MIN (Tcb.Ssthresh, TCP_SUB_SEQ (Tcb.SndNxt, Tcb.SndUna) + Tcb.SndMss);
+      Tcb.CongestState = TCP_CONGEST_OPEN;
+    } else {
+      TcpRetransmit (&Tcb, Seg->Ack);
+      Acked = TCP_SUB_SEQ (Seg->Ack, Tcb.SndUna);
+      if (Acked >= Tcb.SndMss) {
+        Acked -= Tcb.SndMss;
+      }
+
+      Tcb.CWnd -= Acked;
+    }
+  }
+
+  VOID
+  ReceiveAck (
+    Ack  *A
+    )
+  {
+    TCP_SEG     Seg;
+    TCP_OPTION  Option;
+
+    if (TCP_SEQ_LT (A->Ack, Tcb.SndUna)) {
+      return;
+    }
+
+    if (!TCP_FLG_ON (Tcb.CtrlFlag, TCP_CTRL_SND_SACK) || TCP_SEQ_GT (A->Ack, Tcb.SndUna)) {
+      IdleRounds = 0;
+    }
+
+    ZeroMem (&Seg, sizeof (Seg));
+    ZeroMem (&Option, sizeof (Option));
+    Seg.Ack = A->Ack;
+    if (A->Num != 0) {
+      Option.Flag    = TCP_OPTION_RCVD_SACK;
+      Option.SackNum = (UINT8)A->Num;
+      CopyMem (Option.Sack, A->Sack, A->Num * sizeof (TCP_SACK_BLOCK));
+    }
+
+    if (TCP_FLG_ON (Tcb.CtrlFlag, TCP_CTRL_SND_SACK)) {
+      TcpSackUpdate (&Tcb, &Option, Seg.Ack);
+    }
+
+    if ((Seg.Ack == Tcb.SndUna) && (Tcb.SndUna != Tcb.SndNxt)) {
+      Tcb.DupAck++;
+    } else {
+      Tcb.DupAck = 0;
+    }
+
+    if (((Tcb.CongestState == TCP_CONGEST_OPEN) && (Tcb.DupAck < 3) && !TcpSackIsLost (&Tcb, Seg.Ack)) ||
+        (Tcb.CongestState == TCP_CONGEST_LOSS))
+    {
+      if (TCP_SEQ_GT (Seg.Ack, Tcb.SndUna)) {
+        TcpCcOnAck (&Tcb, TCP_SUB_SEQ (Seg.Ack, Tcb.SndUna));
+
+        if (Tcb.CongestState == TCP_CONGEST_LOSS) {
+          if (TCP_SEQ_GEQ (Seg.Ack, Tcb.LossRecover)) {
+            Tcb.CongestState = TCP_CONGEST_OPEN;
+          } else {
+            TcpRetransmit (&Tcb, Seg.Ack);
+          }
+        }
+      }
+    } else if (TCP_FLG_ON (Tcb.CtrlFlag, TCP_CTRL_SND_SACK)) {
+      TcpSackRecover (&Tcb, &Seg);
+    } else {
+      NewRenoRecover (&Seg);
+    }
+
+    Tcb.SndUna = Seg.Ack;
+  }
+
+  //
+  // Retransmission timeout, as TcpRexmitTimeout() handles it.
+  //
+  VOID
+  Timeout (
+    )
+  {
+    Tcb.Ssthresh     = TcpCcSsthresh (&Tcb);
+    Tcb.CWnd         = Tcb.SndMss;
+    Tcb.LossRecover  = Tcb.SndNxt;
+    Tcb.SackNum      = 0;
+    Tcb.CongestState = TCP_CONGEST_LOSS;
+    TcpRetransmit (&Tcb, Tcb.SndUna);
+  }
+
+  //
+  // Run the transfer and return the goodput in bytes per second.
+  //
+  UINT64
+  Run (
+    UINT32  Rounds
+    )
+  {
+    std::vector<Ack>  Received;
+    UINT32            Round;
+
+    mSimulation = this;
+
+    for (Round = 0; Round < Rounds; Round++) {
+      mTcpTick++;
+      Offered = 0;
+      Received.swap (Acks);
+      Acks.clear ();
+
+      for (size_t Index = 0; Index < Received.size (); Index++) {
+        ReceiveAck (&Received[Index]);
+        SendNewData ();
+      }
+
+      if (Tcb.SndUna == Tcb.SndNxt) {
+        SendNewData ();
+      }
+
+      //
+      // The retransmission timer, one second.
+      //
+      if (Tcb.SndUna == Tcb.SndNxt) {
+        IdleRounds = 0;
+      } else if (++IdleRounds == 5) {
+        IdleRounds = 0;
+        Timeout ();
+      }
+    }
+
+    mSimulation = NULL;
+
+    return DivU64x32 (MultU64x32 (TCP_SUB_SEQ (Tcb.SndUna, TEST_ISS), 1000), Rounds * TCP_TICK);
+  }
+};
+
+VOID
+TcpSimulationSend (
+  IN TCP_SEQNO  Seq
+  )
+{
+  mSimulation->Send (Seq);
+}
+
+// Test Description:
+// Drop bursts at the bottleneck: SACK repairs all the losses of a window
+// in one RTT, NewReno one per RTT.
+TEST (TcpLossySimulationTest, SackShouldImproveGoodputOnBurstLoss) {
+  TcpLossySimulation  NewReno (FALSE, TCP_CC_NEWRENO, 100, 0);
+  TcpLossySimulation  Sack (TRUE, TCP_CC_NEWRENO, 100, 0);
+  UINT64              NewRenoGoodput;
+  UINT64              SackGoodput;
+
+  NewRenoGoodput = NewReno.Run (1000);
+  SackGoodput    = Sack.Run (1000);
+
+  RecordProperty ("NewRenoGoodput", (int)NewRenoGoodput);
+  RecordProperty ("SackGoodput", (int)SackGoodput);
+  printf ("Burst loss goodput: NewReno %llu B/s, SACK %llu B/s\n", NewRenoGoodput, SackGoodput);
+
+  EXPECT_GT (SackGoodput, NewRenoGoodput);
+}
+
+// Test Description:
+// Random loss on a large bandwidth-delay product path: CUBIC keeps the
+// window closer to the capacity than NewReno.
+TEST (TcpLossySimulationTest, CubicShouldImproveGoodputOnLongFatPath) {
+  TcpLossySimulation  Reno (TRUE, TCP_CC_NEWRENO, 2000, 50);
+  TcpLossySimulation  Cubic (TRUE, TCP_CC_CUBIC, 2000, 50);
+  UINT64              RenoGoodput;
+  UINT64              CubicGoodput;
+
+  RenoGoodput  = Reno.Run (3000);
+  CubicGoodput = Cubic.Run (3000);
+
+  RecordProperty ("RenoGoodput", (int)RenoGoodput);
+  RecordProperty ("CubicGoodput", (int)CubicGoodput);
+  printf ("Random loss goodput: NewReno %llu B/s, CUBIC %llu B/s\n", RenoGoodput, CubicGoodput);
+
+  EXPECT_GT (CubicGoodput, RenoGoodput);
+}
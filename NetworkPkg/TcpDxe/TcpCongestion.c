@@ -0,0 +1,239 @@
+/** @file
+  TCP congestion control.
+
+  Two algorithms are implemented: the standard NewReno window growth
+  (RFC 5681) and CUBIC (RFC 9438), which grows the window as a cubic
+  function of the time since the last congestion event and so recovers
+  faster on paths with a large bandwidth-delay product. The algorithm is
+  selected by PcdTcpCongestionControl when a TCP instance is configured.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC parameters. C is 0.4 segment/s^3 and beta is 0.7, the window
+// growth is computed with the time in milliseconds: 1 / C * 10^9 is
+// TCP_CUBIC_C_INV. The time offset fed into the cubic function is
+// limited so that its cube fits into 64 bits.
+//
+#define TCP_CUBIC_C_INV      2500000000ULL
+#define TCP_CUBIC_MAX_DELTA  (1U << 21)
+
+/**
+  Compute the integer cube root of a 64 bit value.
+
+  @param[in]  Value     The value to compute the cube root of.
+
+  @return The largest integer whose cube is less than or equal to Value.
+
+**/
+STATIC
+UINT32
+TcpCubeRoot (
+  IN UINT64  Value
+  )
+{
+  UINT64  Root;
+  UINT64  Bit;
+  INTN    Shift;
+
+  Root = 0;
+  for (Shift = 63; Shift >= 0; Shift -= 3) {
+    Root = LShiftU64 (Root, 1);
+    Bit  = MultU64x64 (MultU64x32 (Root, 3), Root + 1) + 1;
+    if (RShiftU64 (Value, Shift) >= Bit) {
+      Value -= LShiftU64 (Bit, Shift);
+      Root++;
+    }
+  }
+
+  return (UINT32)Root;
+}
+
+/**
+  Grow the congestion window of a CUBIC sender in congestion avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes newly acknowledged.
+
+**/
+STATIC
+VOID
+TcpCubicAvoid (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  UINT32  Mss;
+  UINT32  Elapsed;
+  UINT32  Delta;
+  UINT64  Offset;
+  UINT64  Target;
+
+  Mss = Tcb->SndMss;
+
+  if (!Tcb->CubicEpochOn) {
+    //
+    // Start a new congestion avoidance epoch. K is the time, in
+    // milliseconds, the cubic function takes to get back to WMax.
+    //
+    Tcb->CubicEpochOn = TRUE;
+    Tcb->CubicEpoch   = mTcpTick;
+    Tcb->CubicWEst    = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicK = TcpCubeRoot (
+                      DivU64x32 (
+                        MultU64x64 (Tcb->CubicWMax - Tcb->CWnd, TCP_CUBIC_C_INV),
+                        Mss
+                        )
+                      );
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // Target the window one RTT ahead.
+  //
+  Elapsed = (TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + (Tcb->SRtt >> TCP_RTT_SHIFT)) * TCP_TICK;
+  Delta   = (Elapsed > Tcb->CubicK) ? Elapsed - Tcb->CubicK : Tcb->CubicK - Elapsed;
+  Delta   = MIN (Delta, TCP_CUBIC_MAX_DELTA);
+
+  Offset = MultU64x64 (MultU64x32 (Delta, Delta), Delta);
+  Offset = DivU64x32 (MultU64x32 (DivU64x32 (Offset, 2500000), Mss), 1000);
+
+  if (Elapsed > Tcb->CubicK) {
+    Target = Tcb->CubicOrigin + Offset;
+  } else {
+    Target = (Tcb->CubicOrigin > Offset) ? Tcb->CubicOrigin - Offset : 0;
+  }
+
+  Target = MIN (Target, (UINT64)Tcb->CWnd + (Tcb->CWnd >> 1));
+
+  //
+  // The window a Reno sender would have reached, grown by
+  // 3 * (1 - beta) / (1 + beta) = 9 / 17 segment per RTT.
+  //
+  Tcb->CubicWEst += MAX (
+                      (UINT32)DivU64x32 (
+                                DivU64x32 (MultU64x32 (MultU64x32 (Acked, Mss), 9), 17),
+                                Tcb->CWnd
+                                ),
+                      1
+                      );
+
+  if (Tcb->CubicWEst > Target) {
+    //
+    // Reno friendly region.
+    //
+    if (Tcb->CubicWEst > Tcb->CWnd) {
+      Tcb->CWnd = Tcb->CubicWEst;
+    }
+  } else if (Target > Tcb->CWnd) {
+    Tcb->CWnd += MAX ((UINT32)DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Mss), Tcb->CWnd), 1);
+  } else {
+    Tcb->CWnd += MAX (Mss * Mss / Tcb->CWnd / 100, 1);
+  }
+}
+
+/**
+  Initialize the congestion control state of a TCP instance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCcInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  if (PcdGet8 (PcdTcpCongestionControl) == TCP_CC_CUBIC) {
+    Tcb->CongestAlgo = TCP_CC_CUBIC;
+  } else {
+    Tcb->CongestAlgo = TCP_CC_NEWRENO;
+  }
+
+  Tcb->CubicEpochOn = FALSE;
+  Tcb->CubicEpoch   = 0;
+  Tcb->CubicK       = 0;
+  Tcb->CubicOrigin  = 0;
+  Tcb->CubicWMax    = 0;
+  Tcb->CubicWEst    = 0;
+}
+
+/**
+  Grow the congestion window on the acknowledgment of new data, while
+  not in loss recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCcOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+  } else if (Tcb->CongestAlgo == TCP_CC_CUBIC) {
+    TcpCubicAvoid (Tcb, Acked);
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+
+  Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+}
+
+/**
+  Compute the slow start threshold after a congestion event, that is
+  a fast retransmit or a retransmission timeout. Called before the
+  congestion state of the TCB is changed.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCcSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  FlightSize;
+  UINT32  Window;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+  if (Tcb->CongestAlgo != TCP_CC_CUBIC) {
+    return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+  }
+
+  Window = FlightSize;
+
+  if (Tcb->CongestState == TCP_CONGEST_OPEN) {
+    Window = MIN (Tcb->CWnd, FlightSize);
+
+    //
+    // Fast convergence: if the window didn't get back to the previous
+    // maximum, release some bandwidth to the newer flows.
+    //
+    if (Window < Tcb->CubicWMax) {
+      Tcb->CubicWMax = Window / 20 * 17;
+    } else {
+      Tcb->CubicWMax = Window;
+    }
+  }
+
+  Tcb->CubicEpochOn = FALSE;
+
+  return MAX (Window / 10 * 7, (UINT32)(2 * Tcb->SndMss));
+}
@@ -118,7 +118,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -195,7 +195,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -563,6 +563,8 @@ TcpConfigurePcb (
   Tcb->Ssthresh = 0xffffffff;
 
   Tcb->CongestState = TCP_CONGEST_OPEN;
+  Tcb->SackNum      = 0;
+  TcpCcInit (Tcb);
 
   Tcb->KeepAliveIdle   = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod = TCP_KEEPALIVE_PERIOD;
@@ -703,6 +705,10 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (!Option->EnableSelectiveAck) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
@@ -657,6 +657,131 @@ Tcp6RefreshNeighbor (
   IN UINT32          Timeout
   );
 
+//
+// Functions in TcpSack.c
+//
+
+/**
+  Update the SACK scoreboard with an incoming acknowledgment.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Option   Pointer to the TCP options parsed from the segment.
+  @param[in]       Ack      The acknowledgment number of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_OPTION  *Option,
+  IN     TCP_SEQNO   Ack
+  );
+
+/**
+  Check whether the segment at SND.UNA is deemed lost, RFC 6675 IsLost().
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Una      The lowest unacknowledged sequence number.
+
+  @retval TRUE         The segment at Una is lost.
+  @retval FALSE        The segment at Una isn't lost, or SACK isn't in use.
+
+**/
+BOOLEAN
+TcpSackIsLost (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Una
+  );
+
+/**
+  Estimate the number of bytes still in flight, RFC 6675 SetPipe().
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Una      The lowest unacknowledged sequence number.
+
+  @return The estimated number of bytes in flight.
+
+**/
+UINT32
+TcpSackPipe (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Una
+  );
+
+/**
+  Find the next hole to retransmit, RFC 6675 NextSeg() rule (1).
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]   Una      The lowest unacknowledged sequence number.
+  @param[out]  Seq      The first sequence number of the hole.
+  @param[out]  Len      The length of the hole, at most one SMSS.
+
+  @retval TRUE         A hole is found.
+  @retval FALSE        No hole below the highest SACKed byte is left.
+
+**/
+BOOLEAN
+TcpSackNextHole (
+  IN  TCP_CB     *Tcb,
+  IN  TCP_SEQNO  Una,
+  OUT TCP_SEQNO  *Seq,
+  OUT UINT32     *Len
+  );
+
+/**
+  SACK based loss recovery, RFC 6675.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg      Segment that triggers the recovery.
+
+**/
+VOID
+TcpSackRecover (
+  IN OUT TCP_CB   *Tcb,
+  IN     TCP_SEG  *Seg
+  );
+
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Initialize the congestion control state of a TCP instance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCcInit (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Grow the congestion window on the acknowledgment of new data, while
+  not in loss recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCcOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  );
+
+/**
+  Compute the slow start threshold after a congestion event.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCcSsthresh (
+  IN OUT TCP_CB  *Tcb
+  );
+
 //
 // Functions in TcpDispatcher.c
 //
@@ -45,6 +45,14 @@ TcpFastRecover (
   UINT32  FlightSize;
   UINT32  Acked;
 
+  //
+  // Use the scoreboard based recovery if the peer has agreed to SACK.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    TcpSackRecover (Tcb, Seg);
+    return;
+  }
+
   //
   // Step 1: Three duplicate ACKs and not in fast recovery
   //
@@ -52,9 +60,7 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = TcpCcSsthresh (Tcb);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -1207,12 +1213,27 @@ TcpInput (
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
   }
 
+  //
+  // With SACK, the retransmission timer is only restarted when new data
+  // is acknowledged (RFC 6298 rule 5.3), or the duplicate ACKs keep it
+  // from ever detecting a lost retransmission.
+  //
   if (Seg->Ack == Tcb->SndNxt) {
     TcpClearTimer (Tcb, TCP_TIMER_REXMIT);
-  } else {
+  } else if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+             TCP_SEQ_GT (Seg->Ack, Tcb->SndUna) ||
+             !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_REXMIT))
+  {
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Update the SACK scoreboard before the ACK is processed.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    TcpSackUpdate (Tcb, &Option, Seg->Ack);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1229,17 +1250,11 @@ TcpInput (
   //
   // Congestion avoidance, fast recovery and fast retransmission.
   //
-  if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3)) ||
+  if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3) && !TcpSackIsLost (Tcb, Seg->Ack)) ||
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
-
-      Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+      TcpCcOnAck (Tcb, TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna));
     }
 
     if (Tcb->CongestState == TCP_CONGEST_LOSS) {
@@ -1477,6 +1492,14 @@ StepSix:
       goto RESET_THEN_DROP;
     }
 
+    //
+    // Remember the latest out of order segment, its block is reported
+    // first in the SACK option.
+    //
+    if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+      Tcb->RcvSackSeq = Seg->Seq;
+    }
+
     if (TcpQueueData (Tcb, Nbuf) == 0) {
       DEBUG (
         (DEBUG_ERROR,
@@ -92,6 +92,79 @@ TcpComputeScale (
   return Scale;
 }
 
+/**
+  Collect the out-of-order data on the reassemble queue into SACK blocks.
+
+  Contiguous segments are merged into one block. As RFC2018 requires, the
+  block that holds the most recently received segment is reported first,
+  the others follow in sequence order.
+
+  @param[in]   Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block   Array to store the SACK blocks in.
+  @param[in]   MaxNum  The number of entries in Block.
+
+  @return              The number of SACK blocks stored in Block.
+
+**/
+UINT8
+TcpGetSackBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxNum
+  )
+{
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Range;
+  UINT8           Num;
+  BOOLEAN         Recent;
+
+  Num    = 0;
+  Recent = FALSE;
+  Entry  = Tcb->RcvQue.ForwardLink;
+
+  while ((Entry != &Tcb->RcvQue) && (MaxNum > 0)) {
+    Seg         = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+    Range.Left  = Seg->Seq;
+    Range.Right = Seg->End;
+
+    for (Entry = Entry->ForwardLink; Entry != &Tcb->RcvQue; Entry = Entry->ForwardLink) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+      if (TCP_SEQ_GT (Seg->Seq, Range.Right)) {
+        break;
+      }
+
+      if (TCP_SEQ_GT (Seg->End, Range.Right)) {
+        Range.Right = Seg->End;
+      }
+    }
+
+    if (!Recent &&
+        TCP_SEQ_LEQ (Range.Left, Tcb->RcvSackSeq) &&
+        TCP_SEQ_LT (Tcb->RcvSackSeq, Range.Right))
+    {
+      //
+      // Put the most recent block first, dropping the last one if full.
+      //
+      if (Num == MaxNum) {
+        Num--;
+      }
+
+      CopyMem (&Block[1], &Block[0], Num * sizeof (TCP_SACK_BLOCK));
+      CopyMem (&Block[0], &Range, sizeof (TCP_SACK_BLOCK));
+      Num++;
+      Recent = TRUE;
+    } else if (Num < MaxNum) {
+      CopyMem (&Block[Num], &Range, sizeof (TCP_SACK_BLOCK));
+      Num++;
+    } else if (Recent) {
+      break;
+    }
+  }
+
+  return Num;
+}
+
 /**
   Build the TCP option in three-way handshake.
 
@@ -160,6 +233,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when SACK is not
+  // disabled, and either we are doing active open or
+  // the peer has permitted SACK too.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -187,8 +282,12 @@ TcpBuildOption (
   IN NET_BUF  *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK];
+  UINT32          Room;
+  UINT8           Num;
+  UINT8           Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
   Len = 0;
@@ -214,6 +313,54 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option if there is out-of-order data
+  // to report. It must fit in the 40 bytes of option space,
+  // and must not push a data segment beyond the SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+      !IsListEmpty (&Tcb->RcvQue) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST)
+      )
+  {
+    //
+    // SndMss has already been reduced by the timestamp option.
+    //
+    Room = 40 - Len;
+    if (Tcb->SndMss < Nbuf->TotalSize + Room) {
+      Room = (Tcb->SndMss > Nbuf->TotalSize) ? Tcb->SndMss - Nbuf->TotalSize : 0;
+    }
+
+    Num = 0;
+    if (Room >= TCP_OPTION_SACK_ALIGNED_LEN + TCP_OPTION_SACK_BLOCK_LEN) {
+      Num = (UINT8)MIN (
+                     (Room - TCP_OPTION_SACK_ALIGNED_LEN) / TCP_OPTION_SACK_BLOCK_LEN,
+                     TCP_OPTION_MAX_SACK
+                     );
+      Num = TcpGetSackBlocks (Tcb, Block, Num);
+    }
+
+    if (Num > 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               TCP_OPTION_SACK_ALIGNED_LEN + Num * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16)(Len + TCP_OPTION_SACK_ALIGNED_LEN + Num * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Num * TCP_OPTION_SACK_BLOCK_LEN));
+      Data += TCP_OPTION_SACK_ALIGNED_LEN;
+
+      for (Index = 0; Index < Num; Index++) {
+        TcpPutUint32 (Data, Block[Index].Left);
+        TcpPutUint32 (Data + 4, Block[Index].Right);
+        Data += TCP_OPTION_SACK_BLOCK_LEN;
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,10 +386,12 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag = 0;
+  Option->Flag    = 0;
+  Option->SackNum = 0;
 
   TotalLen = (UINT8)((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -297,6 +446,39 @@ TcpParseOption (
         Cur += TCP_OPTION_WS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+            ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        Option->SackNum = (UINT8)MIN ((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN, TCP_OPTION_MAX_SACK);
+        for (Index = 0; Index < Option->SackNum; Index++) {
+          Option->Sack[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->Sack[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_TS:
         Len = Head[Cur + 1];
 
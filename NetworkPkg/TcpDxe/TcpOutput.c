@@ -173,6 +173,8 @@ TcpDataToSend (
   UINT32  Len;
   UINT32  Left;
   UINT32  Limit;
+  UINT32  CWndLimit;
+  UINT32  Pipe;
 
   Sk = Tcb->Sk;
   ASSERT (Sk != NULL);
@@ -182,13 +184,24 @@ TcpDataToSend (
   // and congestion window. The right edge of send
   // window is defined as SND.WL2 + SND.WND. The right
   // edge of congestion window is defined as SND.UNA +
-  // CWND.
+  // CWND. During SACK based loss recovery, the data
+  // in flight is the pipe estimated from the scoreboard
+  // rather than SND.NXT - SND.UNA.
   //
   Win   = 0;
   Limit = Tcb->SndWl2 + Tcb->SndWnd;
 
-  if (TCP_SEQ_GT (Limit, Tcb->SndUna + Tcb->CWnd)) {
-    Limit = Tcb->SndUna + Tcb->CWnd;
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+      (Tcb->CongestState == TCP_CONGEST_RECOVER))
+  {
+    Pipe      = TcpSackPipe (Tcb, Tcb->SndUna);
+    CWndLimit = Tcb->SndNxt + ((Tcb->CWnd > Pipe) ? Tcb->CWnd - Pipe : 0);
+  } else {
+    CWndLimit = Tcb->SndUna + Tcb->CWnd;
+  }
+
+  if (TCP_SEQ_GT (Limit, CWndLimit)) {
+    Limit = CWndLimit;
   }
 
   if (TCP_SEQ_GT (Limit, Tcb->SndNxt)) {
@@ -52,6 +52,12 @@
 #define TCP_CONGEST_LOSS     2      ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN     3      ///< TCP is opening its congestion window.
 
+//
+// Congestion control algorithm used in congestion avoidance.
+//
+#define TCP_CC_NEWRENO  0           ///< RFC5681 congestion avoidance.
+#define TCP_CC_CUBIC    1           ///< RFC9438 CUBIC.
+
 //
 // TCP control flags
 //
@@ -70,6 +76,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_SND_SACK      0x10000  ///< Both ends permit SACK.
 
 //
 // Timer related values
@@ -204,6 +212,20 @@
 
 #define TCP_MAX_WIN  0xFFFFU
 
+//
+// Number of SACKed ranges remembered by the sender. It only needs to
+// cover the holes of a couple of windows.
+//
+#define TCP_SACK_SCOREBOARD_SIZE  16
+
+///
+/// A block of contiguous sequence space, as carried by the SACK option.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of the block.
+  TCP_SEQNO    Right; ///< The sequence number of the last byte + 1.
+} TCP_SACK_BLOCK;
+
 ///
 /// TCP segmentation data.
 ///
@@ -306,6 +328,26 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC2018 and RFC6675 variables.
+  // SACK option and scoreboard based loss recovery.
+  //
+  TCP_SACK_BLOCK      SackBlock[TCP_SACK_SCOREBOARD_SIZE]; ///< SACKed ranges above SndUna, in order.
+  UINT8               SackNum;                             ///< Number of valid ranges in SackBlock.
+  TCP_SEQNO           HighRxt;                             ///< End of the data retransmitted in recovery.
+  TCP_SEQNO           RcvSackSeq;                          ///< Seq of the latest out-of-order segment.
+
+  //
+  // RFC9438 variables, CUBIC congestion control.
+  //
+  UINT8               CongestAlgo;  ///< TCP_CC_NEWRENO or TCP_CC_CUBIC.
+  BOOLEAN             CubicEpochOn; ///< A congestion avoidance epoch is running.
+  UINT32              CubicEpoch;   ///< The mTcpTick when the epoch started.
+  UINT32              CubicK;       ///< Time to grow back to CubicOrigin, in ms.
+  UINT32              CubicOrigin;  ///< The window the cubic function plateaus at.
+  UINT32              CubicWMax;    ///< The window before the last reduction.
+  UINT32              CubicWEst;    ///< The Reno-friendly window estimate.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
@@ -0,0 +1,417 @@
+/** @file
+  TCP selective acknowledgment (RFC 2018) and SACK based loss
+  recovery (RFC 6675).
+
+  The sender keeps a scoreboard of the ranges above SND.UNA that the peer
+  has reported as received. The scoreboard is used to estimate the data
+  in flight (the "pipe") and to pick the holes to retransmit while in
+  loss recovery, so that several lost segments can be repaired in one
+  round trip.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Insert a range into the SACK scoreboard, merging it with the ranges it
+  overlaps or touches. The scoreboard is kept sorted by sequence number.
+  If the scoreboard is full, the highest range is dropped, because the
+  ranges nearest to SND.UNA matter most for the recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     The first sequence number of the range.
+  @param[in]       Right    The sequence number following the range.
+
+**/
+STATIC
+VOID
+TcpSackInsert (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  )
+{
+  UINT8  Index;
+  UINT8  Last;
+
+  Index = 0;
+  while ((Index < Tcb->SackNum) && TCP_SEQ_LT (Tcb->SackBlock[Index].Right, Left)) {
+    Index++;
+  }
+
+  Last = Index;
+  while ((Last < Tcb->SackNum) && TCP_SEQ_LEQ (Tcb->SackBlock[Last].Left, Right)) {
+    if (TCP_SEQ_LT (Tcb->SackBlock[Last].Left, Left)) {
+      Left = Tcb->SackBlock[Last].Left;
+    }
+
+    if (TCP_SEQ_GT (Tcb->SackBlock[Last].Right, Right)) {
+      Right = Tcb->SackBlock[Last].Right;
+    }
+
+    Last++;
+  }
+
+  if (Last > Index) {
+    //
+    // The ranges from Index to Last - 1 are merged into one.
+    //
+    Tcb->SackBlock[Index].Left  = Left;
+    Tcb->SackBlock[Index].Right = Right;
+
+    CopyMem (
+      &Tcb->SackBlock[Index + 1],
+      &Tcb->SackBlock[Last],
+      (Tcb->SackNum - Last) * sizeof (TCP_SACK_BLOCK)
+      );
+
+    Tcb->SackNum = (UINT8)(Tcb->SackNum - (Last - Index - 1));
+    return;
+  }
+
+  if (Tcb->SackNum == TCP_SACK_SCOREBOARD_SIZE) {
+    if (Index == TCP_SACK_SCOREBOARD_SIZE) {
+      return;
+    }
+
+    Tcb->SackNum--;
+  }
+
+  CopyMem (
+    &Tcb->SackBlock[Index + 1],
+    &Tcb->SackBlock[Index],
+    (Tcb->SackNum - Index) * sizeof (TCP_SACK_BLOCK)
+    );
+
+  Tcb->SackBlock[Index].Left  = Left;
+  Tcb->SackBlock[Index].Right = Right;
+  Tcb->SackNum++;
+}
+
+/**
+  Update the SACK scoreboard with an incoming acknowledgment.
+
+  The ranges covered by the cumulative acknowledgment are removed, then
+  the SACK blocks carried by the segment are added. Blocks that are below
+  the acknowledgment (D-SACK, RFC 2883) or beyond SND.NXT are ignored.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Option   Pointer to the TCP options parsed from the segment.
+  @param[in]       Ack      The acknowledgment number of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_OPTION  *Option,
+  IN     TCP_SEQNO   Ack
+  )
+{
+  UINT8      Index;
+  TCP_SEQNO  Left;
+  TCP_SEQNO  Right;
+
+  Index = 0;
+  while ((Index < Tcb->SackNum) && TCP_SEQ_LEQ (Tcb->SackBlock[Index].Right, Ack)) {
+    Index++;
+  }
+
+  if (Index > 0) {
+    CopyMem (
+      &Tcb->SackBlock[0],
+      &Tcb->SackBlock[Index],
+      (Tcb->SackNum - Index) * sizeof (TCP_SACK_BLOCK)
+      );
+
+    Tcb->SackNum = (UINT8)(Tcb->SackNum - Index);
+  }
+
+  if ((Tcb->SackNum > 0) && TCP_SEQ_LT (Tcb->SackBlock[0].Left, Ack)) {
+    Tcb->SackBlock[0].Left = Ack;
+  }
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackNum; Index++) {
+    Left  = Option->Sack[Index].Left;
+    Right = Option->Sack[Index].Right;
+
+    if (!TCP_SEQ_LT (Left, Right) ||
+        TCP_SEQ_LEQ (Right, Ack) ||
+        TCP_SEQ_GT (Right, Tcb->SndNxt))
+    {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Left, Ack)) {
+      Left = Ack;
+    }
+
+    TcpSackInsert (Tcb, Left, Right);
+  }
+}
+
+/**
+  Check whether the segment at SND.UNA is deemed lost, RFC 6675 IsLost().
+  It is if more than (DupThresh - 1) * SMSS bytes above it have been
+  selectively acknowledged.
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Una      The lowest unacknowledged sequence number.
+
+  @retval TRUE         The segment at Una is lost.
+  @retval FALSE        The segment at Una isn't lost, or SACK isn't in use.
+
+**/
+BOOLEAN
+TcpSackIsLost (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Una
+  )
+{
+  UINT8   Index;
+  UINT32  Sacked;
+
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    return FALSE;
+  }
+
+  Sacked = 0;
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_GT (Tcb->SackBlock[Index].Left, Una)) {
+      Sacked += TCP_SUB_SEQ (Tcb->SackBlock[Index].Right, Tcb->SackBlock[Index].Left);
+    }
+  }
+
+  return (BOOLEAN)(Sacked > 2 * (UINT32)Tcb->SndMss);
+}
+
+/**
+  Estimate the number of bytes still in flight, RFC 6675 SetPipe().
+
+  The bytes between Una and SND.NXT are counted, minus those that have
+  been selectively acknowledged and minus the holes below the highest
+  selectively acknowledged byte that haven't been retransmitted yet,
+  which are assumed to have left the network.
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Una      The lowest unacknowledged sequence number.
+
+  @return The estimated number of bytes in flight.
+
+**/
+UINT32
+TcpSackPipe (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Una
+  )
+{
+  UINT8      Index;
+  UINT32     Out;
+  UINT32     Gone;
+  TCP_SEQNO  Hole;
+  TCP_SEQNO  Lost;
+  TCP_SEQNO  Left;
+
+  if (TCP_SEQ_LEQ (Tcb->SndNxt, Una)) {
+    return 0;
+  }
+
+  Out  = TCP_SUB_SEQ (Tcb->SndNxt, Una);
+  Gone = 0;
+  Hole = Una;
+  Lost = TCP_SEQ_GT (Tcb->HighRxt, Una) ? Tcb->HighRxt : Una;
+
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].Right, Hole)) {
+      continue;
+    }
+
+    Left = Tcb->SackBlock[Index].Left;
+    if (TCP_SEQ_LT (Left, Hole)) {
+      Left = Hole;
+    }
+
+    Gone += TCP_SUB_SEQ (Tcb->SackBlock[Index].Right, Left);
+
+    //
+    // The hole [Hole, Left) isn't SACKed. The part of it that hasn't
+    // been retransmitted yet is counted as lost.
+    //
+    if (TCP_SEQ_GT (Left, Lost)) {
+      Gone += TCP_SUB_SEQ (Left, TCP_SEQ_GT (Hole, Lost) ? Hole : Lost);
+    }
+
+    Hole = Tcb->SackBlock[Index].Right;
+  }
+
+  return (Gone < Out) ? Out - Gone : 0;
+}
+
+/**
+  Find the next hole to retransmit, RFC 6675 NextSeg() rule (1).
+  The search starts at the highest retransmitted sequence number.
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]   Una      The lowest unacknowledged sequence number.
+  @param[out]  Seq      The first sequence number of the hole.
+  @param[out]  Len      The length of the hole, at most one SMSS.
+
+  @retval TRUE         A hole is found.
+  @retval FALSE        No hole below the highest SACKed byte is left.
+
+**/
+BOOLEAN
+TcpSackNextHole (
+  IN  TCP_CB     *Tcb,
+  IN  TCP_SEQNO  Una,
+  OUT TCP_SEQNO  *Seq,
+  OUT UINT32     *Len
+  )
+{
+  UINT8      Index;
+  TCP_SEQNO  Start;
+
+  Start = TCP_SEQ_GT (Tcb->HighRxt, Una) ? Tcb->HighRxt : Una;
+
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].Right, Start)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Start, Tcb->SackBlock[Index].Left)) {
+      *Seq = Start;
+      *Len = MIN (TCP_SUB_SEQ (Tcb->SackBlock[Index].Left, Start), Tcb->SndMss);
+      return TRUE;
+    }
+
+    Start = Tcb->SackBlock[Index].Right;
+  }
+
+  return FALSE;
+}
+
+/**
+  Retransmit the holes in the scoreboard as long as the congestion
+  window allows, RFC 6675 section 5 step (C).
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Una      The lowest unacknowledged sequence number.
+
+**/
+STATIC
+VOID
+TcpSackRetransmitHoles (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Una
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+
+  while (TcpSackPipe (Tcb, Una) + Tcb->SndMss <= Tcb->CWnd) {
+    if (!TcpSackNextHole (Tcb, Una, &Seq, &Len)) {
+      break;
+    }
+
+    if (TcpRetransmit (Tcb, Seq) != 0) {
+      break;
+    }
+
+    //
+    // Advance HighRxt even if the retransmission was held back by the
+    // send window, or the same hole would be picked again and again.
+    //
+    Tcb->HighRxt = Seq + Len;
+  }
+}
+
+/**
+  SACK based loss recovery, RFC 6675. Called in place of the NewReno
+  fast recovery when the peer has agreed to use SACK.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg      Segment that triggers the recovery.
+
+**/
+VOID
+TcpSackRecover (
+  IN OUT TCP_CB   *Tcb,
+  IN     TCP_SEG  *Seg
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+
+  if (Tcb->CongestState != TCP_CONGEST_RECOVER) {
+    //
+    // Enter loss recovery, RFC 6675 section 5 step (4). The first hole is
+    // always retransmitted, whatever the pipe is.
+    //
+    Tcb->Ssthresh     = TcpCcSsthresh (Tcb);
+    Tcb->CWnd         = Tcb->Ssthresh;
+    Tcb->Recover      = Tcb->SndNxt;
+    Tcb->HighRxt      = Seg->Ack;
+    Tcb->CongestState = TCP_CONGEST_RECOVER;
+    TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+
+    if (!TcpSackNextHole (Tcb, Seg->Ack, &Seq, &Len)) {
+      Seq = Seg->Ack;
+      Len = MIN (TCP_SUB_SEQ (Tcb->SndNxt, Seq), Tcb->SndMss);
+    }
+
+    if (TcpRetransmit (Tcb, Seq) == 0) {
+      Tcb->HighRxt = Seq + Len;
+    }
+
+    TcpSackRetransmitHoles (Tcb, Seg->Ack);
+
+    DEBUG (
+      (DEBUG_NET,
+       "TcpSackRecover: enter SACK recovery for TCB %p, ssthresh %d\n",
+       Tcb,
+       Tcb->Ssthresh)
+      );
+
+    return;
+  }
+
+  if (TCP_SEQ_GEQ (Seg->Ack, Tcb->Recover)) {
+    //
+    // Full acknowledgment, leave the recovery.
+    //
+    Tcb->CWnd         = Tcb->Ssthresh;
+    Tcb->CongestState = TCP_CONGEST_OPEN;
+
+    DEBUG (
+      (DEBUG_NET,
+       "TcpSackRecover: received a full ACK(%d) for TCB %p, exit SACK recovery\n",
+       Seg->Ack,
+       Tcb)
+      );
+
+    return;
+  }
+
+  if (TCP_SEQ_LT (Tcb->HighRxt, Seg->Ack)) {
+    Tcb->HighRxt = Seg->Ack;
+  }
+
+  //
+  // A partial acknowledgment that carries no SACK information means the
+  // next segment is lost too, retransmit it as NewReno does.
+  //
+  if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna) && (Tcb->SackNum == 0)) {
+    if (TcpRetransmit (Tcb, Seg->Ack) == 0) {
+      Len          = MIN (TCP_SUB_SEQ (Tcb->SndNxt, Seg->Ack), Tcb->SndMss);
+      Tcb->HighRxt = Seg->Ack + Len;
+    }
+  }
+
+  TcpSackRetransmitHoles (Tcb, Seg->Ack);
+}
@@ -180,8 +180,6 @@ TcpRexmitTimeout (
   IN OUT TCP_CB  *Tcb
   )
 {
-  UINT32  FlightSize;
-
   DEBUG (
     (DEBUG_WARN,
      "TcpRexmitTimeout: transmission timeout for TCB %p\n",
@@ -189,15 +187,15 @@ TcpRexmitTimeout (
     );
 
   //
-  // Set the congestion window. FlightSize is the
-  // amount of data that has been sent but not
-  // yet ACKed.
+  // Set the congestion window. The SACK scoreboard is
+  // discarded since the peer may have reneged on the
+  // data it selectively acknowledged, RFC 2018.
   //
-  FlightSize    = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh = MAX ((UINT32)(2 * Tcb->SndMss), FlightSize / 2);
+  Tcb->Ssthresh = TcpCcSsthresh (Tcb);
 
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
+  Tcb->SackNum     = 0;
 
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) && !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
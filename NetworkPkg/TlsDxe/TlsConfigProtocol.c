@@ -69,11 +69,23 @@ TlsConfigurationSetData (
       break;
     case EfiTlsConfigDataTypeCertRevocationList:
       Status = TlsSetCertRevocationList (Data, DataSize);
+      if (!EFI_ERROR (Status)) {
+        //
+        // The revocation list is shared by all the connections, the cached
+        // sessions were verified against the previous one.
+        //
+        TlsSessionCacheFlush (Instance->Service);
+      }
+
       break;
     default:
       Status = EFI_UNSUPPORTED;
   }
 
+  if (!EFI_ERROR (Status)) {
+    TlsSessionCacheUpdateConfig (Instance, DataType, Data, DataSize);
+  }
+
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
@@ -27,9 +27,14 @@ TlsCleanInstance (
 {
   if (Instance != NULL) {
     if (Instance->TlsConn != NULL) {
+      TlsSessionCacheSave (Instance);
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->HostName != NULL) {
+      FreePool (Instance->HostName);
+    }
+
     FreePool (Instance);
   }
 }
@@ -66,6 +71,7 @@ TlsCreateInstance (
 
   CopyMem (&TlsInstance->Tls, &mTlsProtocol, sizeof (TlsInstance->Tls));
   CopyMem (&TlsInstance->TlsConfig, &mTlsConfigurationProtocol, sizeof (TlsInstance->TlsConfig));
+  CopyMem (&TlsInstance->SessionCache, &mTlsSessionCacheProtocol, sizeof (TlsInstance->SessionCache));
 
   TlsInstance->TlsSessionState = EfiTlsSessionNotStarted;
 
@@ -86,6 +92,17 @@ TlsCleanService (
   )
 {
   if (Service != NULL) {
+    DEBUG ((
+      DEBUG_INFO,
+      "TlsDxe: %Lu full handshakes in %Lu ms, %Lu resumed handshakes in %Lu ms\n",
+      Service->FullHandshakes,
+      DivU64x32 (Service->FullHandshakeTime, 1000000),
+      Service->ResumedHandshakes,
+      DivU64x32 (Service->ResumedHandshakeTime, 1000000)
+      ));
+
+    TlsSessionCacheFlush (Service);
+
     if (Service->TlsCtx != NULL) {
       TlsCtxFree (Service->TlsCtx);
     }
@@ -132,6 +149,7 @@ TlsCreateService (
   TlsService->TlsChildrenNum = 0;
   InitializeListHead (&TlsService->TlsChildrenList);
   TlsService->ImageHandle = Image;
+  InitializeListHead (&TlsService->SessionCache);
 
   *Service = TlsService;
 
@@ -349,7 +367,7 @@ TlsServiceBindingCreateChild (
   }
 
   //
-  // Install TLS protocol and configuration protocol onto ChildHandle
+  // Install TLS protocol, configuration protocol and session cache protocol onto ChildHandle
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   ChildHandle,
@@ -357,6 +375,8 @@ TlsServiceBindingCreateChild (
                   &TlsInstance->Tls,
                   &gEfiTlsConfigurationProtocolGuid,
                   &TlsInstance->TlsConfig,
+                  &gEdkiiTlsSessionCacheProtocolGuid,
+                  &TlsInstance->SessionCache,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -466,7 +486,8 @@ TlsServiceBindingDestroyChild (
   TlsInstance->InDestroy = TRUE;
 
   //
-  // Uninstall the TLS protocol and TLS Configuration Protocol interface installed in ChildHandle.
+  // Uninstall the TLS protocol, TLS Configuration Protocol and TLS Session Cache Protocol
+  // interface installed in ChildHandle.
   //
   Status = gBS->UninstallMultipleProtocolInterfaces (
                   ChildHandle,
@@ -474,6 +495,8 @@ TlsServiceBindingDestroyChild (
                   Tls,
                   &gEfiTlsConfigurationProtocolGuid,
                   TlsConfig,
+                  &gEdkiiTlsSessionCacheProtocolGuid,
+                  &TlsInstance->SessionCache,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
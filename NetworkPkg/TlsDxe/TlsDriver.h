@@ -55,6 +55,21 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // Sessions of the previous connections, most recently used first, which
+  // are offered to the servers for resumption. See TlsSessionCache.c.
+  //
+  LIST_ENTRY                      SessionCache;
+  UINTN                           SessionCacheCount;
+
+  //
+  // Handshake statistics, the times are in nanoseconds.
+  //
+  UINT64                          FullHandshakes;
+  UINT64                          ResumedHandshakes;
+  UINT64                          FullHandshakeTime;
+  UINT64                          ResumedHandshakeTime;
 };
 
 struct _TLS_INSTANCE {
@@ -68,6 +83,7 @@ struct _TLS_INSTANCE {
 
   EFI_TLS_PROTOCOL                  Tls;
   EFI_TLS_CONFIGURATION_PROTOCOL    TlsConfig;
+  EDKII_TLS_SESSION_CACHE_PROTOCOL  SessionCache;
 
   EFI_TLS_SESSION_STATE             TlsSessionState;
 
@@ -76,6 +92,19 @@ struct _TLS_INSTANCE {
   // per established connection.
   //
   VOID                              *TlsConn;
+
+  //
+  // The server host name set with EfiTlsVerifyHost, the server port set
+  // with EDKII_TLS_SESSION_CACHE_PROTOCOL, and the digest of the
+  // certificates and keys set with EFI_TLS_CONFIGURATION_PROTOCOL, which
+  // identify the session of the connection in the session cache.
+  //
+  CHAR8                             *HostName;
+  UINT16                            ServerPort;
+  UINT8                             ConfigDigest[SHA256_DIGEST_SIZE];
+  BOOLEAN                           ConfigDigestError;
+  UINT64                            HandshakeStart;
+  BOOLEAN                           HandshakeDone;
 };
 
 #define TLS_SERVICE_FROM_THIS(a)   \
@@ -87,6 +116,9 @@ struct _TLS_INSTANCE {
 #define TLS_INSTANCE_FROM_CONFIGURATION(a)  \
   CR (a, TLS_INSTANCE, TlsConfig, TLS_INSTANCE_SIGNATURE)
 
+#define TLS_INSTANCE_FROM_SESSION_CACHE(a)  \
+  CR (a, TLS_INSTANCE, SessionCache, TLS_INSTANCE_SIGNATURE)
+
 /**
   Release all the resources used by the TLS instance.
 
@@ -22,12 +22,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/NetLib.h>
 #include <Library/BaseCryptLib.h>
 #include <Library/TlsLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
 
 //
 // Consumed Protocols
 //
 #include <Protocol/Tls.h>
 #include <Protocol/TlsConfig.h>
+#include <Protocol/TlsSessionCache.h>
 
 #include <IndustryStandard/Tls1.h>
 
@@ -36,9 +39,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Protocol instances
 //
-extern EFI_SERVICE_BINDING_PROTOCOL    mTlsServiceBinding;
-extern EFI_TLS_PROTOCOL                mTlsProtocol;
-extern EFI_TLS_CONFIGURATION_PROTOCOL  mTlsConfigurationProtocol;
+extern EFI_SERVICE_BINDING_PROTOCOL      mTlsServiceBinding;
+extern EFI_TLS_PROTOCOL                  mTlsProtocol;
+extern EFI_TLS_CONFIGURATION_PROTOCOL    mTlsConfigurationProtocol;
+extern EDKII_TLS_SESSION_CACHE_PROTOCOL  mTlsSessionCacheProtocol;
 
 /**
   Encrypt the message listed in fragment.
@@ -302,4 +306,86 @@ TlsConfigurationGetData (
   IN OUT UINTN                           *DataSize
   );
 
+/**
+  Set the port of the server the TLS connection is established with.
+
+  @param[in]  This            Pointer to the EDKII_TLS_SESSION_CACHE_PROTOCOL instance.
+  @param[in]  ServerPort      The TCP port of the server.
+
+  @retval EFI_SUCCESS             The port is set.
+  @retval EFI_INVALID_PARAMETER   This is NULL, or ServerPort is 0.
+  @retval EFI_ACCESS_DENIED       The handshake has started.
+**/
+EFI_STATUS
+EFIAPI
+TlsSessionCacheSetServerPort (
+  IN EDKII_TLS_SESSION_CACHE_PROTOCOL  *This,
+  IN UINT16                            ServerPort
+  );
+
+/**
+  Account a certificate or a key of the TLS connection in the digest of its
+  configuration. Only the sessions established with the same configuration
+  are resumed.
+
+  @param[in]  Instance        The TLS instance data.
+  @param[in]  DataType        The configuration data type.
+  @param[in]  Data            The configuration data.
+  @param[in]  DataSize        The size of Data in bytes.
+
+**/
+VOID
+TlsSessionCacheUpdateConfig (
+  IN TLS_INSTANCE              *Instance,
+  IN EFI_TLS_CONFIG_DATA_TYPE  DataType,
+  IN VOID                      *Data,
+  IN UINTN                     DataSize
+  );
+
+/**
+  Offer the cached session of the server to a TLS connection which is about
+  to start its handshake, and start timing the handshake.
+
+  @param[in]  Instance        The TLS instance data.
+
+**/
+VOID
+TlsSessionCacheResume (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Account a completed handshake in the handshake statistics of the service.
+
+  @param[in]  Instance        The TLS instance data.
+
+**/
+VOID
+TlsSessionCacheHandshakeDone (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Save the session of a TLS connection in the session cache, so that the
+  next connection to the same server can resume it.
+
+  @param[in]  Instance        The TLS instance data.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Release all the sessions in the session cache.
+
+  @param[in]  Service         The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  );
+
 #endif
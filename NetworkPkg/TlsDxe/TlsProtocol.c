@@ -187,6 +187,21 @@ TlsSetSessionData (
       }
 
       Status = TlsSetVerifyHost (Instance->TlsConn, TlsVerifyHost->Flags, TlsVerifyHost->HostName);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      //
+      // Remember the host name as the key of the session cache.
+      //
+      if (Instance->HostName != NULL) {
+        FreePool (Instance->HostName);
+      }
+
+      Instance->HostName = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
+      if (Instance->HostName == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+      }
 
       break;
     case EfiTlsSessionID:
@@ -485,8 +500,13 @@ TlsBuildResponsePacket (
     switch (Instance->TlsSessionState) {
       case EfiTlsSessionNotStarted:
         //
-        // ClientHello.
+        // ClientHello, offering the session of the previous connection to
+        // the same server for resumption.
         //
+        if (!Instance->HandshakeDone && (Instance->HandshakeStart == 0)) {
+          TlsSessionCacheResume (Instance);
+        }
+
         Status = TlsDoHandshake (
                    Instance->TlsConn,
                    NULL,
@@ -575,6 +595,7 @@ TlsBuildResponsePacket (
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+        TlsSessionCacheHandshakeDone (Instance);
       }
     } else {
       //
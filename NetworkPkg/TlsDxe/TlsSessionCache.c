@@ -0,0 +1,384 @@
+/** @file
+  TLS session cache of the TlsDxe driver.
+
+  The session of a client connection which verified the host name of the
+  server is kept when the connection is destroyed, and offered to the next
+  connection to the same server. A server which accepts it resumes the
+  session (from a TLS 1.2 session ID or ticket, or a TLS 1.3 pre-shared key)
+  with an abbreviated handshake, without the certificate exchange and the
+  key agreement of a full handshake. Up to PcdTlsSessionCacheSize sessions
+  are kept, the least recently used is evicted first.
+
+  A session is identified by the host name and the port of the server, and
+  by the digest of the CA certificates, the client certificate and the
+  client key of the connection. A resumed session skips the verification
+  of the server, so a session is never offered to a connection configured
+  differently: its entry is dropped instead. Setting a revocation list,
+  which is shared by all the connections, drops all the sessions.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TlsImpl.h"
+
+typedef struct {
+  LIST_ENTRY    Link;
+  CHAR8         *HostName;
+  UINT16        ServerPort;
+  UINT8         ConfigDigest[SHA256_DIGEST_SIZE];
+  VOID          *Session;
+} TLS_SESSION_CACHE_ENTRY;
+
+EDKII_TLS_SESSION_CACHE_PROTOCOL  mTlsSessionCacheProtocol = {
+  TlsSessionCacheSetServerPort
+};
+
+/**
+  Get the time elapsed since a performance counter value.
+
+  @param[in]  Start           The performance counter value to start from.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+STATIC
+UINT64
+TlsSessionCacheElapsed (
+  IN UINT64  Start
+  )
+{
+  UINT64  Now;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+
+  Now = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterStart > CounterEnd) {
+    return GetTimeInNanoSecond (Start - Now);
+  }
+
+  return GetTimeInNanoSecond (Now - Start);
+}
+
+/**
+  Remove an entry from the session cache and release it.
+
+  @param[in]  Service         The TLS service data.
+  @param[in]  Entry           The cache entry to remove.
+
+**/
+STATIC
+VOID
+TlsSessionCacheRemove (
+  IN TLS_SERVICE              *Service,
+  IN TLS_SESSION_CACHE_ENTRY  *Entry
+  )
+{
+  RemoveEntryList (&Entry->Link);
+  Service->SessionCacheCount--;
+
+  TlsSessionFree (Entry->Session);
+  FreePool (Entry->HostName);
+  FreePool (Entry);
+}
+
+/**
+  Find the cached session of the server of a TLS connection.
+
+  The entry of the server is dropped if its session was established with
+  another configuration.
+
+  @param[in]  Service         The TLS service data.
+  @param[in]  Instance        The TLS instance data.
+
+  @return The cache entry of the server, or NULL if there is none.
+
+**/
+STATIC
+TLS_SESSION_CACHE_ENTRY *
+TlsSessionCacheFind (
+  IN TLS_SERVICE   *Service,
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  LIST_ENTRY               *Link;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH (Link, &Service->SessionCache) {
+    Entry = BASE_CR (Link, TLS_SESSION_CACHE_ENTRY, Link);
+    if ((Entry->ServerPort == Instance->ServerPort) &&
+        (AsciiStriCmp (Entry->HostName, Instance->HostName) == 0))
+    {
+      if (CompareMem (Entry->ConfigDigest, Instance->ConfigDigest, SHA256_DIGEST_SIZE) != 0) {
+        TlsSessionCacheRemove (Service, Entry);
+        return NULL;
+      }
+
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Check whether the session of a TLS connection can be kept in, or resumed
+  from, the session cache.
+
+  @param[in]  Instance        The TLS instance data.
+
+  @retval TRUE                The server and the configuration are known.
+  @retval FALSE               The session must not be cached.
+
+**/
+STATIC
+BOOLEAN
+TlsSessionCacheable (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  return (BOOLEAN)((PcdGet32 (PcdTlsSessionCacheSize) != 0) &&
+                   (Instance->HostName != NULL) &&
+                   (Instance->ServerPort != 0) &&
+                   !Instance->ConfigDigestError);
+}
+
+/**
+  Set the port of the server the TLS connection is established with.
+
+  @param[in]  This            Pointer to the EDKII_TLS_SESSION_CACHE_PROTOCOL instance.
+  @param[in]  ServerPort      The TCP port of the server.
+
+  @retval EFI_SUCCESS             The port is set.
+  @retval EFI_INVALID_PARAMETER   This is NULL, or ServerPort is 0.
+  @retval EFI_ACCESS_DENIED       The handshake has started.
+**/
+EFI_STATUS
+EFIAPI
+TlsSessionCacheSetServerPort (
+  IN EDKII_TLS_SESSION_CACHE_PROTOCOL  *This,
+  IN UINT16                            ServerPort
+  )
+{
+  TLS_INSTANCE  *Instance;
+
+  if ((This == NULL) || (ServerPort == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Instance = TLS_INSTANCE_FROM_SESSION_CACHE (This);
+  if (Instance->TlsSessionState != EfiTlsSessionNotStarted) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  Instance->ServerPort = ServerPort;
+  return EFI_SUCCESS;
+}
+
+/**
+  Account a certificate or a key of the TLS connection in the digest of its
+  configuration. Only the sessions established with the same configuration
+  are resumed.
+
+  The digest is chained, it covers all the data set on the connection and
+  the order they were set in.
+
+  @param[in]  Instance        The TLS instance data.
+  @param[in]  DataType        The configuration data type.
+  @param[in]  Data            The configuration data.
+  @param[in]  DataSize        The size of Data in bytes.
+
+**/
+VOID
+TlsSessionCacheUpdateConfig (
+  IN TLS_INSTANCE              *Instance,
+  IN EFI_TLS_CONFIG_DATA_TYPE  DataType,
+  IN VOID                      *Data,
+  IN UINTN                     DataSize
+  )
+{
+  VOID     *HashCtx;
+  UINT32   Type;
+  BOOLEAN  Result;
+
+  if (Instance->ConfigDigestError) {
+    return;
+  }
+
+  HashCtx = AllocatePool (Sha256GetContextSize ());
+  if (HashCtx == NULL) {
+    Instance->ConfigDigestError = TRUE;
+    return;
+  }
+
+  Type   = (UINT32)DataType;
+  Result = Sha256Init (HashCtx) &&
+           Sha256Update (HashCtx, Instance->ConfigDigest, SHA256_DIGEST_SIZE) &&
+           Sha256Update (HashCtx, &Type, sizeof (Type)) &&
+           Sha256Update (HashCtx, Data, DataSize) &&
+           Sha256Final (HashCtx, Instance->ConfigDigest);
+  if (!Result) {
+    Instance->ConfigDigestError = TRUE;
+  }
+
+  FreePool (HashCtx);
+}
+
+/**
+  Offer the cached session of the server to a TLS connection which is about
+  to start its handshake, and start timing the handshake.
+
+  @param[in]  Instance        The TLS instance data.
+
+**/
+VOID
+TlsSessionCacheResume (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  Service                  = Instance->Service;
+  Instance->HandshakeStart = GetPerformanceCounter ();
+
+  if (!TlsSessionCacheable (Instance)) {
+    return;
+  }
+
+  Entry = TlsSessionCacheFind (Service, Instance);
+  if (Entry == NULL) {
+    return;
+  }
+
+  if (EFI_ERROR (TlsSetSession (Instance->TlsConn, Entry->Session))) {
+    //
+    // The session doesn't match the configuration of the connection
+    // any more, it will be replaced by the session of this connection.
+    //
+    TlsSessionCacheRemove (Service, Entry);
+    return;
+  }
+
+  RemoveEntryList (&Entry->Link);
+  InsertHeadList (&Service->SessionCache, &Entry->Link);
+}
+
+/**
+  Account a completed handshake in the handshake statistics of the service.
+
+  @param[in]  Instance        The TLS instance data.
+
+**/
+VOID
+TlsSessionCacheHandshakeDone (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SERVICE  *Service;
+  UINT64       Elapsed;
+
+  if (Instance->HandshakeDone) {
+    return;
+  }
+
+  Service                 = Instance->Service;
+  Instance->HandshakeDone = TRUE;
+  Elapsed                 = TlsSessionCacheElapsed (Instance->HandshakeStart);
+
+  if (TlsSessionReused (Instance->TlsConn)) {
+    Service->ResumedHandshakes++;
+    Service->ResumedHandshakeTime += Elapsed;
+  } else {
+    Service->FullHandshakes++;
+    Service->FullHandshakeTime += Elapsed;
+  }
+}
+
+/**
+  Save the session of a TLS connection in the session cache, so that the
+  next connection to the same server can resume it.
+
+  @param[in]  Instance        The TLS instance data.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  VOID                     *Session;
+
+  Service = Instance->Service;
+
+  //
+  // Only the sessions of the connections which completed a handshake with
+  // a verified server, and were not torn down by an error, are reusable.
+  //
+  if (!TlsSessionCacheable (Instance) || !Instance->HandshakeDone ||
+      (Instance->TlsSessionState == EfiTlsSessionError))
+  {
+    return;
+  }
+
+  Session = TlsGetSession (Instance->TlsConn);
+  if (Session == NULL) {
+    return;
+  }
+
+  Entry = TlsSessionCacheFind (Service, Instance);
+  if (Entry != NULL) {
+    TlsSessionFree (Entry->Session);
+    Entry->Session = Session;
+    RemoveEntryList (&Entry->Link);
+    InsertHeadList (&Service->SessionCache, &Entry->Link);
+    return;
+  }
+
+  Entry = AllocatePool (sizeof (TLS_SESSION_CACHE_ENTRY));
+  if (Entry == NULL) {
+    TlsSessionFree (Session);
+    return;
+  }
+
+  Entry->HostName = AllocateCopyPool (AsciiStrSize (Instance->HostName), Instance->HostName);
+  if (Entry->HostName == NULL) {
+    TlsSessionFree (Session);
+    FreePool (Entry);
+    return;
+  }
+
+  Entry->ServerPort = Instance->ServerPort;
+  Entry->Session    = Session;
+  CopyMem (Entry->ConfigDigest, Instance->ConfigDigest, SHA256_DIGEST_SIZE);
+  InsertHeadList (&Service->SessionCache, &Entry->Link);
+  Service->SessionCacheCount++;
+
+  while (Service->SessionCacheCount > PcdGet32 (PcdTlsSessionCacheSize)) {
+    TlsSessionCacheRemove (Service, BASE_CR (Service->SessionCache.BackLink, TLS_SESSION_CACHE_ENTRY, Link));
+  }
+}
+
+/**
+  Release all the sessions in the session cache.
+
+  @param[in]  Service         The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  )
+{
+  LIST_ENTRY  *Link;
+  LIST_ENTRY  *Next;
+
+  NET_LIST_FOR_EACH_SAFE (Link, Next, &Service->SessionCache) {
+    TlsSessionCacheRemove (Service, BASE_CR (Link, TLS_SESSION_CACHE_ENTRY, Link));
+  }
+}
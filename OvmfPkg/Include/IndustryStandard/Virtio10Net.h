@@ -23,4 +23,24 @@ typedef struct {
 } VIRTIO_1_0_NET_REQ;
 #pragma pack ()
 
+//
+// Device configuration layout, including the fields that follow the
+// virtio-0.9.5 ones. Mtu is only valid if VIRTIO_NET_F_MTU is offered.
+//
+#pragma pack (1)
+typedef struct {
+  VIRTIO_NET_CONFIG    V0_9_5;
+  UINT16               MaxVirtqueuePairs;
+  UINT16               Mtu;
+} VIRTIO_1_0_NET_CONFIG;
+#pragma pack ()
+
+#define OFFSET_OF_VNET_1_0(Field)  OFFSET_OF (VIRTIO_1_0_NET_CONFIG, Field)
+#define SIZE_OF_VNET_1_0(Field)    (sizeof ((VIRTIO_1_0_NET_CONFIG *) 0)->Field)
+
+//
+// Feature Bits beyond virtio-0.9.5
+//
+#define VIRTIO_NET_F_MTU  BIT3  // device reports its maximum MTU
+
 #endif // _VIRTIO_1_0_NET_H_
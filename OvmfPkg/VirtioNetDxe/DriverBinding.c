@@ -41,6 +41,8 @@
                                     host, the current link status is stored in
                                     *MediaPresent. Otherwise MediaPresent is
                                     unused.
+  param[in,out] MaxPacketSize       Raised to the MTU reported by the host, if
+                                    mergeable RX buffers are supported too.
 
   @retval EFI_UNSUPPORTED           The host doesn't supply a MAC address.
   @return                           Status codes from VirtIo protocol members.
@@ -53,7 +55,8 @@ VirtioNetGetFeatures (
   IN OUT  VNET_DEV         *Dev,
   OUT     EFI_MAC_ADDRESS  *MacAddress,
   OUT     BOOLEAN          *MediaPresentSupported,
-  OUT     BOOLEAN          *MediaPresent
+  OUT     BOOLEAN          *MediaPresent,
+  IN OUT  UINT32           *MaxPacketSize
   )
 {
   EFI_STATUS  Status;
@@ -61,6 +64,7 @@ VirtioNetGetFeatures (
   UINT64      Features;
   UINTN       MacIdx;
   UINT16      LinkStatus;
+  UINT16      Mtu;
 
   //
   // Interrogate the device for features (virtio-0.9.5, 2.2.1 Device
@@ -128,6 +132,30 @@ VirtioNetGetFeatures (
     *MediaPresent = (BOOLEAN)((LinkStatus & VIRTIO_NET_S_LINK_UP) != 0);
   }
 
+  //
+  // Frames bigger than the RX buffers need mergeable RX buffers, see
+  // VirtioNetInitRx(). The MTU field only exists in the virtio-1.0 layout.
+  //
+  if ((Dev->VirtIo->Revision >= VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+      ((Features & VIRTIO_NET_F_MRG_RXBUF) != 0) &&
+      ((Features & VIRTIO_NET_F_MTU) != 0))
+  {
+    Status = Dev->VirtIo->ReadDevice (
+                            Dev->VirtIo,
+                            OFFSET_OF_VNET_1_0 (Mtu),
+                            SIZE_OF_VNET_1_0 (Mtu),
+                            sizeof Mtu,
+                            &Mtu
+                            );
+    if (EFI_ERROR (Status)) {
+      goto YieldDevice;
+    }
+
+    if (Mtu > *MaxPacketSize) {
+      *MaxPacketSize = MIN (Mtu, VNET_MAX_MTU);
+    }
+  }
+
 YieldDevice:
   Dev->VirtIo->SetDeviceStatus (
                  Dev->VirtIo,
@@ -207,12 +235,15 @@ VirtioNetSnpPopulate (
   Dev->Snp.Receive        = &VirtioNetReceive;
   Dev->Snp.Mode           = &Dev->Snm;
 
+  Dev->RxLoan.ReceiveLoan = &VirtioNetReceiveLoan;
+  Dev->RxLoan.ReturnLoan  = &VirtioNetReturnLoan;
+
   Dev->Snm.State           = EfiSimpleNetworkStopped;
   Dev->Snm.HwAddressSize   = SIZE_OF_VNET (Mac);
   Dev->Snm.MediaHeaderSize = SIZE_OF_VNET (Mac) +       // dst MAC
                              SIZE_OF_VNET (Mac) +       // src MAC
                              2;                         // Ethertype
-  Dev->Snm.MaxPacketSize        = 1500;
+  Dev->Snm.MaxPacketSize        = VNET_RX_BUF_MTU;
   Dev->Snm.NvRamSize            = 0;
   Dev->Snm.NvRamAccessSize      = 0;
   Dev->Snm.ReceiveFilterMask    = RECEIVE_FILTERS_NO_MCAST;
@@ -229,7 +260,8 @@ VirtioNetSnpPopulate (
              Dev,
              &Dev->Snm.CurrentAddress,
              &Dev->Snm.MediaPresentSupported,
-             &Dev->Snm.MediaPresent
+             &Dev->Snm.MediaPresent,
+             &Dev->Snm.MaxPacketSize
              );
   if (EFI_ERROR (Status)) {
     goto CloseWaitForPacket;
@@ -531,6 +563,8 @@ VirtioNetDriverBindingStart (
                   &Dev->MacHandle,
                   &gEfiSimpleNetworkProtocolGuid,
                   &Dev->Snp,
+                  &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+                  &Dev->RxLoan,
                   &gEfiDevicePathProtocolGuid,
                   Dev->MacDevicePath,
                   NULL
@@ -562,6 +596,8 @@ UninstallMultiple:
          Dev->MacHandle,
          &gEfiDevicePathProtocolGuid,
          Dev->MacDevicePath,
+         &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+         &Dev->RxLoan,
          &gEfiSimpleNetworkProtocolGuid,
          &Dev->Snp,
          NULL
@@ -659,9 +695,12 @@ VirtioNetDriverBindingStop (
     OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
     ASSERT (Dev->MacHandle == ChildHandleBuffer[0]);
-    if (Dev->Snm.State != EfiSimpleNetworkStopped) {
+    if ((Dev->Snm.State != EfiSimpleNetworkStopped) ||
+        (Dev->RxOrphanCount > 0))
+    {
       //
-      // device in use, cannot stop driver instance
+      // device in use, or RX buffers still loaned out, cannot stop driver
+      // instance
       //
       Status = EFI_DEVICE_ERROR;
     } else {
@@ -675,6 +714,8 @@ VirtioNetDriverBindingStop (
              Dev->MacHandle,
              &gEfiDevicePathProtocolGuid,
              Dev->MacDevicePath,
+             &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+             &Dev->RxLoan,
              &gEfiSimpleNetworkProtocolGuid,
              &Dev->Snp,
              NULL
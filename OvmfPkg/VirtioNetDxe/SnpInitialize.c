@@ -163,7 +163,7 @@ VirtioNetInitTx (
 
   Dev->TxMaxPending = (UINT16)MIN (
                                 Dev->TxRing.QueueSize / 2,
-                                VNET_MAX_PENDING
+                                VNET_MAX_TX_PENDING
                                 );
   Dev->TxCurPending = 0;
   Dev->TxFreeStack  = AllocatePool (
@@ -214,9 +214,10 @@ VirtioNetInitTx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  TxSharedReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  TxSharedReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                     ((Dev->Features & VIRTIO_NET_F_MRG_RXBUF) == 0)) ?
                     sizeof (Dev->TxSharedReq->V0_9_5) :
                     sizeof *Dev->TxSharedReq;
 
@@ -315,6 +316,7 @@ VirtioNetInitRx (
   EFI_STATUS            Status;
   UINTN                 VirtioNetReqSize;
   UINTN                 RxBufSize;
+  UINTN                 RxDataOffset;
   UINT16                RxAlwaysPending;
   UINTN                 PktIdx;
   UINT16                DescIdx;
@@ -324,9 +326,10 @@ VirtioNetInitRx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  VirtioNetReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  VirtioNetReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                      ((Dev->Features & VIRTIO_NET_F_MRG_RXBUF) == 0)) ?
                      sizeof (VIRTIO_NET_REQ) :
                      sizeof (VIRTIO_1_0_NET_REQ);
 
@@ -336,8 +339,21 @@ VirtioNetInitRx (
   // - the recipient for the network data (which consists of Ethernet header
   //   and Ethernet payload).
   //
-  RxBufSize = VirtioNetReqSize +
-              (Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize);
+  // The network data is placed so that the protocol header following the
+  // Ethernet header is 4-byte aligned, as the network stack expects it when
+  // the buffers are loaned out with VirtioNetReceiveLoan().
+  //
+  // With VIRTIO_NET_F_MRG_RXBUF, frames bigger than VNET_RX_BUF_MTU are
+  // spread by the host over several descriptor chains, which are filled in
+  // from their first byte on, header descriptor included.
+  //
+  RxDataOffset = ALIGN_VALUE (VirtioNetReqSize + Dev->Snm.MediaHeaderSize, 4) -
+                 Dev->Snm.MediaHeaderSize;
+  RxBufSize = ALIGN_VALUE (
+                RxDataOffset + Dev->Snm.MediaHeaderSize +
+                MIN (Dev->Snm.MaxPacketSize, VNET_RX_BUF_MTU),
+                4
+                );
 
   //
   // Limit the number of pending RX packets if the queue is big. The division
@@ -378,6 +394,22 @@ VirtioNetInitRx (
 
   Dev->RxBuf = RxBuffer;
 
+  //
+  // Up to half of the RX buffers may be loaned out through the Rx Loan
+  // Protocol, the other half keeps reception running meanwhile.
+  //
+  Dev->RxBufSize   = RxBufSize;
+  Dev->RxLoanMax   = (UINT16)(RxAlwaysPending / 2);
+  Dev->RxLoanCount = 0;
+
+  //
+  // Recycled RX descriptor chains are made available to the host one by one,
+  // but the host is only notified once per quarter of them, or when the
+  // Used Ring has been drained, see VirtioNetKickRx().
+  //
+  Dev->RxRecycled  = 0;
+  Dev->RxKickBatch = (UINT16)MAX (RxAlwaysPending / 4, 1);
+
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
   //
@@ -412,12 +444,14 @@ VirtioNetInitRx (
     Dev->RxRing.Desc[DescIdx].Len   = (UINT32)VirtioNetReqSize;
     Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE | VRING_DESC_F_NEXT;
     Dev->RxRing.Desc[DescIdx].Next  = (UINT16)(DescIdx + 1);
-    RxBufDeviceAddress             += Dev->RxRing.Desc[DescIdx++].Len;
+    DescIdx++;
 
-    Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
-    Dev->RxRing.Desc[DescIdx].Len   = (UINT32)(RxBufSize - VirtioNetReqSize);
+    Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress + RxDataOffset;
+    Dev->RxRing.Desc[DescIdx].Len   = (UINT32)(RxBufSize - RxDataOffset);
     Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE;
-    RxBufDeviceAddress             += Dev->RxRing.Desc[DescIdx++].Len;
+    DescIdx++;
+
+    RxBufDeviceAddress += RxBufSize;
   }
 
   //
@@ -557,8 +591,17 @@ VirtioNetInitialize (
     !!(Features & VIRTIO_NET_F_STATUS)
     );
 
+  //
+  // Besides the features we depend on, accept mergeable RX buffers, and the
+  // MTU if VirtioNetGetFeatures() took it.
+  //
+  if (Dev->Snm.MaxPacketSize <= VNET_RX_BUF_MTU) {
+    Features &= ~(UINT64)VIRTIO_NET_F_MTU;
+  }
+
   Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_F_IOMMU_PLATFORM | VIRTIO_NET_F_MRG_RXBUF |
+              VIRTIO_NET_F_MTU;
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -605,6 +648,8 @@ VirtioNetInitialize (
     }
   }
 
+  Dev->Features = Features;
+
   //
   // step 6 -- virtio-net initialization complete
   //
@@ -15,6 +15,40 @@
 
 #include "VirtioNet.h"
 
+/**
+  Copy the data of a follow-up RX buffer of a packet spread by the host over
+  several buffers (VIRTIO_NET_F_MRG_RXBUF). The host fills such a descriptor
+  chain from its first byte on, the header descriptor included.
+
+  @param[in]  Dev      The VNET_DEV driver instance.
+  @param[in]  DescIdx  The head of the descriptor chain.
+  @param[in]  Len      The number of bytes the host wrote to the chain.
+  @param[out] Dest     Where to copy the bytes to.
+**/
+STATIC
+VOID
+VirtioNetCopyRxChain (
+  IN  VNET_DEV  *Dev,
+  IN  UINT32    DescIdx,
+  IN  UINT32    Len,
+  OUT UINT8     *Dest
+  )
+{
+  UINT32  HeadLen;
+
+  HeadLen = MIN (Len, Dev->RxRing.Desc[DescIdx].Len);
+  CopyMem (
+    Dest,
+    Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx].Addr - Dev->RxBufDeviceBase),
+    HeadLen
+    );
+  CopyMem (
+    Dest + HeadLen,
+    Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr - Dev->RxBufDeviceBase),
+    Len - HeadLen
+    );
+}
+
 /**
   Receives a packet from a network interface.
 
@@ -73,9 +107,11 @@ VirtioNetReceive (
   UINT32      RxLen;
   UINTN       OrigBufferSize;
   UINT8       *RxPtr;
-  UINT16      AvailIdx;
   EFI_STATUS  NotifyStatus;
   UINTN       RxBufOffset;
+  UINT16      NumBuffers;
+  UINT16      BufIdx;
+  UINTN       TotalLen;
 
   if ((This == NULL) || (BufferSize == NULL) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -102,6 +138,10 @@ VirtioNetReceive (
   MemoryFence ();
 
   if (Dev->RxLastUsed == RxCurUsed) {
+    //
+    // Drained; make sure the host knows about all the recycled buffers.
+    //
+    VirtioNetKickRx (Dev);
     Status = EFI_NOT_READY;
     goto Exit;
   }
@@ -120,15 +160,37 @@ VirtioNetReceive (
   //
   ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
 
+  //
+  // With VIRTIO_NET_F_MRG_RXBUF the packet may continue in the next used
+  // buffers, which the host publishes together with the first one.
+  //
+  NumBuffers = VirtioNetRxNumBuffers (Dev, DescIdx);
+  if (NumBuffers > (UINT16)(RxCurUsed - Dev->RxLastUsed)) {
+    if (NumBuffers > Dev->RxRing.QueueSize / 2) {
+      NumBuffers = 1;
+      Status     = EFI_DEVICE_ERROR;
+      goto RecycleDesc; // drop malformed packet
+    }
+
+    Status = EFI_NOT_READY;
+    goto Exit;
+  }
+
+  TotalLen = RxLen;
+  for (BufIdx = 1; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) % Dev->RxRing.QueueSize;
+    TotalLen   += Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+  }
+
   OrigBufferSize = *BufferSize;
-  *BufferSize    = RxLen;
+  *BufferSize    = TotalLen;
 
-  if (OrigBufferSize < RxLen) {
+  if (OrigBufferSize < TotalLen) {
     Status = EFI_BUFFER_TOO_SMALL;
     goto Exit; // keep the packet
   }
 
-  if (RxLen < Dev->Snm.MediaHeaderSize) {
+  if (TotalLen < Dev->Snm.MediaHeaderSize) {
     Status = EFI_DEVICE_ERROR;
     goto RecycleDesc; // drop useless short packet
   }
@@ -139,8 +201,21 @@ VirtioNetReceive (
 
   RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
                         Dev->RxBufDeviceBase);
-  RxPtr = Dev->RxBuf + RxBufOffset;
-  CopyMem (Buffer, RxPtr, RxLen);
+  CopyMem (Buffer, Dev->RxBuf + RxBufOffset, RxLen);
+
+  RxPtr = (UINT8 *)Buffer + RxLen;
+  for (BufIdx = 1; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) % Dev->RxRing.QueueSize;
+    VirtioNetCopyRxChain (
+      Dev,
+      Dev->RxRing.Used.UsedElem[UsedElemIdx].Id,
+      Dev->RxRing.Used.UsedElem[UsedElemIdx].Len,
+      RxPtr
+      );
+    RxPtr += Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+  }
+
+  RxPtr = Buffer;
 
   if (DestAddr != NULL) {
     CopyMem (DestAddr, RxPtr, SIZE_OF_VNET (Mac));
@@ -163,23 +238,28 @@ VirtioNetReceive (
   Status = EFI_SUCCESS;
 
 RecycleDesc:
-  ++Dev->RxLastUsed;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = Dev->RxLastUsed++ % Dev->RxRing.QueueSize;
+    DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+
+    NotifyStatus = VirtioNetRecycleRxDesc (Dev, DescIdx);
+    if (!EFI_ERROR (Status)) {
+      // earlier error takes precedence
+      Status = NotifyStatus;
+    }
+  }
 
   //
-  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
+  // If this packet drained the Used Ring, make sure the host knows about all
+  // the recycled buffers, as the caller may not call us again before the next
+  // packet arrives.
   //
-  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16)DescIdx;
-
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
-
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) {
-    // earlier error takes precedence
-    Status = NotifyStatus;
+  if (Dev->RxLastUsed == RxCurUsed) {
+    NotifyStatus = VirtioNetKickRx (Dev);
+    if (!EFI_ERROR (Status)) {
+      // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
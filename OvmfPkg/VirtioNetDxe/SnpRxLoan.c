@@ -0,0 +1,210 @@
+/** @file
+
+  Implementation of the Simple Network Rx Loan Protocol, which hands the RX
+  buffers of the device to the SNP consumer instead of copying the packets
+  out of them.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "VirtioNet.h"
+
+/**
+  Receive a packet from the network interface into a buffer loaned by the
+  interface.
+
+  @param  This          This EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param  HeaderSize    The size, in bytes, of the media header received on
+                        the network interface. Optional.
+  @param  BufferSize    On exit, the size, in bytes, of the packet received.
+  @param  Buffer        On exit, the loaned buffer holding the packet.
+
+  @retval EFI_SUCCESS           A packet is received into a loaned buffer.
+  @retval EFI_NOT_STARTED       The network interface is not initialized.
+  @retval EFI_NOT_READY         No packet has been received.
+  @retval EFI_OUT_OF_RESOURCES  The maximum number of buffers is loaned out, or
+                                the packet spans several buffers.
+  @retval EFI_INVALID_PARAMETER BufferSize or Buffer is NULL.
+  @retval EFI_DEVICE_ERROR      The network interface reported an error.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetReceiveLoan (
+  IN  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  OUT UINTN                                  *HeaderSize OPTIONAL,
+  OUT UINTN                                  *BufferSize,
+  OUT VOID                                   **Buffer
+  )
+{
+  VNET_DEV    *Dev;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  UINT16      RxCurUsed;
+  UINT16      UsedElemIdx;
+  UINT32      DescIdx;
+  UINT32      RxLen;
+
+  if ((This == NULL) || (BufferSize == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dev    = VIRTIO_NET_FROM_RX_LOAN (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  if (Dev->Snm.State != EfiSimpleNetworkInitialized) {
+    Status = EFI_NOT_STARTED;
+    goto Exit;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  RxCurUsed = *Dev->RxRing.Used.Idx;
+  MemoryFence ();
+
+  if (Dev->RxLastUsed == RxCurUsed) {
+    VirtioNetKickRx (Dev);
+    Status = EFI_NOT_READY;
+    goto Exit;
+  }
+
+  if (Dev->RxLoanCount >= Dev->RxLoanMax) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit; // leave the packet to VirtioNetReceive()
+  }
+
+  UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
+  DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+  RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+
+  //
+  // the virtio-net request header must be complete; we skip it
+  //
+  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
+  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
+  //
+  // the host must not have filled in more data than requested
+  //
+  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+
+  if (VirtioNetRxNumBuffers (Dev, DescIdx) > 1) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit; // a packet spread over several buffers can't be loaned
+  }
+
+  ++Dev->RxLastUsed;
+
+  if (RxLen < Dev->Snm.MediaHeaderSize) {
+    //
+    // drop useless short packet
+    //
+    VirtioNetRecycleRxDesc (Dev, DescIdx);
+    Status = EFI_DEVICE_ERROR;
+    goto Exit;
+  }
+
+  if (HeaderSize != NULL) {
+    *HeaderSize = Dev->Snm.MediaHeaderSize;
+  }
+
+  *BufferSize = RxLen;
+  *Buffer     = Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
+                                     Dev->RxBufDeviceBase);
+  ++Dev->RxLoanCount;
+  Status = EFI_SUCCESS;
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Hand a loaned receive buffer back to the network interface.
+
+  @param  This          This EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param  Buffer        The buffer returned by ReceiveLoan().
+
+  @retval EFI_SUCCESS           The buffer is returned.
+  @retval EFI_INVALID_PARAMETER Buffer is not a loaned buffer.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetReturnLoan (
+  IN EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  IN VOID                                   *Buffer
+  )
+{
+  VNET_DEV    *Dev;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  UINT8       *RxPtr;
+  UINTN       PktIdx;
+  UINT32      DescIdx;
+
+  if ((This == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dev    = VIRTIO_NET_FROM_RX_LOAN (This);
+  RxPtr  = Buffer;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if ((Dev->RxOrphanCount > 0) &&
+      (RxPtr >= Dev->RxOrphanBuf) &&
+      (RxPtr < Dev->RxOrphanBuf + EFI_PAGES_TO_SIZE (Dev->RxOrphanNrPages)))
+  {
+    //
+    // The buffer was loaned out before the last shutdown, release the memory
+    // with the last such buffer.
+    //
+    if (--Dev->RxOrphanCount == 0) {
+      Dev->VirtIo->FreeSharedPages (
+                     Dev->VirtIo,
+                     Dev->RxOrphanNrPages,
+                     Dev->RxOrphanBuf
+                     );
+      Dev->RxOrphanBuf = NULL;
+    }
+
+    Status = EFI_SUCCESS;
+    goto Exit;
+  }
+
+  if ((Dev->Snm.State != EfiSimpleNetworkInitialized) ||
+      (Dev->RxLoanCount == 0) ||
+      (RxPtr < Dev->RxBuf) ||
+      (RxPtr >= Dev->RxBuf + EFI_PAGES_TO_SIZE (Dev->RxBufNrPages)))
+  {
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  //
+  // Each RX packet owns RxBufSize bytes of RxBuf and a two-part descriptor
+  // chain, see VirtioNetInitRx().
+  //
+  PktIdx  = (UINTN)(RxPtr - Dev->RxBuf) / Dev->RxBufSize;
+  DescIdx = (UINT32)PktIdx * 2;
+  if ((PktIdx >= Dev->RxRing.QueueSize / 2) ||
+      (RxPtr != Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
+                                     Dev->RxBufDeviceBase)))
+  {
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  --Dev->RxLoanCount;
+  Status = VirtioNetRecycleRxDesc (Dev, DescIdx);
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
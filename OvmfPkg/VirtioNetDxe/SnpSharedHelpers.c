@@ -8,6 +8,7 @@
 
 **/
 
+#include <Library/BaseLib.h>
 #include <Library/MemoryAllocationLib.h>
 
 #include "VirtioNet.h"
@@ -43,6 +44,30 @@ VirtioNetShutdownRx (
   )
 {
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxBufMap);
+
+  if (Dev->RxLoanCount > 0) {
+    //
+    // Some RX buffers are still loaned out through the Rx Loan Protocol. The
+    // device has been reset, so it won't touch them anymore, but the memory
+    // may only be released when the last of them is returned, see
+    // VirtioNetReturnLoan().
+    //
+    if (Dev->RxOrphanCount > 0) {
+      DEBUG ((
+        DEBUG_WARN,
+        "%a: leaking %u loaned RX buffers of an earlier shutdown\n",
+        __func__,
+        Dev->RxOrphanCount
+        ));
+    }
+
+    Dev->RxOrphanBuf     = Dev->RxBuf;
+    Dev->RxOrphanNrPages = Dev->RxBufNrPages;
+    Dev->RxOrphanCount   = Dev->RxLoanCount;
+    Dev->RxLoanCount     = 0;
+    return;
+  }
+
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
                  Dev->RxBufNrPages,
@@ -50,6 +75,105 @@ VirtioNetShutdownRx (
                  );
 }
 
+/**
+  Give a received RX descriptor chain back to the device.
+
+  The chain is made available to the device at once, but the device is only
+  notified about it once RxKickBatch chains have been recycled, or when
+  VirtioNetKickRx() is called because the Used Ring has been drained.
+
+  @param[in,out] Dev      The VNET_DEV driver instance.
+  @param[in]     DescIdx  The head of the descriptor chain, as reported in the
+                          used ring.
+
+  @return  The status of the queue notification.
+*/
+EFI_STATUS
+EFIAPI
+VirtioNetRecycleRxDesc (
+  IN OUT VNET_DEV  *Dev,
+  IN     UINT32    DescIdx
+  )
+{
+  UINT16  AvailIdx;
+
+  //
+  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
+  //
+  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
+  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
+    (UINT16)DescIdx;
+
+  MemoryFence ();
+  *Dev->RxRing.Avail.Idx = AvailIdx;
+
+  if (++Dev->RxRecycled < Dev->RxKickBatch) {
+    return EFI_SUCCESS;
+  }
+
+  return VirtioNetKickRx (Dev);
+}
+
+/**
+  Notify the device about the RX descriptor chains recycled since the last
+  notification, unless the device asked not to be notified.
+
+  @param[in,out] Dev      The VNET_DEV driver instance.
+
+  @return  The status of the queue notification.
+*/
+EFI_STATUS
+EFIAPI
+VirtioNetKickRx (
+  IN OUT VNET_DEV  *Dev
+  )
+{
+  if (Dev->RxRecycled == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Dev->RxRecycled = 0;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device
+  //
+  MemoryFence ();
+  if ((*Dev->RxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    return EFI_SUCCESS;
+  }
+
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+}
+
+/**
+  Get the number of RX buffers a received packet spans.
+
+  @param[in] Dev      The VNET_DEV driver instance.
+  @param[in] DescIdx  The head of the descriptor chain of the first buffer of
+                      the packet, as reported in the used ring.
+
+  @return  The NumBuffers field of the virtio-net request header if
+           VIRTIO_NET_F_MRG_RXBUF has been negotiated, 1 otherwise.
+*/
+UINT16
+EFIAPI
+VirtioNetRxNumBuffers (
+  IN VNET_DEV  *Dev,
+  IN UINT32    DescIdx
+  )
+{
+  VIRTIO_1_0_NET_REQ  *Req;
+
+  if ((Dev->Features & VIRTIO_NET_F_MRG_RXBUF) == 0) {
+    return 1;
+  }
+
+  Req = (VIRTIO_1_0_NET_REQ *)(Dev->RxBuf +
+                               (UINTN)(Dev->RxRing.Desc[DescIdx].Addr -
+                                       Dev->RxBufDeviceBase));
+  return MAX (Req->NumBuffers, 1);
+}
+
 VOID
 EFIAPI
 VirtioNetShutdownTx (
@@ -173,7 +173,16 @@ VirtioNetTransmit (
   MemoryFence ();
   *Dev->TxRing.Avail.Idx = AvailIdx;
 
+  //
+  // The device may be processing the queue already, and not want to be
+  // notified.
+  //
   MemoryFence ();
+  if ((*Dev->TxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    Status = EFI_SUCCESS;
+    goto Exit;
+  }
+
   Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
 
 Exit:
@@ -20,6 +20,7 @@
 #include <Protocol/DevicePath.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkRxLoan.h>
 #include <Library/OrderedCollectionLib.h>
 
 #define VNET_SIG  SIGNATURE_32 ('V', 'N', 'E', 'T')
@@ -27,7 +28,16 @@
 //
 // maximum number of pending packets, separately for each direction
 //
-#define VNET_MAX_PENDING  64
+#define VNET_MAX_PENDING     64
+#define VNET_MAX_TX_PENDING  256
+
+//
+// With VIRTIO_NET_F_MRG_RXBUF, the RX buffers remain sized for standard
+// Ethernet frames, and the host spreads bigger frames over several of them.
+// The MTU reported by the host is honored up to VNET_MAX_MTU then.
+//
+#define VNET_RX_BUF_MTU  1500
+#define VNET_MAX_MTU     9000
 
 //
 // State diagram:
@@ -69,13 +79,15 @@ typedef struct {
   //
   //                          field              init function
   //                          ------------------ ------------------------------
-  UINT32                         Signature;      // VirtioNetDriverBindingStart
-  VIRTIO_DEVICE_PROTOCOL         *VirtIo;        // VirtioNetDriverBindingStart
-  EFI_SIMPLE_NETWORK_PROTOCOL    Snp;            // VirtioNetSnpPopulate
-  EFI_SIMPLE_NETWORK_MODE        Snm;            // VirtioNetSnpPopulate
-  EFI_EVENT                      ExitBoot;       // VirtioNetSnpPopulate
-  EFI_DEVICE_PATH_PROTOCOL       *MacDevicePath; // VirtioNetDriverBindingStart
-  EFI_HANDLE                     MacHandle;      // VirtioNetDriverBindingStart
+  UINT32                                   Signature;      // VirtioNetDriverBindingStart
+  VIRTIO_DEVICE_PROTOCOL                   *VirtIo;        // VirtioNetDriverBindingStart
+  EFI_SIMPLE_NETWORK_PROTOCOL              Snp;            // VirtioNetSnpPopulate
+  EFI_SIMPLE_NETWORK_MODE                  Snm;            // VirtioNetSnpPopulate
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL    RxLoan;         // VirtioNetSnpPopulate
+  EFI_EVENT                                ExitBoot;       // VirtioNetSnpPopulate
+  EFI_DEVICE_PATH_PROTOCOL                 *MacDevicePath; // VirtioNetDriverBindingStart
+  EFI_HANDLE                               MacHandle;      // VirtioNetDriverBindingStart
+  UINT64                                   Features;       // VirtioNetInitialize
 
   VRING                          RxRing;          // VirtioNetInitRing
   VOID                           *RxRingMap;      // VirtioRingMap and
@@ -85,6 +97,14 @@ typedef struct {
   UINTN                          RxBufNrPages;    // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
   VOID                           *RxBufMap;       // VirtioNetInitRx
+  UINTN                          RxBufSize;       // VirtioNetInitRx
+  UINT16                         RxLoanMax;       // VirtioNetInitRx
+  UINT16                         RxLoanCount;     // VirtioNetInitRx
+  UINT8                          *RxOrphanBuf;    // VirtioNetShutdownRx
+  UINTN                          RxOrphanNrPages; // VirtioNetShutdownRx
+  UINT16                         RxOrphanCount;   // VirtioNetShutdownRx
+  UINT16                         RxRecycled;      // VirtioNetInitRx
+  UINT16                         RxKickBatch;     // VirtioNetInitRx
 
   VRING                          TxRing;           // VirtioNetInitRing
   VOID                           *TxRingMap;       // VirtioRingMap and
@@ -111,6 +131,9 @@ typedef struct {
 #define VIRTIO_NET_FROM_SNP(SnpPointer) \
         CR (SnpPointer, VNET_DEV, Snp, VNET_SIG)
 
+#define VIRTIO_NET_FROM_RX_LOAN(RxLoanPointer) \
+        CR (RxLoanPointer, VNET_DEV, RxLoan, VNET_SIG)
+
 #define VIRTIO_CFG_WRITE(Dev, Field, Value)  ((Dev)->VirtIo->WriteDevice (  \
                                                 (Dev)->VirtIo,              \
                                                 OFFSET_OF_VNET (Field),     \
@@ -252,9 +275,48 @@ VirtioNetReceive (
   OUT UINT16                      *Protocol   OPTIONAL
   );
 
+//
+// member functions implementing the Simple Network Rx Loan Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioNetReceiveLoan (
+  IN  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  OUT UINTN                                  *HeaderSize OPTIONAL,
+  OUT UINTN                                  *BufferSize,
+  OUT VOID                                   **Buffer
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioNetReturnLoan (
+  IN EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  IN VOID                                   *Buffer
+  );
+
 //
 // utility functions shared by various SNP member functions
 //
+EFI_STATUS
+EFIAPI
+VirtioNetRecycleRxDesc (
+  IN OUT VNET_DEV  *Dev,
+  IN     UINT32    DescIdx
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioNetKickRx (
+  IN OUT VNET_DEV  *Dev
+  );
+
+UINT16
+EFIAPI
+VirtioNetRxNumBuffers (
+  IN VNET_DEV  *Dev,
+  IN UINT32    DescIdx
+  );
+
 VOID
 EFIAPI
 VirtioNetShutdownRx (
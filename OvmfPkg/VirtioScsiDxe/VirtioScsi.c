@@ -7,16 +7,18 @@
 
   - No hotplug / hot-unplug.
 
-  - Although EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru() could be a good match
-    for multiple in-flight virtio-scsi requests, we stick to synchronous
-    requests for now.
+  - EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru() supports non-blocking requests.
+    Up to VSCSI_MAX_IN_FLIGHT requests are in flight on the request virtqueue
+    at the same time; further requests wait in a pending list. Completed
+    non-blocking requests are reaped by a periodic timer, blocking requests
+    poll the used ring themselves.
 
   - Timeouts are not supported for EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru().
 
   - Only one channel is supported. (At the time of this writing, host-side
     virtio-scsi supports a single channel too.)
 
-  - Only one request queue is used (for the one synchronous request).
+  - Only one request queue is used.
 
   - The ResetChannel() and ResetTargetLun() functions of
     EFI_EXT_SCSI_PASS_THRU_PROTOCOL are not supported (which is allowed by the
@@ -411,66 +413,127 @@ ReportHostAdapterError (
   return EFI_DEVICE_ERROR;
 }
 
-//
-// The next seven functions implement EFI_EXT_SCSI_PASS_THRU_PROTOCOL
-// for the virtio-scsi HBA. Refer to UEFI Spec 2.3.1 + Errata C, sections
-// - 14.1 SCSI Driver Model Overview,
-// - 14.7 Extended SCSI Pass Thru Protocol.
-//
+/**
+
+  Release the buffers and mappings of a request, in the reverse order of
+  their setup in VirtioScsiPrepareRequest(). The VSCSI_REQ structure itself is
+  not freed.
+
+  @param[in] Dev  The virtio-scsi host device the request belongs to.
+
+  @param[in] Req  The request whose resources should be released. Resources
+                  that have not been set up are skipped.
+
+**/
+STATIC
+VOID
+VirtioScsiReleaseRequest (
+  IN VSCSI_DEV  *Dev,
+  IN VSCSI_REQ  *Req
+  )
+{
+  if (Req->ResponseMapping != NULL) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->ResponseMapping);
+    Req->ResponseMapping = NULL;
+  }
+
+  if (Req->Response != NULL) {
+    Dev->VirtIo->FreeSharedPages (
+                   Dev->VirtIo,
+                   EFI_SIZE_TO_PAGES (sizeof *Req->Response),
+                   (VOID *)Req->Response
+                   );
+    Req->Response = NULL;
+  }
+
+  if (Req->OutDataBufferIsMapped) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->OutDataMapping);
+    Req->OutDataBufferIsMapped = FALSE;
+  }
+
+  if (Req->InDataMapping != NULL) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->InDataMapping);
+    Req->InDataMapping = NULL;
+  }
+
+  if (Req->InDataBuffer != NULL) {
+    Dev->VirtIo->FreeSharedPages (
+                   Dev->VirtIo,
+                   Req->InDataNumPages,
+                   Req->InDataBuffer
+                   );
+    Req->InDataBuffer = NULL;
+  }
+
+  if (Req->RequestMapping != NULL) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->RequestMapping);
+    Req->RequestMapping = NULL;
+  }
+
+  if (Req->Request != NULL) {
+    FreePool ((VOID *)Req->Request);
+    Req->Request = NULL;
+  }
+}
+
+/**
+
+  Allocate a request tracking structure for an
+  EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru() call, populate the virtio-scsi
+  request header, and set up and map all the buffers the host will access.
+
+  @param[in] Dev          The virtio-scsi host device the request is sent to.
 
+  @param[in] Target       The target identifier, in host byte order.
+
+  @param[in] Lun          The LUN parameter of PassThru().
+
+  @param[in,out] Packet   The Packet parameter of PassThru(). On error, the
+                          packet may have been updated as described for the
+                          error codes of PassThru().
+
+  @param[in] Event        The Event parameter of PassThru().
+
+  @param[out] Req         On success, the new request, ready to be submitted
+                          to the host.
+
+  @return  Status codes as documented for PassThru(). EFI_SUCCESS means only
+           that the request is ready to be submitted.
+
+**/
+STATIC
 EFI_STATUS
-EFIAPI
-VirtioScsiPassThru (
-  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
-  IN     UINT8                                       *Target,
+VirtioScsiPrepareRequest (
+  IN     VSCSI_DEV                                   *Dev,
+  IN     UINT16                                      Target,
   IN     UINT64                                      Lun,
   IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
-  IN     EFI_EVENT                                   Event   OPTIONAL
+  IN     EFI_EVENT                                   Event   OPTIONAL,
+  OUT    VSCSI_REQ                                   **Req
   )
 {
-  VSCSI_DEV                  *Dev;
-  UINT16                     TargetValue;
-  EFI_STATUS                 Status;
-  volatile VIRTIO_SCSI_REQ   *Request;
-  volatile VIRTIO_SCSI_RESP  *Response;
-  VOID                       *ResponseBuffer;
-  DESC_INDICES               Indices;
-  VOID                       *RequestMapping;
-  VOID                       *ResponseMapping;
-  VOID                       *InDataMapping;
-  VOID                       *OutDataMapping;
-  EFI_PHYSICAL_ADDRESS       RequestDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       ResponseDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       InDataDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       OutDataDeviceAddress;
-  VOID                       *InDataBuffer;
-  UINTN                      InDataNumPages;
-  BOOLEAN                    OutDataBufferIsMapped;
-
-  //
-  // Set InDataMapping,OutDataMapping,InDataDeviceAddress and OutDataDeviceAddress to
-  // suppress incorrect compiler/analyzer warnings.
-  //
-  InDataMapping        = NULL;
-  OutDataMapping       = NULL;
-  InDataDeviceAddress  = 0;
-  OutDataDeviceAddress = 0;
-
-  Request = AllocateZeroPool (sizeof (*Request));
-  if (Request == NULL) {
+  VSCSI_REQ   *NewReq;
+  EFI_STATUS  Status;
+  VOID        *ResponseBuffer;
+
+  NewReq = AllocateZeroPool (sizeof *NewReq);
+  if (NewReq == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Dev = VIRTIO_SCSI_FROM_PASS_THRU (This);
-  CopyMem (&TargetValue, Target, sizeof TargetValue);
+  NewReq->Signature = VSCSI_REQ_SIG;
+  NewReq->Packet    = Packet;
+  NewReq->Event     = Event;
 
-  InDataBuffer          = NULL;
-  OutDataBufferIsMapped = FALSE;
-  InDataNumPages        = 0;
+  NewReq->Request = AllocateZeroPool (sizeof (*NewReq->Request));
+  if (NewReq->Request == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Failed;
+  }
 
-  Status = PopulateRequest (Dev, TargetValue, Lun, Packet, Request);
+  Status = PopulateRequest (Dev, Target, Lun, Packet, NewReq->Request);
   if (EFI_ERROR (Status)) {
-    goto FreeScsiRequest;
+    goto Failed;
   }
 
   //
@@ -479,14 +542,14 @@ VirtioScsiPassThru (
   Status = VirtioMapAllBytesInSharedBuffer (
              Dev->VirtIo,
              VirtioOperationBusMasterRead,
-             (VOID *)Request,
-             sizeof (*Request),
-             &RequestDeviceAddress,
-             &RequestMapping
+             (VOID *)NewReq->Request,
+             sizeof (*NewReq->Request),
+             &NewReq->RequestDeviceAddress,
+             &NewReq->RequestMapping
              );
   if (EFI_ERROR (Status)) {
     Status = ReportHostAdapterError (Packet);
-    goto FreeScsiRequest;
+    goto Failed;
   }
 
   //
@@ -508,30 +571,32 @@ VirtioScsiPassThru (
     // the Virtio request is successful then we copy the data from temporary
     // buffer into Packet->InDataBuffer.
     //
-    InDataNumPages = EFI_SIZE_TO_PAGES ((UINTN)Packet->InTransferLength);
-    Status         = Dev->VirtIo->AllocateSharedPages (
-                                    Dev->VirtIo,
-                                    InDataNumPages,
-                                    &InDataBuffer
-                                    );
+    NewReq->InDataNumPages = EFI_SIZE_TO_PAGES ((UINTN)Packet->InTransferLength);
+    Status                 = Dev->VirtIo->AllocateSharedPages (
+                                            Dev->VirtIo,
+                                            NewReq->InDataNumPages,
+                                            &NewReq->InDataBuffer
+                                            );
     if (EFI_ERROR (Status)) {
-      Status = ReportHostAdapterError (Packet);
-      goto UnmapRequestBuffer;
+      NewReq->InDataBuffer = NULL;
+      Status               = ReportHostAdapterError (Packet);
+      goto Failed;
     }
 
-    ZeroMem (InDataBuffer, Packet->InTransferLength);
+    ZeroMem (NewReq->InDataBuffer, Packet->InTransferLength);
 
     Status = VirtioMapAllBytesInSharedBuffer (
                Dev->VirtIo,
                VirtioOperationBusMasterCommonBuffer,
-               InDataBuffer,
+               NewReq->InDataBuffer,
                Packet->InTransferLength,
-               &InDataDeviceAddress,
-               &InDataMapping
+               &NewReq->InDataDeviceAddress,
+               &NewReq->InDataMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = ReportHostAdapterError (Packet);
-      goto FreeInDataBuffer;
+      NewReq->InDataMapping = NULL;
+      Status                = ReportHostAdapterError (Packet);
+      goto Failed;
     }
   }
 
@@ -544,15 +609,15 @@ VirtioScsiPassThru (
                VirtioOperationBusMasterRead,
                Packet->OutDataBuffer,
                Packet->OutTransferLength,
-               &OutDataDeviceAddress,
-               &OutDataMapping
+               &NewReq->OutDataDeviceAddress,
+               &NewReq->OutDataMapping
                );
     if (EFI_ERROR (Status)) {
       Status = ReportHostAdapterError (Packet);
-      goto UnmapInDataBuffer;
+      goto Failed;
     }
 
-    OutDataBufferIsMapped = TRUE;
+    NewReq->OutDataBufferIsMapped = TRUE;
   }
 
   //
@@ -562,22 +627,22 @@ VirtioScsiPassThru (
   //
   Status = Dev->VirtIo->AllocateSharedPages (
                           Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *Response),
+                          EFI_SIZE_TO_PAGES (sizeof *NewReq->Response),
                           &ResponseBuffer
                           );
   if (EFI_ERROR (Status)) {
     Status = ReportHostAdapterError (Packet);
-    goto UnmapOutDataBuffer;
+    goto Failed;
   }
 
-  Response = ResponseBuffer;
+  NewReq->Response = ResponseBuffer;
 
-  ZeroMem ((VOID *)Response, sizeof (*Response));
+  ZeroMem ((VOID *)NewReq->Response, sizeof (*NewReq->Response));
 
   //
   // preset a host status for ourselves that we do not accept as success
   //
-  Response->Response = VIRTIO_SCSI_S_FAILURE;
+  NewReq->Response->Response = VIRTIO_SCSI_S_FAILURE;
 
   //
   // Map the response buffer with BusMasterCommonBuffer so that response
@@ -587,30 +652,139 @@ VirtioScsiPassThru (
              Dev->VirtIo,
              VirtioOperationBusMasterCommonBuffer,
              ResponseBuffer,
-             sizeof (*Response),
-             &ResponseDeviceAddress,
-             &ResponseMapping
+             sizeof (*NewReq->Response),
+             &NewReq->ResponseDeviceAddress,
+             &NewReq->ResponseMapping
              );
   if (EFI_ERROR (Status)) {
-    Status = ReportHostAdapterError (Packet);
-    goto FreeResponseBuffer;
+    NewReq->ResponseMapping = NULL;
+    Status                  = ReportHostAdapterError (Packet);
+    goto Failed;
   }
 
-  VirtioPrepare (&Dev->Ring, &Indices);
+  *Req = NewReq;
+  return EFI_SUCCESS;
+
+Failed:
+  VirtioScsiReleaseRequest (Dev, NewReq);
+  FreePool (NewReq);
+  return Status;
+}
+
+/**
+
+  Finish a request: release its resources, then either signal the caller's
+  event and free the request (non-blocking request), or mark the request as
+  done for the polling caller (blocking request).
+
+  The caller is responsible for having updated the request packet, and for
+  having set Req->Status. Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-scsi host device the request belongs to.
+
+  @param[in] Req  The request to finish.
+
+**/
+STATIC
+VOID
+VirtioScsiFinishRequest (
+  IN VSCSI_DEV  *Dev,
+  IN VSCSI_REQ  *Req
+  )
+{
+  VirtioScsiReleaseRequest (Dev, Req);
+
+  if (Req->Event != NULL) {
+    gBS->SignalEvent (Req->Event);
+    FreePool (Req);
+  } else {
+    Req->Done = TRUE;
+  }
+}
+
+/**
+
+  Complete a request that the host has returned in the used ring: parse the
+  virtio-scsi response into the request packet, copy the incoming data, and
+  finish the request.
+
+  @param[in] Dev  The virtio-scsi host device the request belongs to.
+
+  @param[in] Req  The request the host has completed.
+
+**/
+STATIC
+VOID
+VirtioScsiCompleteRequest (
+  IN VSCSI_DEV  *Dev,
+  IN VSCSI_REQ  *Req
+  )
+{
+  Req->Status = ParseResponse (Req->Packet, Req->Response);
 
   //
-  // ensured by VirtioScsiInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
+  // If virtio request was successful and it was a CPU read request then we
+  // have used an intermediate buffer. Copy the data from intermediate buffer
+  // to the final buffer.
   //
-  ASSERT (Dev->Ring.QueueSize >= 4);
+  if (Req->InDataBuffer != NULL) {
+    CopyMem (
+      Req->Packet->InDataBuffer,
+      Req->InDataBuffer,
+      Req->Packet->InTransferLength
+      );
+  }
+
+  VirtioScsiFinishRequest (Dev, Req);
+}
+
+/**
+
+  Build the descriptor chain of a request in the descriptor block of its
+  slot, expose the chain in the available ring, and kick the host.
+
+  Unlike VirtioFlush(), this function does not wait for the host to process
+  the request; VirtioScsiProcessUsedRing() reaps it later.
+
+  @param[in] Dev   The virtio-scsi host device to submit the request to.
+
+  @param[in] Req   The request to submit.
+
+  @param[in] Slot  The free slot the request has been assigned to.
+
+  @return  Status codes returned by
+           VIRTIO_DEVICE_PROTOCOL.SetQueueNotify().
+
+**/
+STATIC
+EFI_STATUS
+VirtioScsiKickRequest (
+  IN VSCSI_DEV  *Dev,
+  IN VSCSI_REQ  *Req,
+  IN UINTN      Slot
+  )
+{
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  DESC_INDICES                                Indices;
+  UINT16                                      AvailIdx;
+
+  Packet = Req->Packet;
+
+  //
+  // ensured by VirtioScsiInit() -- every slot owns VSCSI_DESC_PER_REQUEST
+  // descriptors, so we don't have to track free descriptors.
+  //
+  ASSERT (Slot < Dev->NumSlots);
+  Indices.HeadDescIdx = (UINT16)(Slot * VSCSI_DESC_PER_REQUEST);
+  Indices.NextDescIdx = Indices.HeadDescIdx;
 
   //
   // enqueue Request
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof (*Request),
+    Req->RequestDeviceAddress,
+    sizeof (*Req->Request),
     VRING_DESC_F_NEXT,
     &Indices
     );
@@ -621,7 +795,7 @@ VirtioScsiPassThru (
   if (Packet->OutTransferLength > 0) {
     VirtioAppendDesc (
       &Dev->Ring,
-      OutDataDeviceAddress,
+      Req->OutDataDeviceAddress,
       Packet->OutTransferLength,
       VRING_DESC_F_NEXT,
       &Indices
@@ -633,8 +807,8 @@ VirtioScsiPassThru (
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    ResponseDeviceAddress,
-    sizeof *Response,
+    Req->ResponseDeviceAddress,
+    sizeof *Req->Response,
     VRING_DESC_F_WRITE | (Packet->InTransferLength > 0 ? VRING_DESC_F_NEXT : 0),
     &Indices
     );
@@ -645,71 +819,315 @@ VirtioScsiPassThru (
   if (Packet->InTransferLength > 0) {
     VirtioAppendDesc (
       &Dev->Ring,
-      InDataDeviceAddress,
+      Req->InDataDeviceAddress,
       Packet->InTransferLength,
       VRING_DESC_F_WRITE,
       &Indices
       );
   }
 
-  // If kicking the host fails, we must fake a host adapter error.
-  // EFI_NOT_READY would save us the effort, but it would also suggest that the
-  // caller retry.
   //
-  if (VirtioFlush (
-        Dev->VirtIo,
-        VIRTIO_SCSI_REQUEST_QUEUE,
-        &Dev->Ring,
-        &Indices,
-        NULL
-        ) != EFI_SUCCESS)
-  {
-    Status = ReportHostAdapterError (Packet);
-    goto UnmapResponseBuffer;
-  }
-
-  Status = ParseResponse (Packet, Response);
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring, and 2.4.1.3 Updating
+  // the Index Field. The descriptors must be visible to the host before the
+  // available index is bumped.
+  //
+  AvailIdx                                             = *Dev->Ring.Avail.Idx;
+  Dev->Ring.Avail.Ring[AvailIdx % Dev->Ring.QueueSize] = Indices.HeadDescIdx;
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = (UINT16)(AvailIdx + 1);
 
   //
-  // If virtio request was successful and it was a CPU read request then we
-  // have used an intermediate buffer. Copy the data from intermediate buffer
-  // to the final buffer.
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device
   //
-  if (InDataBuffer != NULL) {
-    CopyMem (Packet->InDataBuffer, InDataBuffer, Packet->InTransferLength);
+  MemoryFence ();
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_SCSI_REQUEST_QUEUE);
+}
+
+/**
+
+  Move requests from the pending list to free slots, and submit them to the
+  host. Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+VirtioScsiStartRequests (
+  IN VSCSI_DEV  *Dev
+  )
+{
+  UINTN       Slot;
+  VSCSI_REQ   *Req;
+  EFI_STATUS  Status;
+
+  Slot = 0;
+  while (!IsListEmpty (&Dev->PendingRequests)) {
+    while (Slot < Dev->NumSlots && Dev->InFlight[Slot] != NULL) {
+      Slot++;
+    }
+
+    if (Slot == Dev->NumSlots) {
+      return;
+    }
+
+    Req = CR (
+            GetFirstNode (&Dev->PendingRequests),
+            VSCSI_REQ,
+            Link,
+            VSCSI_REQ_SIG
+            );
+    RemoveEntryList (&Req->Link);
+
+    Dev->InFlight[Slot] = Req;
+    Status              = VirtioScsiKickRequest (Dev, Req, Slot);
+    if (EFI_ERROR (Status)) {
+      //
+      // If kicking the host fails, we must fake a host adapter error.
+      // EFI_NOT_READY would save us the effort, but it would also suggest
+      // that the caller retry.
+      //
+      Dev->InFlight[Slot] = NULL;
+      Req->Status         = ReportHostAdapterError (Req->Packet);
+      VirtioScsiFinishRequest (Dev, Req);
+    }
+  }
+}
+
+/**
+
+  Reap the requests that the host has returned in the used ring since the
+  last call, complete them, and submit pending requests to the slots that
+  have been freed up. Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+VirtioScsiProcessUsedRing (
+  IN VSCSI_DEV  *Dev
+  )
+{
+  UINT16                    UsedIdx;
+  volatile VRING_USED_ELEM  *UsedElem;
+  UINTN                     Slot;
+  VSCSI_REQ                 *Req;
+
+  MemoryFence ();
+  UsedIdx = *Dev->Ring.Used.Idx;
+  MemoryFence ();
+
+  while (Dev->LastUsedIdx != UsedIdx) {
+    UsedElem = &Dev->Ring.Used.UsedElem[Dev->LastUsedIdx % Dev->Ring.QueueSize];
+    Dev->LastUsedIdx++;
+
+    Slot = UsedElem->Id / VSCSI_DESC_PER_REQUEST;
+    ASSERT (Slot < Dev->NumSlots);
+    if ((Slot >= Dev->NumSlots) || (Dev->InFlight[Slot] == NULL)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: unexpected used descriptor %u\n",
+        __func__,
+        UsedElem->Id
+        ));
+      continue;
+    }
+
+    Req                 = Dev->InFlight[Slot];
+    Dev->InFlight[Slot] = NULL;
+    VirtioScsiCompleteRequest (Dev, Req);
   }
 
-UnmapResponseBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, ResponseMapping);
+  VirtioScsiStartRequests (Dev);
+}
+
+/**
+
+  Return whether any request is in flight or pending on a device. Must be
+  called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-scsi host device.
 
-FreeResponseBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *Response),
-                 ResponseBuffer
-                 );
+  @retval TRUE   There are outstanding requests.
+  @retval FALSE  The device is idle.
 
-UnmapOutDataBuffer:
-  if (OutDataBufferIsMapped) {
-    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, OutDataMapping);
+**/
+STATIC
+BOOLEAN
+VirtioScsiIsBusy (
+  IN VSCSI_DEV  *Dev
+  )
+{
+  UINTN  Slot;
+
+  if (!IsListEmpty (&Dev->PendingRequests)) {
+    return TRUE;
   }
 
-UnmapInDataBuffer:
-  if (InDataBuffer != NULL) {
-    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, InDataMapping);
+  for (Slot = 0; Slot < Dev->NumSlots; Slot++) {
+    if (Dev->InFlight[Slot] != NULL) {
+      return TRUE;
+    }
   }
 
-FreeInDataBuffer:
-  if (InDataBuffer != NULL) {
-    Dev->VirtIo->FreeSharedPages (Dev->VirtIo, InDataNumPages, InDataBuffer);
+  return FALSE;
+}
+
+/**
+
+  Periodic timer notification function that reaps completed non-blocking
+  requests. The timer cancels itself once the device has gone idle;
+  VirtioScsiPassThru() re-arms it for the next non-blocking request.
+
+  @param[in] Event    The periodic timer event.
+
+  @param[in] Context  The VSCSI_DEV the timer belongs to.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioScsiAsyncTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  VSCSI_DEV  *Dev;
+
+  Dev = Context;
+  VirtioScsiProcessUsedRing (Dev);
+
+  if (!VirtioScsiIsBusy (Dev)) {
+    gBS->SetTimer (Dev->AsyncTimer, TimerCancel, 0);
+    Dev->AsyncTimerArmed = FALSE;
   }
+}
+
+/**
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
+  Fail every request that is in flight or pending with a host adapter error.
+  This is used when the device is torn down; the caller must have reset the
+  device already, so that the host no longer accesses the request buffers.
 
-FreeScsiRequest:
-  FreePool ((VOID *)Request);
+  @param[in] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+VirtioScsiAbortRequests (
+  IN VSCSI_DEV  *Dev
+  )
+{
+  UINTN      Slot;
+  VSCSI_REQ  *Req;
+
+  for (Slot = 0; Slot < Dev->NumSlots; Slot++) {
+    Req = Dev->InFlight[Slot];
+    if (Req != NULL) {
+      Dev->InFlight[Slot] = NULL;
+      Req->Status         = ReportHostAdapterError (Req->Packet);
+      VirtioScsiFinishRequest (Dev, Req);
+    }
+  }
 
+  while (!IsListEmpty (&Dev->PendingRequests)) {
+    Req = CR (
+            GetFirstNode (&Dev->PendingRequests),
+            VSCSI_REQ,
+            Link,
+            VSCSI_REQ_SIG
+            );
+    RemoveEntryList (&Req->Link);
+    Req->Status = ReportHostAdapterError (Req->Packet);
+    VirtioScsiFinishRequest (Dev, Req);
+  }
+}
+
+//
+// The next seven functions implement EFI_EXT_SCSI_PASS_THRU_PROTOCOL
+// for the virtio-scsi HBA. Refer to UEFI Spec 2.3.1 + Errata C, sections
+// - 14.1 SCSI Driver Model Overview,
+// - 14.7 Extended SCSI Pass Thru Protocol.
+//
+
+EFI_STATUS
+EFIAPI
+VirtioScsiPassThru (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
+  IN     UINT8                                       *Target,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event   OPTIONAL
+  )
+{
+  VSCSI_DEV   *Dev;
+  UINT16      TargetValue;
+  EFI_STATUS  Status;
+  VSCSI_REQ   *Req;
+  EFI_TPL     OldTpl;
+  BOOLEAN     Done;
+  UINTN       PollPeriodUsecs;
+
+  Dev = VIRTIO_SCSI_FROM_PASS_THRU (This);
+  CopyMem (&TargetValue, Target, sizeof TargetValue);
+
+  Status = VirtioScsiPrepareRequest (Dev, TargetValue, Lun, Packet, Event, &Req);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Requests that don't find a free slot wait in the pending list; they are
+  // submitted as soon as earlier requests complete.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertTailList (&Dev->PendingRequests, &Req->Link);
+  VirtioScsiStartRequests (Dev);
+
+  if (Event != NULL) {
+    //
+    // Non-blocking request: the periodic timer reaps it and signals Event.
+    //
+    if (!Dev->AsyncTimerArmed) {
+      Status = gBS->SetTimer (
+                      Dev->AsyncTimer,
+                      TimerPeriodic,
+                      VSCSI_ASYNC_POLL_PERIOD
+                      );
+      ASSERT_EFI_ERROR (Status);
+      Dev->AsyncTimerArmed = TRUE;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+    return EFI_SUCCESS;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  //
+  // Blocking request: poll the used ring, backing off exponentially like
+  // VirtioFlush() does. Other requests completed meanwhile are reaped too.
+  //
+  PollPeriodUsecs = 1;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioScsiProcessUsedRing (Dev);
+    Done = Req->Done;
+    gBS->RestoreTPL (OldTpl);
+
+    if (Done) {
+      break;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+
+  Status = Req->Status;
+  FreePool (Req);
   return Status;
 }
 
@@ -1063,9 +1481,9 @@ VirtioScsiInit (
   }
 
   //
-  // VirtioScsiPassThru() uses at most four descriptors
+  // Each request uses at most four descriptors
   //
-  if (QueueSize < 4) {
+  if (QueueSize < VSCSI_DESC_PER_REQUEST) {
     Status = EFI_UNSUPPORTED;
     goto Failed;
   }
@@ -1139,13 +1557,40 @@ VirtioScsiInit (
     goto UnmapQueue;
   }
 
+  //
+  // Set up request tracking. Each slot owns a fixed block of descriptors, see
+  // VirtioScsiKickRequest(). We reap completions by polling, so ask the host
+  // not to interrupt us.
+  //
+  Dev->NumSlots = (UINT16)MIN (
+                            QueueSize / VSCSI_DESC_PER_REQUEST,
+                            VSCSI_MAX_IN_FLIGHT
+                            );
+  Dev->LastUsedIdx = 0;
+  ZeroMem (Dev->InFlight, sizeof Dev->InFlight);
+  InitializeListHead (&Dev->PendingRequests);
+  *Dev->Ring.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  VirtioScsiAsyncTimer,
+                  Dev,
+                  &Dev->AsyncTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  Dev->AsyncTimerArmed = FALSE;
+
   //
   // step 6 -- initialization complete
   //
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto CloseAsyncTimer;
   }
 
   //
@@ -1171,8 +1616,11 @@ VirtioScsiInit (
   // Driver Writer's Guide for UEFI 2.3.1 v1.01, 20.1.5 Implementing Extended
   // SCSI Pass Thru Protocol.
   //
+  // Non-blocking requests are supported too.
+  //
   Dev->PassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL |
-                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL;
+                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL |
+                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
 
   //
   // no restriction on transfer buffer alignment
@@ -1181,6 +1629,9 @@ VirtioScsiInit (
 
   return EFI_SUCCESS;
 
+CloseAsyncTimer:
+  gBS->CloseEvent (Dev->AsyncTimer);
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -1215,8 +1666,14 @@ VirtioScsiUninit (
   // VIRTIO_CFG_WRITE() returns, the host will have learned to stay away from
   // the old comms area.
   //
+  gBS->CloseEvent (Dev->AsyncTimer);
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
+  //
+  // The host has forgotten about the ring; fail whatever it hasn't completed.
+  //
+  VirtioScsiAbortRequests (Dev);
+
   Dev->InOutSupported = FALSE;
   Dev->MaxTarget      = 0;
   Dev->MaxLun         = 0;
@@ -17,6 +17,7 @@
 #include <Protocol/ScsiPassThruExt.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioScsi.h>
 
 //
 // This driver supports 2-byte target identifiers and 4-byte LUN identifiers.
@@ -34,6 +35,53 @@
 
 #define VSCSI_SIG  SIGNATURE_32 ('V', 'S', 'C', 'S')
 
+//
+// Every request in flight owns a fixed block of descriptors in the request
+// virtqueue: request header, "dataout", response header, "datain". The block
+// of the request in slot N starts at descriptor N * VSCSI_DESC_PER_REQUEST, so
+// the head descriptor index reported in the used ring identifies the slot.
+//
+#define VSCSI_DESC_PER_REQUEST  4
+#define VSCSI_MAX_IN_FLIGHT     32
+
+//
+// Period of the timer that reaps completed non-blocking requests, in 100ns
+// units.
+//
+#define VSCSI_ASYNC_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+#define VSCSI_REQ_SIG  SIGNATURE_32 ('V', 'S', 'R', 'Q')
+
+//
+// Tracks one EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru() request from its
+// submission until the host has completed it.
+//
+typedef struct {
+  UINT32                                        Signature;
+  LIST_ENTRY                                    Link;        // VSCSI_DEV.PendingRequests
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  EFI_EVENT                                     Event;       // NULL for blocking requests
+  EFI_STATUS                                    Status;      // blocking requests only
+  BOOLEAN                                       Done;        // blocking requests only
+
+  volatile VIRTIO_SCSI_REQ                      *Request;
+  VOID                                          *RequestMapping;
+  EFI_PHYSICAL_ADDRESS                          RequestDeviceAddress;
+
+  volatile VIRTIO_SCSI_RESP                     *Response;
+  VOID                                          *ResponseMapping;
+  EFI_PHYSICAL_ADDRESS                          ResponseDeviceAddress;
+
+  VOID                                          *InDataBuffer;
+  UINTN                                         InDataNumPages;
+  VOID                                          *InDataMapping;
+  EFI_PHYSICAL_ADDRESS                          InDataDeviceAddress;
+
+  BOOLEAN                                       OutDataBufferIsMapped;
+  VOID                                          *OutDataMapping;
+  EFI_PHYSICAL_ADDRESS                          OutDataDeviceAddress;
+} VSCSI_REQ;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -53,6 +101,13 @@ typedef struct {
   EFI_EXT_SCSI_PASS_THRU_PROTOCOL    PassThru;       // VirtioScsiInit      1
   EFI_EXT_SCSI_PASS_THRU_MODE        PassThruMode;   // VirtioScsiInit      1
   VOID                               *RingMap;       // VirtioRingMap       2
+  UINT16                             NumSlots;       // VirtioScsiInit      1
+  UINT16                             LastUsedIdx;    // VirtioScsiInit      1
+  VSCSI_REQ                          *InFlight[VSCSI_MAX_IN_FLIGHT];
+                                                     // VirtioScsiInit      1
+  LIST_ENTRY                         PendingRequests;// VirtioScsiInit      1
+  EFI_EVENT                          AsyncTimer;     // VirtioScsiInit      1
+  BOOLEAN                            AsyncTimerArmed;// VirtioScsiInit      1
 } VSCSI_DEV;
 
 #define VIRTIO_SCSI_FROM_PASS_THRU(PassThruPointer) \
@@ -0,0 +1,72 @@
+/** @file
+  Hashing of the FVs copied to permanent memory by FvReportPei.
+
+  Verified boot time is dominated by hashing the FVs. The FV digests don't
+  depend on each other, so they are computed in one batch, which BaseCryptLib
+  spreads over the enabled processors where it can.
+
+  The processors are started by the BaseCryptLib instance that computes the
+  digests, never by this PEIM. A hash function reached through
+  BaseCryptLibOnProtocolPpi looks up the Crypto PPI with the PEI services on
+  every call, which is only allowed on the BSP, so it must not be called from
+  an AP. The batch call crosses into the crypto provider on the BSP, and the
+  provider only hands its own, AP-safe, hash functions to the APs.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "FvReportPei.h"
+
+/**
+  Hash all the FVs of the job list.
+
+  The FVs are hashed as one batch first. Those the batch did not hash, e.g.
+  all of them when the BaseCryptLib instance does not support batches, are
+  then hashed one after the other on the BSP.
+
+  @param[in, out]  JobList   FVs to hash. The Hashed and Digest members of
+                             every job are set.
+**/
+VOID
+HashFvJobList (
+  IN OUT FV_HASH_JOB_LIST  *JobList
+  )
+{
+  CONST HASH_ALG_INFO  *AlgInfo;
+  CRYPTO_HASH_REQUEST  *Requests;
+  FV_HASH_JOB          *Job;
+  UINT32               Index;
+
+  if (JobList->JobCount == 0) {
+    return;
+  }
+
+  AlgInfo  = JobList->AlgInfo;
+  Requests = AllocateZeroPool (sizeof (CRYPTO_HASH_REQUEST) * JobList->JobCount);
+  if (Requests != NULL) {
+    for (Index = 0; Index < JobList->JobCount; ++Index) {
+      Job                       = &JobList->Jobs[Index];
+      Requests[Index].Data      = Job->FvBuffer;
+      Requests[Index].DataSize  = Job->FvLength;
+      Requests[Index].HashValue = Job->Digest;
+    }
+
+    if (!AlgInfo->HashAllBatch (Requests, JobList->JobCount)) {
+      DEBUG ((DEBUG_INFO, "Hash the remaining FVs on BSP only\r\n"));
+    }
+  }
+
+  for (Index = 0; Index < JobList->JobCount; ++Index) {
+    Job         = &JobList->Jobs[Index];
+    Job->Hashed = (BOOLEAN)((Requests != NULL) && Requests[Index].Result);
+    if (!Job->Hashed) {
+      Job->Hashed = AlgInfo->HashAll (Job->FvBuffer, Job->FvLength, Job->Digest);
+    }
+  }
+
+  if (Requests != NULL) {
+    FreePool (Requests);
+  }
+}
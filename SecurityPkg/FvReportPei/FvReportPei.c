@@ -9,9 +9,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "FvReportPei.h"
 
 STATIC CONST HASH_ALG_INFO  mHashAlgInfo[] = {
-  { TPM_ALG_SHA256, SHA256_DIGEST_SIZE, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll }, // 000B
-  { TPM_ALG_SHA384, SHA384_DIGEST_SIZE, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll }, // 000C
-  { TPM_ALG_SHA512, SHA512_DIGEST_SIZE, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll }, // 000D
+  { TPM_ALG_SHA256, SHA256_DIGEST_SIZE, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll, Sha256HashAllBatch }, // 000B
+  { TPM_ALG_SHA384, SHA384_DIGEST_SIZE, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll, Sha384HashAllBatch }, // 000C
+  { TPM_ALG_SHA512, SHA512_DIGEST_SIZE, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll, Sha512HashAllBatch }, // 000D
 };
 
 /**
@@ -121,6 +121,9 @@ VerifyHashedFv (
   VOID                                  *FvBuffer;
   EDKII_PEI_FIRMWARE_VOLUME_SHADOW_PPI  *FvShadowPpi;
   EFI_STATUS                            Status;
+  FV_HASH_JOB_LIST                      JobList;
+  FV_HASH_JOB                           *Job;
+  UINT32                                JobIndex;
 
   if ((HashInfo == NULL) ||
       (HashInfo->HashSize == 0) ||
@@ -150,6 +153,11 @@ VerifyHashedFv (
   HashValue = AllocateZeroPool (AlgInfo->HashSize * (FvNumber + 1));
   ASSERT (HashValue != NULL);
 
+  JobList.AlgInfo  = AlgInfo;
+  JobList.Jobs     = AllocateZeroPool (sizeof (FV_HASH_JOB) * FvNumber);
+  JobList.JobCount = 0;
+  ASSERT (JobList.Jobs != NULL);
+
   Status = PeiServicesLocatePpi (
              &gEdkiiPeiFirmwareVolumeShadowPpiGuid,
              0,
@@ -161,9 +169,8 @@ VerifyHashedFv (
   }
 
   //
-  // Calculate hash value for each FV first.
+  // Copy every FV to be hashed to permanent memory first.
   //
-  FvHashValue = HashValue;
   for (FvIndex = 0; FvIndex < FvNumber; ++FvIndex) {
     //
     // Not meant for verified boot and/or measured boot?
@@ -221,7 +228,22 @@ VerifyHashedFv (
         );
     }
 
-    if (!AlgInfo->HashAll (FvBuffer, (UINTN)FvInfo[FvIndex].Length, FvHashValue)) {
+    Job           = &JobList.Jobs[JobList.JobCount++];
+    Job->FvIndex  = FvIndex;
+    Job->FvBuffer = FvBuffer;
+    Job->FvLength = (UINTN)FvInfo[FvIndex].Length;
+  }
+
+  //
+  // Calculate hash value for each FV, in parallel if possible.
+  //
+  HashFvJobList (&JobList);
+
+  FvHashValue = HashValue;
+  for (JobIndex = 0; JobIndex < JobList.JobCount; ++JobIndex) {
+    Job     = &JobList.Jobs[JobIndex];
+    FvIndex = Job->FvIndex;
+    if (!Job->Hashed) {
       Status = EFI_ABORTED;
       goto Done;
     }
@@ -231,11 +253,11 @@ VerifyHashedFv (
     //
     if ((FvInfo[FvIndex].Flag & HASHED_FV_FLAG_MEASURED_BOOT) != 0) {
       InstallPreHashFvPpi (
-        FvBuffer,
-        (UINTN)FvInfo[FvIndex].Length,
+        Job->FvBuffer,
+        Job->FvLength,
         HashInfo->HashAlgoId,
         HashInfo->HashSize,
-        FvHashValue
+        Job->Digest
         );
     }
 
@@ -243,13 +265,14 @@ VerifyHashedFv (
     // Don't keep the hash value of current FV if we don't need to verify it.
     //
     if ((FvInfo[FvIndex].Flag & HASHED_FV_FLAG_VERIFIED_BOOT) != 0) {
+      CopyMem (FvHashValue, Job->Digest, AlgInfo->HashSize);
       FvHashValue += AlgInfo->HashSize;
     }
 
     //
     // Use memory copy of the FV from now on.
     //
-    FvInfo[FvIndex].Base = (UINT64)(UINTN)FvBuffer;
+    FvInfo[FvIndex].Base = (UINT64)(UINTN)Job->FvBuffer;
   }
 
   //
@@ -265,6 +288,7 @@ VerifyHashedFv (
   }
 
 Done:
+  FreePool (JobList.Jobs);
   FreePool (HashValue);
   return Status;
 }
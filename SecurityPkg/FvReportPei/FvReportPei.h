@@ -55,6 +55,29 @@ BOOLEAN
   OUT  UINT8       *HashValue
   );
 
+/**
+  Computes the message digest of each data buffer in a batch.
+
+  The digests may be computed on several processors. Each entry reports in
+  its Result member whether its digest was computed.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Requests      Array of hash requests.
+  @param[in]       RequestCount  Number of entries in Requests.
+
+  @retval TRUE   All digest computations succeeded.
+  @retval FALSE  At least one digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *HASH_ALL_BATCH_METHOD)(
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  );
+
 /**
   Initializes user-supplied memory as hash context for subsequent use.
 
@@ -111,12 +134,42 @@ BOOLEAN
   );
 
 typedef struct {
-  UINT16                HashAlgId;
-  UINTN                 HashSize;
-  HASH_INIT_METHOD      HashInit;
-  HASH_UPDATE_METHOD    HashUpdate;
-  HASH_FINAL_METHOD     HashFinal;
-  HASH_ALL_METHOD       HashAll;
+  UINT16                   HashAlgId;
+  UINTN                    HashSize;
+  HASH_INIT_METHOD         HashInit;
+  HASH_UPDATE_METHOD       HashUpdate;
+  HASH_FINAL_METHOD        HashFinal;
+  HASH_ALL_METHOD          HashAll;
+  HASH_ALL_BATCH_METHOD    HashAllBatch;
 } HASH_ALG_INFO;
 
+//
+// One FV copied to permanent memory and waiting to be hashed. The copies are
+// hashed independently of each other, possibly on different processors.
+//
+typedef struct {
+  UINTN      FvIndex;
+  VOID       *FvBuffer;
+  UINTN      FvLength;
+  BOOLEAN    Hashed;
+  UINT8      Digest[SHA512_DIGEST_SIZE];
+} FV_HASH_JOB;
+
+typedef struct {
+  CONST HASH_ALG_INFO    *AlgInfo;
+  FV_HASH_JOB            *Jobs;
+  UINT32                 JobCount;
+} FV_HASH_JOB_LIST;
+
+/**
+  Hash all the FVs of the job list.
+
+  @param[in, out]  JobList   FVs to hash. The Hashed and Digest members of
+                             every job are set.
+**/
+VOID
+HashFvJobList (
+  IN OUT FV_HASH_JOB_LIST  *JobList
+  );
+
 #endif //__FV_REPORT_PEI_H__
@@ -0,0 +1,263 @@
+/** @file
+  Tests for HashFvJobList() of FvReportPei.
+
+  The FVs are hashed as one batch with BaseCryptLib, which may spread them
+  over the processors. The tests check that every FV gets the digest of its
+  own buffer, and that the FVs the batch did not hash are hashed one by one
+  instead.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <vector>
+
+extern "C" {
+  #include "../FvReportPei.h"
+}
+
+using namespace testing;
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_FV_COUNT  9
+
+/////////////////////////////////////////////////////////////////////////
+// Fake hash functions
+///////////////////////////////////////////////////////////////////////
+
+static UINTN               mHashAllCalls;
+static UINTN               mBatchCalls;
+static BOOLEAN             mBatchSupported;
+static std::vector<UINTN>  mBatchFailures;
+static std::vector<UINTN>  mHashAllFailures;
+
+/**
+  Writes a digest made of the size and the first byte of the data.
+**/
+static
+VOID
+FakeDigest (
+  IN  CONST VOID  *Data,
+  IN  UINTN       DataSize,
+  OUT UINT8       *HashValue
+  )
+{
+  ZeroMem (HashValue, SHA256_DIGEST_SIZE);
+  CopyMem (HashValue, &DataSize, sizeof (DataSize));
+  HashValue[sizeof (DataSize)] = *(CONST UINT8 *)Data;
+}
+
+static
+BOOLEAN
+EFIAPI
+FakeHashAll (
+  IN   CONST VOID  *Data,
+  IN   UINTN       DataSize,
+  OUT  UINT8       *HashValue
+  )
+{
+  mHashAllCalls++;
+  for (UINTN Failure : mHashAllFailures) {
+    if (Failure == DataSize) {
+      return FALSE;
+    }
+  }
+
+  FakeDigest (Data, DataSize, HashValue);
+  return TRUE;
+}
+
+static
+BOOLEAN
+EFIAPI
+FakeHashAllBatch (
+  IN OUT  CRYPTO_HASH_REQUEST  *Requests,
+  IN      UINTN                RequestCount
+  )
+{
+  BOOLEAN  Status;
+  UINTN    Index;
+
+  mBatchCalls++;
+  if (!mBatchSupported) {
+    return FALSE;
+  }
+
+  Status = TRUE;
+  for (Index = 0; Index < RequestCount; Index++) {
+    Requests[Index].Result = TRUE;
+    for (UINTN Failure : mBatchFailures) {
+      if (Failure == Index) {
+        Requests[Index].Result = FALSE;
+        Status                 = FALSE;
+      }
+    }
+
+    if (Requests[Index].Result) {
+      FakeDigest (Requests[Index].Data, Requests[Index].DataSize, Requests[Index].HashValue);
+    }
+  }
+
+  return Status;
+}
+
+STATIC CONST HASH_ALG_INFO  mFakeAlgInfo = {
+  TPM_ALG_SHA256, SHA256_DIGEST_SIZE, NULL, NULL, NULL, FakeHashAll, FakeHashAllBatch
+};
+
+STATIC CONST HASH_ALG_INFO  mSha256AlgInfo = {
+  TPM_ALG_SHA256, SHA256_DIGEST_SIZE, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll, Sha256HashAllBatch
+};
+
+class HashFvJobListTest : public Test {
+protected:
+  std::vector<std::vector<UINT8> >  Fvs;
+  std::vector<FV_HASH_JOB>          Jobs;
+  FV_HASH_JOB_LIST                  JobList;
+
+  void
+  SetUp (
+    ) override
+  {
+    mHashAllCalls   = 0;
+    mBatchCalls     = 0;
+    mBatchSupported = TRUE;
+    mBatchFailures.clear ();
+    mHashAllFailures.clear ();
+  }
+
+  //
+  // Build FvCount FVs of different sizes and contents, FV Index being
+  // Index + 1 pages long and filled with Index.
+  //
+  void
+  Init (
+    CONST HASH_ALG_INFO  *AlgInfo,
+    UINTN                FvCount
+    )
+  {
+    UINTN  Index;
+
+    Fvs.resize (FvCount);
+    Jobs.resize (FvCount);
+    for (Index = 0; Index < FvCount; Index++) {
+      Fvs[Index].assign ((Index + 1) * EFI_PAGE_SIZE, (UINT8)Index);
+      ZeroMem (&Jobs[Index], sizeof (Jobs[Index]));
+      Jobs[Index].FvIndex  = Index;
+      Jobs[Index].FvBuffer = Fvs[Index].data ();
+      Jobs[Index].FvLength = Fvs[Index].size ();
+    }
+
+    JobList.AlgInfo  = AlgInfo;
+    JobList.Jobs     = Jobs.data ();
+    JobList.JobCount = (UINT32)FvCount;
+  }
+
+  void
+  ExpectFvHashed (
+    UINTN  Index
+    )
+  {
+    UINT8  Digest[SHA256_DIGEST_SIZE];
+
+    EXPECT_TRUE (Jobs[Index].Hashed) << "FV " << Index;
+    if (JobList.AlgInfo == &mFakeAlgInfo) {
+      FakeDigest (Fvs[Index].data (), Fvs[Index].size (), Digest);
+    } else {
+      ASSERT_TRUE (Sha256HashAll (Fvs[Index].data (), Fvs[Index].size (), Digest));
+    }
+
+    EXPECT_EQ (CompareMem (Jobs[Index].Digest, Digest, sizeof (Digest)), 0) << "FV " << Index;
+  }
+};
+
+TEST_F (HashFvJobListTest, NoFv) {
+  Init (&mFakeAlgInfo, 0);
+
+  HashFvJobList (&JobList);
+  EXPECT_EQ (mBatchCalls, 0U);
+  EXPECT_EQ (mHashAllCalls, 0U);
+}
+
+TEST_F (HashFvJobListTest, AllFvsAreHashedInOneBatch) {
+  UINTN  Index;
+
+  Init (&mFakeAlgInfo, TEST_FV_COUNT);
+
+  HashFvJobList (&JobList);
+  EXPECT_EQ (mBatchCalls, 1U);
+  EXPECT_EQ (mHashAllCalls, 0U);
+  for (Index = 0; Index < TEST_FV_COUNT; Index++) {
+    ExpectFvHashed (Index);
+  }
+}
+
+TEST_F (HashFvJobListTest, UnsupportedBatchFallsBackToBsp) {
+  UINTN  Index;
+
+  Init (&mFakeAlgInfo, TEST_FV_COUNT);
+  mBatchSupported = FALSE;
+
+  HashFvJobList (&JobList);
+  EXPECT_EQ (mBatchCalls, 1U);
+  EXPECT_EQ (mHashAllCalls, (UINTN)TEST_FV_COUNT);
+  for (Index = 0; Index < TEST_FV_COUNT; Index++) {
+    ExpectFvHashed (Index);
+  }
+}
+
+TEST_F (HashFvJobListTest, FailedBatchEntriesAreHashedAgain) {
+  UINTN  Index;
+
+  Init (&mFakeAlgInfo, TEST_FV_COUNT);
+  mBatchFailures = { 0, 4, TEST_FV_COUNT - 1 };
+
+  HashFvJobList (&JobList);
+  EXPECT_EQ (mHashAllCalls, mBatchFailures.size ());
+  for (Index = 0; Index < TEST_FV_COUNT; Index++) {
+    ExpectFvHashed (Index);
+  }
+}
+
+TEST_F (HashFvJobListTest, FvFailingTwiceIsNotHashed) {
+  UINTN  Index;
+
+  Init (&mFakeAlgInfo, TEST_FV_COUNT);
+  mBatchFailures   = { 3 };
+  mHashAllFailures = { Fvs[3].size () };
+
+  HashFvJobList (&JobList);
+  EXPECT_FALSE (Jobs[3].Hashed);
+  for (Index = 0; Index < TEST_FV_COUNT; Index++) {
+    if (Index != 3) {
+      ExpectFvHashed (Index);
+    }
+  }
+}
+
+TEST_F (HashFvJobListTest, BaseCryptLibBatchMatchesHashAll) {
+  UINTN  Index;
+
+  //
+  // Large enough for BaseCryptLib to dispatch the batch.
+  //
+  Init (&mSha256AlgInfo, 4 * TEST_FV_COUNT);
+
+  HashFvJobList (&JobList);
+  for (Index = 0; Index < Jobs.size (); Index++) {
+    ExpectFvHashed (Index);
+  }
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
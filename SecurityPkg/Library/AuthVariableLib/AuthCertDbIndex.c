@@ -0,0 +1,410 @@
+/** @file
+  Index of the signer's certificate databases "certdb" and "certdbv".
+
+  Each private authenticated variable write looks up its AUTH_CERT_DB_DATA in
+  one of the databases. Parsing the database for every lookup makes such a
+  write slower with each private authenticated variable that exists, so a
+  hash table from VendorGuid and VariableName to the offset of the node is
+  kept for each database. A table is built the first time its database is
+  searched and then follows every change this library makes to the database.
+  The database variables remain the only persistent copy.
+
+  Caution: This module requires additional review when modified.
+  This driver will have external input - variable data. It may be input in SMM mode.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "AuthServiceInternal.h"
+
+//
+// NodeOffset of an empty slot. CertDbListSize is at offset 0, so no
+// AUTH_CERT_DB_DATA starts there.
+//
+#define CERT_DB_INDEX_EMPTY_SLOT  0
+
+AUTH_CERT_DB_INDEX  mCertDbIndex;
+AUTH_CERT_DB_INDEX  mCertDbVolatileIndex;
+
+/**
+  Hash the VendorGuid and VariableName of a certificate database node.
+
+  @param[in]  VendorGuid    Vendor GUID, which may be unaligned.
+  @param[in]  VariableName  Variable name without terminator, which may be unaligned.
+  @param[in]  NameSize      Length of VariableName in CHAR16s.
+
+  @return  The 32-bit FNV-1a hash of the GUID and name bytes.
+**/
+STATIC
+UINT32
+CertDbIndexHash (
+  IN CONST VOID  *VendorGuid,
+  IN CONST VOID  *VariableName,
+  IN UINT32      NameSize
+  )
+{
+  CONST UINT8  *Bytes;
+  UINTN        Index;
+  UINT32       Hash;
+
+  Hash  = 0x811C9DC5;
+  Bytes = VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  Bytes = VariableName;
+  for (Index = 0; Index < NameSize * sizeof (CHAR16); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Add a node to the hash table of a certificate database index.
+
+  @param[in, out]  Index       Certificate database index.
+  @param[in]       Hash        Hash of VendorGuid and VariableName of the node.
+  @param[in]       NodeOffset  Offset of the AUTH_CERT_DB_DATA in the database.
+
+  @retval TRUE   The node was added.
+  @retval FALSE  The hash table is full.
+**/
+STATIC
+BOOLEAN
+CertDbIndexAdd (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     UINT32              Hash,
+  IN     UINT32              NodeOffset
+  )
+{
+  UINT32  Slot;
+
+  //
+  // Keep the load factor at or below 3/4 so probe sequences stay short.
+  //
+  if ((UINT64)(Index->NodeCount + 1) * 4 > (UINT64)Index->SlotCount * 3) {
+    return FALSE;
+  }
+
+  Slot = Hash & (Index->SlotCount - 1);
+  while (Index->Slots[Slot].NodeOffset != CERT_DB_INDEX_EMPTY_SLOT) {
+    Slot = (Slot + 1) & (Index->SlotCount - 1);
+  }
+
+  Index->Slots[Slot].Hash       = Hash;
+  Index->Slots[Slot].NodeOffset = NodeOffset;
+  Index->NodeCount++;
+  return TRUE;
+}
+
+/**
+  Build the index of a certificate database.
+
+  @param[in, out]  Index     Certificate database index.
+  @param[in]       Data      Pointer to variable "certdb" or "certdbv".
+  @param[in]       DataSize  Size of variable "certdb" or "certdbv".
+
+  @retval EFI_SUCCESS    The index describes the database.
+  @retval EFI_NOT_READY  The database is malformed or has too many nodes to be
+                         indexed.
+**/
+STATIC
+EFI_STATUS
+CertDbIndexBuild (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     UINT8               *Data,
+  IN     UINTN               DataSize
+  )
+{
+  AUTH_CERT_DB_DATA  *Ptr;
+  UINT32             Offset;
+  UINT32             NodeSize;
+  UINT32             NameSize;
+  UINT32             CertSize;
+
+  CertDbIndexInvalidate (Index);
+  if (Index->Slots == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  if ((DataSize < sizeof (UINT32)) || (DataSize > MAX_UINT32) ||
+      (ReadUnaligned32 ((UINT32 *)Data) != (UINT32)DataSize))
+  {
+    return EFI_NOT_READY;
+  }
+
+  Offset = sizeof (UINT32);
+  while (Offset < (UINT32)DataSize) {
+    if ((UINT32)DataSize - Offset < sizeof (AUTH_CERT_DB_DATA)) {
+      CertDbIndexInvalidate (Index);
+      return EFI_NOT_READY;
+    }
+
+    Ptr      = (AUTH_CERT_DB_DATA *)(Data + Offset);
+    NodeSize = ReadUnaligned32 (&Ptr->CertNodeSize);
+    NameSize = ReadUnaligned32 (&Ptr->NameSize);
+    CertSize = ReadUnaligned32 (&Ptr->CertDataSize);
+    if ((NodeSize > (UINT32)DataSize - Offset) ||
+        ((UINT64)NodeSize != sizeof (AUTH_CERT_DB_DATA) + (UINT64)NameSize * sizeof (CHAR16) + CertSize))
+    {
+      CertDbIndexInvalidate (Index);
+      return EFI_NOT_READY;
+    }
+
+    if (!CertDbIndexAdd (Index, CertDbIndexHash (&Ptr->VendorGuid, Ptr + 1, NameSize), Offset)) {
+      CertDbIndexInvalidate (Index);
+      return EFI_NOT_READY;
+    }
+
+    Offset += NodeSize;
+  }
+
+  Index->DbSize = (UINT32)DataSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Allocate the hash tables of the certificate database indexes.
+
+  The tables are sized for the largest database mMaxCertDbSize allows, so
+  they never have to grow at runtime.
+
+  @retval EFI_SUCCESS           The hash tables were allocated.
+  @retval EFI_OUT_OF_RESOURCES  Fail to allocate the hash tables.
+**/
+EFI_STATUS
+CertDbIndexInitialize (
+  VOID
+  )
+{
+  UINT32  MaxNodeCount;
+  UINT32  SlotCount;
+
+  //
+  // The smallest node has a one-character name and a SHA-256 digest.
+  //
+  MaxNodeCount = mMaxCertDbSize / (sizeof (AUTH_CERT_DB_DATA) + sizeof (CHAR16) + SHA256_DIGEST_SIZE);
+  SlotCount    = (UINT32)GetPowerOfTwo32 (MaxNodeCount * 4 / 3 + 1) * 2;
+
+  mCertDbIndex.Slots         = AllocateRuntimeZeroPool (SlotCount * sizeof (AUTH_CERT_DB_INDEX_SLOT));
+  mCertDbVolatileIndex.Slots = AllocateRuntimeZeroPool (SlotCount * sizeof (AUTH_CERT_DB_INDEX_SLOT));
+  if ((mCertDbIndex.Slots == NULL) || (mCertDbVolatileIndex.Slots == NULL)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mCertDbIndex.SlotCount         = SlotCount;
+  mCertDbVolatileIndex.SlotCount = SlotCount;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the index of the certificate database used by an authenticated variable.
+
+  @param[in]  Attributes  Attributes of authenticated variable.
+
+  @return  Index of "certdb" for a non-volatile variable, or of "certdbv".
+**/
+AUTH_CERT_DB_INDEX *
+GetCertDbIndex (
+  IN UINT32  Attributes
+  )
+{
+  if ((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0) {
+    return &mCertDbIndex;
+  }
+
+  return &mCertDbVolatileIndex;
+}
+
+/**
+  Forget the content of a certificate database index, so that it is rebuilt
+  the next time the database is searched.
+
+  @param[in, out]  Index  Certificate database index.
+**/
+VOID
+CertDbIndexInvalidate (
+  IN OUT AUTH_CERT_DB_INDEX  *Index
+  )
+{
+  if (Index->Slots != NULL) {
+    ZeroMem (Index->Slots, Index->SlotCount * sizeof (AUTH_CERT_DB_INDEX_SLOT));
+  }
+
+  Index->NodeCount = 0;
+  Index->DbSize    = 0;
+}
+
+/**
+  Find the signer's certificates of an authenticated variable in a
+  certificate database through its index.
+
+  The index is rebuilt first if it does not describe the database.
+
+  @param[in, out]  Index           Certificate database index.
+  @param[in]       VariableName    Name of authenticated Variable.
+  @param[in]       VendorGuid      Vendor GUID of authenticated Variable.
+  @param[in]       Data            Pointer to variable "certdb" or "certdbv".
+  @param[in]       DataSize        Size of variable "certdb" or "certdbv".
+  @param[out]      CertNodeOffset  Offset of matching AUTH_CERT_DB_DATA, from
+                                   starting of Data.
+
+  @retval EFI_SUCCESS    Found the matching AUTH_CERT_DB_DATA.
+  @retval EFI_NOT_FOUND  The database has no matching AUTH_CERT_DB_DATA.
+  @retval EFI_NOT_READY  The database can't be indexed, the caller has to
+                         parse it.
+**/
+EFI_STATUS
+CertDbIndexFind (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     CHAR16              *VariableName,
+  IN     EFI_GUID            *VendorGuid,
+  IN     UINT8               *Data,
+  IN     UINTN               DataSize,
+  OUT    UINT32              *CertNodeOffset
+  )
+{
+  EFI_STATUS         Status;
+  AUTH_CERT_DB_DATA  *Ptr;
+  UINT32             NodeOffset;
+  UINT32             NameSize;
+  UINT32             Hash;
+  UINT32             Slot;
+
+  if ((Index->DbSize == 0) || (Index->DbSize != DataSize)) {
+    Status = CertDbIndexBuild (Index, Data, DataSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  NameSize = (UINT32)StrLen (VariableName);
+  Hash     = CertDbIndexHash (VendorGuid, VariableName, NameSize);
+  Slot     = Hash & (Index->SlotCount - 1);
+  while (Index->Slots[Slot].NodeOffset != CERT_DB_INDEX_EMPTY_SLOT) {
+    NodeOffset = Index->Slots[Slot].NodeOffset;
+    if ((Index->Slots[Slot].Hash == Hash) &&
+        ((UINT64)NodeOffset + sizeof (AUTH_CERT_DB_DATA) + (UINT64)NameSize * sizeof (CHAR16) <= DataSize))
+    {
+      Ptr = (AUTH_CERT_DB_DATA *)(Data + NodeOffset);
+      if (CompareGuid (&Ptr->VendorGuid, VendorGuid) &&
+          (ReadUnaligned32 (&Ptr->NameSize) == NameSize) &&
+          (CompareMem (Ptr + 1, VariableName, NameSize * sizeof (CHAR16)) == 0))
+      {
+        *CertNodeOffset = NodeOffset;
+        return EFI_SUCCESS;
+      }
+    }
+
+    Slot = (Slot + 1) & (Index->SlotCount - 1);
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Record a node appended to a certificate database.
+
+  @param[in, out]  Index       Certificate database index.
+  @param[in]       OldDbSize   Size of the database before the node was appended.
+  @param[in]       NewCertDb   Pointer to the new database content.
+  @param[in]       NewDbSize   Size of the new database.
+**/
+VOID
+CertDbIndexInsert (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     UINT32              OldDbSize,
+  IN     UINT8               *NewCertDb,
+  IN     UINT32              NewDbSize
+  )
+{
+  AUTH_CERT_DB_DATA  *Ptr;
+
+  if ((Index->DbSize == 0) || (Index->DbSize != OldDbSize)) {
+    //
+    // Not built yet, or out of date. The next search rebuilds it.
+    //
+    CertDbIndexInvalidate (Index);
+    return;
+  }
+
+  Ptr = (AUTH_CERT_DB_DATA *)(NewCertDb + OldDbSize);
+  if (!CertDbIndexAdd (Index, CertDbIndexHash (&Ptr->VendorGuid, Ptr + 1, ReadUnaligned32 (&Ptr->NameSize)), OldDbSize)) {
+    CertDbIndexInvalidate (Index);
+    return;
+  }
+
+  Index->DbSize = NewDbSize;
+}
+
+/**
+  Record a node removed from a certificate database.
+
+  The nodes after it moved down by CertNodeSize bytes.
+
+  @param[in, out]  Index           Certificate database index.
+  @param[in]       OldDbSize       Size of the database before the node was removed.
+  @param[in]       CertNodeOffset  Offset of the removed AUTH_CERT_DB_DATA.
+  @param[in]       CertNodeSize    Size of the removed AUTH_CERT_DB_DATA.
+**/
+VOID
+CertDbIndexRemove (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     UINT32              OldDbSize,
+  IN     UINT32              CertNodeOffset,
+  IN     UINT32              CertNodeSize
+  )
+{
+  UINT32   Slot;
+  UINT32   Hole;
+  UINT32   Home;
+  UINT32   Mask;
+  BOOLEAN  Found;
+
+  if ((Index->DbSize == 0) || (Index->DbSize != OldDbSize)) {
+    CertDbIndexInvalidate (Index);
+    return;
+  }
+
+  Mask  = Index->SlotCount - 1;
+  Hole  = 0;
+  Found = FALSE;
+  for (Slot = 0; Slot < Index->SlotCount; Slot++) {
+    if (Index->Slots[Slot].NodeOffset == CertNodeOffset) {
+      Hole  = Slot;
+      Found = TRUE;
+    } else if (Index->Slots[Slot].NodeOffset > CertNodeOffset) {
+      Index->Slots[Slot].NodeOffset -= CertNodeSize;
+    }
+  }
+
+  if (!Found) {
+    CertDbIndexInvalidate (Index);
+    return;
+  }
+
+  //
+  // Delete by shifting back the following entries of the probe sequence that
+  // may not stay behind the hole, so that lookups never stop early at it.
+  //
+  Slot = (Hole + 1) & Mask;
+  while (Index->Slots[Slot].NodeOffset != CERT_DB_INDEX_EMPTY_SLOT) {
+    Home = Index->Slots[Slot].Hash & Mask;
+    if (((Slot - Home) & Mask) >= ((Slot - Hole) & Mask)) {
+      Index->Slots[Hole] = Index->Slots[Slot];
+      Hole               = Slot;
+    }
+
+    Slot = (Slot + 1) & Mask;
+  }
+
+  Index->Slots[Hole].NodeOffset = CERT_DB_INDEX_EMPTY_SLOT;
+  Index->NodeCount--;
+  Index->DbSize = OldDbSize - CertNodeSize;
+}
@@ -1291,6 +1291,8 @@ CalculatePrivAuthVarSignChainSHADigest (
 /**
   Find matching signer's certificates for common authenticated variable
   by corresponding VariableName and VendorGuid from "certdb" or "certdbv".
+  The index of the database is used when given, and the database is parsed
+  only if it can't be indexed.
 
   The data format of "certdb" or "certdbv":
   //
@@ -1305,6 +1307,7 @@ CalculatePrivAuthVarSignChainSHADigest (
   @param[in]  VendorGuid     Vendor GUID of authenticated Variable.
   @param[in]  Data           Pointer to variable "certdb" or "certdbv".
   @param[in]  DataSize       Size of variable "certdb" or "certdbv".
+  @param[in]  Index          Index of "certdb" or "certdbv", NULL to parse Data.
   @param[out] CertOffset     Offset of matching CertData, from starting of Data.
   @param[out] CertDataSize   Length of CertData in bytes.
   @param[out] CertNodeOffset Offset of matching AUTH_CERT_DB_DATA , from
@@ -1318,16 +1321,18 @@ CalculatePrivAuthVarSignChainSHADigest (
 **/
 EFI_STATUS
 FindCertsFromDb (
-  IN     CHAR16    *VariableName,
-  IN     EFI_GUID  *VendorGuid,
-  IN     UINT8     *Data,
-  IN     UINTN     DataSize,
-  OUT    UINT32    *CertOffset     OPTIONAL,
-  OUT    UINT32    *CertDataSize   OPTIONAL,
-  OUT    UINT32    *CertNodeOffset OPTIONAL,
-  OUT    UINT32    *CertNodeSize   OPTIONAL
+  IN     CHAR16              *VariableName,
+  IN     EFI_GUID            *VendorGuid,
+  IN     UINT8               *Data,
+  IN     UINTN               DataSize,
+  IN OUT AUTH_CERT_DB_INDEX  *Index          OPTIONAL,
+  OUT    UINT32              *CertOffset     OPTIONAL,
+  OUT    UINT32              *CertDataSize   OPTIONAL,
+  OUT    UINT32              *CertNodeOffset OPTIONAL,
+  OUT    UINT32              *CertNodeSize   OPTIONAL
   )
 {
+  EFI_STATUS         Status;
   UINT32             Offset;
   AUTH_CERT_DB_DATA  *Ptr;
   UINT32             CertSize;
@@ -1352,6 +1357,46 @@ FindCertsFromDb (
     return EFI_INVALID_PARAMETER;
   }
 
+  if (Index != NULL) {
+    Status = CertDbIndexFind (Index, VariableName, VendorGuid, Data, DataSize, &Offset);
+    if (Status == EFI_NOT_FOUND) {
+      return EFI_NOT_FOUND;
+    }
+
+    if (!EFI_ERROR (Status)) {
+      Ptr      = (AUTH_CERT_DB_DATA *)(Data + Offset);
+      NodeSize = ReadUnaligned32 (&Ptr->CertNodeSize);
+      NameSize = ReadUnaligned32 (&Ptr->NameSize);
+      CertSize = ReadUnaligned32 (&Ptr->CertDataSize);
+      if ((NodeSize <= (UINT32)DataSize - Offset) &&
+          ((UINT64)NodeSize == sizeof (AUTH_CERT_DB_DATA) + (UINT64)NameSize * sizeof (CHAR16) + CertSize))
+      {
+        if (CertOffset != NULL) {
+          *CertOffset = Offset + sizeof (AUTH_CERT_DB_DATA) + NameSize * sizeof (CHAR16);
+        }
+
+        if (CertDataSize != NULL) {
+          *CertDataSize = CertSize;
+        }
+
+        if (CertNodeOffset != NULL) {
+          *CertNodeOffset = Offset;
+        }
+
+        if (CertNodeSize != NULL) {
+          *CertNodeSize = NodeSize;
+        }
+
+        return EFI_SUCCESS;
+      }
+
+      //
+      // The database changed behind the index. Parse it instead.
+      //
+      CertDbIndexInvalidate (Index);
+    }
+  }
+
   Offset = sizeof (UINT32);
 
   //
@@ -1481,6 +1526,7 @@ GetCertsFromDb (
              VendorGuid,
              Data,
              DataSize,
+             GetCertDbIndex (Attributes),
              &CertOffset,
              CertDataSize,
              NULL,
@@ -1576,6 +1622,7 @@ DeleteCertsFromDb (
              VendorGuid,
              Data,
              DataSize,
+             GetCertDbIndex (Attributes),
              NULL,
              NULL,
              &CertNodeOffset,
@@ -1625,6 +1672,9 @@ DeleteCertsFromDb (
              NewCertDbSize,
              VarAttr
              );
+  if (!EFI_ERROR (Status)) {
+    CertDbIndexRemove (GetCertDbIndex (Attributes), (UINT32)DataSize, CertNodeOffset, CertNodeSize);
+  }
 
   return Status;
 }
@@ -1725,6 +1775,7 @@ InsertCertsToDb (
              VendorGuid,
              Data,
              DataSize,
+             GetCertDbIndex (Attributes),
              NULL,
              NULL,
              NULL,
@@ -1801,6 +1852,9 @@ InsertCertsToDb (
              NewCertDbSize,
              VarAttr
              );
+  if (!EFI_ERROR (Status)) {
+    CertDbIndexInsert (GetCertDbIndex (Attributes), (UINT32)DataSize, NewCertDb, NewCertDbSize);
+  }
 
   return Status;
 }
@@ -1812,6 +1866,9 @@ InsertCertsToDb (
   make them inconsistent,  this function is called in AuthVariable Init
   to ensure consistency.
 
+  The scan continues behind each removed node instead of starting over, so
+  the clean up takes one pass over "certdb".
+
   @retval  EFI_NOT_FOUND         Fail to find variable "certdb".
   @retval  EFI_OUT_OF_RESOURCES  The operation is failed due to lack of resources.
   @retval  EFI_SUCCESS           The operation is completed successfully.
@@ -1828,90 +1885,103 @@ CleanCertsFromDb (
   UINT32              NodeSize;
   CHAR16              *VariableName;
   EFI_STATUS          Status;
-  BOOLEAN             CertCleaned;
   UINT8               *Data;
   UINTN               DataSize;
   EFI_GUID            AuthVarGuid;
   AUTH_VARIABLE_INFO  AuthVariableInfo;
 
-  Status = EFI_SUCCESS;
+  //
+  // Get variable "certdb"
+  //
+  Status = AuthServiceInternalFindVariable (
+             EFI_CERT_DB_NAME,
+             &gEfiCertDbGuid,
+             (VOID **)&Data,
+             &DataSize
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((DataSize == 0) || (Data == NULL)) {
+    ASSERT (FALSE);
+    return EFI_NOT_FOUND;
+  }
+
+  Offset = sizeof (UINT32);
 
   //
   // Get corresponding certificates by VendorGuid and VariableName.
   //
-  do {
-    CertCleaned = FALSE;
+  while (Offset < (UINT32)DataSize) {
+    Ptr      = (AUTH_CERT_DB_DATA *)(Data + Offset);
+    NodeSize = ReadUnaligned32 (&Ptr->CertNodeSize);
+    NameSize = ReadUnaligned32 (&Ptr->NameSize);
 
     //
-    // Get latest variable "certdb"
+    // Get VarName tailed with '\0'
     //
-    Status = AuthServiceInternalFindVariable (
-               EFI_CERT_DB_NAME,
-               &gEfiCertDbGuid,
-               (VOID **)&Data,
-               &DataSize
-               );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-
-    if ((DataSize == 0) || (Data == NULL)) {
-      ASSERT (FALSE);
-      return EFI_NOT_FOUND;
+    VariableName = AllocateZeroPool ((NameSize + 1) * sizeof (CHAR16));
+    if (VariableName == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
 
-    Offset = sizeof (UINT32);
+    CopyMem (VariableName, (UINT8 *)Ptr + sizeof (AUTH_CERT_DB_DATA), NameSize * sizeof (CHAR16));
+    //
+    // Keep VarGuid  aligned
+    //
+    CopyMem (&AuthVarGuid, &Ptr->VendorGuid, sizeof (EFI_GUID));
 
-    while (Offset < (UINT32)DataSize) {
-      Ptr      = (AUTH_CERT_DB_DATA *)(Data + Offset);
-      NodeSize = ReadUnaligned32 (&Ptr->CertNodeSize);
-      NameSize = ReadUnaligned32 (&Ptr->NameSize);
+    //
+    // Find corresponding time auth variable
+    //
+    ZeroMem (&AuthVariableInfo, sizeof (AuthVariableInfo));
+    Status = mAuthVarLibContextIn->FindVariable (
+                                     VariableName,
+                                     &AuthVarGuid,
+                                     &AuthVariableInfo
+                                     );
 
+    if (EFI_ERROR (Status) || ((AuthVariableInfo.Attributes & EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS) == 0)) {
       //
-      // Get VarName tailed with '\0'
+      // While cleaning certdb, always delete the variable in certdb regardless of it attributes.
       //
-      VariableName = AllocateZeroPool ((NameSize + 1) * sizeof (CHAR16));
-      if (VariableName == NULL) {
-        return EFI_OUT_OF_RESOURCES;
+      Status = DeleteCertsFromDb (
+                 VariableName,
+                 &AuthVarGuid,
+                 AuthVariableInfo.Attributes | EFI_VARIABLE_NON_VOLATILE
+                 );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "Cert for Auth Variable %s Guid %g can't be removed - %r\n", VariableName, &AuthVarGuid, Status));
+        Offset = Offset + NodeSize;
+      } else {
+        DEBUG ((DEBUG_INFO, "Recovery!! Cert for Auth Variable %s Guid %g is removed for consistency\n", VariableName, &AuthVarGuid));
       }
 
-      CopyMem (VariableName, (UINT8 *)Ptr + sizeof (AUTH_CERT_DB_DATA), NameSize * sizeof (CHAR16));
-      //
-      // Keep VarGuid  aligned
-      //
-      CopyMem (&AuthVarGuid, &Ptr->VendorGuid, sizeof (EFI_GUID));
+      FreePool (VariableName);
 
       //
-      // Find corresponding time auth variable
+      // Get latest variable "certdb". The node after the removed one is now
+      // at Offset.
       //
-      ZeroMem (&AuthVariableInfo, sizeof (AuthVariableInfo));
-      Status = mAuthVarLibContextIn->FindVariable (
-                                       VariableName,
-                                       &AuthVarGuid,
-                                       &AuthVariableInfo
-                                       );
-
-      if (EFI_ERROR (Status) || ((AuthVariableInfo.Attributes & EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS) == 0)) {
-        //
-        // While cleaning certdb, always delete the variable in certdb regardless of it attributes.
-        //
-        Status = DeleteCertsFromDb (
-                   VariableName,
-                   &AuthVarGuid,
-                   AuthVariableInfo.Attributes | EFI_VARIABLE_NON_VOLATILE
-                   );
-        CertCleaned = TRUE;
-        DEBUG ((DEBUG_INFO, "Recovery!! Cert for Auth Variable %s Guid %g is removed for consistency\n", VariableName, &AuthVarGuid));
-        FreePool (VariableName);
-        break;
+      Status = AuthServiceInternalFindVariable (
+                 EFI_CERT_DB_NAME,
+                 &gEfiCertDbGuid,
+                 (VOID **)&Data,
+                 &DataSize
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
       }
 
-      FreePool (VariableName);
-      Offset = Offset + NodeSize;
+      continue;
     }
-  } while (CertCleaned);
 
-  return Status;
+    FreePool (VariableName);
+    Offset = Offset + NodeSize;
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
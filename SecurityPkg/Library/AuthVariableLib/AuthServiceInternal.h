@@ -87,6 +87,24 @@ typedef struct {
 } AUTH_CERT_DB_DATA;
 #pragma pack()
 
+///
+/// A slot of the hash table indexing "certdb" or "certdbv".
+///
+typedef struct {
+  UINT32    Hash;       ///< Hash of VendorGuid and VariableName of the node.
+  UINT32    NodeOffset; ///< Offset of the AUTH_CERT_DB_DATA, 0 if the slot is empty.
+} AUTH_CERT_DB_INDEX_SLOT;
+
+///
+/// Index of "certdb" or "certdbv" by VendorGuid and VariableName.
+///
+typedef struct {
+  AUTH_CERT_DB_INDEX_SLOT    *Slots;
+  UINT32                     SlotCount; ///< Power of two.
+  UINT32                     NodeCount;
+  UINT32                     DbSize;    ///< Size of the indexed database, 0 if the index has to be rebuilt.
+} AUTH_CERT_DB_INDEX;
+
 extern UINT8   *mCertDbStore;
 extern UINT32  mMaxCertDbSize;
 extern UINT32  mPlatformMode;
@@ -98,6 +116,9 @@ extern VOID  *mHashSha512Ctx;
 
 extern AUTH_VAR_LIB_CONTEXT_IN  *mAuthVarLibContextIn;
 
+extern AUTH_CERT_DB_INDEX  mCertDbIndex;
+extern AUTH_CERT_DB_INDEX  mCertDbVolatileIndex;
+
 /**
   Process variable with EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS set
 
@@ -367,4 +388,97 @@ AuthServiceInternalUpdateVariableWithTimeStamp (
   IN EFI_TIME  *TimeStamp
   );
 
+/**
+  Allocate the hash tables of the certificate database indexes.
+
+  @retval EFI_SUCCESS           The hash tables were allocated.
+  @retval EFI_OUT_OF_RESOURCES  Fail to allocate the hash tables.
+**/
+EFI_STATUS
+CertDbIndexInitialize (
+  VOID
+  );
+
+/**
+  Get the index of the certificate database used by an authenticated variable.
+
+  @param[in]  Attributes  Attributes of authenticated variable.
+
+  @return  Index of "certdb" for a non-volatile variable, or of "certdbv".
+**/
+AUTH_CERT_DB_INDEX *
+GetCertDbIndex (
+  IN UINT32  Attributes
+  );
+
+/**
+  Forget the content of a certificate database index, so that it is rebuilt
+  the next time the database is searched.
+
+  @param[in, out]  Index  Certificate database index.
+**/
+VOID
+CertDbIndexInvalidate (
+  IN OUT AUTH_CERT_DB_INDEX  *Index
+  );
+
+/**
+  Find the signer's certificates of an authenticated variable in a
+  certificate database through its index.
+
+  @param[in, out]  Index           Certificate database index.
+  @param[in]       VariableName    Name of authenticated Variable.
+  @param[in]       VendorGuid      Vendor GUID of authenticated Variable.
+  @param[in]       Data            Pointer to variable "certdb" or "certdbv".
+  @param[in]       DataSize        Size of variable "certdb" or "certdbv".
+  @param[out]      CertNodeOffset  Offset of matching AUTH_CERT_DB_DATA, from
+                                   starting of Data.
+
+  @retval EFI_SUCCESS    Found the matching AUTH_CERT_DB_DATA.
+  @retval EFI_NOT_FOUND  The database has no matching AUTH_CERT_DB_DATA.
+  @retval EFI_NOT_READY  The database can't be indexed, the caller has to
+                         parse it.
+**/
+EFI_STATUS
+CertDbIndexFind (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     CHAR16              *VariableName,
+  IN     EFI_GUID            *VendorGuid,
+  IN     UINT8               *Data,
+  IN     UINTN               DataSize,
+  OUT    UINT32              *CertNodeOffset
+  );
+
+/**
+  Record a node appended to a certificate database.
+
+  @param[in, out]  Index       Certificate database index.
+  @param[in]       OldDbSize   Size of the database before the node was appended.
+  @param[in]       NewCertDb   Pointer to the new database content.
+  @param[in]       NewDbSize   Size of the new database.
+**/
+VOID
+CertDbIndexInsert (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     UINT32              OldDbSize,
+  IN     UINT8               *NewCertDb,
+  IN     UINT32              NewDbSize
+  );
+
+/**
+  Record a node removed from a certificate database.
+
+  @param[in, out]  Index           Certificate database index.
+  @param[in]       OldDbSize       Size of the database before the node was removed.
+  @param[in]       CertNodeOffset  Offset of the removed AUTH_CERT_DB_DATA.
+  @param[in]       CertNodeSize    Size of the removed AUTH_CERT_DB_DATA.
+**/
+VOID
+CertDbIndexRemove (
+  IN OUT AUTH_CERT_DB_INDEX  *Index,
+  IN     UINT32              OldDbSize,
+  IN     UINT32              CertNodeOffset,
+  IN     UINT32              CertNodeSize
+  );
+
 #endif
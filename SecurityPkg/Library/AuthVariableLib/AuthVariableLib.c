@@ -93,7 +93,7 @@ VARIABLE_ENTRY_PROPERTY  mAuthVarEntry[] = {
   },
 };
 
-VOID  **mAuthVarAddressPointer[11];
+VOID  **mAuthVarAddressPointer[13];
 
 AUTH_VAR_LIB_CONTEXT_IN  *mAuthVarLibContextIn = NULL;
 
@@ -161,6 +161,11 @@ AuthVariableLibInitialize (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  Status = CertDbIndexInitialize ();
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   Status = AuthServiceInternalFindVariable (EFI_PLATFORM_KEY_NAME, &gEfiGlobalVariableGuid, (VOID **)&Data, &DataSize);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "Variable %s does not exist.\n", EFI_PLATFORM_KEY_NAME));
@@ -376,6 +381,8 @@ AuthVariableLibInitialize (
   mAuthVarAddressPointer[8]                 = (VOID **)&(mAuthVarLibContextIn->GetScratchBuffer),
   mAuthVarAddressPointer[9]                 = (VOID **)&(mAuthVarLibContextIn->CheckRemainingSpaceForConsistency),
   mAuthVarAddressPointer[10]                = (VOID **)&(mAuthVarLibContextIn->AtRuntime),
+  mAuthVarAddressPointer[11]                = (VOID **)&mCertDbIndex.Slots;
+  mAuthVarAddressPointer[12]                = (VOID **)&mCertDbVolatileIndex.Slots;
   AuthVarLibContextOut->AddressPointer      = mAuthVarAddressPointer;
   AuthVarLibContextOut->AddressPointerCount = ARRAY_SIZE (mAuthVarAddressPointer);
 
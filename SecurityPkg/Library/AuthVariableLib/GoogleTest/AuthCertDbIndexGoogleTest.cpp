@@ -0,0 +1,652 @@
+/** @file
+  Tests for the index of the signer's certificate databases of
+  AuthCertDbIndex.c, and for the lookups and updates of "certdb" in
+  AuthService.c that go through it.
+
+  The databases are served by a fake variable store. A small hash table with
+  names chosen to collide checks the deletion from the middle of a probe
+  sequence, including one that wraps around the end of the table.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <vector>
+
+extern "C" {
+  #include "../AuthServiceInternal.h"
+  #include <Library/VariablePolicyLib.h>
+
+  EFI_STATUS
+  FindCertsFromDb (
+    IN     CHAR16              *VariableName,
+    IN     EFI_GUID            *VendorGuid,
+    IN     UINT8               *Data,
+    IN     UINTN               DataSize,
+    IN OUT AUTH_CERT_DB_INDEX  *Index          OPTIONAL,
+    OUT    UINT32              *CertOffset     OPTIONAL,
+    OUT    UINT32              *CertDataSize   OPTIONAL,
+    OUT    UINT32              *CertNodeOffset OPTIONAL,
+    OUT    UINT32              *CertNodeSize   OPTIONAL
+    );
+}
+
+using namespace testing;
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_MAX_CERT_DB_SIZE     0x2000
+#define TEST_CERT_SIZE            SHA256_DIGEST_SIZE
+#define TEST_SMALL_SLOT_COUNT     8
+#define TEST_COLLIDING_VAR_COUNT  6
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// The globals of AuthVariableLib.c, which is not part of the test.
+////////////////////////////////////////////////////////////////////////
+UINT8                    *mCertDbStore;
+UINT32                   mMaxCertDbSize;
+UINT32                   mPlatformMode;
+UINT8                    mVendorKeyState;
+VOID                     *mHashSha256Ctx;
+VOID                     *mHashSha384Ctx;
+VOID                     *mHashSha512Ctx;
+AUTH_VAR_LIB_CONTEXT_IN  *mAuthVarLibContextIn;
+
+//
+// PlatformSecureLib and VariablePolicyLib, which the tests don't reach.
+//
+BOOLEAN
+EFIAPI
+UserPhysicalPresent (
+  VOID
+  )
+{
+  return FALSE;
+}
+
+BOOLEAN
+EFIAPI
+IsVariablePolicyEnabled (
+  VOID
+  )
+{
+  return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Fake variable store
+// "certdb", and the time-based authenticated variables that exist.
+////////////////////////////////////////////////////////////////////////
+
+STATIC EFI_GUID  mTestVendorGuid = {
+  0x3C4C2A3F, 0x1B7C, 0x4E8A, { 0x9B, 0x5D, 0x3E, 0x71, 0x2C, 0x44, 0x60, 0x18 }
+};
+
+STATIC EFI_GUID  mOtherVendorGuid = {
+  0x6E2B3F51, 0x90A4, 0x4C1D, { 0x8F, 0x27, 0x15, 0xC3, 0x6A, 0x0E, 0x92, 0x4B }
+};
+
+//
+// With mTestVendorGuid, the hashes of Var2, Var13 and Var20 all select
+// slot 7 of an 8-slot table, those of Var5 and Var14 slot 0, and that of
+// Var4 slot 1. Inserted in this order, they fill slots 7 to 4 with every
+// entry but the first displaced.
+//
+STATIC CHAR16  *mCollidingNames[TEST_COLLIDING_VAR_COUNT] = {
+  (CHAR16 *)L"Var2",
+  (CHAR16 *)L"Var13",
+  (CHAR16 *)L"Var20",
+  (CHAR16 *)L"Var5",
+  (CHAR16 *)L"Var4",
+  (CHAR16 *)L"Var14"
+};
+
+static std::vector<UINT8>     mCertDb;
+static std::vector<CHAR16 *>  mTimeBasedVariables;
+static std::vector<UINTN>     mVariableLookups;
+static BOOLEAN                mFailCertDbUpdate;
+
+static
+EFI_STATUS
+EFIAPI
+FakeFindVariable (
+  IN  CHAR16              *VariableName,
+  IN  EFI_GUID            *VendorGuid,
+  OUT AUTH_VARIABLE_INFO  *AuthVariableInfo
+  )
+{
+  UINTN  Index;
+
+  if (CompareGuid (VendorGuid, &gEfiCertDbGuid) && (StrCmp (VariableName, (CHAR16 *)EFI_CERT_DB_NAME) == 0)) {
+    if (mCertDb.empty ()) {
+      return EFI_NOT_FOUND;
+    }
+
+    AuthVariableInfo->Data     = mCertDb.data ();
+    AuthVariableInfo->DataSize = mCertDb.size ();
+    return EFI_SUCCESS;
+  }
+
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    if (StrCmp (VariableName, mCollidingNames[Index]) == 0) {
+      mVariableLookups[Index]++;
+    }
+  }
+
+  for (CHAR16 *Name : mTimeBasedVariables) {
+    if (StrCmp (VariableName, Name) == 0) {
+      AuthVariableInfo->Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS |
+                                     EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+static
+EFI_STATUS
+EFIAPI
+FakeUpdateVariable (
+  IN AUTH_VARIABLE_INFO  *AuthVariableInfo
+  )
+{
+  if (!CompareGuid (AuthVariableInfo->VendorGuid, &gEfiCertDbGuid) ||
+      (StrCmp (AuthVariableInfo->VariableName, (CHAR16 *)EFI_CERT_DB_NAME) != 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (mFailCertDbUpdate) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mCertDb.assign ((UINT8 *)AuthVariableInfo->Data, (UINT8 *)AuthVariableInfo->Data + AuthVariableInfo->DataSize);
+  return EFI_SUCCESS;
+}
+
+static AUTH_VAR_LIB_CONTEXT_IN  mFakeContextIn = {
+  AUTH_VAR_LIB_CONTEXT_IN_STRUCT_VERSION,
+  sizeof (AUTH_VAR_LIB_CONTEXT_IN),
+  TEST_MAX_CERT_DB_SIZE,
+  FakeFindVariable,
+  NULL,
+  FakeUpdateVariable,
+  NULL,
+  NULL,
+  NULL
+};
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+//
+// Append a node for VendorGuid and Name to a certificate database, whose
+// CertNodeSize claims ExtraSize more bytes than the node holds, and return
+// its offset.
+//
+static
+UINT32
+AppendNode (
+  IN OUT std::vector<UINT8>  &Db,
+  IN     EFI_GUID            *VendorGuid,
+  IN     CHAR16              *Name,
+  IN     UINT32              ExtraSize = 0
+  )
+{
+  AUTH_CERT_DB_DATA  Node;
+  UINT32             Offset;
+  UINT32             DbSize;
+
+  if (Db.empty ()) {
+    Db.resize (sizeof (UINT32));
+  }
+
+  Offset = (UINT32)Db.size ();
+  CopyGuid (&Node.VendorGuid, VendorGuid);
+  Node.NameSize     = (UINT32)StrLen (Name);
+  Node.CertDataSize = TEST_CERT_SIZE;
+  Node.CertNodeSize = sizeof (Node) + Node.NameSize * sizeof (CHAR16) + TEST_CERT_SIZE + ExtraSize;
+
+  Db.insert (Db.end (), (UINT8 *)&Node, (UINT8 *)(&Node + 1));
+  Db.insert (Db.end (), (UINT8 *)Name, (UINT8 *)(Name + Node.NameSize));
+  Db.insert (Db.end (), TEST_CERT_SIZE + ExtraSize, (UINT8)Offset);
+
+  DbSize = (UINT32)Db.size ();
+  CopyMem (Db.data (), &DbSize, sizeof (DbSize));
+  return Offset;
+}
+
+//
+// Remove the node at Offset from a certificate database, as
+// DeleteCertsFromDb() does, and return its size.
+//
+static
+UINT32
+RemoveNode (
+  IN OUT std::vector<UINT8>  &Db,
+  IN     UINT32              Offset
+  )
+{
+  UINT32  NodeSize;
+  UINT32  DbSize;
+
+  NodeSize = ReadUnaligned32 (&((AUTH_CERT_DB_DATA *)(Db.data () + Offset))->CertNodeSize);
+  Db.erase (Db.begin () + Offset, Db.begin () + Offset + NodeSize);
+
+  DbSize = (UINT32)Db.size ();
+  CopyMem (Db.data (), &DbSize, sizeof (DbSize));
+  return NodeSize;
+}
+
+class AuthCertDbIndexTest : public Test {
+protected:
+  AUTH_CERT_DB_INDEX_SLOT  SmallSlots[TEST_SMALL_SLOT_COUNT];
+  AUTH_CERT_DB_INDEX       SmallIndex;
+  std::vector<UINT32>      Offsets;
+
+  void
+  SetUp (
+    ) override
+  {
+    mMaxCertDbSize       = TEST_MAX_CERT_DB_SIZE;
+    mAuthVarLibContextIn = &mFakeContextIn;
+    mCertDbStore         = (UINT8 *)AllocatePool (TEST_MAX_CERT_DB_SIZE);
+    ASSERT_NE (mCertDbStore, nullptr);
+    ASSERT_EQ (CertDbIndexInitialize (), EFI_SUCCESS);
+
+    ZeroMem (&SmallIndex, sizeof (SmallIndex));
+    SmallIndex.Slots     = SmallSlots;
+    SmallIndex.SlotCount = TEST_SMALL_SLOT_COUNT;
+    CertDbIndexInvalidate (&SmallIndex);
+
+    mCertDb.clear ();
+    mTimeBasedVariables.clear ();
+    mVariableLookups.assign (TEST_COLLIDING_VAR_COUNT, 0);
+    mFailCertDbUpdate = FALSE;
+    Offsets.clear ();
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    FreePool (mCertDbStore);
+    FreePool (mCertDbIndex.Slots);
+    FreePool (mCertDbVolatileIndex.Slots);
+    ZeroMem (&mCertDbIndex, sizeof (mCertDbIndex));
+    ZeroMem (&mCertDbVolatileIndex, sizeof (mCertDbVolatileIndex));
+  }
+
+  //
+  // Fill mCertDb with the nodes of the colliding names.
+  //
+  void
+  BuildCollidingDb (
+    )
+  {
+    UINTN  Index;
+
+    for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+      Offsets.push_back (AppendNode (mCertDb, &mTestVendorGuid, mCollidingNames[Index]));
+    }
+  }
+
+  void
+  ExpectFound (
+    AUTH_CERT_DB_INDEX  *Index,
+    CHAR16              *Name,
+    UINT32              ExpectedOffset
+    )
+  {
+    UINT32  Offset;
+
+    Offset = 0;
+    EXPECT_EQ (CertDbIndexFind (Index, Name, &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &Offset), EFI_SUCCESS);
+    EXPECT_EQ (Offset, ExpectedOffset);
+  }
+
+  void
+  ExpectNotFound (
+    AUTH_CERT_DB_INDEX  *Index,
+    CHAR16              *Name
+    )
+  {
+    UINT32  Offset;
+
+    EXPECT_EQ (CertDbIndexFind (Index, Name, &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &Offset), EFI_NOT_FOUND);
+  }
+};
+
+TEST_F (AuthCertDbIndexTest, BuildAndFind) {
+  UINTN   Index;
+  UINT32  Slot;
+  UINTN   Displaced;
+
+  BuildCollidingDb ();
+
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    ExpectFound (&SmallIndex, mCollidingNames[Index], Offsets[Index]);
+  }
+
+  EXPECT_EQ (SmallIndex.NodeCount, (UINT32)TEST_COLLIDING_VAR_COUNT);
+  EXPECT_EQ (SmallIndex.DbSize, (UINT32)mCertDb.size ());
+  ExpectNotFound (&SmallIndex, (CHAR16 *)L"Var3");
+
+  //
+  // The names must collide for the other tests to exercise the probing.
+  //
+  Displaced = 0;
+  for (Slot = 0; Slot < TEST_SMALL_SLOT_COUNT; Slot++) {
+    if ((SmallSlots[Slot].NodeOffset != 0) && ((SmallSlots[Slot].Hash & (TEST_SMALL_SLOT_COUNT - 1)) != Slot)) {
+      Displaced++;
+    }
+  }
+
+  EXPECT_EQ (Displaced, (UINTN)TEST_COLLIDING_VAR_COUNT - 1);
+}
+
+TEST_F (AuthCertDbIndexTest, TooManyNodesAreNotIndexed) {
+  UINT32  Offset;
+
+  BuildCollidingDb ();
+  AppendNode (mCertDb, &mTestVendorGuid, (CHAR16 *)L"Var3");
+
+  EXPECT_EQ (CertDbIndexFind (&SmallIndex, mCollidingNames[0], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &Offset), EFI_NOT_READY);
+  EXPECT_EQ (SmallIndex.DbSize, 0U);
+  EXPECT_EQ (SmallIndex.NodeCount, 0U);
+}
+
+TEST_F (AuthCertDbIndexTest, InsertFollowsAppendedNode) {
+  UINT32  OldDbSize;
+  UINT32  Offset;
+  UINTN   Index;
+
+  Offsets.push_back (AppendNode (mCertDb, &mTestVendorGuid, mCollidingNames[0]));
+  ExpectFound (&SmallIndex, mCollidingNames[0], Offsets[0]);
+
+  for (Index = 1; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    OldDbSize = (UINT32)mCertDb.size ();
+    Offsets.push_back (AppendNode (mCertDb, &mTestVendorGuid, mCollidingNames[Index]));
+    CertDbIndexInsert (&SmallIndex, OldDbSize, mCertDb.data (), (UINT32)mCertDb.size ());
+    EXPECT_EQ (SmallIndex.DbSize, (UINT32)mCertDb.size ());
+    EXPECT_EQ (SmallIndex.NodeCount, (UINT32)Index + 1);
+  }
+
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    ExpectFound (&SmallIndex, mCollidingNames[Index], Offsets[Index]);
+  }
+
+  //
+  // A full table gives up instead of overfilling.
+  //
+  OldDbSize = (UINT32)mCertDb.size ();
+  Offset    = AppendNode (mCertDb, &mTestVendorGuid, (CHAR16 *)L"Var3");
+  CertDbIndexInsert (&SmallIndex, OldDbSize, mCertDb.data (), (UINT32)mCertDb.size ());
+  EXPECT_EQ (SmallIndex.DbSize, 0U);
+  EXPECT_EQ (CertDbIndexFind (&SmallIndex, (CHAR16 *)L"Var3", &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &Offset), EFI_NOT_READY);
+}
+
+TEST_F (AuthCertDbIndexTest, InsertAfterOutOfDateIndexInvalidates) {
+  UINT32  OldDbSize;
+
+  Offsets.push_back (AppendNode (mCertDb, &mTestVendorGuid, mCollidingNames[0]));
+  ExpectFound (&SmallIndex, mCollidingNames[0], Offsets[0]);
+
+  //
+  // A node the index did not see, then one it is told about.
+  //
+  Offsets.push_back (AppendNode (mCertDb, &mTestVendorGuid, mCollidingNames[1]));
+  OldDbSize = (UINT32)mCertDb.size ();
+  Offsets.push_back (AppendNode (mCertDb, &mTestVendorGuid, mCollidingNames[2]));
+  CertDbIndexInsert (&SmallIndex, OldDbSize, mCertDb.data (), (UINT32)mCertDb.size ());
+  EXPECT_EQ (SmallIndex.DbSize, 0U);
+
+  ExpectFound (&SmallIndex, mCollidingNames[1], Offsets[1]);
+  ExpectFound (&SmallIndex, mCollidingNames[2], Offsets[2]);
+  EXPECT_EQ (SmallIndex.NodeCount, 3U);
+}
+
+TEST_F (AuthCertDbIndexTest, RemoveShiftsBackProbeSequence) {
+  UINTN   Removed;
+  UINTN   Index;
+  UINT32  OldDbSize;
+  UINT32  NodeSize;
+
+  //
+  // Remove each node in turn from a fresh table, so that the hole is left
+  // at every position of the cluster, including before the wrap around.
+  //
+  for (Removed = 0; Removed < TEST_COLLIDING_VAR_COUNT; Removed++) {
+    mCertDb.clear ();
+    Offsets.clear ();
+    CertDbIndexInvalidate (&SmallIndex);
+    BuildCollidingDb ();
+    ExpectFound (&SmallIndex, mCollidingNames[0], Offsets[0]);
+
+    OldDbSize = (UINT32)mCertDb.size ();
+    NodeSize  = RemoveNode (mCertDb, Offsets[Removed]);
+    CertDbIndexRemove (&SmallIndex, OldDbSize, Offsets[Removed], NodeSize);
+    EXPECT_EQ (SmallIndex.DbSize, (UINT32)mCertDb.size ()) << "Removed " << Removed;
+    EXPECT_EQ (SmallIndex.NodeCount, (UINT32)TEST_COLLIDING_VAR_COUNT - 1) << "Removed " << Removed;
+
+    //
+    // The index is still up to date, so these lookups don't rebuild it, and
+    // the nodes behind the removed one are found at their new offsets.
+    //
+    for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+      if (Index == Removed) {
+        ExpectNotFound (&SmallIndex, mCollidingNames[Index]);
+      } else {
+        ExpectFound (&SmallIndex, mCollidingNames[Index], (Index < Removed) ? Offsets[Index] : Offsets[Index] - NodeSize);
+      }
+    }
+
+    EXPECT_EQ (SmallIndex.DbSize, (UINT32)mCertDb.size ()) << "Removed " << Removed;
+  }
+}
+
+TEST_F (AuthCertDbIndexTest, RemoveAllNodes) {
+  UINTN   Index;
+  UINTN   Next;
+  UINT32  OldDbSize;
+  UINT32  NodeSize;
+  UINT32  Slot;
+
+  BuildCollidingDb ();
+  ExpectFound (&SmallIndex, mCollidingNames[0], Offsets[0]);
+
+  //
+  // Remove the first node each time, which moves all the others.
+  //
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    OldDbSize = (UINT32)mCertDb.size ();
+    NodeSize  = RemoveNode (mCertDb, sizeof (UINT32));
+    CertDbIndexRemove (&SmallIndex, OldDbSize, sizeof (UINT32), NodeSize);
+    EXPECT_EQ (SmallIndex.DbSize, (UINT32)mCertDb.size ());
+
+    for (Next = Index + 1; Next < TEST_COLLIDING_VAR_COUNT; Next++) {
+      Offsets[Next] -= NodeSize;
+      ExpectFound (&SmallIndex, mCollidingNames[Next], Offsets[Next]);
+    }
+  }
+
+  EXPECT_EQ (SmallIndex.NodeCount, 0U);
+  for (Slot = 0; Slot < TEST_SMALL_SLOT_COUNT; Slot++) {
+    EXPECT_EQ (SmallSlots[Slot].NodeOffset, 0U);
+  }
+}
+
+TEST_F (AuthCertDbIndexTest, RemoveFromOutOfDateIndexInvalidates) {
+  UINT32  OldDbSize;
+  UINT32  NodeSize;
+
+  BuildCollidingDb ();
+  ExpectFound (&SmallIndex, mCollidingNames[0], Offsets[0]);
+
+  OldDbSize = (UINT32)mCertDb.size ();
+  NodeSize  = RemoveNode (mCertDb, Offsets[1]);
+  CertDbIndexRemove (&SmallIndex, OldDbSize + 1, Offsets[1], NodeSize);
+  EXPECT_EQ (SmallIndex.DbSize, 0U);
+
+  ExpectFound (&SmallIndex, mCollidingNames[2], Offsets[2] - NodeSize);
+}
+
+TEST_F (AuthCertDbIndexTest, SizeMismatchRebuilds) {
+  CHAR16  *Name;
+  UINT32  Offset;
+
+  BuildCollidingDb ();
+  ExpectFound (&SmallIndex, mCollidingNames[0], Offsets[0]);
+
+  //
+  // Another writer of the variable replaced a node behind the index.
+  //
+  Name = mCollidingNames[TEST_COLLIDING_VAR_COUNT - 1];
+  RemoveNode (mCertDb, Offsets[TEST_COLLIDING_VAR_COUNT - 1]);
+  Offset = AppendNode (mCertDb, &mOtherVendorGuid, (CHAR16 *)L"Var3");
+  ASSERT_NE ((UINT32)mCertDb.size (), SmallIndex.DbSize);
+
+  EXPECT_EQ (CertDbIndexFind (&SmallIndex, (CHAR16 *)L"Var3", &mOtherVendorGuid, mCertDb.data (), mCertDb.size (), &Offset), EFI_SUCCESS);
+  EXPECT_EQ (Offset, Offsets[TEST_COLLIDING_VAR_COUNT - 1]);
+  EXPECT_EQ (SmallIndex.DbSize, (UINT32)mCertDb.size ());
+  ExpectNotFound (&SmallIndex, Name);
+}
+
+TEST_F (AuthCertDbIndexTest, MalformedDbIsParsed) {
+  UINT32  Offset;
+  UINT32  NodeOffset;
+  UINT32  NodeSize;
+  UINT32  CertOffset;
+  UINT32  CertSize;
+
+  //
+  // A node of another vendor whose size doesn't match its content can't be
+  // indexed, but the parsing skips it.
+  //
+  AppendNode (mCertDb, &mOtherVendorGuid, (CHAR16 *)L"Other", 2);
+  Offset = AppendNode (mCertDb, &mTestVendorGuid, mCollidingNames[0]);
+
+  EXPECT_EQ (CertDbIndexFind (&mCertDbIndex, mCollidingNames[0], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &NodeOffset), EFI_NOT_READY);
+
+  EXPECT_EQ (
+    FindCertsFromDb (mCollidingNames[0], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &mCertDbIndex, &CertOffset, &CertSize, &NodeOffset, &NodeSize),
+    EFI_SUCCESS
+    );
+  EXPECT_EQ (NodeOffset, Offset);
+  EXPECT_EQ (NodeSize, (UINT32)(mCertDb.size () - Offset));
+  EXPECT_EQ (CertOffset, (UINT32)(Offset + sizeof (AUTH_CERT_DB_DATA) + StrLen (mCollidingNames[0]) * sizeof (CHAR16)));
+  EXPECT_EQ (CertSize, (UINT32)TEST_CERT_SIZE);
+  EXPECT_EQ (mCertDbIndex.DbSize, 0U);
+
+  EXPECT_EQ (
+    FindCertsFromDb (mCollidingNames[1], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &mCertDbIndex, NULL, NULL, NULL, NULL),
+    EFI_NOT_FOUND
+    );
+}
+
+TEST_F (AuthCertDbIndexTest, FindThroughIndexMatchesParsing) {
+  UINTN   Index;
+  UINT32  NodeOffset;
+  UINT32  NodeSize;
+  UINT32  ParsedNodeOffset;
+  UINT32  ParsedNodeSize;
+
+  BuildCollidingDb ();
+  AppendNode (mCertDb, &mOtherVendorGuid, mCollidingNames[0]);
+
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    EXPECT_EQ (
+      FindCertsFromDb (mCollidingNames[Index], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &mCertDbIndex, NULL, NULL, &NodeOffset, &NodeSize),
+      EFI_SUCCESS
+      );
+    EXPECT_EQ (
+      FindCertsFromDb (mCollidingNames[Index], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), NULL, NULL, NULL, &ParsedNodeOffset, &ParsedNodeSize),
+      EFI_SUCCESS
+      );
+    EXPECT_EQ (NodeOffset, ParsedNodeOffset);
+    EXPECT_EQ (NodeSize, ParsedNodeSize);
+  }
+
+  EXPECT_EQ (mCertDbIndex.DbSize, (UINT32)mCertDb.size ());
+  EXPECT_EQ (mCertDbIndex.NodeCount, (UINT32)TEST_COLLIDING_VAR_COUNT + 1);
+}
+
+TEST_F (AuthCertDbIndexTest, DeleteCertsUpdatesIndex) {
+  UINT32  NodeOffset;
+  UINT32  NodeSize;
+  UINTN   DbSize;
+
+  BuildCollidingDb ();
+  ASSERT_EQ (
+    FindCertsFromDb (mCollidingNames[0], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &mCertDbIndex, NULL, NULL, NULL, &NodeSize),
+    EFI_SUCCESS
+    );
+
+  DbSize = mCertDb.size ();
+  EXPECT_EQ (DeleteCertsFromDb (mCollidingNames[0], &mTestVendorGuid, EFI_VARIABLE_NON_VOLATILE), EFI_SUCCESS);
+  EXPECT_EQ (mCertDb.size (), DbSize - NodeSize);
+
+  //
+  // Updated in place rather than rebuilt.
+  //
+  EXPECT_EQ (mCertDbIndex.DbSize, (UINT32)mCertDb.size ());
+  EXPECT_EQ (mCertDbIndex.NodeCount, (UINT32)TEST_COLLIDING_VAR_COUNT - 1);
+  EXPECT_EQ (CertDbIndexFind (&mCertDbIndex, mCollidingNames[1], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), &NodeOffset), EFI_SUCCESS);
+  EXPECT_EQ (NodeOffset, (UINT32)sizeof (UINT32));
+  EXPECT_EQ (DeleteCertsFromDb (mCollidingNames[0], &mTestVendorGuid, EFI_VARIABLE_NON_VOLATILE), EFI_NOT_FOUND);
+}
+
+TEST_F (AuthCertDbIndexTest, CleanCertsInOnePass) {
+  UINTN   Index;
+  UINT32  NodeOffset;
+
+  BuildCollidingDb ();
+
+  //
+  // Every other variable is gone, so its node has to be removed.
+  //
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index += 2) {
+    mTimeBasedVariables.push_back (mCollidingNames[Index]);
+  }
+
+  EXPECT_EQ (CleanCertsFromDb (), EFI_SUCCESS);
+
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    EXPECT_EQ (mVariableLookups[Index], 1U) << "Variable " << Index;
+    EXPECT_EQ (
+      FindCertsFromDb (mCollidingNames[Index], &mTestVendorGuid, mCertDb.data (), mCertDb.size (), NULL, NULL, NULL, &NodeOffset, NULL),
+      ((Index % 2) == 0) ? EFI_SUCCESS : EFI_NOT_FOUND
+      ) << "Variable " << Index;
+  }
+}
+
+TEST_F (AuthCertDbIndexTest, CleanCertsSkipsNodeItCannotRemove) {
+  UINTN  Index;
+  UINTN  DbSize;
+
+  BuildCollidingDb ();
+  DbSize            = mCertDb.size ();
+  mFailCertDbUpdate = TRUE;
+
+  EXPECT_EQ (CleanCertsFromDb (), EFI_SUCCESS);
+
+  EXPECT_EQ (mCertDb.size (), DbSize);
+  for (Index = 0; Index < TEST_COLLIDING_VAR_COUNT; Index++) {
+    EXPECT_EQ (mVariableLookups[Index], 1U) << "Variable " << Index;
+  }
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
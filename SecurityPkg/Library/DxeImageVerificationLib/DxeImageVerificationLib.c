@@ -20,19 +20,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "DxeImageVerificationLib.h"
 
-//
-// Caution: This is used by a function which may receive untrusted input.
-// These global variables hold PE/COFF image data, and they should be validated before use.
-//
-EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION  mNtHeader;
-UINT32                               mPeCoffHeaderOffset;
-EFI_GUID                             mCertType;
+EFI_GUID  mCertType;
 
 //
-// Information on current PE/COFF image
+// Current digest of current PE/COFF image
 //
-UINTN  mImageSize;
-UINT8  *mImageBase = NULL;
 UINT8  mImageDigest[MAX_DIGEST_SIZE];
 UINTN  mImageDigestSize;
 
@@ -46,29 +38,6 @@ CHAR16  mNotifyString2[MAX_NOTIFY_STRING_LEN] = L"Launch this image anyway? (Yes
 //
 CONST UINT8  mRsaE[] = { 0x01, 0x00, 0x01 };
 
-//
-// OID ASN.1 Value for Hash Algorithms
-//
-UINT8  mHashOidValue[] = {
-  0x2B, 0x0E, 0x03, 0x02, 0x1A,                         // OBJ_sha1
-  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x04, // OBJ_sha224
-  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, // OBJ_sha256
-  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, // OBJ_sha384
-  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, // OBJ_sha512
-};
-
-HASH_TABLE  mHash[] = {
- #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
-  { L"SHA1",   20, &mHashOidValue[0],  5, Sha1GetContextSize,   Sha1Init,   Sha1Update,   Sha1Final   },
- #else
-  { L"SHA1",   20, &mHashOidValue[0],  5, NULL,                 NULL,       NULL,         NULL        },
- #endif
-  { L"SHA224", 28, &mHashOidValue[5],  9, NULL,                 NULL,       NULL,         NULL        },
-  { L"SHA256", 32, &mHashOidValue[14], 9, Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final },
-  { L"SHA384", 48, &mHashOidValue[23], 9, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final },
-  { L"SHA512", 64, &mHashOidValue[32], 9, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final }
-};
-
 EFI_STRING  mHashTypeStr;
 
 /**
@@ -273,14 +242,11 @@ GetImageType (
 
 /**
   Calculate hash of Pe/Coff image based on the authenticode image hashing in
-  PE/COFF Specification 8.0 Appendix A
+  PE/COFF Specification 8.0 Appendix A, and make it the current digest of the
+  image (mImageDigest, mImageDigestSize and mCertType).
 
-  Caution: This function may receive untrusted input.
-  PE/COFF image is external input, so this function will validate its data structure
-  within this image buffer before use.
-
-  Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
-  its caller function DxeImageVerificationHandler().
+  The digest is only computed if HashPeImageDigests() did not compute it yet
+  for this image.
 
   @param[in]    HashAlg   Hash algorithm type.
 
@@ -293,23 +259,6 @@ HashPeImage (
   IN  UINT32  HashAlg
   )
 {
-  BOOLEAN                   Status;
-  EFI_IMAGE_SECTION_HEADER  *Section;
-  VOID                      *HashCtx;
-  UINTN                     CtxSize;
-  UINT8                     *HashBase;
-  UINTN                     HashSize;
-  UINTN                     SumOfBytesHashed;
-  EFI_IMAGE_SECTION_HEADER  *SectionHeader;
-  UINTN                     Index;
-  UINTN                     Pos;
-  UINT32                    CertSize;
-  UINT32                    NumberOfRvaAndSizes;
-
-  HashCtx       = NULL;
-  SectionHeader = NULL;
-  Status        = FALSE;
-
   if ((HashAlg >= HASHALG_MAX)) {
     return FALSE;
   }
@@ -347,262 +296,13 @@ HashPeImage (
   }
 
   mHashTypeStr = mHash[HashAlg].Name;
-  CtxSize      = mHash[HashAlg].GetContextSize ();
 
-  HashCtx = AllocatePool (CtxSize);
-  if (HashCtx == NULL) {
+  if (!HashPeImageDigests (HASHALG_MASK (HashAlg))) {
     return FALSE;
   }
 
-  // 1.  Load the image header into memory.
-
-  // 2.  Initialize a SHA hash context.
-  Status = mHash[HashAlg].HashInit (HashCtx);
-
-  if (!Status) {
-    goto Done;
-  }
-
-  //
-  // Measuring PE/COFF Image Header;
-  // But CheckSum field and SECURITY data directory (certificate) are excluded
-  //
-
-  //
-  // 3.  Calculate the distance from the base of the image header to the image checksum address.
-  // 4.  Hash the image header from its base to beginning of the image checksum.
-  //
-  HashBase = mImageBase;
-  if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-    //
-    // Use PE32 offset.
-    //
-    HashSize            = (UINTN)(&mNtHeader.Pe32->OptionalHeader.CheckSum) - (UINTN)HashBase;
-    NumberOfRvaAndSizes = mNtHeader.Pe32->OptionalHeader.NumberOfRvaAndSizes;
-  } else if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
-    //
-    // Use PE32+ offset.
-    //
-    HashSize            = (UINTN)(&mNtHeader.Pe32Plus->OptionalHeader.CheckSum) - (UINTN)HashBase;
-    NumberOfRvaAndSizes = mNtHeader.Pe32Plus->OptionalHeader.NumberOfRvaAndSizes;
-  } else {
-    //
-    // Invalid header magic number.
-    //
-    Status = FALSE;
-    goto Done;
-  }
-
-  Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-  if (!Status) {
-    goto Done;
-  }
-
-  //
-  // 5.  Skip over the image checksum (it occupies a single ULONG).
-  //
-  if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
-    //
-    // 6.  Since there is no Cert Directory in optional header, hash everything
-    //     from the end of the checksum to the end of image header.
-    //
-    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-      //
-      // Use PE32 offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    } else {
-      //
-      // Use PE32+ offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    }
-
-    if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    }
-  } else {
-    //
-    // 7.  Hash everything from the end of the checksum to the start of the Cert Directory.
-    //
-    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-      //
-      // Use PE32 offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = (UINTN)(&mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
-    } else {
-      //
-      // Use PE32+ offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = (UINTN)(&mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
-    }
-
-    if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    }
-
-    //
-    // 8.  Skip over the Cert Directory. (It is sizeof(IMAGE_DATA_DIRECTORY) bytes.)
-    // 9.  Hash everything from the end of the Cert Directory to the end of image header.
-    //
-    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-      //
-      // Use PE32 offset
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
-      HashSize = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    } else {
-      //
-      // Use PE32+ offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
-      HashSize = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    }
-
-    if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    }
-  }
-
-  //
-  // 10. Set the SUM_OF_BYTES_HASHED to the size of the header.
-  //
-  if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-    //
-    // Use PE32 offset.
-    //
-    SumOfBytesHashed = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders;
-  } else {
-    //
-    // Use PE32+ offset
-    //
-    SumOfBytesHashed = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders;
-  }
-
-  Section = (EFI_IMAGE_SECTION_HEADER *)(
-                                         mImageBase +
-                                         mPeCoffHeaderOffset +
-                                         sizeof (UINT32) +
-                                         sizeof (EFI_IMAGE_FILE_HEADER) +
-                                         mNtHeader.Pe32->FileHeader.SizeOfOptionalHeader
-                                         );
-
-  //
-  // 11. Build a temporary table of pointers to all the IMAGE_SECTION_HEADER
-  //     structures in the image. The 'NumberOfSections' field of the image
-  //     header indicates how big the table should be. Do not include any
-  //     IMAGE_SECTION_HEADERs in the table whose 'SizeOfRawData' field is zero.
-  //
-  SectionHeader = (EFI_IMAGE_SECTION_HEADER *)AllocateZeroPool (sizeof (EFI_IMAGE_SECTION_HEADER) * mNtHeader.Pe32->FileHeader.NumberOfSections);
-  if (SectionHeader == NULL) {
-    Status = FALSE;
-    goto Done;
-  }
-
-  //
-  // 12.  Using the 'PointerToRawData' in the referenced section headers as
-  //      a key, arrange the elements in the table in ascending order. In other
-  //      words, sort the section headers according to the disk-file offset of
-  //      the section.
-  //
-  for (Index = 0; Index < mNtHeader.Pe32->FileHeader.NumberOfSections; Index++) {
-    Pos = Index;
-    while ((Pos > 0) && (Section->PointerToRawData < SectionHeader[Pos - 1].PointerToRawData)) {
-      CopyMem (&SectionHeader[Pos], &SectionHeader[Pos - 1], sizeof (EFI_IMAGE_SECTION_HEADER));
-      Pos--;
-    }
-
-    CopyMem (&SectionHeader[Pos], Section, sizeof (EFI_IMAGE_SECTION_HEADER));
-    Section += 1;
-  }
-
-  //
-  // 13.  Walk through the sorted table, bring the corresponding section
-  //      into memory, and hash the entire section (using the 'SizeOfRawData'
-  //      field in the section header to determine the amount of data to hash).
-  // 14.  Add the section's 'SizeOfRawData' to SUM_OF_BYTES_HASHED .
-  // 15.  Repeat steps 13 and 14 for all the sections in the sorted table.
-  //
-  for (Index = 0; Index < mNtHeader.Pe32->FileHeader.NumberOfSections; Index++) {
-    Section = &SectionHeader[Index];
-    if (Section->SizeOfRawData == 0) {
-      continue;
-    }
-
-    HashBase = mImageBase + Section->PointerToRawData;
-    HashSize = (UINTN)Section->SizeOfRawData;
-
-    Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-    if (!Status) {
-      goto Done;
-    }
-
-    SumOfBytesHashed += HashSize;
-  }
-
-  //
-  // 16.  If the file size is greater than SUM_OF_BYTES_HASHED, there is extra
-  //      data in the file that needs to be added to the hash. This data begins
-  //      at file offset SUM_OF_BYTES_HASHED and its length is:
-  //             FileSize  -  (CertDirectory->Size)
-  //
-  if (mImageSize > SumOfBytesHashed) {
-    HashBase = mImageBase + SumOfBytesHashed;
-
-    if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
-      CertSize = 0;
-    } else {
-      if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-        //
-        // Use PE32 offset.
-        //
-        CertSize = mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
-      } else {
-        //
-        // Use PE32+ offset.
-        //
-        CertSize = mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
-      }
-    }
-
-    if (mImageSize > CertSize + SumOfBytesHashed) {
-      HashSize = (UINTN)(mImageSize - CertSize - SumOfBytesHashed);
-
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    } else if (mImageSize < CertSize + SumOfBytesHashed) {
-      Status = FALSE;
-      goto Done;
-    }
-  }
-
-  Status = mHash[HashAlg].HashFinal (HashCtx, mImageDigest);
-
-Done:
-  if (HashCtx != NULL) {
-    FreePool (HashCtx);
-  }
-
-  if (SectionHeader != NULL) {
-    FreePool (SectionHeader);
-  }
-
-  return Status;
+  CopyMem (mImageDigest, mImageDigests[HashAlg], mImageDigestSize);
+  return TRUE;
 }
 
 /**
@@ -827,13 +527,26 @@ AddImageExeInfo (
   }
 }
 
+//
+// Signature types of the X.509 certificate hashes in the forbidden database.
+//
+typedef struct {
+  EFI_GUID    *SignatureType;
+  UINT32      HashAlg;
+} X509_HASH_TYPE;
+
+X509_HASH_TYPE  mX509HashType[] = {
+  { &gEfiCertX509Sha256Guid, HASHALG_SHA256 },
+  { &gEfiCertX509Sha384Guid, HASHALG_SHA384 },
+  { &gEfiCertX509Sha512Guid, HASHALG_SHA512 }
+};
+
 /**
   Check whether the hash of an given X.509 certificate is in forbidden database (DBX).
 
   @param[in]  Certificate       Pointer to X.509 Certificate that is searched for.
   @param[in]  CertSize          Size of X.509 Certificate.
-  @param[in]  SignatureList     Pointer to the Signature List in forbidden database.
-  @param[in]  SignatureListSize Size of Signature List.
+  @param[in]  Dbx               The forbidden database.
   @param[out] RevocationTime    Return the time that the certificate was revoked.
   @param[out] IsFound           Search result. Only valid if EFI_SUCCESS returned.
 
@@ -845,34 +558,32 @@ EFI_STATUS
 IsCertHashFoundInDbx (
   IN  UINT8               *Certificate,
   IN  UINTN               CertSize,
-  IN  EFI_SIGNATURE_LIST  *SignatureList,
-  IN  UINTN               SignatureListSize,
+  IN  SIGNATURE_DATABASE  *Dbx,
   OUT EFI_TIME            *RevocationTime,
   OUT BOOLEAN             *IsFound
   )
 {
   EFI_STATUS          Status;
   EFI_SIGNATURE_LIST  *DbxList;
-  UINTN               DbxSize;
   EFI_SIGNATURE_DATA  *CertHash;
-  UINTN               CertHashCount;
+  EFI_SIGNATURE_LIST  *FoundList;
+  EFI_SIGNATURE_DATA  *FoundHash;
+  UINTN               FoundDigestLength;
   UINTN               Index;
   UINT32              HashAlg;
   VOID                *HashCtx;
   UINT8               CertDigest[MAX_DIGEST_SIZE];
-  UINT8               *DbxCertHash;
-  UINTN               SiglistHeaderSize;
   UINT8               *TBSCert;
   UINTN               TBSCertSize;
 
-  Status   = EFI_ABORTED;
-  *IsFound = FALSE;
-  DbxList  = SignatureList;
-  DbxSize  = SignatureListSize;
-  HashCtx  = NULL;
-  HashAlg  = HASHALG_MAX;
+  Status            = EFI_ABORTED;
+  *IsFound          = FALSE;
+  HashCtx           = NULL;
+  FoundList         = NULL;
+  FoundHash         = NULL;
+  FoundDigestLength = 0;
 
-  if ((RevocationTime == NULL) || (DbxList == NULL)) {
+  if ((RevocationTime == NULL) || (Dbx == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -883,22 +594,17 @@ IsCertHashFoundInDbx (
     return Status;
   }
 
-  while ((DbxSize > 0) && (SignatureListSize >= DbxList->SignatureListSize)) {
-    //
-    // Determine Hash Algorithm of Certificate in the forbidden database.
-    //
-    if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha256Guid)) {
-      HashAlg = HASHALG_SHA256;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha384Guid)) {
-      HashAlg = HASHALG_SHA384;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha512Guid)) {
-      HashAlg = HASHALG_SHA512;
-    } else {
-      DbxSize -= DbxList->SignatureListSize;
-      DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
+  //
+  // Hash the TBSCertificate once per hash algorithm used in the forbidden
+  // database, and keep the match which comes first in the database.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (mX509HashType); Index++) {
+    if (!SignatureDatabaseHasType (Dbx, mX509HashType[Index].SignatureType)) {
       continue;
     }
 
+    HashAlg = mX509HashType[Index].HashAlg;
+
     //
     // Calculate the hash value of current TBSCertificate for comparision.
     //
@@ -927,33 +633,36 @@ IsCertHashFoundInDbx (
     FreePool (HashCtx);
     HashCtx = NULL;
 
-    SiglistHeaderSize = sizeof (EFI_SIGNATURE_LIST) + DbxList->SignatureHeaderSize;
-    CertHash          = (EFI_SIGNATURE_DATA *)((UINT8 *)DbxList + SiglistHeaderSize);
-    CertHashCount     = (DbxList->SignatureListSize - SiglistHeaderSize) / DbxList->SignatureSize;
-    for (Index = 0; Index < CertHashCount; Index++) {
-      //
-      // Iterate each Signature Data Node within this CertList for verify.
-      //
-      DbxCertHash = CertHash->SignatureData;
-      if (CompareMem (DbxCertHash, CertDigest, mHash[HashAlg].DigestLength) == 0) {
-        //
-        // Hash of Certificate is found in forbidden database.
-        //
-        Status   = EFI_SUCCESS;
-        *IsFound = TRUE;
+    CertHash = SignatureDatabaseFind (
+                 Dbx,
+                 mX509HashType[Index].SignatureType,
+                 CertDigest,
+                 mHash[HashAlg].DigestLength,
+                 TRUE,
+                 &DbxList
+                 );
+    if ((CertHash != NULL) && ((FoundHash == NULL) || ((UINTN)CertHash < (UINTN)FoundHash))) {
+      FoundList         = DbxList;
+      FoundHash         = CertHash;
+      FoundDigestLength = mHash[HashAlg].DigestLength;
+    }
+  }
 
-        //
-        // Return the revocation time.
-        //
-        CopyMem (RevocationTime, (EFI_TIME *)(DbxCertHash + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
-        goto Done;
-      }
+  if (FoundHash != NULL) {
+    //
+    // Hash of Certificate is found in forbidden database.
+    //
+    *IsFound = TRUE;
 
-      CertHash = (EFI_SIGNATURE_DATA *)((UINT8 *)CertHash + DbxList->SignatureSize);
+    //
+    // Return the revocation time, or a zero time (always revoked) if the
+    // signature has no room for it.
+    //
+    if (FoundList->SignatureSize - sizeof (EFI_GUID) >= FoundDigestLength + sizeof (EFI_TIME)) {
+      CopyMem (RevocationTime, FoundHash->SignatureData + FoundDigestLength, sizeof (EFI_TIME));
+    } else {
+      ZeroMem (RevocationTime, sizeof (EFI_TIME));
     }
-
-    DbxSize -= DbxList->SignatureListSize;
-    DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
   }
 
   Status = EFI_SUCCESS;
@@ -989,21 +698,16 @@ IsSignatureFoundInDatabase (
   )
 {
   EFI_STATUS          Status;
+  SIGNATURE_DATABASE  *Database;
   EFI_SIGNATURE_LIST  *CertList;
   EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
 
   //
   // Read signature database variable.
   //
   *IsFound = FALSE;
-  Data     = NULL;
-  DataSize = 0;
-  Status   = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  Status   = GetSignatureDatabase (VariableName, &Database);
+  if (EFI_ERROR (Status)) {
     if (Status == EFI_NOT_FOUND) {
       //
       // No database, no need to search.
@@ -1014,58 +718,24 @@ IsSignatureFoundInDatabase (
     return Status;
   }
 
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
   //
-  // Enumerate all signature data in SigDB to check if signature exists for executable.
+  // Look up the signature of the executable in the index of SigDB.
   //
-  CertList = (EFI_SIGNATURE_LIST *)Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-    if ((CertList->SignatureSize == sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid (&CertList->SignatureType, CertType))) {
-      for (Index = 0; Index < CertCount; Index++) {
-        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
-          //
-          // Find the signature in database.
-          //
-          *IsFound = TRUE;
-          //
-          // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
-          //
-          if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
-            SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
-          }
-
-          break;
-        }
-
-        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
-      }
-
-      if (*IsFound) {
-        break;
-      }
+  Cert = SignatureDatabaseFind (Database, CertType, Signature, SignatureSize, FALSE, &CertList);
+  if (Cert != NULL) {
+    //
+    // Find the signature in database.
+    //
+    *IsFound = TRUE;
+    //
+    // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
+    //
+    if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+      SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
     }
-
-    DataSize -= CertList->SignatureListSize;
-    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
-  }
-
-Done:
-  if (Data != NULL) {
-    FreePool (Data);
   }
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1252,14 +922,9 @@ IsForbiddenByDbx (
   EFI_STATUS          Status;
   BOOLEAN             IsForbidden;
   BOOLEAN             IsFound;
-  UINT8               *Data;
-  UINTN               DataSize;
-  EFI_SIGNATURE_LIST  *CertList;
-  UINTN               CertListSize;
-  EFI_SIGNATURE_DATA  *CertData;
+  SIGNATURE_DATABASE  *Dbx;
   UINT8               *RootCert;
   UINTN               RootCertSize;
-  UINTN               CertCount;
   UINTN               Index;
   UINT8               *CertBuffer;
   UINTN               BufferLength;
@@ -1275,9 +940,6 @@ IsForbiddenByDbx (
   // Variable Initialization
   //
   IsForbidden       = TRUE;
-  Data              = NULL;
-  CertList          = NULL;
-  CertData          = NULL;
   RootCert          = NULL;
   RootCertSize      = 0;
   Cert              = NULL;
@@ -1289,10 +951,8 @@ IsForbiddenByDbx (
   //
   // The image will not be forbidden if dbx can't be got.
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  Status = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1, &Dbx);
+  if (EFI_ERROR (Status)) {
     if (Status == EFI_NOT_FOUND) {
       //
       // Evidently not in dbx if the database doesn't exist.
@@ -1303,56 +963,29 @@ IsForbiddenByDbx (
     return IsForbidden;
   }
 
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return IsForbidden;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
   //
   // Verify image signature with RAW X509 certificates in DBX database.
   // If passed, the image will be forbidden.
   //
-  CertList     = (EFI_SIGNATURE_LIST *)Data;
-  CertListSize = DataSize;
-  while ((CertListSize > 0) && (CertListSize >= CertList->SignatureListSize)) {
-    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-      CertData  = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-      for (Index = 0; Index < CertCount; Index++) {
-        //
-        // Iterate each Signature Data Node within this CertList for verify.
-        //
-        RootCert     = CertData->SignatureData;
-        RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
+  for (Index = 0; Index < Dbx->CertCount; Index++) {
+    RootCert     = Dbx->Certs[Index].Data->SignatureData;
+    RootCertSize = Dbx->Certs[Index].DataSize;
 
-        //
-        // Call AuthenticodeVerify library to Verify Authenticode struct.
-        //
-        IsForbidden = AuthenticodeVerify (
-                        AuthData,
-                        AuthDataSize,
-                        RootCert,
-                        RootCertSize,
-                        mImageDigest,
-                        mImageDigestSize
-                        );
-        if (IsForbidden) {
-          DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
-          goto Done;
-        }
-
-        CertData = (EFI_SIGNATURE_DATA *)((UINT8 *)CertData + CertList->SignatureSize);
-      }
+    //
+    // Call AuthenticodeVerify library to Verify Authenticode struct.
+    //
+    IsForbidden = AuthenticodeVerify (
+                    AuthData,
+                    AuthDataSize,
+                    RootCert,
+                    RootCertSize,
+                    mImageDigest,
+                    mImageDigestSize
+                    );
+    if (IsForbidden) {
+      DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
+      goto Done;
     }
-
-    CertListSize -= CertList->SignatureListSize;
-    CertList      = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
   }
 
   //
@@ -1390,7 +1023,7 @@ IsForbiddenByDbx (
     //
     CertPtr = CertPtr + sizeof (UINT32) + CertSize;
 
-    Status = IsCertHashFoundInDbx (Cert, CertSize, (EFI_SIGNATURE_LIST *)Data, DataSize, &RevocationTime, &IsFound);
+    Status = IsCertHashFoundInDbx (Cert, CertSize, Dbx, &RevocationTime, &IsFound);
     if (EFI_ERROR (Status)) {
       //
       // Error in searching dbx. Consider it as 'found'. RevocationTime might
@@ -1419,10 +1052,6 @@ IsForbiddenByDbx (
   IsForbidden = FALSE;
 
 Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   Pkcs7FreeSigners (CertBuffer);
   Pkcs7FreeSigners (TrustedCert);
 
@@ -1448,23 +1077,18 @@ IsAllowedByDb (
   EFI_STATUS          Status;
   BOOLEAN             VerifyStatus;
   BOOLEAN             IsFound;
+  SIGNATURE_DATABASE  *Db;
+  SIGNATURE_DATABASE  *Dbx;
   EFI_SIGNATURE_LIST  *CertList;
   EFI_SIGNATURE_DATA  *CertData;
-  UINTN               DataSize;
-  UINT8               *Data;
   UINT8               *RootCert;
   UINTN               RootCertSize;
   UINTN               Index;
-  UINTN               CertCount;
-  UINTN               DbxDataSize;
-  UINT8               *DbxData;
   EFI_TIME            RevocationTime;
 
-  Data         = NULL;
   CertList     = NULL;
   CertData     = NULL;
   RootCert     = NULL;
-  DbxData      = NULL;
   RootCertSize = 0;
   VerifyStatus = FALSE;
 
@@ -1472,21 +1096,9 @@ IsAllowedByDb (
   // Fetch 'db' content. If 'db' doesn't exist or encounters problem to get the
   // data, return not-allowed-by-db (FALSE).
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    return VerifyStatus;
-  }
-
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return VerifyStatus;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
+  Status = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE, &Db);
   if (EFI_ERROR (Status)) {
-    goto Done;
+    return VerifyStatus;
   }
 
   //
@@ -1494,116 +1106,78 @@ IsAllowedByDb (
   // If any other errors occurred, no need to check 'db' but just return
   // not-allowed-by-db (FALSE) to avoid bypass.
   //
-  DbxDataSize = 0;
-  Status      = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  Status = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1, &Dbx);
+  if (EFI_ERROR (Status)) {
     if (Status != EFI_NOT_FOUND) {
-      goto Done;
+      return VerifyStatus;
     }
 
     //
     // 'dbx' does not exist. Continue to check 'db'.
     //
-  } else {
-    //
-    // 'dbx' exists. Get its content.
-    //
-    DbxData = (UINT8 *)AllocateZeroPool (DbxDataSize);
-    if (DbxData == NULL) {
-      goto Done;
-    }
-
-    Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, (VOID *)DbxData);
-    if (EFI_ERROR (Status)) {
-      goto Done;
-    }
+    Dbx = NULL;
   }
 
   //
   // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
   //
-  CertList = (EFI_SIGNATURE_LIST *)Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-      CertData  = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-      for (Index = 0; Index < CertCount; Index++) {
-        //
-        // Iterate each Signature Data Node within this CertList for verify.
-        //
-        RootCert     = CertData->SignatureData;
-        RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
+  for (Index = 0; Index < Db->CertCount; Index++) {
+    CertList     = Db->Certs[Index].List;
+    CertData     = Db->Certs[Index].Data;
+    RootCert     = CertData->SignatureData;
+    RootCertSize = Db->Certs[Index].DataSize;
 
+    //
+    // Call AuthenticodeVerify library to Verify Authenticode struct.
+    //
+    VerifyStatus = AuthenticodeVerify (
+                     AuthData,
+                     AuthDataSize,
+                     RootCert,
+                     RootCertSize,
+                     mImageDigest,
+                     mImageDigestSize
+                     );
+    if (VerifyStatus) {
+      //
+      // The image is signed and its signature is found in 'db'.
+      //
+      if (Dbx != NULL) {
         //
-        // Call AuthenticodeVerify library to Verify Authenticode struct.
+        // Here We still need to check if this RootCert's Hash is revoked
         //
-        VerifyStatus = AuthenticodeVerify (
-                         AuthData,
-                         AuthDataSize,
-                         RootCert,
-                         RootCertSize,
-                         mImageDigest,
-                         mImageDigestSize
-                         );
-        if (VerifyStatus) {
+        Status = IsCertHashFoundInDbx (RootCert, RootCertSize, Dbx, &RevocationTime, &IsFound);
+        if (EFI_ERROR (Status)) {
           //
-          // The image is signed and its signature is found in 'db'.
+          // Error in searching dbx. Consider it as 'found'. RevocationTime might
+          // not be valid in such situation.
           //
-          if (DbxData != NULL) {
-            //
-            // Here We still need to check if this RootCert's Hash is revoked
-            //
-            Status = IsCertHashFoundInDbx (RootCert, RootCertSize, (EFI_SIGNATURE_LIST *)DbxData, DbxDataSize, &RevocationTime, &IsFound);
-            if (EFI_ERROR (Status)) {
-              //
-              // Error in searching dbx. Consider it as 'found'. RevocationTime might
-              // not be valid in such situation.
-              //
-              VerifyStatus = FALSE;
-            } else if (IsFound) {
-              //
-              // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
-              //
-              VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &RevocationTime);
-              if (!VerifyStatus) {
-                DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
-              }
-            }
-          }
-
+          VerifyStatus = FALSE;
+        } else if (IsFound) {
           //
-          // There's no 'dbx' to check revocation time against (must-be pass),
-          // or, there's revocation time found in 'dbx' and checked againt 'dbt'
-          // (maybe pass or fail, depending on timestamp compare result). Either
-          // way the verification job has been completed at this point.
+          // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
           //
-          goto Done;
+          VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &RevocationTime);
+          if (!VerifyStatus) {
+            DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
+          }
         }
-
-        CertData = (EFI_SIGNATURE_DATA *)((UINT8 *)CertData + CertList->SignatureSize);
       }
-    }
 
-    DataSize -= CertList->SignatureListSize;
-    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+      //
+      // There's no 'dbx' to check revocation time against (must-be pass),
+      // or, there's revocation time found in 'dbx' and checked againt 'dbt'
+      // (maybe pass or fail, depending on timestamp compare result). Either
+      // way the verification job has been completed at this point.
+      //
+      break;
+    }
   }
 
-Done:
-
   if (VerifyStatus) {
     SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, CertData);
   }
 
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
-  if (DbxData != NULL) {
-    FreePool (DbxData);
-  }
-
   return VerifyStatus;
 }
 
@@ -1776,8 +1350,9 @@ DxeImageVerificationHandler (
     return EFI_ACCESS_DENIED;
   }
 
-  mImageBase = (UINT8 *)FileBuffer;
-  mImageSize = FileSize;
+  mImageBase         = (UINT8 *)FileBuffer;
+  mImageSize         = FileSize;
+  mImageDigestsValid = 0;
 
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *)FileBuffer;
@@ -1844,6 +1419,11 @@ DxeImageVerificationHandler (
     // This image is not signed. The hash value of the image must match a record in the security database "db",
     // and not be reflected in the security data base "dbx".
     //
+    // Hash the image with all the supported algorithms at once, instead of
+    // walking it once per algorithm below.
+    //
+    HashPeImageDigests (HASHALG_MASK (HASHALG_MAX) - 1);
+
     HashAlg = sizeof (mHash) / sizeof (HASH_TABLE);
     while (HashAlg > 0) {
       HashAlg--;
@@ -32,6 +32,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/AuthenticatedVariableFormat.h>
 #include <IndustryStandard/PeImage.h>
 
+#include "SignatureDatabase.h"
+
 #define EFI_CERT_TYPE_RSA2048_SHA256_SIZE  256
 #define EFI_CERT_TYPE_RSA2048_SIZE         256
 #define MAX_NOTIFY_STRING_LEN              64
@@ -69,6 +71,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HASHALG_SHA512  0x00000004
 #define HASHALG_MAX     0x00000005
 
+#define HASHALG_MASK(HashAlg)  ((UINT32)1 << (HashAlg))
+
+//
+// The image is hashed with several algorithms by chunks of this size, which
+// stay in the cache between the algorithms.
+//
+#define HASH_CHUNK_SIZE  SIZE_64KB
+
 //
 // Set max digest size as SHA512 Output (64 bytes) by far
 //
@@ -195,4 +205,34 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+//
+// PE/COFF image being verified, and its Authenticode digests.
+//
+extern EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION  mNtHeader;
+extern UINT32                               mPeCoffHeaderOffset;
+extern UINTN                                mImageSize;
+extern UINT8                                *mImageBase;
+extern UINT8                                mImageDigests[HASHALG_MAX][MAX_DIGEST_SIZE];
+extern UINT32                               mImageDigestsValid;
+extern HASH_TABLE                           mHash[HASHALG_MAX];
+
+/**
+  Calculate hash of Pe/Coff image based on the authenticode image hashing in
+  PE/COFF Specification 8.0 Appendix A
+
+  Caution: This function may receive untrusted input.
+  PE/COFF image is external input, so this function will validate its data structure
+  within this image buffer before use.
+
+  @param[in]    HashAlgMask   Mask of HASHALG_MASK() of the hash algorithms.
+
+  @retval TRUE            Successfully hash image with all the algorithms.
+  @retval FALSE           Fail in hash image with at least one algorithm.
+
+**/
+BOOLEAN
+HashPeImageDigests (
+  IN  UINT32  HashAlgMask
+  );
+
 #endif
@@ -0,0 +1,241 @@
+/** @file
+  Tests for the Authenticode hashing of PeImageHash.c.
+
+  A PE32+ image whose sections are not in file order, with a section larger
+  than HASH_CHUNK_SIZE, extra data and a certificate table is hashed, and the
+  digests are checked against known vectors. The vectors were computed apart
+  from this code, by hashing the ranges listed in the PE/COFF Specification 8.0
+  Appendix A with the hash tools of the host.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <vector>
+
+extern "C" {
+  #include "../DxeImageVerificationLib.h"
+}
+
+using namespace testing;
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_PE_HEADER_OFFSET  0x80
+#define TEST_SIZE_OF_HEADERS   0x400
+#define TEST_TEXT_OFFSET       0x400
+#define TEST_TEXT_SIZE         0x11000
+#define TEST_DATA_OFFSET       0x11400
+#define TEST_DATA_SIZE         0x200
+#define TEST_EXTRA_SIZE        0x100
+#define TEST_CERT_OFFSET       (TEST_DATA_OFFSET + TEST_DATA_SIZE + TEST_EXTRA_SIZE)
+#define TEST_CERT_SIZE         0x20
+#define TEST_IMAGE_SIZE        (TEST_CERT_OFFSET + TEST_CERT_SIZE)
+
+#ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+#define TEST_SHA1_HASHALG_MASK  HASHALG_MASK (HASHALG_SHA1)
+#else
+#define TEST_SHA1_HASHALG_MASK  0
+#endif
+
+#define TEST_ALL_HASHALG_MASK  (TEST_SHA1_HASHALG_MASK | HASHALG_MASK (HASHALG_SHA256) |\
+                                HASHALG_MASK (HASHALG_SHA384) | HASHALG_MASK (HASHALG_SHA512))
+
+////////////////////////////////////////////////////////////////////////
+// Known Authenticode digests of the test image
+////////////////////////////////////////////////////////////////////////
+static CONST UINT8  mSha1Digest[] = {
+  0x57, 0x3d, 0x9b, 0xd6, 0x74, 0x2a, 0xb4, 0xcc, 0xb4, 0xbe, 0x90, 0x86,
+  0x4b, 0xf4, 0x12, 0x01, 0x0f, 0xe1, 0x05, 0x45,
+};
+
+static CONST UINT8  mSha256Digest[] = {
+  0xcb, 0x1a, 0xed, 0x71, 0x23, 0x1a, 0xc2, 0x07, 0xa3, 0xc8, 0x46, 0xa2,
+  0xef, 0xef, 0x10, 0xf4, 0x7d, 0x6a, 0x3a, 0x49, 0x7a, 0x3b, 0x2b, 0xf7,
+  0xdb, 0x20, 0x02, 0x52, 0x04, 0xa5, 0x81, 0x5d,
+};
+
+static CONST UINT8  mSha384Digest[] = {
+  0xfd, 0x6a, 0x2a, 0xca, 0x85, 0xd4, 0xc0, 0x51, 0x12, 0x5c, 0xb9, 0x93,
+  0x6e, 0xab, 0x4e, 0xc3, 0xa1, 0x5b, 0x0f, 0xfa, 0xeb, 0xad, 0xed, 0xf4,
+  0x85, 0x08, 0x36, 0x06, 0xe3, 0x8b, 0x6f, 0x6f, 0x16, 0x47, 0x97, 0x25,
+  0xb6, 0x1b, 0x53, 0x0d, 0x14, 0x69, 0xea, 0xa3, 0xea, 0x14, 0xd8, 0xeb,
+};
+
+static CONST UINT8  mSha512Digest[] = {
+  0x4e, 0x21, 0x7a, 0x48, 0xff, 0xfa, 0x66, 0x63, 0xc1, 0x33, 0xc2, 0x1d,
+  0xa7, 0x51, 0x3f, 0xe3, 0xa6, 0xee, 0x9d, 0x68, 0x05, 0x03, 0x56, 0xd0,
+  0xbb, 0x34, 0x69, 0x15, 0xa7, 0x50, 0x99, 0xfd, 0xb7, 0xb0, 0x84, 0x30,
+  0xd6, 0xe3, 0x9e, 0x4e, 0x09, 0xeb, 0x8f, 0x99, 0x31, 0x19, 0x73, 0xf9,
+  0xf7, 0x24, 0x26, 0xbf, 0x99, 0x7f, 0xb6, 0x38, 0xc6, 0xa0, 0x82, 0x76,
+  0xb8, 0x1b, 0xbb, 0xec,
+};
+
+class PeImageHashTest : public Test {
+protected:
+  std::vector<UINT8>  Image;
+
+  //
+  // Build the test image: the .data section header comes before the .text
+  // one but its raw data follows it, and every byte not part of a header is
+  // filled with a pattern depending on its offset.
+  //
+  void
+  SetUp (
+    ) override
+  {
+    EFI_IMAGE_DOS_HEADER      *DosHdr;
+    EFI_IMAGE_NT_HEADERS64    *NtHdr;
+    EFI_IMAGE_SECTION_HEADER  *Section;
+    UINTN                     Index;
+
+    Image.resize (TEST_IMAGE_SIZE);
+    for (Index = 0; Index < Image.size (); Index++) {
+      Image[Index] = (UINT8)(Index * 7 + 3);
+    }
+
+    ZeroMem (Image.data (), TEST_SIZE_OF_HEADERS);
+    DosHdr           = (EFI_IMAGE_DOS_HEADER *)Image.data ();
+    DosHdr->e_magic  = EFI_IMAGE_DOS_SIGNATURE;
+    DosHdr->e_lfanew = TEST_PE_HEADER_OFFSET;
+
+    NtHdr                                  = (EFI_IMAGE_NT_HEADERS64 *)(Image.data () + TEST_PE_HEADER_OFFSET);
+    NtHdr->Signature                       = EFI_IMAGE_NT_SIGNATURE;
+    NtHdr->FileHeader.Machine              = IMAGE_FILE_MACHINE_X64;
+    NtHdr->FileHeader.NumberOfSections     = 2;
+    NtHdr->FileHeader.SizeOfOptionalHeader = sizeof (EFI_IMAGE_OPTIONAL_HEADER64);
+    NtHdr->FileHeader.Characteristics      = EFI_IMAGE_FILE_EXECUTABLE_IMAGE | EFI_IMAGE_FILE_LARGE_ADDRESS_AWARE;
+    NtHdr->OptionalHeader.Magic            = EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    NtHdr->OptionalHeader.SizeOfHeaders    = TEST_SIZE_OF_HEADERS;
+    NtHdr->OptionalHeader.CheckSum         = 0x12345678;
+
+    NtHdr->OptionalHeader.NumberOfRvaAndSizes                                               = EFI_IMAGE_NUMBER_OF_DIRECTORY_ENTRIES;
+    NtHdr->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].VirtualAddress = TEST_CERT_OFFSET;
+    NtHdr->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size           = TEST_CERT_SIZE;
+
+    Section = (EFI_IMAGE_SECTION_HEADER *)(NtHdr + 1);
+    CopyMem (Section[0].Name, ".data", sizeof (".data"));
+    Section[0].Misc.VirtualSize = TEST_DATA_SIZE;
+    Section[0].VirtualAddress   = 0x12000;
+    Section[0].SizeOfRawData    = TEST_DATA_SIZE;
+    Section[0].PointerToRawData = TEST_DATA_OFFSET;
+    CopyMem (Section[1].Name, ".text", sizeof (".text"));
+    Section[1].Misc.VirtualSize = TEST_TEXT_SIZE;
+    Section[1].VirtualAddress   = 0x1000;
+    Section[1].SizeOfRawData    = TEST_TEXT_SIZE;
+    Section[1].PointerToRawData = TEST_TEXT_OFFSET;
+
+    //
+    // Make it the current image, as DxeImageVerificationHandler() does.
+    //
+    mImageBase          = Image.data ();
+    mImageSize          = Image.size ();
+    mPeCoffHeaderOffset = TEST_PE_HEADER_OFFSET;
+    mNtHeader.Pe32      = (EFI_IMAGE_NT_HEADERS32 *)NtHdr;
+    mImageDigestsValid  = 0;
+  }
+
+  void
+  ExpectDigest (
+    UINT32       HashAlg,
+    CONST UINT8  *Digest,
+    UINTN        DigestSize
+    )
+  {
+    EXPECT_NE (mImageDigestsValid & HASHALG_MASK (HashAlg), 0U) << "HashAlg " << HashAlg;
+    EXPECT_EQ (DigestSize, mHash[HashAlg].DigestLength);
+    EXPECT_EQ (CompareMem (mImageDigests[HashAlg], Digest, DigestSize), 0) << "HashAlg " << HashAlg;
+  }
+
+  void
+  ExpectKnownDigests (
+    UINT32  HashAlgMask
+    )
+  {
+    if ((HashAlgMask & TEST_SHA1_HASHALG_MASK) != 0) {
+      ExpectDigest (HASHALG_SHA1, mSha1Digest, sizeof (mSha1Digest));
+    }
+
+    if ((HashAlgMask & HASHALG_MASK (HASHALG_SHA256)) != 0) {
+      ExpectDigest (HASHALG_SHA256, mSha256Digest, sizeof (mSha256Digest));
+    }
+
+    if ((HashAlgMask & HASHALG_MASK (HASHALG_SHA384)) != 0) {
+      ExpectDigest (HASHALG_SHA384, mSha384Digest, sizeof (mSha384Digest));
+    }
+
+    if ((HashAlgMask & HASHALG_MASK (HASHALG_SHA512)) != 0) {
+      ExpectDigest (HASHALG_SHA512, mSha512Digest, sizeof (mSha512Digest));
+    }
+  }
+};
+
+TEST_F (PeImageHashTest, AllAlgorithmsInOnePass) {
+  EXPECT_TRUE (HashPeImageDigests (TEST_ALL_HASHALG_MASK));
+  ExpectKnownDigests (TEST_ALL_HASHALG_MASK);
+}
+
+TEST_F (PeImageHashTest, EachAlgorithmAlone) {
+  UINT32  HashAlg;
+
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if ((TEST_ALL_HASHALG_MASK & HASHALG_MASK (HashAlg)) == 0) {
+      continue;
+    }
+
+    mImageDigestsValid = 0;
+    EXPECT_TRUE (HashPeImageDigests (HASHALG_MASK (HashAlg)));
+    EXPECT_EQ (mImageDigestsValid, HASHALG_MASK (HashAlg));
+    ExpectKnownDigests (HASHALG_MASK (HashAlg));
+  }
+}
+
+TEST_F (PeImageHashTest, UnsupportedAlgorithmFails) {
+  //
+  // BaseCryptLib has no SHA-224, but the other digests are still computed.
+  //
+  EXPECT_FALSE (HashPeImageDigests (HASHALG_MASK (HASHALG_MAX) - 1));
+  EXPECT_EQ (mImageDigestsValid & HASHALG_MASK (HASHALG_SHA224), 0U);
+  ExpectKnownDigests (TEST_ALL_HASHALG_MASK);
+}
+
+TEST_F (PeImageHashTest, DigestsAreKeptUntilTheNextImage) {
+  EXPECT_TRUE (HashPeImageDigests (HASHALG_MASK (HASHALG_SHA256)));
+
+  //
+  // Known digests are not computed again, so changing the image does not
+  // change them, while the others reflect the change.
+  //
+  Image[TEST_TEXT_OFFSET] ^= 0xFF;
+  EXPECT_TRUE (HashPeImageDigests (HASHALG_MASK (HASHALG_SHA256) | HASHALG_MASK (HASHALG_SHA384)));
+  ExpectKnownDigests (HASHALG_MASK (HASHALG_SHA256));
+  EXPECT_NE (CompareMem (mImageDigests[HASHALG_SHA384], mSha384Digest, sizeof (mSha384Digest)), 0);
+
+  Image[TEST_TEXT_OFFSET] ^= 0xFF;
+  mImageDigestsValid = 0;
+  EXPECT_TRUE (HashPeImageDigests (HASHALG_MASK (HASHALG_SHA384)));
+  ExpectKnownDigests (HASHALG_MASK (HASHALG_SHA384));
+}
+
+TEST_F (PeImageHashTest, ChecksumAndCertificateAreExcluded) {
+  EFI_IMAGE_NT_HEADERS64  *NtHdr;
+
+  NtHdr                           = (EFI_IMAGE_NT_HEADERS64 *)(Image.data () + TEST_PE_HEADER_OFFSET);
+  NtHdr->OptionalHeader.CheckSum ^= 0xFFFFFFFF;
+  Image[TEST_CERT_OFFSET]        ^= 0xFF;
+
+  EXPECT_TRUE (HashPeImageDigests (TEST_ALL_HASHALG_MASK));
+  ExpectKnownDigests (TEST_ALL_HASHALG_MASK);
+}
+
+TEST_F (PeImageHashTest, CertificateBeyondImageFails) {
+  EFI_IMAGE_NT_HEADERS64  *NtHdr;
+
+  NtHdr = (EFI_IMAGE_NT_HEADERS64 *)(Image.data () + TEST_PE_HEADER_OFFSET);
+  NtHdr->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size = TEST_EXTRA_SIZE + TEST_CERT_SIZE + 1;
+
+  EXPECT_FALSE (HashPeImageDigests (HASHALG_MASK (HASHALG_SHA256)));
+  EXPECT_EQ (mImageDigestsValid, 0U);
+}
@@ -0,0 +1,406 @@
+/** @file
+  Tests for the parsed copy of the image signature databases of
+  SignatureDatabase.c.
+
+  Besides the unit tests of the lookups and of the rebuild of the index when
+  the variable changes, a micro-benchmark measures the signature database
+  lookups done for one unsigned image, against walking the variable.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <GoogleTest/Library/MockUefiRuntimeServicesTableLib.h>
+#include <chrono>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Guid/ImageAuthentication.h>
+  #include "../SignatureDatabase.h"
+}
+
+using namespace testing;
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_DIGEST_SIZE     32
+#define TEST_DBX_HASH_COUNT  1024
+#define TEST_DB_HASH_COUNT   64
+#define TEST_BENCHMARK_RUN   2000
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// The content of the db and dbx variables served by gRT->GetVariable()
+////////////////////////////////////////////////////////////////////////
+static std::vector<UINT8>  mDb;
+static std::vector<UINT8>  mDbx;
+
+static
+EFI_STATUS
+EFIAPI
+HostGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data OPTIONAL
+  )
+{
+  std::vector<UINT8>  *Variable;
+
+  if (!CompareGuid (VendorGuid, &gEfiImageSecurityDatabaseGuid)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (StrCmp (VariableName, (CHAR16 *)EFI_IMAGE_SECURITY_DATABASE) == 0) {
+    Variable = &mDb;
+  } else if (StrCmp (VariableName, (CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1) == 0) {
+    Variable = &mDbx;
+  } else {
+    return EFI_NOT_FOUND;
+  }
+
+  if (Variable->empty ()) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (*DataSize < Variable->size ()) {
+    *DataSize = Variable->size ();
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DataSize = Variable->size ();
+  CopyMem (Data, Variable->data (), Variable->size ());
+  return EFI_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+//
+// Fill the data of the signature Seed of a signature list.
+//
+static
+VOID
+FillSignature (
+  OUT UINT8   *Data,
+  IN  UINTN   Size,
+  IN  UINT32  Seed
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Seed        = Seed * 1103515245 + 12345;
+    Data[Index] = (UINT8)(Seed >> 16);
+  }
+}
+
+//
+// Append a signature list of Count signatures of DataSize bytes, the data of
+// the signature Index being FillSignature (FirstSeed + Index).
+//
+static
+VOID
+AppendSignatureList (
+  IN OUT std::vector<UINT8>  &Variable,
+  IN     EFI_GUID            *SignatureType,
+  IN     UINTN               DataSize,
+  IN     UINTN               Count,
+  IN     UINT32              FirstSeed,
+  IN     UINT8               Owner = 0
+  )
+{
+  EFI_SIGNATURE_LIST  *List;
+  EFI_SIGNATURE_DATA  *Data;
+  UINTN               Offset;
+  UINTN               SignatureSize;
+  UINTN               Index;
+
+  SignatureSize = sizeof (EFI_GUID) + DataSize;
+  Offset        = Variable.size ();
+  Variable.resize (Offset + sizeof (EFI_SIGNATURE_LIST) + Count * SignatureSize);
+
+  List = (EFI_SIGNATURE_LIST *)&Variable[Offset];
+  CopyGuid (&List->SignatureType, SignatureType);
+  List->SignatureListSize   = (UINT32)(sizeof (EFI_SIGNATURE_LIST) + Count * SignatureSize);
+  List->SignatureHeaderSize = 0;
+  List->SignatureSize       = (UINT32)SignatureSize;
+
+  for (Index = 0; Index < Count; Index++) {
+    Data = (EFI_SIGNATURE_DATA *)((UINT8 *)(List + 1) + Index * SignatureSize);
+    SetMem (&Data->SignatureOwner, sizeof (EFI_GUID), Owner);
+    FillSignature (Data->SignatureData, DataSize, FirstSeed + (UINT32)Index);
+  }
+}
+
+//
+// Look up a signature the way IsSignatureFoundInDatabase() did before the
+// index: read the variable and walk all its signature lists.
+//
+static
+BOOLEAN
+WalkDatabase (
+  IN CHAR16    *VariableName,
+  IN UINT8     *Signature,
+  IN EFI_GUID  *CertType,
+  IN UINTN     SignatureSize
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINTN               DataSize;
+  UINT8               *Data;
+  UINTN               Index;
+  UINTN               CertCount;
+  BOOLEAN             IsFound;
+
+  IsFound  = FALSE;
+  DataSize = 0;
+  if (gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL) != EFI_BUFFER_TOO_SMALL) {
+    return FALSE;
+  }
+
+  Data = (UINT8 *)AllocateZeroPool (DataSize);
+  gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
+
+  CertList = (EFI_SIGNATURE_LIST *)Data;
+  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize) && !IsFound) {
+    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    if ((CertList->SignatureSize == sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid (&CertList->SignatureType, CertType))) {
+      for (Index = 0; Index < CertCount; Index++) {
+        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
+          IsFound = TRUE;
+          break;
+        }
+
+        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+      }
+    }
+
+    DataSize -= CertList->SignatureListSize;
+    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+
+  FreePool (Data);
+  return IsFound;
+}
+
+////////////////////////////////////////////////////////////////////////
+// SignatureDatabaseTest Tests
+////////////////////////////////////////////////////////////////////////
+class SignatureDatabaseTest : public Test {
+protected:
+  MockUefiRuntimeServicesTableLib RtServicesMock;
+  SIGNATURE_DATABASE *Database;
+  UINT8 Digest[TEST_DIGEST_SIZE];
+
+  void
+  SetUp (
+    ) override
+  {
+    mDb.clear ();
+    mDbx.clear ();
+    Database = NULL;
+    EXPECT_CALL (RtServicesMock, gRT_GetVariable)
+      .WillRepeatedly (Invoke (HostGetVariable));
+  }
+};
+
+// A missing database is reported as such.
+TEST_F (SignatureDatabaseTest, MissingDatabase) {
+  EXPECT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_NOT_FOUND);
+  EXPECT_EQ (GetSignatureDatabase ((CHAR16 *)L"dbt", &Database), EFI_UNSUPPORTED);
+}
+
+// Every signature of the database is found, and no other.
+TEST_F (SignatureDatabaseTest, FindHashes) {
+  EFI_SIGNATURE_LIST  *List;
+  UINT32              Index;
+
+  AppendSignatureList (mDbx, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 100, 0);
+  AppendSignatureList (mDbx, &gEfiCertX509Guid, 500, 1, 1000);
+  AppendSignatureList (mDbx, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 100, 100);
+
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_SUCCESS);
+  EXPECT_EQ (Database->IndexCount, 201U);
+
+  for (Index = 0; Index < 200; Index++) {
+    FillSignature (Digest, sizeof (Digest), Index);
+    List = NULL;
+    ASSERT_NE (SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, &List), nullptr);
+    EXPECT_TRUE (CompareGuid (&List->SignatureType, &gEfiCertSha256Guid));
+  }
+
+  FillSignature (Digest, sizeof (Digest), 200);
+  EXPECT_EQ (SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, NULL), nullptr);
+
+  //
+  // Same data, other type or size.
+  //
+  FillSignature (Digest, sizeof (Digest), 0);
+  EXPECT_EQ (SignatureDatabaseFind (Database, &gEfiCertSha384Guid, Digest, sizeof (Digest), FALSE, NULL), nullptr);
+  EXPECT_EQ (SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest) - 1, FALSE, NULL), nullptr);
+}
+
+// A signature found several times is the first of the variable.
+TEST_F (SignatureDatabaseTest, FirstMatchInVariableOrder) {
+  EFI_SIGNATURE_DATA  *Data;
+
+  AppendSignatureList (mDb, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 10, 0, 0x11);
+  AppendSignatureList (mDb, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 10, 5, 0x22);
+
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE, &Database), EFI_SUCCESS);
+
+  FillSignature (Digest, sizeof (Digest), 7);
+  Data = SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, NULL);
+  ASSERT_NE (Data, nullptr);
+  EXPECT_EQ (((UINT8 *)&Data->SignatureOwner)[0], 0x11);
+
+  FillSignature (Digest, sizeof (Digest), 12);
+  Data = SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, NULL);
+  ASSERT_NE (Data, nullptr);
+  EXPECT_EQ (((UINT8 *)&Data->SignatureOwner)[0], 0x22);
+}
+
+// The certificate hashes are matched on their digest, followed by the
+// revocation time.
+TEST_F (SignatureDatabaseTest, FindCertificateHashPrefix) {
+  EFI_SIGNATURE_DATA  *Data;
+  EFI_SIGNATURE_DATA  *Expected;
+
+  AppendSignatureList (mDbx, &gEfiCertX509Sha256Guid, TEST_DIGEST_SIZE + sizeof (EFI_TIME), 20, 0);
+
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_SUCCESS);
+  EXPECT_TRUE (SignatureDatabaseHasType (Database, &gEfiCertX509Sha256Guid));
+  EXPECT_FALSE (SignatureDatabaseHasType (Database, &gEfiCertX509Sha384Guid));
+
+  //
+  // The digest of the signature 3 is the beginning of its data.
+  //
+  Expected = (EFI_SIGNATURE_DATA *)(mDbx.data () + sizeof (EFI_SIGNATURE_LIST) + 3 * (sizeof (EFI_GUID) + TEST_DIGEST_SIZE + sizeof (EFI_TIME)));
+  CopyMem (Digest, Expected->SignatureData, sizeof (Digest));
+
+  Data = SignatureDatabaseFind (Database, &gEfiCertX509Sha256Guid, Digest, sizeof (Digest), TRUE, NULL);
+  ASSERT_NE (Data, nullptr);
+  EXPECT_EQ (CompareMem (Data, Expected, sizeof (EFI_GUID) + TEST_DIGEST_SIZE + sizeof (EFI_TIME)), 0);
+  EXPECT_EQ (SignatureDatabaseFind (Database, &gEfiCertX509Sha256Guid, Digest, sizeof (Digest), FALSE, NULL), nullptr);
+}
+
+// The X.509 certificates are listed in the order of the variable.
+TEST_F (SignatureDatabaseTest, CertificatesInVariableOrder) {
+  AppendSignatureList (mDb, &gEfiCertX509Guid, 700, 1, 0);
+  AppendSignatureList (mDb, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 4, 10);
+  AppendSignatureList (mDb, &gEfiCertX509Guid, 300, 2, 1);
+
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE, &Database), EFI_SUCCESS);
+  ASSERT_EQ (Database->CertCount, 3U);
+  EXPECT_EQ (Database->Certs[0].DataSize, 700U);
+  EXPECT_EQ (Database->Certs[1].DataSize, 300U);
+  EXPECT_EQ (Database->Certs[2].DataSize, 300U);
+  EXPECT_LT ((UINTN)Database->Certs[0].Data, (UINTN)Database->Certs[1].Data);
+  EXPECT_LT ((UINTN)Database->Certs[1].Data, (UINTN)Database->Certs[2].Data);
+}
+
+// A change of the variable, even of the same size, rebuilds the index.
+TEST_F (SignatureDatabaseTest, RebuildOnChange) {
+  UINT8  *Data;
+
+  AppendSignatureList (mDbx, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 10, 0);
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_SUCCESS);
+  Data = Database->Data;
+
+  //
+  // Unchanged: the copy the index was built from is kept.
+  //
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_SUCCESS);
+  EXPECT_EQ (Database->Data, Data);
+
+  //
+  // Replace the signature 4 with the signature 10.
+  //
+  FillSignature (mDbx.data () + sizeof (EFI_SIGNATURE_LIST) + 4 * (sizeof (EFI_GUID) + TEST_DIGEST_SIZE) + sizeof (EFI_GUID), TEST_DIGEST_SIZE, 10);
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_SUCCESS);
+  EXPECT_NE (Database->Data, Data);
+
+  FillSignature (Digest, sizeof (Digest), 4);
+  EXPECT_EQ (SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, NULL), nullptr);
+  FillSignature (Digest, sizeof (Digest), 10);
+  EXPECT_NE (SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, NULL), nullptr);
+
+  //
+  // Deleted.
+  //
+  mDbx.clear ();
+  EXPECT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_NOT_FOUND);
+}
+
+// The walk stops at a malformed signature list.
+TEST_F (SignatureDatabaseTest, MalformedSignatureList) {
+  EFI_SIGNATURE_LIST  *List;
+
+  AppendSignatureList (mDb, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 3, 0);
+  AppendSignatureList (mDb, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, 3, 3);
+  List                = (EFI_SIGNATURE_LIST *)(mDb.data () + sizeof (EFI_SIGNATURE_LIST) + 3 * (sizeof (EFI_GUID) + TEST_DIGEST_SIZE));
+  List->SignatureSize = 0;
+
+  ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE, &Database), EFI_SUCCESS);
+  EXPECT_EQ (Database->IndexCount, 3U);
+}
+
+// The lookups of one unsigned image: its SHA-256 hash is searched in dbx,
+// then in db.
+TEST_F (SignatureDatabaseTest, BenchmarkImageLookup) {
+  std::chrono::steady_clock::time_point  Start;
+  std::chrono::nanoseconds               Walk;
+  std::chrono::nanoseconds               Indexed;
+  UINT32                                 Index;
+  BOOLEAN                                IsFound;
+
+  AppendSignatureList (mDbx, &gEfiCertX509Sha256Guid, TEST_DIGEST_SIZE + sizeof (EFI_TIME), 16, 100000);
+  AppendSignatureList (mDbx, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, TEST_DBX_HASH_COUNT, 0);
+  AppendSignatureList (mDb, &gEfiCertX509Guid, 1500, 2, 200000);
+  AppendSignatureList (mDb, &gEfiCertSha256Guid, TEST_DIGEST_SIZE, TEST_DB_HASH_COUNT, TEST_DBX_HASH_COUNT);
+
+  //
+  // The images are allowed by the last hash of db.
+  //
+  FillSignature (Digest, sizeof (Digest), TEST_DBX_HASH_COUNT + TEST_DB_HASH_COUNT - 1);
+
+  Start = std::chrono::steady_clock::now ();
+  for (Index = 0; Index < TEST_BENCHMARK_RUN; Index++) {
+    IsFound = WalkDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, Digest, &gEfiCertSha256Guid, sizeof (Digest));
+    ASSERT_FALSE (IsFound);
+    IsFound = WalkDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE, Digest, &gEfiCertSha256Guid, sizeof (Digest));
+    ASSERT_TRUE (IsFound);
+  }
+
+  Walk = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now () - Start);
+
+  Start = std::chrono::steady_clock::now ();
+  for (Index = 0; Index < TEST_BENCHMARK_RUN; Index++) {
+    ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE1, &Database), EFI_SUCCESS);
+    ASSERT_EQ (SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, NULL), nullptr);
+    ASSERT_EQ (GetSignatureDatabase ((CHAR16 *)EFI_IMAGE_SECURITY_DATABASE, &Database), EFI_SUCCESS);
+    ASSERT_NE (SignatureDatabaseFind (Database, &gEfiCertSha256Guid, Digest, sizeof (Digest), FALSE, NULL), nullptr);
+  }
+
+  Indexed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now () - Start);
+
+  RecordProperty ("WalkNsPerImage", (int)(Walk.count () / TEST_BENCHMARK_RUN));
+  RecordProperty ("IndexedNsPerImage", (int)(Indexed.count () / TEST_BENCHMARK_RUN));
+  printf (
+    "Image lookup in db/dbx of %d hashes: walk %.1f ns, indexed %.1f ns\n",
+    TEST_DBX_HASH_COUNT + TEST_DB_HASH_COUNT,
+    (double)Walk.count () / TEST_BENCHMARK_RUN,
+    (double)Indexed.count () / TEST_BENCHMARK_RUN
+    );
+}
@@ -0,0 +1,414 @@
+/** @file
+  Authenticode hashing of the PE/COFF image being verified by ImageVerificationLib.
+
+  Caution: This file requires additional review when modified.
+  This library will have external input - PE/COFF image.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+  HashPeImageDigests() function will accept untrusted PE/COFF image and validate
+  its data structure within this image buffer before use.
+
+Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+//
+// Caution: This is used by a function which may receive untrusted input.
+// These global variables hold PE/COFF image data, and they should be validated before use.
+//
+EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION  mNtHeader;
+UINT32                               mPeCoffHeaderOffset;
+
+//
+// Information on current PE/COFF image
+//
+UINTN  mImageSize;
+UINT8  *mImageBase = NULL;
+
+//
+// Authenticode digests of current PE/COFF image, indexed by hash algorithm,
+// and the HASHALG_MASK() of the valid ones.
+//
+UINT8   mImageDigests[HASHALG_MAX][MAX_DIGEST_SIZE];
+UINT32  mImageDigestsValid;
+
+//
+// OID ASN.1 Value for Hash Algorithms
+//
+UINT8  mHashOidValue[] = {
+  0x2B, 0x0E, 0x03, 0x02, 0x1A,                         // OBJ_sha1
+  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x04, // OBJ_sha224
+  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, // OBJ_sha256
+  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, // OBJ_sha384
+  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, // OBJ_sha512
+};
+
+HASH_TABLE  mHash[HASHALG_MAX] = {
+ #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+  { L"SHA1",   20, &mHashOidValue[0],  5, Sha1GetContextSize,   Sha1Init,   Sha1Update,   Sha1Final   },
+ #else
+  { L"SHA1",   20, &mHashOidValue[0],  5, NULL,                 NULL,       NULL,         NULL        },
+ #endif
+  { L"SHA224", 28, &mHashOidValue[5],  9, NULL,                 NULL,       NULL,         NULL        },
+  { L"SHA256", 32, &mHashOidValue[14], 9, Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final },
+  { L"SHA384", 48, &mHashOidValue[23], 9, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final },
+  { L"SHA512", 64, &mHashOidValue[32], 9, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final }
+};
+
+/**
+  Hash a range of the PE/COFF image with several hash algorithms.
+
+  The range is fed to the hash contexts by chunks of HASH_CHUNK_SIZE, so that
+  each chunk is read from memory once for all the algorithms.
+
+  @param[in]      HashCtx       Hash contexts, indexed by hash algorithm.
+  @param[in, out] ActiveMask    HASHALG_MASK() of the hash algorithms to update.
+                                The algorithms which fail are removed.
+  @param[in]      HashBase      Start of the range.
+  @param[in]      HashSize      Size of the range.
+
+**/
+STATIC
+VOID
+HashPeImageUpdate (
+  IN     VOID    **HashCtx,
+  IN OUT UINT32  *ActiveMask,
+  IN     UINT8   *HashBase,
+  IN     UINTN   HashSize
+  )
+{
+  UINTN   ChunkSize;
+  UINT32  HashAlg;
+
+  while ((HashSize > 0) && (*ActiveMask != 0)) {
+    ChunkSize = MIN (HashSize, HASH_CHUNK_SIZE);
+    for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+      if (((*ActiveMask & HASHALG_MASK (HashAlg)) != 0) &&
+          !mHash[HashAlg].HashUpdate (HashCtx[HashAlg], HashBase, ChunkSize))
+      {
+        *ActiveMask &= ~HASHALG_MASK (HashAlg);
+      }
+    }
+
+    HashBase += ChunkSize;
+    HashSize -= ChunkSize;
+  }
+}
+
+/**
+  Calculate hash of Pe/Coff image based on the authenticode image hashing in
+  PE/COFF Specification 8.0 Appendix A
+
+  Caution: This function may receive untrusted input.
+  PE/COFF image is external input, so this function will validate its data structure
+  within this image buffer before use.
+
+  Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
+  its caller function DxeImageVerificationHandler().
+
+  The image is walked once for all the requested hash algorithms, whose
+  digests are kept in mImageDigests until the next image. Only an unsigned
+  image is looked up in DB/DBX with several algorithms, so it is the only
+  caller asking for more than one. A signed image asks for the algorithm of
+  each of its signatures, which is computed on the first one and reused by
+  the others.
+
+  @param[in]    HashAlgMask   Mask of HASHALG_MASK() of the hash algorithms.
+
+  @retval TRUE            Successfully hash image with all the algorithms.
+  @retval FALSE           Fail in hash image with at least one algorithm.
+
+**/
+BOOLEAN
+HashPeImageDigests (
+  IN  UINT32  HashAlgMask
+  )
+{
+  BOOLEAN                   Status;
+  EFI_IMAGE_SECTION_HEADER  *Section;
+  VOID                      *HashCtx[HASHALG_MAX];
+  UINT32                    HashAlg;
+  UINT32                    ActiveMask;
+  UINT8                     *HashBase;
+  UINTN                     HashSize;
+  UINTN                     SumOfBytesHashed;
+  EFI_IMAGE_SECTION_HEADER  *SectionHeader;
+  UINTN                     Index;
+  UINTN                     Pos;
+  UINT32                    CertSize;
+  UINT32                    NumberOfRvaAndSizes;
+
+  SectionHeader = NULL;
+  Status        = FALSE;
+  ZeroMem (HashCtx, sizeof (HashCtx));
+
+  //
+  // Only hash the image with the algorithms whose digests are not known yet.
+  //
+  ActiveMask = HashAlgMask & ~mImageDigestsValid;
+  if (ActiveMask == 0) {
+    return TRUE;
+  }
+
+  // 1.  Load the image header into memory.
+
+  // 2.  Initialize a SHA hash context for each algorithm.
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if ((ActiveMask & HASHALG_MASK (HashAlg)) == 0) {
+      continue;
+    }
+
+    if ((mHash[HashAlg].GetContextSize == NULL) || (mHash[HashAlg].HashInit == NULL) ||
+        (mHash[HashAlg].HashUpdate == NULL) || (mHash[HashAlg].HashFinal == NULL))
+    {
+      ActiveMask &= ~HASHALG_MASK (HashAlg);
+      continue;
+    }
+
+    HashCtx[HashAlg] = AllocatePool (mHash[HashAlg].GetContextSize ());
+    if ((HashCtx[HashAlg] == NULL) || !mHash[HashAlg].HashInit (HashCtx[HashAlg])) {
+      ActiveMask &= ~HASHALG_MASK (HashAlg);
+    }
+  }
+
+  //
+  // Measuring PE/COFF Image Header;
+  // But CheckSum field and SECURITY data directory (certificate) are excluded
+  //
+
+  //
+  // 3.  Calculate the distance from the base of the image header to the image checksum address.
+  // 4.  Hash the image header from its base to beginning of the image checksum.
+  //
+  HashBase = mImageBase;
+  if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+    //
+    // Use PE32 offset.
+    //
+    HashSize            = (UINTN)(&mNtHeader.Pe32->OptionalHeader.CheckSum) - (UINTN)HashBase;
+    NumberOfRvaAndSizes = mNtHeader.Pe32->OptionalHeader.NumberOfRvaAndSizes;
+  } else if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
+    //
+    // Use PE32+ offset.
+    //
+    HashSize            = (UINTN)(&mNtHeader.Pe32Plus->OptionalHeader.CheckSum) - (UINTN)HashBase;
+    NumberOfRvaAndSizes = mNtHeader.Pe32Plus->OptionalHeader.NumberOfRvaAndSizes;
+  } else {
+    //
+    // Invalid header magic number.
+    //
+    Status = FALSE;
+    goto Done;
+  }
+
+  HashPeImageUpdate (HashCtx, &ActiveMask, HashBase, HashSize);
+
+  //
+  // 5.  Skip over the image checksum (it occupies a single ULONG).
+  //
+  if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
+    //
+    // 6.  Since there is no Cert Directory in optional header, hash everything
+    //     from the end of the checksum to the end of image header.
+    //
+    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+      //
+      // Use PE32 offset.
+      //
+      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
+    } else {
+      //
+      // Use PE32+ offset.
+      //
+      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
+    }
+
+    if (HashSize != 0) {
+      HashPeImageUpdate (HashCtx, &ActiveMask, HashBase, HashSize);
+    }
+  } else {
+    //
+    // 7.  Hash everything from the end of the checksum to the start of the Cert Directory.
+    //
+    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+      //
+      // Use PE32 offset.
+      //
+      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = (UINTN)(&mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
+    } else {
+      //
+      // Use PE32+ offset.
+      //
+      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = (UINTN)(&mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
+    }
+
+    if (HashSize != 0) {
+      HashPeImageUpdate (HashCtx, &ActiveMask, HashBase, HashSize);
+    }
+
+    //
+    // 8.  Skip over the Cert Directory. (It is sizeof(IMAGE_DATA_DIRECTORY) bytes.)
+    // 9.  Hash everything from the end of the Cert Directory to the end of image header.
+    //
+    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+      //
+      // Use PE32 offset
+      //
+      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
+      HashSize = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
+    } else {
+      //
+      // Use PE32+ offset.
+      //
+      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
+      HashSize = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
+    }
+
+    if (HashSize != 0) {
+      HashPeImageUpdate (HashCtx, &ActiveMask, HashBase, HashSize);
+    }
+  }
+
+  //
+  // 10. Set the SUM_OF_BYTES_HASHED to the size of the header.
+  //
+  if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+    //
+    // Use PE32 offset.
+    //
+    SumOfBytesHashed = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders;
+  } else {
+    //
+    // Use PE32+ offset
+    //
+    SumOfBytesHashed = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders;
+  }
+
+  Section = (EFI_IMAGE_SECTION_HEADER *)(
+                                         mImageBase +
+                                         mPeCoffHeaderOffset +
+                                         sizeof (UINT32) +
+                                         sizeof (EFI_IMAGE_FILE_HEADER) +
+                                         mNtHeader.Pe32->FileHeader.SizeOfOptionalHeader
+                                         );
+
+  //
+  // 11. Build a temporary table of pointers to all the IMAGE_SECTION_HEADER
+  //     structures in the image. The 'NumberOfSections' field of the image
+  //     header indicates how big the table should be. Do not include any
+  //     IMAGE_SECTION_HEADERs in the table whose 'SizeOfRawData' field is zero.
+  //
+  SectionHeader = (EFI_IMAGE_SECTION_HEADER *)AllocateZeroPool (sizeof (EFI_IMAGE_SECTION_HEADER) * mNtHeader.Pe32->FileHeader.NumberOfSections);
+  if (SectionHeader == NULL) {
+    Status = FALSE;
+    goto Done;
+  }
+
+  //
+  // 12.  Using the 'PointerToRawData' in the referenced section headers as
+  //      a key, arrange the elements in the table in ascending order. In other
+  //      words, sort the section headers according to the disk-file offset of
+  //      the section.
+  //
+  for (Index = 0; Index < mNtHeader.Pe32->FileHeader.NumberOfSections; Index++) {
+    Pos = Index;
+    while ((Pos > 0) && (Section->PointerToRawData < SectionHeader[Pos - 1].PointerToRawData)) {
+      CopyMem (&SectionHeader[Pos], &SectionHeader[Pos - 1], sizeof (EFI_IMAGE_SECTION_HEADER));
+      Pos--;
+    }
+
+    CopyMem (&SectionHeader[Pos], Section, sizeof (EFI_IMAGE_SECTION_HEADER));
+    Section += 1;
+  }
+
+  //
+  // 13.  Walk through the sorted table, bring the corresponding section
+  //      into memory, and hash the entire section (using the 'SizeOfRawData'
+  //      field in the section header to determine the amount of data to hash).
+  // 14.  Add the section's 'SizeOfRawData' to SUM_OF_BYTES_HASHED .
+  // 15.  Repeat steps 13 and 14 for all the sections in the sorted table.
+  //
+  for (Index = 0; Index < mNtHeader.Pe32->FileHeader.NumberOfSections; Index++) {
+    Section = &SectionHeader[Index];
+    if (Section->SizeOfRawData == 0) {
+      continue;
+    }
+
+    HashBase = mImageBase + Section->PointerToRawData;
+    HashSize = (UINTN)Section->SizeOfRawData;
+
+    HashPeImageUpdate (HashCtx, &ActiveMask, HashBase, HashSize);
+
+    SumOfBytesHashed += HashSize;
+  }
+
+  //
+  // 16.  If the file size is greater than SUM_OF_BYTES_HASHED, there is extra
+  //      data in the file that needs to be added to the hash. This data begins
+  //      at file offset SUM_OF_BYTES_HASHED and its length is:
+  //             FileSize  -  (CertDirectory->Size)
+  //
+  if (mImageSize > SumOfBytesHashed) {
+    HashBase = mImageBase + SumOfBytesHashed;
+
+    if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
+      CertSize = 0;
+    } else {
+      if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+        //
+        // Use PE32 offset.
+        //
+        CertSize = mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
+      } else {
+        //
+        // Use PE32+ offset.
+        //
+        CertSize = mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
+      }
+    }
+
+    if (mImageSize > CertSize + SumOfBytesHashed) {
+      HashSize = (UINTN)(mImageSize - CertSize - SumOfBytesHashed);
+
+      HashPeImageUpdate (HashCtx, &ActiveMask, HashBase, HashSize);
+    } else if (mImageSize < CertSize + SumOfBytesHashed) {
+      Status = FALSE;
+      goto Done;
+    }
+  }
+
+  //
+  // 17.  Finalize the SHA hashes.
+  //
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if (((ActiveMask & HASHALG_MASK (HashAlg)) != 0) &&
+        mHash[HashAlg].HashFinal (HashCtx[HashAlg], mImageDigests[HashAlg]))
+    {
+      mImageDigestsValid |= HASHALG_MASK (HashAlg);
+    }
+  }
+
+  Status = (BOOLEAN)((HashAlgMask & ~mImageDigestsValid) == 0);
+
+Done:
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if (HashCtx[HashAlg] != NULL) {
+      FreePool (HashCtx[HashAlg]);
+    }
+  }
+
+  if (SectionHeader != NULL) {
+    FreePool (SectionHeader);
+  }
+
+  return Status;
+}
+
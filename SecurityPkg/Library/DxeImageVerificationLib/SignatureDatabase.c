@@ -0,0 +1,463 @@
+/** @file
+  Keep a parsed copy of the image signature databases (db and dbx), so that
+  looking up a signature does not walk every signature list of the variable.
+
+  The signatures are indexed by type and data in a sorted array which is
+  binary searched, and the X.509 certificates are located once for the
+  AuthenticodeVerify() loops. As variable writes are not signaled, the
+  variable is read for every lookup and the index is rebuilt whenever its
+  content changed.
+
+  Caution: This module requires additional review when modified.
+  The signature databases are variables, so the signature lists are
+  validated before use.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "SignatureDatabase.h"
+
+SIGNATURE_DATABASE  mSignatureDatabase[] = {
+  { EFI_IMAGE_SECURITY_DATABASE  },
+  { EFI_IMAGE_SECURITY_DATABASE1 }
+};
+
+/**
+  Compare a signature of a signature database with a key.
+
+  The signatures are ordered by type, then by data. If the key is the
+  beginning of the data of the signature, the signature is considered
+  greater or equal to the key.
+
+  @param[in]  Entry             The signature.
+  @param[in]  SignatureType     The type of the key.
+  @param[in]  Signature         The data of the key.
+  @param[in]  SignatureSize     Size of Signature.
+
+  @retval <0                    The signature is less than the key.
+  @retval 0                     The key is the beginning of the data of the
+                                signature, with the same type.
+  @retval >0                    The signature is greater than the key.
+
+**/
+STATIC
+INTN
+CompareSignatureEntry (
+  IN SIGNATURE_DATABASE_ENTRY  *Entry,
+  IN EFI_GUID                  *SignatureType,
+  IN UINT8                     *Signature,
+  IN UINTN                     SignatureSize
+  )
+{
+  INTN  Result;
+
+  Result = CompareMem (&Entry->List->SignatureType, SignatureType, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+
+  Result = CompareMem (Entry->Data->SignatureData, Signature, MIN (Entry->DataSize, SignatureSize));
+  if ((Result == 0) && (Entry->DataSize < SignatureSize)) {
+    Result = -1;
+  }
+
+  return Result;
+}
+
+/**
+  QuickSort() callback ordering the signatures of a signature database by
+  type, then by data, then by position in the variable.
+
+  @param[in]  Buffer1           The first SIGNATURE_DATABASE_ENTRY.
+  @param[in]  Buffer2           The second SIGNATURE_DATABASE_ENTRY.
+
+  @retval <0                    Buffer1 is less than Buffer2.
+  @retval 0                     Buffer1 is Buffer2.
+  @retval >0                    Buffer1 is greater than Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+SortSignatureEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  SIGNATURE_DATABASE_ENTRY  *Entry1;
+  SIGNATURE_DATABASE_ENTRY  *Entry2;
+  INTN                      Result;
+
+  Entry1 = (SIGNATURE_DATABASE_ENTRY *)Buffer1;
+  Entry2 = (SIGNATURE_DATABASE_ENTRY *)Buffer2;
+
+  Result = CompareSignatureEntry (Entry1, &Entry2->List->SignatureType, Entry2->Data->SignatureData, Entry2->DataSize);
+  if ((Result == 0) && (Entry1->DataSize > Entry2->DataSize)) {
+    Result = 1;
+  }
+
+  if (Result != 0) {
+    return Result;
+  }
+
+  if ((UINTN)Entry1->Data < (UINTN)Entry2->Data) {
+    return -1;
+  }
+
+  return ((UINTN)Entry1->Data > (UINTN)Entry2->Data) ? 1 : 0;
+}
+
+/**
+  Enumerate the signatures of a signature database variable.
+
+  @param[in]  Database          The signature database, whose Data is walked.
+  @param[out] Index             If not NULL, receives all the signatures.
+  @param[out] Certs             If not NULL, receives the X.509 certificates.
+  @param[out] IndexCount        Number of signatures.
+  @param[out] CertCount         Number of X.509 certificates.
+
+**/
+STATIC
+VOID
+WalkSignatureDatabase (
+  IN  SIGNATURE_DATABASE        *Database,
+  OUT SIGNATURE_DATABASE_ENTRY  *Index OPTIONAL,
+  OUT SIGNATURE_DATABASE_ENTRY  *Certs OPTIONAL,
+  OUT UINTN                     *IndexCount,
+  OUT UINTN                     *CertCount
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *CertData;
+  UINTN               DataSize;
+  UINTN               Count;
+  UINTN               Loop;
+  BOOLEAN             IsX509;
+
+  *IndexCount = 0;
+  *CertCount  = 0;
+
+  CertList = (EFI_SIGNATURE_LIST *)Database->Data;
+  DataSize = Database->DataSize;
+  while ((DataSize >= sizeof (EFI_SIGNATURE_LIST)) && (DataSize >= CertList->SignatureListSize)) {
+    if ((CertList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST)) ||
+        (CertList->SignatureHeaderSize > CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST)) ||
+        (CertList->SignatureSize < sizeof (EFI_GUID)))
+    {
+      break;
+    }
+
+    IsX509   = CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid);
+    CertData = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    Count    = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    for (Loop = 0; Loop < Count; Loop++) {
+      if (Index != NULL) {
+        Index[*IndexCount].List     = CertList;
+        Index[*IndexCount].Data     = CertData;
+        Index[*IndexCount].DataSize = CertList->SignatureSize - sizeof (EFI_GUID);
+      }
+
+      (*IndexCount)++;
+
+      if (IsX509) {
+        if (Certs != NULL) {
+          Certs[*CertCount].List     = CertList;
+          Certs[*CertCount].Data     = CertData;
+          Certs[*CertCount].DataSize = CertList->SignatureSize - sizeof (EFI_GUID);
+        }
+
+        (*CertCount)++;
+      }
+
+      CertData = (EFI_SIGNATURE_DATA *)((UINT8 *)CertData + CertList->SignatureSize);
+    }
+
+    DataSize -= CertList->SignatureListSize;
+    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+}
+
+/**
+  Build the signature index and the certificate list of a signature database
+  from its Data.
+
+  @param[in, out]  Database      The signature database.
+
+  @retval EFI_SUCCESS           The signature database is parsed.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough resources to parse it.
+
+**/
+STATIC
+EFI_STATUS
+ParseSignatureDatabase (
+  IN OUT SIGNATURE_DATABASE  *Database
+  )
+{
+  SIGNATURE_DATABASE_ENTRY  Entry;
+  UINTN                     IndexCount;
+  UINTN                     CertCount;
+
+  if (Database->Index != NULL) {
+    FreePool (Database->Index);
+    Database->Index = NULL;
+  }
+
+  if (Database->Certs != NULL) {
+    FreePool (Database->Certs);
+    Database->Certs = NULL;
+  }
+
+  Database->IndexCount = 0;
+  Database->CertCount  = 0;
+
+  WalkSignatureDatabase (Database, NULL, NULL, &IndexCount, &CertCount);
+  if (IndexCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Database->Index = AllocatePool (IndexCount * sizeof (SIGNATURE_DATABASE_ENTRY));
+  if (Database->Index == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (CertCount != 0) {
+    Database->Certs = AllocatePool (CertCount * sizeof (SIGNATURE_DATABASE_ENTRY));
+    if (Database->Certs == NULL) {
+      FreePool (Database->Index);
+      Database->Index = NULL;
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  WalkSignatureDatabase (Database, Database->Index, Database->Certs, &Database->IndexCount, &Database->CertCount);
+  QuickSort (Database->Index, Database->IndexCount, sizeof (SIGNATURE_DATABASE_ENTRY), SortSignatureEntry, &Entry);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the parsed copy of a signature database variable.
+
+  The variable is read every time, and the signature index is only rebuilt
+  if its content differs from the one the index was built from.
+
+  The returned database is valid until the next call for the same variable.
+
+  @param[in]  VariableName      EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[out] Database          The parsed copy of the variable.
+
+  @retval EFI_SUCCESS           The database is returned.
+  @retval EFI_NOT_FOUND         The variable does not exist.
+  @retval EFI_UNSUPPORTED       VariableName is not a supported database.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough resources to parse the variable.
+  @retval Others                The variable could not be read.
+
+**/
+EFI_STATUS
+GetSignatureDatabase (
+  IN  CHAR16              *VariableName,
+  OUT SIGNATURE_DATABASE  **Database
+  )
+{
+  EFI_STATUS          Status;
+  SIGNATURE_DATABASE  *Db;
+  UINTN               Index;
+  UINTN               DataSize;
+  UINT8               *Buffer;
+  UINTN               BufferSize;
+
+  Db = NULL;
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDatabase); Index++) {
+    if (StrCmp (VariableName, mSignatureDatabase[Index].VariableName) == 0) {
+      Db = &mSignatureDatabase[Index];
+      break;
+    }
+  }
+
+  if (Db == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Read the variable to the scratch buffer, growing it if needed.
+  //
+  DataSize = Db->BufferSize;
+  Status   = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Db->Buffer);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    if (Db->Buffer != NULL) {
+      FreePool (Db->Buffer);
+    }
+
+    Db->BufferSize = 0;
+    Db->Buffer     = AllocatePool (DataSize);
+    if (Db->Buffer == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      Db->BufferSize = DataSize;
+      Status         = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Db->Buffer);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    Db->Valid = FALSE;
+    return Status;
+  }
+
+  if (Db->Valid && (DataSize == Db->DataSize) && (CompareMem (Db->Buffer, Db->Data, DataSize) == 0)) {
+    *Database = Db;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The variable changed: keep what was read, and index it.
+  //
+  Buffer             = Db->Data;
+  BufferSize         = Db->DataBufferSize;
+  Db->Data           = Db->Buffer;
+  Db->DataBufferSize = Db->BufferSize;
+  Db->DataSize       = DataSize;
+  Db->Buffer         = Buffer;
+  Db->BufferSize     = BufferSize;
+
+  Status    = ParseSignatureDatabase (Db);
+  Db->Valid = (BOOLEAN) !EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *Database = Db;
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the first signature of the index which is not less than a key.
+
+  @param[in]  Database          The signature database.
+  @param[in]  SignatureType     The type of the key.
+  @param[in]  Signature         The data of the key.
+  @param[in]  SignatureSize     Size of Signature.
+
+  @return The position of the signature in the index, or IndexCount if all
+          the signatures are less than the key.
+
+**/
+STATIC
+UINTN
+SignatureDatabaseLowerBound (
+  IN SIGNATURE_DATABASE  *Database,
+  IN EFI_GUID            *SignatureType,
+  IN UINT8               *Signature,
+  IN UINTN               SignatureSize
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+
+  Low  = 0;
+  High = Database->IndexCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (CompareSignatureEntry (&Database->Index[Middle], SignatureType, Signature, SignatureSize) < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return Low;
+}
+
+/**
+  Find a signature in a signature database.
+
+  If several signatures match, the one which comes first in the variable is
+  returned.
+
+  @param[in]  Database          The signature database.
+  @param[in]  SignatureType     The type of the signature.
+  @param[in]  Signature         The signature data to search for.
+  @param[in]  SignatureSize     Size of Signature.
+  @param[in]  Prefix            TRUE if Signature only needs to be the beginning
+                                of the signature data, FALSE if it must be the
+                                whole signature data.
+  @param[out] SignatureList     The signature list of the returned signature.
+
+  @return The matching signature, or NULL if there is none.
+
+**/
+EFI_SIGNATURE_DATA *
+SignatureDatabaseFind (
+  IN  SIGNATURE_DATABASE  *Database,
+  IN  EFI_GUID            *SignatureType,
+  IN  UINT8               *Signature,
+  IN  UINTN               SignatureSize,
+  IN  BOOLEAN             Prefix,
+  OUT EFI_SIGNATURE_LIST  **SignatureList OPTIONAL
+  )
+{
+  SIGNATURE_DATABASE_ENTRY  *Entry;
+  SIGNATURE_DATABASE_ENTRY  *Found;
+  UINTN                     Index;
+
+  Found = NULL;
+  for (Index = SignatureDatabaseLowerBound (Database, SignatureType, Signature, SignatureSize);
+       Index < Database->IndexCount;
+       Index++)
+  {
+    Entry = &Database->Index[Index];
+    if (CompareSignatureEntry (Entry, SignatureType, Signature, SignatureSize) != 0) {
+      break;
+    }
+
+    if (!Prefix) {
+      //
+      // The exact matches come first, in the order of the variable.
+      //
+      if (Entry->DataSize == SignatureSize) {
+        Found = Entry;
+      }
+
+      break;
+    }
+
+    if ((Found == NULL) || ((UINTN)Entry->Data < (UINTN)Found->Data)) {
+      Found = Entry;
+    }
+  }
+
+  if (Found == NULL) {
+    return NULL;
+  }
+
+  if (SignatureList != NULL) {
+    *SignatureList = Found->List;
+  }
+
+  return Found->Data;
+}
+
+/**
+  Check whether a signature database contains signatures of the given type.
+
+  @param[in]  Database          The signature database.
+  @param[in]  SignatureType     The type of the signatures.
+
+  @retval TRUE                  At least one signature has the type SignatureType.
+  @retval FALSE                 No signature has the type SignatureType.
+
+**/
+BOOLEAN
+SignatureDatabaseHasType (
+  IN SIGNATURE_DATABASE  *Database,
+  IN EFI_GUID            *SignatureType
+  )
+{
+  UINTN  Index;
+
+  Index = SignatureDatabaseLowerBound (Database, SignatureType, NULL, 0);
+  return (BOOLEAN)((Index < Database->IndexCount) &&
+                   CompareGuid (&Database->Index[Index].List->SignatureType, SignatureType));
+}
@@ -0,0 +1,133 @@
+/** @file
+  The internal header file of the parsed copy of the image signature
+  databases (db and dbx) used by ImageVerificationLib.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __SIGNATURE_DATABASE_H__
+#define __SIGNATURE_DATABASE_H__
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Guid/ImageAuthentication.h>
+
+//
+// One signature of a signature database variable.
+//
+typedef struct {
+  EFI_SIGNATURE_LIST    *List;
+  EFI_SIGNATURE_DATA    *Data;
+  //
+  // Size of Data->SignatureData
+  //
+  UINTN                 DataSize;
+} SIGNATURE_DATABASE_ENTRY;
+
+//
+// Parsed copy of a signature database variable (db or dbx)
+//
+typedef struct {
+  CHAR16                      *VariableName;
+  //
+  // TRUE if Data, Index and Certs describe the current content of the variable
+  //
+  BOOLEAN                     Valid;
+  //
+  // Copy of the variable the index was built from
+  //
+  UINT8                       *Data;
+  UINTN                       DataSize;
+  UINTN                       DataBufferSize;
+  //
+  // Scratch buffer the variable is read to, to be compared with Data
+  //
+  UINT8                       *Buffer;
+  UINTN                       BufferSize;
+  //
+  // All the signatures, sorted by SignatureType, then by SignatureData, then
+  // by their position in the variable
+  //
+  SIGNATURE_DATABASE_ENTRY    *Index;
+  UINTN                       IndexCount;
+  //
+  // The EFI_CERT_X509_GUID signatures, in the order of the variable
+  //
+  SIGNATURE_DATABASE_ENTRY    *Certs;
+  UINTN                       CertCount;
+} SIGNATURE_DATABASE;
+
+/**
+  Get the parsed copy of a signature database variable.
+
+  The variable is read every time, and the signature index is only rebuilt
+  if its content differs from the one the index was built from.
+
+  The returned database is valid until the next call for the same variable.
+
+  @param[in]  VariableName      EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[out] Database          The parsed copy of the variable.
+
+  @retval EFI_SUCCESS           The database is returned.
+  @retval EFI_NOT_FOUND         The variable does not exist.
+  @retval EFI_UNSUPPORTED       VariableName is not a supported database.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough resources to parse the variable.
+  @retval Others                The variable could not be read.
+
+**/
+EFI_STATUS
+GetSignatureDatabase (
+  IN  CHAR16              *VariableName,
+  OUT SIGNATURE_DATABASE  **Database
+  );
+
+/**
+  Find a signature in a signature database.
+
+  If several signatures match, the one which comes first in the variable is
+  returned.
+
+  @param[in]  Database          The signature database.
+  @param[in]  SignatureType     The type of the signature.
+  @param[in]  Signature         The signature data to search for.
+  @param[in]  SignatureSize     Size of Signature.
+  @param[in]  Prefix            TRUE if Signature only needs to be the beginning
+                                of the signature data, FALSE if it must be the
+                                whole signature data.
+  @param[out] SignatureList     The signature list of the returned signature.
+
+  @return The matching signature, or NULL if there is none.
+
+**/
+EFI_SIGNATURE_DATA *
+SignatureDatabaseFind (
+  IN  SIGNATURE_DATABASE  *Database,
+  IN  EFI_GUID            *SignatureType,
+  IN  UINT8               *Signature,
+  IN  UINTN               SignatureSize,
+  IN  BOOLEAN             Prefix,
+  OUT EFI_SIGNATURE_LIST  **SignatureList OPTIONAL
+  );
+
+/**
+  Check whether a signature database contains signatures of the given type.
+
+  @param[in]  Database          The signature database.
+  @param[in]  SignatureType     The type of the signatures.
+
+  @retval TRUE                  At least one signature has the type SignatureType.
+  @retval FALSE                 No signature has the type SignatureType.
+
+**/
+BOOLEAN
+SignatureDatabaseHasType (
+  IN SIGNATURE_DATABASE  *Database,
+  IN EFI_GUID            *SignatureType
+  );
+
+#endif
@@ -0,0 +1,319 @@
+/** @file
+  Tests for HashInterfacesUpdate() of HashLibBaseCryptoRouterCommon.c.
+
+  The unit tests check that feeding the PCR banks slice by slice produces the
+  same digests as hashing the whole buffer, and that masked banks are left
+  alone. A micro-benchmark with all the SHA banks enabled measures the single
+  pass against letting every bank stream the whole buffer.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+#include <vector>
+
+extern "C" {
+  #include <PiPei.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/BaseCryptLib.h>
+  #include <Library/HashLib.h>
+  #include "../HashLibBaseCryptoRouterCommon.h"
+}
+
+using namespace testing;
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_BANK_COUNT          4
+#define TEST_BENCHMARK_SIZE      SIZE_16MB
+#define TEST_BENCHMARK_RUN       4
+#define TEST_ALL_BANKS_MASK      (HASH_ALG_SHA1 | HASH_ALG_SHA256 | HASH_ALG_SHA384 | HASH_ALG_SHA512)
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// Hash interfaces over BaseCryptLib, as HashInstanceLib* register them
+////////////////////////////////////////////////////////////////////////
+
+#define DEFINE_TEST_HASH_INTERFACE(Alg)                                        \
+  STATIC EFI_STATUS EFIAPI                                                     \
+  Test##Alg##Init (OUT HASH_HANDLE *HashHandle)                                \
+  {                                                                            \
+    VOID  *Ctx = AllocatePool (Alg##GetContextSize ());                        \
+    Alg##Init (Ctx);                                                           \
+    *HashHandle = (HASH_HANDLE)Ctx;                                            \
+    return EFI_SUCCESS;                                                        \
+  }                                                                            \
+  STATIC EFI_STATUS EFIAPI                                                     \
+  Test##Alg##Update (IN HASH_HANDLE HashHandle, IN VOID *Data, IN UINTN Size)  \
+  {                                                                            \
+    Alg##Update ((VOID *)HashHandle, Data, Size);                              \
+    return EFI_SUCCESS;                                                        \
+  }                                                                            \
+  STATIC EFI_STATUS EFIAPI                                                     \
+  Test##Alg##Final (IN HASH_HANDLE HashHandle, OUT TPML_DIGEST_VALUES *List)   \
+  {                                                                            \
+    ZeroMem (List, sizeof (*List));                                            \
+    List->count = 1;                                                           \
+    Alg##Final ((VOID *)HashHandle, (UINT8 *)&List->digests[0].digest);        \
+    FreePool ((VOID *)HashHandle);                                             \
+    return EFI_SUCCESS;                                                        \
+  }
+
+DEFINE_TEST_HASH_INTERFACE (Sha1)
+DEFINE_TEST_HASH_INTERFACE (Sha256)
+DEFINE_TEST_HASH_INTERFACE (Sha384)
+DEFINE_TEST_HASH_INTERFACE (Sha512)
+
+HASH_INTERFACE  mTestHashInterface[TEST_BANK_COUNT] = {
+  { HASH_ALGORITHM_SHA1_GUID,   TestSha1Init,   TestSha1Update,   TestSha1Final   },
+  { HASH_ALGORITHM_SHA256_GUID, TestSha256Init, TestSha256Update, TestSha256Final },
+  { HASH_ALGORITHM_SHA384_GUID, TestSha384Init, TestSha384Update, TestSha384Final },
+  { HASH_ALGORITHM_SHA512_GUID, TestSha512Init, TestSha512Update, TestSha512Final },
+};
+
+UINTN  mTestDigestSize[TEST_BANK_COUNT] = {
+  SHA1_DIGEST_SIZE,
+  SHA256_DIGEST_SIZE,
+  SHA384_DIGEST_SIZE,
+  SHA512_DIGEST_SIZE
+};
+
+//
+// Recording interface, to check what every bank is fed with.
+//
+UINTN  mRecordedBytes;
+UINTN  mRecordedCalls;
+UINTN  mRecordedLargestChunk;
+
+STATIC
+EFI_STATUS
+EFIAPI
+RecordInit (
+  OUT HASH_HANDLE  *HashHandle
+  )
+{
+  *HashHandle = 0;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+RecordUpdate (
+  IN HASH_HANDLE  HashHandle,
+  IN VOID         *DataToHash,
+  IN UINTN        DataToHashLen
+  )
+{
+  mRecordedBytes       += DataToHashLen;
+  mRecordedCalls       += 1;
+  mRecordedLargestChunk = MAX (mRecordedLargestChunk, DataToHashLen);
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+RecordFinal (
+  IN HASH_HANDLE          HashHandle,
+  OUT TPML_DIGEST_VALUES  *DigestList
+  )
+{
+  return EFI_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+class HashInterfacesUpdateTest : public Test {
+protected:
+  std::vector<UINT8> Data;
+  HASH_HANDLE HashCtx[TEST_BANK_COUNT];
+
+  void
+  SetUp (
+    ) override
+  {
+    UINTN  Index;
+
+    Data.resize (TEST_BENCHMARK_SIZE);
+    for (Index = 0; Index < Data.size (); Index++) {
+      Data[Index] = (UINT8)(Index * 7 + (Index >> 11));
+    }
+
+    mRecordedBytes        = 0;
+    mRecordedCalls        = 0;
+    mRecordedLargestChunk = 0;
+  }
+
+  void
+  StartAll (
+    VOID
+    )
+  {
+    UINTN  Index;
+
+    for (Index = 0; Index < TEST_BANK_COUNT; Index++) {
+      ASSERT_EQ (mTestHashInterface[Index].HashInit (&HashCtx[Index]), EFI_SUCCESS);
+    }
+  }
+
+  void
+  FinishAll (
+    UINT8  Digest[TEST_BANK_COUNT][SHA512_DIGEST_SIZE]
+    )
+  {
+    TPML_DIGEST_VALUES  DigestList;
+    UINTN               Index;
+
+    for (Index = 0; Index < TEST_BANK_COUNT; Index++) {
+      ASSERT_EQ (mTestHashInterface[Index].HashFinal (HashCtx[Index], &DigestList), EFI_SUCCESS);
+      CopyMem (Digest[Index], &DigestList.digests[0].digest, mTestDigestSize[Index]);
+    }
+  }
+
+  void
+  ExpectOneShotDigests (
+    UINTN  Size
+    )
+  {
+    UINT8  Digest[TEST_BANK_COUNT][SHA512_DIGEST_SIZE];
+    UINT8  Expected[SHA512_DIGEST_SIZE];
+
+    StartAll ();
+    HashInterfacesUpdate (mTestHashInterface, TEST_BANK_COUNT, HashCtx, TEST_ALL_BANKS_MASK, Data.data (), Size);
+    FinishAll (Digest);
+
+    ASSERT_TRUE (Sha1HashAll (Data.data (), Size, Expected));
+    EXPECT_EQ (CompareMem (Digest[0], Expected, SHA1_DIGEST_SIZE), 0) << "Size " << Size;
+    ASSERT_TRUE (Sha256HashAll (Data.data (), Size, Expected));
+    EXPECT_EQ (CompareMem (Digest[1], Expected, SHA256_DIGEST_SIZE), 0) << "Size " << Size;
+    ASSERT_TRUE (Sha384HashAll (Data.data (), Size, Expected));
+    EXPECT_EQ (CompareMem (Digest[2], Expected, SHA384_DIGEST_SIZE), 0) << "Size " << Size;
+    ASSERT_TRUE (Sha512HashAll (Data.data (), Size, Expected));
+    EXPECT_EQ (CompareMem (Digest[3], Expected, SHA512_DIGEST_SIZE), 0) << "Size " << Size;
+  }
+};
+
+//
+// Every bank ends up with the digest of the whole buffer, whatever the
+// position of the buffer end relative to the slices.
+//
+TEST_F (HashInterfacesUpdateTest, DigestsMatchOneShot) {
+  ExpectOneShotDigests (0);
+  ExpectOneShotDigests (1);
+  ExpectOneShotDigests (HASH_LIB_CHUNK_SIZE - 1);
+  ExpectOneShotDigests (HASH_LIB_CHUNK_SIZE);
+  ExpectOneShotDigests (HASH_LIB_CHUNK_SIZE + 1);
+  ExpectOneShotDigests (3 * HASH_LIB_CHUNK_SIZE + 17);
+}
+
+//
+// Hashing a buffer in several HashUpdate() calls keeps working.
+//
+TEST_F (HashInterfacesUpdateTest, DigestsMatchAcrossUpdates) {
+  UINT8  Digest[TEST_BANK_COUNT][SHA512_DIGEST_SIZE];
+  UINT8  Expected[SHA512_DIGEST_SIZE];
+  UINTN  Size;
+
+  Size = 5 * HASH_LIB_CHUNK_SIZE + 123;
+  StartAll ();
+  HashInterfacesUpdate (mTestHashInterface, TEST_BANK_COUNT, HashCtx, TEST_ALL_BANKS_MASK, Data.data (), 100);
+  HashInterfacesUpdate (mTestHashInterface, TEST_BANK_COUNT, HashCtx, TEST_ALL_BANKS_MASK, Data.data () + 100, Size - 100);
+  FinishAll (Digest);
+
+  ASSERT_TRUE (Sha384HashAll (Data.data (), Size, Expected));
+  EXPECT_EQ (CompareMem (Digest[2], Expected, SHA384_DIGEST_SIZE), 0);
+}
+
+//
+// Banks out of the mask are not fed, and a single active bank gets the
+// buffer in one call.
+//
+TEST_F (HashInterfacesUpdateTest, MaskedBanksAreSkipped) {
+  HASH_INTERFACE  Interface[3] = {
+    { HASH_ALGORITHM_SHA1_GUID,   RecordInit, RecordUpdate, RecordFinal },
+    { HASH_ALGORITHM_SHA256_GUID, RecordInit, RecordUpdate, RecordFinal },
+    { HASH_ALGORITHM_SHA384_GUID, RecordInit, RecordUpdate, RecordFinal },
+  };
+  HASH_HANDLE     Ctx[3] = { 0 };
+  UINTN           Size;
+
+  Size = 4 * HASH_LIB_CHUNK_SIZE;
+  HashInterfacesUpdate (Interface, 3, Ctx, HASH_ALG_SHA256 | HASH_ALG_SM3_256, Data.data (), Size);
+  EXPECT_EQ (mRecordedBytes, Size);
+  EXPECT_EQ (mRecordedCalls, 1U);
+
+  mRecordedBytes = 0;
+  mRecordedCalls = 0;
+  HashInterfacesUpdate (Interface, 3, Ctx, 0, Data.data (), Size);
+  EXPECT_EQ (mRecordedBytes, 0U);
+  EXPECT_EQ (mRecordedCalls, 0U);
+}
+
+//
+// Several active banks get every byte, by slices no larger than
+// HASH_LIB_CHUNK_SIZE.
+//
+TEST_F (HashInterfacesUpdateTest, ActiveBanksAreSliced) {
+  HASH_INTERFACE  Interface[2] = {
+    { HASH_ALGORITHM_SHA1_GUID,   RecordInit, RecordUpdate, RecordFinal },
+    { HASH_ALGORITHM_SHA512_GUID, RecordInit, RecordUpdate, RecordFinal },
+  };
+  HASH_HANDLE     Ctx[2] = { 0 };
+  UINTN           Size;
+
+  Size = 4 * HASH_LIB_CHUNK_SIZE + 1;
+  HashInterfacesUpdate (Interface, 2, Ctx, TEST_ALL_BANKS_MASK, Data.data (), Size);
+  EXPECT_EQ (mRecordedBytes, 2 * Size);
+  EXPECT_EQ (mRecordedCalls, 2U * 5);
+  EXPECT_EQ (mRecordedLargestChunk, (UINTN)HASH_LIB_CHUNK_SIZE);
+}
+
+//
+// Micro-benchmark: a large buffer measured with all the SHA banks enabled,
+// each bank streaming the whole buffer against a single sliced pass.
+//
+TEST_F (HashInterfacesUpdateTest, BenchmarkAllBanks) {
+  std::chrono::steady_clock::time_point  Start;
+  std::chrono::nanoseconds               PerBank;
+  std::chrono::nanoseconds               SinglePass;
+  UINT8                                  Digest[TEST_BANK_COUNT][SHA512_DIGEST_SIZE]    = { { 0 } };
+  UINT8                                  Reference[TEST_BANK_COUNT][SHA512_DIGEST_SIZE] = { { 0 } };
+  UINTN                                  Run;
+  UINTN                                  Index;
+
+  PerBank    = std::chrono::nanoseconds::zero ();
+  SinglePass = std::chrono::nanoseconds::zero ();
+  for (Run = 0; Run < TEST_BENCHMARK_RUN; Run++) {
+    StartAll ();
+    Start = std::chrono::steady_clock::now ();
+    for (Index = 0; Index < TEST_BANK_COUNT; Index++) {
+      mTestHashInterface[Index].HashUpdate (HashCtx[Index], Data.data (), Data.size ());
+    }
+
+    PerBank += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now () - Start);
+    FinishAll (Reference);
+
+    StartAll ();
+    Start = std::chrono::steady_clock::now ();
+    HashInterfacesUpdate (mTestHashInterface, TEST_BANK_COUNT, HashCtx, TEST_ALL_BANKS_MASK, Data.data (), Data.size ());
+    SinglePass += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now () - Start);
+    FinishAll (Digest);
+
+    ASSERT_EQ (CompareMem (Digest, Reference, sizeof (Digest)), 0);
+  }
+
+  RecordProperty ("PerBankUs", (int)(PerBank.count () / 1000 / TEST_BENCHMARK_RUN));
+  RecordProperty ("SinglePassUs", (int)(SinglePass.count () / 1000 / TEST_BENCHMARK_RUN));
+  printf (
+    "%d banks over %d MB: per bank %.1f ms, single pass %.1f ms\n",
+    TEST_BANK_COUNT,
+    TEST_BENCHMARK_SIZE / SIZE_1MB,
+    (double)PerBank.count () / 1000000 / TEST_BENCHMARK_RUN,
+    (double)SinglePass.count () / 1000000 / TEST_BENCHMARK_RUN
+    );
+}
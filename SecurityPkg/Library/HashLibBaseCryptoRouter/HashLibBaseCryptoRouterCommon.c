@@ -15,6 +15,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID    Guid;
   UINT32      Mask;
@@ -72,3 +74,69 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count++;
 }
+
+/**
+  Update the hash sequences of all hash interfaces selected by HashMask
+  with the same data, reading the data once.
+
+  Rather than letting every PCR bank stream the whole buffer on its own,
+  the buffer is sliced into HASH_LIB_CHUNK_SIZE pieces and each piece is
+  fed to all the active hash interfaces while it is still in the cache.
+  This matters most when the buffer lives in flash or in memory that is
+  not cached yet, where every extra pass costs a full read of the buffer.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param HashMask           Mask of the hash algorithms to update.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashInterfacesUpdate (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  UINTN  ActiveIndex[HASH_COUNT];
+  UINTN  ActiveCount;
+  UINTN  Index;
+  UINT8  *Data;
+  UINTN  Remaining;
+  UINTN  ChunkSize;
+
+  ActiveCount = 0;
+  for (Index = 0; Index < HashInterfaceCount && ActiveCount < HASH_COUNT; Index++) {
+    if ((Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid) & HashMask) != 0) {
+      ActiveIndex[ActiveCount++] = Index;
+    }
+  }
+
+  //
+  // Slicing only pays off when several banks share the buffer.
+  //
+  if ((ActiveCount < 2) || (DataToHashLen <= HASH_LIB_CHUNK_SIZE)) {
+    for (Index = 0; Index < ActiveCount; Index++) {
+      HashInterface[ActiveIndex[Index]].HashUpdate (HashCtx[ActiveIndex[Index]], DataToHash, DataToHashLen);
+    }
+
+    return;
+  }
+
+  Data      = (UINT8 *)DataToHash;
+  Remaining = DataToHashLen;
+  while (Remaining != 0) {
+    ChunkSize = MIN (Remaining, HASH_LIB_CHUNK_SIZE);
+    for (Index = 0; Index < ActiveCount; Index++) {
+      HashInterface[ActiveIndex[Index]].HashUpdate (HashCtx[ActiveIndex[Index]], Data, ChunkSize);
+    }
+
+    Data      += ChunkSize;
+    Remaining -= ChunkSize;
+  }
+}
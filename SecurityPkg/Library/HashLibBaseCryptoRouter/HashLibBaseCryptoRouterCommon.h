@@ -9,6 +9,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// Size of the slices HashInterfacesUpdate() feeds to every active hash
+// interface in turn. Small enough for a slice to stay in the data cache
+// while all PCR banks consume it.
+//
+#define HASH_LIB_CHUNK_SIZE  SIZE_16KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -35,4 +42,26 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES      *Digest
   );
 
+/**
+  Update the hash sequences of all hash interfaces selected by HashMask
+  with the same data, reading the data once.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param HashMask           Mask of the hash algorithms to update.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashInterfacesUpdate (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
@@ -108,8 +108,6 @@ HashUpdate (
   )
 {
   HASH_HANDLE  *HashCtx;
-  UINTN        Index;
-  UINT32       HashMask;
 
   if (mHashInterfaceCount == 0) {
     return EFI_UNSUPPORTED;
@@ -119,12 +117,14 @@ HashUpdate (
 
   HashCtx = (HASH_HANDLE *)HashHandle;
 
-  for (Index = 0; Index < mHashInterfaceCount; Index++) {
-    HashMask = Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid);
-    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      mHashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
-    }
-  }
+  HashInterfacesUpdate (
+    mHashInterface,
+    mHashInterfaceCount,
+    HashCtx,
+    PcdGet32 (PcdTpm2HashMask),
+    DataToHash,
+    DataToHashLen
+    );
 
   return EFI_SUCCESS;
 }
@@ -213,10 +213,18 @@ HashCompleteAndExtend (
   HashCtx = (HASH_HANDLE *)HashHandle;
   ZeroMem (DigestList, sizeof (*DigestList));
 
+  HashInterfacesUpdate (
+    mHashInterface,
+    mHashInterfaceCount,
+    HashCtx,
+    PcdGet32 (PcdTpm2HashMask),
+    DataToHash,
+    DataToHashLen
+    );
+
   for (Index = 0; Index < mHashInterfaceCount; Index++) {
     HashMask = Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid);
     if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      mHashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
       mHashInterface[Index].HashFinal (HashCtx[Index], &Digest);
       Tpm2SetHashToDigestList (DigestList, &Digest);
     }
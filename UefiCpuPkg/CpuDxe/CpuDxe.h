@@ -13,6 +13,7 @@
 
 #include <Protocol/Cpu.h>
 #include <Protocol/MpService.h>
+#include <Protocol/MpJobQueue.h>
 #include <Register/Intel/Cpuid.h>
 #include <Register/Intel/Msr.h>
 
@@ -466,4 +466,35 @@ WhoAmI (
   OUT UINTN                    *ProcessorNumber
   );
 
+/**
+  This service runs a list of jobs on all enabled processors and returns when
+  all of them have finished. This service may only be called from the BSP.
+
+  @param[in]  This                    A pointer to the EDKII_MP_JOB_QUEUE_PROTOCOL
+                                      instance.
+  @param[in]  Jobs                    The array of jobs to run.
+  @param[in]  JobCount                The number of entries in Jobs.
+  @param[in]  TimeoutInMicroseconds   Indicates the time limit in microseconds for
+                                      APs to finish their jobs. Zero means
+                                      infinity.
+
+  @retval EFI_SUCCESS             All jobs have finished.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_TIMEOUT             The timeout expired before all jobs have
+                                  finished.
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL and JobCount is not zero.
+  @retval EFI_INVALID_PARAMETER   The Procedure of any job is NULL.
+  @retval EFI_OUT_OF_RESOURCES    The job queues could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+RunJobs (
+  IN EDKII_MP_JOB_QUEUE_PROTOCOL  *This,
+  IN EDKII_MP_JOB                 *Jobs,
+  IN UINTN                        JobCount,
+  IN UINTN                        TimeoutInMicroseconds
+  );
+
 #endif // _CPU_MP_H_
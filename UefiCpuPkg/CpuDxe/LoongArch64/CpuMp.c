@@ -22,6 +22,10 @@ EFI_MP_SERVICES_PROTOCOL  mMpServicesTemplate = {
   WhoAmI
 };
 
+EDKII_MP_JOB_QUEUE_PROTOCOL  mMpJobQueueTemplate = {
+  RunJobs
+};
+
 /**
   This service retrieves the number of logical processor in the platform
   and the number of those logical processors that are enabled on this boot.
@@ -512,6 +516,40 @@ WhoAmI (
   return MpInitLibWhoAmI (ProcessorNumber);
 }
 
+/**
+  This service runs a list of jobs on all enabled processors and returns when
+  all of them have finished. This service may only be called from the BSP.
+
+  @param[in]  This                    A pointer to the EDKII_MP_JOB_QUEUE_PROTOCOL
+                                      instance.
+  @param[in]  Jobs                    The array of jobs to run.
+  @param[in]  JobCount                The number of entries in Jobs.
+  @param[in]  TimeoutInMicroseconds   Indicates the time limit in microseconds for
+                                      APs to finish their jobs. Zero means
+                                      infinity.
+
+  @retval EFI_SUCCESS             All jobs have finished.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_TIMEOUT             The timeout expired before all jobs have
+                                  finished.
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL and JobCount is not zero.
+  @retval EFI_INVALID_PARAMETER   The Procedure of any job is NULL.
+  @retval EFI_OUT_OF_RESOURCES    The job queues could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+RunJobs (
+  IN EDKII_MP_JOB_QUEUE_PROTOCOL  *This,
+  IN EDKII_MP_JOB                 *Jobs,
+  IN UINTN                        JobCount,
+  IN UINTN                        TimeoutInMicroseconds
+  )
+{
+  return MpInitLibRunJobs (Jobs, JobCount, TimeoutInMicroseconds);
+}
+
 /**
   Initialize Multi-processor support.
 **/
@@ -538,6 +576,8 @@ InitializeMpSupport (
                   &mMpServiceHandle,
                   &gEfiMpServiceProtocolGuid,
                   &mMpServicesTemplate,
+                  &gEdkiiMpJobQueueProtocolGuid,
+                  &mMpJobQueueTemplate,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
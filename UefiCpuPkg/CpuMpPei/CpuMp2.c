@@ -414,3 +414,42 @@ EFI_PEI_MP_SERVICES2_PPI  mMpServices2Ppi = {
   PeiWhoAmI2,
   PeiStartupAllCPUs2
 };
+
+/**
+  This service runs a list of jobs on all enabled CPUs and returns when all of
+  them have finished. This service may only be called from the BSP.
+
+  @param[in] This                 A pointer to the EDKII_PEI_MP_JOB_QUEUE_PPI instance.
+  @param[in] Jobs                 The array of jobs to run.
+  @param[in] JobCount             The number of entries in Jobs.
+  @param[in] TimeoutInMicroSeconds
+                                  Indicates the time limit in microseconds for APs to
+                                  finish their jobs. Zero means infinity. If the
+                                  timeout expires, BSP returns EFI_TIMEOUT.
+
+  @retval EFI_SUCCESS             All jobs have finished.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_TIMEOUT             The timeout expired before all jobs have finished.
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL and JobCount is not zero.
+  @retval EFI_INVALID_PARAMETER   The Procedure of any job is NULL.
+  @retval EFI_OUT_OF_RESOURCES    The job queues could not be allocated.
+**/
+EFI_STATUS
+EFIAPI
+PeiRunJobs (
+  IN  EDKII_PEI_MP_JOB_QUEUE_PPI  *This,
+  IN  EDKII_MP_JOB                *Jobs,
+  IN  UINTN                       JobCount,
+  IN  UINTN                       TimeoutInMicroSeconds
+  )
+{
+  return MpInitLibRunJobs (Jobs, JobCount, TimeoutInMicroSeconds);
+}
+
+//
+// MP job queue PPI to be installed
+//
+EDKII_PEI_MP_JOB_QUEUE_PPI  mMpJobQueuePpi = {
+  PeiRunJobs
+};
@@ -11,6 +11,7 @@
 
 #include <Ppi/SecPlatformInformation.h>
 #include <Protocol/MpService.h>
+#include <Protocol/MpJobQueue.h>
 
 /**
   MP Initialize Library initialization.
@@ -380,4 +381,42 @@ MpInitLibStartupAllCPUs (
   IN  VOID              *ProcedureArgument      OPTIONAL
   );
 
+/**
+  This service runs a list of jobs on all enabled CPUs and returns when all of
+  them have finished.
+
+  The jobs are split evenly into one queue per CPU. A CPU runs the jobs of its
+  own queue and, once it is empty, steals half of the jobs left in the queue of
+  another CPU. Each job runs exactly once, on an unspecified CPU which may be
+  the BSP, so the jobs must not depend on each other.
+
+  Jobs run on APs, so they must not call PEI services or UEFI boot services,
+  directly or through a library.
+
+  @param[in]  Jobs                    The array of jobs to run.
+  @param[in]  JobCount                The number of entries in Jobs.
+  @param[in]  TimeoutInMicroseconds   Indicates the time limit in microseconds for
+                                      APs to finish their jobs. Zero means
+                                      infinity.
+
+  @retval EFI_SUCCESS             All jobs have finished.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_NOT_READY           MP Initialize Library is not initialized.
+  @retval EFI_TIMEOUT             The timeout expired before all jobs have
+                                  finished.
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL and JobCount is not zero.
+  @retval EFI_INVALID_PARAMETER   The Procedure of any job is NULL.
+  @retval EFI_INVALID_PARAMETER   JobCount is greater than MAX_UINT32.
+  @retval EFI_OUT_OF_RESOURCES    The job queues could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibRunJobs (
+  IN  EDKII_MP_JOB  *Jobs,
+  IN  UINTN         JobCount,
+  IN  UINTN         TimeoutInMicroseconds
+  );
+
 #endif
@@ -0,0 +1,62 @@
+/** @file
+  EDK II PEI MP Job Queue PPI definition.
+
+  This PPI is the PEI counterpart of the EDK II MP Job Queue Protocol.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EDKII_PEI_MP_JOB_QUEUE_PPI_H_
+#define EDKII_PEI_MP_JOB_QUEUE_PPI_H_
+
+#include <Protocol/MpJobQueue.h>
+
+#define EDKII_PEI_MP_JOB_QUEUE_PPI_GUID \
+  { \
+    0xb77c2458, 0xb4f2, 0x40af, { 0x9a, 0x31, 0x4a, 0x2b, 0xce, 0x5d, 0xd5, 0x3f } \
+  }
+
+typedef struct _EDKII_PEI_MP_JOB_QUEUE_PPI EDKII_PEI_MP_JOB_QUEUE_PPI;
+
+/**
+  Runs a list of jobs on all enabled processors and returns when all of them
+  have finished.
+
+  See EDKII_MP_JOB_QUEUE_RUN_JOBS for the semantics of the parameters and the
+  return values.
+
+  A job runs on an AP, so it must not call PEI services, directly or through
+  a library. In particular, it must not locate PPIs, allocate memory from
+  the PEI core, or use a DebugLib instance that reports through PEI
+  services. Any PPI a job needs must be located by the caller before
+  RunJobs() and handed over in the ProcedureArgument.
+
+  @param[in]  This                    A pointer to this PPI instance.
+  @param[in]  Jobs                    The array of jobs to run.
+  @param[in]  JobCount                The number of entries in Jobs.
+  @param[in]  TimeoutInMicroseconds   Indicates the time limit in microseconds for
+                                      APs to finish their jobs. Zero means
+                                      infinity.
+
+  @retval EFI_SUCCESS             All jobs have finished.
+  @retval others                  See EDKII_MP_JOB_QUEUE_RUN_JOBS.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PEI_MP_JOB_QUEUE_RUN_JOBS)(
+  IN  EDKII_PEI_MP_JOB_QUEUE_PPI  *This,
+  IN  EDKII_MP_JOB                *Jobs,
+  IN  UINTN                       JobCount,
+  IN  UINTN                       TimeoutInMicroseconds
+  );
+
+struct _EDKII_PEI_MP_JOB_QUEUE_PPI {
+  EDKII_PEI_MP_JOB_QUEUE_RUN_JOBS    RunJobs;
+};
+
+extern EFI_GUID  gEdkiiPeiMpJobQueuePpiGuid;
+
+#endif
@@ -0,0 +1,82 @@
+/** @file
+  EDK II MP Job Queue Protocol definition.
+
+  The protocol is a companion of the MP Services Protocol. It runs a list of
+  independent jobs on all enabled processors in blocking mode. Each processor
+  keeps taking jobs until the list is drained, so jobs of uneven cost are
+  balanced across the processors.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EDKII_MP_JOB_QUEUE_PROTOCOL_H_
+#define EDKII_MP_JOB_QUEUE_PROTOCOL_H_
+
+//
+// Share EFI_AP_PROCEDURE with MP Services
+//
+#include <Protocol/MpService.h>
+
+#define EDKII_MP_JOB_QUEUE_PROTOCOL_GUID \
+  { \
+    0x9a0cca63, 0x2ca6, 0x48a6, { 0xbe, 0xa3, 0x74, 0x86, 0x06, 0x79, 0x02, 0x30 } \
+  }
+
+typedef struct _EDKII_MP_JOB_QUEUE_PROTOCOL EDKII_MP_JOB_QUEUE_PROTOCOL;
+
+///
+/// One unit of work for the job queue.
+///
+typedef struct {
+  EFI_AP_PROCEDURE    Procedure;
+  VOID                *ProcedureArgument;
+} EDKII_MP_JOB;
+
+/**
+  Runs a list of jobs on all enabled processors and returns when all of them
+  have finished.
+
+  Each job runs exactly once, on an unspecified processor which may be the BSP.
+  Jobs may run in any order and in parallel, so they must not depend on each
+  other. The restrictions on the Procedure of StartupAllAPs() apply to every
+  job: a job runs on an AP, so it must not call UEFI boot services or runtime
+  services, directly or through a library. In particular, DebugLib instances
+  that print through a protocol may not be used, and any state a job needs
+  from boot services must be looked up by the caller before RunJobs().
+
+  @param[in]  This                    A pointer to this protocol instance.
+  @param[in]  Jobs                    The array of jobs to run.
+  @param[in]  JobCount                The number of entries in Jobs.
+  @param[in]  TimeoutInMicroseconds   Indicates the time limit in microseconds for
+                                      APs to finish their jobs. Zero means
+                                      infinity.
+
+  @retval EFI_SUCCESS             All jobs have finished.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_TIMEOUT             The timeout expired before all jobs have
+                                  finished.
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL and JobCount is not zero.
+  @retval EFI_INVALID_PARAMETER   The Procedure of any job is NULL.
+  @retval EFI_INVALID_PARAMETER   JobCount is greater than MAX_UINT32.
+  @retval EFI_OUT_OF_RESOURCES    The job queue could not be allocated.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_JOB_QUEUE_RUN_JOBS)(
+  IN  EDKII_MP_JOB_QUEUE_PROTOCOL  *This,
+  IN  EDKII_MP_JOB                 *Jobs,
+  IN  UINTN                        JobCount,
+  IN  UINTN                        TimeoutInMicroseconds
+  );
+
+struct _EDKII_MP_JOB_QUEUE_PROTOCOL {
+  EDKII_MP_JOB_QUEUE_RUN_JOBS    RunJobs;
+};
+
+extern EFI_GUID  gEdkiiMpJobQueueProtocolGuid;
+
+#endif
@@ -0,0 +1,303 @@
+/** @file
+  Host based stress tests of the MpInitLib job queue.
+
+  MpInitLibStartupAllCPUs() is replaced by a fake that runs the procedure on
+  one host thread per CPU, the calling thread playing the BSP. The threads are
+  released together so that they contend for the job ranges from the start.
+  The tests check that every job runs exactly once for many job and CPU
+  counts, with jobs of uneven cost, and that the jobs of a blocked CPU are
+  stolen by the others.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+extern "C" {
+  #include <PiPei.h>
+  #include <Library/BaseLib.h>
+  #include <Library/MpInitLib.h>
+}
+
+using namespace testing;
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_STRESS_RUN       20
+#define TEST_MAX_JOB_COUNT    5000
+#define TEST_STEAL_WAIT_SECS  10
+
+/////////////////////////////////////////////////////////////////////////
+// Fake MP services
+///////////////////////////////////////////////////////////////////////
+
+static UINTN       mCpuCount;
+static EFI_STATUS  mStartupStatus;
+
+extern "C" {
+  EFI_STATUS
+  EFIAPI
+  MpInitLibGetNumberOfProcessors (
+    OUT UINTN  *NumberOfProcessors        OPTIONAL,
+    OUT UINTN  *NumberOfEnabledProcessors OPTIONAL
+    )
+  {
+    if (NumberOfProcessors != NULL) {
+      *NumberOfProcessors = mCpuCount;
+    }
+
+    if (NumberOfEnabledProcessors != NULL) {
+      *NumberOfEnabledProcessors = mCpuCount;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  MpInitLibStartupAllCPUs (
+    IN  EFI_AP_PROCEDURE  Procedure,
+    IN  UINTN             TimeoutInMicroseconds,
+    IN  VOID              *ProcedureArgument      OPTIONAL
+    )
+  {
+    std::vector<std::thread>  Threads;
+    std::atomic<BOOLEAN>      Go;
+    UINTN                     Index;
+
+    if (EFI_ERROR (mStartupStatus)) {
+      return mStartupStatus;
+    }
+
+    Go = FALSE;
+    for (Index = 1; Index < mCpuCount; Index++) {
+      Threads.emplace_back (
+                [&Go, Procedure, ProcedureArgument]() {
+        while (!Go) {
+          std::this_thread::yield ();
+        }
+
+        Procedure (ProcedureArgument);
+      }
+                );
+    }
+
+    Go = TRUE;
+    Procedure (ProcedureArgument);
+
+    for (auto &Thread : Threads) {
+      Thread.join ();
+    }
+
+    return EFI_SUCCESS;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Jobs
+///////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  std::atomic<UINT32>    RunCount;
+  UINTN                  Cost;
+} TEST_JOB;
+
+static std::atomic<UINTN>  mFinishedJobs;
+static UINTN               mJobCount;
+
+/**
+  Spin for the cost of the job and count the run.
+**/
+static
+VOID
+EFIAPI
+UnevenJob (
+  IN OUT VOID  *Buffer
+  )
+{
+  TEST_JOB        *Job;
+  volatile UINTN  Sink;
+  UINTN           Index;
+
+  Job  = (TEST_JOB *)Buffer;
+  Sink = 0;
+  for (Index = 0; Index < Job->Cost; Index++) {
+    Sink = Sink + Index;
+  }
+
+  Job->RunCount++;
+  mFinishedJobs++;
+}
+
+/**
+  Block the CPU running it until all the other jobs have finished, so that
+  they can only run if the rest of its range is stolen.
+**/
+static
+VOID
+EFIAPI
+BlockingJob (
+  IN OUT VOID  *Buffer
+  )
+{
+  TEST_JOB  *Job;
+
+  Job = (TEST_JOB *)Buffer;
+  auto  Deadline = std::chrono::steady_clock::now () + std::chrono::seconds (TEST_STEAL_WAIT_SECS);
+
+  while ((mFinishedJobs < mJobCount - 1) && (std::chrono::steady_clock::now () < Deadline)) {
+    std::this_thread::yield ();
+  }
+
+  Job->RunCount++;
+  mFinishedJobs++;
+}
+
+class MpJobQueueTest : public Test {
+protected:
+  std::unique_ptr<TEST_JOB[]>  TestJobs;
+  std::vector<EDKII_MP_JOB>    Jobs;
+
+  void
+  SetUp (
+    ) override
+  {
+    mCpuCount      = 1;
+    mStartupStatus = EFI_SUCCESS;
+  }
+
+  //
+  // Build JobCount jobs whose cost varies by three orders of magnitude, with
+  // the expensive ones clustered so that the initial split is unbalanced.
+  //
+  void
+  Init (
+    UINTN  JobCount
+    )
+  {
+    UINTN  Index;
+
+    TestJobs.reset (new TEST_JOB[JobCount]);
+    Jobs.resize (JobCount);
+    for (Index = 0; Index < JobCount; Index++) {
+      TestJobs[Index].RunCount = 0;
+      TestJobs[Index].Cost     = (Index < JobCount / 8) ? 20000 : (Index % 13) * 20;
+      Jobs[Index].Procedure         = UnevenJob;
+      Jobs[Index].ProcedureArgument = &TestJobs[Index];
+    }
+
+    mFinishedJobs = 0;
+    mJobCount     = JobCount;
+  }
+
+  void
+  ExpectEachJobRanOnce (
+    )
+  {
+    UINTN  Index;
+
+    for (Index = 0; Index < Jobs.size (); Index++) {
+      EXPECT_EQ (TestJobs[Index].RunCount, 1U) << "Job " << Index;
+    }
+  }
+};
+
+TEST_F (MpJobQueueTest, InvalidParameters) {
+  Init (4);
+
+  EXPECT_EQ (MpInitLibRunJobs (NULL, 0, 0), EFI_SUCCESS);
+  EXPECT_EQ (MpInitLibRunJobs (NULL, 1, 0), EFI_INVALID_PARAMETER);
+  if (sizeof (UINTN) > sizeof (UINT32)) {
+    EXPECT_EQ (MpInitLibRunJobs (Jobs.data (), (UINTN)MAX_UINT32 + 1, 0), EFI_INVALID_PARAMETER);
+  }
+
+  Jobs[2].Procedure = NULL;
+  EXPECT_EQ (MpInitLibRunJobs (Jobs.data (), Jobs.size (), 0), EFI_INVALID_PARAMETER);
+  EXPECT_EQ (mFinishedJobs, 0U);
+}
+
+TEST_F (MpJobQueueTest, StartupErrorIsReturned) {
+  Init (16);
+  mCpuCount      = 4;
+  mStartupStatus = EFI_NOT_READY;
+
+  EXPECT_EQ (MpInitLibRunJobs (Jobs.data (), Jobs.size (), 0), EFI_NOT_READY);
+  EXPECT_EQ (mFinishedJobs, 0U);
+}
+
+TEST_F (MpJobQueueTest, SingleCpu) {
+  Init (100);
+
+  EXPECT_EQ (MpInitLibRunJobs (Jobs.data (), Jobs.size (), 0), EFI_SUCCESS);
+  ExpectEachJobRanOnce ();
+}
+
+TEST_F (MpJobQueueTest, FewerJobsThanCpus) {
+  Init (3);
+  mCpuCount = 8;
+
+  EXPECT_EQ (MpInitLibRunJobs (Jobs.data (), Jobs.size (), 0), EFI_SUCCESS);
+  ExpectEachJobRanOnce ();
+}
+
+TEST_F (MpJobQueueTest, EachJobRunsOnceUnderContention) {
+  static const UINTN  JobCounts[] = { 1, 2, 7, 64, 333, TEST_MAX_JOB_COUNT };
+  UINTN               CpuCounts[] = { 2, 3, 8, 0 };
+  UINTN               Run;
+
+  //
+  // Oversubscribing the host is fine: no worker waits for another one, so
+  // preempted workers only make the steals more frequent.
+  //
+  CpuCounts[3] = MAX (std::thread::hardware_concurrency (), 16U);
+
+  for (Run = 0; Run < TEST_STRESS_RUN; Run++) {
+    for (UINTN CpuCount : CpuCounts) {
+      for (UINTN JobCount : JobCounts) {
+        Init (JobCount);
+        mCpuCount = CpuCount;
+
+        ASSERT_EQ (MpInitLibRunJobs (Jobs.data (), Jobs.size (), 0), EFI_SUCCESS);
+        ExpectEachJobRanOnce ();
+        ASSERT_EQ (mFinishedJobs, JobCount) << CpuCount << " CPUs, " << JobCount << " jobs";
+      }
+    }
+  }
+}
+
+TEST_F (MpJobQueueTest, JobsOfBlockedCpuAreStolen) {
+  UINTN  CpuCount;
+
+  //
+  // The first job blocks the CPU owning the first range until all the other
+  // jobs are done, so they must be stolen by the other CPUs to finish in time.
+  //
+  for (CpuCount = 2; CpuCount <= 8; CpuCount *= 2) {
+    Init (64 * CpuCount);
+    mCpuCount         = CpuCount;
+    Jobs[0].Procedure = BlockingJob;
+
+    auto  Start = std::chrono::steady_clock::now ();
+
+    EXPECT_EQ (MpInitLibRunJobs (Jobs.data (), Jobs.size (), 0), EFI_SUCCESS);
+    EXPECT_LT (std::chrono::steady_clock::now () - Start, std::chrono::seconds (TEST_STEAL_WAIT_SECS));
+    ExpectEachJobRanOnce ();
+  }
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
@@ -0,0 +1,280 @@
+/** @file
+  Work-stealing job queue on top of MpInitLibStartupAllCPUs().
+
+  Each worker CPU owns a range of job indexes [Head, Tail) packed into one
+  UINT64. The owner takes jobs from Head and an idle worker steals the upper
+  half of the range of another worker from Tail. Both ends are updated with a
+  compare-exchange on the same UINT64, so no lock is needed. The ranges are
+  placed on separate cache lines to keep the owners from contending.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/MpInitLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+
+typedef struct {
+  EDKII_MP_JOB       *Jobs;
+  UINT8              *Ranges;
+  UINTN              RangeSize;
+  UINT32             WorkerCount;
+  volatile UINT32    NextWorker;
+  volatile UINT32    FinishedJobs;
+} MP_JOB_QUEUE;
+
+/**
+  Packs a job index range into one UINT64.
+
+  @param[in]  Head  The first job index of the range.
+  @param[in]  Tail  The job index following the last one of the range.
+
+  @return The packed range.
+**/
+STATIC
+UINT64
+MakeJobRange (
+  IN UINT32  Head,
+  IN UINT32  Tail
+  )
+{
+  return LShiftU64 (Tail, 32) | Head;
+}
+
+/**
+  Returns the job index range owned by a worker.
+
+  @param[in]  Queue   The job queue.
+  @param[in]  Worker  The index of the worker.
+
+  @return The job index range of Worker.
+**/
+STATIC
+volatile UINT64 *
+GetJobRange (
+  IN MP_JOB_QUEUE  *Queue,
+  IN UINT32        Worker
+  )
+{
+  return (volatile UINT64 *)(Queue->Ranges + Worker * Queue->RangeSize);
+}
+
+/**
+  Takes the first job from a range.
+
+  @param[in]   Range     The job index range.
+  @param[out]  JobIndex  The index of the job taken.
+
+  @retval TRUE   A job was taken.
+  @retval FALSE  The range is empty.
+**/
+STATIC
+BOOLEAN
+PopJob (
+  IN  volatile UINT64  *Range,
+  OUT UINT32           *JobIndex
+  )
+{
+  UINT64  Value;
+  UINT32  Head;
+  UINT32  Tail;
+
+  do {
+    Value = *Range;
+    Head  = (UINT32)Value;
+    Tail  = (UINT32)RShiftU64 (Value, 32);
+    if (Head >= Tail) {
+      return FALSE;
+    }
+  } while (InterlockedCompareExchange64 ((UINT64 *)Range, Value, MakeJobRange (Head + 1, Tail)) != Value);
+
+  *JobIndex = Head;
+  return TRUE;
+}
+
+/**
+  Steals the upper half of the jobs of another worker.
+
+  The first stolen job is returned and the others are moved into the range of
+  the thief, which is empty at this point. Only the owner refills its range, so
+  the refill does not race with other workers.
+
+  @param[in]   Queue     The job queue.
+  @param[in]   Thief     The index of the stealing worker.
+  @param[out]  JobIndex  The index of the job to run.
+
+  @retval TRUE   A job was stolen.
+  @retval FALSE  The ranges of all workers are empty.
+**/
+STATIC
+BOOLEAN
+StealJobs (
+  IN  MP_JOB_QUEUE  *Queue,
+  IN  UINT32        Thief,
+  OUT UINT32        *JobIndex
+  )
+{
+  volatile UINT64  *Range;
+  UINT64           Value;
+  UINT64           OldValue;
+  UINT32           Offset;
+  UINT32           Head;
+  UINT32           Tail;
+  UINT32           Split;
+
+  for (Offset = 1; Offset < Queue->WorkerCount; Offset++) {
+    Range = GetJobRange (Queue, (Thief + Offset) % Queue->WorkerCount);
+    do {
+      Value = *Range;
+      Head  = (UINT32)Value;
+      Tail  = (UINT32)RShiftU64 (Value, 32);
+      if (Head >= Tail) {
+        break;
+      }
+
+      Split = Tail - (Tail - Head + 1) / 2;
+    } while (InterlockedCompareExchange64 ((UINT64 *)Range, Value, MakeJobRange (Head, Split)) != Value);
+
+    if (Head < Tail) {
+      //
+      // The range of the thief is empty, so no other worker updates it and
+      // the exchange cannot fail.
+      //
+      Range    = GetJobRange (Queue, Thief);
+      Value    = *Range;
+      OldValue = InterlockedCompareExchange64 ((UINT64 *)Range, Value, MakeJobRange (Split + 1, Tail));
+      ASSERT (OldValue == Value);
+      ASSERT ((UINT32)Value >= (UINT32)RShiftU64 (Value, 32));
+      *JobIndex = Split;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Runs jobs on the calling CPU until none is left in any range.
+
+  @param[in,out]  Buffer  The job queue.
+**/
+STATIC
+VOID
+EFIAPI
+RunJobsWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  MP_JOB_QUEUE     *Queue;
+  volatile UINT64  *Range;
+  UINT32           Worker;
+  UINT32           JobIndex;
+
+  Queue  = (MP_JOB_QUEUE *)Buffer;
+  Worker = InterlockedIncrement (&Queue->NextWorker) - 1;
+  if (Worker >= Queue->WorkerCount) {
+    return;
+  }
+
+  Range = GetJobRange (Queue, Worker);
+  while (PopJob (Range, &JobIndex) || StealJobs (Queue, Worker, &JobIndex)) {
+    Queue->Jobs[JobIndex].Procedure (Queue->Jobs[JobIndex].ProcedureArgument);
+    InterlockedIncrement (&Queue->FinishedJobs);
+  }
+}
+
+/**
+  This service runs a list of jobs on all enabled CPUs and returns when all of
+  them have finished.
+
+  The jobs are split evenly into one queue per CPU. A CPU runs the jobs of its
+  own queue and, once it is empty, steals half of the jobs left in the queue of
+  another CPU. Each job runs exactly once, on an unspecified CPU which may be
+  the BSP, so the jobs must not depend on each other.
+
+  Jobs run on APs, so they must not call PEI services or UEFI boot services,
+  directly or through a library.
+
+  @param[in]  Jobs                    The array of jobs to run.
+  @param[in]  JobCount                The number of entries in Jobs.
+  @param[in]  TimeoutInMicroseconds   Indicates the time limit in microseconds for
+                                      APs to finish their jobs. Zero means
+                                      infinity.
+
+  @retval EFI_SUCCESS             All jobs have finished.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_NOT_READY           MP Initialize Library is not initialized.
+  @retval EFI_TIMEOUT             The timeout expired before all jobs have
+                                  finished.
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL and JobCount is not zero.
+  @retval EFI_INVALID_PARAMETER   The Procedure of any job is NULL.
+  @retval EFI_INVALID_PARAMETER   JobCount is greater than MAX_UINT32.
+  @retval EFI_OUT_OF_RESOURCES    The job queues could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibRunJobs (
+  IN  EDKII_MP_JOB  *Jobs,
+  IN  UINTN         JobCount,
+  IN  UINTN         TimeoutInMicroseconds
+  )
+{
+  EFI_STATUS    Status;
+  MP_JOB_QUEUE  Queue;
+  UINTN         EnabledCount;
+  UINTN         Pages;
+  UINTN         Index;
+  UINT32        Worker;
+
+  if (JobCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if ((Jobs == NULL) || (JobCount > MAX_UINT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < JobCount; Index++) {
+    if (Jobs[Index].Procedure == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  Status = MpInitLibGetNumberOfProcessors (NULL, &EnabledCount);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Queue.Jobs         = Jobs;
+  Queue.WorkerCount  = (UINT32)EnabledCount;
+  Queue.NextWorker   = 0;
+  Queue.FinishedJobs = 0;
+  Queue.RangeSize    = ALIGN_VALUE (sizeof (UINT64), GetSpinLockProperties ());
+  Pages              = EFI_SIZE_TO_PAGES (Queue.RangeSize * Queue.WorkerCount);
+  Queue.Ranges       = AllocatePages (Pages);
+  if (Queue.Ranges == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Worker = 0; Worker < Queue.WorkerCount; Worker++) {
+    *GetJobRange (&Queue, Worker) = MakeJobRange (
+                                      (UINT32)DivU64x32 (MultU64x32 (JobCount, Worker), Queue.WorkerCount),
+                                      (UINT32)DivU64x32 (MultU64x32 (JobCount, Worker + 1), Queue.WorkerCount)
+                                      );
+  }
+
+  Status = MpInitLibStartupAllCPUs (RunJobsWorker, TimeoutInMicroseconds, &Queue);
+  if (!EFI_ERROR (Status)) {
+    ASSERT (Queue.FinishedJobs == JobCount);
+  }
+
+  FreePages (Queue.Ranges, Pages);
+  return Status;
+}
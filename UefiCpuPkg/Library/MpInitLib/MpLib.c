@@ -1796,6 +1796,7 @@ CheckAllAPs (
   EFI_STATUS   Status;
   CPU_MP_DATA  *CpuMpData;
   CPU_AP_DATA  *CpuData;
+  BOOLEAN      TimedOut;
 
   CpuMpData = GetCpuMpData ();
 
@@ -1805,6 +1806,28 @@ CheckAllAPs (
   }
 
   NextProcessorNumber = 0;
+  TimedOut            = FALSE;
+
+  //
+  // In blocking parallel mode every AP increments FinishedCount after setting
+  // its state to CpuStateFinished. Skip the scan of all CPU states until the
+  // count shows that the APs are done, or the timeout needs the failed APs.
+  //
+  if ((CpuMpData->WaitEvent == NULL) && !CpuMpData->SingleThread &&
+      (CpuMpData->FinishedCount < CpuMpData->RunningCount))
+  {
+    if (!CheckTimeout (
+           &CpuMpData->CurrentTime,
+           &CpuMpData->TotalTime,
+           CpuMpData->ExpectedTime
+           )
+        )
+    {
+      return EFI_NOT_READY;
+    }
+
+    TimedOut = TRUE;
+  }
 
   //
   // Go through all APs that are responsible for the StartupAllAPs().
@@ -1855,7 +1878,8 @@ CheckAllAPs (
   //
   // If timeout expires, report timeout.
   //
-  if (CheckTimeout (
+  if (TimedOut ||
+      CheckTimeout (
         &CpuMpData->CurrentTime,
         &CpuMpData->TotalTime,
         CpuMpData->ExpectedTime
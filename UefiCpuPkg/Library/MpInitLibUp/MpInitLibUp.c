@@ -9,6 +9,7 @@
 #include <PiDxe.h>
 #include <Ppi/SecPlatformInformation.h>
 #include <Protocol/MpService.h>
+#include <Protocol/MpJobQueue.h>
 #include <Library/DebugLib.h>
 #include <Library/LocalApicLib.h>
 #include <Library/HobLib.h>
@@ -448,3 +449,46 @@ MpInitLibStartupAllCPUs (
 
   return EFI_SUCCESS;
 }
+
+/**
+  This service runs a list of jobs on all enabled CPUs and returns when all of
+  them have finished.
+
+  @param[in]  Jobs                    The array of jobs to run.
+  @param[in]  JobCount                The number of entries in Jobs.
+  @param[in]  TimeoutInMicroseconds   Indicates the time limit in microseconds for
+                                      APs to finish their jobs. Zero means
+                                      infinity. TimeoutInMicroseconds is ignored
+                                      for BSP.
+
+  @retval EFI_SUCCESS             The BSP has finished all jobs.
+  @retval EFI_INVALID_PARAMETER   Jobs is NULL and JobCount is not zero.
+  @retval EFI_INVALID_PARAMETER   The Procedure of any job is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibRunJobs (
+  IN  EDKII_MP_JOB  *Jobs,
+  IN  UINTN         JobCount,
+  IN  UINTN         TimeoutInMicroseconds
+  )
+{
+  UINTN  Index;
+
+  if ((Jobs == NULL) && (JobCount != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < JobCount; Index++) {
+    if (Jobs[Index].Procedure == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  for (Index = 0; Index < JobCount; Index++) {
+    Jobs[Index].Procedure (Jobs[Index].ProcedureArgument);
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,245 @@
+/** @file
+  Host based stress tests of the SmmCpuSyncLib instances.
+
+  One host thread plays each CPU. The tests check the check-in, check-out and
+  lock door accounting, then run the BSP/AP rendezvous of an SMI many times,
+  checking that every AP runs exactly once per rendezvous. The rendezvous
+  latency is reported for increasing thread counts so that the instances can
+  be compared on the same host.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/SmmCpuSyncLib.h>
+}
+
+using namespace testing;
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TEST_CPU_COUNT         8
+#define TEST_RENDEZVOUS_RUN    2000
+#define TEST_BSP_INDEX         0
+
+class SmmCpuSyncLibTest : public Test {
+protected:
+  SMM_CPU_SYNC_CONTEXT *Context = NULL;
+
+  void
+  TearDown (
+    ) override
+  {
+    if (Context != NULL) {
+      SmmCpuSyncContextDeinit (Context);
+    }
+  }
+
+  void
+  Init (
+    UINTN  NumberOfCpus
+    )
+  {
+    Context = NULL;
+    ASSERT_EQ (SmmCpuSyncContextInit (NumberOfCpus, &Context), RETURN_SUCCESS);
+    ASSERT_NE (Context, nullptr);
+  }
+
+  //
+  // Run the BSP/AP flow of an SMI TEST_RENDEZVOUS_RUN times on NumberOfCpus
+  // threads and return the average time of one rendezvous.
+  //
+  std::chrono::nanoseconds
+  Rendezvous (
+    UINTN  NumberOfCpus
+    )
+  {
+    std::vector<std::thread>  Threads;
+    std::atomic<UINTN>        Executed;
+    BOOLEAN                   Mismatch;
+    UINTN                     CpuCount;
+    UINTN                     Run;
+    UINTN                     Index;
+
+    Executed = 0;
+    Mismatch = FALSE;
+
+    for (Index = 0; Index < NumberOfCpus; Index++) {
+      if (Index == TEST_BSP_INDEX) {
+        continue;
+      }
+
+      Threads.emplace_back (
+                [this, Index, &Executed]() {
+        UINTN Run;
+
+        EXPECT_EQ (SmmCpuSyncCheckInCpu (Context, Index), RETURN_SUCCESS);
+        for (Run = 0; Run < TEST_RENDEZVOUS_RUN; Run++) {
+          SmmCpuSyncWaitForBsp (Context, Index, TEST_BSP_INDEX);
+          Executed++;
+          SmmCpuSyncReleaseBsp (Context, Index, TEST_BSP_INDEX);
+        }
+      }
+                );
+    }
+
+    EXPECT_EQ (SmmCpuSyncCheckInCpu (Context, TEST_BSP_INDEX), RETURN_SUCCESS);
+    while (SmmCpuSyncGetArrivedCpuCount (Context) < NumberOfCpus) {
+      CpuPause ();
+    }
+
+    SmmCpuSyncLockDoor (Context, TEST_BSP_INDEX, &CpuCount);
+    EXPECT_EQ (CpuCount, NumberOfCpus);
+
+    auto  Start = std::chrono::steady_clock::now ();
+
+    for (Run = 0; Run < TEST_RENDEZVOUS_RUN; Run++) {
+      for (Index = 0; Index < NumberOfCpus; Index++) {
+        if (Index != TEST_BSP_INDEX) {
+          SmmCpuSyncReleaseOneAp (Context, Index, TEST_BSP_INDEX);
+        }
+      }
+
+      SmmCpuSyncWaitForAPs (Context, NumberOfCpus - 1, TEST_BSP_INDEX);
+      if (Executed != (Run + 1) * (NumberOfCpus - 1)) {
+        Mismatch = TRUE;
+      }
+    }
+
+    auto  Elapsed = std::chrono::steady_clock::now () - Start;
+
+    for (auto &Thread : Threads) {
+      Thread.join ();
+    }
+
+    EXPECT_FALSE (Mismatch);
+    SmmCpuSyncContextReset (Context);
+    EXPECT_EQ (SmmCpuSyncGetArrivedCpuCount (Context), 0U);
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed) / TEST_RENDEZVOUS_RUN;
+  }
+};
+
+TEST_F (SmmCpuSyncLibTest, CheckInOutAndLockDoor) {
+  UINTN  Index;
+  UINTN  CpuCount;
+
+  Init (TEST_CPU_COUNT);
+
+  for (Index = 0; Index < TEST_CPU_COUNT - 2; Index++) {
+    EXPECT_EQ (SmmCpuSyncCheckInCpu (Context, Index), RETURN_SUCCESS);
+  }
+
+  EXPECT_EQ (SmmCpuSyncCheckOutCpu (Context, 1), RETURN_SUCCESS);
+  EXPECT_EQ (SmmCpuSyncGetArrivedCpuCount (Context), (UINTN)TEST_CPU_COUNT - 3);
+
+  SmmCpuSyncLockDoor (Context, 0, &CpuCount);
+  EXPECT_EQ (CpuCount, (UINTN)TEST_CPU_COUNT - 3);
+  EXPECT_EQ (SmmCpuSyncGetArrivedCpuCount (Context), (UINTN)TEST_CPU_COUNT - 3);
+
+  EXPECT_EQ (SmmCpuSyncCheckInCpu (Context, TEST_CPU_COUNT - 1), RETURN_ABORTED);
+  EXPECT_EQ (SmmCpuSyncCheckOutCpu (Context, 2), RETURN_ABORTED);
+  EXPECT_EQ (SmmCpuSyncGetArrivedCpuCount (Context), (UINTN)TEST_CPU_COUNT - 3);
+
+  SmmCpuSyncContextReset (Context);
+  EXPECT_EQ (SmmCpuSyncGetArrivedCpuCount (Context), 0U);
+  EXPECT_EQ (SmmCpuSyncCheckInCpu (Context, TEST_CPU_COUNT - 1), RETURN_SUCCESS);
+  EXPECT_EQ (SmmCpuSyncGetArrivedCpuCount (Context), 1U);
+}
+
+TEST_F (SmmCpuSyncLibTest, ReleasesAreCounted) {
+  UINTN  Index;
+
+  Init (TEST_CPU_COUNT);
+
+  //
+  // Releases from APs that the BSP does not wait for yet must not be lost.
+  //
+  for (Index = 1; Index < TEST_CPU_COUNT; Index++) {
+    SmmCpuSyncReleaseBsp (Context, Index, TEST_BSP_INDEX);
+    SmmCpuSyncReleaseBsp (Context, Index, TEST_BSP_INDEX);
+  }
+
+  SmmCpuSyncWaitForAPs (Context, TEST_CPU_COUNT - 1, TEST_BSP_INDEX);
+  SmmCpuSyncWaitForAPs (Context, TEST_CPU_COUNT - 1, TEST_BSP_INDEX);
+
+  SmmCpuSyncReleaseOneAp (Context, TEST_CPU_COUNT - 1, TEST_BSP_INDEX);
+  SmmCpuSyncWaitForBsp (Context, TEST_CPU_COUNT - 1, TEST_BSP_INDEX);
+}
+
+TEST_F (SmmCpuSyncLibTest, ConcurrentCheckInIsCounted) {
+  std::vector<std::thread>  Threads;
+  UINTN                     NumberOfCpus;
+  UINTN                     Index;
+  UINTN                     CpuCount;
+
+  NumberOfCpus = MAX (std::thread::hardware_concurrency (), 2U);
+  Init (NumberOfCpus);
+
+  for (Index = 0; Index < NumberOfCpus; Index++) {
+    Threads.emplace_back (
+              [this, Index]() {
+      EXPECT_EQ (SmmCpuSyncCheckInCpu (Context, Index), RETURN_SUCCESS);
+    }
+              );
+  }
+
+  for (auto &Thread : Threads) {
+    Thread.join ();
+  }
+
+  SmmCpuSyncLockDoor (Context, TEST_BSP_INDEX, &CpuCount);
+  EXPECT_EQ (CpuCount, NumberOfCpus);
+}
+
+TEST_F (SmmCpuSyncLibTest, RendezvousLatency) {
+  std::vector<UINTN>        ThreadCounts;
+  std::chrono::nanoseconds  Latency;
+  UINTN                     MaxCpus;
+  UINTN                     NumberOfCpus;
+
+  //
+  // Spinning CPUs need a host thread each, or every hand-off waits for a
+  // time slice and the latency says nothing about the instance.
+  //
+  MaxCpus = std::thread::hardware_concurrency ();
+  if (MaxCpus < 2) {
+    GTEST_SKIP () << "Needs at least 2 host threads";
+  }
+
+  for (NumberOfCpus = 2; NumberOfCpus < MaxCpus; NumberOfCpus *= 2) {
+    ThreadCounts.push_back (NumberOfCpus);
+  }
+
+  ThreadCounts.push_back (MaxCpus);
+
+  for (UINTN Count : ThreadCounts) {
+    Init (Count);
+    Latency = Rendezvous (Count);
+    SmmCpuSyncContextDeinit (Context);
+    Context = NULL;
+
+    RecordProperty ("RendezvousNs" + std::to_string (Count), (int)Latency.count ());
+    printf ("  %4u threads: %8u ns per rendezvous\n", (unsigned)Count, (unsigned)Latency.count ());
+  }
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
@@ -0,0 +1,818 @@
+/** @file
+  SMM CPU Sync lib implementation for systems with many processors.
+
+  The lib provides the same 3 sets of APIs as SmmCpuSyncLib.c, see there for
+  the usage flow. The difference is where the CPUs meet:
+
+  SmmCpuSyncLib.c counts arrived CPUs in one global semaphore, and all APs
+  release the BSP through the one semaphore of the BSP. Every CPU of the
+  system then fights for the same two cache lines in each SMI rendezvous, so
+  the rendezvous gets slower with each CPU added.
+
+  This instance splits the CPUs into groups of consecutive CPU indexes. CPU
+  indexes follow the APIC ID order, so the CPUs of a group are siblings in the
+  same core and package. Each group has its own arrival counter and its own
+  counter of BSP releases, each on an exclusive cache line:
+
+                          BSP (root)
+              /              |              \
+        Group 0          Group 1    ...    Group N-1
+    Arrived Released  Arrived Released   Arrived Released
+      / | \             / | \               / | \
+    CPUs 0..G-1      CPUs G..2G-1           ...
+
+  A CPU only writes the counters of its own group, so the cache lines stay in
+  the package. The BSP is the root of the tree: it collects the counts of all
+  groups, which only needs reads of lines that are written by few CPUs. The
+  semaphore every AP waits on stays per-CPU as in SmmCpuSyncLib.c.
+
+  PcdSmmCpuSyncGroupSize sets the number of CPUs per group. 0 selects the
+  largest power of two whose square does not exceed the number of CPUs,
+  which balances the CPUs per group against the groups scanned by the BSP.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SafeIntLib.h>
+#include <Library/SmmCpuSyncLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Uefi.h>
+
+///
+/// The implementation shall place one semaphore on exclusive cache line for good performance.
+///
+typedef volatile UINT32 SMM_CPU_SYNC_SEMAPHORE;
+
+typedef struct {
+  ///
+  /// Used for control each CPU continue run or wait for signal
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *Run;
+} SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU;
+
+typedef struct {
+  ///
+  /// Indicate CPUs of the group entered SMM before lock door.
+  /// Set to -1 when the door is locked.
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *Arrived;
+  ///
+  /// Number of BSP releases from the CPUs of the group not yet consumed by the BSP.
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *Released;
+} SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP;
+
+struct SMM_CPU_SYNC_CONTEXT  {
+  ///
+  /// Indicate all CPUs in the system.
+  ///
+  UINTN                                    NumberOfCpus;
+  ///
+  /// Number of CPUs in one group and number of groups.
+  ///
+  UINTN                                    GroupSize;
+  UINTN                                    NumberOfGroups;
+  ///
+  /// Address of semaphores.
+  ///
+  VOID                                     *SemBuffer;
+  ///
+  /// Size of semaphores.
+  ///
+  UINTN                                    SemBufferPages;
+  ///
+  /// Before the door is locked, the Arrived semaphores of the groups store the arrived CPU count.
+  /// DoorLocked is set when the door is being locked, and ArrivedCpuCountUponLock stores the
+  /// arrived CPU count then.
+  ///
+  volatile BOOLEAN                         DoorLocked;
+  UINTN                                    ArrivedCpuCountUponLock;
+  ///
+  /// Semaphores of each group, following CpuSem[NumberOfCpus].
+  ///
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP    *GroupSem;
+  ///
+  /// Define an array of structure for each CPU semaphore due to the size alignment
+  /// requirement. With the array of structure for each CPU semaphore, it's easy to
+  /// reach the specific CPU with CPU Index for its own semaphore access: CpuSem[CpuIndex].
+  ///
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU      CpuSem[];
+};
+
+/**
+  Performs an atomic compare exchange operation to get semaphore.
+  The compare exchange operation must be performed using MP safe
+  mechanisms.
+
+  @param[in,out]  Sem    IN:  32-bit unsigned integer
+                         OUT: original integer - 1 if Sem is not locked.
+                         OUT: MAX_UINT32 if Sem is locked.
+
+  @retval     Original integer - 1 if Sem is not locked.
+              MAX_UINT32 if Sem is locked.
+
+**/
+STATIC
+UINT32
+InternalWaitForSemaphore (
+  IN OUT  volatile UINT32  *Sem
+  )
+{
+  UINT32  Value;
+
+  for ( ; ;) {
+    Value = *Sem;
+    if (Value == MAX_UINT32) {
+      return Value;
+    }
+
+    if ((Value != 0) &&
+        (InterlockedCompareExchange32 (
+           (UINT32 *)Sem,
+           Value,
+           Value - 1
+           ) == Value))
+    {
+      break;
+    }
+
+    CpuPause ();
+  }
+
+  return Value - 1;
+}
+
+/**
+  Performs an atomic compare exchange operation to release semaphore.
+  The compare exchange operation must be performed using MP safe
+  mechanisms.
+
+  @param[in,out]  Sem    IN:  32-bit unsigned integer
+                         OUT: original integer + 1 if Sem is not locked.
+                         OUT: MAX_UINT32 if Sem is locked.
+
+  @retval    Original integer + 1 if Sem is not locked.
+             MAX_UINT32 if Sem is locked.
+
+**/
+STATIC
+UINT32
+InternalReleaseSemaphore (
+  IN OUT  volatile UINT32  *Sem
+  )
+{
+  UINT32  Value;
+
+  do {
+    Value = *Sem;
+  } while (Value + 1 != 0 &&
+           InterlockedCompareExchange32 (
+             (UINT32 *)Sem,
+             Value,
+             Value + 1
+             ) != Value);
+
+  if (Value == MAX_UINT32) {
+    return Value;
+  }
+
+  return Value + 1;
+}
+
+/**
+  Performs an atomic compare exchange operation to lock semaphore.
+  The compare exchange operation must be performed using MP safe
+  mechanisms.
+
+  @param[in,out]  Sem    IN:  32-bit unsigned integer
+                         OUT: -1
+
+  @retval    Original integer
+
+**/
+STATIC
+UINT32
+InternalLockdownSemaphore (
+  IN OUT  volatile UINT32  *Sem
+  )
+{
+  UINT32  Value;
+
+  do {
+    Value = *Sem;
+  } while (InterlockedCompareExchange32 (
+             (UINT32 *)Sem,
+             Value,
+             (UINT32)-1
+             ) != Value);
+
+  return Value;
+}
+
+/**
+  Performs an atomic compare exchange operation to take up to MaxCount from semaphore.
+  The compare exchange operation must be performed using MP safe
+  mechanisms.
+
+  @param[in,out]  Sem       IN:  32-bit unsigned integer
+                            OUT: original integer - the returned count.
+  @param[in]      MaxCount  Maximum count to take.
+
+  @return    The count taken, 0 if Sem is 0.
+
+**/
+STATIC
+UINT32
+InternalTakeSemaphore (
+  IN OUT  volatile UINT32  *Sem,
+  IN      UINT32           MaxCount
+  )
+{
+  UINT32  Value;
+  UINT32  Count;
+
+  for ( ; ;) {
+    Value = *Sem;
+    if (Value == 0) {
+      return 0;
+    }
+
+    Count = MIN (Value, MaxCount);
+    if (InterlockedCompareExchange32 (
+          (UINT32 *)Sem,
+          Value,
+          Value - Count
+          ) == Value)
+    {
+      return Count;
+    }
+
+    CpuPause ();
+  }
+}
+
+/**
+  Get the semaphores of the group a CPU belongs to.
+
+  @param[in]  Context     Pointer to the SMM CPU Sync context object.
+  @param[in]  CpuIndex    CPU index.
+
+  @return    Semaphores of the group.
+
+**/
+STATIC
+SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP *
+InternalGetGroupSem (
+  IN SMM_CPU_SYNC_CONTEXT  *Context,
+  IN UINTN                 CpuIndex
+  )
+{
+  return &Context->GroupSem[CpuIndex / Context->GroupSize];
+}
+
+/**
+  Create and initialize the SMM CPU Sync context. It is to allocate and initialize the
+  SMM CPU Sync context.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in]  NumberOfCpus          The number of Logical Processors in the system.
+  @param[out] Context               Pointer to the new created and initialized SMM CPU Sync context object.
+                                    NULL will be returned if any error happen during init.
+
+  @retval RETURN_SUCCESS            The SMM CPU Sync context was successful created and initialized.
+  @retval RETURN_OUT_OF_RESOURCES   There are not enough resources available to create and initialize SMM CPU Sync context.
+  @retval RETURN_BUFFER_TOO_SMALL   Overflow happen
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncContextInit (
+  IN   UINTN                 NumberOfCpus,
+  OUT  SMM_CPU_SYNC_CONTEXT  **Context
+  )
+{
+  RETURN_STATUS                          Status;
+  UINTN                                  GroupSize;
+  UINTN                                  NumberOfGroups;
+  UINTN                                  ContextSize;
+  UINTN                                  GroupSemSize;
+  UINTN                                  OneSemSize;
+  UINTN                                  NumSem;
+  UINTN                                  TotalSemSize;
+  UINTN                                  SemAddr;
+  UINTN                                  Index;
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU    *CpuSem;
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP  *GroupSem;
+
+  ASSERT (Context != NULL);
+
+  //
+  // Split CPUs into groups
+  //
+  GroupSize = FixedPcdGet32 (PcdSmmCpuSyncGroupSize);
+  if (GroupSize == 0) {
+    GroupSize = 1;
+    while ((GroupSize * 2) * (GroupSize * 2) <= NumberOfCpus) {
+      GroupSize *= 2;
+    }
+  }
+
+  GroupSize      = MIN (GroupSize, MAX (NumberOfCpus, 1));
+  NumberOfGroups = (NumberOfCpus + GroupSize - 1) / GroupSize;
+
+  //
+  // Calculate ContextSize
+  //
+  Status = SafeUintnMult (NumberOfCpus, sizeof (SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU), &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SafeUintnMult (NumberOfGroups, sizeof (SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP), &GroupSemSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SafeUintnAdd (ContextSize, GroupSemSize, &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SafeUintnAdd (ContextSize, sizeof (SMM_CPU_SYNC_CONTEXT), &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Allocate Buffer for Context
+  //
+  *Context = AllocatePool (ContextSize);
+  if (*Context == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  (*Context)->DoorLocked              = FALSE;
+  (*Context)->ArrivedCpuCountUponLock = 0;
+
+  //
+  // Save NumberOfCpus and the groups
+  //
+  (*Context)->NumberOfCpus   = NumberOfCpus;
+  (*Context)->GroupSize      = GroupSize;
+  (*Context)->NumberOfGroups = NumberOfGroups;
+  (*Context)->GroupSem       = (SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP *)&(*Context)->CpuSem[NumberOfCpus];
+
+  //
+  // Calculate total semaphore size
+  //
+  OneSemSize = GetSpinLockProperties ();
+  ASSERT (sizeof (SMM_CPU_SYNC_SEMAPHORE) <= OneSemSize);
+
+  Status = SafeUintnMult (2, NumberOfGroups, &NumSem);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = SafeUintnAdd (NumSem, NumberOfCpus, &NumSem);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = SafeUintnMult (NumSem, OneSemSize, &TotalSemSize);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Allocate for Semaphores in the *Context
+  //
+  (*Context)->SemBufferPages = EFI_SIZE_TO_PAGES (TotalSemSize);
+  (*Context)->SemBuffer      = AllocatePages ((*Context)->SemBufferPages);
+  if ((*Context)->SemBuffer == NULL) {
+    Status = RETURN_OUT_OF_RESOURCES;
+    goto ON_ERROR;
+  }
+
+  SemAddr = (UINTN)(*Context)->SemBuffer;
+
+  //
+  // Assign Group Semaphore pointer
+  //
+  GroupSem = (*Context)->GroupSem;
+  for (Index = 0; Index < NumberOfGroups; Index++) {
+    GroupSem->Arrived   = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *GroupSem->Arrived  = 0;
+    GroupSem->Released  = (SMM_CPU_SYNC_SEMAPHORE *)(SemAddr + OneSemSize);
+    *GroupSem->Released = 0;
+
+    GroupSem++;
+    SemAddr += 2 * OneSemSize;
+  }
+
+  //
+  // Assign CPU Semaphore pointer
+  //
+  CpuSem = (*Context)->CpuSem;
+  for (Index = 0; Index < NumberOfCpus; Index++) {
+    CpuSem->Run  = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *CpuSem->Run = 0;
+
+    CpuSem++;
+    SemAddr += OneSemSize;
+  }
+
+  return RETURN_SUCCESS;
+
+ON_ERROR:
+  FreePool (*Context);
+  return Status;
+}
+
+/**
+  Deinit an allocated SMM CPU Sync context. The resources allocated in SmmCpuSyncContextInit() will
+  be freed.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in,out]  Context     Pointer to the SMM CPU Sync context object to be deinitialized.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncContextDeinit (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  ASSERT (Context != NULL);
+
+  FreePages (Context->SemBuffer, Context->SemBufferPages);
+
+  FreePool (Context);
+}
+
+/**
+  Reset SMM CPU Sync context. SMM CPU Sync context will be reset to the initialized state.
+
+  This function is called by one of CPUs after all CPUs are ready to exit SMI, which allows CPU to
+  check into the next SMI from this point.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in,out]  Context     Pointer to the SMM CPU Sync context object to be reset.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncContextReset (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  UINTN  Index;
+
+  ASSERT (Context != NULL);
+
+  Context->ArrivedCpuCountUponLock = 0;
+  for (Index = 0; Index < Context->NumberOfGroups; Index++) {
+    *Context->GroupSem[Index].Arrived = 0;
+  }
+
+  Context->DoorLocked = FALSE;
+}
+
+/**
+  Get current number of arrived CPU in SMI.
+
+  BSP might need to know the current number of arrived CPU in SMI to make sure all APs
+  in SMI. This API can be for that purpose.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in]      Context     Pointer to the SMM CPU Sync context object.
+
+  @retval    Current number of arrived CPU in SMI.
+
+**/
+UINTN
+EFIAPI
+SmmCpuSyncGetArrivedCpuCount (
+  IN  SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  UINTN   Index;
+  UINTN   Arrived;
+  UINT32  Value;
+
+  ASSERT (Context != NULL);
+
+  if (Context->DoorLocked) {
+    return Context->ArrivedCpuCountUponLock;
+  }
+
+  Arrived = 0;
+  for (Index = 0; Index < Context->NumberOfGroups; Index++) {
+    Value = *Context->GroupSem[Index].Arrived;
+    if (Value == (UINT32)-1) {
+      return Context->ArrivedCpuCountUponLock;
+    }
+
+    Arrived += Value;
+  }
+
+  return Arrived;
+}
+
+/**
+  Performs an atomic operation to check in CPU.
+
+  When SMI happens, all processors including BSP enter to SMM mode by calling SmmCpuSyncCheckInCpu().
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Check in CPU index.
+
+  @retval RETURN_SUCCESS            Check in CPU (CpuIndex) successfully.
+  @retval RETURN_ABORTED            Check in CPU failed due to SmmCpuSyncLockDoor() has been called by one elected CPU.
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncCheckInCpu (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  //
+  // Check to return if the group has already been locked.
+  //
+  if (InternalReleaseSemaphore (InternalGetGroupSem (Context, CpuIndex)->Arrived) == MAX_UINT32) {
+    return RETURN_ABORTED;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Performs an atomic operation to check out CPU.
+
+  This function can be called in error handling flow for the CPU who calls CheckInCpu() earlier.
+  The caller shall make sure the CPU specified by CpuIndex has already checked-in.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Check out CPU index.
+
+  @retval RETURN_SUCCESS            Check out CPU (CpuIndex) successfully.
+  @retval RETURN_ABORTED            Check out CPU failed due to SmmCpuSyncLockDoor() has been called by one elected CPU.
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncCheckOutCpu (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  if (InternalWaitForSemaphore (InternalGetGroupSem (Context, CpuIndex)->Arrived) == MAX_UINT32) {
+    return RETURN_ABORTED;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Performs an atomic operation lock door for CPU checkin and checkout. After this function:
+  CPU can not check in via SmmCpuSyncCheckInCpu().
+  CPU can not check out via SmmCpuSyncCheckOutCpu().
+
+  The CPU specified by CpuIndex is elected to lock door. The caller shall make sure the CpuIndex
+  is the actual CPU calling this function to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If CpuCount is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which CPU to lock door.
+  @param[out]     CpuCount          Number of arrived CPU in SMI after look door.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncLockDoor (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  OUT UINTN                    *CpuCount
+  )
+{
+  UINTN  Index;
+  UINTN  Arrived;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuCount != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  //
+  // Temporarily record the arrived CPU count into the ArrivedCpuCountUponLock before lock door.
+  // Recording before lock door is to avoid the groups are locked but possible
+  // Context->ArrivedCpuCountUponLock is not updated.
+  //
+  Context->ArrivedCpuCountUponLock = SmmCpuSyncGetArrivedCpuCount (Context);
+  Context->DoorLocked              = TRUE;
+
+  //
+  // Lock door operation. A CPU is counted if it checked in before its group is locked.
+  //
+  Arrived = 0;
+  for (Index = 0; Index < Context->NumberOfGroups; Index++) {
+    Arrived += InternalLockdownSemaphore (Context->GroupSem[Index].Arrived);
+  }
+
+  //
+  // Update the ArrivedCpuCountUponLock
+  //
+  Context->ArrivedCpuCountUponLock = Arrived;
+  *CpuCount                        = Arrived;
+}
+
+/**
+  Used by the BSP to wait for APs.
+
+  The number of APs need to be waited is specified by NumberOfAPs. The BSP is specified by BspIndex.
+  The caller shall make sure the BspIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The caller shall make sure the NumberOfAPs have already checked-in to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If NumberOfAPs >= All CPUs in system, then ASSERT().
+  If BspIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  Note:
+  This function is blocking mode, and it will return only after the number of APs released by
+  calling SmmCpuSyncReleaseBsp():
+  BSP: WaitForAPs    <--  AP: ReleaseBsp
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      NumberOfAPs       Number of APs need to be waited by BSP.
+  @param[in]      BspIndex          The BSP Index to wait for APs.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncWaitForAPs (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 NumberOfAPs,
+  IN     UINTN                 BspIndex
+  )
+{
+  UINTN  Index;
+  UINTN  Remaining;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (NumberOfAPs < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  //
+  // Collect the releases from all groups until NumberOfAPs are consumed.
+  //
+  Remaining = NumberOfAPs;
+  while (Remaining > 0) {
+    for (Index = 0; (Index < Context->NumberOfGroups) && (Remaining > 0); Index++) {
+      Remaining -= InternalTakeSemaphore (Context->GroupSem[Index].Released, (UINT32)Remaining);
+    }
+
+    if (Remaining > 0) {
+      CpuPause ();
+    }
+  }
+}
+
+/**
+  Used by the BSP to release one AP.
+
+  The AP is specified by CpuIndex. The BSP is specified by BspIndex.
+  The caller shall make sure the BspIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The caller shall make sure the CpuIndex has already checked-in to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which AP need to be released.
+  @param[in]      BspIndex          The BSP Index to release AP.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncReleaseOneAp   (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InternalReleaseSemaphore (Context->CpuSem[CpuIndex].Run);
+}
+
+/**
+  Used by the AP to wait BSP.
+
+  The AP is specified by CpuIndex.
+  The caller shall make sure the CpuIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The BSP is specified by BspIndex.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  Note:
+  This function is blocking mode, and it will return only after the AP released by
+  calling SmmCpuSyncReleaseOneAp():
+  BSP: ReleaseOneAp  -->  AP: WaitForBsp
+
+  @param[in,out]  Context          Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex         Indicate which AP wait BSP.
+  @param[in]      BspIndex         The BSP Index to be waited.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncWaitForBsp (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InternalWaitForSemaphore (Context->CpuSem[CpuIndex].Run);
+}
+
+/**
+  Used by the AP to release BSP.
+
+  The AP is specified by CpuIndex.
+  The caller shall make sure the CpuIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The BSP is specified by BspIndex.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which AP release BSP.
+  @param[in]      BspIndex          The BSP Index to be released.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncReleaseBsp (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InternalReleaseSemaphore (InternalGetGroupSem (Context, CpuIndex)->Released);
+}
@@ -0,0 +1,160 @@
+/** @file
+  Instance of Timer Library based on POSIX APIs
+
+  Uses the POSIX monotonic clock as a nanosecond performance counter.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <time.h>
+
+#include <Base.h>
+#include <Library/TimerLib.h>
+#include <Library/BaseLib.h>
+
+///
+/// The performance counter counts nanoseconds.
+///
+#define TIMER_LIB_POSIX_FREQUENCY  1000000000ULL
+
+/**
+  Busy-waits until the performance counter has advanced by the specified
+  number of nanoseconds.
+
+  @param  NanoSeconds  The number of nanoseconds to wait.
+
+**/
+STATIC
+VOID
+TimerLibPosixDelay (
+  IN UINT64  NanoSeconds
+  )
+{
+  UINT64  Start;
+
+  Start = GetPerformanceCounter ();
+  while (GetPerformanceCounter () - Start < NanoSeconds) {
+    CpuPause ();
+  }
+}
+
+/**
+  Stalls the CPU for at least the given number of microseconds.
+
+  Stalls the CPU for the number of microseconds specified by MicroSeconds.
+
+  @param  MicroSeconds  The minimum number of microseconds to delay.
+
+  @return The value of MicroSeconds inputted.
+
+**/
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN      UINTN  MicroSeconds
+  )
+{
+  TimerLibPosixDelay (MultU64x32 (MicroSeconds, 1000));
+  return MicroSeconds;
+}
+
+/**
+  Stalls the CPU for at least the given number of nanoseconds.
+
+  Stalls the CPU for the number of nanoseconds specified by NanoSeconds.
+
+  @param  NanoSeconds The minimum number of nanoseconds to delay.
+
+  @return The value of NanoSeconds inputted.
+
+**/
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN      UINTN  NanoSeconds
+  )
+{
+  TimerLibPosixDelay (NanoSeconds);
+  return NanoSeconds;
+}
+
+/**
+  Retrieves the current value of a 64-bit free running performance counter.
+
+  The counter is the host CLOCK_MONOTONIC clock in nanoseconds, so it is not
+  affected by adjustments of the wall clock.
+
+  @return The current value of the free running performance counter.
+
+**/
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  if (clock_gettime (CLOCK_MONOTONIC, &Now) != 0) {
+    return 0;
+  }
+
+  return (UINT64)Now.tv_sec * TIMER_LIB_POSIX_FREQUENCY + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Retrieves the 64-bit frequency in Hz and the range of performance counter
+  values.
+
+  If StartValue is not NULL, then the value that the performance counter starts
+  with immediately after is it rolls over is returned in StartValue. If
+  EndValue is not NULL, then the value that the performance counter end with
+  immediately before it rolls over is returned in EndValue. The 64-bit
+  frequency of the performance counter in Hz is always returned.
+
+  @param  StartValue  The value the performance counter starts with when it
+                      rolls over.
+  @param  EndValue    The value that the performance counter ends with before
+                      it rolls over.
+
+  @return The frequency in Hz.
+
+**/
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT      UINT64  *StartValue   OPTIONAL,
+  OUT      UINT64  *EndValue     OPTIONAL
+  )
+{
+  if (StartValue != NULL) {
+    *StartValue = 0;
+  }
+
+  if (EndValue != NULL) {
+    *EndValue = MAX_UINT64;
+  }
+
+  return TIMER_LIB_POSIX_FREQUENCY;
+}
+
+/**
+  Converts elapsed ticks of performance counter to time in nanoseconds.
+
+  This function converts the elapsed ticks of running performance counter to
+  time value in unit of nanoseconds.
+
+  @param  Ticks     The number of elapsed ticks of running performance counter.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN      UINT64  Ticks
+  )
+{
+  return Ticks;
+}